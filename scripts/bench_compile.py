@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+# scripts/bench_compile.py
+#
+# Compile-latency benchmark for `quick_compile` and the helper-generation modes.
+#
+# Scenarios (one record each, latencies in milliseconds):
+#   cold_extract   fresh process with an empty TMPDIR, so the first compile
+#                  extracts the embedded runtime (libtcc1.a + headers)
+#   cold_process   fresh process reusing an already-extracted TMPDIR
+#                  (both cold scenarios only exercise extraction when the
+#                  compile-time TinyCC build dir is absent, as in
+#                  scripts/test_embedded_runtime.sh or an installed extension)
+#   warm_tiny / warm_medium / warm_large
+#                  repeated compiles in one process of 1, 50 and 500 helper
+#                  functions plus the registered entry point
+#   library_m      warm compile with `library := 'm'` resolution
+#   c_struct_5 / c_struct_20 / c_struct_50
+#                  `c_struct` helper generation for N fields
+#   concurrent_N   N connections compiling distinct functions at once
+#
+# Each record reports p50/p99/max latency, the median compile phase split from
+# tcc_compile_stats() where applicable, and for warm scenarios the resident
+# memory retained per artifact (RSS growth divided by compiles, Linux only).
+#
+# Usage:
+#   scripts/bench_compile.py [--extension build/release/ducktinycc.duckdb_extension]
+#                            [--iterations 50] [--cold-iterations 5] [--concurrency 1,4,8]
+#                            [--format csv|json] [--output results.csv]
+#
+# Prerequisites:
+#   make release (or pass --extension), and the `duckdb` Python package
+#   (configure/venv provides it).
+
+import argparse
+import csv
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+import duckdb
+
+PROJ = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+SIZES = {"tiny": 1, "medium": 50, "large": 500}
+
+
+def parse_args():
+    p = argparse.ArgumentParser(description="Compile latency of quick_compile and helper-generation modes.")
+    p.add_argument("--extension", default=os.path.join(PROJ, "build", "release", "ducktinycc.duckdb_extension"))
+    p.add_argument("--iterations", type=int, default=50)
+    p.add_argument("--cold-iterations", type=int, default=5)
+    p.add_argument("--concurrency", default="1,4,8")
+    p.add_argument("--format", choices=["csv", "json"], default="csv")
+    p.add_argument("--output", default="-")
+    p.add_argument("--child-cold", action="store_true", help=argparse.SUPPRESS)
+    return p.parse_args()
+
+
+def connect(extension):
+    con = duckdb.connect(config={"allow_unsigned_extensions": "true"})
+    con.execute(f"LOAD '{extension}'")
+    return con
+
+
+def make_source(symbol, helpers):
+    """Returns a translation unit with `helpers` small static functions chained into `symbol`."""
+    parts = []
+    for h in range(helpers):
+        parts.append(
+            f"static long long {symbol}_h{h}(long long x){{\n"
+            f"  long long acc = x;\n"
+            f"  int i;\n"
+            f"  for (i = 0; i < {h % 7 + 1}; i++) acc = acc * 31 + {h} - i;\n"
+            f"  return acc ^ (acc >> 3);\n"
+            f"}}\n"
+        )
+    body = " + ".join(f"{symbol}_h{h}(x)" for h in range(helpers)) or "x"
+    parts.append(f"long long {symbol}(long long x){{ return {body}; }}\n")
+    return "".join(parts)
+
+
+def quick_compile(con, symbol, source, library=None):
+    sql = ("SELECT ok, code, detail FROM tcc_module(mode := 'quick_compile', source := ?, symbol := ?, "
+           "sql_name := ?, return_type := 'i64', arg_types := ['i64']")
+    params = [source, symbol, symbol]
+    if library:
+        sql += ", library := ?"
+        params.append(library)
+    sql += ")"
+    t0 = time.perf_counter()
+    row = con.execute(sql, params).fetchone()
+    elapsed = time.perf_counter() - t0
+    if not row[0]:
+        raise RuntimeError(f"compile failed for {symbol}: {row[1]} {row[2]}")
+    return elapsed
+
+
+def c_struct(con, name, fields):
+    source = "struct %s { %s };" % (name, " ".join(f"long long f{i};" for i in range(fields)))
+    t0 = time.perf_counter()
+    row = con.execute(
+        "SELECT ok, code, detail FROM tcc_module(mode := 'c_struct', source := ?, symbol := ?, arg_types := ?)",
+        [source, name, [f"f{i}:i64" for i in range(fields)]],
+    ).fetchone()
+    elapsed = time.perf_counter() - t0
+    if not row[0]:
+        raise RuntimeError(f"c_struct failed for {name}: {row[1]} {row[2]}")
+    return elapsed
+
+
+def rss_bytes():
+    try:
+        with open("/proc/self/statm") as f:
+            return int(f.read().split()[1]) * os.sysconf("SC_PAGE_SIZE")
+    except (OSError, ValueError):
+        return None
+
+
+def percentile(samples, q):
+    s = sorted(samples)
+    if not s:
+        return None
+    k = min(len(s) - 1, max(0, int(round(q * (len(s) - 1)))))
+    return s[k]
+
+
+def phase_split(con, since_seq):
+    """Median per-phase compile time (ms) from tcc_compile_stats() rows newer than since_seq."""
+    rows = con.execute(
+        "SELECT median(parse_ns), median(codegen_ns), median(setup_ns), median(session_ns), median(compile_ns), "
+        "median(relocate_ns), median(init_ns), median(register_ns) FROM tcc_compile_stats() WHERE seq > ? AND ok",
+        [since_seq],
+    ).fetchone()
+    names = ["parse", "codegen", "setup", "session", "compile", "relocate", "init", "register"]
+    return {f"{n}_ms": (round(v / 1e6, 3) if v is not None else None) for n, v in zip(names, rows)}
+
+
+def last_seq(con):
+    return con.execute("SELECT coalesce(max(seq), 0) FROM tcc_compile_stats()").fetchone()[0]
+
+
+def record(scenario, samples, extra=None):
+    ms = [s * 1e3 for s in samples]
+    r = {
+        "scenario": scenario,
+        "n": len(ms),
+        "p50_ms": round(percentile(ms, 0.5), 3),
+        "p99_ms": round(percentile(ms, 0.99), 3),
+        "max_ms": round(max(ms), 3),
+        "retained_bytes_per_artifact": None,
+    }
+    for n in ["parse", "codegen", "setup", "session", "compile", "relocate", "init", "register"]:
+        r[f"{n}_ms"] = None
+    if extra:
+        r.update(extra)
+    return r
+
+
+def child_cold(args):
+    """Runs in a fresh process: LOAD plus first compile, printed as JSON seconds."""
+    t0 = time.perf_counter()
+    con = connect(args.extension)
+    t1 = time.perf_counter()
+    quick_compile(con, "cold_probe", make_source("cold_probe", 1))
+    t2 = time.perf_counter()
+    print(json.dumps({"load_s": t1 - t0, "first_compile_s": t2 - t1}))
+    return 0
+
+
+def run_cold(args, fresh_tmpdir, shared_tmpdir):
+    env = dict(os.environ)
+    env["TMPDIR"] = tempfile.mkdtemp(prefix="ducktinycc_bench_") if fresh_tmpdir else shared_tmpdir
+    out = subprocess.run([sys.executable, os.path.abspath(__file__), "--child-cold", "--extension", args.extension],
+                         env=env, check=True, capture_output=True, text=True).stdout
+    return json.loads(out.strip().splitlines()[-1])["first_compile_s"]
+
+
+def run_concurrent(con, nthreads, iterations, tag):
+    cursors = [con.cursor() for _ in range(nthreads)]
+    samples = []
+    lock = threading.Lock()
+    barrier = threading.Barrier(nthreads)
+    errors = []
+
+    def worker(t):
+        local = []
+        try:
+            barrier.wait()
+            for i in range(iterations):
+                sym = f"conc_{tag}_{nthreads}_{t}_{i}"
+                local.append(quick_compile(cursors[t], sym, make_source(sym, SIZES["medium"])))
+        except Exception as e:  # noqa: BLE001 - surfaced after join
+            errors.append(e)
+        with lock:
+            samples.extend(local)
+
+    threads = [threading.Thread(target=worker, args=(t,)) for t in range(nthreads)]
+    t0 = time.perf_counter()
+    for th in threads:
+        th.start()
+    for th in threads:
+        th.join()
+    wall = time.perf_counter() - t0
+    if errors:
+        raise errors[0]
+    return samples, wall
+
+
+def main():
+    args = parse_args()
+    if not os.path.exists(args.extension):
+        print(f"extension not found: {args.extension} (run make release or pass --extension)", file=sys.stderr)
+        return 2
+    if args.child_cold:
+        return child_cold(args)
+
+    results = []
+
+    shared_tmpdir = tempfile.mkdtemp(prefix="ducktinycc_bench_shared_")
+    results.append(record("cold_extract", [run_cold(args, True, shared_tmpdir) for _ in range(args.cold_iterations)]))
+    run_cold(args, False, shared_tmpdir)  # populate the shared extraction directory
+    results.append(record("cold_process", [run_cold(args, False, shared_tmpdir) for _ in range(args.cold_iterations)]))
+
+    con = connect(args.extension)
+    quick_compile(con, "warmup_probe", make_source("warmup_probe", 1))
+
+    for size, helpers in SIZES.items():
+        seq = last_seq(con)
+        rss0 = rss_bytes()
+        samples = []
+        for i in range(args.iterations):
+            sym = f"warm_{size}_{i}"
+            samples.append(quick_compile(con, sym, make_source(sym, helpers)))
+        rss1 = rss_bytes()
+        extra = phase_split(con, seq)
+        if rss0 is not None and rss1 is not None:
+            extra["retained_bytes_per_artifact"] = (rss1 - rss0) // max(1, args.iterations)
+        results.append(record(f"warm_{size}", samples, extra))
+
+    seq = last_seq(con)
+    samples = []
+    for i in range(args.iterations):
+        sym = f"libm_{i}"
+        src = f"double sqrt(double);\nlong long {sym}(long long x){{ return (long long)sqrt((double)x); }}\n"
+        samples.append(quick_compile(con, sym, src, library="m"))
+    results.append(record("library_m", samples, phase_split(con, seq)))
+
+    for n in [int(x) for x in args.concurrency.split(",") if x]:
+        per_thread = max(1, args.iterations // n)
+        samples, wall = run_concurrent(con, n, per_thread, "c")
+        results.append(record(f"concurrent_{n}", samples,
+                              {"compiles_per_sec": round(len(samples) / wall, 1) if wall > 0 else None}))
+
+    # Generated helpers allocate with malloc/free, so c_struct needs libc staged in the session;
+    # run it last so the other scenarios compile without it.
+    con.execute("SELECT ok FROM tcc_module(mode := 'add_library', library := 'c')").fetchall()
+    for fields in (5, 20, 50):
+        samples = [c_struct(con, f"bench_struct_{fields}_{i}", fields) for i in range(args.iterations)]
+        results.append(record(f"c_struct_{fields}", samples))
+
+    fields = []
+    for r in results:
+        for k in r:
+            if k not in fields:
+                fields.append(k)
+    out = sys.stdout if args.output == "-" else open(args.output, "w", newline="")
+    try:
+        if args.format == "json":
+            for r in results:
+                out.write(json.dumps(r) + "\n")
+        else:
+            w = csv.DictWriter(out, fieldnames=fields, restval="")
+            w.writeheader()
+            w.writerows(results)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
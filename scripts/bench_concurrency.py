@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+# scripts/bench_concurrency.py
+#
+# Concurrency stress benchmark for generated UDF execution, `tcc_module`
+# compiles, and the pointer registry behind `tcc_alloc`/`tcc_read_*`.
+#
+# Workloads (each worker is one Python thread on its own DuckDB cursor and loops
+# for --duration seconds):
+#   udf        `SELECT sum(conc_add(i, 1)) FROM range(--udf-rows)` with the
+#              database running --db-threads execution threads
+#   compile    `quick_compile` of a distinct small function per iteration
+#              (module-state write lock)
+#   introspect `SELECT count(*) FROM tcc_functions()` (module-state read lock)
+#   registry   alloc + write + read + free of --registry-rows handles per query
+#              (pointer-registry spin lock, 4 acquisitions per row)
+#
+# Scenarios run each workload alone at every --threads count, then `mixed`,
+# which runs udf, compile, introspect and registry workers at once (the
+# "queries on all cores while a deploy compiles" shape).
+#
+# Each record reports operations, ops/sec, p50/p99/max latency per operation
+# (one query or one compile), and the lock wait deltas from tcc_lock_stats()
+# over the scenario: acquisitions, contended acquisitions, total wait and the
+# process-lifetime max wait for the module-state RW lock (read/write) and the
+# pointer-registry spin lock.
+#
+# Usage:
+#   scripts/bench_concurrency.py [--extension build/release/ducktinycc.duckdb_extension]
+#                                [--threads 1,8,32] [--duration 3] [--db-threads N]
+#                                [--workloads udf,compile,introspect,registry,mixed]
+#                                [--format csv|json] [--output results.csv]
+#
+# Prerequisites:
+#   make release (or pass --extension), and the `duckdb` Python package
+#   (configure/venv provides it).
+
+import argparse
+import csv
+import json
+import os
+import sys
+import threading
+import time
+
+import duckdb
+
+PROJ = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+WORKLOADS = ["udf", "compile", "introspect", "registry"]
+
+LOCKS = [("module_state", "read"), ("module_state", "write"), ("ptr_registry", "spin")]
+
+
+def parse_args():
+    p = argparse.ArgumentParser(description="Concurrent UDF execution, compile and pointer-registry stress benchmark.")
+    p.add_argument("--extension", default=os.path.join(PROJ, "build", "release", "ducktinycc.duckdb_extension"))
+    p.add_argument("--threads", default="1,8,32")
+    p.add_argument("--duration", type=float, default=3.0)
+    p.add_argument("--db-threads", type=int, default=os.cpu_count() or 1)
+    p.add_argument("--udf-rows", type=int, default=1000000)
+    p.add_argument("--registry-rows", type=int, default=2048)
+    p.add_argument("--workloads", default="udf,compile,introspect,registry,mixed")
+    p.add_argument("--format", choices=["csv", "json"], default="csv")
+    p.add_argument("--output", default="-")
+    return p.parse_args()
+
+
+def connect(extension):
+    con = duckdb.connect(config={"allow_unsigned_extensions": "true"})
+    con.execute(f"LOAD '{extension}'")
+    return con
+
+
+def quick_compile(cur, symbol, source):
+    row = cur.execute(
+        "SELECT ok, code, detail FROM tcc_module(mode := 'quick_compile', source := ?, symbol := ?, "
+        "sql_name := ?, return_type := 'i64', arg_types := ['i64', 'i64'], wrapper_mode := 'chunk_scalar_loop')",
+        [source, symbol, symbol],
+    ).fetchone()
+    if not row[0]:
+        raise RuntimeError(f"compile failed for {symbol}: {row[1]} {row[2]}")
+
+
+class Counter:
+    """Hands out unique compile symbols across workers and scenarios."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.n = 0
+
+    def next(self):
+        with self.lock:
+            self.n += 1
+            return self.n
+
+
+def make_op(workload, cur, args, symbols):
+    if workload == "udf":
+        sql = f"SELECT sum(conc_add(i, 1)) FROM range({args.udf_rows}) t(i)"
+        return lambda: cur.execute(sql).fetchall()
+    if workload == "compile":
+        def op():
+            sym = f"conc_fn_{symbols.next()}"
+            quick_compile(cur, sym, f"long long {sym}(long long a, long long b){{ return a * 31 + b; }}")
+        return op
+    if workload == "introspect":
+        return lambda: cur.execute("SELECT count(*) FROM tcc_functions()").fetchall()
+    if workload == "registry":
+        # Each row allocates a handle, writes it, reads it back and frees it; the nesting forces that order.
+        sql = (f"SELECT sum(r), bool_and(tcc_free_ptr(h)) FROM ("
+               f"SELECT h, CASE WHEN w THEN tcc_read_i64(h, 0) END AS r FROM ("
+               f"SELECT h, tcc_write_i64(h, 0, i) AS w FROM ("
+               f"SELECT i, tcc_alloc(8) AS h FROM range({args.registry_rows}) t(i))))")
+        expected = args.registry_rows * (args.registry_rows - 1) // 2
+
+        def op():
+            total, freed = cur.execute(sql).fetchone()
+            if total != expected or not freed:
+                raise RuntimeError(f"registry round trip mismatch: sum={total} freed={freed}")
+        return op
+    raise ValueError(workload)
+
+
+def lock_snapshot(con):
+    rows = con.execute("SELECT lock, kind, acquisitions, contended, wait_ns, max_wait_ns FROM tcc_lock_stats()").fetchall()
+    return {(r[0], r[1]): r[2:] for r in rows}
+
+
+def percentile(samples, q):
+    s = sorted(samples)
+    if not s:
+        return None
+    k = min(len(s) - 1, max(0, int(round(q * (len(s) - 1)))))
+    return s[k]
+
+
+def run_scenario(con, plan, args, symbols):
+    """plan is a list of (workload, nthreads). Returns per-workload samples and the wall time."""
+    workers = []
+    for workload, n in plan:
+        for _ in range(n):
+            cur = con.cursor()
+            workers.append((workload, make_op(workload, cur, args, symbols)))
+    samples = {w: [] for w, _ in plan}
+    errors = []
+    lock = threading.Lock()
+    barrier = threading.Barrier(len(workers) + 1)
+    deadline = [0.0]
+
+    def worker(workload, op):
+        local = []
+        try:
+            barrier.wait()
+            while time.perf_counter() < deadline[0]:
+                t0 = time.perf_counter()
+                op()
+                local.append(time.perf_counter() - t0)
+        except Exception as e:  # noqa: BLE001 - surfaced after join
+            errors.append(e)
+        with lock:
+            samples[workload].extend(local)
+
+    threads = [threading.Thread(target=worker, args=w) for w in workers]
+    for th in threads:
+        th.start()
+    t0 = time.perf_counter()
+    deadline[0] = t0 + args.duration
+    barrier.wait()
+    for th in threads:
+        th.join()
+    wall = time.perf_counter() - t0
+    if errors:
+        raise errors[0]
+    return samples, wall
+
+
+def lock_columns(before, after):
+    out = {}
+    for key in LOCKS:
+        prefix = f"{key[0]}_{key[1]}"
+        b = before.get(key, (0, 0, 0, 0))
+        a = after.get(key, (0, 0, 0, 0))
+        out[f"{prefix}_acquisitions"] = a[0] - b[0]
+        out[f"{prefix}_contended"] = a[1] - b[1]
+        out[f"{prefix}_wait_ms"] = round((a[2] - b[2]) / 1e6, 3)
+        out[f"{prefix}_max_wait_ms"] = round(a[3] / 1e6, 3)
+    return out
+
+
+def records(scenario, plan, samples, wall, locks):
+    out = []
+    for workload, n in plan:
+        ms = [s * 1e3 for s in samples[workload]]
+        r = {
+            "scenario": scenario,
+            "workload": workload,
+            "threads": n,
+            "ops": len(ms),
+            "seconds": round(wall, 3),
+            "ops_per_sec": round(len(ms) / wall, 1) if wall > 0 else None,
+            "p50_ms": round(percentile(ms, 0.5), 3) if ms else None,
+            "p99_ms": round(percentile(ms, 0.99), 3) if ms else None,
+            "max_ms": round(max(ms), 3) if ms else None,
+        }
+        r.update(locks)
+        out.append(r)
+    return out
+
+
+def main():
+    args = parse_args()
+    if not os.path.exists(args.extension):
+        print(f"extension not found: {args.extension} (run make release or pass --extension)", file=sys.stderr)
+        return 2
+    thread_counts = [int(x) for x in args.threads.split(",") if x]
+    wanted = [x for x in args.workloads.split(",") if x]
+
+    con = connect(args.extension)
+    con.execute(f"SET threads = {args.db_threads}")
+    quick_compile(con, "conc_add", "long long conc_add(long long a, long long b){ return a + b; }")
+    symbols = Counter()
+
+    results = []
+    for n in thread_counts:
+        for workload in WORKLOADS:
+            if workload not in wanted:
+                continue
+            plan = [(workload, n)]
+            before = lock_snapshot(con)
+            samples, wall = run_scenario(con, plan, args, symbols)
+            results.extend(records(workload, plan, samples, wall, lock_columns(before, lock_snapshot(con))))
+        if "mixed" in wanted:
+            # Query traffic on every requested worker plus a steady trickle of deploy/introspection/registry work.
+            side = max(1, n // 8)
+            plan = [("udf", n), ("compile", side), ("introspect", side), ("registry", side)]
+            before = lock_snapshot(con)
+            samples, wall = run_scenario(con, plan, args, symbols)
+            results.extend(records(f"mixed_{n}", plan, samples, wall, lock_columns(before, lock_snapshot(con))))
+
+    fields = []
+    for r in results:
+        for k in r:
+            if k not in fields:
+                fields.append(k)
+    out = sys.stdout if args.output == "-" else open(args.output, "w", newline="")
+    try:
+        if args.format == "json":
+            for r in results:
+                out.write(json.dumps(r) + "\n")
+        else:
+            w = csv.DictWriter(out, fieldnames=fields or ["scenario"], restval="")
+            w.writeheader()
+            w.writerows(results)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
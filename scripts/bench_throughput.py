@@ -0,0 +1,352 @@
+#!/usr/bin/env python3
+# scripts/bench_throughput.py
+#
+# Rows/second benchmark for generated UDFs across wrapper ABIs, compared with
+# the equivalent native DuckDB expression.
+#
+# Every case is compiled once per wrapper mode (`row`, `chunk_scalar_loop`, and
+# `arrow` for cases with an Arrow kernel) and evaluated over a pre-materialized
+# input table for each NULL density and thread count. The query shape is
+# `SELECT sum(hash(<expr>)) FROM input` so the UDF result is consumed but no
+# large result set is produced. Each UDF result must equal the native
+# expression's before its timing is recorded; a mismatch aborts the run.
+#
+# Output is machine-readable (CSV by default, `--format json` for JSON lines),
+# one record per (case, abi, null_ratio, threads).
+#
+# Usage:
+#   scripts/bench_throughput.py [--extension build/release/ducktinycc.duckdb_extension]
+#                               [--rows 1000000] [--threads 1,4] [--null-ratios 0,0.1,0.5]
+#                               [--repeat 3] [--cases scalar_i64,varchar] [--format csv|json]
+#                               [--output results.csv]
+#
+# Prerequisites:
+#   make release (or pass --extension), and the `duckdb` Python package
+#   (configure/venv provides it).
+
+import argparse
+import csv
+import json
+import os
+import statistics
+import sys
+import time
+
+import duckdb
+
+PROJ = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+# Input columns are generated without NULLs and then NULLed per column with an
+# UPDATE, since CASE does not support every nested type (e.g. FLOAT[4]).
+INPUT_COLUMNS = {
+    "a": "(i % 1000)::BIGINT",
+    "b": "(i % 7)::BIGINT",
+    "s": "'row-' || (i % 997)::VARCHAR",
+    "bl": "encode('blob-' || (i % 251)::VARCHAR)",
+    "l": "[i % 3, i % 5, i % 11]::DOUBLE[]",
+    "fa": "[i % 3, i % 5, i % 7, i % 11]::FLOAT[4]",
+    "st": "{'x': (i % 13)::BIGINT, 'y': (i % 17)::BIGINT}",
+    "m": "MAP([1::BIGINT, 2::BIGINT], [(i % 19)::BIGINT, (i % 23)::BIGINT])",
+    "u": "CASE WHEN i % 2 = 0 THEN (i % 29)::BIGINT::UNION(i BIGINT, d DOUBLE) "
+         "ELSE (i % 31)::DOUBLE::UNION(i BIGINT, d DOUBLE) END",
+}
+
+CASES = [
+    {
+        "name": "scalar_i64",
+        "source": "long long bench_add(long long a, long long b){ return a + b; }",
+        "symbol": "bench_add",
+        "return_type": "i64",
+        "arg_types": ["i64", "i64"],
+        "args": "a, b",
+        "native": "a + b",
+        "arrow_symbol": "bench_add_arrow",
+        "arrow_source": """_Bool bench_add_arrow(const struct ArrowSchema *schema, const struct ArrowArray *input, struct ArrowArray *out){
+  const struct ArrowArray *a = input->children[0];
+  const struct ArrowArray *b = input->children[1];
+  const int64_t *x = (const int64_t *)a->buffers[1];
+  const int64_t *y = (const int64_t *)b->buffers[1];
+  const uint8_t *xv = (const uint8_t *)a->buffers[0];
+  const uint8_t *yv = (const uint8_t *)b->buffers[0];
+  uint8_t *ov = (uint8_t *)out->buffers[0];
+  int64_t *o = (int64_t *)out->buffers[1];
+  (void)schema;
+  for (int64_t i = 0; i < input->length; i++) {
+    if ((xv && !((xv[i >> 3] >> (i & 7)) & 1)) || (yv && !((yv[i >> 3] >> (i & 7)) & 1))) {
+      ov[i >> 3] &= (uint8_t)~(1u << (i & 7));
+      continue;
+    }
+    o[i] = x[i] + y[i];
+  }
+  return 1;
+}""",
+    },
+    {
+        "name": "varchar",
+        "source": "const char *bench_vc_echo(const char *s){ return s; }",
+        "symbol": "bench_vc_echo",
+        "return_type": "varchar",
+        "arg_types": ["varchar"],
+        "args": "s",
+        "native": "s",
+        "arrow_symbol": "bench_vc_echo_arrow",
+        "arrow_source": """static void bench_vc_echo_release(struct ArrowArray *a){ a->release = 0; }
+_Bool bench_vc_echo_arrow(const struct ArrowSchema *schema, const struct ArrowArray *input, struct ArrowArray *out){
+  const struct ArrowArray *s = input->children[0];
+  (void)schema;
+  out->length = s->length;
+  out->offset = s->offset;
+  out->null_count = s->null_count;
+  out->n_buffers = 3;
+  out->buffers = s->buffers;
+  out->release = bench_vc_echo_release;
+  return 1;
+}""",
+    },
+    {
+        "name": "blob",
+        "source": "unsigned long long bench_blob_len(ducktinycc_blob_t b){ return b.ptr ? b.len : 0ULL; }",
+        "symbol": "bench_blob_len",
+        "return_type": "u64",
+        "arg_types": ["blob"],
+        "args": "bl",
+        "native": "octet_length(bl)::UBIGINT",
+        "arrow_symbol": "bench_blob_len_arrow",
+        "arrow_source": """_Bool bench_blob_len_arrow(const struct ArrowSchema *schema, const struct ArrowArray *input, struct ArrowArray *out){
+  const struct ArrowArray *b = input->children[0];
+  const int32_t *off = (const int32_t *)b->buffers[1];
+  const uint8_t *bv = (const uint8_t *)b->buffers[0];
+  uint8_t *ov = (uint8_t *)out->buffers[0];
+  uint64_t *o = (uint64_t *)out->buffers[1];
+  (void)schema;
+  for (int64_t i = 0; i < input->length; i++) {
+    int64_t j = i + b->offset;
+    if (bv && !((bv[j >> 3] >> (j & 7)) & 1)) {
+      ov[i >> 3] &= (uint8_t)~(1u << (i & 7));
+      continue;
+    }
+    o[i] = (uint64_t)(off[j + 1] - off[j]);
+  }
+  return 1;
+}""",
+    },
+    {
+        "name": "list_f64",
+        "source": """double bench_list_sum(ducktinycc_list_t a){
+  const double *p = (const double *)a.ptr;
+  unsigned long long i;
+  double s = 0;
+  if (!a.ptr) return 0;
+  for (i = 0; i < a.len; i++) {
+    if (ducktinycc_list_is_valid(&a, i)) s += p[i];
+  }
+  return s;
+}""",
+        "symbol": "bench_list_sum",
+        "return_type": "f64",
+        "arg_types": ["list<f64>"],
+        "args": "l",
+        "native": "list_sum(l)",
+    },
+    {
+        "name": "array_f32x4",
+        "source": """double bench_array_sum(ducktinycc_array_t a){
+  const float *p = (const float *)a.ptr;
+  unsigned long long i;
+  double s = 0;
+  if (!a.ptr) return 0;
+  for (i = 0; i < a.len; i++) {
+    if (ducktinycc_array_is_valid(&a, i)) s += p[i];
+  }
+  return s;
+}""",
+        "symbol": "bench_array_sum",
+        "return_type": "f64",
+        "arg_types": ["f32[4]"],
+        "args": "fa",
+        "native": "list_sum(fa::DOUBLE[])",
+    },
+    {
+        "name": "struct",
+        "source": """long long bench_struct_sum(ducktinycc_struct_t s){
+  const long long *x;
+  const long long *y;
+  long long out = 0;
+  if (!s.field_ptrs || s.field_count < 2) return 0;
+  x = (const long long *)ducktinycc_struct_field_ptr(&s, 0);
+  y = (const long long *)ducktinycc_struct_field_ptr(&s, 1);
+  if (x && ducktinycc_struct_field_is_valid(&s, 0)) out += x[s.offset];
+  if (y && ducktinycc_struct_field_is_valid(&s, 1)) out += y[s.offset];
+  return out;
+}""",
+        "symbol": "bench_struct_sum",
+        "return_type": "i64",
+        "arg_types": ["struct<x:i64;y:i64>"],
+        "args": "st",
+        "native": "st.x + st.y",
+    },
+    {
+        "name": "map",
+        "source": """long long bench_map_sum(ducktinycc_map_t m){
+  const long long *k = (const long long *)m.key_ptr;
+  const long long *v = (const long long *)m.value_ptr;
+  unsigned long long i;
+  long long out = 0;
+  if (!m.key_ptr || !m.value_ptr) return 0;
+  for (i = 0; i < m.len; i++) {
+    if (ducktinycc_map_key_is_valid(&m, i) && ducktinycc_map_value_is_valid(&m, i)) out += k[i] + v[i];
+  }
+  return out;
+}""",
+        "symbol": "bench_map_sum",
+        "return_type": "i64",
+        "arg_types": ["map<i64;i64>"],
+        "args": "m",
+        "native": "list_sum(map_keys(m)) + list_sum(map_values(m))",
+    },
+    {
+        "name": "union",
+        "source": """long long bench_union_read(ducktinycc_union_t u){
+  int tag = ducktinycc_union_tag(&u);
+  if (tag == 0) {
+    const long long *p = (const long long *)ducktinycc_union_member_ptr(&u, 0);
+    return p ? p[u.offset] : 0;
+  }
+  if (tag == 1) {
+    const double *p = (const double *)ducktinycc_union_member_ptr(&u, 1);
+    return p ? (long long)p[u.offset] : 0;
+  }
+  return 0;
+}""",
+        "symbol": "bench_union_read",
+        "return_type": "i64",
+        "arg_types": ["union<i:i64;d:f64>"],
+        "args": "u",
+        "native": "CASE union_tag(u) WHEN 'i' THEN union_extract(u, 'i') ELSE union_extract(u, 'd')::BIGINT END",
+    },
+]
+
+# `arrow` kernels take the whole chunk as an Arrow struct array, so only cases
+# with an `arrow_source` (flat types the arrow ABI supports) run in that mode.
+WRAPPER_MODES = ["row", "chunk_scalar_loop", "arrow"]
+
+
+def parse_args():
+    p = argparse.ArgumentParser(description="Rows/sec of generated UDFs per wrapper ABI vs native DuckDB expressions.")
+    p.add_argument("--extension", default=os.path.join(PROJ, "build", "release", "ducktinycc.duckdb_extension"))
+    p.add_argument("--rows", type=int, default=1000000)
+    p.add_argument("--threads", default="1,4")
+    p.add_argument("--null-ratios", default="0,0.1,0.5")
+    p.add_argument("--repeat", type=int, default=3)
+    p.add_argument("--cases", default="", help="comma-separated subset of case names")
+    p.add_argument("--format", choices=["csv", "json"], default="csv")
+    p.add_argument("--output", default="-")
+    return p.parse_args()
+
+
+def connect(extension):
+    con = duckdb.connect(config={"allow_unsigned_extensions": "true"})
+    con.execute(f"LOAD '{extension}'")
+    return con
+
+
+def case_modes(case):
+    return [m for m in WRAPPER_MODES if m != "arrow" or "arrow_source" in case]
+
+
+def compile_case(con, case, mode):
+    sql_name = f"{case['symbol']}_{mode}"
+    source, symbol = (case["arrow_source"], case["arrow_symbol"]) if mode == "arrow" else (case["source"], case["symbol"])
+    row = con.execute(
+        "SELECT ok, code, detail FROM tcc_module(mode := 'quick_compile', source := ?, symbol := ?, "
+        "sql_name := ?, return_type := ?, arg_types := ?, wrapper_mode := ?)",
+        [source, symbol, sql_name, case["return_type"], case["arg_types"], mode],
+    ).fetchone()
+    if not row[0]:
+        raise RuntimeError(f"compile failed for {case['name']} ({mode}): {row[1]} {row[2]}")
+    return sql_name
+
+
+def build_inputs(con, rows, null_ratios):
+    tables = {}
+    for ratio in null_ratios:
+        table = "bench_input_" + str(ratio).replace(".", "_")
+        cols = ", ".join(f"{expr} AS {name}" for name, expr in INPUT_COLUMNS.items())
+        con.execute(f"CREATE OR REPLACE TABLE {table} AS SELECT i, {cols} FROM range({rows}) t(i)")
+        threshold = int(round(ratio * 1000))
+        if threshold > 0:
+            for seed, name in enumerate(INPUT_COLUMNS):
+                con.execute(f"UPDATE {table} SET {name} = NULL WHERE hash(i * 31 + {seed}) % 1000 < {threshold}")
+        tables[ratio] = table
+    return tables
+
+
+def time_query(con, sql, repeat, expected=None, label=""):
+    result = con.execute(sql).fetchone()[0]  # warm-up, and the value checked against native
+    if expected is not None and result != expected:
+        raise RuntimeError(f"{label}: result {result} differs from native {expected}")
+    samples = []
+    for _ in range(repeat):
+        t0 = time.perf_counter()
+        con.execute(sql).fetchall()
+        samples.append(time.perf_counter() - t0)
+    return statistics.median(samples), result
+
+
+def main():
+    args = parse_args()
+    if not os.path.exists(args.extension):
+        print(f"extension not found: {args.extension} (run make release or pass --extension)", file=sys.stderr)
+        return 2
+    threads = [int(x) for x in args.threads.split(",") if x]
+    null_ratios = [float(x) for x in args.null_ratios.split(",") if x]
+    wanted = set(x for x in args.cases.split(",") if x)
+    cases = [c for c in CASES if not wanted or c["name"] in wanted]
+
+    con = connect(args.extension)
+    tables = build_inputs(con, args.rows, null_ratios)
+    compiled = {(c["name"], m): compile_case(con, c, m) for c in cases for m in case_modes(c)}
+
+    results = []
+    for case in cases:
+        for ratio in null_ratios:
+            table = tables[ratio]
+            for nthreads in threads:
+                con.execute(f"SET threads = {nthreads}")
+                native_s, expected = time_query(con, f"SELECT sum(hash({case['native']})) FROM {table}", args.repeat)
+                variants = [("native", native_s)]
+                for mode in case_modes(case):
+                    fn = compiled[(case["name"], mode)]
+                    sql = f"SELECT sum(hash({fn}({case['args']}))) FROM {table}"
+                    label = f"{case['name']} ({mode}, null_ratio={ratio}, threads={nthreads})"
+                    seconds, _ = time_query(con, sql, args.repeat, expected, label)
+                    variants.append((mode, seconds))
+                for abi, seconds in variants:
+                    results.append({
+                        "case": case["name"],
+                        "abi": abi,
+                        "null_ratio": ratio,
+                        "threads": nthreads,
+                        "rows": args.rows,
+                        "seconds": round(seconds, 6),
+                        "rows_per_sec": round(args.rows / seconds) if seconds > 0 else None,
+                        "slowdown_vs_native": round(seconds / native_s, 3) if native_s > 0 else None,
+                    })
+
+    out = sys.stdout if args.output == "-" else open(args.output, "w", newline="")
+    try:
+        if args.format == "json":
+            for r in results:
+                out.write(json.dumps(r) + "\n")
+        else:
+            w = csv.DictWriter(out, fieldnames=list(results[0].keys()) if results else ["case"])
+            w.writeheader()
+            w.writerows(results)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
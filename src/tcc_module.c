@@ -55,7 +55,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 #include <stdarg.h>
+#include <time.h>
 #ifdef _WIN32
 #include <io.h>
 #include <direct.h>   /* _mkdir */
@@ -73,6 +75,37 @@
 #define TCC_MKDIR(p) (mkdir((p), 0755) == 0 || errno == EEXIST)
 #endif
 
+#if !defined(DUCKTINYCC_WASM_UNSUPPORTED) && !defined(_WIN32)
+/* `isolation := 'process'`: generated UDFs run in forked workers fed through shared-memory chunk slots. */
+#define TCC_ISOLATION_SUPPORTED 1
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/* tcc_mutex_t: blocking lock for code that may hold it across user I/O (sinks). */
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
+#if !defined(DUCKTINYCC_WASM_UNSUPPORTED) && !defined(_WIN32)
+/* `mode := 'file_reader'` scans memory-map their input file. */
+#define TCC_READER_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 DUCKDB_EXTENSION_EXTERN
 
 /* BEGIN: TCC_FUNCTION_CATALOG
@@ -82,21 +115,28 @@ DUCKDB_EXTENSION_EXTERN
  * Purpose: quick ownership/audit reference when changing runtime, codegen, and bridge logic.
  */
 /* - RegisterTccModuleFunction: Registers `tcc_module` plus diagnostic/probe table functions on a DuckDB connection. */
+/* - destroy_tcc_code_info_bind_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
+/* - destroy_tcc_compile_stats_bind_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
 /* - destroy_tcc_diag_bind_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
 /* - destroy_tcc_diag_init_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
+/* - destroy_tcc_functions_bind_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
 /* - destroy_tcc_module_bind_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
 /* - destroy_tcc_module_init_data: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
 /* - destroy_tcc_module_state: Destructor callback for bind/init/state allocations owned by DuckDB function/table contexts. */
+/* - destroy_tcc_read_bind_data: Destructor for tcc_read bind payloads. */
+/* - destroy_tcc_read_init_data: Destructor for tcc_read global scan state. */
 /* - ducktinycc_array_elem_ptr: ARRAY descriptor accessor helper for generated wrappers. */
 /* - ducktinycc_array_is_valid: ARRAY descriptor accessor helper for generated wrappers. */
 /* - ducktinycc_buf_ptr_at: Range-checked pointer lookup inside raw byte buffers. */
 /* - ducktinycc_buf_ptr_at_mut: Range-checked pointer lookup inside raw byte buffers. */
 /* - ducktinycc_list_elem_ptr: LIST descriptor accessor helper for generated wrappers. */
 /* - ducktinycc_list_is_valid: LIST descriptor accessor helper for generated wrappers. */
+/* - ducktinycc_map_find: MAP key lookup helper probing a per-chunk hash index over the map's keys. */
 /* - ducktinycc_map_key_is_valid: MAP descriptor accessor helper for generated wrappers. */
 /* - ducktinycc_map_key_ptr: MAP descriptor accessor helper for generated wrappers. */
 /* - ducktinycc_map_value_is_valid: MAP descriptor accessor helper for generated wrappers. */
 /* - ducktinycc_map_value_ptr: MAP descriptor accessor helper for generated wrappers. */
+/* - ducktinycc_out_alloc: Host-exported bump allocator for variable-size return payloads of the executing chunk. */
 /* - ducktinycc_ptr_add: Pointer arithmetic helper for generated wrapper code. */
 /* - ducktinycc_ptr_add_mut: Pointer arithmetic helper for generated wrapper code. */
 /* - ducktinycc_read_bytes: Typed read helper from raw memory or bridge descriptors. */
@@ -133,8 +173,14 @@ DUCKDB_EXTENSION_EXTERN
 /* - ducktinycc_write_u32: Typed write helper into raw memory or bridge descriptors. */
 /* - ducktinycc_write_u64: Typed write helper into raw memory or bridge descriptors. */
 /* - ducktinycc_write_u8: Typed write helper into raw memory or bridge descriptors. */
+/* - register_tcc_code_info_function: Registers extension helper functions/tables into DuckDB. */
+/* - register_tcc_compile_expr_function: Registers the tcc_compile_expr table function over the shared module dispatcher. */
+/* - register_tcc_compile_stats_function: Registers extension helper functions/tables into DuckDB. */
+/* - register_tcc_functions_function: Registers extension helper functions/tables into DuckDB. */
 /* - register_tcc_library_probe_function: Registers extension helper functions/tables into DuckDB. */
+/* - register_tcc_lock_stats_function: Registers extension helper functions/tables into DuckDB. */
 /* - register_tcc_pointer_helper_functions: Registers extension helper functions/tables into DuckDB. */
+/* - register_tcc_read_function: Registers tcc_read and its replacement scan. */
 /* - register_tcc_system_paths_function: Registers extension helper functions/tables into DuckDB. */
 /* - tcc_add_host_symbols: Registers host-exported symbols into each TinyCC state for generated wrappers. */
 /* - tcc_add_platform_library_paths: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
@@ -143,9 +189,24 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_append_error: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_apply_bind_overrides_to_state: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_apply_session_to_state: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_arrow_bit_is_set: Arrow bitmap bit test used by the arrow wrapper import path. */
+/* - tcc_arrow_export_varlen_column: Copies one VARCHAR/BLOB column into Arrow offsets + data buffers for the arrow wrapper. */
+/* - tcc_arrow_format_for_type: Maps scalar FFI types to Arrow format strings; gates which types `wrapper_mode := 'arrow'` accepts. */
+/* - tcc_arrow_release_borrowed_array: No-op release callback for host-owned Arrow array views. */
+/* - tcc_arrow_release_borrowed_schema: No-op release callback for the host-owned Arrow schema. */
+/* - tcc_arrow_schema_init: Builds the immutable Arrow input schema stored in the UDF signature context. */
+/* - tcc_arrow_type_is_varlen: Arrow layout predicate for offsets + data (VARCHAR/BLOB) types. */
 /* - tcc_artifact_destroy: Releases compiled TinyCC module artifact resources. */
+/* - tcc_artifact_release_failed_init: Artifact helper keeping a failed init's code alive if it registered anything. */
 /* - tcc_basename_ptr: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
-/* - tcc_bind_read_named_arg_types: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_bench_clock_cost_ns: Estimates the per-call cost of the monotonic clock for bench split correction. */
+/* - tcc_bench_create_type: Builds the STRUCT logical type of the bench result column. */
+/* - tcc_bench_fill_primitive: Fills a primitive vector with synthesized bench values. */
+/* - tcc_bench_fill_vector: Recursively fills a (nested) vector with synthesized bench values. */
+/* - tcc_bench_find_ctx: Finds the host signature context of a registered UDF by sql_name. */
+/* - tcc_bench_row_is_null: Deterministic per-row/column NULL decision for synthesized bench inputs. */
+/* - tcc_bind_overrides_units: Shared-base eligibility check for per-call compile overrides. */
+/* - tcc_bind_read_named_list_csv: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_bind_read_named_varchar: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_build_c_composite_bindings: Builder helper for bridge objects, helper source/bindings, module artifacts, or search candidates. */
 /* - tcc_build_c_enum_bindings: Builder helper for bridge objects, helper source/bindings, module artifacts, or search candidates. */
@@ -156,10 +217,17 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_c_field_list_append: Dynamic field metadata list utility for c_struct/c_union/c_bitfield helper codegen. */
 /* - tcc_c_field_list_destroy: Dynamic field metadata list utility for c_struct/c_union/c_bitfield helper codegen. */
 /* - tcc_c_field_list_reserve: Dynamic field metadata list utility for c_struct/c_union/c_bitfield helper codegen. */
+/* - tcc_code_info_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_code_info_clear: Releases a collected module code layout. */
+/* - tcc_code_info_collect: Copies per-function address/size/bytes/disassembly of a registered module. */
+/* - tcc_code_info_find_artifact: Resolves a compiled module artifact by compile or UDF sql_name. */
+/* - tcc_code_info_table_function: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
 /* - tcc_codegen_build_compilation_unit: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
 /* - tcc_codegen_classify_error_message: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
 /* - tcc_codegen_compile_and_load_module: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
 /* - tcc_codegen_generate_wrapper_source: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
+/* - tcc_codegen_load_unit: Codegen helper compiling a complete wrapper+loader unit and running its module init. */
+/* - tcc_codegen_prepare_generic_sources: Codegen helper expanding a type_params kernel into per-type overloads in one compilation unit. */
 /* - tcc_codegen_prepare_sources: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
 /* - tcc_codegen_signature_ctx_destroy: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
 /* - tcc_codegen_signature_ctx_init: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
@@ -169,9 +237,19 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_codegen_source_ctx_init: Code generation helper for wrapper source assembly, classification, and compile/load flow. */
 /* - tcc_collect_include_paths: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_collect_library_search_paths: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_columnar_return_supported: Signature check that a chunk_columnar STRUCT return has only fixed-width fields. */
+/* - tcc_compile_expr_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
 /* - tcc_compile_generated_binding: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_compile_stats_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_compile_stats_clear: Releases the compile timing history ring. */
+/* - tcc_compile_stats_collect: Copies the compile timing history (oldest first) for tcc_compile_stats(). */
+/* - tcc_compile_stats_record: Appends one compile to the per-state timing history ring. */
+/* - tcc_compile_stats_table_function: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_compile_timings_create_type: Builds the STRUCT logical type of the tcc_module timings column. */
+/* - tcc_compile_timings_values: Flattens compile timings into column order. */
 /* - tcc_configure_runtime_paths: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_copy_duckdb_string_as_cstr: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_count_null_rows: Counts rows where any of several validity masks marks NULL. */
 /* - tcc_dataptr_scalar: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_default_runtime_path: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_ensure_embedded_runtime: Extracts embedded libtcc1.a + headers to a temp dir; returns the stable extraction path. */
@@ -187,7 +265,49 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_effective_sql_name: Resolves effective symbol/SQL name from bind args and session defaults. */
 /* - tcc_effective_symbol: Resolves effective symbol/SQL name from bind args and session defaults. */
 /* - tcc_equals_ci: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_execute_arrow_scalar_udf: Runtime bridge for `arrow` wrappers: exports the chunk as Arrow arrays and imports the result array. */
+/* - tcc_execute_chunk: Dispatches one chunk to the Arrow or compiled executor for a registered signature. */
 /* - tcc_execute_compiled_scalar_udf: Main runtime bridge for executing compiled row/chunk-scalar-loop wrappers and marshaling values. */
+/* - tcc_execute_scalar_udf: Registered DuckDB entry point for generated UDFs: dispatches to the mode bridge and updates runtime counters. */
+/* - tcc_expr_build_kernel: Expression compiler builder for the batch kernel compilation unit. */
+/* - tcc_expr_c_type: Expression compiler mapping from node type to kernel C type. */
+/* - tcc_expr_common_type: Expression compiler DuckDB-style implicit common type of two operands. */
+/* - tcc_expr_emit: Expression compiler emitter for one typed node. */
+/* - tcc_expr_emit_arith: Expression compiler emitter for checked arithmetic. */
+/* - tcc_expr_emit_cast: Expression compiler emitter for DuckDB CAST semantics. */
+/* - tcc_expr_expect_kw: Expression compiler token consumer. */
+/* - tcc_expr_expect_op: Expression compiler token consumer. */
+/* - tcc_expr_fail: Expression compiler error reporter with source offset. */
+/* - tcc_expr_int_limits: Expression compiler integer range bounds as C literals and int64 values. */
+/* - tcc_expr_int_width: Expression compiler integer byte width used for DuckDB-style promotion. */
+/* - tcc_expr_is_kw: Expression compiler token predicate. */
+/* - tcc_expr_is_op: Expression compiler token predicate. */
+/* - tcc_expr_literal_fits: Expression compiler check whether an integer literal fits a type. */
+/* - tcc_expr_lookup_type_name: Expression compiler SQL/ffi type-name lookup. */
+/* - tcc_expr_make: Expression compiler typed node constructor. */
+/* - tcc_expr_make_arith: Expression compiler typed arithmetic constructor. */
+/* - tcc_expr_make_compare: Expression compiler typed comparison constructor. */
+/* - tcc_expr_new_node: Expression compiler node-pool allocator. */
+/* - tcc_expr_next: Expression compiler lexer step. */
+/* - tcc_expr_parse_add: Expression compiler parser for additive operators. */
+/* - tcc_expr_parse_and: Expression compiler parser for AND. */
+/* - tcc_expr_parse_case_tail: Expression compiler parser lowering CASE to nested IF nodes. */
+/* - tcc_expr_parse_coalesce_tail: Expression compiler parser lowering COALESCE to binary nodes. */
+/* - tcc_expr_parse_compare: Expression compiler parser for comparisons. */
+/* - tcc_expr_parse_expr: Expression compiler parser entry (OR level). */
+/* - tcc_expr_parse_is: Expression compiler parser for IS [NOT] NULL. */
+/* - tcc_expr_parse_mul: Expression compiler parser for multiplicative operators. */
+/* - tcc_expr_parse_not: Expression compiler parser for NOT. */
+/* - tcc_expr_parse_postfix: Expression compiler parser for postfix casts. */
+/* - tcc_expr_parse_primary: Expression compiler parser for primaries. */
+/* - tcc_expr_parse_signature: Expression compiler parser for name:type argument lists. */
+/* - tcc_expr_parse_type_name: Expression compiler parser for CAST targets. */
+/* - tcc_expr_parse_unary: Expression compiler parser for unary operators. */
+/* - tcc_expr_require_bool: Expression compiler operand type check. */
+/* - tcc_expr_require_numeric: Expression compiler operand type check. */
+/* - tcc_expr_type_is_float: Expression compiler type predicate. */
+/* - tcc_expr_type_is_int: Expression compiler type predicate. */
+/* - tcc_expr_type_is_signed: Expression compiler type predicate. */
 /* - tcc_ffi_array_child_type: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_ffi_array_type_from_child: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_ffi_list_child_type: Internal helper in the TinyCC module/runtime pipeline. */
@@ -197,39 +317,88 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_ffi_type_is_fixed_width_scalar: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_is_list: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_is_map: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
+/* - tcc_ffi_type_is_plain_column: Type-system predicate for fixed-width types whose vector data is the C value itself. */
 /* - tcc_ffi_type_is_struct: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_is_union: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_size: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_to_c_type_name: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_to_duckdb_type: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
 /* - tcc_ffi_type_to_token: FFI type conversion helper across tokens, C types, DuckDB logical types, and byte widths. */
+/* - tcc_file_reader_find: Reader helper looking up a decoder by file extension. */
+/* - tcc_file_reader_release: Reader helper dropping one reference on a compiled file decoder. */
+/* - tcc_file_readers_destroy: Reader helper releasing the state's registered file decoders. */
 /* - tcc_find_top_level_char: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_format_cstr: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_free_ptr_scalar: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_functions_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_functions_collect: Snapshots registry metadata and counters for tcc_functions(). */
+/* - tcc_functions_table_function: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_fuse_build_source: Fuse helper building the compilation unit with the composed entry point. */
+/* - tcc_fuse_is_c_identifier: Fuse helper validating stage symbols before they are pasted into generated source. */
 /* - tcc_generate_c_composite_helpers_source: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_generate_c_enum_helpers_source: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_get_ptr_registry: Fetches pointer registry from scalar function context, reporting errors to DuckDB on failure. */
 /* - tcc_has_library_suffix: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_hash64: Hash helper (FNV-1a 64-bit) for source_file/add_file input tracking. */
+/* - tcc_hash64_str: Hash helper folding a terminated string into an FNV-1a 64-bit hash. */
 /* - tcc_helper_binding_list_add: Dynamic helper-binding list utility for generated helper UDF registration. */
 /* - tcc_helper_binding_list_add_prefixed: Dynamic helper-binding list utility for generated helper UDF registration. */
 /* - tcc_helper_binding_list_destroy: Dynamic helper-binding list utility for generated helper UDF registration. */
 /* - tcc_helper_binding_list_reserve: Dynamic helper-binding list utility for generated helper UDF registration. */
 /* - tcc_host_sig_ctx_destroy: Releases UDF signature context, including parsed type metadata and descriptors. */
+/* - tcc_import_collect_cb: Import tcc_list_symbols callback collecting exported globals. */
+/* - tcc_import_set_add: Import helper recording one exported symbol (conflict detection). */
+/* - tcc_import_set_apply: Import helper adding resolved symbols to a new TinyCC state. */
+/* - tcc_import_set_destroy: Import helper releasing pins and symbol copies. */
+/* - tcc_import_set_resolve: Import helper resolving import_from entries against registered artifacts (pins exporters). */
+/* - tcc_is_host_symbol: Host symbol table membership check. */
 /* - tcc_is_identifier_token: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_is_path_like: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_isolation_await: Process isolation helper waiting for a worker status byte with crash detection. */
+/* - tcc_isolation_execute_chunk: Process isolation executor leasing a worker for one chunk. */
+/* - tcc_isolation_pool_create: Process isolation pool constructor (slot layout, eligibility checks, fork). */
+/* - tcc_isolation_pool_destroy: Process isolation pool destructor (workers and shared slots). */
+/* - tcc_isolation_retire: Process isolation helper closing and reaping one worker. */
+/* - tcc_isolation_run_slot: Process isolation worker step running the wrapper over one shared chunk slot. */
+/* - tcc_isolation_size_align: Process isolation slot layout alignment helper. */
+/* - tcc_isolation_spawn: Process isolation helper forking one worker. */
+/* - tcc_isolation_worker_main: Process isolation forked worker loop. */
 /* - tcc_library_link_name_from_path: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_library_probe_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_lock_stats_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_lock_stats_snapshot: Copies one lock's wait counters into a tcc_lock_stats() row. */
+/* - tcc_lock_stats_table_function: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_lock_wait_record: Counts one lock acquisition and its spin wait, if any. */
+/* - tcc_lock_wait_stats_init: Zeroes the wait counters embedded in a lock. */
+/* - tcc_map_index_build: MAP key index builder for ducktinycc_map_find. */
+/* - tcc_map_key_hash: MAP key hash for ducktinycc_map_find indexes. */
 /* - tcc_map_meta_array_destroy: MAP metadata lifecycle helper for parsed signatures. */
 /* - tcc_map_meta_destroy: MAP metadata lifecycle helper for parsed signatures. */
+/* - tcc_mapped_file_close: Reader helper unmapping a scanned file. */
+/* - tcc_mapped_file_open: Reader helper memory-mapping (or reading) a scanned file. */
+/* - tcc_mode_add_file: Mode handler staging a C file by path with change detection. */
+/* - tcc_mode_bench: Mode handler for bench: runs a registered UDF executor over synthesized chunks. */
+/* - tcc_mode_code_info: Mode handler for code_info: module function count, text size, largest function. */
+/* - tcc_mode_compile_expr: Mode handler compiling a SQL scalar expression into a registered batch UDF. */
+/* - tcc_mode_file_reader: Mode handler compiling a decoder and registering it for a file extension. */
+/* - tcc_mode_fuse: Mode handler compiling a chain of stage functions into one registered UDF. */
+/* - tcc_mode_sink: Mode handler compiling a chunk-at-a-time side-effect callback and registering it as an aggregate. */
 /* - tcc_mode_requires_write_lock: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_module_bind: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_module_bind_add_result_columns: Adds the shared one-row status columns used by tcc_module-style binds. */
+/* - tcc_module_collect_text_symbols: Lists a module's global functions inside its text markers, sorted by address. */
+/* - tcc_module_compile_text_marker: Compiles the begin/end marker functions bounding a module's text (code_size, perf-map sizing). */
 /* - tcc_module_function: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
 /* - tcc_module_init: DuckDB bind/init/execute callback for module or diagnostics/probe table functions. */
+/* - tcc_mutex_init: Blocking mutex wrappers (init/lock/unlock/destroy) for locks held across user I/O. */
 /* - tcc_nested_struct_bridge_destroy: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_next_top_level_part: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_now_ns: Monotonic nanosecond clock used by runtime counters and timings. */
+/* - tcc_out_arena_reset: Return-arena helper freeing every block of a chunk's bump arena. */
 /* - tcc_parse_c_enum_constants: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
 /* - tcc_parse_c_field_spec_token: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
 /* - tcc_parse_c_field_specs: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
+/* - tcc_parse_isolation: Process isolation parser for the isolation parameter (worker count). */
 /* - tcc_parse_map_meta_token: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
 /* - tcc_parse_signature: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
 /* - tcc_parse_struct_meta_token: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
@@ -238,6 +407,13 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_parse_wrapper_mode: Parser helper for signatures, wrapper mode, C helper field specs, or nested type tokens. */
 /* - tcc_path_exists: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_path_join: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_perf_map_collect_cb: tcc_list_symbols callback collecting relocated module symbols inside the perf-map text range. */
+/* - tcc_perf_map_emit: Appends /tmp/perf-<pid>.map entries (address, size, sql_name-qualified label) for a relocated module. */
+/* - tcc_perf_map_enabled: Returns whether perf-map emission is requested via perf_map := true or DUCKTINYCC_PERF_MAP. */
+/* - tcc_perf_map_symbol_cmp: qsort comparator ordering perf-map symbols by address. */
+/* - tcc_popcount64: Counts set bits in one validity word. */
+/* - tcc_predicate_expand: Executor helper expanding a predicate bitmask into BOOLEAN output and validity. */
+/* - tcc_predicate_signature_supported: Signature check for wrapper_mode predicate (bool return, plain column args). */
 /* - tcc_ptr_add_scalar: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_ptr_helper_ctx_destroy: Destructor for scalar helper extra-info context holding pointer registry references. */
 /* - tcc_ptr_registry_alloc: Pointer registry allocator/lookup/IO primitive for `tcc_alloc` and pointer helper UDFs. */
@@ -255,17 +431,24 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_ptr_registry_write: Pointer registry allocator/lookup/IO primitive for `tcc_alloc` and pointer helper UDFs. */
 /* - tcc_ptr_size_scalar: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_ptr_span_fits: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_read_bind: Bind callback for tcc_read(path, extension) declaring the reader columns. */
 /* - tcc_read_bytes_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_f32_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_f64_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
+/* - tcc_read_function: Scan callback for tcc_read decoding ranges into output chunks. */
 /* - tcc_read_i16_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_i32_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_i64_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_i8_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
+/* - tcc_read_init: Global init for tcc_read mapping the file and splitting it into ranges. */
+/* - tcc_read_local_init: Local init for tcc_read per-thread range state. */
+/* - tcc_read_replacement_scan: Replacement scan routing registered file extensions to tcc_read. */
+/* - tcc_read_text_file: File helper reading a whole source file into a NUL-terminated buffer. */
 /* - tcc_read_u16_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_u32_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_u64_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_read_u8_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
+/* - tcc_reader_column_supported: Reader helper accepting fixed-width output column types. */
 /* - tcc_register_pointer_scalar: Internal helper in the TinyCC module/runtime pipeline. */
 /* - tcc_registry_entry_destroy_metadata: Compiled-artifact metadata registry helper for SQL name to artifact lookup/storage. */
 /* - tcc_registry_find_sql_name: Compiled-artifact metadata registry helper for SQL name to artifact lookup/storage. */
@@ -276,15 +459,41 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_rwlock_read_unlock: Spin-based read/write lock primitive for extension state coordination. */
 /* - tcc_rwlock_write_lock: Spin-based read/write lock primitive for extension state coordination. */
 /* - tcc_rwlock_write_unlock: Spin-based read/write lock primitive for extension state coordination. */
+/* - tcc_session_base_acquire: Shared-base accessor compiling staged units once per session configuration. */
+/* - tcc_session_base_collect_cb: Shared-base tcc_list_symbols callback collecting exported staged symbols. */
+/* - tcc_session_base_release: Shared-base reference release (deletes the base on the last one). */
+/* - tcc_session_base_runtime_name: Shared-base filter for reserved runtime/linker names each module defines. */
 /* - tcc_session_clear_bind: Session state helper for runtime path, staged sources, and symbol bindings. */
 /* - tcc_session_clear_build_state: Session state helper for runtime path, staged sources, and symbol bindings. */
+/* - tcc_session_files_destroy: Session helper releasing add_file records. */
+/* - tcc_session_hash_inputs: Session helper hashing staged build inputs for incremental rebuilds. */
 /* - tcc_session_runtime_path: Session state helper for runtime path, staged sources, and symbol bindings. */
 /* - tcc_session_set_runtime_path: Session state helper for runtime path, staged sources, and symbol bindings. */
+/* - tcc_session_snapshot: Session deep copy including one-shot bind overrides. */
 /* - tcc_set_error: Value/error/validity setter helper for vectors and diagnostics output. */
 /* - tcc_set_output_row_null: Value/error/validity setter helper for vectors and diagnostics output. */
 /* - tcc_set_varchar_col: Value/error/validity setter helper for vectors and diagnostics output. */
 /* - tcc_set_vector_row_validity: Value/error/validity setter helper for vectors and diagnostics output. */
+/* - tcc_sink_arg_supported: Sink helper accepting fixed-width, varchar and blob argument types. */
+/* - tcc_sink_combine: Aggregate combine callback summing sink row counts. */
+/* - tcc_sink_destroy: Sink helper releasing a compiled sink and its artifact reference. */
+/* - tcc_sink_finalize: Aggregate finalize callback running the sink flush and returning row counts. */
+/* - tcc_sink_state_init: Aggregate state init callback for sinks. */
+/* - tcc_sink_state_size: Aggregate state size callback for sinks. */
+/* - tcc_sink_update: Aggregate update callback handing each input chunk to the sink. */
 /* - tcc_skip_space: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_source_compile_hashes: Rebuild helper computing the signature and input hashes of a source_file compile. */
+/* - tcc_source_file_dir: Path helper extracting the directory of a source file. */
+/* - tcc_source_file_hash: Include helper returning the graph hash of one source file. */
+/* - tcc_source_hash_graph: Include helper hashing a file and its quoted-include graph. */
+/* - tcc_source_resolve_include: Include helper resolving a quoted include in TinyCC search order. */
+/* - tcc_specialize_attach: Specialization plan validation against a registered signature. */
+/* - tcc_specialize_compile_variant: Specialization variant compile with constant #defines. */
+/* - tcc_specialize_count_hit: Specialization repeat counter gating variant compiles. */
+/* - tcc_specialize_format_literal: Specialization C literal rendering of raw argument bits. */
+/* - tcc_specialize_plan_create: Specialization plan parser and compile-input snapshot for the specialize parameter. */
+/* - tcc_specialize_plan_destroy: Specialization plan destructor (variants and snapshot). */
+/* - tcc_specialize_route: Specialization per-chunk constant detection and variant lookup/compile. */
 /* - tcc_split_csv_tokens: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_strdup: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_string_ends_with: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
@@ -303,16 +512,24 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_text_buf_reserve: Growable text buffer utility used by code generation paths. */
 /* - tcc_trim_inplace: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_try_resolve_candidate: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_type_param_substitute: Codegen helper replacing standalone T tokens of a signature CSV. */
+/* - tcc_type_param_supported: Codegen helper listing the type tokens accepted by type_params. */
+/* - tcc_typedesc_apply_used: Typedesc helper marking STRUCT argument fields outside used := [...] as skipped by the bridge. */
 /* - tcc_typedesc_create_logical_type: Recursive typedesc parser/converter used for nested SQL/C type bridging. */
 /* - tcc_typedesc_destroy: Recursive typedesc parser/converter used for nested SQL/C type bridging. */
 /* - tcc_typedesc_is_composite: Recursive typedesc parser/converter used for nested SQL/C type bridging. */
 /* - tcc_typedesc_parse_token: Recursive typedesc parser/converter used for nested SQL/C type bridging. */
+/* - tcc_udf_stats_attach: Allocates per-UDF counters and attaches them to the artifact whose module_init is running on this thread. */
+/* - tcc_udf_stats_destroy: Releases one per-UDF counter block. */
+/* - tcc_udf_stats_snapshot: Sums the sharded counters of one UDF. */
 /* - tcc_union_meta_array_destroy: UNION metadata lifecycle helper for parsed signatures. */
 /* - tcc_union_meta_destroy: UNION metadata lifecycle helper for parsed signatures. */
 /* - tcc_valid_input_row: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_validity_set_all: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
 /* - tcc_value_bridge_destroy: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_wrapper_mode_is: Parser helper matching a wrapper_mode parameter against one batch-variant token. */
 /* - tcc_wrapper_mode_token: Utility/helper function supporting parsing, diagnostics, paths, locking, or runtime configuration. */
+/* - tcc_write_bench_col: Writes bench mode measurements into the bench STRUCT column. */
 /* - tcc_write_bytes_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_f32_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_f64_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
@@ -321,11 +538,25 @@ DUCKDB_EXTENSION_EXTERN
 /* - tcc_write_i64_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_i8_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_row: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_write_timings_col: Fills the timings column of a tcc_module(...) row. */
 /* - tcc_write_u16_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_u32_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_u64_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_u8_scalar: Scalar UDF implementation for pointer/memory helper SQL functions. */
 /* - tcc_write_value_to_vector: Internal helper in the TinyCC module/runtime pipeline. */
+/* - tcc_x64_decode_0f: x86-64 decoder: two-byte (0F) opcode subset emitted by TinyCC. */
+/* - tcc_x64_disasm: Disassembles a code range into offset/bytes/instruction lines. */
+/* - tcc_x64_disasm_one: Decodes one x86-64 instruction into Intel syntax. */
+/* - tcc_x64_gpr: x86-64 decoder: general-purpose register name by number and width. */
+/* - tcc_x64_hex: x86-64 decoder: signed hex formatting. */
+/* - tcc_x64_imm: x86-64 decoder: reads a sign-extended immediate/displacement. */
+/* - tcc_x64_read_modrm: x86-64 decoder: decodes ModRM/SIB/displacement into operand text. */
+/* - tcc_x64_rm: x86-64 decoder: formats an r/m operand as register or memory. */
+/* - tcc_x64_rm_xmm: x86-64 decoder: formats an r/m operand as xmm register or memory. */
+/* - tcc_x64_size_name: x86-64 decoder: Intel ptr size keyword for an operand width. */
+/* - tcc_x64_sse_bits: x86-64 decoder: SSE memory operand width from the mandatory prefix. */
+/* - tcc_x64_sse_suffix: x86-64 decoder: ps/pd/ss/sd suffix from the mandatory prefix. */
+/* - tcc_x64_u8: x86-64 decoder: reads one code byte with overrun tracking. */
 /* END: TCC_FUNCTION_CATALOG */
 
 /* Generic growable list of owned strings. */
@@ -335,11 +566,22 @@ typedef struct {
 	idx_t capacity;
 } tcc_string_list_t;
 
+/* Lock wait counters reported by `tcc_lock_stats()`. Uncontended acquisitions only bump `acquisitions`;
+ * the clock is read only once a spin has to wait. */
+typedef struct {
+	atomic_uint_fast64_t acquisitions;
+	atomic_uint_fast64_t contended;
+	atomic_uint_fast64_t wait_ns;
+	atomic_uint_fast64_t max_wait_ns;
+} tcc_lock_wait_stats_t;
+
 /* Minimal spin-based RW lock for connection-local module state. */
 typedef struct {
 	atomic_bool writer;
 	atomic_uint readers;
 	atomic_uint pending_writers;
+	tcc_lock_wait_stats_t read_wait;
+	tcc_lock_wait_stats_t write_wait;
 } tcc_rwlock_t;
 
 typedef struct {
@@ -357,12 +599,20 @@ typedef struct {
 typedef struct {
 	atomic_uint ref_count;
 	atomic_flag lock;
+	tcc_lock_wait_stats_t lock_wait;
 	tcc_ptr_entry_t *entries;
 	idx_t count;
 	idx_t capacity;
 	uint64_t next_handle;
 } tcc_ptr_registry_t;
 
+/* One `add_file` input: its slot in the session's `sources` and the hash of its contents and quoted includes. */
+typedef struct {
+	char *path;
+	idx_t source_index;
+	uint64_t hash;
+} tcc_session_file_t;
+
 /* Mutable per-connection TinyCC build session (staged inputs + bind defaults). */
 typedef struct {
 	char *runtime_path;
@@ -382,6 +632,10 @@ typedef struct {
 	uint64_t *symbol_ptrs;
 	idx_t symbol_count;
 	idx_t symbol_capacity;
+	/* Sources staged by `add_file`, so re-adding an unchanged file is a no-op and a changed one replaces its slot. */
+	tcc_session_file_t *files;
+	idx_t file_count;
+	idx_t file_capacity;
 	uint64_t config_version;
 	uint64_t state_id;
 } tcc_session_t;
@@ -510,6 +764,13 @@ typedef struct {
 	uint64_t offset;
 } ducktinycc_struct_t;
 
+/* Writable STRUCT output columns for wrapper_mode := 'chunk_columnar': field i of row r is field_ptrs[i][r]. */
+typedef struct {
+	void *const *field_ptrs;
+	uint64_t *const *field_validity;
+	uint64_t field_count;
+} ducktinycc_struct_out_t;
+
 typedef struct {
 	const void *key_ptr;
 	const uint64_t *key_validity;
@@ -527,10 +788,43 @@ typedef struct {
 	uint64_t offset;
 } ducktinycc_union_t;
 
+/* Arrow C Data Interface structs (https://arrow.apache.org/docs/format/CDataInterface.html).
+ * duckdb.h only forward-declares them; the layout below is fixed by the Arrow ABI. */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+struct ArrowSchema {
+	const char *format;
+	const char *name;
+	const char *metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema **children;
+	struct ArrowSchema *dictionary;
+	void (*release)(struct ArrowSchema *);
+	void *private_data;
+};
+struct ArrowArray {
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void **buffers;
+	struct ArrowArray **children;
+	struct ArrowArray *dictionary;
+	void (*release)(struct ArrowArray *);
+	void *private_data;
+};
+#endif
+
 /* Wrapper ABI mode for generated C entrypoints. */
 typedef enum {
 	TCC_WRAPPER_MODE_ROW = 0,
-	TCC_WRAPPER_MODE_BATCH = 1
+	TCC_WRAPPER_MODE_BATCH = 1,
+	TCC_WRAPPER_MODE_ARROW = 2
 } tcc_wrapper_mode_t;
 
 typedef enum {
@@ -538,22 +832,148 @@ typedef enum {
 	TCC_FUNCTION_STABILITY_VOLATILE = 1
 } tcc_function_stability_t;
 
+/* Wall time of each compile pipeline phase, in nanoseconds. */
+typedef struct {
+	uint64_t parse_ns;    /* signature/wrapper_mode/stability parsing */
+	uint64_t codegen_ns;  /* wrapper + compilation-unit source generation */
+	uint64_t setup_ns;    /* tcc_new, runtime paths, host symbols */
+	uint64_t session_ns;  /* staged include/library paths, headers, sources, libraries, symbols, bind overrides */
+	uint64_t compile_ns;  /* tcc_compile_string of the generated compilation unit */
+	uint64_t relocate_ns; /* tcc_relocate + symbol lookup */
+	uint64_t init_ns;     /* module_init, excluding DuckDB registration */
+	uint64_t register_ns; /* duckdb_register_scalar_function + registry bookkeeping */
+	uint64_t total_ns;
+} tcc_compile_timings_t;
+
+/* Executor phases timed by `mode := 'bench'`. */
+typedef enum {
+	TCC_EXEC_PHASE_MARSHAL = 0,  /* input decode, composite bridges, output scratch setup */
+	TCC_EXEC_PHASE_CALL = 1,     /* generated wrapper (and user function) invocation */
+	TCC_EXEC_PHASE_WRITEBACK = 2 /* output vector writes, NULL propagation, scratch release */
+} tcc_exec_phase_t;
+
+/* Bridge time of one or more chunk executions split by phase, collected only by `mode := 'bench'`. `laps` counts
+ * clock reads charged to each phase so the caller can subtract timer overhead. */
+typedef struct {
+	uint64_t ns[3];
+	uint64_t laps[3];
+} tcc_exec_split_t;
+
+/* Thread-local storage qualifier for per-thread runtime state (counter shard ids, registration context). */
+#if defined(_MSC_VER)
+#define TCC_THREAD_LOCAL __declspec(thread)
+#else
+#define TCC_THREAD_LOCAL _Thread_local
+#endif
+
+/* Number of counter shards per UDF; threads pick a shard once so the hot path rarely shares a cache line. */
+#define TCC_UDF_STATS_SHARDS 16
+
+/* One cache-line sized counter shard (six 8-byte counters plus padding). */
+typedef struct {
+	atomic_uint_fast64_t chunks;
+	atomic_uint_fast64_t rows;
+	atomic_uint_fast64_t null_in_rows;
+	atomic_uint_fast64_t null_out_rows;
+	atomic_uint_fast64_t errors;
+	atomic_uint_fast64_t total_ns;
+	uint64_t pad[2];
+} tcc_udf_stats_shard_t;
+
+/* Forward declaration: runtime signature context (defined with the type metadata below). */
+typedef struct tcc_host_sig_ctx tcc_host_sig_ctx_t;
+/* Forward declaration: worker pool of an `isolation := 'process'` UDF (Process Isolation section). */
+typedef struct tcc_isolation_pool tcc_isolation_pool_t;
+/* Forward declaration: `specialize := [...]` plan and variant cache of a UDF (Constant Specialization section). */
+typedef struct tcc_specialize_plan tcc_specialize_plan_t;
+/* Forward declaration: shared compile of the session's staged sources (defined with the artifact type). */
+typedef struct tcc_session_base tcc_session_base_t;
+/* Forward declaration: compiled decoder behind `FROM 'file.ext'` (File Readers section). */
+typedef struct tcc_file_reader tcc_file_reader_t;
+
+/* Per-UDF runtime counters. Owned by the registering artifact; the signature ctx only borrows them. */
+typedef struct {
+	char *sql_name;
+	tcc_wrapper_mode_t wrapper_mode;
+	tcc_function_stability_t stability;
+	/* Borrowed signature ctx (owned by the DuckDB function's extra info) so `mode := 'bench'` can drive the
+	 * executor directly; NULL if registration failed. */
+	tcc_host_sig_ctx_t *ctx;
+	tcc_udf_stats_shard_t shards[TCC_UDF_STATS_SHARDS];
+} tcc_udf_stats_t;
+
 /* Function pointer shapes exported by generated modules. */
 typedef bool (*tcc_dynamic_init_fn_t)(duckdb_connection connection);
 typedef bool (*tcc_host_row_wrapper_fn_t)(void **args, void *out_value, bool *out_is_null);
 typedef bool (*tcc_host_batch_wrapper_fn_t)(void **arg_data, uint64_t **arg_validity, uint64_t count, void *out_data,
                                             uint64_t *out_validity);
+typedef bool (*tcc_host_arrow_wrapper_fn_t)(const struct ArrowSchema *schema, const struct ArrowArray *input,
+                                            struct ArrowArray *out);
 
 #ifndef DUCKTINYCC_WASM_UNSUPPORTED
 /* Owns one relocated TinyCC module artifact and its init symbol. */
-typedef struct {
+/* Staged headers and sources of one session configuration, compiled and relocated once and linked into every
+ * module compiled against that configuration. The module state's cache and each artifact hold one reference. */
+struct tcc_session_base {
+	/* NULL for a configuration whose staged units do not link on their own (they call into the module being
+	 * compiled); such a base is only cached so each compile knows to keep its private copy. */
+	TCCState *tcc;
+	atomic_int refs;
+	uint64_t state_id;
+	uint64_t config_version;
+	/* Global symbols defined by the staged units, re-exported into each module with tcc_add_symbol. */
+	char **names;
+	void **addrs;
+	idx_t count;
+	idx_t capacity;
+};
+
+typedef struct tcc_registered_artifact {
 	TCCState *tcc;
 	bool is_module;
 	tcc_dynamic_init_fn_t module_init;
 	char *sql_name;
 	char *symbol;
 	uint64_t state_id;
+	/* Bytes between the module text markers (user code, prelude helpers, wrapper, init). */
+	uint64_t code_size;
+	/* Counters for each UDF registered by module_init; freed with the artifact. */
+	tcc_udf_stats_t **udf_stats;
+	idx_t udf_stats_count;
+	idx_t udf_stats_capacity;
+	/* Shared base the module resolved staged symbols against (one reference); NULL when compiled standalone. */
+	tcc_session_base_t *base;
+	/* Owners: the registry entry, plus every later artifact that imported symbols from this one. */
+	atomic_int refs;
+	/* Artifacts this module resolved `import_from` symbols against (one reference each). */
+	struct tcc_registered_artifact **imports;
+	idx_t import_count;
+	/* Latest in-place rebuild of a `source_file` module (owned); its wrapper runs in place of this one's. */
+	struct tcc_registered_artifact *rebuilt;
+	/* The rebuild this one replaced (owned): kept alive while chunks may still run its code, and freed by the next
+	 * rebuild that finds no chunk inside rebuilt code. */
+	struct tcc_registered_artifact *superseded;
 } tcc_registered_artifact_t;
+
+/* Artifact whose module_init is running on this thread; ducktinycc_register_signature attaches counters to it. */
+static TCC_THREAD_LOCAL tcc_registered_artifact_t *tcc_registering_artifact = NULL;
+/* Timings of the compile whose module_init is running on this thread (register_ns accumulates here). */
+static TCC_THREAD_LOCAL tcc_compile_timings_t *tcc_registering_timings = NULL;
+/* Set while a compile_expr module_init runs: its kernel implements NULL semantics itself (COALESCE, IS NULL, OR). */
+static TCC_THREAD_LOCAL bool tcc_registering_special_nulls = false;
+/* Worker count requested by `isolation := 'process'` for the module_init running on this thread (0 = in-process). */
+static TCC_THREAD_LOCAL int tcc_registering_isolation_workers = 0;
+/* Per-chunk worker deadline (ms) requested alongside tcc_registering_isolation_workers. */
+static TCC_THREAD_LOCAL int tcc_registering_isolation_timeout_ms = 0;
+/* Why ducktinycc_register_signature refused a signature during module_init (static string), or NULL. */
+static TCC_THREAD_LOCAL const char *tcc_registering_error = NULL;
+/* CSV of `used := [...]` field names for the module_init running on this thread (borrowed from the bind), or NULL. */
+static TCC_THREAD_LOCAL const char *tcc_registering_used = NULL;
+/* Specialization plan for the module_init running on this thread; the registered signature takes ownership. */
+static TCC_THREAD_LOCAL tcc_specialize_plan_t *tcc_registering_specialize = NULL;
+/* Set while a specialized variant's module_init runs: ducktinycc_register_signature stores the wrapper here
+ * instead of registering a SQL function. */
+static TCC_THREAD_LOCAL void **tcc_registering_capture = NULL;
 #endif
 
 /* Registry entry mapping SQL name to compiled module metadata. */
@@ -561,11 +981,50 @@ typedef struct {
 	char *sql_name;
 	char *symbol;
 	uint64_t state_id;
+	/* Set for modules compiled from `source_file`: recompiles compare these hashes instead of failing. */
+	bool from_file;
+	uint64_t input_hash;
+	uint64_t signature_hash;
 #ifndef DUCKTINYCC_WASM_UNSUPPORTED
 	tcc_registered_artifact_t *artifact;
 #endif
 } tcc_registered_entry_t;
 
+/* Adds the time since `t_phase` to `timings->field` (when timings is non-NULL) and restarts the phase clock. */
+#define TCC_TIMINGS_LAP(timings, field, t_phase, t_now)                                                            \
+	do {                                                                                                           \
+		(t_now) = tcc_now_ns();                                                                                    \
+		if (timings) {                                                                                             \
+			(timings)->field += (t_now) - (t_phase);                                                               \
+		}                                                                                                          \
+		(t_phase) = (t_now);                                                                                       \
+	} while (0)
+
+/* Charges the time since `t_mark` to `phase` and restarts the mark; reads no clock when `split` is NULL. */
+#define TCC_EXEC_SPLIT_LAP(split, phase, t_mark)                                                                   \
+	do {                                                                                                           \
+		if (split) {                                                                                               \
+			uint64_t tcc_split_now_ = tcc_now_ns();                                                                \
+			(split)->ns[phase] += tcc_split_now_ - (t_mark);                                                       \
+			(split)->laps[phase]++;                                                                                \
+			(t_mark) = tcc_split_now_;                                                                             \
+		}                                                                                                          \
+	} while (0)
+
+/* Number of compile records retained for `tcc_compile_stats()` (oldest are overwritten). */
+#define TCC_COMPILE_STATS_CAPACITY 256
+
+/* One `tcc_compile_stats()` history record. */
+typedef struct {
+	uint64_t seq;
+	char *mode;
+	char *sql_name;
+	char *code;
+	bool ok;
+	uint64_t state_id;
+	tcc_compile_timings_t timings;
+} tcc_compile_stat_t;
+
 /* Root extension state stored as table-function extra info. */
 typedef struct {
 	duckdb_connection connection;
@@ -576,6 +1035,20 @@ typedef struct {
 	tcc_registered_entry_t *entries;
 	idx_t entry_count;
 	idx_t entry_capacity;
+	/* Ring buffer of recent compile timings (TCC_COMPILE_STATS_CAPACITY slots, allocated on first compile). */
+	tcc_compile_stat_t *compile_stats;
+	uint64_t compile_stats_seq;
+	/* Cached base of the session's staged sources (one reference); rebuilt when state_id/config_version move. */
+	tcc_session_base_t *session_base;
+	/* Decoders registered with `mode := 'file_reader'`, one per file extension (one reference each). */
+	tcc_file_reader_t **readers;
+	idx_t reader_count;
+	idx_t reader_capacity;
+	/* Artifacts whose module_init failed after some of its functions were already registered (one reference each):
+	 * DuckDB can still call into them, so they live as long as the state. */
+	struct tcc_registered_artifact **stranded;
+	idx_t stranded_count;
+	idx_t stranded_capacity;
 } tcc_module_state_t;
 
 /* Parsed named arguments for one `tcc_module(...)` invocation. */
@@ -589,6 +1062,23 @@ typedef struct {
 	char *return_type;
 	char *wrapper_mode;
 	char *stability;
+	/* fuse: CSV of stage symbols applied left to right. */
+	char *symbols;
+	/* compile_expr: SQL scalar expression over the `arg_types` columns. */
+	char *expr;
+	/* 'inprocess' (default), 'process' or 'process:N', optionally with ',timeout_ms=T': run the registered UDFs in
+	 * forked worker processes. */
+	char *isolation;
+	/* CSV of 'define_name:argument_position' entries compiled as #defines when those arguments are constant. */
+	char *specialize;
+	/* CSV of type tokens substituted for `T`: one overload of the UDF is compiled per entry. */
+	char *type_params;
+	/* CSV of 'module' or 'module:symbol' entries linking exported symbols of registered modules. */
+	char *import_from;
+	/* compile/quick_compile read `source` from this file; add_file stages it. */
+	char *source_file;
+	/* CSV of STRUCT argument field names the kernel reads; other fields are not bridged. */
+	char *used;
 	char *include_path;
 	char *sysinclude_path;
 	char *library_path;
@@ -600,6 +1090,10 @@ typedef struct {
 	char *symbol_name;
 	uint64_t symbol_ptr;
 	bool has_symbol_ptr;
+	bool perf_map;
+	uint64_t bench_rows;
+	bool has_bench_rows;
+	double bench_null_ratio;
 } tcc_module_bind_data_t;
 
 /* Per-scan init state: ensures table-function emits once. */
@@ -644,10 +1138,16 @@ typedef struct {
 } tcc_ffi_union_meta_t;
 
 /* Runtime UDF signature context attached to DuckDB scalar function extra info. */
-typedef struct {
+struct tcc_host_sig_ctx {
 	tcc_wrapper_mode_t wrapper_mode;
 	tcc_host_row_wrapper_fn_t row_wrapper;
 	tcc_host_batch_wrapper_fn_t batch_wrapper;
+	tcc_host_arrow_wrapper_fn_t arrow_wrapper;
+	/* Arrow mode only: immutable "+s" schema (one child per argument) shared by every chunk. */
+	struct ArrowSchema arrow_schema;
+	struct ArrowSchema *arrow_children;
+	struct ArrowSchema **arrow_child_ptrs;
+	char *arrow_child_names;
 	int arg_count;
 	tcc_ffi_type_t return_type;
 	tcc_ffi_type_t *arg_types;
@@ -662,7 +1162,21 @@ typedef struct {
 	tcc_ffi_union_meta_t *arg_union_metas;
 	tcc_typedesc_t *return_desc;
 	tcc_typedesc_t **arg_descs;
-} tcc_host_sig_ctx_t;
+	/* Borrowed runtime counters (owned by the artifact); NULL when registered outside module_init. */
+	tcc_udf_stats_t *stats;
+	/* Owned worker pool when registered with `isolation := 'process'`; NULL runs chunks in-process. */
+	tcc_isolation_pool_t *isolation;
+	/* Owned `specialize := [...]` plan; NULL runs every chunk on the generic wrapper. */
+	tcc_specialize_plan_t *specialize;
+	/* wrapper_mode := 'chunk_columnar': the batch wrapper writes the STRUCT result's child vectors directly. */
+	bool columnar_return;
+	/* wrapper_mode := 'predicate': the batch wrapper fills a selection bitmask that is expanded into the BOOLEAN output. */
+	bool predicate_mask;
+	/* Wrapper of the latest in-place `source_file` rebuild (owned by the artifact); 0 runs the original. */
+	atomic_uintptr_t rebuilt_wrapper;
+	/* Chunks running some rebuilt wrapper; a rebuild that finds none frees the rebuilds it superseded. */
+	atomic_uint rebuilt_readers;
+};
 
 /* Nested bridge container variants for recursive composite marshalling. */
 typedef enum {
@@ -775,6 +1289,8 @@ typedef enum {
 typedef struct {
 	char *name;
 	tcc_typedesc_t *type;
+	/* STRUCT argument field left out of `used := [...]`: never bridged, NULL in field_ptrs. */
+	bool skip;
 } tcc_typedesc_field_t;
 
 /* Recursive parsed type descriptor tree for nested signature grammar. */
@@ -827,6 +1343,7 @@ typedef struct {
 	char module_symbol[128];
 	char *wrapper_loader_source;
 	char *compilation_unit_source;
+	uint64_t parse_ns;
 } tcc_codegen_source_ctx_t;
 
 /* Forward declarations grouped by subsystem (parser/types/bridge/codegen). */
@@ -840,6 +1357,11 @@ static bool tcc_parse_signature(const char *return_type, const char *arg_types_c
 		                                tcc_ffi_union_meta_t **out_arg_union_metas, int *out_arg_count,
 		                                tcc_error_buffer_t *error_buf);
 static bool tcc_equals_ci(const char *a, const char *b);
+static bool tcc_wrapper_mode_is(const char *wrapper_mode, const char *expected);
+static bool tcc_columnar_return_supported(tcc_ffi_type_t return_type, const tcc_ffi_struct_meta_t *meta);
+static bool tcc_predicate_signature_supported(tcc_ffi_type_t return_type, const tcc_ffi_type_t *arg_types,
+                                              int arg_count);
+static void tcc_file_readers_destroy(tcc_module_state_t *state);
 static bool tcc_parse_wrapper_mode(const char *wrapper_mode, tcc_wrapper_mode_t *out_mode,
                                    tcc_error_buffer_t *error_buf);
 static const char *tcc_function_stability_token(tcc_function_stability_t stability);
@@ -885,6 +1407,16 @@ static tcc_nested_struct_bridge_t *tcc_build_struct_bridge_from_vector(duckdb_ve
                                                                        const tcc_ffi_struct_meta_t *meta, idx_t n,
                                                                        const char **out_error);
 static bool tcc_typedesc_is_composite(const tcc_typedesc_t *desc);
+#ifdef TCC_ISOLATION_SUPPORTED
+static void tcc_isolation_pool_destroy(tcc_isolation_pool_t *pool);
+#endif
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+static void tcc_session_base_release(tcc_session_base_t *base);
+static idx_t tcc_registry_find_sql_name(tcc_module_state_t *state, const char *sql_name);
+static void tcc_specialize_plan_destroy(tcc_specialize_plan_t *plan);
+static bool tcc_specialize_attach(tcc_host_sig_ctx_t *ctx, tcc_specialize_plan_t *plan, const char **out_error);
+static bool tcc_specialize_route(const tcc_host_sig_ctx_t *ctx, duckdb_data_chunk input, tcc_host_sig_ctx_t *out_ctx);
+#endif
 static void tcc_value_bridge_destroy(tcc_value_bridge_t *bridge);
 static tcc_value_bridge_t *tcc_build_value_bridge(duckdb_vector vector, const tcc_typedesc_t *desc, idx_t count,
                                                   const char **out_error);
@@ -904,6 +1436,8 @@ static void tcc_codegen_source_ctx_destroy(tcc_codegen_source_ctx_t *ctx);
 static bool tcc_codegen_prepare_sources(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
                                         const char *sql_name, const char *target_symbol,
                                         tcc_codegen_source_ctx_t *ctx, tcc_error_buffer_t *error_buf);
+static bool tcc_fuse_is_c_identifier(const char *name);
+static const char *tcc_ffi_type_to_c_type_name(tcc_ffi_type_t type);
 static const char *tcc_effective_stability(tcc_module_state_t *state, const tcc_module_bind_data_t *bind);
 static void tcc_codegen_classify_error_message(const char *error_message, const char **phase, const char **code,
                                                const char **message);
@@ -915,8 +1449,44 @@ static char *tcc_codegen_generate_wrapper_source(const char *module_symbol, cons
                                                  const char *arg_types_csv, const char *wrapper_mode_token,
                                                  tcc_wrapper_mode_t wrapper_mode, const char *stability_token,
                                                  tcc_ffi_type_t ret_type, const tcc_ffi_type_t *arg_types,
-                                                 int arg_count, bool emit_extern_decl);
+                                                 int arg_count, bool emit_extern_decl, bool export_wrapper);
 static char *tcc_codegen_build_compilation_unit(const char *user_source, const char *wrapper_loader_source);
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+static int tcc_codegen_load_unit(const char *runtime_path, tcc_module_state_t *state,
+                                 const tcc_module_bind_data_t *bind, const char *unit_source, const char *sql_name,
+                                 const char *module_symbol, tcc_registered_artifact_t **out_artifact,
+                                 tcc_error_buffer_t *error_buf, tcc_compile_timings_t *timings);
+#endif
+static duckdb_logical_type tcc_compile_timings_create_type(void);
+static uint64_t tcc_now_ns(void);
+static duckdb_logical_type tcc_bench_create_type(void);
+static void tcc_compile_stats_clear(tcc_module_state_t *state);
+
+/* tcc_lock_wait_stats_init: zeroes lock wait counters. Allocation/Lifetime: counters live inside the owning lock. */
+static void tcc_lock_wait_stats_init(tcc_lock_wait_stats_t *stats) {
+	atomic_store_explicit(&stats->acquisitions, 0, memory_order_relaxed);
+	atomic_store_explicit(&stats->contended, 0, memory_order_relaxed);
+	atomic_store_explicit(&stats->wait_ns, 0, memory_order_relaxed);
+	atomic_store_explicit(&stats->max_wait_ns, 0, memory_order_relaxed);
+}
+
+/* tcc_lock_wait_record: counts one acquisition and, if it had to spin, the wait since `wait_start_ns`.
+ * Allocation/Lifetime: borrows caller-owned counters; relaxed atomics only. */
+static void tcc_lock_wait_record(tcc_lock_wait_stats_t *stats, bool contended, uint64_t wait_start_ns) {
+	uint64_t waited;
+	uint64_t seen;
+	atomic_fetch_add_explicit(&stats->acquisitions, 1, memory_order_relaxed);
+	if (!contended) {
+		return;
+	}
+	waited = tcc_now_ns() - wait_start_ns;
+	atomic_fetch_add_explicit(&stats->contended, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&stats->wait_ns, waited, memory_order_relaxed);
+	seen = atomic_load_explicit(&stats->max_wait_ns, memory_order_relaxed);
+	while (waited > seen && !atomic_compare_exchange_weak_explicit(&stats->max_wait_ns, &seen, waited,
+	                                                                memory_order_relaxed, memory_order_relaxed)) {
+	}
+}
 
 /* RW-lock primitives used to guard shared module/session state during mode execution. */
 static void tcc_rwlock_init(tcc_rwlock_t *lock) {
@@ -926,16 +1496,24 @@ static void tcc_rwlock_init(tcc_rwlock_t *lock) {
 	atomic_store_explicit(&lock->writer, false, memory_order_relaxed);
 	atomic_store_explicit(&lock->readers, 0, memory_order_relaxed);
 	atomic_store_explicit(&lock->pending_writers, 0, memory_order_relaxed);
+	tcc_lock_wait_stats_init(&lock->read_wait);
+	tcc_lock_wait_stats_init(&lock->write_wait);
 }
 
 /* tcc_rwlock_read_lock: State/registry primitive used by runtime and helper UDFs. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
 static void tcc_rwlock_read_lock(tcc_rwlock_t *lock) {
+	bool contended = false;
+	uint64_t wait_start = 0;
 	if (!lock) {
 		return;
 	}
 	for (;;) {
 		while (atomic_load_explicit(&lock->writer, memory_order_acquire) ||
 		       atomic_load_explicit(&lock->pending_writers, memory_order_acquire) > 0) {
+			if (!contended) {
+				contended = true;
+				wait_start = tcc_now_ns();
+			}
 		}
 		atomic_fetch_add_explicit(&lock->readers, 1, memory_order_acquire);
 		if (!atomic_load_explicit(&lock->writer, memory_order_acquire) &&
@@ -943,7 +1521,12 @@ static void tcc_rwlock_read_lock(tcc_rwlock_t *lock) {
 			break;
 		}
 		atomic_fetch_sub_explicit(&lock->readers, 1, memory_order_release);
+		if (!contended) {
+			contended = true;
+			wait_start = tcc_now_ns();
+		}
 	}
+	tcc_lock_wait_record(&lock->read_wait, contended, wait_start);
 }
 
 /* tcc_rwlock_read_unlock: State/registry primitive used by runtime and helper UDFs. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
@@ -957,6 +1540,8 @@ static void tcc_rwlock_read_unlock(tcc_rwlock_t *lock) {
 /* tcc_rwlock_write_lock: State/registry primitive used by runtime and helper UDFs. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
 static void tcc_rwlock_write_lock(tcc_rwlock_t *lock) {
 	bool expected = false;
+	bool contended = false;
+	uint64_t wait_start = 0;
 	if (!lock) {
 		return;
 	}
@@ -967,10 +1552,19 @@ static void tcc_rwlock_write_lock(tcc_rwlock_t *lock) {
 		                                          memory_order_acquire)) {
 			break;
 		}
+		if (!contended) {
+			contended = true;
+			wait_start = tcc_now_ns();
+		}
 	}
 	while (atomic_load_explicit(&lock->readers, memory_order_acquire) != 0) {
+		if (!contended) {
+			contended = true;
+			wait_start = tcc_now_ns();
+		}
 	}
 	atomic_fetch_sub_explicit(&lock->pending_writers, 1, memory_order_release);
+	tcc_lock_wait_record(&lock->write_wait, contended, wait_start);
 }
 
 /* tcc_rwlock_write_unlock: State/registry primitive used by runtime and helper UDFs. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
@@ -984,11 +1578,18 @@ static void tcc_rwlock_write_unlock(tcc_rwlock_t *lock) {
 /* Pointer-registry primitives backing `tcc_alloc` and pointer helper scalar UDFs. */
 /* ===== Section: Pointer Registry + Pointer SQL Helpers ===== */
 static void tcc_ptr_registry_lock(tcc_ptr_registry_t *registry) {
+	bool contended = false;
+	uint64_t wait_start = 0;
 	if (!registry) {
 		return;
 	}
 	while (atomic_flag_test_and_set_explicit(&registry->lock, memory_order_acquire)) {
+		if (!contended) {
+			contended = true;
+			wait_start = tcc_now_ns();
+		}
 	}
+	tcc_lock_wait_record(&registry->lock_wait, contended, wait_start);
 }
 
 /* tcc_ptr_registry_unlock: State/registry primitive used by runtime and helper UDFs. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
@@ -1007,6 +1608,7 @@ static tcc_ptr_registry_t *tcc_ptr_registry_create(void) {
 	memset(registry, 0, sizeof(*registry));
 	atomic_init(&registry->ref_count, 1);
 	atomic_flag_clear(&registry->lock);
+	tcc_lock_wait_stats_init(&registry->lock_wait);
 	registry->next_handle = 1;
 	return registry;
 }
@@ -2998,6 +3600,248 @@ static char *tcc_library_link_name_from_path(const char *path) {
 	return name;
 }
 
+/* ===== Section: Source Files (add_file / source_file) ===== */
+/* Nesting limit for the quoted-include walk; deeper chains hash only the include name. */
+#define TCC_SOURCE_INCLUDE_MAX_DEPTH 16
+
+/* tcc_hash64: FNV-1a 64-bit over `len` bytes, continuing from `hash`. */
+static uint64_t tcc_hash64(uint64_t hash, const void *data, size_t len) {
+	const unsigned char *p = (const unsigned char *)data;
+	size_t i;
+	for (i = 0; i < len; i++) {
+		hash ^= (uint64_t)p[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* tcc_hash64_str: hashes a string including its terminator, so adjacent fields cannot run together (NULL hashes as
+ * ""). */
+static uint64_t tcc_hash64_str(uint64_t hash, const char *value) {
+	return tcc_hash64(hash, value ? value : "", value ? strlen(value) + 1 : 1);
+}
+
+/* tcc_read_text_file: reads a whole file as a NUL-terminated string. Allocation/Lifetime: returns duckdb_malloc
+ * memory the caller frees; NULL when the file cannot be read. */
+static char *tcc_read_text_file(const char *path) {
+	FILE *fp;
+	char *data = NULL;
+	size_t len = 0;
+	size_t cap = 0;
+	size_t n;
+	if (!path || path[0] == '\0') {
+		return NULL;
+	}
+	fp = fopen(path, "rb");
+	if (!fp) {
+		return NULL;
+	}
+	do {
+		if (cap - len < 4096) {
+			size_t new_cap = cap == 0 ? 16384 : cap * 2;
+			char *grown = (char *)duckdb_malloc(new_cap + 1);
+			if (!grown) {
+				duckdb_free(data);
+				fclose(fp);
+				return NULL;
+			}
+			if (data) {
+				memcpy(grown, data, len);
+				duckdb_free(data);
+			}
+			data = grown;
+			cap = new_cap;
+		}
+		n = fread(data + len, 1, cap - len, fp);
+		len += n;
+	} while (n > 0);
+	if (ferror(fp)) {
+		duckdb_free(data);
+		fclose(fp);
+		return NULL;
+	}
+	fclose(fp);
+	data[len] = '\0';
+	return data;
+}
+
+/* tcc_source_file_dir: writes the directory part of `path` ("." for a bare name) into `buf`. */
+static bool tcc_source_file_dir(const char *path, char *buf, size_t buf_len) {
+	const char *base = tcc_basename_ptr(path);
+	size_t dir_len = (size_t)(base - path);
+	if (dir_len == 0) {
+		return snprintf(buf, buf_len, ".") < (int)buf_len;
+	}
+	if (dir_len > 1) {
+		dir_len--; /* drop the trailing separator, keep "/" for files in the root */
+	}
+	if (dir_len + 1 > buf_len) {
+		return false;
+	}
+	memcpy(buf, path, dir_len);
+	buf[dir_len] = '\0';
+	return true;
+}
+
+/* tcc_source_resolve_include: finds a quoted include the way TinyCC searches: the including file's directory
+ * (the working directory for the top-level unit, which is compiled from a string), then `include_paths` and
+ * `extra_path`; the top-level file's own directory is added last by compile/add_file. Returns the contents and
+ * writes the path, or NULL when no candidate opens. */
+static char *tcc_source_resolve_include(const char *from_path, bool top_level, const char *name,
+                                        const tcc_string_list_t *include_paths, const char *extra_path, char *path_buf,
+                                        size_t path_len) {
+	char dir[1024];
+	char *contents;
+	idx_t i;
+	if (name[0] == '/' || name[0] == '\\' || top_level) {
+		if (snprintf(path_buf, path_len, "%s", name) < (int)path_len &&
+		    (contents = tcc_read_text_file(path_buf)) != NULL) {
+			return contents;
+		}
+		if (name[0] == '/' || name[0] == '\\') {
+			return NULL;
+		}
+	} else if (tcc_source_file_dir(from_path, dir, sizeof(dir)) &&
+	           snprintf(path_buf, path_len, "%s/%s", dir, name) < (int)path_len &&
+	           (contents = tcc_read_text_file(path_buf)) != NULL) {
+		return contents;
+	}
+	for (i = 0; include_paths && i < include_paths->count; i++) {
+		if (snprintf(path_buf, path_len, "%s/%s", include_paths->items[i], name) < (int)path_len &&
+		    (contents = tcc_read_text_file(path_buf)) != NULL) {
+			return contents;
+		}
+	}
+	if (extra_path && extra_path[0] != '\0' && snprintf(path_buf, path_len, "%s/%s", extra_path, name) < (int)path_len &&
+	    (contents = tcc_read_text_file(path_buf)) != NULL) {
+		return contents;
+	}
+	if (top_level && tcc_source_file_dir(from_path, dir, sizeof(dir)) &&
+	    snprintf(path_buf, path_len, "%s/%s", dir, name) < (int)path_len) {
+		return tcc_read_text_file(path_buf);
+	}
+	return NULL;
+}
+
+/**
+ * @function tcc_source_hash_graph
+ * @brief Hashes a source file together with every file it reaches through quoted `#include "..."` lines.
+ * @param[in] path Path of the file (hashed, and the base directory for its quoted includes).
+ * @param[in] contents File contents.
+ * @param[in] include_paths Session include paths searched after the file's own directory.
+ * @param[in] extra_path Optional per-call include path searched last.
+ * @param[in,out] visited Paths already hashed; a file included twice contributes its path only.
+ * @param[in] depth Current nesting depth.
+ * @param[in] hash Running hash.
+ * @return The updated hash.
+ * @ownership borrows(all inputs)
+ * @note TinyCC only records dependencies for `-MD` output files, so the graph is found by scanning rather than
+ * from the compiler. `<...>` includes are system headers and are not tracked; a quoted include that cannot be
+ * opened hashes its name only, so its contents start counting once the file appears.
+ */
+static uint64_t tcc_source_hash_graph(const char *path, const char *contents, const tcc_string_list_t *include_paths,
+                                      const char *extra_path, tcc_string_list_t *visited, int depth, uint64_t hash) {
+	const char *line = contents;
+	hash = tcc_hash64_str(hash, path);
+	hash = tcc_hash64_str(hash, contents);
+	while (line && *line) {
+		const char *p = line;
+		const char *next = strchr(line, '\n');
+		line = next ? next + 1 : NULL;
+		while (*p == ' ' || *p == '\t') {
+			p++;
+		}
+		if (*p++ != '#') {
+			continue;
+		}
+		while (*p == ' ' || *p == '\t') {
+			p++;
+		}
+		if (strncmp(p, "include", 7) != 0) {
+			continue;
+		}
+		p += 7;
+		while (*p == ' ' || *p == '\t') {
+			p++;
+		}
+		if (*p == '"') {
+			char name[512];
+			char resolved[1024];
+			const char *end = strchr(p + 1, '"');
+			size_t name_len = end ? (size_t)(end - p - 1) : 0;
+			char *included;
+			if (!end || (next && end > next) || name_len == 0 || name_len >= sizeof(name)) {
+				continue;
+			}
+			memcpy(name, p + 1, name_len);
+			name[name_len] = '\0';
+			included = depth < TCC_SOURCE_INCLUDE_MAX_DEPTH
+			               ? tcc_source_resolve_include(path, depth == 0, name, include_paths, extra_path, resolved,
+			                                            sizeof(resolved))
+			               : NULL;
+			if (!included) {
+				hash = tcc_hash64_str(hash, name);
+			} else if (tcc_string_list_contains(visited, resolved) || !tcc_string_list_append(visited, resolved)) {
+				hash = tcc_hash64_str(hash, resolved);
+			} else {
+				hash = tcc_source_hash_graph(resolved, included, include_paths, extra_path, visited, depth + 1,
+				                             hash);
+			}
+			if (included) {
+				duckdb_free(included);
+			}
+		}
+	}
+	return hash;
+}
+
+/* tcc_source_file_hash: hash of a source file and its quoted-include graph. */
+static uint64_t tcc_source_file_hash(const char *path, const char *contents, const tcc_string_list_t *include_paths,
+                                     const char *extra_path) {
+	tcc_string_list_t visited;
+	uint64_t hash;
+	memset(&visited, 0, sizeof(visited));
+	(void)tcc_string_list_append(&visited, path);
+	hash = tcc_source_hash_graph(path, contents, include_paths, extra_path, &visited, 0, 14695981039346656037ULL);
+	tcc_string_list_destroy(&visited);
+	return hash;
+}
+
+/* tcc_session_files_destroy: releases the `add_file` records (the staged sources themselves live in `sources`). */
+static void tcc_session_files_destroy(tcc_session_t *session) {
+	idx_t i;
+	for (i = 0; i < session->file_count; i++) {
+		duckdb_free(session->files[i].path);
+	}
+	if (session->files) {
+		duckdb_free(session->files);
+	}
+	session->files = NULL;
+	session->file_count = 0;
+	session->file_capacity = 0;
+}
+
+/* tcc_session_hash_inputs: hashes everything the session contributes to a compile: staged paths, headers, sources,
+ * defines and injected symbols. */
+static uint64_t tcc_session_hash_inputs(const tcc_session_t *session, uint64_t hash) {
+	const tcc_string_list_t *lists[] = {&session->include_paths, &session->sysinclude_paths, &session->library_paths,
+	                                    &session->libraries,     &session->options,          &session->headers,
+	                                    &session->sources,       &session->define_names,     &session->define_values,
+	                                    &session->symbol_names};
+	size_t l;
+	idx_t i;
+	for (l = 0; l < sizeof(lists) / sizeof(lists[0]); l++) {
+		hash = tcc_hash64(hash, &lists[l]->count, sizeof(lists[l]->count));
+		for (i = 0; i < lists[l]->count; i++) {
+			hash = tcc_hash64_str(hash, lists[l]->items[i]);
+		}
+	}
+	if (session->symbol_count > 0) {
+		hash = tcc_hash64(hash, session->symbol_ptrs, sizeof(uint64_t) * (size_t)session->symbol_count);
+	}
+	return hash;
+}
+
 /* tcc_session_clear_bind: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
 static void tcc_session_clear_bind(tcc_session_t *session) {
 	if (!session) {
@@ -3038,6 +3882,7 @@ static void tcc_session_clear_build_state(tcc_session_t *session) {
 	}
 	session->symbol_count = 0;
 	session->symbol_capacity = 0;
+	tcc_session_files_destroy(session);
 	tcc_session_clear_bind(session);
 	session->state_id++;
 	session->config_version++;
@@ -3135,6 +3980,25 @@ static void tcc_host_sig_ctx_destroy(void *ptr) {
 	tcc_struct_meta_destroy(&ctx->return_struct_meta);
 	tcc_map_meta_destroy(&ctx->return_map_meta);
 	tcc_union_meta_destroy(&ctx->return_union_meta);
+	if (ctx->arrow_children) {
+		duckdb_free(ctx->arrow_children);
+	}
+	if (ctx->arrow_child_ptrs) {
+		duckdb_free(ctx->arrow_child_ptrs);
+	}
+	if (ctx->arrow_child_names) {
+		duckdb_free(ctx->arrow_child_names);
+	}
+#ifdef TCC_ISOLATION_SUPPORTED
+	if (ctx->isolation) {
+		tcc_isolation_pool_destroy(ctx->isolation);
+	}
+#endif
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (ctx->specialize) {
+		tcc_specialize_plan_destroy(ctx->specialize);
+	}
+#endif
 	duckdb_free(ctx);
 }
 
@@ -4615,8 +5479,14 @@ static tcc_value_bridge_t *tcc_build_value_bridge(duckdb_vector vector, const tc
 		}
 		memset(bridge->children, 0, sizeof(tcc_value_bridge_t *) * (size_t)field_count);
 		for (i = 0; i < field_count; i++) {
-			duckdb_vector child_vector = duckdb_struct_vector_get_child(vector, i);
+			duckdb_vector child_vector;
 			tcc_value_bridge_t *child_bridge;
+			if (desc->as.struct_like.fields[i].skip) {
+				bridge->child_ptrs[i] = NULL;
+				bridge->child_validity_ptrs[i] = NULL;
+				continue;
+			}
+			child_vector = duckdb_struct_vector_get_child(vector, i);
 			if (!child_vector) {
 				if (out_error) {
 					*out_error = "ducktinycc missing struct child vector";
@@ -5018,6 +5888,13 @@ static bool tcc_write_value_to_vector(duckdb_vector vector, const tcc_typedesc_t
 				}
 				return false;
 			}
+			if (!st->field_ptrs[field_idx]) {
+				/* A field the input bridge skipped (`used := [...]`) carries no data. */
+				if (!tcc_set_vector_row_validity(field_vector, row, false)) {
+					return false;
+				}
+				continue;
+			}
 			if (!tcc_write_value_to_vector(field_vector, desc->as.struct_like.fields[field_idx].type, row,
 			                               st->field_ptrs[field_idx], st->offset, field_validity, out_error)) {
 				return false;
@@ -5157,43 +6034,560 @@ static bool tcc_write_value_to_vector(duckdb_vector vector, const tcc_typedesc_t
 	return true;
 }
 
+/* ===== Section: Arrow C Data Interface Wrapper ===== */
+
+/* tcc_arrow_format_for_type: Maps one scalar FFI type to its Arrow format string. Returns NULL for types the
+ * `arrow` wrapper mode cannot carry (void, decimal/uuid/interval and all nested types). */
+static const char *tcc_arrow_format_for_type(tcc_ffi_type_t type) {
+	switch (type) {
+	case TCC_FFI_BOOL:
+		return "b";
+	case TCC_FFI_I8:
+		return "c";
+	case TCC_FFI_U8:
+		return "C";
+	case TCC_FFI_I16:
+		return "s";
+	case TCC_FFI_U16:
+		return "S";
+	case TCC_FFI_I32:
+		return "i";
+	case TCC_FFI_U32:
+		return "I";
+	case TCC_FFI_I64:
+		return "l";
+	case TCC_FFI_U64:
+	case TCC_FFI_PTR:
+		return "L";
+	case TCC_FFI_F32:
+		return "f";
+	case TCC_FFI_F64:
+		return "g";
+	case TCC_FFI_VARCHAR:
+		return "u";
+	case TCC_FFI_BLOB:
+		return "z";
+	case TCC_FFI_DATE:
+		return "tdD";
+	case TCC_FFI_TIME:
+		return "ttu";
+	case TCC_FFI_TIMESTAMP:
+		return "tsu:";
+	default:
+		return NULL;
+	}
+}
+
+/* tcc_arrow_type_is_varlen: Returns whether an arrow-mode type uses the offsets + data buffer layout. */
+static bool tcc_arrow_type_is_varlen(tcc_ffi_type_t type) {
+	return type == TCC_FFI_VARCHAR || type == TCC_FFI_BLOB;
+}
+
+/* tcc_arrow_bit_is_set: Reads one bit of an Arrow (LSB-first) bitmap; a NULL bitmap means all bits are set. */
+static bool tcc_arrow_bit_is_set(const void *bitmap, uint64_t idx) {
+	const uint8_t *bytes = (const uint8_t *)bitmap;
+	if (!bytes) {
+		return true;
+	}
+	return ((bytes[idx >> 3] >> (idx & 7)) & 1) != 0;
+}
+
+/* Host-side release callbacks for borrowed Arrow views: they only mark the struct released, because the buffers
+ * belong to DuckDB vectors or to per-chunk scratch that the host frees itself. */
+static void tcc_arrow_release_borrowed_schema(struct ArrowSchema *schema) {
+	if (schema) {
+		schema->release = NULL;
+	}
+}
+
+static void tcc_arrow_release_borrowed_array(struct ArrowArray *array) {
+	if (array) {
+		array->release = NULL;
+	}
+}
+
+/* tcc_arrow_schema_init: Builds the immutable "+s" input schema (children "a0".."aN") stored in the signature ctx.
+ * Allocation/Lifetime: child schemas and names are duckdb_malloc'd and released by tcc_host_sig_ctx_destroy. */
+static bool tcc_arrow_schema_init(tcc_host_sig_ctx_t *ctx) {
+	int i;
+	if (!ctx || ctx->arg_count < 0) {
+		return false;
+	}
+	if (ctx->arg_count > 0) {
+		ctx->arrow_children = (struct ArrowSchema *)duckdb_malloc(sizeof(struct ArrowSchema) * (size_t)ctx->arg_count);
+		ctx->arrow_child_ptrs =
+		    (struct ArrowSchema **)duckdb_malloc(sizeof(struct ArrowSchema *) * (size_t)ctx->arg_count);
+		ctx->arrow_child_names = (char *)duckdb_malloc((size_t)ctx->arg_count * 16);
+		if (!ctx->arrow_children || !ctx->arrow_child_ptrs || !ctx->arrow_child_names) {
+			return false;
+		}
+		memset(ctx->arrow_children, 0, sizeof(struct ArrowSchema) * (size_t)ctx->arg_count);
+	}
+	for (i = 0; i < ctx->arg_count; i++) {
+		struct ArrowSchema *child = &ctx->arrow_children[i];
+		char *name = ctx->arrow_child_names + ((size_t)i * 16);
+		child->format = tcc_arrow_format_for_type(ctx->arg_types[i]);
+		if (!child->format) {
+			return false;
+		}
+		snprintf(name, 16, "a%d", i);
+		child->name = name;
+		child->flags = ARROW_FLAG_NULLABLE;
+		child->release = tcc_arrow_release_borrowed_schema;
+		ctx->arrow_child_ptrs[i] = child;
+	}
+	memset(&ctx->arrow_schema, 0, sizeof(ctx->arrow_schema));
+	ctx->arrow_schema.format = "+s";
+	ctx->arrow_schema.name = "";
+	ctx->arrow_schema.n_children = ctx->arg_count;
+	ctx->arrow_schema.children = ctx->arrow_child_ptrs;
+	ctx->arrow_schema.release = tcc_arrow_release_borrowed_schema;
+	return true;
+}
+
+/* tcc_arrow_export_varlen_column: Copies one VARCHAR/BLOB column into Arrow int32 offsets + data buffers.
+ * Allocation/Lifetime: both buffers are duckdb_malloc'd into `out_offsets`/`out_data`; caller frees them. */
+static const char *tcc_arrow_export_varlen_column(duckdb_string_t *strings, const uint64_t *validity, idx_t n,
+                                                  int32_t **out_offsets, uint8_t **out_data) {
+	int32_t *offsets;
+	uint8_t *data;
+	uint64_t total = 0;
+	idx_t row;
+	offsets = (int32_t *)duckdb_malloc(sizeof(int32_t) * ((size_t)n + 1));
+	if (!offsets) {
+		return "ducktinycc out of memory";
+	}
+	*out_offsets = offsets;
+	for (row = 0; row < n; row++) {
+		if (validity && !duckdb_validity_row_is_valid((uint64_t *)validity, row)) {
+			continue;
+		}
+		total += (uint64_t)duckdb_string_t_length(strings[row]);
+	}
+	if (total > (uint64_t)INT32_MAX) {
+		return "ducktinycc arrow chunk string payload exceeds 2GiB";
+	}
+	data = (uint8_t *)duckdb_malloc(total > 0 ? (size_t)total : 1);
+	if (!data) {
+		return "ducktinycc out of memory";
+	}
+	*out_data = data;
+	total = 0;
+	offsets[0] = 0;
+	for (row = 0; row < n; row++) {
+		if (!validity || duckdb_validity_row_is_valid((uint64_t *)validity, row)) {
+			uint32_t len = duckdb_string_t_length(strings[row]);
+			if (len > 0) {
+				memcpy(data + total, duckdb_string_t_data(&strings[row]), (size_t)len);
+			}
+			total += len;
+		}
+		offsets[row + 1] = (int32_t)total;
+	}
+	return NULL;
+}
+
 /**
- * @function tcc_execute_compiled_scalar_udf
- * @brief Execute generated row/chunk-scalar-loop wrappers and marshal DuckDB vectors to/from C bridge descriptors.
- * @param[in] info DuckDB function invocation info.
+ * @function tcc_execute_arrow_scalar_udf
+ * @brief Execute an `arrow` wrapper: export the input chunk as an Arrow struct array and import the result array.
+ * @param[in] ctx Signature context of the registered UDF.
  * @param[in] input Borrowed input chunk.
  * @param[out] output Borrowed output vector to fill.
- * @ownership borrows(info,input,output), transfers(none)
- * @heap allocates transient per-call bridge buffers and decoded varchar/blob arrays; all released in cleanup path
- * @stack fixed-size locals only (large buffers are heap-backed)
- * @thread_safety relies on immutable signature context + per-call temporaries
- * @locks none (registry/session locking happens at other boundaries)
- * @errors sets duckdb_scalar_function_set_error(info, ...) on bridge/runtime failures
+ * @param[in,out] split Optional phase-time accumulator (NULL outside `mode := 'bench'`).
+ * @param[out] out_error Static error message when returning false.
+ * @return true when the chunk completed; false with `*out_error` set.
+ * @ownership borrows(ctx,input,output); the kernel borrows schema/input for the call and returns `out` either
+ *            in place (release == NULL, written through host buffers) or as an owned array the host releases
+ * @heap fixed-width columns and validity are exported zero-copy from DuckDB vectors; BOOL bitmaps and
+ *       VARCHAR/BLOB offsets+data are per-chunk duckdb_malloc scratch released in cleanup
+ * @stack fixed-size locals only
+ * @thread_safety relies on immutable signature context (including the shared schema) + per-call temporaries
+ * @locks none
+ * @errors reports export/import/runtime failures through `*out_error`
+ * @note DuckDB validity masks are 64-bit LSB-first words, which match Arrow bitmaps byte-for-byte on
+ *       little-endian hosts; this is what makes the validity export zero-copy.
  */
-static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_data_chunk input, duckdb_vector output) {
-	tcc_host_sig_ctx_t *ctx = (tcc_host_sig_ctx_t *)duckdb_scalar_function_get_extra_info(info);
+static bool tcc_execute_arrow_scalar_udf(tcc_host_sig_ctx_t *ctx, duckdb_data_chunk input, duckdb_vector output,
+                                         tcc_exec_split_t *split, const char **out_error) {
 	idx_t n = duckdb_data_chunk_get_size(input);
 	uint8_t *out_data = (uint8_t *)duckdb_vector_get_data(output);
 	uint64_t *out_validity;
-	uint8_t **in_data = NULL;
-	uint64_t **in_validity = NULL;
+	uint64_t *out_bits = NULL;
+	struct ArrowArray root;
+	struct ArrowArray out;
+	struct ArrowArray *children = NULL;
+	struct ArrowArray **child_ptrs = NULL;
+	const void **child_buffers = NULL;
+	void **scratch = NULL;
+	const void *root_buffers[1];
+	const void *out_buffers[3];
 	size_t ret_size;
-	void **arg_ptrs = NULL;
-	void **batch_arg_data = NULL;
-	const char **row_varchar_values = NULL;
-	char **row_varchar_allocations = NULL;
-	idx_t row_varchar_alloc_count = 0;
-	idx_t row_varchar_alloc_capacity = 0;
-	ducktinycc_blob_t *row_blob_values = NULL;
-	ducktinycc_blob_t **batch_blob_columns = NULL;
-	const char ***batch_varchar_columns = NULL;
-	char ***batch_varchar_owned = NULL;
-	tcc_value_bridge_t **arg_value_bridges = NULL;
-	const char **batch_out_varchar = NULL;
-	ducktinycc_blob_t *batch_out_blob = NULL;
-	ducktinycc_list_t *batch_out_list = NULL;
+	size_t bitmap_bytes = (((size_t)n + 63) / 64) * sizeof(uint64_t);
+	bool ret_varlen;
+	idx_t row;
+	int col;
+	const char *error = NULL;
+	uint64_t t_mark = split ? tcc_now_ns() : 0;
+	tcc_exec_phase_t pending = TCC_EXEC_PHASE_MARSHAL;
+	bool invoked;
+	memset(&out, 0, sizeof(out));
+	if (!ctx || !ctx->arrow_wrapper || ctx->arg_count < 0) {
+		*out_error = "ducktinycc arrow wrapper missing";
+		return false;
+	}
+	ret_size = tcc_ffi_type_size(ctx->return_type);
+	ret_varlen = tcc_arrow_type_is_varlen(ctx->return_type);
+	if (ctx->arg_count > 0) {
+		children = (struct ArrowArray *)duckdb_malloc(sizeof(struct ArrowArray) * (size_t)ctx->arg_count);
+		child_ptrs = (struct ArrowArray **)duckdb_malloc(sizeof(struct ArrowArray *) * (size_t)ctx->arg_count);
+		child_buffers = (const void **)duckdb_malloc(sizeof(void *) * 3 * (size_t)ctx->arg_count);
+		scratch = (void **)duckdb_malloc(sizeof(void *) * 2 * (size_t)ctx->arg_count);
+		if (!children || !child_ptrs || !child_buffers || !scratch) {
+			error = "ducktinycc out of memory";
+			goto cleanup;
+		}
+		memset(children, 0, sizeof(struct ArrowArray) * (size_t)ctx->arg_count);
+		memset(child_buffers, 0, sizeof(void *) * 3 * (size_t)ctx->arg_count);
+		memset(scratch, 0, sizeof(void *) * 2 * (size_t)ctx->arg_count);
+	}
+	for (col = 0; col < ctx->arg_count; col++) {
+		duckdb_vector v = duckdb_data_chunk_get_vector(input, (idx_t)col);
+		uint8_t *data = (uint8_t *)duckdb_vector_get_data(v);
+		uint64_t *validity = duckdb_vector_get_validity(v);
+		struct ArrowArray *child = &children[col];
+		const void **buffers = &child_buffers[(size_t)col * 3];
+		child->length = (int64_t)n;
+		child->null_count = validity ? -1 : 0;
+		child->n_buffers = 2;
+		child->buffers = buffers;
+		child->release = tcc_arrow_release_borrowed_array;
+		buffers[0] = validity;
+		if (ctx->arg_types[col] == TCC_FFI_BOOL) {
+			uint8_t *bits = (uint8_t *)duckdb_malloc(bitmap_bytes > 0 ? bitmap_bytes : 1);
+			if (!bits) {
+				error = "ducktinycc out of memory";
+				goto cleanup;
+			}
+			memset(bits, 0, bitmap_bytes > 0 ? bitmap_bytes : 1);
+			for (row = 0; row < n; row++) {
+				if (data[row]) {
+					bits[row >> 3] |= (uint8_t)(1u << (row & 7));
+				}
+			}
+			scratch[(size_t)col * 2] = bits;
+			buffers[1] = bits;
+		} else if (tcc_arrow_type_is_varlen(ctx->arg_types[col])) {
+			int32_t *offsets = NULL;
+			uint8_t *payload = NULL;
+			error = tcc_arrow_export_varlen_column((duckdb_string_t *)data, validity, n, &offsets, &payload);
+			scratch[(size_t)col * 2] = offsets;
+			scratch[(size_t)col * 2 + 1] = payload;
+			if (error) {
+				goto cleanup;
+			}
+			child->n_buffers = 3;
+			buffers[1] = offsets;
+			buffers[2] = payload;
+		} else {
+			buffers[1] = data;
+		}
+		child_ptrs[col] = child;
+	}
+	root_buffers[0] = NULL;
+	memset(&root, 0, sizeof(root));
+	root.length = (int64_t)n;
+	root.n_buffers = 1;
+	root.buffers = root_buffers;
+	root.n_children = ctx->arg_count;
+	root.children = child_ptrs;
+	root.release = tcc_arrow_release_borrowed_array;
+
+	duckdb_vector_ensure_validity_writable(output);
+	out_validity = duckdb_vector_get_validity(output);
+	if (!out_validity) {
+		error = "ducktinycc output validity missing";
+		goto cleanup;
+	}
+	tcc_validity_set_all(out_validity, n, true);
+	/* Pre-populate `out` with the output vector's own buffers so fixed-width kernels can write in place. */
+	out_buffers[0] = out_validity;
+	out_buffers[1] = out_data;
+	out_buffers[2] = NULL;
+	if (ctx->return_type == TCC_FFI_BOOL) {
+		out_bits = (uint64_t *)duckdb_malloc(bitmap_bytes > 0 ? bitmap_bytes : sizeof(uint64_t));
+		if (!out_bits) {
+			error = "ducktinycc out of memory";
+			goto cleanup;
+		}
+		memset(out_bits, 0, bitmap_bytes > 0 ? bitmap_bytes : sizeof(uint64_t));
+		out_buffers[1] = out_bits;
+	} else if (ret_varlen) {
+		out_buffers[1] = NULL;
+	}
+	out.length = (int64_t)n;
+	out.n_buffers = ret_varlen ? 3 : 2;
+	out.buffers = out_buffers;
+
+	TCC_EXEC_SPLIT_LAP(split, pending, t_mark);
+	invoked = ctx->arrow_wrapper(&ctx->arrow_schema, &root, &out);
+	TCC_EXEC_SPLIT_LAP(split, TCC_EXEC_PHASE_CALL, t_mark);
+	pending = TCC_EXEC_PHASE_WRITEBACK;
+	if (!invoked) {
+		error = "ducktinycc invoke failed";
+		goto cleanup;
+	}
+	if (!out.release) {
+		if (ret_varlen) {
+			error = "ducktinycc arrow varchar/blob results must be returned as an owned array";
+			goto cleanup;
+		}
+		if (out.buffers != out_buffers || out.length != (int64_t)n || out.offset != 0) {
+			error = "ducktinycc arrow result without release callback must be written in place";
+			goto cleanup;
+		}
+		if (ctx->return_type == TCC_FFI_BOOL) {
+			for (row = 0; row < n; row++) {
+				out_data[row] = tcc_arrow_bit_is_set(out_bits, (uint64_t)row) ? 1 : 0;
+			}
+		}
+		goto cleanup;
+	}
+	if (out.length != (int64_t)n || out.offset < 0) {
+		error = "ducktinycc arrow result length mismatch";
+		goto cleanup;
+	}
+	if (!out.buffers || out.n_buffers < (ret_varlen ? 3 : 2) || (n > 0 && !out.buffers[1]) ||
+	    (n > 0 && ret_varlen && !out.buffers[2])) {
+		error = "ducktinycc arrow result is missing buffers";
+		goto cleanup;
+	}
+	{
+		const uint64_t off = (uint64_t)out.offset;
+		const void *bitmap = out.null_count != 0 ? out.buffers[0] : NULL;
+		const uint8_t *values = (const uint8_t *)out.buffers[1];
+		if (bitmap != (const void *)out_validity || off != 0) {
+			for (row = 0; row < n; row++) {
+				if (!tcc_arrow_bit_is_set(bitmap, off + row)) {
+					duckdb_validity_set_row_validity(out_validity, row, false);
+				}
+			}
+		}
+		if (ctx->return_type == TCC_FFI_BOOL) {
+			for (row = 0; row < n; row++) {
+				out_data[row] = tcc_arrow_bit_is_set(values, off + row) ? 1 : 0;
+			}
+		} else if (ret_varlen) {
+			const int32_t *offsets = (const int32_t *)out.buffers[1];
+			const char *payload = (const char *)out.buffers[2];
+			for (row = 0; row < n; row++) {
+				int32_t start;
+				int32_t end;
+				if (!duckdb_validity_row_is_valid(out_validity, row)) {
+					continue;
+				}
+				start = offsets[off + row];
+				end = offsets[off + row + 1];
+				if (start < 0 || end < start) {
+					error = "ducktinycc arrow result has invalid offsets";
+					goto cleanup;
+				}
+				duckdb_vector_assign_string_element_len(output, row, payload + start, (idx_t)(end - start));
+			}
+		} else if (n > 0 && values + (off * ret_size) != out_data) {
+			/* Kernel produced its own buffer: one memcpy per chunk. Writing in place skips even this. */
+			memcpy(out_data, values + (off * ret_size), (size_t)n * ret_size);
+		}
+	}
+cleanup:
+	if (out.release) {
+		out.release(&out);
+	}
+	if (scratch) {
+		for (col = 0; col < ctx->arg_count * 2; col++) {
+			if (scratch[col]) {
+				duckdb_free(scratch[col]);
+			}
+		}
+		duckdb_free((void *)scratch);
+	}
+	if (out_bits) {
+		duckdb_free(out_bits);
+	}
+	if (children) {
+		duckdb_free(children);
+	}
+	if (child_ptrs) {
+		duckdb_free((void *)child_ptrs);
+	}
+	if (child_buffers) {
+		duckdb_free((void *)child_buffers);
+	}
+	TCC_EXEC_SPLIT_LAP(split, pending, t_mark);
+	if (error) {
+		*out_error = error;
+		return false;
+	}
+	return true;
+}
+
+/* ===== Section: Return Arena (ducktinycc_out_alloc) ===== */
+/* Smallest arena block; a larger request gets a block of its own size. */
+#define TCC_OUT_ARENA_BLOCK_SIZE 65536
+
+/* One arena block; the payload follows the header, which is padded to 16 bytes. */
+typedef struct tcc_out_arena_block {
+	struct tcc_out_arena_block *next;
+	size_t size;
+	size_t used;
+	size_t pad;
+} tcc_out_arena_block_t;
+
+/* Cached MAP key indexes per chunk; a map's slot is picked from its key buffer address. */
+#define TCC_MAP_INDEX_SLOTS 8
+
+/* Open-addressing index over the keys of one MAP value, built by ducktinycc_map_find. `table` entries hold the key
+ * position + 1 (0 is empty); the buffer is kept across rebuilds of the slot and freed with the arena. */
+typedef struct {
+	const void *key_ptr;
+	uint64_t len;
+	uint64_t key_size;
+	uint64_t mask;
+	uint32_t *table;
+	uint64_t table_capacity;
+} tcc_map_index_t;
+
+/* Bump allocator for return payloads of one executing chunk, plus the chunk's MAP key indexes. Lives on the
+ * executor's stack. */
+typedef struct {
+	tcc_out_arena_block_t *head;
+	tcc_map_index_t map_index[TCC_MAP_INDEX_SLOTS];
+} tcc_out_arena_t;
+
+/* Arena of the chunk executing on this thread; ducktinycc_out_alloc carves from it, NULL outside a chunk. */
+static TCC_THREAD_LOCAL tcc_out_arena_t *tcc_current_out_arena = NULL;
+
+/* tcc_out_arena_reset: frees every block and MAP key index. Allocation/Lifetime: payloads handed out by the arena
+ * become invalid. */
+static void tcc_out_arena_reset(tcc_out_arena_t *arena) {
+	int i;
+	while (arena->head) {
+		tcc_out_arena_block_t *next = arena->head->next;
+		duckdb_free(arena->head);
+		arena->head = next;
+	}
+	for (i = 0; i < TCC_MAP_INDEX_SLOTS; i++) {
+		if (arena->map_index[i].table) {
+			duckdb_free(arena->map_index[i].table);
+		}
+	}
+	memset(arena->map_index, 0, sizeof(arena->map_index));
+}
+
+/* ducktinycc_out_alloc: Host-exported bump allocator for VARCHAR/BLOB/LIST/MAP return payloads. Allocation/Lifetime:
+ * memory is 16-byte aligned and owned by the current chunk; it stays valid until that chunk's writeback finishes and
+ * is released in one step afterwards. Returns NULL outside a UDF call or when out of memory. */
+static void *ducktinycc_out_alloc(uint64_t size) {
+	tcc_out_arena_t *arena = tcc_current_out_arena;
+	tcc_out_arena_block_t *block;
+	size_t need;
+	if (!arena || size > (uint64_t)(SIZE_MAX / 2)) {
+		return NULL;
+	}
+	need = ((size_t)size + 15) & ~(size_t)15;
+	block = arena->head;
+	if (!block || block->size - block->used < need) {
+		size_t block_size = need > TCC_OUT_ARENA_BLOCK_SIZE ? need : TCC_OUT_ARENA_BLOCK_SIZE;
+		block = (tcc_out_arena_block_t *)duckdb_malloc(sizeof(tcc_out_arena_block_t) + block_size);
+		if (!block) {
+			return NULL;
+		}
+		block->size = block_size;
+		block->used = 0;
+		block->next = arena->head;
+		arena->head = block;
+	}
+	block->used += need;
+	return (uint8_t *)(block + 1) + (block->used - need);
+}
+
+/* tcc_predicate_expand: turns a predicate kernel's selection bitmask into the BOOLEAN output, eight rows per
+ * multiply, and ANDs the argument validity masks into the output validity one word at a time. */
+static void tcc_predicate_expand(const uint64_t *mask, idx_t count, uint8_t *out, uint64_t *out_validity,
+                                 const uint64_t *const *arg_validity, int arg_count) {
+	idx_t word_count = (count + 63) / 64;
+	idx_t w;
+	idx_t row;
+	int col;
+	for (row = 0; row < count; row += 8) {
+		uint64_t bits = (mask[row >> 6] >> (row & 63)) & 0xFFULL;
+		uint64_t bytes = (bits * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+		idx_t i;
+		bytes = ((bytes + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		if (row + 8 <= count) {
+			memcpy(out + row, &bytes, sizeof(bytes));
+			continue;
+		}
+#endif
+		for (i = 0; i < 8 && row + i < count; i++) {
+			out[row + i] = (uint8_t)(bytes >> (8 * i));
+		}
+	}
+	for (col = 0; col < arg_count && out_validity; col++) {
+		if (!arg_validity || !arg_validity[col]) {
+			continue;
+		}
+		for (w = 0; w < word_count; w++) {
+			out_validity[w] &= arg_validity[col][w];
+		}
+	}
+}
+
+/**
+ * @function tcc_execute_compiled_scalar_udf
+ * @brief Execute generated row/chunk-scalar-loop wrappers and marshal DuckDB vectors to/from C bridge descriptors.
+ * @param[in] ctx Signature context of the registered UDF.
+ * @param[in] input Borrowed input chunk.
+ * @param[out] output Borrowed output vector to fill.
+ * @param[in,out] split Optional phase-time accumulator (NULL outside `mode := 'bench'`); row mode reads the
+ *                clock three times per row when set.
+ * @param[out] out_error Static error message when returning false.
+ * @return true when the chunk completed; false with `*out_error` set.
+ * @ownership borrows(ctx,input,output), transfers(none)
+ * @heap allocates transient per-call bridge buffers and decoded varchar/blob arrays; all released in cleanup path
+ * @stack fixed-size locals only (large buffers are heap-backed)
+ * @thread_safety relies on immutable signature context + per-call temporaries
+ * @locks none (registry/session locking happens at other boundaries)
+ * @errors reports bridge/runtime failures through `*out_error`
+ */
+static bool tcc_execute_compiled_scalar_udf(tcc_host_sig_ctx_t *ctx, duckdb_data_chunk input, duckdb_vector output,
+                                            tcc_exec_split_t *split, const char **out_error) {
+	idx_t n = duckdb_data_chunk_get_size(input);
+	uint8_t *out_data = (uint8_t *)duckdb_vector_get_data(output);
+	uint64_t *out_validity;
+	uint8_t **in_data = NULL;
+	uint64_t **in_validity = NULL;
+	size_t ret_size;
+	void **arg_ptrs = NULL;
+	void **batch_arg_data = NULL;
+	const char **row_varchar_values = NULL;
+	char **row_varchar_allocations = NULL;
+	idx_t row_varchar_alloc_count = 0;
+	idx_t row_varchar_alloc_capacity = 0;
+	ducktinycc_blob_t *row_blob_values = NULL;
+	ducktinycc_blob_t **batch_blob_columns = NULL;
+	const char ***batch_varchar_columns = NULL;
+	char ***batch_varchar_owned = NULL;
+	tcc_value_bridge_t **arg_value_bridges = NULL;
+	const char **batch_out_varchar = NULL;
+	ducktinycc_blob_t *batch_out_blob = NULL;
+	ducktinycc_list_t *batch_out_list = NULL;
 	ducktinycc_array_t *batch_out_array = NULL;
 	ducktinycc_struct_t *batch_out_struct = NULL;
+	void **columnar_ptrs = NULL;
+	uint64_t **columnar_validity = NULL;
+	uint64_t *predicate_words = NULL;
+	ducktinycc_struct_out_t columnar_out;
 	ducktinycc_map_t *batch_out_map = NULL;
 	ducktinycc_union_t *batch_out_union = NULL;
 	uint8_t out_value[64];
@@ -5205,35 +6599,42 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 	ducktinycc_map_t out_map_value;
 	ducktinycc_union_t out_union_value;
 	void *batch_out_ptr = NULL;
+	tcc_out_arena_t out_arena = {NULL};
+	tcc_out_arena_t *prev_out_arena;
 	idx_t row;
 	int col;
 	const char *error = NULL;
 	const tcc_typedesc_t *return_desc = NULL;
+	uint64_t t_mark = split ? tcc_now_ns() : 0;
+	tcc_exec_phase_t pending = TCC_EXEC_PHASE_MARSHAL;
+	bool invoked;
 	if (!ctx || ctx->arg_count < 0) {
-		duckdb_scalar_function_set_error(info, "ducktinycc signature ctx missing");
-		return;
+		*out_error = "ducktinycc signature ctx missing";
+		return false;
 	}
 	if (ctx->wrapper_mode == TCC_WRAPPER_MODE_ROW && !ctx->row_wrapper) {
-		duckdb_scalar_function_set_error(info, "ducktinycc row wrapper missing");
-		return;
+		*out_error = "ducktinycc row wrapper missing";
+		return false;
 	}
 	if (ctx->wrapper_mode == TCC_WRAPPER_MODE_BATCH && !ctx->batch_wrapper) {
-		duckdb_scalar_function_set_error(info, "ducktinycc batch wrapper missing");
-		return;
+		*out_error = "ducktinycc batch wrapper missing";
+		return false;
 	}
 	if (ctx->wrapper_mode != TCC_WRAPPER_MODE_ROW && ctx->wrapper_mode != TCC_WRAPPER_MODE_BATCH) {
-		duckdb_scalar_function_set_error(info, "ducktinycc signature ctx missing");
-		return;
+		*out_error = "ducktinycc signature ctx missing";
+		return false;
 	}
 	return_desc = ctx->return_desc;
 	if (!return_desc) {
-		duckdb_scalar_function_set_error(info, "ducktinycc typed signature is missing");
-		return;
+		*out_error = "ducktinycc typed signature is missing";
+		return false;
 	}
 	if ((size_t)ctx->arg_count > (SIZE_MAX / sizeof(uint8_t *))) {
-		duckdb_scalar_function_set_error(info, "ducktinycc arg count too large");
-		return;
+		*out_error = "ducktinycc arg count too large";
+		return false;
 	}
+	prev_out_arena = tcc_current_out_arena;
+	tcc_current_out_arena = &out_arena;
 	if (ctx->arg_count > 0) {
 		in_data = (uint8_t **)duckdb_malloc(sizeof(uint8_t *) * (size_t)ctx->arg_count);
 		in_validity = (uint64_t **)duckdb_malloc(sizeof(uint64_t *) * (size_t)ctx->arg_count);
@@ -5398,6 +6799,37 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 					goto cleanup;
 				}
 				memset((void *)batch_out_array, 0, sizeof(ducktinycc_array_t) * (size_t)n);
+			} else if (ctx->predicate_mask) {
+				predicate_words = (uint64_t *)duckdb_malloc(sizeof(uint64_t) * (size_t)((n + 63) / 64 + 1));
+				if (!predicate_words) {
+					error = "ducktinycc out of memory";
+					goto cleanup;
+				}
+				memset(predicate_words, 0, sizeof(uint64_t) * (size_t)((n + 63) / 64 + 1));
+			} else if (ctx->columnar_return) {
+				/* chunk_columnar: hand the kernel the output STRUCT's child vectors; nothing to write back. */
+				idx_t field_count = return_desc->as.struct_like.count;
+				idx_t f;
+				columnar_ptrs = (void **)duckdb_malloc(sizeof(void *) * (size_t)field_count);
+				columnar_validity = (uint64_t **)duckdb_malloc(sizeof(uint64_t *) * (size_t)field_count);
+				if (!columnar_ptrs || !columnar_validity) {
+					error = "ducktinycc out of memory";
+					goto cleanup;
+				}
+				for (f = 0; f < field_count; f++) {
+					duckdb_vector child = duckdb_struct_vector_get_child(output, f);
+					if (!child) {
+						error = "ducktinycc missing struct output child vector";
+						goto cleanup;
+					}
+					duckdb_vector_ensure_validity_writable(child);
+					columnar_ptrs[f] = duckdb_vector_get_data(child);
+					columnar_validity[f] = duckdb_vector_get_validity(child);
+					tcc_validity_set_all(columnar_validity[f], n, true);
+				}
+				columnar_out.field_ptrs = columnar_ptrs;
+				columnar_out.field_validity = columnar_validity;
+				columnar_out.field_count = (uint64_t)field_count;
 			} else if (tcc_ffi_type_is_struct(ctx->return_type) && n > 0) {
 				batch_out_struct = (ducktinycc_struct_t *)duckdb_malloc(sizeof(ducktinycc_struct_t) * (size_t)n);
 				if (!batch_out_struct) {
@@ -5430,6 +6862,10 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 					batch_out_ptr = (void *)batch_out_list;
 				} else if (tcc_ffi_type_is_array(ctx->return_type)) {
 					batch_out_ptr = (void *)batch_out_array;
+				} else if (ctx->predicate_mask) {
+					batch_out_ptr = (void *)predicate_words;
+				} else if (ctx->columnar_return) {
+					batch_out_ptr = (void *)&columnar_out;
 				} else if (tcc_ffi_type_is_struct(ctx->return_type)) {
 					batch_out_ptr = (void *)batch_out_struct;
 				} else if (tcc_ffi_type_is_map(ctx->return_type)) {
@@ -5437,7 +6873,11 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 				} else if (tcc_ffi_type_is_union(ctx->return_type)) {
 					batch_out_ptr = (void *)batch_out_union;
 				}
-				if (!ctx->batch_wrapper(batch_arg_data, in_validity, (uint64_t)n, batch_out_ptr, out_validity)) {
+				TCC_EXEC_SPLIT_LAP(split, pending, t_mark);
+				invoked = ctx->batch_wrapper(batch_arg_data, in_validity, (uint64_t)n, batch_out_ptr, out_validity);
+				TCC_EXEC_SPLIT_LAP(split, TCC_EXEC_PHASE_CALL, t_mark);
+				pending = TCC_EXEC_PHASE_WRITEBACK;
+				if (!invoked) {
 					error = "ducktinycc invoke failed";
 					goto cleanup;
 				}
@@ -5466,6 +6906,18 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 					duckdb_vector_assign_string_element_len(output, row, (const char *)batch_out_blob[row].ptr,
 					                                        (idx_t)batch_out_blob[row].len);
 				}
+				} else if (ctx->predicate_mask) {
+					tcc_predicate_expand(predicate_words, n, out_data, out_validity,
+					                     (const uint64_t *const *)in_validity, ctx->arg_count);
+				} else if (ctx->columnar_return) {
+					/* A NULL struct row must read as NULL through its fields too. */
+					idx_t w;
+					uint64_t f;
+					for (w = 0; w < (n + 63) / 64; w++) {
+						for (f = 0; f < columnar_out.field_count; f++) {
+							columnar_validity[f][w] &= out_validity[w];
+						}
+					}
 				} else if (tcc_typedesc_is_composite(return_desc)) {
 					for (row = 0; row < n; row++) {
 						if (!duckdb_validity_row_is_valid(out_validity, row)) {
@@ -5483,6 +6935,8 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 		bool valid = true;
 		bool out_is_null = false;
 		const void *row_result_base = (const void *)out_value;
+		TCC_EXEC_SPLIT_LAP(split, pending, t_mark);
+		pending = TCC_EXEC_PHASE_MARSHAL;
 		for (col = 0; col < ctx->arg_count; col++) {
 			if (in_validity[col] && !duckdb_validity_row_is_valid(in_validity[col], row)) {
 				valid = false;
@@ -5577,7 +7031,11 @@ static void tcc_execute_compiled_scalar_udf(duckdb_function_info info, duckdb_da
 					row_out_ptr = (void *)&out_union_value;
 				}
 				row_result_base = row_out_ptr;
-				if (!ctx->row_wrapper(arg_ptrs, row_out_ptr, &out_is_null)) {
+				TCC_EXEC_SPLIT_LAP(split, pending, t_mark);
+				invoked = ctx->row_wrapper(arg_ptrs, row_out_ptr, &out_is_null);
+				TCC_EXEC_SPLIT_LAP(split, TCC_EXEC_PHASE_CALL, t_mark);
+				pending = TCC_EXEC_PHASE_WRITEBACK;
+				if (!invoked) {
 					error = "ducktinycc invoke failed";
 					goto cleanup;
 				}
@@ -5665,6 +7123,15 @@ cleanup:
 	if (batch_out_struct) {
 		duckdb_free((void *)batch_out_struct);
 	}
+	if (columnar_ptrs) {
+		duckdb_free((void *)columnar_ptrs);
+	}
+	if (predicate_words) {
+		duckdb_free((void *)predicate_words);
+	}
+	if (columnar_validity) {
+		duckdb_free((void *)columnar_validity);
+	}
 	if (batch_out_map) {
 		duckdb_free((void *)batch_out_map);
 	}
@@ -5709,1686 +7176,3467 @@ cleanup:
 		}
 		duckdb_free((void *)arg_value_bridges);
 	}
+	/* Writeback is done: every ducktinycc_out_alloc payload of this chunk goes at once. */
+	tcc_current_out_arena = prev_out_arena;
+	tcc_out_arena_reset(&out_arena);
+	TCC_EXEC_SPLIT_LAP(split, pending, t_mark);
 	if (error) {
-		duckdb_scalar_function_set_error(info, error);
+		*out_error = error;
+		return false;
 	}
+	return true;
 }
 
-/**
- * @function ducktinycc_register_signature
- * @brief Register one generated wrapper symbol as a DuckDB scalar UDF.
- * @param[in] con Borrowed DuckDB connection.
- * @param[in] name SQL function name.
- * @param[in] fn_ptr Wrapper function pointer.
- * @param[in] return_type Canonical return token string.
- * @param[in] arg_types_csv Canonical argument token CSV.
- * @param[in] wrapper_mode "row" or "chunk_scalar_loop".
- * @return true on successful registration.
- * @ownership borrows(con,name,fn_ptr,return_type,arg_types_csv,wrapper_mode)
- * @heap allocates parsed signature/type metadata and function objects; ownership moves to ctx on success
- * @stack fixed-size locals only
- * @thread_safety registration-time only; runtime safety handled by DuckDB + immutable ctx
- * @locks none
- * @errors reports failure via boolean return (caller maps to SQL diagnostics)
- */
-static bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr,
-                                          const char *return_type, const char *arg_types_csv,
-                                          const char *wrapper_mode, const char *stability) {
-	duckdb_scalar_function fn = NULL;
-	tcc_host_sig_ctx_t *ctx = NULL;
-	duckdb_state rc;
-	tcc_ffi_type_t ret_type = TCC_FFI_I64;
-	size_t ret_array_size = 0;
-	tcc_ffi_type_t *arg_types = NULL;
-	size_t *arg_array_sizes = NULL;
-	tcc_ffi_struct_meta_t ret_struct_meta;
-	tcc_ffi_map_meta_t ret_map_meta;
-	tcc_ffi_union_meta_t ret_union_meta;
-	tcc_ffi_struct_meta_t *arg_struct_metas = NULL;
-	tcc_ffi_map_meta_t *arg_map_metas = NULL;
-	tcc_ffi_union_meta_t *arg_union_metas = NULL;
-	tcc_wrapper_mode_t mode = TCC_WRAPPER_MODE_ROW;
-	tcc_function_stability_t function_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
-	int arg_count = 0;
-	tcc_error_buffer_t err;
-	tcc_typedesc_t *return_desc = NULL;
-	tcc_typedesc_t **arg_descs = NULL;
-	tcc_string_list_t arg_tokens;
-	int i;
-	memset(&err, 0, sizeof(err));
-	memset(&arg_tokens, 0, sizeof(arg_tokens));
-	memset(&ret_struct_meta, 0, sizeof(ret_struct_meta));
-	memset(&ret_map_meta, 0, sizeof(ret_map_meta));
-	memset(&ret_union_meta, 0, sizeof(ret_union_meta));
-	if (!con || !name || name[0] == '\0' || !fn_ptr) {
-		return false;
+/* ===== Section: Process Isolation ===== */
+#ifdef TCC_ISOLATION_SUPPORTED
+/* Upper bounds for one isolated UDF: argument columns (one validity-flag bit each) and pool size. */
+#define TCC_ISOLATION_MAX_ARGS 64
+#define TCC_ISOLATION_MAX_WORKERS 64
+/* Pool size for plain `isolation := 'process'`: online CPUs, capped here. */
+#define TCC_ISOLATION_DEFAULT_WORKERS 8
+/* How long one chunk may run on a worker before it is killed and the query fails; `timeout_ms=T` overrides. */
+#define TCC_ISOLATION_DEFAULT_TIMEOUT_MS 60000
+#define TCC_ISOLATION_MAX_TIMEOUT_MS 86400000L
+
+/* Header at the start of every shared chunk slot; argument and result columns follow at pool offsets. */
+typedef struct {
+	uint64_t count;            /* rows in the chunk */
+	uint64_t arg_has_validity; /* bit i set: argument i carries a validity mask (else all rows valid) */
+} tcc_isolation_slot_header_t;
+
+/* One forked worker: the parent end of its control socket and its MAP_SHARED chunk slot. */
+typedef struct {
+	atomic_int busy; /* 1 while an executing thread leases this worker */
+	pid_t pid;       /* -1 when not running (not started yet, crashed, or reaped) */
+	int fd;
+	uint8_t *slot;
+} tcc_isolation_worker_t;
+
+/* Worker pool of one isolated UDF. Owned by its signature ctx; workers inherit the relocated module by fork. */
+struct tcc_isolation_pool {
+	int worker_count;
+	int timeout_ms; /* per-chunk deadline of a worker round trip */
+	idx_t capacity; /* rows per slot (DuckDB vector size) */
+	size_t slot_size;
+	size_t ret_size;
+	size_t arg_validity_offsets[TCC_ISOLATION_MAX_ARGS];
+	size_t arg_data_offsets[TCC_ISOLATION_MAX_ARGS];
+	size_t out_validity_offset;
+	size_t out_data_offset;
+	atomic_uint next;
+	tcc_isolation_worker_t workers[TCC_ISOLATION_MAX_WORKERS];
+};
+
+/* tcc_parse_isolation: maps the `isolation` parameter to a worker count (0 = in-process) and a per-chunk timeout. */
+static bool tcc_parse_isolation(const char *text, int *out_workers, int *out_timeout_ms,
+                                tcc_error_buffer_t *error_buf) {
+	const char *p;
+	char *end = NULL;
+	long workers;
+	long timeout_ms;
+	*out_workers = 0;
+	*out_timeout_ms = TCC_ISOLATION_DEFAULT_TIMEOUT_MS;
+	if (!text || text[0] == '\0' || strcmp(text, "inprocess") == 0) {
+		return true;
 	}
-	if (!tcc_parse_signature(return_type, arg_types_csv, &ret_type, &ret_array_size, &arg_types, &arg_array_sizes,
-	                         &ret_struct_meta, &ret_map_meta, &ret_union_meta, &arg_struct_metas, &arg_map_metas,
-	                         &arg_union_metas, &arg_count, &err)) {
-		return false;
+	if (strncmp(text, "process", 7) != 0) {
+		goto bad;
 	}
-	if (!tcc_parse_wrapper_mode(wrapper_mode, &mode, &err)) {
-		goto fail;
+	p = text + 7;
+	if (*p == ':') {
+		errno = 0;
+		workers = strtol(p + 1, &end, 10);
+		if (errno != 0 || end == p + 1 || workers < 1 || workers > TCC_ISOLATION_MAX_WORKERS) {
+			goto bad;
+		}
+		p = end;
+	} else {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		workers = cpus < 1 ? 1 : (cpus > TCC_ISOLATION_DEFAULT_WORKERS ? TCC_ISOLATION_DEFAULT_WORKERS : cpus);
 	}
-	if (!tcc_parse_function_stability(stability, &function_stability, &err)) {
-		goto fail;
+	if (strncmp(p, ",timeout_ms=", 12) == 0) {
+		errno = 0;
+		timeout_ms = strtol(p + 12, &end, 10);
+		if (errno != 0 || end == p + 12 || timeout_ms < 1 || timeout_ms > TCC_ISOLATION_MAX_TIMEOUT_MS) {
+			goto bad;
+		}
+		*out_timeout_ms = (int)timeout_ms;
+		p = end;
 	}
-	if (!tcc_typedesc_parse_token(return_type, true, &return_desc, &err)) {
-		goto fail;
+	if (*p != '\0') {
+		goto bad;
 	}
-	if (!tcc_split_csv_tokens(arg_types_csv, &arg_tokens, &err)) {
-		goto fail;
+	*out_workers = (int)workers;
+	return true;
+
+bad:
+	tcc_set_error(error_buf, "isolation must be 'inprocess', 'process' or 'process:N' with N in 1..64, optionally "
+	                         "followed by ',timeout_ms=T'");
+	return false;
+}
+
+/* tcc_isolation_run_slot: worker side of one chunk; runs the wrapper over the slot columns in place. Returns the
+ * wrapper's verdict (false = "invoke failed"). */
+static bool tcc_isolation_run_slot(const tcc_host_sig_ctx_t *ctx, const tcc_isolation_pool_t *pool, uint8_t *slot) {
+	const tcc_isolation_slot_header_t *hdr = (const tcc_isolation_slot_header_t *)slot;
+	void *arg_data[TCC_ISOLATION_MAX_ARGS];
+	uint64_t *arg_validity[TCC_ISOLATION_MAX_ARGS];
+	void *arg_ptrs[TCC_ISOLATION_MAX_ARGS];
+	uint64_t *out_validity = (uint64_t *)(slot + pool->out_validity_offset);
+	uint8_t *out_data = slot + pool->out_data_offset;
+	uint64_t n = hdr->count;
+	uint64_t row;
+	int col;
+	for (col = 0; col < ctx->arg_count; col++) {
+		arg_data[col] = slot + pool->arg_data_offsets[col];
+		arg_validity[col] =
+		    (hdr->arg_has_validity >> col) & 1 ? (uint64_t *)(slot + pool->arg_validity_offsets[col]) : NULL;
 	}
-	if ((int)arg_tokens.count != arg_count) {
-		goto fail;
+	tcc_validity_set_all(out_validity, (idx_t)n, true);
+	if (ctx->wrapper_mode == TCC_WRAPPER_MODE_BATCH) {
+		return ctx->batch_wrapper(arg_data, arg_validity, n, out_data, out_validity);
 	}
-	if (arg_count > 0) {
-		arg_descs = (tcc_typedesc_t **)duckdb_malloc(sizeof(tcc_typedesc_t *) * (size_t)arg_count);
-		if (!arg_descs) {
-			goto fail;
-		}
-		memset(arg_descs, 0, sizeof(tcc_typedesc_t *) * (size_t)arg_count);
-		for (i = 0; i < arg_count; i++) {
-			if (!tcc_typedesc_parse_token(arg_tokens.items[i], false, &arg_descs[i], &err)) {
-				goto fail;
+	for (row = 0; row < n; row++) {
+		uint8_t out_value[64];
+		bool out_is_null = false;
+		bool valid = true;
+		for (col = 0; col < ctx->arg_count; col++) {
+			if (arg_validity[col] && !((arg_validity[col][row >> 6] >> (row & 63)) & 1)) {
+				valid = false;
+				break;
 			}
+			arg_ptrs[col] = (uint8_t *)arg_data[col] + (size_t)row * ctx->arg_sizes[col];
+		}
+		if (!valid) {
+			out_validity[row >> 6] &= ~(UINT64_C(1) << (row & 63));
+			continue;
+		}
+		if (!ctx->row_wrapper(arg_ptrs, out_value, &out_is_null)) {
+			return false;
+		}
+		if (out_is_null) {
+			out_validity[row >> 6] &= ~(UINT64_C(1) << (row & 63));
+			continue;
+		}
+		if (pool->ret_size > 0) {
+			memcpy(out_data + (size_t)row * pool->ret_size, out_value, pool->ret_size);
 		}
 	}
-	tcc_string_list_destroy(&arg_tokens);
+	return true;
+}
 
-	fn = duckdb_create_scalar_function();
-	if (!fn) {
-		goto fail;
+/* tcc_isolation_worker_main: forked worker loop. Only touches its slot, its socket and the generated code; never
+ * returns (exits when the parent closes the socket or exits). */
+static void tcc_isolation_worker_main(const tcc_host_sig_ctx_t *ctx, const tcc_isolation_pool_t *pool, uint8_t *slot,
+                                      int fd) {
+	/* The parent owns the lifetime: Ctrl-C goes to the query, not to the worker. */
+	signal(SIGINT, SIG_IGN);
+#if defined(__linux__) && defined(SYS_close_range)
+	/* Drop inherited descriptors (database files, other workers' sockets) so a worker only holds its own. */
+	if (fd > 3) {
+		(void)syscall(SYS_close_range, 3U, (unsigned)fd - 1U, 0U);
+	}
+	(void)syscall(SYS_close_range, (unsigned)fd + 1U, ~0U, 0U);
+#endif
+	for (;;) {
+		uint8_t byte;
+		ssize_t r = recv(fd, &byte, 1, 0);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r != 1) {
+			_exit(0);
+		}
+		byte = tcc_isolation_run_slot(ctx, pool, slot) ? 1 : 0;
+		while (send(fd, &byte, 1, MSG_NOSIGNAL) < 0 && errno == EINTR) {
+		}
 	}
-	ctx = (tcc_host_sig_ctx_t *)duckdb_malloc(sizeof(tcc_host_sig_ctx_t));
-	if (!ctx) {
-		goto fail;
+}
+
+/* tcc_isolation_spawn: forks worker `index`. Called at registration and, after a crash, by the next executing
+ * thread that leases the slot. The child only runs generated code, so it must not depend on locks another
+ * thread held at fork time (avoid malloc-heavy code in isolated UDFs). */
+static bool tcc_isolation_spawn(const tcc_host_sig_ctx_t *ctx, tcc_isolation_pool_t *pool, int index) {
+	tcc_isolation_worker_t *w = &pool->workers[index];
+	int fds[2];
+	pid_t pid;
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+		return false;
 	}
-	memset(ctx, 0, sizeof(tcc_host_sig_ctx_t));
-	ctx->wrapper_mode = mode;
-	if (mode == TCC_WRAPPER_MODE_BATCH) {
-		ctx->batch_wrapper = (tcc_host_batch_wrapper_fn_t)fn_ptr;
-	} else {
-		ctx->row_wrapper = (tcc_host_row_wrapper_fn_t)fn_ptr;
+	pid = fork();
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return false;
 	}
-	ctx->arg_count = arg_count;
-	ctx->return_type = ret_type;
-	ctx->return_array_size = ret_array_size;
-	ctx->arg_types = arg_types;
-	ctx->arg_array_sizes = arg_array_sizes;
-	ctx->return_struct_meta = ret_struct_meta;
-	ctx->return_map_meta = ret_map_meta;
-	ctx->return_union_meta = ret_union_meta;
-	ctx->arg_struct_metas = arg_struct_metas;
-	ctx->arg_map_metas = arg_map_metas;
-	ctx->arg_union_metas = arg_union_metas;
-	ctx->return_desc = return_desc;
-	ctx->arg_descs = arg_descs;
-	arg_types = NULL;
-	arg_array_sizes = NULL;
-	return_desc = NULL;
-	arg_descs = NULL;
-	memset(&ret_struct_meta, 0, sizeof(ret_struct_meta));
-	memset(&ret_map_meta, 0, sizeof(ret_map_meta));
-	memset(&ret_union_meta, 0, sizeof(ret_union_meta));
-	arg_struct_metas = NULL;
-	arg_map_metas = NULL;
-	arg_union_metas = NULL;
-	if (ctx->arg_count > 0) {
-		ctx->arg_sizes = (size_t *)duckdb_malloc(sizeof(size_t) * (size_t)ctx->arg_count);
-		if (!ctx->arg_sizes) {
-			tcc_host_sig_ctx_destroy(ctx);
-			duckdb_destroy_scalar_function(&fn);
+	if (pid == 0) {
+		close(fds[0]);
+		tcc_isolation_worker_main(ctx, pool, w->slot, fds[1]);
+		_exit(0);
+	}
+	close(fds[1]);
+	w->fd = fds[0];
+	w->pid = pid;
+	return true;
+}
+
+/* tcc_isolation_retire: closes the control socket and kills/reaps the worker process if it is still ours. */
+static void tcc_isolation_retire(tcc_isolation_worker_t *w) {
+	if (w->fd >= 0) {
+		close(w->fd);
+		w->fd = -1;
+	}
+	if (w->pid > 0) {
+		kill(w->pid, SIGKILL);
+		while (waitpid(w->pid, NULL, 0) < 0 && errno == EINTR) {
+		}
+		w->pid = -1;
+	}
+}
+
+/* tcc_isolation_await: waits up to `timeout_ms` for the worker's status byte. Returns false if the worker died (EOF,
+ * or reaped/gone when polled) or the deadline passed before it answered; *out_timed_out tells the two apart. The
+ * caller retires the worker either way, which kills one that is still running. */
+static bool tcc_isolation_await(tcc_isolation_worker_t *w, int timeout_ms, uint8_t *out_status, bool *out_timed_out) {
+	uint64_t deadline = tcc_now_ns() + (uint64_t)timeout_ms * UINT64_C(1000000);
+	*out_timed_out = false;
+	for (;;) {
+		struct pollfd pfd;
+		uint64_t now = tcc_now_ns();
+		int wait_ms;
+		int rc;
+		if (now >= deadline) {
+			*out_timed_out = true;
 			return false;
 		}
-		for (i = 0; i < ctx->arg_count; i++) {
-			ctx->arg_sizes[i] = tcc_ffi_type_size(ctx->arg_types[i]);
-			if (ctx->arg_sizes[i] == 0) {
-				tcc_host_sig_ctx_destroy(ctx);
-				duckdb_destroy_scalar_function(&fn);
-				return false;
+		wait_ms = (int)((deadline - now + UINT64_C(999999)) / UINT64_C(1000000));
+		pfd.fd = w->fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		rc = poll(&pfd, 1, wait_ms < 100 ? wait_ms : 100);
+		if (rc > 0) {
+			ssize_t r = recv(w->fd, out_status, 1, 0);
+			if (r == 1) {
+				return true;
+			}
+			if (r < 0 && errno == EINTR) {
+				continue;
 			}
+			return false;
 		}
-	}
-
-	duckdb_scalar_function_set_name(fn, name);
-	for (i = 0; i < arg_count; i++) {
-		duckdb_logical_type arg_type = tcc_typedesc_create_logical_type(ctx->arg_descs ? ctx->arg_descs[i] : NULL);
-		if (!arg_type) {
-			tcc_host_sig_ctx_destroy(ctx);
-			duckdb_destroy_scalar_function(&fn);
+		if (rc < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
 			return false;
 		}
-		duckdb_scalar_function_add_parameter(fn, arg_type);
-		duckdb_destroy_logical_type(&arg_type);
-	}
-	{
-		duckdb_logical_type ret_type_obj = tcc_typedesc_create_logical_type(ctx->return_desc);
-		if (!ret_type_obj) {
-			tcc_host_sig_ctx_destroy(ctx);
-			duckdb_destroy_scalar_function(&fn);
+		/* A leaked copy of the socket can hide EOF; the process table cannot. */
+		if (waitpid(w->pid, NULL, WNOHANG) != 0) {
+			w->pid = -1;
 			return false;
 		}
-		duckdb_scalar_function_set_return_type(fn, ret_type_obj);
-		duckdb_destroy_logical_type(&ret_type_obj);
-	}
-	if (function_stability == TCC_FUNCTION_STABILITY_VOLATILE) {
-		duckdb_scalar_function_set_volatile(fn);
 	}
-	duckdb_scalar_function_set_function(fn, tcc_execute_compiled_scalar_udf);
-	duckdb_scalar_function_set_extra_info(fn, ctx, tcc_host_sig_ctx_destroy);
-	rc = duckdb_register_scalar_function(con, fn);
-	duckdb_destroy_scalar_function(&fn);
-	return rc == DuckDBSuccess;
+}
 
-fail:
-	tcc_string_list_destroy(&arg_tokens);
-	if (arg_descs) {
-		for (i = 0; i < arg_count; i++) {
-			if (arg_descs[i]) {
-				tcc_typedesc_destroy(arg_descs[i]);
-			}
+/* tcc_isolation_pool_destroy: stops every worker and unmaps the slots. Allocation/Lifetime: frees the pool. */
+static void tcc_isolation_pool_destroy(tcc_isolation_pool_t *pool) {
+	int i;
+	if (!pool) {
+		return;
+	}
+	for (i = 0; i < pool->worker_count; i++) {
+		tcc_isolation_retire(&pool->workers[i]);
+		if (pool->workers[i].slot) {
+			munmap(pool->workers[i].slot, pool->slot_size);
 		}
-		duckdb_free(arg_descs);
 	}
-	if (return_desc) {
-		tcc_typedesc_destroy(return_desc);
+	duckdb_free(pool);
+}
+
+/* tcc_isolation_size_align: rounds a slot offset up to a cache line. */
+static size_t tcc_isolation_size_align(size_t n) {
+	return (n + 63) & ~(size_t)63;
+}
+
+/**
+ * @function tcc_isolation_pool_create
+ * @brief Lays out the shared chunk slots of an isolated UDF and forks its workers.
+ * @param[in] ctx Fully initialized signature context (wrappers, argument sizes); workers run on their copy.
+ * @param[in] workers Pool size (1..TCC_ISOLATION_MAX_WORKERS).
+ * @param[in] timeout_ms Per-chunk deadline after which a worker is killed.
+ * @param[out] out_error Static reason when the signature cannot be isolated or workers cannot start.
+ * @return New pool, or NULL.
+ * @ownership borrows(ctx), transfers(return value to ctx->isolation)
+ * @heap one pool block; one MAP_SHARED slot per worker
+ * @thread_safety registration-time only (module-state write lock held)
+ * @locks none
+ * @errors row/chunk_scalar_loop wrappers over fixed-width, non-pointer types only (not predicate or
+ *         chunk_columnar): VARCHAR, BLOB, composite and `ptr` values reference parent memory a worker cannot see
+ */
+static tcc_isolation_pool_t *tcc_isolation_pool_create(const tcc_host_sig_ctx_t *ctx, int workers, int timeout_ms,
+                                                       const char **out_error) {
+	tcc_isolation_pool_t *pool;
+	size_t offset;
+	size_t page;
+	size_t validity_bytes;
+	idx_t capacity = duckdb_vector_size();
+	int i;
+	/* predicate and chunk_columnar are BATCH sub-modes whose output the parent must post-process, not copy. */
+	if ((ctx->wrapper_mode != TCC_WRAPPER_MODE_ROW && ctx->wrapper_mode != TCC_WRAPPER_MODE_BATCH) ||
+	    ctx->predicate_mask || ctx->columnar_return) {
+		*out_error = "isolation := 'process' supports wrapper_mode 'row' and 'chunk_scalar_loop'";
+		return NULL;
 	}
-	if (arg_types) {
-		duckdb_free(arg_types);
+	if (ctx->arg_count > TCC_ISOLATION_MAX_ARGS) {
+		*out_error = "isolation := 'process' supports at most 64 arguments";
+		return NULL;
 	}
-	if (arg_array_sizes) {
-		duckdb_free(arg_array_sizes);
+	for (i = 0; i < ctx->arg_count; i++) {
+		if (!tcc_ffi_type_is_fixed_width_scalar(ctx->arg_types[i]) || ctx->arg_types[i] == TCC_FFI_PTR) {
+			*out_error = "isolation := 'process' supports fixed-width scalar argument and return types only";
+			return NULL;
+		}
 	}
-	if (arg_struct_metas) {
-		tcc_struct_meta_array_destroy(arg_struct_metas, arg_count);
+	if (ctx->return_type != TCC_FFI_VOID &&
+	    (!tcc_ffi_type_is_fixed_width_scalar(ctx->return_type) || ctx->return_type == TCC_FFI_PTR)) {
+		*out_error = "isolation := 'process' supports fixed-width scalar argument and return types only";
+		return NULL;
 	}
-	if (arg_map_metas) {
-		tcc_map_meta_array_destroy(arg_map_metas, arg_count);
+	pool = (tcc_isolation_pool_t *)duckdb_malloc(sizeof(tcc_isolation_pool_t));
+	if (!pool) {
+		*out_error = "out of memory";
+		return NULL;
 	}
-	if (arg_union_metas) {
-		tcc_union_meta_array_destroy(arg_union_metas, arg_count);
+	memset(pool, 0, sizeof(tcc_isolation_pool_t));
+	pool->capacity = capacity;
+	pool->ret_size = ctx->return_type == TCC_FFI_VOID ? 0 : tcc_ffi_type_size(ctx->return_type);
+	validity_bytes = tcc_isolation_size_align(((size_t)capacity + 63) / 64 * sizeof(uint64_t));
+	offset = tcc_isolation_size_align(sizeof(tcc_isolation_slot_header_t));
+	for (i = 0; i < ctx->arg_count; i++) {
+		pool->arg_validity_offsets[i] = offset;
+		offset += validity_bytes;
+		pool->arg_data_offsets[i] = offset;
+		offset += tcc_isolation_size_align((size_t)capacity * ctx->arg_sizes[i]);
+	}
+	pool->out_validity_offset = offset;
+	offset += validity_bytes;
+	pool->out_data_offset = offset;
+	offset += tcc_isolation_size_align((size_t)capacity * pool->ret_size);
+	page = (size_t)sysconf(_SC_PAGESIZE);
+	pool->slot_size = (offset + page - 1) / page * page;
+	pool->worker_count = workers;
+	pool->timeout_ms = timeout_ms;
+	for (i = 0; i < workers; i++) {
+		pool->workers[i].pid = -1;
+		pool->workers[i].fd = -1;
+		pool->workers[i].slot = (uint8_t *)mmap(NULL, pool->slot_size, PROT_READ | PROT_WRITE,
+		                                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (pool->workers[i].slot == MAP_FAILED) {
+			pool->workers[i].slot = NULL;
+			tcc_isolation_pool_destroy(pool);
+			*out_error = "isolation := 'process' could not map a shared chunk slot";
+			return NULL;
+		}
 	}
-	tcc_struct_meta_destroy(&ret_struct_meta);
-	tcc_map_meta_destroy(&ret_map_meta);
-	tcc_union_meta_destroy(&ret_union_meta);
-	if (fn) {
-		duckdb_destroy_scalar_function(&fn);
+	for (i = 0; i < workers; i++) {
+		if (!tcc_isolation_spawn(ctx, pool, i)) {
+			tcc_isolation_pool_destroy(pool);
+			*out_error = "isolation := 'process' could not fork a worker";
+			return NULL;
+		}
 	}
-	return false;
+	return pool;
 }
 
-/* ducktinycc_valid_is_set: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_valid_is_set(const uint64_t *validity, uint64_t idx) {
-	if (!validity) {
-		return 1;
+/**
+ * @function tcc_isolation_execute_chunk
+ * @brief Runs one chunk of an isolated UDF on a leased worker.
+ * @param[in] ctx Signature context with a worker pool.
+ * @param[in] input Borrowed input chunk.
+ * @param[out] output Borrowed output vector to fill.
+ * @param[in,out] split Optional phase-time accumulator: copy-in is marshal, the worker round trip is call,
+ *                copy-out is writeback.
+ * @param[out] out_error Static error message when returning false.
+ * @return true when the chunk completed.
+ * @ownership borrows(ctx,input,output), transfers(none)
+ * @heap none (columns are copied into the worker's shared slot and back)
+ * @thread_safety each executing thread leases a distinct worker, so concurrent chunks run on different processes
+ * @locks per-worker lease flag (spins with sched_yield while every worker is busy)
+ * @errors a worker that dies mid-chunk, or runs past the pool's timeout_ms and is killed, fails only this query; it
+ *         is restarted by the next chunk that leases it
+ */
+static bool tcc_isolation_execute_chunk(tcc_host_sig_ctx_t *ctx, duckdb_data_chunk input, duckdb_vector output,
+                                        tcc_exec_split_t *split, const char **out_error) {
+	tcc_isolation_pool_t *pool = ctx->isolation;
+	tcc_isolation_worker_t *w = NULL;
+	tcc_isolation_slot_header_t *hdr;
+	idx_t n = duckdb_data_chunk_get_size(input);
+	size_t words = ((size_t)n + 63) / 64;
+	uint64_t t_mark = split ? tcc_now_ns() : 0;
+	uint64_t *out_validity;
+	uint8_t byte = 1;
+	bool timed_out = false;
+	unsigned start;
+	int col;
+	int i;
+	if (n > pool->capacity) {
+		*out_error = "ducktinycc chunk exceeds the isolated worker slot";
+		return false;
 	}
-	return (validity[idx >> 6] & (1ULL << (idx & 63))) != 0;
-}
-
-/* ducktinycc_valid_set: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static void ducktinycc_valid_set(uint64_t *validity, uint64_t idx, int valid) {
-	uint64_t bit;
-	if (!validity) {
-		return;
+	start = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+	while (!w) {
+		for (i = 0; i < pool->worker_count; i++) {
+			tcc_isolation_worker_t *cand = &pool->workers[(start + (unsigned)i) % (unsigned)pool->worker_count];
+			int expected = 0;
+			if (atomic_compare_exchange_strong_explicit(&cand->busy, &expected, 1, memory_order_acquire,
+			                                            memory_order_relaxed)) {
+				w = cand;
+				break;
+			}
+		}
+		if (!w) {
+			sched_yield();
+		}
 	}
-	bit = 1ULL << (idx & 63);
-	if (valid) {
-		validity[idx >> 6] |= bit;
+	if (w->pid <= 0) {
+		tcc_isolation_retire(w);
+		if (!tcc_isolation_spawn(ctx, pool, (int)(w - pool->workers))) {
+			atomic_store_explicit(&w->busy, 0, memory_order_release);
+			*out_error = "ducktinycc could not restart an isolated worker";
+			return false;
+		}
+	}
+	hdr = (tcc_isolation_slot_header_t *)w->slot;
+	hdr->count = (uint64_t)n;
+	hdr->arg_has_validity = 0;
+	for (col = 0; col < ctx->arg_count; col++) {
+		duckdb_vector v = duckdb_data_chunk_get_vector(input, (idx_t)col);
+		uint64_t *validity = duckdb_vector_get_validity(v);
+		memcpy(w->slot + pool->arg_data_offsets[col], duckdb_vector_get_data(v), (size_t)n * ctx->arg_sizes[col]);
+		if (validity) {
+			memcpy(w->slot + pool->arg_validity_offsets[col], validity, words * sizeof(uint64_t));
+			hdr->arg_has_validity |= UINT64_C(1) << col;
+		}
+	}
+	TCC_EXEC_SPLIT_LAP(split, TCC_EXEC_PHASE_MARSHAL, t_mark);
+	if (send(w->fd, &byte, 1, MSG_NOSIGNAL) != 1 || !tcc_isolation_await(w, pool->timeout_ms, &byte, &timed_out)) {
+		tcc_isolation_retire(w);
+		atomic_store_explicit(&w->busy, 0, memory_order_release);
+		*out_error = timed_out ? "ducktinycc isolated worker timed out and was killed"
+		                       : "ducktinycc isolated worker crashed while running the chunk";
+		return false;
+	}
+	TCC_EXEC_SPLIT_LAP(split, TCC_EXEC_PHASE_CALL, t_mark);
+	if (!byte) {
+		atomic_store_explicit(&w->busy, 0, memory_order_release);
+		*out_error = "ducktinycc invoke failed";
+		return false;
+	}
+	duckdb_vector_ensure_validity_writable(output);
+	out_validity = duckdb_vector_get_validity(output);
+	if (!out_validity) {
+		atomic_store_explicit(&w->busy, 0, memory_order_release);
+		*out_error = "ducktinycc output validity missing";
+		return false;
+	}
+	if (ctx->return_type == TCC_FFI_VOID) {
+		tcc_validity_set_all(out_validity, n, false);
 	} else {
-		validity[idx >> 6] &= ~bit;
+		memcpy(out_validity, w->slot + pool->out_validity_offset, words * sizeof(uint64_t));
+		memcpy(duckdb_vector_get_data(output), w->slot + pool->out_data_offset, (size_t)n * pool->ret_size);
 	}
+	atomic_store_explicit(&w->busy, 0, memory_order_release);
+	TCC_EXEC_SPLIT_LAP(split, TCC_EXEC_PHASE_WRITEBACK, t_mark);
+	return true;
 }
+#endif
 
-/* ducktinycc_span_contains: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_span_contains(uint64_t len, uint64_t idx) {
-	return idx < len;
-}
-
-static const void *ducktinycc_ptr_add(const void *base, uint64_t byte_offset) {
-	const uint8_t *p = (const uint8_t *)base;
-	if (!p) {
-		return NULL;
+/* tcc_execute_chunk: runs one chunk through the bridge matching ctx->wrapper_mode. Allocation/Lifetime: borrows
+ * all inputs; per-chunk scratch is released before returning. */
+static bool tcc_execute_chunk(tcc_host_sig_ctx_t *ctx, duckdb_data_chunk input, duckdb_vector output,
+                              tcc_exec_split_t *split, const char **out_error) {
+	tcc_host_sig_ctx_t rebuilt_ctx;
+	uintptr_t rebuilt;
+#ifdef TCC_ISOLATION_SUPPORTED
+	if (ctx->isolation) {
+		return tcc_isolation_execute_chunk(ctx, input, output, split, out_error);
 	}
-	return (const void *)(p + byte_offset);
-}
-
-static void *ducktinycc_ptr_add_mut(void *base, uint64_t byte_offset) {
-	uint8_t *p = (uint8_t *)base;
-	if (!p) {
-		return NULL;
+#endif
+	/* The original wrapper lives as long as the function, so only rebuilt code needs the reader count. */
+	if (atomic_load_explicit(&ctx->rebuilt_wrapper, memory_order_relaxed)) {
+		bool ok;
+		/* Count first, then read the slot: a rebuild that sees no readers knows later chunks get its wrapper. */
+		atomic_fetch_add_explicit(&ctx->rebuilt_readers, 1, memory_order_seq_cst);
+		rebuilt = atomic_load_explicit(&ctx->rebuilt_wrapper, memory_order_seq_cst);
+		/* A `source_file` rebuild replaced the code; the chunk runs on whichever wrapper was current at its start. */
+		memcpy(&rebuilt_ctx, ctx, sizeof(rebuilt_ctx));
+		if (ctx->wrapper_mode == TCC_WRAPPER_MODE_BATCH) {
+			rebuilt_ctx.batch_wrapper = (tcc_host_batch_wrapper_fn_t)rebuilt;
+		} else if (ctx->wrapper_mode == TCC_WRAPPER_MODE_ARROW) {
+			rebuilt_ctx.arrow_wrapper = (tcc_host_arrow_wrapper_fn_t)rebuilt;
+		} else {
+			rebuilt_ctx.row_wrapper = (tcc_host_row_wrapper_fn_t)rebuilt;
+		}
+		if (rebuilt_ctx.wrapper_mode == TCC_WRAPPER_MODE_ARROW) {
+			ok = tcc_execute_arrow_scalar_udf(&rebuilt_ctx, input, output, split, out_error);
+		} else {
+			ok = tcc_execute_compiled_scalar_udf(&rebuilt_ctx, input, output, split, out_error);
+		}
+		atomic_fetch_sub_explicit(&ctx->rebuilt_readers, 1, memory_order_release);
+		return ok;
 	}
-	return (void *)(p + byte_offset);
+	if (ctx->wrapper_mode == TCC_WRAPPER_MODE_ARROW) {
+		return tcc_execute_arrow_scalar_udf(ctx, input, output, split, out_error);
+	}
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (ctx->specialize) {
+		tcc_host_sig_ctx_t variant_ctx;
+		if (tcc_specialize_route(ctx, input, &variant_ctx)) {
+			return tcc_execute_compiled_scalar_udf(&variant_ctx, input, output, split, out_error);
+		}
+	}
+#endif
+	return tcc_execute_compiled_scalar_udf(ctx, input, output, split, out_error);
 }
 
-/* ducktinycc_span_fits: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_span_fits(uint64_t len, uint64_t offset, uint64_t width) {
-	if (offset > len) {
+/* ===== Section: Runtime Counters ===== */
+/* Next shard id handed to a thread on its first counted chunk. */
+static atomic_uint tcc_udf_stats_next_shard = 0;
+/* Shard id + 1 for the current thread (0 = not assigned yet). */
+static TCC_THREAD_LOCAL unsigned tcc_udf_stats_thread_shard = 0;
+
+/* tcc_now_ns: monotonic nanosecond clock for runtime counters and compile timings (wall clock on Windows). */
+static uint64_t tcc_now_ns(void) {
+	struct timespec ts;
+#if defined(_WIN32)
+	if (timespec_get(&ts, TIME_UTC) != TIME_UTC) {
 		return 0;
 	}
-	return width <= (len - offset);
+#else
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+		return 0;
+	}
+#endif
+	return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
 }
 
-static const void *ducktinycc_buf_ptr_at(const void *base, uint64_t len, uint64_t offset, uint64_t width) {
-	if (!base || !ducktinycc_span_fits(len, offset, width)) {
-		return NULL;
+/* tcc_popcount64: number of set bits in one validity word. */
+static unsigned tcc_popcount64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_popcountll(v);
+#else
+	unsigned c = 0;
+	while (v) {
+		v &= v - 1;
+		c++;
 	}
-	return ducktinycc_ptr_add(base, offset);
+	return c;
+#endif
 }
 
-static void *ducktinycc_buf_ptr_at_mut(void *base, uint64_t len, uint64_t offset, uint64_t width) {
-	if (!base || !ducktinycc_span_fits(len, offset, width)) {
-		return NULL;
+/* tcc_count_null_rows: counts rows in [0, n) where any of `masks` marks the row invalid (NULL masks are all-valid). */
+static uint64_t tcc_count_null_rows(uint64_t **masks, int mask_count, idx_t n) {
+	uint64_t nulls = 0;
+	idx_t words = (n + 63) / 64;
+	idx_t w;
+	int i;
+	bool any = false;
+	for (i = 0; i < mask_count; i++) {
+		any = any || masks[i] != NULL;
 	}
-	return ducktinycc_ptr_add_mut(base, offset);
-}
-
-/* ducktinycc_read_bytes: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_read_bytes(const void *base, uint64_t len, uint64_t offset, void *out, uint64_t width) {
-	const void *src;
-	if (!out && width > 0) {
-		return 0;
-	}
-	if (width == 0) {
-		return 1;
-	}
-	src = ducktinycc_buf_ptr_at(base, len, offset, width);
-	if (!src) {
-		return 0;
-	}
-	memcpy(out, src, (size_t)width);
-	return 1;
-}
-
-/* ducktinycc_write_bytes: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_write_bytes(void *base, uint64_t len, uint64_t offset, const void *in, uint64_t width) {
-	void *dst;
-	if (!in && width > 0) {
-		return 0;
-	}
-	if (width == 0) {
-		return 1;
-	}
-	dst = ducktinycc_buf_ptr_at_mut(base, len, offset, width);
-	if (!dst) {
-		return 0;
-	}
-	memcpy(dst, in, (size_t)width);
-	return 1;
-}
-
-#define DUCKTINYCC_DEFINE_BUF_RW(name, type)                                                                                \
-	static int ducktinycc_read_##name(const void *base, uint64_t len, uint64_t offset, type *out) {                     \
-		return ducktinycc_read_bytes(base, len, offset, out, (uint64_t)sizeof(type));                               \
-	}                                                                                                                      \
-	static int ducktinycc_write_##name(void *base, uint64_t len, uint64_t offset, type value) {                        \
-		return ducktinycc_write_bytes(base, len, offset, &value, (uint64_t)sizeof(type));                          \
-	}
-
-DUCKTINYCC_DEFINE_BUF_RW(i8, int8_t)
-DUCKTINYCC_DEFINE_BUF_RW(u8, uint8_t)
-DUCKTINYCC_DEFINE_BUF_RW(i16, int16_t)
-DUCKTINYCC_DEFINE_BUF_RW(u16, uint16_t)
-DUCKTINYCC_DEFINE_BUF_RW(i32, int32_t)
-DUCKTINYCC_DEFINE_BUF_RW(u32, uint32_t)
-DUCKTINYCC_DEFINE_BUF_RW(i64, int64_t)
-DUCKTINYCC_DEFINE_BUF_RW(u64, uint64_t)
-DUCKTINYCC_DEFINE_BUF_RW(f32, float)
-DUCKTINYCC_DEFINE_BUF_RW(f64, double)
-
-#undef DUCKTINYCC_DEFINE_BUF_RW
-
-/* ducktinycc_read_ptr: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_read_ptr(const void *base, uint64_t len, uint64_t offset, const void **out) {
-	uintptr_t tmp = 0;
-	if (!out) {
+	if (!any) {
 		return 0;
 	}
-	if (!ducktinycc_read_bytes(base, len, offset, &tmp, (uint64_t)sizeof(uintptr_t))) {
-		return 0;
+	for (w = 0; w < words; w++) {
+		uint64_t valid = ~UINT64_C(0);
+		idx_t bits = (w + 1) * 64 <= n ? 64 : n - w * 64;
+		for (i = 0; i < mask_count; i++) {
+			if (masks[i]) {
+				valid &= masks[i][w];
+			}
+		}
+		if (bits < 64) {
+			valid &= (UINT64_C(1) << bits) - 1;
+		}
+		nulls += bits - tcc_popcount64(valid);
 	}
-	*out = (const void *)tmp;
-	return 1;
-}
-
-/* ducktinycc_write_ptr: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_write_ptr(void *base, uint64_t len, uint64_t offset, const void *value) {
-	uintptr_t tmp = (uintptr_t)value;
-	return ducktinycc_write_bytes(base, len, offset, &tmp, (uint64_t)sizeof(uintptr_t));
+	return nulls;
 }
 
-/* ducktinycc_list_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_list_is_valid(const ducktinycc_list_t *list, uint64_t idx) {
-	uint64_t global_idx;
-	if (!list || idx >= list->len) {
-		return 0;
+/* tcc_udf_stats_destroy: releases one counter block. Allocation/Lifetime: frees the sql_name copy and the block. */
+static void tcc_udf_stats_destroy(tcc_udf_stats_t *stats) {
+	if (!stats) {
+		return;
 	}
-	if (!list->validity) {
-		return 1;
+	if (stats->sql_name) {
+		duckdb_free(stats->sql_name);
 	}
-	global_idx = list->offset + idx;
-	return ducktinycc_valid_is_set(list->validity, global_idx);
+	duckdb_free(stats);
 }
 
-static const void *ducktinycc_list_elem_ptr(const ducktinycc_list_t *list, uint64_t idx, uint64_t elem_size) {
-	uint64_t global_idx;
-	if (!list || !list->ptr || idx >= list->len || elem_size == 0) {
+/* tcc_udf_stats_attach: allocates counters for one UDF and appends them to the artifact whose module_init is
+ * running on this thread. Allocation/Lifetime: the artifact owns the block; returns NULL (counting disabled)
+ * outside module_init or on OOM. */
+static tcc_udf_stats_t *tcc_udf_stats_attach(const char *sql_name, tcc_wrapper_mode_t wrapper_mode,
+                                             tcc_function_stability_t stability) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	(void)sql_name;
+	(void)wrapper_mode;
+	(void)stability;
+	return NULL;
+#else
+	tcc_registered_artifact_t *artifact = tcc_registering_artifact;
+	tcc_udf_stats_t *stats;
+	if (!artifact) {
 		return NULL;
 	}
-	global_idx = list->offset + idx;
-	return ducktinycc_ptr_add(list->ptr, global_idx * elem_size);
-}
-
-/* ducktinycc_array_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_array_is_valid(const ducktinycc_array_t *arr, uint64_t idx) {
-	uint64_t global_idx;
-	if (!arr || idx >= arr->len) {
-		return 0;
-	}
-	if (!arr->validity) {
-		return 1;
+	if (artifact->udf_stats_count == artifact->udf_stats_capacity) {
+		idx_t new_capacity = artifact->udf_stats_capacity == 0 ? 2 : artifact->udf_stats_capacity * 2;
+		tcc_udf_stats_t **grown = (tcc_udf_stats_t **)duckdb_malloc(sizeof(tcc_udf_stats_t *) * (size_t)new_capacity);
+		if (!grown) {
+			return NULL;
+		}
+		if (artifact->udf_stats) {
+			memcpy(grown, artifact->udf_stats, sizeof(tcc_udf_stats_t *) * (size_t)artifact->udf_stats_count);
+			duckdb_free((void *)artifact->udf_stats);
+		}
+		artifact->udf_stats = grown;
+		artifact->udf_stats_capacity = new_capacity;
 	}
-	global_idx = arr->offset + idx;
-	return ducktinycc_valid_is_set(arr->validity, global_idx);
-}
-
-static const void *ducktinycc_array_elem_ptr(const ducktinycc_array_t *arr, uint64_t idx, uint64_t elem_size) {
-	uint64_t global_idx;
-	if (!arr || !arr->ptr || idx >= arr->len || elem_size == 0) {
+	stats = (tcc_udf_stats_t *)duckdb_malloc(sizeof(tcc_udf_stats_t));
+	if (!stats) {
 		return NULL;
 	}
-	global_idx = arr->offset + idx;
-	return ducktinycc_ptr_add(arr->ptr, global_idx * elem_size);
-}
-
-static const void *ducktinycc_struct_field_ptr(const ducktinycc_struct_t *st, uint64_t idx) {
-	if (!st || !st->field_ptrs || idx >= st->field_count) {
+	memset(stats, 0, sizeof(tcc_udf_stats_t));
+	stats->sql_name = tcc_strdup(sql_name);
+	if (!stats->sql_name) {
+		duckdb_free(stats);
 		return NULL;
 	}
-	return st->field_ptrs[idx];
+	stats->wrapper_mode = wrapper_mode;
+	stats->stability = stability;
+	artifact->udf_stats[artifact->udf_stats_count++] = stats;
+	return stats;
+#endif
 }
 
-/* ducktinycc_struct_field_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_struct_field_is_valid(const ducktinycc_struct_t *st, uint64_t field_idx) {
-	if (!st || !st->field_ptrs || field_idx >= st->field_count) {
-		return 0;
-	}
-	if (!st->field_validity || !st->field_validity[field_idx]) {
-		return 1;
+/* tcc_udf_stats_snapshot: sums all shards of one counter block into `out` (relaxed reads; totals may trail
+ * in-flight chunks). */
+static void tcc_udf_stats_snapshot(const tcc_udf_stats_t *stats, uint64_t out[6]) {
+	int i;
+	memset(out, 0, sizeof(uint64_t) * 6);
+	if (!stats) {
+		return;
 	}
-	return ducktinycc_valid_is_set(st->field_validity[field_idx], st->offset);
-}
-
-static const void *ducktinycc_map_key_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t key_size) {
-	uint64_t global_idx;
-	if (!m || !m->key_ptr || idx >= m->len || key_size == 0) {
-		return NULL;
+	for (i = 0; i < TCC_UDF_STATS_SHARDS; i++) {
+		const tcc_udf_stats_shard_t *sh = &stats->shards[i];
+		out[0] += atomic_load_explicit(&sh->chunks, memory_order_relaxed);
+		out[1] += atomic_load_explicit(&sh->rows, memory_order_relaxed);
+		out[2] += atomic_load_explicit(&sh->null_in_rows, memory_order_relaxed);
+		out[3] += atomic_load_explicit(&sh->null_out_rows, memory_order_relaxed);
+		out[4] += atomic_load_explicit(&sh->errors, memory_order_relaxed);
+		out[5] += atomic_load_explicit(&sh->total_ns, memory_order_relaxed);
 	}
-	global_idx = m->offset + idx;
-	return ducktinycc_ptr_add(m->key_ptr, global_idx * key_size);
 }
 
-static const void *ducktinycc_map_value_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t value_size) {
-	uint64_t global_idx;
-	if (!m || !m->value_ptr || idx >= m->len || value_size == 0) {
-		return NULL;
+/**
+ * @function tcc_execute_scalar_udf
+ * @brief DuckDB entry point for every generated UDF: runs the mode-specific bridge and updates runtime counters.
+ * @param[in] info DuckDB function invocation info.
+ * @param[in] input Borrowed input chunk.
+ * @param[out] output Borrowed output vector to fill.
+ * @ownership borrows(info,input,output), transfers(none)
+ * @heap none beyond the dispatched bridge
+ * @stack one validity-mask pointer per argument (bounded by a small fixed array, larger signatures skip
+ *        NULL-in counting)
+ * @thread_safety counters are relaxed atomics in a per-thread shard, so concurrent chunks never contend on
+ *                the same cache line unless more than TCC_UDF_STATS_SHARDS threads run the same UDF
+ * @locks none
+ * @errors delegated to the dispatched bridge; failed chunks increment `errors`
+ */
+static void tcc_execute_scalar_udf(duckdb_function_info info, duckdb_data_chunk input, duckdb_vector output) {
+	tcc_host_sig_ctx_t *ctx = (tcc_host_sig_ctx_t *)duckdb_scalar_function_get_extra_info(info);
+	tcc_udf_stats_shard_t *shard;
+	uint64_t *in_masks[16];
+	uint64_t *out_mask;
+	uint64_t t0;
+	uint64_t elapsed;
+	idx_t n;
+	bool ok;
+	int col;
+	const char *error = NULL;
+	if (!ctx) {
+		duckdb_scalar_function_set_error(info, "ducktinycc signature ctx missing");
+		return;
 	}
-	global_idx = m->offset + idx;
-	return ducktinycc_ptr_add(m->value_ptr, global_idx * value_size);
-}
-
-/* ducktinycc_map_key_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_map_key_is_valid(const ducktinycc_map_t *m, uint64_t idx) {
-	uint64_t global_idx;
-	if (!m || idx >= m->len) {
-		return 0;
+	if (!ctx->stats) {
+		if (!tcc_execute_chunk(ctx, input, output, NULL, &error)) {
+			duckdb_scalar_function_set_error(info, error);
+		}
+		return;
 	}
-	if (!m->key_validity) {
-		return 1;
+	t0 = tcc_now_ns();
+	ok = tcc_execute_chunk(ctx, input, output, NULL, &error);
+	elapsed = tcc_now_ns() - t0;
+	if (!ok) {
+		duckdb_scalar_function_set_error(info, error);
 	}
-	global_idx = m->offset + idx;
-	return ducktinycc_valid_is_set(m->key_validity, global_idx);
-}
-
-/* ducktinycc_map_value_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_map_value_is_valid(const ducktinycc_map_t *m, uint64_t idx) {
-	uint64_t global_idx;
-	if (!m || idx >= m->len) {
-		return 0;
+	if (tcc_udf_stats_thread_shard == 0) {
+		tcc_udf_stats_thread_shard =
+		    (atomic_fetch_add_explicit(&tcc_udf_stats_next_shard, 1, memory_order_relaxed) % TCC_UDF_STATS_SHARDS) + 1;
 	}
-	if (!m->value_validity) {
-		return 1;
+	shard = &ctx->stats->shards[tcc_udf_stats_thread_shard - 1];
+	n = duckdb_data_chunk_get_size(input);
+	atomic_fetch_add_explicit(&shard->chunks, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->rows, (uint64_t)n, memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->total_ns, elapsed, memory_order_relaxed);
+	if (!ok) {
+		atomic_fetch_add_explicit(&shard->errors, 1, memory_order_relaxed);
+		return;
 	}
-	global_idx = m->offset + idx;
-	return ducktinycc_valid_is_set(m->value_validity, global_idx);
-}
-
-/* ducktinycc_union_tag: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_union_tag(const ducktinycc_union_t *u) {
-	if (!u || !u->tag_ptr) {
-		return -1;
+	if (ctx->arg_count > 0 && ctx->arg_count <= (int)(sizeof(in_masks) / sizeof(in_masks[0]))) {
+		for (col = 0; col < ctx->arg_count; col++) {
+			in_masks[col] = duckdb_vector_get_validity(duckdb_data_chunk_get_vector(input, (idx_t)col));
+		}
+		atomic_fetch_add_explicit(&shard->null_in_rows, tcc_count_null_rows(in_masks, ctx->arg_count, n),
+		                          memory_order_relaxed);
 	}
-	return (int)u->tag_ptr[u->offset];
+	out_mask = duckdb_vector_get_validity(output);
+	atomic_fetch_add_explicit(&shard->null_out_rows, tcc_count_null_rows(&out_mask, 1, n), memory_order_relaxed);
 }
 
-/* ducktinycc_union_member_ptr: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static const void *ducktinycc_union_member_ptr(const ducktinycc_union_t *u, uint64_t member_idx) {
-	if (!u || !u->member_ptrs || member_idx >= u->member_count) {
-		return NULL;
+/* tcc_typedesc_apply_used: marks every top-level STRUCT argument field missing from `used_csv` as skipped, so the
+ * bridge never touches its child vector. Each name must be a field of at least one STRUCT argument. */
+static bool tcc_typedesc_apply_used(tcc_typedesc_t **arg_descs, int arg_count, const char *used_csv,
+                                    const char **out_error) {
+	tcc_string_list_t names;
+	tcc_error_buffer_t err;
+	bool ok = true;
+	idx_t n;
+	idx_t f;
+	int i;
+	memset(&names, 0, sizeof(names));
+	memset(&err, 0, sizeof(err));
+	if (!tcc_split_csv_tokens(used_csv, &names, &err)) {
+		*out_error = "used field list could not be parsed";
+		return false;
 	}
-	return u->member_ptrs[member_idx];
-}
-
-/* ducktinycc_union_member_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
-static int ducktinycc_union_member_is_valid(const ducktinycc_union_t *u, uint64_t member_idx) {
-	if (!u || !u->member_ptrs || member_idx >= u->member_count) {
-		return 0;
+	for (i = 0; i < arg_count; i++) {
+		tcc_typedesc_t *desc = arg_descs ? arg_descs[i] : NULL;
+		if (!desc || desc->kind != TCC_TYPEDESC_STRUCT) {
+			continue;
+		}
+		for (f = 0; f < desc->as.struct_like.count; f++) {
+			desc->as.struct_like.fields[f].skip = true;
+		}
 	}
-	if (!u->member_validity || !u->member_validity[member_idx]) {
-		return 1;
+	for (n = 0; n < names.count && ok; n++) {
+		bool found = false;
+		for (i = 0; i < arg_count; i++) {
+			tcc_typedesc_t *desc = arg_descs ? arg_descs[i] : NULL;
+			if (!desc || desc->kind != TCC_TYPEDESC_STRUCT) {
+				continue;
+			}
+			for (f = 0; f < desc->as.struct_like.count; f++) {
+				if (strcmp(desc->as.struct_like.fields[f].name, names.items[n]) == 0) {
+					desc->as.struct_like.fields[f].skip = false;
+					found = true;
+				}
+			}
+		}
+		if (!found) {
+			*out_error = "used field is not declared by any struct argument in arg_types";
+			ok = false;
+		}
 	}
-	return ducktinycc_valid_is_set(u->member_validity[member_idx], u->offset);
+	tcc_string_list_destroy(&names);
+	return ok;
 }
 
-#define TCC_HOST_SYMBOL_TABLE(X)                                                                                          \
-	X("duckdb_ext_api", &duckdb_ext_api)                                                                                 \
-	X("ducktinycc_register_signature", ducktinycc_register_signature)                                                    \
-	X("ducktinycc_valid_is_set", ducktinycc_valid_is_set)                                                                \
-	X("ducktinycc_valid_set", ducktinycc_valid_set)                                                                      \
-	X("ducktinycc_span_contains", ducktinycc_span_contains)                                                              \
-	X("ducktinycc_ptr_add", ducktinycc_ptr_add)                                                                          \
-	X("ducktinycc_ptr_add_mut", ducktinycc_ptr_add_mut)                                                                  \
-	X("ducktinycc_span_fits", ducktinycc_span_fits)                                                                      \
-	X("ducktinycc_buf_ptr_at", ducktinycc_buf_ptr_at)                                                                    \
-	X("ducktinycc_buf_ptr_at_mut", ducktinycc_buf_ptr_at_mut)                                                            \
-	X("ducktinycc_read_bytes", ducktinycc_read_bytes)                                                                    \
-	X("ducktinycc_write_bytes", ducktinycc_write_bytes)                                                                  \
-	X("ducktinycc_read_i8", ducktinycc_read_i8)                                                                          \
-	X("ducktinycc_write_i8", ducktinycc_write_i8)                                                                        \
-	X("ducktinycc_read_u8", ducktinycc_read_u8)                                                                          \
-	X("ducktinycc_write_u8", ducktinycc_write_u8)                                                                        \
-	X("ducktinycc_read_i16", ducktinycc_read_i16)                                                                        \
-	X("ducktinycc_write_i16", ducktinycc_write_i16)                                                                      \
-	X("ducktinycc_read_u16", ducktinycc_read_u16)                                                                        \
-	X("ducktinycc_write_u16", ducktinycc_write_u16)                                                                      \
-	X("ducktinycc_read_i32", ducktinycc_read_i32)                                                                        \
-	X("ducktinycc_write_i32", ducktinycc_write_i32)                                                                      \
-	X("ducktinycc_read_u32", ducktinycc_read_u32)                                                                        \
-	X("ducktinycc_write_u32", ducktinycc_write_u32)                                                                      \
-	X("ducktinycc_read_i64", ducktinycc_read_i64)                                                                        \
-	X("ducktinycc_write_i64", ducktinycc_write_i64)                                                                      \
-	X("ducktinycc_read_u64", ducktinycc_read_u64)                                                                        \
-	X("ducktinycc_write_u64", ducktinycc_write_u64)                                                                      \
-	X("ducktinycc_read_f32", ducktinycc_read_f32)                                                                        \
-	X("ducktinycc_write_f32", ducktinycc_write_f32)                                                                      \
-	X("ducktinycc_read_f64", ducktinycc_read_f64)                                                                        \
-	X("ducktinycc_write_f64", ducktinycc_write_f64)                                                                      \
-	X("ducktinycc_read_ptr", ducktinycc_read_ptr)                                                                        \
-	X("ducktinycc_write_ptr", ducktinycc_write_ptr)                                                                      \
-	X("ducktinycc_list_is_valid", ducktinycc_list_is_valid)                                                              \
-	X("ducktinycc_list_elem_ptr", ducktinycc_list_elem_ptr)                                                              \
-	X("ducktinycc_array_is_valid", ducktinycc_array_is_valid)                                                            \
-	X("ducktinycc_array_elem_ptr", ducktinycc_array_elem_ptr)                                                            \
-	X("ducktinycc_struct_field_ptr", ducktinycc_struct_field_ptr)                                                        \
-	X("ducktinycc_struct_field_is_valid", ducktinycc_struct_field_is_valid)                                              \
-	X("ducktinycc_map_key_ptr", ducktinycc_map_key_ptr)                                                                  \
-	X("ducktinycc_map_value_ptr", ducktinycc_map_value_ptr)                                                              \
-	X("ducktinycc_map_key_is_valid", ducktinycc_map_key_is_valid)                                                        \
-	X("ducktinycc_map_value_is_valid", ducktinycc_map_value_is_valid)                                                      \
-	X("ducktinycc_union_tag", ducktinycc_union_tag)                                                                        \
-	X("ducktinycc_union_member_ptr", ducktinycc_union_member_ptr)                                                          \
-	X("ducktinycc_union_member_is_valid", ducktinycc_union_member_is_valid)                                                \
-	X("duckdb_validity_row_is_valid", duckdb_validity_row_is_valid)
-
+/**
+ * @function ducktinycc_register_signature
+ * @brief Register one generated wrapper symbol as a DuckDB scalar UDF.
+ * @param[in] con Borrowed DuckDB connection.
+ * @param[in] name SQL function name.
+ * @param[in] fn_ptr Wrapper function pointer.
+ * @param[in] return_type Canonical return token string.
+ * @param[in] arg_types_csv Canonical argument token CSV.
+ * @param[in] wrapper_mode "row", "chunk_scalar_loop", or "arrow".
+ * @return true on successful registration.
+ * @ownership borrows(con,name,fn_ptr,return_type,arg_types_csv,wrapper_mode)
+ * @heap allocates parsed signature/type metadata and function objects; ownership moves to ctx on success
+ * @stack fixed-size locals only
+ * @thread_safety registration-time only; runtime safety handled by DuckDB + immutable ctx
+ * @locks none
+ * @errors reports failure via boolean return (caller maps to SQL diagnostics)
+ */
+static bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr,
+                                          const char *return_type, const char *arg_types_csv,
+                                          const char *wrapper_mode, const char *stability) {
+	duckdb_scalar_function fn = NULL;
+	tcc_host_sig_ctx_t *ctx = NULL;
+	tcc_udf_stats_t *stats = NULL;
+	duckdb_state rc;
+	tcc_ffi_type_t ret_type = TCC_FFI_I64;
+	size_t ret_array_size = 0;
+	tcc_ffi_type_t *arg_types = NULL;
+	size_t *arg_array_sizes = NULL;
+	tcc_ffi_struct_meta_t ret_struct_meta;
+	tcc_ffi_map_meta_t ret_map_meta;
+	tcc_ffi_union_meta_t ret_union_meta;
+	tcc_ffi_struct_meta_t *arg_struct_metas = NULL;
+	tcc_ffi_map_meta_t *arg_map_metas = NULL;
+	tcc_ffi_union_meta_t *arg_union_metas = NULL;
+	tcc_wrapper_mode_t mode = TCC_WRAPPER_MODE_ROW;
+	tcc_function_stability_t function_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+	int arg_count = 0;
+	tcc_error_buffer_t err;
+	tcc_typedesc_t *return_desc = NULL;
+	tcc_typedesc_t **arg_descs = NULL;
+	tcc_string_list_t arg_tokens;
+	int i;
+	memset(&err, 0, sizeof(err));
+	memset(&arg_tokens, 0, sizeof(arg_tokens));
+	memset(&ret_struct_meta, 0, sizeof(ret_struct_meta));
+	memset(&ret_map_meta, 0, sizeof(ret_map_meta));
+	memset(&ret_union_meta, 0, sizeof(ret_union_meta));
 #ifndef DUCKTINYCC_WASM_UNSUPPORTED
-/* tcc_add_host_symbols: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_add_host_symbols(TCCState *s) {
-	if (!s) {
-		return;
+	if (tcc_registering_capture) {
+		*tcc_registering_capture = fn_ptr;
+		return fn_ptr != NULL;
 	}
-#define TCC_ADD_HOST_SYMBOL(name, ptr) (void)tcc_add_symbol(s, name, ptr);
-	TCC_HOST_SYMBOL_TABLE(TCC_ADD_HOST_SYMBOL)
-#undef TCC_ADD_HOST_SYMBOL
-}
-#undef TCC_HOST_SYMBOL_TABLE
-
-/* tcc_artifact_destroy: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
-static void tcc_artifact_destroy(void *ptr) {
-	tcc_registered_artifact_t *artifact = (tcc_registered_artifact_t *)ptr;
-	if (!artifact) {
-		return;
+#endif
+	if (!con || !name || name[0] == '\0' || !fn_ptr) {
+		return false;
 	}
-	if (artifact->tcc) {
-		tcc_delete(artifact->tcc);
+	if (!tcc_parse_signature(return_type, arg_types_csv, &ret_type, &ret_array_size, &arg_types, &arg_array_sizes,
+	                         &ret_struct_meta, &ret_map_meta, &ret_union_meta, &arg_struct_metas, &arg_map_metas,
+	                         &arg_union_metas, &arg_count, &err)) {
+		return false;
 	}
-	if (artifact->sql_name) {
-		duckdb_free(artifact->sql_name);
+	if (!tcc_parse_wrapper_mode(wrapper_mode, &mode, &err)) {
+		goto fail;
 	}
-	if (artifact->symbol) {
-		duckdb_free(artifact->symbol);
+	if (tcc_wrapper_mode_is(wrapper_mode, "chunk_columnar") &&
+	    !tcc_columnar_return_supported(ret_type, &ret_struct_meta)) {
+		goto fail;
 	}
-	duckdb_free(artifact);
-}
-
-/* tcc_apply_session_to_state: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static int tcc_apply_session_to_state(TCCState *s, const tcc_session_t *session, tcc_error_buffer_t *error_buf) {
-	idx_t i;
-	for (i = 0; i < session->include_paths.count; i++) {
-		if (tcc_add_include_path(s, session->include_paths.items[i]) != 0) {
-			tcc_set_error(error_buf, "tcc_add_include_path failed");
-			return -1;
-		}
+	if (tcc_wrapper_mode_is(wrapper_mode, "predicate") &&
+	    !tcc_predicate_signature_supported(ret_type, arg_types, arg_count)) {
+		goto fail;
 	}
-	for (i = 0; i < session->sysinclude_paths.count; i++) {
-		if (tcc_add_sysinclude_path(s, session->sysinclude_paths.items[i]) != 0) {
-			tcc_set_error(error_buf, "tcc_add_sysinclude_path failed");
-			return -1;
-		}
+	if (!tcc_parse_function_stability(stability, &function_stability, &err)) {
+		goto fail;
 	}
-	for (i = 0; i < session->library_paths.count; i++) {
-		if (tcc_add_library_path(s, session->library_paths.items[i]) != 0) {
-			tcc_set_error(error_buf, "tcc_add_library_path failed");
-			return -1;
-		}
+	if (!tcc_typedesc_parse_token(return_type, true, &return_desc, &err)) {
+		goto fail;
 	}
-	for (i = 0; i < session->options.count; i++) {
-		tcc_set_options(s, session->options.items[i]);
+	if (!tcc_split_csv_tokens(arg_types_csv, &arg_tokens, &err)) {
+		goto fail;
 	}
-	for (i = 0; i < session->define_names.count; i++) {
-		tcc_define_symbol(s, session->define_names.items[i], session->define_values.items[i]);
+	if ((int)arg_tokens.count != arg_count) {
+		goto fail;
 	}
-	for (i = 0; i < session->headers.count; i++) {
-		if (tcc_compile_string(s, session->headers.items[i]) != 0) {
-			if (error_buf->message[0] == '\0') {
-				tcc_set_error(error_buf, "header compile failed");
-			}
-			return -1;
+	if (arg_count > 0) {
+		arg_descs = (tcc_typedesc_t **)duckdb_malloc(sizeof(tcc_typedesc_t *) * (size_t)arg_count);
+		if (!arg_descs) {
+			goto fail;
 		}
-	}
-	for (i = 0; i < session->sources.count; i++) {
-		if (tcc_compile_string(s, session->sources.items[i]) != 0) {
-			if (error_buf->message[0] == '\0') {
-				tcc_set_error(error_buf, "source compile failed");
+		memset(arg_descs, 0, sizeof(tcc_typedesc_t *) * (size_t)arg_count);
+		for (i = 0; i < arg_count; i++) {
+			if (!tcc_typedesc_parse_token(arg_tokens.items[i], false, &arg_descs[i], &err)) {
+				goto fail;
 			}
-			return -1;
 		}
 	}
-	for (i = 0; i < session->libraries.count; i++) {
-		if (tcc_add_library(s, session->libraries.items[i]) != 0) {
-			tcc_set_error(error_buf, "tcc_add_library failed");
-			return -1;
-		}
+	tcc_string_list_destroy(&arg_tokens);
+
+	fn = duckdb_create_scalar_function();
+	if (!fn) {
+		goto fail;
 	}
-	for (i = 0; i < session->symbol_names.count && i < session->symbol_count; i++) {
-		if (tcc_add_symbol(s, session->symbol_names.items[i], (void *)(uintptr_t)session->symbol_ptrs[i]) != 0) {
-			tcc_set_error(error_buf, "tcc_add_symbol failed for user symbol");
-			return -1;
-		}
+	ctx = (tcc_host_sig_ctx_t *)duckdb_malloc(sizeof(tcc_host_sig_ctx_t));
+	if (!ctx) {
+		goto fail;
 	}
-	return 0;
-}
-
-/* tcc_apply_bind_overrides_to_state: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static int tcc_apply_bind_overrides_to_state(TCCState *s, const tcc_module_bind_data_t *bind,
-                                             tcc_error_buffer_t *error_buf) {
-	const char *define_value;
-	if (!s || !bind) {
-		return 0;
+	memset(ctx, 0, sizeof(tcc_host_sig_ctx_t));
+	ctx->wrapper_mode = mode;
+	ctx->columnar_return = tcc_wrapper_mode_is(wrapper_mode, "chunk_columnar");
+	ctx->predicate_mask = tcc_wrapper_mode_is(wrapper_mode, "predicate");
+	if (mode == TCC_WRAPPER_MODE_BATCH) {
+		ctx->batch_wrapper = (tcc_host_batch_wrapper_fn_t)fn_ptr;
+	} else if (mode == TCC_WRAPPER_MODE_ARROW) {
+		ctx->arrow_wrapper = (tcc_host_arrow_wrapper_fn_t)fn_ptr;
+	} else {
+		ctx->row_wrapper = (tcc_host_row_wrapper_fn_t)fn_ptr;
 	}
-	if (bind->include_path && bind->include_path[0] != '\0') {
-		if (tcc_add_include_path(s, bind->include_path) != 0) {
-			tcc_set_error(error_buf, "tcc_add_include_path failed");
-			return -1;
+	ctx->arg_count = arg_count;
+	ctx->return_type = ret_type;
+	ctx->return_array_size = ret_array_size;
+	ctx->arg_types = arg_types;
+	ctx->arg_array_sizes = arg_array_sizes;
+	ctx->return_struct_meta = ret_struct_meta;
+	ctx->return_map_meta = ret_map_meta;
+	ctx->return_union_meta = ret_union_meta;
+	ctx->arg_struct_metas = arg_struct_metas;
+	ctx->arg_map_metas = arg_map_metas;
+	ctx->arg_union_metas = arg_union_metas;
+	ctx->return_desc = return_desc;
+	ctx->arg_descs = arg_descs;
+	arg_types = NULL;
+	arg_array_sizes = NULL;
+	return_desc = NULL;
+	arg_descs = NULL;
+	memset(&ret_struct_meta, 0, sizeof(ret_struct_meta));
+	memset(&ret_map_meta, 0, sizeof(ret_map_meta));
+	memset(&ret_union_meta, 0, sizeof(ret_union_meta));
+	arg_struct_metas = NULL;
+	arg_map_metas = NULL;
+	arg_union_metas = NULL;
+	if (ctx->arg_count > 0) {
+		ctx->arg_sizes = (size_t *)duckdb_malloc(sizeof(size_t) * (size_t)ctx->arg_count);
+		if (!ctx->arg_sizes) {
+			tcc_host_sig_ctx_destroy(ctx);
+			duckdb_destroy_scalar_function(&fn);
+			return false;
 		}
-	}
-	if (bind->sysinclude_path && bind->sysinclude_path[0] != '\0') {
-		if (tcc_add_sysinclude_path(s, bind->sysinclude_path) != 0) {
-			tcc_set_error(error_buf, "tcc_add_sysinclude_path failed");
-			return -1;
+		for (i = 0; i < ctx->arg_count; i++) {
+			ctx->arg_sizes[i] = tcc_ffi_type_size(ctx->arg_types[i]);
+			if (ctx->arg_sizes[i] == 0) {
+				tcc_host_sig_ctx_destroy(ctx);
+				duckdb_destroy_scalar_function(&fn);
+				return false;
+			}
 		}
 	}
-	if (bind->library_path && bind->library_path[0] != '\0') {
-		if (tcc_add_library_path(s, bind->library_path) != 0) {
-			tcc_set_error(error_buf, "tcc_add_library_path failed");
-			return -1;
-		}
+
+	if (mode == TCC_WRAPPER_MODE_ARROW &&
+	    (!tcc_arrow_format_for_type(ctx->return_type) || !tcc_arrow_schema_init(ctx))) {
+		tcc_host_sig_ctx_destroy(ctx);
+		duckdb_destroy_scalar_function(&fn);
+		return false;
 	}
-	if (bind->option && bind->option[0] != '\0') {
-		tcc_set_options(s, bind->option);
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (tcc_registering_used && tcc_registering_used[0] != '\0' &&
+	    !tcc_typedesc_apply_used(ctx->arg_descs, ctx->arg_count, tcc_registering_used, &tcc_registering_error)) {
+		tcc_host_sig_ctx_destroy(ctx);
+		duckdb_destroy_scalar_function(&fn);
+		return false;
 	}
-	if (bind->define_name && bind->define_name[0] != '\0') {
-		define_value = bind->define_value ? bind->define_value : "1";
-		tcc_define_symbol(s, bind->define_name, define_value);
+#endif
+#ifdef TCC_ISOLATION_SUPPORTED
+	if (tcc_registering_isolation_workers > 0) {
+		ctx->isolation = tcc_isolation_pool_create(ctx, tcc_registering_isolation_workers,
+		                                           tcc_registering_isolation_timeout_ms, &tcc_registering_error);
+		if (!ctx->isolation) {
+			tcc_host_sig_ctx_destroy(ctx);
+			duckdb_destroy_scalar_function(&fn);
+			return false;
+		}
 	}
-	if (bind->header && bind->header[0] != '\0') {
-		if (tcc_compile_string(s, bind->header) != 0) {
-			if (error_buf->message[0] == '\0') {
-				tcc_set_error(error_buf, "header compile failed");
-			}
-			return -1;
+#endif
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (tcc_registering_specialize) {
+		if (!tcc_specialize_attach(ctx, tcc_registering_specialize, &tcc_registering_error)) {
+			tcc_host_sig_ctx_destroy(ctx);
+			duckdb_destroy_scalar_function(&fn);
+			return false;
 		}
+		tcc_registering_specialize = NULL;
 	}
-	if (bind->library && bind->library[0] != '\0') {
-		if (tcc_add_library(s, bind->library) != 0) {
-			tcc_set_error(error_buf, "tcc_add_library failed");
-			return -1;
+#endif
+
+	duckdb_scalar_function_set_name(fn, name);
+	for (i = 0; i < arg_count; i++) {
+		duckdb_logical_type arg_type = tcc_typedesc_create_logical_type(ctx->arg_descs ? ctx->arg_descs[i] : NULL);
+		if (!arg_type) {
+			tcc_host_sig_ctx_destroy(ctx);
+			duckdb_destroy_scalar_function(&fn);
+			return false;
 		}
+		duckdb_scalar_function_add_parameter(fn, arg_type);
+		duckdb_destroy_logical_type(&arg_type);
 	}
-	return 0;
-}
-
-/* Builds and relocates one TinyCC module artifact, returning its init symbol wrapper. */
-static int tcc_build_module_artifact(const char *runtime_path, tcc_module_state_t *state,
-                                     const tcc_module_bind_data_t *bind, const char *module_symbol,
-                                     const char *module_name, tcc_registered_artifact_t **out_artifact,
-                                     tcc_error_buffer_t *error_buf) {
-	TCCState *s;
-	void *sym;
-	tcc_registered_artifact_t *artifact;
-	if (!module_symbol || module_symbol[0] == '\0') {
-		tcc_set_error(error_buf, "module symbol is required");
-		return -1;
+	{
+		duckdb_logical_type ret_type_obj = tcc_typedesc_create_logical_type(ctx->return_desc);
+		if (!ret_type_obj) {
+			tcc_host_sig_ctx_destroy(ctx);
+			duckdb_destroy_scalar_function(&fn);
+			return false;
+		}
+		duckdb_scalar_function_set_return_type(fn, ret_type_obj);
+		duckdb_destroy_logical_type(&ret_type_obj);
 	}
-	if (!module_name || module_name[0] == '\0') {
-		tcc_set_error(error_buf, "module name is required");
-		return -1;
+	if (function_stability == TCC_FUNCTION_STABILITY_VOLATILE) {
+		duckdb_scalar_function_set_volatile(fn);
 	}
-	if (state->session.sources.count == 0 && (!bind->source || bind->source[0] == '\0')) {
-		tcc_set_error(error_buf, "no source provided (use add_source/source)");
-		return -1;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (tcc_registering_special_nulls) {
+		duckdb_scalar_function_set_special_handling(fn);
+	}
+#endif
+	stats = tcc_udf_stats_attach(name, mode, function_stability);
+	ctx->stats = stats;
+	if (stats) {
+		stats->ctx = ctx;
+	}
+	duckdb_scalar_function_set_function(fn, tcc_execute_scalar_udf);
+	duckdb_scalar_function_set_extra_info(fn, ctx, tcc_host_sig_ctx_destroy);
+	{
+		uint64_t t0 = tcc_now_ns();
+		rc = duckdb_register_scalar_function(con, fn);
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+		if (tcc_registering_timings) {
+			tcc_registering_timings->register_ns += tcc_now_ns() - t0;
+		}
+#else
+		(void)t0;
+#endif
+	}
+	duckdb_destroy_scalar_function(&fn);
+	if (rc != DuckDBSuccess && stats) {
+		/* The ctx died with the unregistered function object. */
+		stats->ctx = NULL;
 	}
+	return rc == DuckDBSuccess;
 
-	s = tcc_new();
-	if (!s) {
-		tcc_set_error(error_buf, "tcc_new failed");
-		return -1;
+fail:
+	tcc_string_list_destroy(&arg_tokens);
+	if (arg_descs) {
+		for (i = 0; i < arg_count; i++) {
+			if (arg_descs[i]) {
+				tcc_typedesc_destroy(arg_descs[i]);
+			}
+		}
+		duckdb_free(arg_descs);
 	}
-	/* Set lib_path BEFORE tcc_set_output_type: tcc_set_output_type eagerly
-	 * expands {B} in CONFIG_TCC_SYSINCLUDEPATHS via tcc_split_path().  If we
-	 * wait until tcc_configure_runtime_paths (called after set_output_type),
-	 * {B} resolves to CONFIG_TCCDIR (the TinyCC install dir used at build
-	 * time, which does not exist on end-user machines) instead of our
-	 * embedded-runtime extraction directory. */
-	if (runtime_path && runtime_path[0] != '\0') {
-		tcc_set_lib_path(s, runtime_path);
+	if (return_desc) {
+		tcc_typedesc_destroy(return_desc);
 	}
-	tcc_set_error_func(s, error_buf, tcc_append_error);
-	/* Use -nostdlib so TinyCC does not attempt to locate and link libc.so at
-	 * relocation time.  In TCC_OUTPUT_MEMORY mode all undefined symbols are
-	 * resolved from the host process via dlsym(RTLD_DEFAULT, ...), so the
-	 * shared-library file is never needed.  Without this flag, compiling on a
-	 * machine that has no C development files installed (e.g. a bare Ubuntu
-	 * runtime with no libc6-dev) would produce "library 'c' not found" even
-	 * for code that uses no libc functions at all. */
-	tcc_set_options(s, "-nostdlib");
-	if (tcc_set_output_type(s, TCC_OUTPUT_MEMORY) != 0) {
-		tcc_set_error(error_buf, "tcc_set_output_type failed");
-		tcc_delete(s);
-		return -1;
+	if (arg_types) {
+		duckdb_free(arg_types);
 	}
-	tcc_configure_runtime_paths(s, runtime_path);
-	tcc_add_host_symbols(s);
-	if (tcc_apply_session_to_state(s, &state->session, error_buf) != 0) {
-		tcc_delete(s);
-		return -1;
+	if (arg_array_sizes) {
+		duckdb_free(arg_array_sizes);
 	}
-	if (tcc_apply_bind_overrides_to_state(s, bind, error_buf) != 0) {
-		tcc_delete(s);
-		return -1;
+	if (arg_struct_metas) {
+		tcc_struct_meta_array_destroy(arg_struct_metas, arg_count);
 	}
-	if (bind->source && bind->source[0] != '\0') {
-		if (tcc_compile_string(s, bind->source) != 0) {
-			if (error_buf->message[0] == '\0') {
-				tcc_set_error(error_buf, "source compile failed");
-			}
-			tcc_delete(s);
-			return -1;
-		}
+	if (arg_map_metas) {
+		tcc_map_meta_array_destroy(arg_map_metas, arg_count);
 	}
-	if (tcc_relocate(s) != 0) {
-		if (error_buf->message[0] == '\0') {
-			tcc_set_error(error_buf, "tcc_relocate failed");
-		}
-		tcc_delete(s);
-		return -1;
+	if (arg_union_metas) {
+		tcc_union_meta_array_destroy(arg_union_metas, arg_count);
 	}
-	sym = tcc_get_symbol(s, module_symbol);
-	if (!sym) {
-		tcc_set_error(error_buf, "module symbol not found after relocation");
-		tcc_delete(s);
-		return -1;
+	tcc_struct_meta_destroy(&ret_struct_meta);
+	tcc_map_meta_destroy(&ret_map_meta);
+	tcc_union_meta_destroy(&ret_union_meta);
+	if (fn) {
+		duckdb_destroy_scalar_function(&fn);
 	}
+	return false;
+}
 
-	artifact = (tcc_registered_artifact_t *)duckdb_malloc(sizeof(tcc_registered_artifact_t));
-	if (!artifact) {
-		tcc_set_error(error_buf, "out of memory");
-		tcc_delete(s);
-		return -1;
-	}
-	memset(artifact, 0, sizeof(tcc_registered_artifact_t));
-	artifact->tcc = s;
-	artifact->is_module = true;
-	artifact->module_init = (tcc_dynamic_init_fn_t)sym;
-	artifact->sql_name = tcc_strdup(module_name);
-	artifact->symbol = tcc_strdup(module_symbol);
-	artifact->state_id = state->session.state_id;
-	if (!artifact->module_init || !artifact->sql_name || !artifact->symbol) {
-		tcc_artifact_destroy(artifact);
-		tcc_set_error(error_buf, "invalid module artifact or out of memory");
-		return -1;
+/* ducktinycc_valid_is_set: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_valid_is_set(const uint64_t *validity, uint64_t idx) {
+	if (!validity) {
+		return 1;
 	}
-	*out_artifact = artifact;
-	return 0;
+	return (validity[idx >> 6] & (1ULL << (idx & 63))) != 0;
 }
-#endif
 
-/* Finds compiled-artifact registry index by SQL function name. */
-static idx_t tcc_registry_find_sql_name(tcc_module_state_t *state, const char *sql_name) {
-	idx_t i;
-	if (!state || !sql_name) {
-		return (idx_t)-1;
+/* ducktinycc_valid_set: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static void ducktinycc_valid_set(uint64_t *validity, uint64_t idx, int valid) {
+	uint64_t bit;
+	if (!validity) {
+		return;
 	}
-	for (i = 0; i < state->entry_count; i++) {
-		if (state->entries[i].sql_name && strcmp(state->entries[i].sql_name, sql_name) == 0) {
-			return i;
-		}
+	bit = 1ULL << (idx & 63);
+	if (valid) {
+		validity[idx >> 6] |= bit;
+	} else {
+		validity[idx >> 6] &= ~bit;
 	}
-	return (idx_t)-1;
 }
 
-/* Ensures registry storage capacity for compiled artifact metadata. */
-static bool tcc_registry_reserve(tcc_module_state_t *state, idx_t wanted) {
-	tcc_registered_entry_t *new_entries;
-	idx_t new_capacity;
-	if (state->entry_capacity >= wanted) {
-		return true;
+/* ducktinycc_span_contains: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_span_contains(uint64_t len, uint64_t idx) {
+	return idx < len;
+}
+
+static const void *ducktinycc_ptr_add(const void *base, uint64_t byte_offset) {
+	const uint8_t *p = (const uint8_t *)base;
+	if (!p) {
+		return NULL;
 	}
-	new_capacity = state->entry_capacity == 0 ? 8 : state->entry_capacity * 2;
-	while (new_capacity < wanted) {
-		new_capacity *= 2;
+	return (const void *)(p + byte_offset);
+}
+
+static void *ducktinycc_ptr_add_mut(void *base, uint64_t byte_offset) {
+	uint8_t *p = (uint8_t *)base;
+	if (!p) {
+		return NULL;
 	}
-	new_entries = (tcc_registered_entry_t *)duckdb_malloc(sizeof(tcc_registered_entry_t) * new_capacity);
-	if (!new_entries) {
-		return false;
+	return (void *)(p + byte_offset);
+}
+
+/* ducktinycc_span_fits: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_span_fits(uint64_t len, uint64_t offset, uint64_t width) {
+	if (offset > len) {
+		return 0;
 	}
-	memset(new_entries, 0, sizeof(tcc_registered_entry_t) * new_capacity);
-	if (state->entries && state->entry_count > 0) {
-		memcpy(new_entries, state->entries, sizeof(tcc_registered_entry_t) * state->entry_count);
-		duckdb_free(state->entries);
+	return width <= (len - offset);
+}
+
+static const void *ducktinycc_buf_ptr_at(const void *base, uint64_t len, uint64_t offset, uint64_t width) {
+	if (!base || !ducktinycc_span_fits(len, offset, width)) {
+		return NULL;
 	}
-	state->entries = new_entries;
-	state->entry_capacity = new_capacity;
-	return true;
+	return ducktinycc_ptr_add(base, offset);
 }
 
-/* Releases metadata (and underlying artifacts) for one registry entry. */
-static void tcc_registry_entry_destroy_metadata(tcc_registered_entry_t *entry) {
-	if (!entry) {
-		return;
+static void *ducktinycc_buf_ptr_at_mut(void *base, uint64_t len, uint64_t offset, uint64_t width) {
+	if (!base || !ducktinycc_span_fits(len, offset, width)) {
+		return NULL;
 	}
-	if (entry->sql_name) {
-		duckdb_free(entry->sql_name);
-		entry->sql_name = NULL;
+	return ducktinycc_ptr_add_mut(base, offset);
+}
+
+/* ducktinycc_read_bytes: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_read_bytes(const void *base, uint64_t len, uint64_t offset, void *out, uint64_t width) {
+	const void *src;
+	if (!out && width > 0) {
+		return 0;
 	}
-	if (entry->symbol) {
-		duckdb_free(entry->symbol);
-		entry->symbol = NULL;
+	if (width == 0) {
+		return 1;
 	}
-	entry->state_id = 0;
-#ifndef DUCKTINYCC_WASM_UNSUPPORTED
-	if (entry->artifact) {
-		tcc_artifact_destroy(entry->artifact);
+	src = ducktinycc_buf_ptr_at(base, len, offset, width);
+	if (!src) {
+		return 0;
 	}
-	entry->artifact = NULL;
-#endif
-}
+	memcpy(out, src, (size_t)width);
+	return 1;
+}
 
-/* Inserts/replaces compiled artifact metadata for one SQL function name. */
-static bool tcc_registry_store_metadata(tcc_module_state_t *state, const char *sql_name, const char *symbol,
-                                        uint64_t state_id
-#ifndef DUCKTINYCC_WASM_UNSUPPORTED
-                                        , tcc_registered_artifact_t *artifact
-#endif
-) {
-	idx_t idx = tcc_registry_find_sql_name(state, sql_name);
-	tcc_registered_entry_t *entry;
-	if (idx == (idx_t)-1) {
-		if (!tcc_registry_reserve(state, state->entry_count + 1)) {
-			return false;
-		}
-		idx = state->entry_count++;
+/* ducktinycc_write_bytes: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_write_bytes(void *base, uint64_t len, uint64_t offset, const void *in, uint64_t width) {
+	void *dst;
+	if (!in && width > 0) {
+		return 0;
 	}
-	entry = &state->entries[idx];
-	tcc_registry_entry_destroy_metadata(entry);
-	entry->sql_name = tcc_strdup(sql_name);
-	entry->symbol = tcc_strdup(symbol);
-	entry->state_id = state_id;
-#ifndef DUCKTINYCC_WASM_UNSUPPORTED
-	entry->artifact = artifact;
-#endif
-	if (!entry->sql_name || !entry->symbol) {
-		tcc_registry_entry_destroy_metadata(entry);
-		return false;
+	if (width == 0) {
+		return 1;
 	}
-	return true;
+	dst = ducktinycc_buf_ptr_at_mut(base, len, offset, width);
+	if (!dst) {
+		return 0;
+	}
+	memcpy(dst, in, (size_t)width);
+	return 1;
 }
 
-/* Destructor for table-function extra info (`tcc_module_state_t`). */
-static void destroy_tcc_module_state(void *ptr) {
-	tcc_module_state_t *state = (tcc_module_state_t *)ptr;
-	idx_t i;
-	if (!state) {
-		return;
+#define DUCKTINYCC_DEFINE_BUF_RW(name, type)                                                                                \
+	static int ducktinycc_read_##name(const void *base, uint64_t len, uint64_t offset, type *out) {                     \
+		return ducktinycc_read_bytes(base, len, offset, out, (uint64_t)sizeof(type));                               \
+	}                                                                                                                      \
+	static int ducktinycc_write_##name(void *base, uint64_t len, uint64_t offset, type value) {                        \
+		return ducktinycc_write_bytes(base, len, offset, &value, (uint64_t)sizeof(type));                          \
 	}
-	for (i = 0; i < state->entry_count; i++) {
-		tcc_registry_entry_destroy_metadata(&state->entries[i]);
+
+DUCKTINYCC_DEFINE_BUF_RW(i8, int8_t)
+DUCKTINYCC_DEFINE_BUF_RW(u8, uint8_t)
+DUCKTINYCC_DEFINE_BUF_RW(i16, int16_t)
+DUCKTINYCC_DEFINE_BUF_RW(u16, uint16_t)
+DUCKTINYCC_DEFINE_BUF_RW(i32, int32_t)
+DUCKTINYCC_DEFINE_BUF_RW(u32, uint32_t)
+DUCKTINYCC_DEFINE_BUF_RW(i64, int64_t)
+DUCKTINYCC_DEFINE_BUF_RW(u64, uint64_t)
+DUCKTINYCC_DEFINE_BUF_RW(f32, float)
+DUCKTINYCC_DEFINE_BUF_RW(f64, double)
+
+#undef DUCKTINYCC_DEFINE_BUF_RW
+
+/* ducktinycc_read_ptr: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_read_ptr(const void *base, uint64_t len, uint64_t offset, const void **out) {
+	uintptr_t tmp = 0;
+	if (!out) {
+		return 0;
 	}
-	if (state->entries) {
-		duckdb_free(state->entries);
+	if (!ducktinycc_read_bytes(base, len, offset, &tmp, (uint64_t)sizeof(uintptr_t))) {
+		return 0;
 	}
-	if (state->ptr_registry) {
-		tcc_ptr_registry_unref(state->ptr_registry);
-		state->ptr_registry = NULL;
+	*out = (const void *)tmp;
+	return 1;
+}
+
+/* ducktinycc_write_ptr: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_write_ptr(void *base, uint64_t len, uint64_t offset, const void *value) {
+	uintptr_t tmp = (uintptr_t)value;
+	return ducktinycc_write_bytes(base, len, offset, &tmp, (uint64_t)sizeof(uintptr_t));
+}
+
+/* ducktinycc_list_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_list_is_valid(const ducktinycc_list_t *list, uint64_t idx) {
+	uint64_t global_idx;
+	if (!list || idx >= list->len) {
+		return 0;
 	}
-	if (state->session.runtime_path) {
-		duckdb_free(state->session.runtime_path);
+	if (!list->validity) {
+		return 1;
 	}
-	tcc_session_clear_build_state(&state->session);
-	duckdb_free(state);
+	global_idx = list->offset + idx;
+	return ducktinycc_valid_is_set(list->validity, global_idx);
 }
 
-/* Destructor for per-invocation bind payload of `tcc_module(...)`. */
-static void destroy_tcc_module_bind_data(void *ptr) {
-	tcc_module_bind_data_t *bind = (tcc_module_bind_data_t *)ptr;
-	if (!bind) {
-		return;
+static const void *ducktinycc_list_elem_ptr(const ducktinycc_list_t *list, uint64_t idx, uint64_t elem_size) {
+	if (!list || !list->ptr || idx >= list->len || elem_size == 0) {
+		return NULL;
 	}
-	if (bind->mode) {
-		duckdb_free(bind->mode);
+	return ducktinycc_ptr_add(list->ptr, idx * elem_size);
+}
+
+/* ducktinycc_array_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_array_is_valid(const ducktinycc_array_t *arr, uint64_t idx) {
+	uint64_t global_idx;
+	if (!arr || idx >= arr->len) {
+		return 0;
 	}
-	if (bind->runtime_path) {
-		duckdb_free(bind->runtime_path);
+	if (!arr->validity) {
+		return 1;
 	}
-	if (bind->source) {
-		duckdb_free(bind->source);
+	global_idx = arr->offset + idx;
+	return ducktinycc_valid_is_set(arr->validity, global_idx);
+}
+
+static const void *ducktinycc_array_elem_ptr(const ducktinycc_array_t *arr, uint64_t idx, uint64_t elem_size) {
+	if (!arr || !arr->ptr || idx >= arr->len || elem_size == 0) {
+		return NULL;
 	}
-	if (bind->symbol) {
-		duckdb_free(bind->symbol);
+	return ducktinycc_ptr_add(arr->ptr, idx * elem_size);
+}
+
+static const void *ducktinycc_struct_field_ptr(const ducktinycc_struct_t *st, uint64_t idx) {
+	if (!st || !st->field_ptrs || idx >= st->field_count) {
+		return NULL;
 	}
-	if (bind->sql_name) {
-		duckdb_free(bind->sql_name);
+	return st->field_ptrs[idx];
+}
+
+/* ducktinycc_struct_field_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_struct_field_is_valid(const ducktinycc_struct_t *st, uint64_t field_idx) {
+	if (!st || !st->field_ptrs || field_idx >= st->field_count || !st->field_ptrs[field_idx]) {
+		return 0;
 	}
-	if (bind->arg_types) {
-		duckdb_free(bind->arg_types);
+	if (!st->field_validity || !st->field_validity[field_idx]) {
+		return 1;
 	}
-	if (bind->return_type) {
-		duckdb_free(bind->return_type);
+	return ducktinycc_valid_is_set(st->field_validity[field_idx], st->offset);
+}
+
+static const void *ducktinycc_map_key_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t key_size) {
+	if (!m || !m->key_ptr || idx >= m->len || key_size == 0) {
+		return NULL;
 	}
-	if (bind->wrapper_mode) {
-		duckdb_free(bind->wrapper_mode);
+	return ducktinycc_ptr_add(m->key_ptr, idx * key_size);
+}
+
+static const void *ducktinycc_map_value_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t value_size) {
+	if (!m || !m->value_ptr || idx >= m->len || value_size == 0) {
+		return NULL;
 	}
-	if (bind->stability) {
-		duckdb_free(bind->stability);
+	return ducktinycc_ptr_add(m->value_ptr, idx * value_size);
+}
+
+/* ducktinycc_map_key_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_map_key_is_valid(const ducktinycc_map_t *m, uint64_t idx) {
+	uint64_t global_idx;
+	if (!m || idx >= m->len) {
+		return 0;
 	}
-	if (bind->include_path) {
-		duckdb_free(bind->include_path);
+	if (!m->key_validity) {
+		return 1;
 	}
-	if (bind->sysinclude_path) {
-		duckdb_free(bind->sysinclude_path);
+	global_idx = m->offset + idx;
+	return ducktinycc_valid_is_set(m->key_validity, global_idx);
+}
+
+/* ducktinycc_map_value_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_map_value_is_valid(const ducktinycc_map_t *m, uint64_t idx) {
+	uint64_t global_idx;
+	if (!m || idx >= m->len) {
+		return 0;
 	}
-	if (bind->library_path) {
-		duckdb_free(bind->library_path);
+	if (!m->value_validity) {
+		return 1;
 	}
-	if (bind->library) {
-		duckdb_free(bind->library);
+	global_idx = m->offset + idx;
+	return ducktinycc_valid_is_set(m->value_validity, global_idx);
+}
+
+/* Maps shorter than this are searched linearly; building an index would cost more than it saves. */
+#define TCC_MAP_INDEX_MIN_LEN 16
+
+/* tcc_map_key_hash: hashes one fixed-width key; 4- and 8-byte keys skip the byte loop. */
+static uint64_t tcc_map_key_hash(const void *key, uint64_t key_size) {
+	uint64_t h;
+	uint64_t i;
+	if (key_size == 8) {
+		memcpy(&h, key, 8);
+	} else if (key_size == 4) {
+		uint32_t v;
+		memcpy(&v, key, 4);
+		h = v;
+	} else {
+		h = 1469598103934665603ULL;
+		for (i = 0; i < key_size; i++) {
+			h ^= ((const uint8_t *)key)[i];
+			h *= 1099511628211ULL;
+		}
 	}
-	if (bind->option) {
-		duckdb_free(bind->option);
+	h *= 0x9E3779B97F4A7C15ULL;
+	return h ^ (h >> 29);
+}
+
+/* tcc_map_index_build: indexes the valid keys of `m` into `index`, keeping the first of duplicate keys.
+ * Allocation/Lifetime: grows the slot's table with duckdb_malloc; returns false (slot emptied) when out of memory. */
+static bool tcc_map_index_build(tcc_map_index_t *index, const ducktinycc_map_t *m, uint64_t key_size) {
+	uint64_t capacity = 32;
+	uint64_t i;
+	while (capacity < m->len * 2) {
+		capacity <<= 1;
+	}
+	if (capacity > index->table_capacity) {
+		if (index->table) {
+			duckdb_free(index->table);
+		}
+		index->table = (uint32_t *)duckdb_malloc(sizeof(uint32_t) * (size_t)capacity);
+		if (!index->table) {
+			memset(index, 0, sizeof(*index));
+			return false;
+		}
+		index->table_capacity = capacity;
 	}
-	if (bind->header) {
-		duckdb_free(bind->header);
+	memset(index->table, 0, sizeof(uint32_t) * (size_t)capacity);
+	index->mask = capacity - 1;
+	for (i = 0; i < m->len; i++) {
+		const uint8_t *key = (const uint8_t *)m->key_ptr + i * key_size;
+		uint64_t slot;
+		if (m->key_validity && !ducktinycc_valid_is_set(m->key_validity, m->offset + i)) {
+			continue;
+		}
+		for (slot = tcc_map_key_hash(key, key_size) & index->mask; index->table[slot] != 0;
+		     slot = (slot + 1) & index->mask) {
+			if (memcmp((const uint8_t *)m->key_ptr + (index->table[slot] - 1) * key_size, key, (size_t)key_size) ==
+			    0) {
+				break;
+			}
+		}
+		if (index->table[slot] == 0) {
+			index->table[slot] = (uint32_t)(i + 1);
+		}
 	}
-	if (bind->define_name) {
-		duckdb_free(bind->define_name);
+	index->key_ptr = m->key_ptr;
+	index->len = m->len;
+	index->key_size = key_size;
+	return true;
+}
+
+/* ducktinycc_map_find: Host-exported MAP key lookup for fixed-width keys, compared bytewise. Returns the key's
+ * position (for ducktinycc_map_value_ptr) or -1. Allocation/Lifetime: maps of 16+ entries get a hash index in the
+ * executing chunk's scratch on first lookup, so repeated probes of one map cost O(1); the index is dropped with the
+ * chunk. Outside a UDF call it falls back to a linear scan. */
+static int64_t ducktinycc_map_find(const ducktinycc_map_t *m, const void *key, uint64_t key_size) {
+	tcc_out_arena_t *arena = tcc_current_out_arena;
+	tcc_map_index_t *index;
+	uint64_t slot;
+	uint64_t i;
+	if (!m || !m->key_ptr || !key || key_size == 0) {
+		return -1;
 	}
-	if (bind->define_value) {
-		duckdb_free(bind->define_value);
+	if (arena && m->len >= TCC_MAP_INDEX_MIN_LEN && m->len < UINT32_MAX) {
+		index = &arena->map_index[((uintptr_t)m->key_ptr >> 4) % TCC_MAP_INDEX_SLOTS];
+		if ((index->key_ptr == m->key_ptr && index->len == m->len && index->key_size == key_size) ||
+		    tcc_map_index_build(index, m, key_size)) {
+			for (slot = tcc_map_key_hash(key, key_size) & index->mask; index->table[slot] != 0;
+			     slot = (slot + 1) & index->mask) {
+				i = index->table[slot] - 1;
+				if (memcmp((const uint8_t *)m->key_ptr + i * key_size, key, (size_t)key_size) == 0) {
+					return (int64_t)i;
+				}
+			}
+			return -1;
+		}
 	}
-	if (bind->symbol_name) {
-		duckdb_free(bind->symbol_name);
+	for (i = 0; i < m->len; i++) {
+		if (memcmp((const uint8_t *)m->key_ptr + i * key_size, key, (size_t)key_size) == 0 &&
+		    ducktinycc_map_key_is_valid(m, i)) {
+			return (int64_t)i;
+		}
 	}
-	duckdb_free(bind);
+	return -1;
 }
 
-/* Destructor for per-scan init payload of `tcc_module(...)`. */
-static void destroy_tcc_module_init_data(void *ptr) {
-	tcc_module_init_data_t *init = (tcc_module_init_data_t *)ptr;
-	if (!init) {
-		return;
+/* ducktinycc_union_tag: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_union_tag(const ducktinycc_union_t *u) {
+	if (!u || !u->tag_ptr) {
+		return -1;
 	}
-	duckdb_free(init);
+	return (int)u->tag_ptr[u->offset];
 }
 
-/* Reads optional named VARCHAR bind parameter as owned C string. */
-static void tcc_bind_read_named_varchar(duckdb_bind_info info, const char *name, char **out_value) {
-	duckdb_value value = duckdb_bind_get_named_parameter(info, name);
-	if (value && !duckdb_is_null_value(value)) {
-		*out_value = duckdb_get_varchar(value);
-	}
-	if (value) {
-		duckdb_destroy_value(&value);
+/* ducktinycc_union_member_ptr: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static const void *ducktinycc_union_member_ptr(const ducktinycc_union_t *u, uint64_t member_idx) {
+	if (!u || !u->member_ptrs || member_idx >= u->member_count) {
+		return NULL;
 	}
+	return u->member_ptrs[member_idx];
 }
 
-/* Reads `arg_types` named parameter, normalizing LIST/ARRAY inputs into CSV token string. */
-static void tcc_bind_read_named_arg_types(duckdb_bind_info info, char **out_csv) {
-	duckdb_value value = duckdb_bind_get_named_parameter(info, "arg_types");
-	if (!value || duckdb_is_null_value(value)) {
-		if (value) {
-			duckdb_destroy_value(&value);
-		}
-		return;
+/* ducktinycc_union_member_is_valid: Host-exported bridge/accessor helper for generated wrappers. Allocation/Lifetime: operates on DuckDB/vector memory and bridge descriptors; treat pointers as borrowed unless explicitly allocated. */
+static int ducktinycc_union_member_is_valid(const ducktinycc_union_t *u, uint64_t member_idx) {
+	if (!u || !u->member_ptrs || member_idx >= u->member_count) {
+		return 0;
 	}
-	duckdb_logical_type vtype = duckdb_get_value_type(value);
-	duckdb_type type_id = duckdb_get_type_id(vtype);
-	if (type_id == DUCKDB_TYPE_LIST || type_id == DUCKDB_TYPE_ARRAY) {
-		idx_t n = duckdb_get_list_size(value);
-		idx_t i;
-		size_t total = 0;
-		char *buf;
-		size_t off = 0;
-		for (i = 0; i < n; i++) {
-			duckdb_value child = duckdb_get_list_child(value, i);
-			char *txt = duckdb_get_varchar(child);
-			size_t len = txt ? strlen(txt) : 0;
-			total += len + (i > 0 ? 1 : 0);
-			if (txt) {
-				duckdb_free(txt);
-			}
-			duckdb_destroy_value(&child);
-		}
-		buf = (char *)duckdb_malloc(total + 1);
-		if (!buf) {
-			duckdb_destroy_value(&value);
-			return;
-		}
-		buf[0] = '\0';
-		for (i = 0; i < n; i++) {
-			duckdb_value child = duckdb_get_list_child(value, i);
-			char *txt = duckdb_get_varchar(child);
-			if (i > 0) {
-				buf[off++] = ',';
-			}
-			if (txt) {
-				size_t len = strlen(txt);
-				memcpy(buf + off, txt, len);
-				off += len;
-				duckdb_free(txt);
-			}
-			duckdb_destroy_value(&child);
-		}
-		buf[off] = '\0';
-		*out_csv = buf;
+	if (!u->member_validity || !u->member_validity[member_idx]) {
+		return 1;
 	}
-	duckdb_destroy_value(&value);
+	return ducktinycc_valid_is_set(u->member_validity[member_idx], u->offset);
 }
 
-/* Bind callback: parses named parameters into immutable bind data for one call. */
-static void tcc_module_bind(duckdb_bind_info info) {
-	tcc_module_bind_data_t *bind;
-	duckdb_logical_type varchar_type;
-	duckdb_logical_type bool_type;
+#define TCC_HOST_SYMBOL_TABLE(X)                                                                                          \
+	X("duckdb_ext_api", &duckdb_ext_api)                                                                                 \
+	X("ducktinycc_register_signature", ducktinycc_register_signature)                                                    \
+	X("ducktinycc_valid_is_set", ducktinycc_valid_is_set)                                                                \
+	X("ducktinycc_valid_set", ducktinycc_valid_set)                                                                      \
+	X("ducktinycc_span_contains", ducktinycc_span_contains)                                                              \
+	X("ducktinycc_ptr_add", ducktinycc_ptr_add)                                                                          \
+	X("ducktinycc_ptr_add_mut", ducktinycc_ptr_add_mut)                                                                  \
+	X("ducktinycc_span_fits", ducktinycc_span_fits)                                                                      \
+	X("ducktinycc_buf_ptr_at", ducktinycc_buf_ptr_at)                                                                    \
+	X("ducktinycc_buf_ptr_at_mut", ducktinycc_buf_ptr_at_mut)                                                            \
+	X("ducktinycc_read_bytes", ducktinycc_read_bytes)                                                                    \
+	X("ducktinycc_write_bytes", ducktinycc_write_bytes)                                                                  \
+	X("ducktinycc_read_i8", ducktinycc_read_i8)                                                                          \
+	X("ducktinycc_write_i8", ducktinycc_write_i8)                                                                        \
+	X("ducktinycc_read_u8", ducktinycc_read_u8)                                                                          \
+	X("ducktinycc_write_u8", ducktinycc_write_u8)                                                                        \
+	X("ducktinycc_read_i16", ducktinycc_read_i16)                                                                        \
+	X("ducktinycc_write_i16", ducktinycc_write_i16)                                                                      \
+	X("ducktinycc_read_u16", ducktinycc_read_u16)                                                                        \
+	X("ducktinycc_write_u16", ducktinycc_write_u16)                                                                      \
+	X("ducktinycc_read_i32", ducktinycc_read_i32)                                                                        \
+	X("ducktinycc_write_i32", ducktinycc_write_i32)                                                                      \
+	X("ducktinycc_read_u32", ducktinycc_read_u32)                                                                        \
+	X("ducktinycc_write_u32", ducktinycc_write_u32)                                                                      \
+	X("ducktinycc_read_i64", ducktinycc_read_i64)                                                                        \
+	X("ducktinycc_write_i64", ducktinycc_write_i64)                                                                      \
+	X("ducktinycc_read_u64", ducktinycc_read_u64)                                                                        \
+	X("ducktinycc_write_u64", ducktinycc_write_u64)                                                                      \
+	X("ducktinycc_read_f32", ducktinycc_read_f32)                                                                        \
+	X("ducktinycc_write_f32", ducktinycc_write_f32)                                                                      \
+	X("ducktinycc_read_f64", ducktinycc_read_f64)                                                                        \
+	X("ducktinycc_write_f64", ducktinycc_write_f64)                                                                      \
+	X("ducktinycc_read_ptr", ducktinycc_read_ptr)                                                                        \
+	X("ducktinycc_write_ptr", ducktinycc_write_ptr)                                                                      \
+	X("ducktinycc_list_is_valid", ducktinycc_list_is_valid)                                                              \
+	X("ducktinycc_list_elem_ptr", ducktinycc_list_elem_ptr)                                                              \
+	X("ducktinycc_array_is_valid", ducktinycc_array_is_valid)                                                            \
+	X("ducktinycc_array_elem_ptr", ducktinycc_array_elem_ptr)                                                            \
+	X("ducktinycc_struct_field_ptr", ducktinycc_struct_field_ptr)                                                        \
+	X("ducktinycc_struct_field_is_valid", ducktinycc_struct_field_is_valid)                                              \
+	X("ducktinycc_map_key_ptr", ducktinycc_map_key_ptr)                                                                  \
+	X("ducktinycc_map_value_ptr", ducktinycc_map_value_ptr)                                                              \
+	X("ducktinycc_map_key_is_valid", ducktinycc_map_key_is_valid)                                                        \
+	X("ducktinycc_map_value_is_valid", ducktinycc_map_value_is_valid)                                                      \
+	X("ducktinycc_map_find", ducktinycc_map_find)                                                                        \
+	X("ducktinycc_union_tag", ducktinycc_union_tag)                                                                        \
+	X("ducktinycc_union_member_ptr", ducktinycc_union_member_ptr)                                                          \
+	X("ducktinycc_union_member_is_valid", ducktinycc_union_member_is_valid)                                                \
+	X("ducktinycc_out_alloc", ducktinycc_out_alloc)                                                                        \
+	X("duckdb_validity_row_is_valid", duckdb_validity_row_is_valid)                                                        \
+	X("ducktinycc_fmod", fmod)
 
-	bind = (tcc_module_bind_data_t *)duckdb_malloc(sizeof(tcc_module_bind_data_t));
-	if (!bind) {
-		duckdb_bind_set_error(info, "out of memory");
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/* tcc_add_host_symbols: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_add_host_symbols(TCCState *s) {
+	if (!s) {
 		return;
 	}
-	memset(bind, 0, sizeof(tcc_module_bind_data_t));
-
-	tcc_bind_read_named_varchar(info, "mode", &bind->mode);
-	if (!bind->mode || bind->mode[0] == '\0') {
-		bind->mode = tcc_strdup("config_get");
-	}
-	tcc_bind_read_named_varchar(info, "runtime_path", &bind->runtime_path);
-	tcc_bind_read_named_varchar(info, "source", &bind->source);
-	tcc_bind_read_named_varchar(info, "symbol", &bind->symbol);
-	tcc_bind_read_named_varchar(info, "sql_name", &bind->sql_name);
-	tcc_bind_read_named_arg_types(info, &bind->arg_types);
-	tcc_bind_read_named_varchar(info, "return_type", &bind->return_type);
-	tcc_bind_read_named_varchar(info, "wrapper_mode", &bind->wrapper_mode);
-	if (!bind->wrapper_mode || bind->wrapper_mode[0] == '\0') {
-		if (bind->wrapper_mode) {
-			duckdb_free(bind->wrapper_mode);
-		}
-		bind->wrapper_mode = tcc_strdup("row");
-	}
-	tcc_bind_read_named_varchar(info, "stability", &bind->stability);
-	tcc_bind_read_named_varchar(info, "include_path", &bind->include_path);
-	tcc_bind_read_named_varchar(info, "sysinclude_path", &bind->sysinclude_path);
-	tcc_bind_read_named_varchar(info, "library_path", &bind->library_path);
-	tcc_bind_read_named_varchar(info, "library", &bind->library);
-	tcc_bind_read_named_varchar(info, "option", &bind->option);
-	tcc_bind_read_named_varchar(info, "header", &bind->header);
-	tcc_bind_read_named_varchar(info, "define_name", &bind->define_name);
-	tcc_bind_read_named_varchar(info, "define_value", &bind->define_value);
-	tcc_bind_read_named_varchar(info, "symbol_name", &bind->symbol_name);
-	{
-		duckdb_value spval = duckdb_bind_get_named_parameter(info, "symbol_ptr");
-		if (spval && !duckdb_is_null_value(spval)) {
-			char *ptr_str = duckdb_get_varchar(spval);
-			if (ptr_str) {
-				bind->symbol_ptr = (uint64_t)strtoull(ptr_str, NULL, 10);
-				bind->has_symbol_ptr = true;
-				duckdb_free(ptr_str);
-			}
-		}
-		if (spval) {
-			duckdb_destroy_value(&spval);
-		}
-	}
-
-	bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
-	varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
-
-	duckdb_bind_add_result_column(info, "ok", bool_type);
-	duckdb_bind_add_result_column(info, "mode", varchar_type);
-	duckdb_bind_add_result_column(info, "phase", varchar_type);
-	duckdb_bind_add_result_column(info, "code", varchar_type);
-	duckdb_bind_add_result_column(info, "message", varchar_type);
-	duckdb_bind_add_result_column(info, "detail", varchar_type);
-	duckdb_bind_add_result_column(info, "sql_name", varchar_type);
-	duckdb_bind_add_result_column(info, "symbol", varchar_type);
-	duckdb_bind_add_result_column(info, "artifact_id", varchar_type);
-	duckdb_bind_add_result_column(info, "connection_scope", varchar_type);
-
-	duckdb_destroy_logical_type(&bool_type);
-	duckdb_destroy_logical_type(&varchar_type);
-
-	duckdb_bind_set_cardinality(info, 1, true);
-	duckdb_bind_set_bind_data(info, bind, destroy_tcc_module_bind_data);
+#define TCC_ADD_HOST_SYMBOL(name, ptr) (void)tcc_add_symbol(s, name, ptr);
+	TCC_HOST_SYMBOL_TABLE(TCC_ADD_HOST_SYMBOL)
+#undef TCC_ADD_HOST_SYMBOL
 }
 
-/* Init callback: stores one-shot emission state for table-function execution. */
-static void tcc_module_init(duckdb_init_info info) {
-	tcc_module_init_data_t *init = (tcc_module_init_data_t *)duckdb_malloc(sizeof(tcc_module_init_data_t));
-	if (!init) {
-		duckdb_init_set_error(info, "out of memory");
-		return;
+/* tcc_is_host_symbol: true when `name` is one of the symbols tcc_add_host_symbols injects into every state. */
+static bool tcc_is_host_symbol(const char *name) {
+#define TCC_MATCH_HOST_SYMBOL(sym_name, ptr)                                                                           \
+	if (strcmp(name, sym_name) == 0) {                                                                                 \
+		return true;                                                                                                   \
 	}
-	atomic_store_explicit(&init->emitted, false, memory_order_relaxed);
-	duckdb_init_set_init_data(info, init, destroy_tcc_module_init_data);
+	TCC_HOST_SYMBOL_TABLE(TCC_MATCH_HOST_SYMBOL)
+#undef TCC_MATCH_HOST_SYMBOL
+	return false;
 }
+#undef TCC_HOST_SYMBOL_TABLE
 
-/* Writes nullable VARCHAR value into an output vector cell. */
-static void tcc_set_varchar_col(duckdb_vector vector, idx_t row, const char *value) {
-	uint64_t *validity;
-	if (!value) {
-		duckdb_vector_ensure_validity_writable(vector);
-		validity = duckdb_vector_get_validity(vector);
-		duckdb_validity_set_row_invalid(validity, row);
+/* tcc_artifact_destroy: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
+static void tcc_artifact_destroy(void *ptr) {
+	tcc_registered_artifact_t *artifact = (tcc_registered_artifact_t *)ptr;
+	idx_t i;
+	if (!artifact || atomic_fetch_sub_explicit(&artifact->refs, 1, memory_order_acq_rel) != 1) {
 		return;
 	}
-	duckdb_vector_assign_string_element(vector, row, value);
-}
-
-/* Emits one diagnostics/status row in the `tcc_module(...)` table output schema. */
-static void tcc_write_row(duckdb_data_chunk output, bool ok, const char *mode, const char *phase, const char *code,
-                          const char *message, const char *detail, const char *sql_name, const char *symbol,
-                          const char *artifact_id, const char *connection_scope) {
-	duckdb_vector v_ok = duckdb_data_chunk_get_vector(output, 0);
-	bool *ok_data = (bool *)duckdb_vector_get_data(v_ok);
-	ok_data[0] = ok;
-
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), 0, mode);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 2), 0, phase);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 3), 0, code);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 4), 0, message);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 5), 0, detail);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 6), 0, sql_name);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 7), 0, symbol);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 8), 0, artifact_id);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 9), 0, connection_scope);
-	duckdb_data_chunk_set_size(output, 1);
-}
-
-static const char *tcc_skip_space(const char *p) {
-	while (p && *p && isspace((unsigned char)*p)) {
-		p++;
+	if (artifact->tcc) {
+		tcc_delete(artifact->tcc);
 	}
-	return p;
-}
-
-/* tcc_equals_ci: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_equals_ci(const char *a, const char *b) {
-	unsigned char ca;
-	unsigned char cb;
-	if (!a || !b) {
-		return false;
+	if (artifact->sql_name) {
+		duckdb_free(artifact->sql_name);
 	}
-	while (*a && *b) {
-		ca = (unsigned char)tolower((unsigned char)*a++);
-		cb = (unsigned char)tolower((unsigned char)*b++);
-		if (ca != cb) {
-			return false;
+	if (artifact->symbol) {
+		duckdb_free(artifact->symbol);
+	}
+	if (artifact->udf_stats) {
+		for (i = 0; i < artifact->udf_stats_count; i++) {
+			tcc_udf_stats_destroy(artifact->udf_stats[i]);
 		}
+		duckdb_free((void *)artifact->udf_stats);
 	}
-	return *a == '\0' && *b == '\0';
+	/* After tcc_delete: the module's code calls into the base and its imports. */
+	tcc_session_base_release(artifact->base);
+	for (i = 0; i < artifact->import_count; i++) {
+		tcc_artifact_destroy(artifact->imports[i]);
+	}
+	if (artifact->imports) {
+		duckdb_free((void *)artifact->imports);
+	}
+	tcc_artifact_destroy(artifact->rebuilt);
+	tcc_artifact_destroy(artifact->superseded);
+	duckdb_free(artifact);
 }
 
-static const char *tcc_wrapper_mode_token(tcc_wrapper_mode_t mode) {
-	switch (mode) {
-	case TCC_WRAPPER_MODE_ROW:
-		return "row";
-	case TCC_WRAPPER_MODE_BATCH:
-		return "chunk_scalar_loop";
-	default:
-		return NULL;
+/* tcc_apply_session_to_state: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static int tcc_apply_session_to_state(TCCState *s, const tcc_session_t *session, const tcc_session_base_t *base,
+                                      tcc_error_buffer_t *error_buf) {
+	idx_t i;
+	for (i = 0; i < session->include_paths.count; i++) {
+		if (tcc_add_include_path(s, session->include_paths.items[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_include_path failed");
+			return -1;
+		}
 	}
-}
-
-static const char *tcc_function_stability_token(tcc_function_stability_t stability) {
-	switch (stability) {
-	case TCC_FUNCTION_STABILITY_CONSISTENT:
-		return "consistent";
-	case TCC_FUNCTION_STABILITY_VOLATILE:
-		return "volatile";
-	default:
-		return NULL;
+	for (i = 0; i < session->sysinclude_paths.count; i++) {
+		if (tcc_add_sysinclude_path(s, session->sysinclude_paths.items[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_sysinclude_path failed");
+			return -1;
+		}
+	}
+	for (i = 0; i < session->library_paths.count; i++) {
+		if (tcc_add_library_path(s, session->library_paths.items[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_library_path failed");
+			return -1;
+		}
+	}
+	for (i = 0; i < session->options.count; i++) {
+		tcc_set_options(s, session->options.items[i]);
+	}
+	for (i = 0; i < session->define_names.count; i++) {
+		tcc_define_symbol(s, session->define_names.items[i], session->define_values.items[i]);
+	}
+	/* With a shared base the staged units are already compiled; their symbols are added below. */
+	for (i = 0; !base && i < session->headers.count; i++) {
+		if (tcc_compile_string(s, session->headers.items[i]) != 0) {
+			if (error_buf->message[0] == '\0') {
+				tcc_set_error(error_buf, "header compile failed");
+			}
+			return -1;
+		}
+	}
+	for (i = 0; !base && i < session->sources.count; i++) {
+		if (tcc_compile_string(s, session->sources.items[i]) != 0) {
+			if (error_buf->message[0] == '\0') {
+				tcc_set_error(error_buf, "source compile failed");
+			}
+			return -1;
+		}
+	}
+	for (i = 0; i < session->libraries.count; i++) {
+		if (tcc_add_library(s, session->libraries.items[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_library failed");
+			return -1;
+		}
+	}
+	for (i = 0; i < session->symbol_names.count && i < session->symbol_count; i++) {
+		if (tcc_add_symbol(s, session->symbol_names.items[i], (void *)(uintptr_t)session->symbol_ptrs[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_symbol failed for user symbol");
+			return -1;
+		}
+	}
+	for (i = 0; base && i < base->count; i++) {
+		if (tcc_add_symbol(s, base->names[i], base->addrs[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_symbol failed for staged source symbol");
+			return -1;
+		}
 	}
+	return 0;
 }
 
-/* tcc_parse_function_stability: Parser helper for DuckDB scalar-function stability. */
-static bool tcc_parse_function_stability(const char *stability, tcc_function_stability_t *out_stability,
-                                         tcc_error_buffer_t *error_buf) {
-	const char *value = stability;
-	char token[32];
-	size_t len;
-	if (!out_stability) {
-		tcc_set_error(error_buf, "stability output is required");
-		return false;
+/* tcc_apply_bind_overrides_to_state: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static int tcc_apply_bind_overrides_to_state(TCCState *s, const tcc_module_bind_data_t *bind,
+                                             tcc_error_buffer_t *error_buf) {
+	const char *define_value;
+	if (!s || !bind) {
+		return 0;
 	}
-	if (!value || value[0] == '\0') {
-		*out_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
-		return true;
+	if (bind->include_path && bind->include_path[0] != '\0') {
+		if (tcc_add_include_path(s, bind->include_path) != 0) {
+			tcc_set_error(error_buf, "tcc_add_include_path failed");
+			return -1;
+		}
 	}
-	value = tcc_skip_space(value);
-	len = strlen(value);
-	while (len > 0 && isspace((unsigned char)value[len - 1])) {
-		len--;
+	if (bind->source_file && bind->source_file[0] != '\0') {
+		/* The unit is compiled from a string, so quoted includes would otherwise resolve from the working dir. */
+		char dir[1024];
+		if (!tcc_source_file_dir(bind->source_file, dir, sizeof(dir)) || tcc_add_include_path(s, dir) != 0) {
+			tcc_set_error(error_buf, "tcc_add_include_path failed");
+			return -1;
+		}
 	}
-	if (len == 0 || len >= sizeof(token)) {
-		tcc_set_error(error_buf, "stability contains unsupported token");
-		return false;
+	if (bind->sysinclude_path && bind->sysinclude_path[0] != '\0') {
+		if (tcc_add_sysinclude_path(s, bind->sysinclude_path) != 0) {
+			tcc_set_error(error_buf, "tcc_add_sysinclude_path failed");
+			return -1;
+		}
 	}
-	memcpy(token, value, len);
-	token[len] = '\0';
-	if (tcc_equals_ci(token, "consistent")) {
-		*out_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
-		return true;
+	if (bind->library_path && bind->library_path[0] != '\0') {
+		if (tcc_add_library_path(s, bind->library_path) != 0) {
+			tcc_set_error(error_buf, "tcc_add_library_path failed");
+			return -1;
+		}
 	}
-	if (tcc_equals_ci(token, "volatile")) {
-		*out_stability = TCC_FUNCTION_STABILITY_VOLATILE;
-		return true;
+	if (bind->option && bind->option[0] != '\0') {
+		tcc_set_options(s, bind->option);
 	}
-	tcc_set_error(error_buf, "stability contains unsupported token");
-	return false;
+	if (bind->define_name && bind->define_name[0] != '\0') {
+		define_value = bind->define_value ? bind->define_value : "1";
+		tcc_define_symbol(s, bind->define_name, define_value);
+	}
+	if (bind->header && bind->header[0] != '\0') {
+		if (tcc_compile_string(s, bind->header) != 0) {
+			if (error_buf->message[0] == '\0') {
+				tcc_set_error(error_buf, "header compile failed");
+			}
+			return -1;
+		}
+	}
+	if (bind->library && bind->library[0] != '\0') {
+		if (tcc_add_library(s, bind->library) != 0) {
+			tcc_set_error(error_buf, "tcc_add_library failed");
+			return -1;
+		}
+	}
+	return 0;
 }
 
-/* tcc_parse_wrapper_mode: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_wrapper_mode(const char *wrapper_mode, tcc_wrapper_mode_t *out_mode,
-                                   tcc_error_buffer_t *error_buf) {
-	const char *mode = wrapper_mode;
-	char token[32];
-	size_t len;
-	if (!out_mode) {
-		tcc_set_error(error_buf, "wrapper_mode output is required");
-		return false;
-	}
-	if (!mode || mode[0] == '\0') {
-		*out_mode = TCC_WRAPPER_MODE_ROW;
+/* ===== Section: Module Text Range and Perf Map Emission ===== */
+/* Text-range markers compiled around every module; they bound its code for code_size and perf-map sizing. */
+#define TCC_MODULE_TEXT_BEGIN_SYMBOL "__ducktinycc_text_begin"
+#define TCC_MODULE_TEXT_END_SYMBOL "__ducktinycc_text_end"
+
+/* One relocated function symbol collected for perf-map output. */
+typedef struct {
+	const char *name;
+	uintptr_t addr;
+} tcc_perf_map_symbol_t;
+
+/* Collector passed through tcc_list_symbols; keeps only symbols inside [begin, end]. */
+typedef struct {
+	tcc_perf_map_symbol_t *items;
+	idx_t count;
+	idx_t capacity;
+	uintptr_t begin;
+	uintptr_t end;
+	bool oom;
+} tcc_perf_map_collect_t;
+
+/* tcc_perf_map_enabled: true when the bind asks for it or DUCKTINYCC_PERF_MAP is set to a non-"0" value. */
+static bool tcc_perf_map_enabled(const tcc_module_bind_data_t *bind) {
+	const char *env;
+	if (bind && bind->perf_map) {
 		return true;
 	}
-	mode = tcc_skip_space(mode);
-	len = strlen(mode);
-	while (len > 0 && isspace((unsigned char)mode[len - 1])) {
-		len--;
+	env = getenv("DUCKTINYCC_PERF_MAP");
+	return env && env[0] != '\0' && strcmp(env, "0") != 0;
+}
+
+/* tcc_perf_map_collect_cb: tcc_list_symbols callback. Allocation/Lifetime: grows collector storage; names stay owned by TCCState. */
+static void tcc_perf_map_collect_cb(void *ctx, const char *name, const void *val) {
+	tcc_perf_map_collect_t *c = (tcc_perf_map_collect_t *)ctx;
+	uintptr_t addr = (uintptr_t)val;
+	if (!c || !name || c->oom || addr < c->begin || addr > c->end) {
+		return;
 	}
-	if (len == 0 || len >= sizeof(token)) {
-		tcc_set_error(error_buf, "wrapper_mode contains unsupported token");
+	if (c->count == c->capacity) {
+		idx_t new_capacity = c->capacity == 0 ? 16 : c->capacity * 2;
+		tcc_perf_map_symbol_t *grown =
+		    (tcc_perf_map_symbol_t *)duckdb_malloc(sizeof(tcc_perf_map_symbol_t) * (size_t)new_capacity);
+		if (!grown) {
+			c->oom = true;
+			return;
+		}
+		if (c->items) {
+			memcpy(grown, c->items, sizeof(tcc_perf_map_symbol_t) * (size_t)c->count);
+			duckdb_free(c->items);
+		}
+		c->items = grown;
+		c->capacity = new_capacity;
+	}
+	c->items[c->count].name = name;
+	c->items[c->count].addr = addr;
+	c->count++;
+}
+
+/* tcc_perf_map_symbol_cmp: qsort comparator ordering symbols by address; the begin marker sorts last among aliases. */
+static int tcc_perf_map_symbol_cmp(const void *a, const void *b) {
+	const tcc_perf_map_symbol_t *sa = (const tcc_perf_map_symbol_t *)a;
+	const tcc_perf_map_symbol_t *sb = (const tcc_perf_map_symbol_t *)b;
+	bool ma;
+	bool mb;
+	if (sa->addr != sb->addr) {
+		return sa->addr < sb->addr ? -1 : 1;
+	}
+	/* Linker-synthesized bounds (__start_*, __init_array_*, ...) alias the begin marker. Only the last
+	 * symbol of an alias group is emitted, so keep the marker there. */
+	ma = strcmp(sa->name, TCC_MODULE_TEXT_BEGIN_SYMBOL) == 0;
+	mb = strcmp(sb->name, TCC_MODULE_TEXT_BEGIN_SYMBOL) == 0;
+	return ma == mb ? strcmp(sa->name, sb->name) : (ma ? 1 : -1);
+}
+
+/* tcc_module_collect_text_symbols: lists the module's global functions inside the text markers, sorted by address.
+ * Allocation/Lifetime: `c->items` is duckdb_malloc'd and freed by the caller on every path; names stay owned by the
+ * TCCState. Returns false when the markers are missing or on OOM. */
+static bool tcc_module_collect_text_symbols(TCCState *s, tcc_perf_map_collect_t *c) {
+	memset(c, 0, sizeof(*c));
+	c->begin = (uintptr_t)tcc_get_symbol(s, TCC_MODULE_TEXT_BEGIN_SYMBOL);
+	c->end = (uintptr_t)tcc_get_symbol(s, TCC_MODULE_TEXT_END_SYMBOL);
+	if (c->begin == 0 || c->end <= c->begin) {
 		return false;
 	}
-	memcpy(token, mode, len);
-	token[len] = '\0';
-	if (tcc_equals_ci(token, "row")) {
-		*out_mode = TCC_WRAPPER_MODE_ROW;
-		return true;
+	tcc_list_symbols(s, c, tcc_perf_map_collect_cb);
+	if (c->oom) {
+		return false;
 	}
-	if (tcc_equals_ci(token, "chunk_scalar_loop")) {
-		*out_mode = TCC_WRAPPER_MODE_BATCH;
-		return true;
+	if (c->count > 1) {
+		qsort(c->items, (size_t)c->count, sizeof(tcc_perf_map_symbol_t), tcc_perf_map_symbol_cmp);
 	}
-	tcc_set_error(error_buf, "wrapper_mode contains unsupported token");
-	return false;
+	return true;
 }
 
-static char *tcc_next_top_level_part(char **cursor, char sep) {
-	char *start;
-	char *p;
-	int angle_depth = 0;
-	int square_depth = 0;
-	if (!cursor || !*cursor) {
-		return NULL;
-	}
-	start = *cursor;
-	p = start;
-	while (*p) {
-		if (*p == '<') {
-			angle_depth++;
-		} else if (*p == '>') {
-			if (angle_depth > 0) {
-				angle_depth--;
-			}
-		} else if (*p == '[') {
-			square_depth++;
-		} else if (*p == ']') {
-			if (square_depth > 0) {
-				square_depth--;
-			}
-		} else if (*p == sep && angle_depth == 0 && square_depth == 0) {
-			*p = '\0';
-			*cursor = p + 1;
-			return start;
+/* tcc_module_compile_text_marker: compiles one empty marker function used to bound the module's text range. */
+static int tcc_module_compile_text_marker(TCCState *s, const char *marker, tcc_error_buffer_t *error_buf) {
+	char src[128];
+	snprintf(src, sizeof(src), "void %s(void) {}\n", marker);
+	if (tcc_compile_string(s, src) != 0) {
+		if (error_buf->message[0] == '\0') {
+			tcc_set_error(error_buf, "text marker compile failed");
 		}
-		p++;
+		return -1;
 	}
-	*cursor = NULL;
-	return start;
+	return 0;
 }
 
-static char *tcc_find_top_level_char(char *input, char target) {
-	char *p;
-	int angle_depth = 0;
-	int square_depth = 0;
-	if (!input) {
-		return NULL;
+/*
+ * @function tcc_perf_map_emit
+ * @brief Appends `/tmp/perf-<pid>.map` entries for every global function of a relocated module.
+ * @ownership Borrows `s`; symbol names are copied into the map file only.
+ * @heap Temporary symbol array and line buffer, freed before return.
+ * @thread_safety The map is opened in append mode and written with a single fwrite so concurrent
+ *                connections interleave whole blocks, not partial lines.
+ * @errors Best effort: failures never fail the compile, the module simply stays unresolved in perf.
+ *
+ * TinyCC lays out `.text` in compile order, so the module's functions live between the begin marker
+ * (compiled before any session/bind source) and the end marker (compiled last). Each symbol's size is
+ * the distance to the next symbol, which is exact for the contiguous function bodies tcc emits.
+ * Generated wrappers drop their `static` when the perf map is on, so they are listed too.
+ */
+static void tcc_perf_map_emit(TCCState *s, const char *sql_name) {
+#if defined(__linux__)
+	tcc_perf_map_collect_t c;
+	char path[64];
+	char *buf = NULL;
+	size_t buf_len = 0;
+	size_t buf_cap = 0;
+	FILE *fp;
+	idx_t i;
+	if (!tcc_module_collect_text_symbols(s, &c) || c.count == 0) {
+		goto cleanup;
 	}
-	p = input;
-	while (*p) {
-		if (*p == '<') {
-			angle_depth++;
-		} else if (*p == '>') {
-			if (angle_depth > 0) {
-				angle_depth--;
+	for (i = 0; i < c.count; i++) {
+		/* The end marker only bounds the last real symbol; it is not reported itself. */
+		uintptr_t next = i + 1 < c.count ? c.items[i + 1].addr : c.end;
+		const char *name = c.items[i].name;
+		size_t need;
+		if (strcmp(name, TCC_MODULE_TEXT_END_SYMBOL) == 0 || next <= c.items[i].addr) {
+			continue;
+		}
+		/* Static helpers compiled ahead of the first global function land in the begin marker's range. */
+		if (strcmp(name, TCC_MODULE_TEXT_BEGIN_SYMBOL) == 0) {
+			name = "static";
+		}
+		need = strlen(name) + (sql_name ? strlen(sql_name) : 0) + 64;
+		if (buf_len + need > buf_cap) {
+			size_t new_cap = buf_cap == 0 ? 1024 : buf_cap;
+			char *grown;
+			while (buf_len + need > new_cap) {
+				new_cap *= 2;
 			}
-		} else if (*p == '[') {
-			square_depth++;
-		} else if (*p == ']') {
-			if (square_depth > 0) {
-				square_depth--;
+			grown = (char *)duckdb_malloc(new_cap);
+			if (!grown) {
+				goto cleanup;
 			}
-		} else if (*p == target && angle_depth == 0 && square_depth == 0) {
-			return p;
+			if (buf) {
+				memcpy(grown, buf, buf_len);
+				duckdb_free(buf);
+			}
+			buf = grown;
+			buf_cap = new_cap;
 		}
-		p++;
+		buf_len += (size_t)snprintf(buf + buf_len, buf_cap - buf_len, "%llx %llx ducktinycc:%s:%s\n",
+		                            (unsigned long long)c.items[i].addr,
+		                            (unsigned long long)(next - c.items[i].addr), sql_name ? sql_name : "",
+		                            name);
 	}
-	return NULL;
-}
+	if (buf_len == 0) {
+		goto cleanup;
+	}
+	snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+	fp = fopen(path, "a");
+	if (fp) {
+		setvbuf(fp, NULL, _IONBF, 0);
+		fwrite(buf, 1, buf_len, fp);
+		fclose(fp);
+	}
+cleanup:
+	if (buf) {
+		duckdb_free(buf);
+	}
+	if (c.items) {
+		duckdb_free(c.items);
+	}
+#else
+	(void)s;
+	(void)sql_name;
+#endif
+}
 
-/* tcc_parse_type_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_type_token(const char *token, bool allow_void, tcc_ffi_type_t *out_type, size_t *out_array_size) {
-	/* Table-driven lookup for simple type tokens. */
-	static const struct {
-		const char *name;
-		tcc_ffi_type_t type;
-	} simple_tokens[] = {
-	    {"bool", TCC_FFI_BOOL},         {"i8", TCC_FFI_I8},
-	    {"u8", TCC_FFI_U8},             {"i16", TCC_FFI_I16},
-	    {"u16", TCC_FFI_U16},           {"i32", TCC_FFI_I32},
-	    {"u32", TCC_FFI_U32},           {"i64", TCC_FFI_I64},
-	    {"u64", TCC_FFI_U64},           {"f32", TCC_FFI_F32},
-	    {"f64", TCC_FFI_F64},           {"ptr", TCC_FFI_PTR},
-	    {"varchar", TCC_FFI_VARCHAR},   {"blob", TCC_FFI_BLOB},
-	    {"uuid", TCC_FFI_UUID},         {"date", TCC_FFI_DATE},
-	    {"time", TCC_FFI_TIME},         {"timestamp", TCC_FFI_TIMESTAMP},
-	    {"interval", TCC_FFI_INTERVAL}, {"decimal", TCC_FFI_DECIMAL},
-	};
-	size_t token_len;
-	size_t i;
-	if (!token || token[0] == '\0' || !out_type) {
-		return false;
+/* ===== Section: Shared Session Base ===== */
+/* tcc_session_base_release: drops one reference; the last one deletes the relocated base. */
+static void tcc_session_base_release(tcc_session_base_t *base) {
+	idx_t i;
+	if (!base || atomic_fetch_sub_explicit(&base->refs, 1, memory_order_acq_rel) != 1) {
+		return;
 	}
-	token_len = strlen(token);
-	if (out_array_size) {
-		*out_array_size = 0;
+	for (i = 0; i < base->count; i++) {
+		duckdb_free(base->names[i]);
 	}
-	if (allow_void && tcc_equals_ci(token, "void")) {
-		*out_type = TCC_FFI_VOID;
-		return true;
+	if (base->names) {
+		duckdb_free((void *)base->names);
 	}
-	for (i = 0; i < sizeof(simple_tokens) / sizeof(simple_tokens[0]); i++) {
-		if (tcc_equals_ci(token, simple_tokens[i].name)) {
-			*out_type = simple_tokens[i].type;
-			return true;
-		}
+	if (base->addrs) {
+		duckdb_free((void *)base->addrs);
 	}
-	if (token_len > 8 && (token[0] == 's' || token[0] == 'S') && (token[1] == 't' || token[1] == 'T') &&
-	    (token[2] == 'r' || token[2] == 'R') && (token[3] == 'u' || token[3] == 'U') &&
-	    (token[4] == 'c' || token[4] == 'C') && (token[5] == 't' || token[5] == 'T') && token[6] == '<' &&
-	    token[token_len - 1] == '>') {
-		*out_type = TCC_FFI_STRUCT;
-		return true;
+	if (base->tcc) {
+		tcc_delete(base->tcc);
 	}
-	if (token_len > 5 && (token[0] == 'm' || token[0] == 'M') && (token[1] == 'a' || token[1] == 'A') &&
-	    (token[2] == 'p' || token[2] == 'P') && token[3] == '<' && token[token_len - 1] == '>') {
-		*out_type = TCC_FFI_MAP;
-		return true;
+	duckdb_free(base);
+}
+
+/* Collector passed through tcc_list_symbols while building a base. */
+typedef struct {
+	tcc_session_base_t *base;
+	const tcc_session_t *session;
+	bool oom;
+} tcc_session_base_collect_t;
+
+/* tcc_session_base_runtime_name: names every module defines for itself rather than taking from the base: the
+ * implementation-reserved `__x` and `_X` names (libtcc1 helpers, `_GLOBAL_OFFSET_TABLE_`) and the linker's section
+ * bounds. A user global such as `_scale` is none of these. */
+static bool tcc_session_base_runtime_name(const char *name) {
+	if (name[0] != '_') {
+		return false;
 	}
-	if (token_len > 7 && (token[0] == 'u' || token[0] == 'U') && (token[1] == 'n' || token[1] == 'N') &&
-	    (token[2] == 'i' || token[2] == 'I') && (token[3] == 'o' || token[3] == 'O') &&
-	    (token[4] == 'n' || token[4] == 'N') && token[5] == '<' && token[token_len - 1] == '>') {
-		*out_type = TCC_FFI_UNION;
-		return true;
+	return name[1] == '_' || isupper((unsigned char)name[1]) || strcmp(name, "_etext") == 0 ||
+	       strcmp(name, "_edata") == 0 || strcmp(name, "_end") == 0;
+}
+
+/* tcc_session_base_collect_cb: tcc_list_symbols callback keeping the symbols the staged units define. Host symbols and
+ * user symbols are injected into every module anyway, runtime names are defined by each module, and `name@plt` stubs
+ * are private to the state that made them. */
+static void tcc_session_base_collect_cb(void *ctx, const char *name, const void *val) {
+	tcc_session_base_collect_t *c = (tcc_session_base_collect_t *)ctx;
+	tcc_session_base_t *base = c->base;
+	idx_t i;
+	if (c->oom || !name || tcc_session_base_runtime_name(name) || strchr(name, '@') || tcc_is_host_symbol(name)) {
+		return;
 	}
-	if (token_len > 6 && (token[0] == 'l' || token[0] == 'L') && (token[1] == 'i' || token[1] == 'I') &&
-	    (token[2] == 's' || token[2] == 'S') && (token[3] == 't' || token[3] == 'T') && token[4] == '<' &&
-	    token[token_len - 1] == '>') {
-		tcc_ffi_type_t child_type = TCC_FFI_VOID;
-		size_t child_array_size = 0;
-		char *inner = (char *)duckdb_malloc(token_len - 4);
-		if (!inner) {
-			return false;
-		}
-		memcpy(inner, token + 5, token_len - 6);
-		inner[token_len - 6] = '\0';
-		{
-			char *trimmed = tcc_trim_inplace(inner);
-			bool ok = tcc_parse_type_token(trimmed, false, &child_type, &child_array_size) && child_type != TCC_FFI_VOID;
-			duckdb_free(inner);
-			if (!ok) {
-				return false;
-			}
-		}
-		if (tcc_ffi_list_type_from_child(child_type, out_type)) {
-			return true;
+	for (i = 0; i < c->session->symbol_names.count; i++) {
+		if (strcmp(c->session->symbol_names.items[i], name) == 0) {
+			return;
 		}
-		*out_type = TCC_FFI_LIST;
-		return true;
 	}
-	if (token_len > 3 && token[token_len - 1] == ']') {
-		const char *lb = strrchr(token, '[');
-		if (lb && lb < token + token_len - 1 && lb[1] != ']') {
-			uint64_t arr_n = 0;
-			const char *p = lb + 1;
-			bool ok_digits = true;
-			tcc_ffi_type_t child_type = TCC_FFI_VOID;
-			size_t child_array_size = 0;
-			char child_token[64];
-			size_t child_len = (size_t)(lb - token);
-			while (p < token + token_len - 1) {
-				if (!isdigit((unsigned char)*p)) {
-					ok_digits = false;
-					break;
-				}
-				arr_n = arr_n * 10 + (uint64_t)(*p - '0');
-				p++;
+	if (base->count == base->capacity) {
+		idx_t new_cap = base->capacity == 0 ? 32 : base->capacity * 2;
+		char **names = (char **)duckdb_malloc(sizeof(char *) * (size_t)new_cap);
+		void **addrs = (void **)duckdb_malloc(sizeof(void *) * (size_t)new_cap);
+		if (!names || !addrs) {
+			if (names) {
+				duckdb_free((void *)names);
 			}
-			if (ok_digits && arr_n > 0 && arr_n <= (uint64_t)SIZE_MAX && child_len > 0 && child_len < sizeof(child_token)) {
-				memcpy(child_token, token, child_len);
-				child_token[child_len] = '\0';
-				if (tcc_parse_type_token(child_token, false, &child_type, &child_array_size) &&
-				    child_type != TCC_FFI_VOID) {
-					if (!tcc_ffi_array_type_from_child(child_type, out_type)) {
-						*out_type = TCC_FFI_ARRAY;
-					}
-					if (out_array_size) {
-						*out_array_size = (size_t)arr_n;
-					}
-					return true;
-				}
+			if (addrs) {
+				duckdb_free((void *)addrs);
 			}
+			c->oom = true;
+			return;
 		}
-	}
-	if (token_len > 2 && token[token_len - 2] == '[' && token[token_len - 1] == ']') {
-		tcc_ffi_type_t child_type = TCC_FFI_VOID;
-		size_t child_array_size = 0;
-		char child_token[64];
-		size_t child_len = token_len - 2;
-		if (child_len > 0 && child_len < sizeof(child_token)) {
-			memcpy(child_token, token, child_len);
-			child_token[child_len] = '\0';
-			if (tcc_parse_type_token(child_token, false, &child_type, &child_array_size) &&
-			    child_type != TCC_FFI_VOID) {
-				if (!tcc_ffi_list_type_from_child(child_type, out_type)) {
-					*out_type = TCC_FFI_LIST;
-				}
-				return true;
-			}
+		if (base->count > 0) {
+			memcpy(names, base->names, sizeof(char *) * (size_t)base->count);
+			memcpy(addrs, base->addrs, sizeof(void *) * (size_t)base->count);
+			duckdb_free((void *)base->names);
+			duckdb_free((void *)base->addrs);
 		}
+		base->names = names;
+		base->addrs = addrs;
+		base->capacity = new_cap;
 	}
-	return false;
+	base->names[base->count] = tcc_strdup(name);
+	if (!base->names[base->count]) {
+		c->oom = true;
+		return;
+	}
+	base->addrs[base->count] = (void *)val;
+	base->count++;
 }
 
-/* tcc_is_identifier_token: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_is_identifier_token(const char *value) {
-	size_t i;
-	if (!value || value[0] == '\0') {
-		return false;
+/**
+ * @function tcc_session_base_acquire
+ * @brief Returns the relocated base of the session's staged headers and sources, compiling it on first use.
+ * @param[in] runtime_path Effective TinyCC runtime path.
+ * @param[in,out] state Module state caching the base for its current state_id/config_version.
+ * @param[out] out_private Set when the staged units do not link on their own (for example they call a function the
+ *             module source defines); the caller then compiles them into the module as before.
+ * @param[out] error_buf Compile diagnostics of the staged units.
+ * @return A base with one reference for the caller, or NULL on failure or when *out_private is set.
+ * @ownership borrows(runtime_path), transfers(one reference to the caller)
+ * @heap compiles and relocates the staged units once per configuration; an unlinkable configuration is cached as
+ *       a base without code, so it is tried once
+ * @thread_safety callers hold the module state write lock
+ * @errors same diagnostics the staged units produced when compiled into each module
+ */
+static tcc_session_base_t *tcc_session_base_acquire(const char *runtime_path, tcc_module_state_t *state,
+                                                    bool *out_private, tcc_error_buffer_t *error_buf) {
+	tcc_session_base_t *base = state->session_base;
+	tcc_session_base_collect_t collect;
+	*out_private = false;
+	if (base && base->state_id == state->session.state_id &&
+	    base->config_version == state->session.config_version) {
+		if (!base->tcc) {
+			*out_private = true;
+			return NULL;
+		}
+		atomic_fetch_add_explicit(&base->refs, 1, memory_order_relaxed);
+		return base;
 	}
-	if (!(isalpha((unsigned char)value[0]) || value[0] == '_')) {
-		return false;
+	tcc_session_base_release(base);
+	state->session_base = NULL;
+	base = (tcc_session_base_t *)duckdb_malloc(sizeof(tcc_session_base_t));
+	if (!base) {
+		tcc_set_error(error_buf, "out of memory");
+		return NULL;
 	}
-	for (i = 1; value[i] != '\0'; i++) {
-		if (!(isalnum((unsigned char)value[i]) || value[i] == '_')) {
-			return false;
-		}
+	memset(base, 0, sizeof(tcc_session_base_t));
+	atomic_init(&base->refs, 1);
+	base->state_id = state->session.state_id;
+	base->config_version = state->session.config_version;
+	base->tcc = tcc_new();
+	if (!base->tcc) {
+		tcc_session_base_release(base);
+		tcc_set_error(error_buf, "tcc_new failed");
+		return NULL;
 	}
-	return true;
+	/* Same setup as tcc_build_module_artifact (lib path before the output type). */
+	if (runtime_path && runtime_path[0] != '\0') {
+		tcc_set_lib_path(base->tcc, runtime_path);
+	}
+	tcc_set_error_func(base->tcc, error_buf, tcc_append_error);
+	tcc_set_options(base->tcc, "-nostdlib");
+	if (tcc_set_output_type(base->tcc, TCC_OUTPUT_MEMORY) != 0) {
+		tcc_session_base_release(base);
+		tcc_set_error(error_buf, "tcc_set_output_type failed");
+		return NULL;
+	}
+	tcc_configure_runtime_paths(base->tcc, runtime_path);
+	tcc_add_host_symbols(base->tcc);
+	if (tcc_apply_session_to_state(base->tcc, &state->session, NULL, error_buf) != 0) {
+		tcc_session_base_release(base);
+		return NULL;
+	}
+	if (tcc_relocate(base->tcc) != 0) {
+		/* The units compiled but reference symbols only a module supplies: remember that and compile them
+		 * privately, where those references resolve (or fail with the module's own diagnostics). */
+		tcc_delete(base->tcc);
+		base->tcc = NULL;
+		error_buf->message[0] = '\0';
+		state->session_base = base;
+		*out_private = true;
+		return NULL;
+	}
+	memset(&collect, 0, sizeof(collect));
+	collect.base = base;
+	collect.session = &state->session;
+	tcc_list_symbols(base->tcc, &collect, tcc_session_base_collect_cb);
+	if (collect.oom) {
+		tcc_session_base_release(base);
+		tcc_set_error(error_buf, "out of memory");
+		return NULL;
+	}
+	state->session_base = base;
+	atomic_fetch_add_explicit(&base->refs, 1, memory_order_relaxed);
+	return base;
 }
 
-/* tcc_split_csv_tokens: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_split_csv_tokens(const char *csv, tcc_string_list_t *out_tokens, tcc_error_buffer_t *error_buf) {
-	char *copy;
-	char *cursor;
-	if (!out_tokens) {
-		tcc_set_error(error_buf, "token output is required");
-		return false;
+/* tcc_bind_overrides_units: per-call options, defines, include paths or headers change how staged sources compile. */
+static bool tcc_bind_overrides_units(const tcc_module_bind_data_t *bind) {
+	return (bind->option && bind->option[0] != '\0') || (bind->define_name && bind->define_name[0] != '\0') ||
+	       (bind->include_path && bind->include_path[0] != '\0') ||
+	       (bind->sysinclude_path && bind->sysinclude_path[0] != '\0') || (bind->header && bind->header[0] != '\0');
+}
+
+/* ===== Section: Cross-Module Imports (import_from) ===== */
+/* Symbols `import_from` pulls out of earlier artifacts, and the artifacts they pin. */
+typedef struct {
+	tcc_string_list_t names;
+	void **addrs;
+	idx_t addr_capacity;
+	tcc_registered_artifact_t **pinned;
+	idx_t pinned_count;
+	/* Set when two imported modules export one name at different addresses (borrowed from `names`). */
+	const char *conflict;
+	bool oom;
+} tcc_import_set_t;
+
+/* tcc_import_set_destroy: drops the pins and symbol copies. Pins already moved to an artifact are not touched. */
+static void tcc_import_set_destroy(tcc_import_set_t *set) {
+	idx_t i;
+	for (i = 0; i < set->pinned_count; i++) {
+		tcc_artifact_destroy(set->pinned[i]);
 	}
-	memset(out_tokens, 0, sizeof(*out_tokens));
-	if (!csv || csv[0] == '\0') {
-		return true;
+	if (set->pinned) {
+		duckdb_free((void *)set->pinned);
 	}
-	copy = tcc_strdup(csv);
-	if (!copy) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+	if (set->addrs) {
+		duckdb_free((void *)set->addrs);
 	}
-	cursor = copy;
-	while (cursor) {
-		char *token;
-		char *part = tcc_next_top_level_part(&cursor, ',');
-		token = tcc_trim_inplace(part);
-		if (token[0] == '\0') {
-			duckdb_free(copy);
-			tcc_string_list_destroy(out_tokens);
-			tcc_set_error(error_buf, "arg_types contains an empty token");
-			return false;
+	tcc_string_list_destroy(&set->names);
+	memset(set, 0, sizeof(*set));
+}
+
+/* tcc_import_set_add: records one exported symbol; a name seen again must resolve to the same address. */
+static void tcc_import_set_add(tcc_import_set_t *set, const char *name, void *addr) {
+	idx_t i;
+	for (i = 0; i < set->names.count; i++) {
+		if (strcmp(set->names.items[i], name) == 0) {
+			if (set->addrs[i] != addr && !set->conflict) {
+				set->conflict = set->names.items[i];
+			}
+			return;
 		}
-		if (!tcc_string_list_append(out_tokens, token)) {
-			duckdb_free(copy);
-			tcc_string_list_destroy(out_tokens);
-			tcc_set_error(error_buf, "out of memory");
-			return false;
+	}
+	if (!tcc_string_list_append(&set->names, name)) {
+		set->oom = true;
+		return;
+	}
+	if (set->names.capacity > set->addr_capacity) {
+		void **addrs = (void **)duckdb_malloc(sizeof(void *) * (size_t)set->names.capacity);
+		if (!addrs) {
+			(void)tcc_string_list_pop_last(&set->names);
+			set->oom = true;
+			return;
+		}
+		if (set->addrs) {
+			memcpy(addrs, set->addrs, sizeof(void *) * (size_t)(set->names.count - 1));
+			duckdb_free((void *)set->addrs);
 		}
+		set->addrs = addrs;
+		set->addr_capacity = set->names.capacity;
 	}
-	duckdb_free(copy);
-	return true;
+	set->addrs[set->names.count - 1] = addr;
 }
 
-/* tcc_parse_c_field_spec_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_c_field_spec_token(const char *token, bool force_bitfield, tcc_c_field_spec_t *out_field,
-                                         tcc_error_buffer_t *error_buf) {
-	char *copy;
-	char *type_part;
-	char *opts_part = NULL;
-	char *sep;
-	char *name;
-	char *type_token;
-	tcc_ffi_type_t parsed_type = TCC_FFI_VOID;
-	tcc_ffi_type_t child_type = TCC_FFI_VOID;
-	size_t array_size = 0;
-	bool is_bitfield = force_bitfield;
-	if (!token || !out_field) {
-		tcc_set_error(error_buf, "invalid c field specification");
-		return false;
+/* tcc_import_collect_cb: tcc_list_symbols callback taking every exported global except host, runtime and PLT names;
+ * a user global such as `_scale` is exported like any other. */
+static void tcc_import_collect_cb(void *ctx, const char *name, const void *val) {
+	tcc_import_set_t *set = (tcc_import_set_t *)ctx;
+	if (set->oom || !name || tcc_session_base_runtime_name(name) || strchr(name, '@') || tcc_is_host_symbol(name)) {
+		return;
 	}
-	memset(out_field, 0, sizeof(*out_field));
-	copy = tcc_strdup(token);
-	if (!copy) {
-		tcc_set_error(error_buf, "out of memory");
+	tcc_import_set_add(set, name, (void *)val);
+}
+
+/**
+ * @function tcc_import_set_resolve
+ * @brief Resolves `import_from` entries ('module' or 'module:symbol') against registered artifacts.
+ * @param[in] state Module state whose registry is searched by SQL name, then by module symbol.
+ * @param[in] import_csv CSV of entries; 'module' imports every exported global, 'module:symbol' one symbol.
+ * @param[out] set Receives the symbols and one pin per distinct exporting artifact.
+ * @param[out] error_buf Error buffer for unknown modules/symbols and conflicts.
+ * @return true on success; on failure the set is emptied and its pins released.
+ * @ownership borrows(state, import_csv), transfers(pins to set)
+ * @thread_safety callers hold the module state write lock
+ */
+static bool tcc_import_set_resolve(tcc_module_state_t *state, const char *import_csv, tcc_import_set_t *set,
+                                   tcc_error_buffer_t *error_buf) {
+	tcc_string_list_t entries;
+	idx_t i;
+	bool ok = true;
+	memset(&entries, 0, sizeof(entries));
+	if (!tcc_split_csv_tokens(import_csv, &entries, error_buf)) {
 		return false;
 	}
-	sep = strchr(copy, ':');
-	if (!sep) {
-		duckdb_free(copy);
-		tcc_set_error(error_buf, "field spec must use name:type or name:type:bitfield");
+	set->pinned = entries.count > 0
+	                  ? (tcc_registered_artifact_t **)duckdb_malloc(sizeof(tcc_registered_artifact_t *) *
+	                                                                (size_t)entries.count)
+	                  : NULL;
+	if (entries.count > 0 && !set->pinned) {
+		tcc_string_list_destroy(&entries);
+		tcc_set_error(error_buf, "out of memory");
 		return false;
 	}
-	*sep = '\0';
-	type_part = sep + 1;
-	sep = strchr(type_part, ':');
-	if (sep) {
-		*sep = '\0';
-		opts_part = sep + 1;
+	for (i = 0; i < entries.count && ok; i++) {
+		char *module = entries.items[i];
+		char *symbol = strchr(module, ':');
+		tcc_registered_artifact_t *artifact = NULL;
+		idx_t idx;
+		idx_t p;
+		bool pinned;
+		if (symbol) {
+			*symbol++ = '\0';
+		}
+		idx = tcc_registry_find_sql_name(state, module);
+		for (p = 0; idx == (idx_t)-1 && p < state->entry_count; p++) {
+			if (state->entries[p].symbol && strcmp(state->entries[p].symbol, module) == 0) {
+				idx = p;
+			}
+		}
+		artifact = idx != (idx_t)-1 ? state->entries[idx].artifact : NULL;
+		if (artifact && artifact->rebuilt) {
+			/* Link against the current code of a module rebuilt from `source_file`. */
+			artifact = artifact->rebuilt;
+		}
+		if (!artifact || !artifact->tcc) {
+			tcc_set_error(error_buf, "import_from names a module that is not registered");
+			ok = false;
+			continue;
+		}
+		if (symbol) {
+			void *addr = symbol[0] != '\0' ? tcc_get_symbol(artifact->tcc, symbol) : NULL;
+			if (!addr) {
+				tcc_set_error(error_buf, "import_from symbol is not defined by that module");
+				ok = false;
+				continue;
+			}
+			tcc_import_set_add(set, symbol, addr);
+		} else {
+			tcc_list_symbols(artifact->tcc, set, tcc_import_collect_cb);
+		}
+		pinned = false;
+		for (p = 0; p < set->pinned_count && !pinned; p++) {
+			pinned = set->pinned[p] == artifact;
+		}
+		if (!pinned) {
+			atomic_fetch_add_explicit(&artifact->refs, 1, memory_order_relaxed);
+			set->pinned[set->pinned_count++] = artifact;
+		}
+		if (set->oom) {
+			tcc_set_error(error_buf, "out of memory");
+			ok = false;
+		} else if (set->conflict) {
+			char msg[256];
+			snprintf(msg, sizeof(msg), "import_from modules export '%s' at different addresses", set->conflict);
+			tcc_set_error(error_buf, msg);
+			ok = false;
+		}
 	}
-	name = tcc_trim_inplace(copy);
-	type_token = tcc_trim_inplace(type_part);
-	if (!tcc_is_identifier_token(name)) {
-		duckdb_free(copy);
-		tcc_set_error(error_buf, "field name must be a valid identifier");
-		return false;
+	tcc_string_list_destroy(&entries);
+	if (!ok) {
+		tcc_import_set_destroy(set);
 	}
-	if (!tcc_parse_type_token(type_token, false, &parsed_type, &array_size)) {
-		duckdb_free(copy);
-		tcc_set_error(error_buf, "field type token is unsupported");
-		return false;
+	return ok;
+}
+
+/* tcc_import_set_apply: adds the imported symbols to a module state, skipping names the shared base or user
+ * symbols already define there. */
+static int tcc_import_set_apply(TCCState *s, const tcc_import_set_t *set, const tcc_session_t *session,
+                                const tcc_session_base_t *base, tcc_error_buffer_t *error_buf) {
+	idx_t i;
+	idx_t j;
+	for (i = 0; i < set->names.count; i++) {
+		const char *name = set->names.items[i];
+		bool known = false;
+		for (j = 0; base && j < base->count && !known; j++) {
+			known = strcmp(base->names[j], name) == 0;
+		}
+		for (j = 0; j < session->symbol_names.count && !known; j++) {
+			known = strcmp(session->symbol_names.items[j], name) == 0;
+		}
+		if (!known && tcc_add_symbol(s, name, set->addrs[i]) != 0) {
+			tcc_set_error(error_buf, "tcc_add_symbol failed for imported symbol");
+			return -1;
+		}
 	}
-	if (opts_part) {
-		char *opt = tcc_trim_inplace(opts_part);
-		if (opt[0] != '\0') {
-			if (tcc_equals_ci(opt, "bitfield")) {
-				is_bitfield = true;
-			} else {
-				duckdb_free(copy);
-				tcc_set_error(error_buf, "field option is unsupported (expected bitfield)");
-				return false;
-			}
+	return 0;
+}
+
+/* Builds and relocates one TinyCC module artifact, returning its init symbol wrapper. */
+static int tcc_build_module_artifact(const char *runtime_path, tcc_module_state_t *state,
+                                     const tcc_module_bind_data_t *bind, const char *module_symbol,
+                                     const char *module_name, tcc_registered_artifact_t **out_artifact,
+                                     tcc_error_buffer_t *error_buf, tcc_compile_timings_t *timings) {
+	TCCState *s;
+	void *sym;
+	bool perf_map;
+	uint64_t code_size = 0;
+	uint64_t t_phase = tcc_now_ns();
+	uint64_t t_now;
+	tcc_registered_artifact_t *artifact;
+	tcc_session_base_t *base = NULL;
+	tcc_import_set_t imports;
+	if (!module_symbol || module_symbol[0] == '\0') {
+		tcc_set_error(error_buf, "module symbol is required");
+		return -1;
+	}
+	if (!module_name || module_name[0] == '\0') {
+		tcc_set_error(error_buf, "module name is required");
+		return -1;
+	}
+	if (state->session.sources.count == 0 && (!bind->source || bind->source[0] == '\0')) {
+		tcc_set_error(error_buf, "no source provided (use add_source/source)");
+		return -1;
+	}
+	memset(&imports, 0, sizeof(imports));
+
+	s = tcc_new();
+	if (!s) {
+		tcc_set_error(error_buf, "tcc_new failed");
+		return -1;
+	}
+	/* Set lib_path BEFORE tcc_set_output_type: tcc_set_output_type eagerly
+	 * expands {B} in CONFIG_TCC_SYSINCLUDEPATHS via tcc_split_path().  If we
+	 * wait until tcc_configure_runtime_paths (called after set_output_type),
+	 * {B} resolves to CONFIG_TCCDIR (the TinyCC install dir used at build
+	 * time, which does not exist on end-user machines) instead of our
+	 * embedded-runtime extraction directory. */
+	if (runtime_path && runtime_path[0] != '\0') {
+		tcc_set_lib_path(s, runtime_path);
+	}
+	tcc_set_error_func(s, error_buf, tcc_append_error);
+	/* Use -nostdlib so TinyCC does not attempt to locate and link libc.so at
+	 * relocation time.  In TCC_OUTPUT_MEMORY mode all undefined symbols are
+	 * resolved from the host process via dlsym(RTLD_DEFAULT, ...), so the
+	 * shared-library file is never needed.  Without this flag, compiling on a
+	 * machine that has no C development files installed (e.g. a bare Ubuntu
+	 * runtime with no libc6-dev) would produce "library 'c' not found" even
+	 * for code that uses no libc functions at all. */
+	tcc_set_options(s, "-nostdlib");
+	if (tcc_set_output_type(s, TCC_OUTPUT_MEMORY) != 0) {
+		tcc_set_error(error_buf, "tcc_set_output_type failed");
+		goto fail;
+	}
+	tcc_configure_runtime_paths(s, runtime_path);
+	tcc_add_host_symbols(s);
+	perf_map = tcc_perf_map_enabled(bind);
+	if (tcc_module_compile_text_marker(s, TCC_MODULE_TEXT_BEGIN_SYMBOL, error_buf) != 0) {
+		goto fail;
+	}
+	TCC_TIMINGS_LAP(timings, setup_ns, t_phase, t_now);
+	/* Staged sources compile once per configuration; per-call options and defines would change them, so those
+	 * compiles keep the private copy. */
+	if (state->session.sources.count > 0 && !tcc_bind_overrides_units(bind)) {
+		bool private_units = false;
+		base = tcc_session_base_acquire(runtime_path, state, &private_units, error_buf);
+		if (!base && !private_units) {
+			goto fail;
 		}
 	}
-	if (tcc_ffi_type_is_array(parsed_type)) {
-		if (!tcc_ffi_array_child_type(parsed_type, &child_type) || array_size == 0) {
-			duckdb_free(copy);
-			tcc_set_error(error_buf, "array field type is invalid");
-			return false;
+	if (tcc_apply_session_to_state(s, &state->session, base, error_buf) != 0) {
+		goto fail;
+	}
+	if (tcc_apply_bind_overrides_to_state(s, bind, error_buf) != 0) {
+		goto fail;
+	}
+	if (bind->import_from && bind->import_from[0] != '\0' &&
+	    (!tcc_import_set_resolve(state, bind->import_from, &imports, error_buf) ||
+	     tcc_import_set_apply(s, &imports, &state->session, base, error_buf) != 0)) {
+		goto fail;
+	}
+	TCC_TIMINGS_LAP(timings, session_ns, t_phase, t_now);
+	if (bind->source && bind->source[0] != '\0') {
+		if (tcc_compile_string(s, bind->source) != 0) {
+			if (error_buf->message[0] == '\0') {
+				tcc_set_error(error_buf, "source compile failed");
+			}
+			goto fail;
 		}
-		if (is_bitfield) {
-			duckdb_free(copy);
-			tcc_set_error(error_buf, "bitfield option cannot be used with array fields");
-			return false;
+	}
+	if (tcc_module_compile_text_marker(s, TCC_MODULE_TEXT_END_SYMBOL, error_buf) != 0) {
+		goto fail;
+	}
+	TCC_TIMINGS_LAP(timings, compile_ns, t_phase, t_now);
+	if (tcc_relocate(s) != 0) {
+		if (error_buf->message[0] == '\0') {
+			tcc_set_error(error_buf, "tcc_relocate failed");
 		}
-		parsed_type = child_type;
-	} else {
-		array_size = 0;
+		goto fail;
 	}
-	if (!(tcc_ffi_type_is_fixed_width_scalar(parsed_type) || parsed_type == TCC_FFI_PTR)) {
-		duckdb_free(copy);
-		tcc_set_error(error_buf,
-		              "fields currently support fixed-width scalar/pointer tokens only (no varchar/blob/nested)");
-		return false;
+	sym = tcc_get_symbol(s, module_symbol);
+	if (!sym) {
+		tcc_set_error(error_buf, "module symbol not found after relocation");
+		goto fail;
 	}
-	out_field->name = tcc_strdup(name);
-	out_field->type = parsed_type;
-	out_field->array_size = array_size;
-	out_field->is_bitfield = is_bitfield;
-	duckdb_free(copy);
-	if (!out_field->name) {
+	TCC_TIMINGS_LAP(timings, relocate_ns, t_phase, t_now);
+	if (perf_map) {
+		tcc_perf_map_emit(s, module_name);
+	}
+	{
+		uintptr_t text_begin = (uintptr_t)tcc_get_symbol(s, TCC_MODULE_TEXT_BEGIN_SYMBOL);
+		uintptr_t text_end = (uintptr_t)tcc_get_symbol(s, TCC_MODULE_TEXT_END_SYMBOL);
+		code_size = text_begin != 0 && text_end > text_begin ? (uint64_t)(text_end - text_begin) : 0;
+	}
+
+	artifact = (tcc_registered_artifact_t *)duckdb_malloc(sizeof(tcc_registered_artifact_t));
+	if (!artifact) {
 		tcc_set_error(error_buf, "out of memory");
-		return false;
+		goto fail;
 	}
-	return true;
+	memset(artifact, 0, sizeof(tcc_registered_artifact_t));
+	artifact->tcc = s;
+	artifact->is_module = true;
+	artifact->module_init = (tcc_dynamic_init_fn_t)sym;
+	artifact->sql_name = tcc_strdup(module_name);
+	artifact->symbol = tcc_strdup(module_symbol);
+	artifact->state_id = state->session.state_id;
+	artifact->code_size = code_size;
+	artifact->base = base;
+	atomic_init(&artifact->refs, 1);
+	/* The pins move to the artifact; the symbol copies were only needed while linking. */
+	artifact->imports = imports.pinned;
+	artifact->import_count = imports.pinned_count;
+	imports.pinned = NULL;
+	imports.pinned_count = 0;
+	tcc_import_set_destroy(&imports);
+	if (!artifact->module_init || !artifact->sql_name || !artifact->symbol) {
+		tcc_artifact_destroy(artifact);
+		tcc_set_error(error_buf, "invalid module artifact or out of memory");
+		return -1;
+	}
+	*out_artifact = artifact;
+	return 0;
+
+fail:
+	tcc_delete(s);
+	tcc_session_base_release(base);
+	tcc_import_set_destroy(&imports);
+	return -1;
 }
+#endif
 
-/* tcc_parse_c_field_specs: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_c_field_specs(const char *arg_types_csv, bool force_bitfield, tcc_c_field_list_t *out_fields,
-                                    tcc_error_buffer_t *error_buf) {
-	tcc_string_list_t tokens;
+/* Finds compiled-artifact registry index by SQL function name. */
+static idx_t tcc_registry_find_sql_name(tcc_module_state_t *state, const char *sql_name) {
 	idx_t i;
-	if (!out_fields) {
-		tcc_set_error(error_buf, "field output is required");
-		return false;
-	}
-	memset(out_fields, 0, sizeof(*out_fields));
-	if (!tcc_split_csv_tokens(arg_types_csv, &tokens, error_buf)) {
-		return false;
-	}
-	if (tokens.count == 0) {
-		tcc_string_list_destroy(&tokens);
-		tcc_set_error(error_buf, "arg_types is required for c_struct/c_union/c_bitfield");
-		return false;
+	if (!state || !sql_name) {
+		return (idx_t)-1;
 	}
-	for (i = 0; i < tokens.count; i++) {
-		tcc_c_field_spec_t field;
-		memset(&field, 0, sizeof(field));
-		if (!tcc_parse_c_field_spec_token(tokens.items[i], force_bitfield, &field, error_buf) ||
-		    !tcc_c_field_list_append(out_fields, &field)) {
-			if (field.name) {
-				duckdb_free(field.name);
-			}
-			tcc_string_list_destroy(&tokens);
-			tcc_c_field_list_destroy(out_fields);
-			if (!error_buf || error_buf->message[0] == '\0') {
-				tcc_set_error(error_buf, "out of memory");
-			}
-			return false;
+	for (i = 0; i < state->entry_count; i++) {
+		if (state->entries[i].sql_name && strcmp(state->entries[i].sql_name, sql_name) == 0) {
+			return i;
 		}
 	}
-	tcc_string_list_destroy(&tokens);
-	return true;
+	return (idx_t)-1;
 }
 
-/* tcc_parse_c_enum_constants: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_c_enum_constants(const char *arg_types_csv, tcc_string_list_t *out_constants,
-                                       tcc_error_buffer_t *error_buf) {
-	idx_t i;
-	if (!tcc_split_csv_tokens(arg_types_csv, out_constants, error_buf)) {
-		return false;
+/* Ensures registry storage capacity for compiled artifact metadata. */
+static bool tcc_registry_reserve(tcc_module_state_t *state, idx_t wanted) {
+	tcc_registered_entry_t *new_entries;
+	idx_t new_capacity;
+	if (state->entry_capacity >= wanted) {
+		return true;
 	}
-	if (out_constants->count == 0) {
-		tcc_set_error(error_buf, "arg_types must list at least one enum constant");
-		tcc_string_list_destroy(out_constants);
+	new_capacity = state->entry_capacity == 0 ? 8 : state->entry_capacity * 2;
+	while (new_capacity < wanted) {
+		new_capacity *= 2;
+	}
+	new_entries = (tcc_registered_entry_t *)duckdb_malloc(sizeof(tcc_registered_entry_t) * new_capacity);
+	if (!new_entries) {
 		return false;
 	}
-	for (i = 0; i < out_constants->count; i++) {
-		if (!tcc_is_identifier_token(out_constants->items[i])) {
-			tcc_set_error(error_buf, "enum constants must be valid identifiers");
-			tcc_string_list_destroy(out_constants);
-			return false;
-		}
+	memset(new_entries, 0, sizeof(tcc_registered_entry_t) * new_capacity);
+	if (state->entries && state->entry_count > 0) {
+		memcpy(new_entries, state->entries, sizeof(tcc_registered_entry_t) * state->entry_count);
+		duckdb_free(state->entries);
 	}
+	state->entries = new_entries;
+	state->entry_capacity = new_capacity;
 	return true;
 }
 
-/* tcc_parse_composite_fields_inner: Shared parser for struct/union field lists.
-   Parses semicolon-delimited `name:type` fields from an already-extracted inner string.
-   If allow_auto_names is true (struct), unnamed fields get auto-generated names (f1, f2, ...).
-   If false (union), a colon-separated name is required.
-   Outputs are allocated arrays that caller must free on failure via the fail label pattern. */
-static bool tcc_parse_composite_fields_inner(char *inner, bool allow_auto_names, const char *kind_label,
-                                             int *out_count, char ***out_names, char ***out_tokens,
-                                             tcc_ffi_type_t **out_types, size_t **out_sizes,
-                                             tcc_error_buffer_t *error_buf) {
-	char *cur = inner;
+/* Releases metadata (and underlying artifacts) for one registry entry. */
+static void tcc_registry_entry_destroy_metadata(tcc_registered_entry_t *entry) {
+	if (!entry) {
+		return;
+	}
+	if (entry->sql_name) {
+		duckdb_free(entry->sql_name);
+		entry->sql_name = NULL;
+	}
+	if (entry->symbol) {
+		duckdb_free(entry->symbol);
+		entry->symbol = NULL;
+	}
+	entry->state_id = 0;
+	entry->from_file = false;
+	entry->input_hash = 0;
+	entry->signature_hash = 0;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (entry->artifact) {
+		tcc_artifact_destroy(entry->artifact);
+	}
+	entry->artifact = NULL;
+#endif
+}
+
+/* Inserts/replaces compiled artifact metadata for one SQL function name. */
+static bool tcc_registry_store_metadata(tcc_module_state_t *state, const char *sql_name, const char *symbol,
+                                        uint64_t state_id
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+                                        , tcc_registered_artifact_t *artifact
+#endif
+) {
+	idx_t idx = tcc_registry_find_sql_name(state, sql_name);
+	tcc_registered_entry_t *entry;
+	if (idx == (idx_t)-1) {
+		if (!tcc_registry_reserve(state, state->entry_count + 1)) {
+			return false;
+		}
+		idx = state->entry_count++;
+	}
+	entry = &state->entries[idx];
+	tcc_registry_entry_destroy_metadata(entry);
+	entry->sql_name = tcc_strdup(sql_name);
+	entry->symbol = tcc_strdup(symbol);
+	entry->state_id = state_id;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	entry->artifact = artifact;
+#endif
+	if (!entry->sql_name || !entry->symbol) {
+		tcc_registry_entry_destroy_metadata(entry);
+		return false;
+	}
+	return true;
+}
+
+/* Destructor for table-function extra info (`tcc_module_state_t`). */
+static void destroy_tcc_module_state(void *ptr) {
+	tcc_module_state_t *state = (tcc_module_state_t *)ptr;
+	idx_t i;
+	if (!state) {
+		return;
+	}
+	for (i = 0; i < state->entry_count; i++) {
+		tcc_registry_entry_destroy_metadata(&state->entries[i]);
+	}
+	if (state->entries) {
+		duckdb_free(state->entries);
+	}
+	tcc_compile_stats_clear(state);
+	if (state->ptr_registry) {
+		tcc_ptr_registry_unref(state->ptr_registry);
+		state->ptr_registry = NULL;
+	}
+	if (state->session.runtime_path) {
+		duckdb_free(state->session.runtime_path);
+	}
+	tcc_session_clear_build_state(&state->session);
+	tcc_file_readers_destroy(state);
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	for (i = 0; i < state->stranded_count; i++) {
+		tcc_artifact_destroy(state->stranded[i]);
+	}
+	tcc_session_base_release(state->session_base);
+#endif
+	if (state->stranded) {
+		duckdb_free((void *)state->stranded);
+	}
+	duckdb_free(state);
+}
+
+/* Destructor for per-invocation bind payload of `tcc_module(...)`. */
+static void destroy_tcc_module_bind_data(void *ptr) {
+	tcc_module_bind_data_t *bind = (tcc_module_bind_data_t *)ptr;
+	if (!bind) {
+		return;
+	}
+	if (bind->mode) {
+		duckdb_free(bind->mode);
+	}
+	if (bind->runtime_path) {
+		duckdb_free(bind->runtime_path);
+	}
+	if (bind->source) {
+		duckdb_free(bind->source);
+	}
+	if (bind->symbol) {
+		duckdb_free(bind->symbol);
+	}
+	if (bind->sql_name) {
+		duckdb_free(bind->sql_name);
+	}
+	if (bind->arg_types) {
+		duckdb_free(bind->arg_types);
+	}
+	if (bind->return_type) {
+		duckdb_free(bind->return_type);
+	}
+	if (bind->wrapper_mode) {
+		duckdb_free(bind->wrapper_mode);
+	}
+	if (bind->stability) {
+		duckdb_free(bind->stability);
+	}
+	if (bind->symbols) {
+		duckdb_free(bind->symbols);
+	}
+	if (bind->expr) {
+		duckdb_free(bind->expr);
+	}
+	if (bind->isolation) {
+		duckdb_free(bind->isolation);
+	}
+	if (bind->specialize) {
+		duckdb_free(bind->specialize);
+	}
+	if (bind->type_params) {
+		duckdb_free(bind->type_params);
+	}
+	if (bind->used) {
+		duckdb_free(bind->used);
+	}
+	if (bind->source_file) {
+		duckdb_free(bind->source_file);
+	}
+	if (bind->import_from) {
+		duckdb_free(bind->import_from);
+	}
+	if (bind->include_path) {
+		duckdb_free(bind->include_path);
+	}
+	if (bind->sysinclude_path) {
+		duckdb_free(bind->sysinclude_path);
+	}
+	if (bind->library_path) {
+		duckdb_free(bind->library_path);
+	}
+	if (bind->library) {
+		duckdb_free(bind->library);
+	}
+	if (bind->option) {
+		duckdb_free(bind->option);
+	}
+	if (bind->header) {
+		duckdb_free(bind->header);
+	}
+	if (bind->define_name) {
+		duckdb_free(bind->define_name);
+	}
+	if (bind->define_value) {
+		duckdb_free(bind->define_value);
+	}
+	if (bind->symbol_name) {
+		duckdb_free(bind->symbol_name);
+	}
+	duckdb_free(bind);
+}
+
+/* Destructor for per-scan init payload of `tcc_module(...)`. */
+static void destroy_tcc_module_init_data(void *ptr) {
+	tcc_module_init_data_t *init = (tcc_module_init_data_t *)ptr;
+	if (!init) {
+		return;
+	}
+	duckdb_free(init);
+}
+
+/* Reads optional named VARCHAR bind parameter as owned C string. */
+static void tcc_bind_read_named_varchar(duckdb_bind_info info, const char *name, char **out_value) {
+	duckdb_value value = duckdb_bind_get_named_parameter(info, name);
+	if (value && !duckdb_is_null_value(value)) {
+		*out_value = duckdb_get_varchar(value);
+	}
+	if (value) {
+		duckdb_destroy_value(&value);
+	}
+}
+
+/* Reads a LIST(VARCHAR) named parameter (`arg_types`, `symbols`), normalizing LIST/ARRAY inputs into a CSV token string. */
+static void tcc_bind_read_named_list_csv(duckdb_bind_info info, const char *name, char **out_csv) {
+	duckdb_value value = duckdb_bind_get_named_parameter(info, name);
+	if (!value || duckdb_is_null_value(value)) {
+		if (value) {
+			duckdb_destroy_value(&value);
+		}
+		return;
+	}
+	duckdb_logical_type vtype = duckdb_get_value_type(value);
+	duckdb_type type_id = duckdb_get_type_id(vtype);
+	if (type_id == DUCKDB_TYPE_LIST || type_id == DUCKDB_TYPE_ARRAY) {
+		idx_t n = duckdb_get_list_size(value);
+		idx_t i;
+		size_t total = 0;
+		char *buf;
+		size_t off = 0;
+		for (i = 0; i < n; i++) {
+			duckdb_value child = duckdb_get_list_child(value, i);
+			char *txt = duckdb_get_varchar(child);
+			size_t len = txt ? strlen(txt) : 0;
+			total += len + (i > 0 ? 1 : 0);
+			if (txt) {
+				duckdb_free(txt);
+			}
+			duckdb_destroy_value(&child);
+		}
+		buf = (char *)duckdb_malloc(total + 1);
+		if (!buf) {
+			duckdb_destroy_value(&value);
+			return;
+		}
+		buf[0] = '\0';
+		for (i = 0; i < n; i++) {
+			duckdb_value child = duckdb_get_list_child(value, i);
+			char *txt = duckdb_get_varchar(child);
+			if (i > 0) {
+				buf[off++] = ',';
+			}
+			if (txt) {
+				size_t len = strlen(txt);
+				memcpy(buf + off, txt, len);
+				off += len;
+				duckdb_free(txt);
+			}
+			duckdb_destroy_value(&child);
+		}
+		buf[off] = '\0';
+		*out_csv = buf;
+	}
+	duckdb_destroy_value(&value);
+}
+
+/* Adds the shared one-row status columns (ok, mode, phase, code, ..., timings, bench) to a bind. */
+static void tcc_module_bind_add_result_columns(duckdb_bind_info info) {
+	duckdb_logical_type bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
+	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_logical_type timings_type = tcc_compile_timings_create_type();
+	duckdb_logical_type bench_type = tcc_bench_create_type();
+
+	duckdb_bind_add_result_column(info, "ok", bool_type);
+	duckdb_bind_add_result_column(info, "mode", varchar_type);
+	duckdb_bind_add_result_column(info, "phase", varchar_type);
+	duckdb_bind_add_result_column(info, "code", varchar_type);
+	duckdb_bind_add_result_column(info, "message", varchar_type);
+	duckdb_bind_add_result_column(info, "detail", varchar_type);
+	duckdb_bind_add_result_column(info, "sql_name", varchar_type);
+	duckdb_bind_add_result_column(info, "symbol", varchar_type);
+	duckdb_bind_add_result_column(info, "artifact_id", varchar_type);
+	duckdb_bind_add_result_column(info, "connection_scope", varchar_type);
+	duckdb_bind_add_result_column(info, "timings", timings_type);
+	duckdb_bind_add_result_column(info, "bench", bench_type);
+
+	duckdb_destroy_logical_type(&bool_type);
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_logical_type(&timings_type);
+	duckdb_destroy_logical_type(&bench_type);
+}
+
+/* Bind callback: parses named parameters into immutable bind data for one call. */
+static void tcc_module_bind(duckdb_bind_info info) {
+	tcc_module_bind_data_t *bind;
+
+	bind = (tcc_module_bind_data_t *)duckdb_malloc(sizeof(tcc_module_bind_data_t));
+	if (!bind) {
+		duckdb_bind_set_error(info, "out of memory");
+		return;
+	}
+	memset(bind, 0, sizeof(tcc_module_bind_data_t));
+
+	tcc_bind_read_named_varchar(info, "mode", &bind->mode);
+	if (!bind->mode || bind->mode[0] == '\0') {
+		bind->mode = tcc_strdup("config_get");
+	}
+	tcc_bind_read_named_varchar(info, "runtime_path", &bind->runtime_path);
+	tcc_bind_read_named_varchar(info, "source", &bind->source);
+	tcc_bind_read_named_varchar(info, "symbol", &bind->symbol);
+	tcc_bind_read_named_varchar(info, "sql_name", &bind->sql_name);
+	tcc_bind_read_named_list_csv(info, "arg_types", &bind->arg_types);
+	tcc_bind_read_named_list_csv(info, "symbols", &bind->symbols);
+	tcc_bind_read_named_varchar(info, "expr", &bind->expr);
+	tcc_bind_read_named_varchar(info, "return_type", &bind->return_type);
+	tcc_bind_read_named_varchar(info, "wrapper_mode", &bind->wrapper_mode);
+	if (!bind->wrapper_mode || bind->wrapper_mode[0] == '\0') {
+		if (bind->wrapper_mode) {
+			duckdb_free(bind->wrapper_mode);
+		}
+		bind->wrapper_mode = tcc_strdup("row");
+	}
+	tcc_bind_read_named_varchar(info, "stability", &bind->stability);
+	tcc_bind_read_named_varchar(info, "isolation", &bind->isolation);
+	tcc_bind_read_named_list_csv(info, "specialize", &bind->specialize);
+	tcc_bind_read_named_list_csv(info, "type_params", &bind->type_params);
+	tcc_bind_read_named_list_csv(info, "import_from", &bind->import_from);
+	tcc_bind_read_named_varchar(info, "source_file", &bind->source_file);
+	tcc_bind_read_named_list_csv(info, "used", &bind->used);
+	tcc_bind_read_named_varchar(info, "include_path", &bind->include_path);
+	tcc_bind_read_named_varchar(info, "sysinclude_path", &bind->sysinclude_path);
+	tcc_bind_read_named_varchar(info, "library_path", &bind->library_path);
+	tcc_bind_read_named_varchar(info, "library", &bind->library);
+	tcc_bind_read_named_varchar(info, "option", &bind->option);
+	tcc_bind_read_named_varchar(info, "header", &bind->header);
+	tcc_bind_read_named_varchar(info, "define_name", &bind->define_name);
+	tcc_bind_read_named_varchar(info, "define_value", &bind->define_value);
+	tcc_bind_read_named_varchar(info, "symbol_name", &bind->symbol_name);
+	{
+		duckdb_value spval = duckdb_bind_get_named_parameter(info, "symbol_ptr");
+		if (spval && !duckdb_is_null_value(spval)) {
+			char *ptr_str = duckdb_get_varchar(spval);
+			if (ptr_str) {
+				bind->symbol_ptr = (uint64_t)strtoull(ptr_str, NULL, 10);
+				bind->has_symbol_ptr = true;
+				duckdb_free(ptr_str);
+			}
+		}
+		if (spval) {
+			duckdb_destroy_value(&spval);
+		}
+	}
+	{
+		duckdb_value pmval = duckdb_bind_get_named_parameter(info, "perf_map");
+		if (pmval && !duckdb_is_null_value(pmval)) {
+			bind->perf_map = duckdb_get_bool(pmval);
+		}
+		if (pmval) {
+			duckdb_destroy_value(&pmval);
+		}
+	}
+	{
+		duckdb_value rows_val = duckdb_bind_get_named_parameter(info, "rows");
+		duckdb_value ratio_val = duckdb_bind_get_named_parameter(info, "null_ratio");
+		if (rows_val && !duckdb_is_null_value(rows_val)) {
+			bind->bench_rows = duckdb_get_uint64(rows_val);
+			bind->has_bench_rows = true;
+		}
+		if (ratio_val && !duckdb_is_null_value(ratio_val)) {
+			bind->bench_null_ratio = duckdb_get_double(ratio_val);
+		}
+		if (rows_val) {
+			duckdb_destroy_value(&rows_val);
+		}
+		if (ratio_val) {
+			duckdb_destroy_value(&ratio_val);
+		}
+	}
+
+	tcc_module_bind_add_result_columns(info);
+	duckdb_bind_set_cardinality(info, 1, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_module_bind_data);
+}
+
+/* Bind callback for `tcc_compile_expr(sql_name, expr := ..., arg_types := [...])`: a one-row `compile_expr` call. */
+static void tcc_compile_expr_bind(duckdb_bind_info info) {
+	tcc_module_bind_data_t *bind;
+	duckdb_value name_val;
+
+	bind = (tcc_module_bind_data_t *)duckdb_malloc(sizeof(tcc_module_bind_data_t));
+	if (!bind) {
+		duckdb_bind_set_error(info, "out of memory");
+		return;
+	}
+	memset(bind, 0, sizeof(tcc_module_bind_data_t));
+	bind->mode = tcc_strdup("compile_expr");
+	bind->wrapper_mode = tcc_strdup("chunk_scalar_loop");
+	name_val = duckdb_bind_get_parameter(info, 0);
+	if (name_val && !duckdb_is_null_value(name_val)) {
+		bind->sql_name = duckdb_get_varchar(name_val);
+	}
+	if (name_val) {
+		duckdb_destroy_value(&name_val);
+	}
+	tcc_bind_read_named_varchar(info, "expr", &bind->expr);
+	tcc_bind_read_named_list_csv(info, "arg_types", &bind->arg_types);
+	tcc_bind_read_named_varchar(info, "return_type", &bind->return_type);
+	tcc_bind_read_named_varchar(info, "stability", &bind->stability);
+	tcc_bind_read_named_varchar(info, "isolation", &bind->isolation);
+
+	tcc_module_bind_add_result_columns(info);
+	duckdb_bind_set_cardinality(info, 1, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_module_bind_data);
+}
+
+/* Init callback: stores one-shot emission state for table-function execution. */
+static void tcc_module_init(duckdb_init_info info) {
+	tcc_module_init_data_t *init = (tcc_module_init_data_t *)duckdb_malloc(sizeof(tcc_module_init_data_t));
+	if (!init) {
+		duckdb_init_set_error(info, "out of memory");
+		return;
+	}
+	atomic_store_explicit(&init->emitted, false, memory_order_relaxed);
+	duckdb_init_set_init_data(info, init, destroy_tcc_module_init_data);
+}
+
+/* Writes nullable VARCHAR value into an output vector cell. */
+static void tcc_set_varchar_col(duckdb_vector vector, idx_t row, const char *value) {
+	uint64_t *validity;
+	if (!value) {
+		duckdb_vector_ensure_validity_writable(vector);
+		validity = duckdb_vector_get_validity(vector);
+		duckdb_validity_set_row_invalid(validity, row);
+		return;
+	}
+	duckdb_vector_assign_string_element(vector, row, value);
+}
+
+/* Emits one diagnostics/status row in the `tcc_module(...)` table output schema. */
+static void tcc_write_row(duckdb_data_chunk output, bool ok, const char *mode, const char *phase, const char *code,
+                          const char *message, const char *detail, const char *sql_name, const char *symbol,
+                          const char *artifact_id, const char *connection_scope) {
+	duckdb_vector v_ok = duckdb_data_chunk_get_vector(output, 0);
+	bool *ok_data = (bool *)duckdb_vector_get_data(v_ok);
+	ok_data[0] = ok;
+
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), 0, mode);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 2), 0, phase);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 3), 0, code);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 4), 0, message);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 5), 0, detail);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 6), 0, sql_name);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 7), 0, symbol);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 8), 0, artifact_id);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 9), 0, connection_scope);
+	/* `timings` is only populated by compile modes (tcc_write_timings_col) and `bench` by the bench mode
+	 * (tcc_write_bench_col); NULL otherwise. */
+	{
+		duckdb_vector v_timings = duckdb_data_chunk_get_vector(output, 10);
+		duckdb_vector v_bench = duckdb_data_chunk_get_vector(output, 11);
+		duckdb_vector_ensure_validity_writable(v_timings);
+		duckdb_validity_set_row_invalid(duckdb_vector_get_validity(v_timings), 0);
+		duckdb_vector_ensure_validity_writable(v_bench);
+		duckdb_validity_set_row_invalid(duckdb_vector_get_validity(v_bench), 0);
+	}
+	duckdb_data_chunk_set_size(output, 1);
+}
+
+static const char *tcc_skip_space(const char *p) {
+	while (p && *p && isspace((unsigned char)*p)) {
+		p++;
+	}
+	return p;
+}
+
+/* tcc_equals_ci: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_equals_ci(const char *a, const char *b) {
+	unsigned char ca;
+	unsigned char cb;
+	if (!a || !b) {
+		return false;
+	}
+	while (*a && *b) {
+		ca = (unsigned char)tolower((unsigned char)*a++);
+		cb = (unsigned char)tolower((unsigned char)*b++);
+		if (ca != cb) {
+			return false;
+		}
+	}
+	return *a == '\0' && *b == '\0';
+}
+
+static const char *tcc_wrapper_mode_token(tcc_wrapper_mode_t mode) {
+	switch (mode) {
+	case TCC_WRAPPER_MODE_ROW:
+		return "row";
+	case TCC_WRAPPER_MODE_BATCH:
+		return "chunk_scalar_loop";
+	case TCC_WRAPPER_MODE_ARROW:
+		return "arrow";
+	default:
+		return NULL;
+	}
+}
+
+static const char *tcc_function_stability_token(tcc_function_stability_t stability) {
+	switch (stability) {
+	case TCC_FUNCTION_STABILITY_CONSISTENT:
+		return "consistent";
+	case TCC_FUNCTION_STABILITY_VOLATILE:
+		return "volatile";
+	default:
+		return NULL;
+	}
+}
+
+/* tcc_parse_function_stability: Parser helper for DuckDB scalar-function stability. */
+static bool tcc_parse_function_stability(const char *stability, tcc_function_stability_t *out_stability,
+                                         tcc_error_buffer_t *error_buf) {
+	const char *value = stability;
+	char token[32];
+	size_t len;
+	if (!out_stability) {
+		tcc_set_error(error_buf, "stability output is required");
+		return false;
+	}
+	if (!value || value[0] == '\0') {
+		*out_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+		return true;
+	}
+	value = tcc_skip_space(value);
+	len = strlen(value);
+	while (len > 0 && isspace((unsigned char)value[len - 1])) {
+		len--;
+	}
+	if (len == 0 || len >= sizeof(token)) {
+		tcc_set_error(error_buf, "stability contains unsupported token");
+		return false;
+	}
+	memcpy(token, value, len);
+	token[len] = '\0';
+	if (tcc_equals_ci(token, "consistent")) {
+		*out_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+		return true;
+	}
+	if (tcc_equals_ci(token, "volatile")) {
+		*out_stability = TCC_FUNCTION_STABILITY_VOLATILE;
+		return true;
+	}
+	tcc_set_error(error_buf, "stability contains unsupported token");
+	return false;
+}
+
+/* tcc_parse_wrapper_mode: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_wrapper_mode(const char *wrapper_mode, tcc_wrapper_mode_t *out_mode,
+                                   tcc_error_buffer_t *error_buf) {
+	const char *mode = wrapper_mode;
+	char token[32];
+	size_t len;
+	if (!out_mode) {
+		tcc_set_error(error_buf, "wrapper_mode output is required");
+		return false;
+	}
+	if (!mode || mode[0] == '\0') {
+		*out_mode = TCC_WRAPPER_MODE_ROW;
+		return true;
+	}
+	mode = tcc_skip_space(mode);
+	len = strlen(mode);
+	while (len > 0 && isspace((unsigned char)mode[len - 1])) {
+		len--;
+	}
+	if (len == 0 || len >= sizeof(token)) {
+		tcc_set_error(error_buf, "wrapper_mode contains unsupported token");
+		return false;
+	}
+	memcpy(token, mode, len);
+	token[len] = '\0';
+	if (tcc_equals_ci(token, "row")) {
+		*out_mode = TCC_WRAPPER_MODE_ROW;
+		return true;
+	}
+	if (tcc_equals_ci(token, "chunk_scalar_loop") || tcc_equals_ci(token, "chunk_columnar") ||
+	    tcc_equals_ci(token, "predicate")) {
+		*out_mode = TCC_WRAPPER_MODE_BATCH;
+		return true;
+	}
+	if (tcc_equals_ci(token, "arrow")) {
+		*out_mode = TCC_WRAPPER_MODE_ARROW;
+		return true;
+	}
+	tcc_set_error(error_buf, "wrapper_mode contains unsupported token");
+	return false;
+}
+
+/* tcc_wrapper_mode_is: case-insensitive match of a wrapper_mode parameter against one token. Used for the batch
+ * variants ('chunk_columnar', 'predicate') that share TCC_WRAPPER_MODE_BATCH but generate different wrappers. */
+static bool tcc_wrapper_mode_is(const char *wrapper_mode, const char *expected) {
+	const char *mode = wrapper_mode ? tcc_skip_space(wrapper_mode) : NULL;
+	char token[32];
+	size_t len = mode ? strlen(mode) : 0;
+	while (len > 0 && isspace((unsigned char)mode[len - 1])) {
+		len--;
+	}
+	if (len == 0 || len >= sizeof(token)) {
+		return false;
+	}
+	memcpy(token, mode, len);
+	token[len] = '\0';
+	return tcc_equals_ci(token, expected);
+}
+
+/* tcc_ffi_type_is_plain_column: fixed-width types whose DuckDB vector data is the C value itself, so generated
+ * code may read or write the vector buffer directly. */
+static bool tcc_ffi_type_is_plain_column(tcc_ffi_type_t type) {
+	return (type >= TCC_FFI_BOOL && type <= TCC_FFI_F64) || type == TCC_FFI_DATE || type == TCC_FFI_TIME ||
+	       type == TCC_FFI_TIMESTAMP;
+}
+
+/* tcc_columnar_return_supported: chunk_columnar kernels store straight into the child vectors, so every field of
+ * the returned STRUCT must be a plain fixed-width column. */
+static bool tcc_columnar_return_supported(tcc_ffi_type_t return_type, const tcc_ffi_struct_meta_t *meta) {
+	int i;
+	if (!tcc_ffi_type_is_struct(return_type) || !meta || meta->field_count <= 0 || !meta->field_types) {
+		return false;
+	}
+	for (i = 0; i < meta->field_count; i++) {
+		if (!tcc_ffi_type_is_plain_column(meta->field_types[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* tcc_predicate_signature_supported: predicate kernels return bool and read every argument as a raw column. */
+static bool tcc_predicate_signature_supported(tcc_ffi_type_t return_type, const tcc_ffi_type_t *arg_types,
+                                              int arg_count) {
+	int i;
+	if (return_type != TCC_FFI_BOOL) {
+		return false;
+	}
+	for (i = 0; i < arg_count; i++) {
+		if (!tcc_ffi_type_is_plain_column(arg_types[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static char *tcc_next_top_level_part(char **cursor, char sep) {
+	char *start;
+	char *p;
+	int angle_depth = 0;
+	int square_depth = 0;
+	if (!cursor || !*cursor) {
+		return NULL;
+	}
+	start = *cursor;
+	p = start;
+	while (*p) {
+		if (*p == '<') {
+			angle_depth++;
+		} else if (*p == '>') {
+			if (angle_depth > 0) {
+				angle_depth--;
+			}
+		} else if (*p == '[') {
+			square_depth++;
+		} else if (*p == ']') {
+			if (square_depth > 0) {
+				square_depth--;
+			}
+		} else if (*p == sep && angle_depth == 0 && square_depth == 0) {
+			*p = '\0';
+			*cursor = p + 1;
+			return start;
+		}
+		p++;
+	}
+	*cursor = NULL;
+	return start;
+}
+
+static char *tcc_find_top_level_char(char *input, char target) {
+	char *p;
+	int angle_depth = 0;
+	int square_depth = 0;
+	if (!input) {
+		return NULL;
+	}
+	p = input;
+	while (*p) {
+		if (*p == '<') {
+			angle_depth++;
+		} else if (*p == '>') {
+			if (angle_depth > 0) {
+				angle_depth--;
+			}
+		} else if (*p == '[') {
+			square_depth++;
+		} else if (*p == ']') {
+			if (square_depth > 0) {
+				square_depth--;
+			}
+		} else if (*p == target && angle_depth == 0 && square_depth == 0) {
+			return p;
+		}
+		p++;
+	}
+	return NULL;
+}
+
+/* tcc_parse_type_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_type_token(const char *token, bool allow_void, tcc_ffi_type_t *out_type, size_t *out_array_size) {
+	/* Table-driven lookup for simple type tokens. */
+	static const struct {
+		const char *name;
+		tcc_ffi_type_t type;
+	} simple_tokens[] = {
+	    {"bool", TCC_FFI_BOOL},         {"i8", TCC_FFI_I8},
+	    {"u8", TCC_FFI_U8},             {"i16", TCC_FFI_I16},
+	    {"u16", TCC_FFI_U16},           {"i32", TCC_FFI_I32},
+	    {"u32", TCC_FFI_U32},           {"i64", TCC_FFI_I64},
+	    {"u64", TCC_FFI_U64},           {"f32", TCC_FFI_F32},
+	    {"f64", TCC_FFI_F64},           {"ptr", TCC_FFI_PTR},
+	    {"varchar", TCC_FFI_VARCHAR},   {"blob", TCC_FFI_BLOB},
+	    {"uuid", TCC_FFI_UUID},         {"date", TCC_FFI_DATE},
+	    {"time", TCC_FFI_TIME},         {"timestamp", TCC_FFI_TIMESTAMP},
+	    {"interval", TCC_FFI_INTERVAL}, {"decimal", TCC_FFI_DECIMAL},
+	};
+	size_t token_len;
+	size_t i;
+	if (!token || token[0] == '\0' || !out_type) {
+		return false;
+	}
+	token_len = strlen(token);
+	if (out_array_size) {
+		*out_array_size = 0;
+	}
+	if (allow_void && tcc_equals_ci(token, "void")) {
+		*out_type = TCC_FFI_VOID;
+		return true;
+	}
+	for (i = 0; i < sizeof(simple_tokens) / sizeof(simple_tokens[0]); i++) {
+		if (tcc_equals_ci(token, simple_tokens[i].name)) {
+			*out_type = simple_tokens[i].type;
+			return true;
+		}
+	}
+	if (token_len > 8 && (token[0] == 's' || token[0] == 'S') && (token[1] == 't' || token[1] == 'T') &&
+	    (token[2] == 'r' || token[2] == 'R') && (token[3] == 'u' || token[3] == 'U') &&
+	    (token[4] == 'c' || token[4] == 'C') && (token[5] == 't' || token[5] == 'T') && token[6] == '<' &&
+	    token[token_len - 1] == '>') {
+		*out_type = TCC_FFI_STRUCT;
+		return true;
+	}
+	if (token_len > 5 && (token[0] == 'm' || token[0] == 'M') && (token[1] == 'a' || token[1] == 'A') &&
+	    (token[2] == 'p' || token[2] == 'P') && token[3] == '<' && token[token_len - 1] == '>') {
+		*out_type = TCC_FFI_MAP;
+		return true;
+	}
+	if (token_len > 7 && (token[0] == 'u' || token[0] == 'U') && (token[1] == 'n' || token[1] == 'N') &&
+	    (token[2] == 'i' || token[2] == 'I') && (token[3] == 'o' || token[3] == 'O') &&
+	    (token[4] == 'n' || token[4] == 'N') && token[5] == '<' && token[token_len - 1] == '>') {
+		*out_type = TCC_FFI_UNION;
+		return true;
+	}
+	if (token_len > 6 && (token[0] == 'l' || token[0] == 'L') && (token[1] == 'i' || token[1] == 'I') &&
+	    (token[2] == 's' || token[2] == 'S') && (token[3] == 't' || token[3] == 'T') && token[4] == '<' &&
+	    token[token_len - 1] == '>') {
+		tcc_ffi_type_t child_type = TCC_FFI_VOID;
+		size_t child_array_size = 0;
+		char *inner = (char *)duckdb_malloc(token_len - 4);
+		if (!inner) {
+			return false;
+		}
+		memcpy(inner, token + 5, token_len - 6);
+		inner[token_len - 6] = '\0';
+		{
+			char *trimmed = tcc_trim_inplace(inner);
+			bool ok = tcc_parse_type_token(trimmed, false, &child_type, &child_array_size) && child_type != TCC_FFI_VOID;
+			duckdb_free(inner);
+			if (!ok) {
+				return false;
+			}
+		}
+		if (tcc_ffi_list_type_from_child(child_type, out_type)) {
+			return true;
+		}
+		*out_type = TCC_FFI_LIST;
+		return true;
+	}
+	if (token_len > 3 && token[token_len - 1] == ']') {
+		const char *lb = strrchr(token, '[');
+		if (lb && lb < token + token_len - 1 && lb[1] != ']') {
+			uint64_t arr_n = 0;
+			const char *p = lb + 1;
+			bool ok_digits = true;
+			tcc_ffi_type_t child_type = TCC_FFI_VOID;
+			size_t child_array_size = 0;
+			char child_token[64];
+			size_t child_len = (size_t)(lb - token);
+			while (p < token + token_len - 1) {
+				if (!isdigit((unsigned char)*p)) {
+					ok_digits = false;
+					break;
+				}
+				arr_n = arr_n * 10 + (uint64_t)(*p - '0');
+				p++;
+			}
+			if (ok_digits && arr_n > 0 && arr_n <= (uint64_t)SIZE_MAX && child_len > 0 && child_len < sizeof(child_token)) {
+				memcpy(child_token, token, child_len);
+				child_token[child_len] = '\0';
+				if (tcc_parse_type_token(child_token, false, &child_type, &child_array_size) &&
+				    child_type != TCC_FFI_VOID) {
+					if (!tcc_ffi_array_type_from_child(child_type, out_type)) {
+						*out_type = TCC_FFI_ARRAY;
+					}
+					if (out_array_size) {
+						*out_array_size = (size_t)arr_n;
+					}
+					return true;
+				}
+			}
+		}
+	}
+	if (token_len > 2 && token[token_len - 2] == '[' && token[token_len - 1] == ']') {
+		tcc_ffi_type_t child_type = TCC_FFI_VOID;
+		size_t child_array_size = 0;
+		char child_token[64];
+		size_t child_len = token_len - 2;
+		if (child_len > 0 && child_len < sizeof(child_token)) {
+			memcpy(child_token, token, child_len);
+			child_token[child_len] = '\0';
+			if (tcc_parse_type_token(child_token, false, &child_type, &child_array_size) &&
+			    child_type != TCC_FFI_VOID) {
+				if (!tcc_ffi_list_type_from_child(child_type, out_type)) {
+					*out_type = TCC_FFI_LIST;
+				}
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* tcc_is_identifier_token: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_is_identifier_token(const char *value) {
+	size_t i;
+	if (!value || value[0] == '\0') {
+		return false;
+	}
+	if (!(isalpha((unsigned char)value[0]) || value[0] == '_')) {
+		return false;
+	}
+	for (i = 1; value[i] != '\0'; i++) {
+		if (!(isalnum((unsigned char)value[i]) || value[i] == '_')) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* tcc_split_csv_tokens: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_split_csv_tokens(const char *csv, tcc_string_list_t *out_tokens, tcc_error_buffer_t *error_buf) {
+	char *copy;
+	char *cursor;
+	if (!out_tokens) {
+		tcc_set_error(error_buf, "token output is required");
+		return false;
+	}
+	memset(out_tokens, 0, sizeof(*out_tokens));
+	if (!csv || csv[0] == '\0') {
+		return true;
+	}
+	copy = tcc_strdup(csv);
+	if (!copy) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	cursor = copy;
+	while (cursor) {
+		char *token;
+		char *part = tcc_next_top_level_part(&cursor, ',');
+		token = tcc_trim_inplace(part);
+		if (token[0] == '\0') {
+			duckdb_free(copy);
+			tcc_string_list_destroy(out_tokens);
+			tcc_set_error(error_buf, "arg_types contains an empty token");
+			return false;
+		}
+		if (!tcc_string_list_append(out_tokens, token)) {
+			duckdb_free(copy);
+			tcc_string_list_destroy(out_tokens);
+			tcc_set_error(error_buf, "out of memory");
+			return false;
+		}
+	}
+	duckdb_free(copy);
+	return true;
+}
+
+/* tcc_parse_c_field_spec_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_c_field_spec_token(const char *token, bool force_bitfield, tcc_c_field_spec_t *out_field,
+                                         tcc_error_buffer_t *error_buf) {
+	char *copy;
+	char *type_part;
+	char *opts_part = NULL;
+	char *sep;
+	char *name;
+	char *type_token;
+	tcc_ffi_type_t parsed_type = TCC_FFI_VOID;
+	tcc_ffi_type_t child_type = TCC_FFI_VOID;
+	size_t array_size = 0;
+	bool is_bitfield = force_bitfield;
+	if (!token || !out_field) {
+		tcc_set_error(error_buf, "invalid c field specification");
+		return false;
+	}
+	memset(out_field, 0, sizeof(*out_field));
+	copy = tcc_strdup(token);
+	if (!copy) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	sep = strchr(copy, ':');
+	if (!sep) {
+		duckdb_free(copy);
+		tcc_set_error(error_buf, "field spec must use name:type or name:type:bitfield");
+		return false;
+	}
+	*sep = '\0';
+	type_part = sep + 1;
+	sep = strchr(type_part, ':');
+	if (sep) {
+		*sep = '\0';
+		opts_part = sep + 1;
+	}
+	name = tcc_trim_inplace(copy);
+	type_token = tcc_trim_inplace(type_part);
+	if (!tcc_is_identifier_token(name)) {
+		duckdb_free(copy);
+		tcc_set_error(error_buf, "field name must be a valid identifier");
+		return false;
+	}
+	if (!tcc_parse_type_token(type_token, false, &parsed_type, &array_size)) {
+		duckdb_free(copy);
+		tcc_set_error(error_buf, "field type token is unsupported");
+		return false;
+	}
+	if (opts_part) {
+		char *opt = tcc_trim_inplace(opts_part);
+		if (opt[0] != '\0') {
+			if (tcc_equals_ci(opt, "bitfield")) {
+				is_bitfield = true;
+			} else {
+				duckdb_free(copy);
+				tcc_set_error(error_buf, "field option is unsupported (expected bitfield)");
+				return false;
+			}
+		}
+	}
+	if (tcc_ffi_type_is_array(parsed_type)) {
+		if (!tcc_ffi_array_child_type(parsed_type, &child_type) || array_size == 0) {
+			duckdb_free(copy);
+			tcc_set_error(error_buf, "array field type is invalid");
+			return false;
+		}
+		if (is_bitfield) {
+			duckdb_free(copy);
+			tcc_set_error(error_buf, "bitfield option cannot be used with array fields");
+			return false;
+		}
+		parsed_type = child_type;
+	} else {
+		array_size = 0;
+	}
+	if (!(tcc_ffi_type_is_fixed_width_scalar(parsed_type) || parsed_type == TCC_FFI_PTR)) {
+		duckdb_free(copy);
+		tcc_set_error(error_buf,
+		              "fields currently support fixed-width scalar/pointer tokens only (no varchar/blob/nested)");
+		return false;
+	}
+	out_field->name = tcc_strdup(name);
+	out_field->type = parsed_type;
+	out_field->array_size = array_size;
+	out_field->is_bitfield = is_bitfield;
+	duckdb_free(copy);
+	if (!out_field->name) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	return true;
+}
+
+/* tcc_parse_c_field_specs: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_c_field_specs(const char *arg_types_csv, bool force_bitfield, tcc_c_field_list_t *out_fields,
+                                    tcc_error_buffer_t *error_buf) {
+	tcc_string_list_t tokens;
+	idx_t i;
+	if (!out_fields) {
+		tcc_set_error(error_buf, "field output is required");
+		return false;
+	}
+	memset(out_fields, 0, sizeof(*out_fields));
+	if (!tcc_split_csv_tokens(arg_types_csv, &tokens, error_buf)) {
+		return false;
+	}
+	if (tokens.count == 0) {
+		tcc_string_list_destroy(&tokens);
+		tcc_set_error(error_buf, "arg_types is required for c_struct/c_union/c_bitfield");
+		return false;
+	}
+	for (i = 0; i < tokens.count; i++) {
+		tcc_c_field_spec_t field;
+		memset(&field, 0, sizeof(field));
+		if (!tcc_parse_c_field_spec_token(tokens.items[i], force_bitfield, &field, error_buf) ||
+		    !tcc_c_field_list_append(out_fields, &field)) {
+			if (field.name) {
+				duckdb_free(field.name);
+			}
+			tcc_string_list_destroy(&tokens);
+			tcc_c_field_list_destroy(out_fields);
+			if (!error_buf || error_buf->message[0] == '\0') {
+				tcc_set_error(error_buf, "out of memory");
+			}
+			return false;
+		}
+	}
+	tcc_string_list_destroy(&tokens);
+	return true;
+}
+
+/* tcc_parse_c_enum_constants: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_c_enum_constants(const char *arg_types_csv, tcc_string_list_t *out_constants,
+                                       tcc_error_buffer_t *error_buf) {
+	idx_t i;
+	if (!tcc_split_csv_tokens(arg_types_csv, out_constants, error_buf)) {
+		return false;
+	}
+	if (out_constants->count == 0) {
+		tcc_set_error(error_buf, "arg_types must list at least one enum constant");
+		tcc_string_list_destroy(out_constants);
+		return false;
+	}
+	for (i = 0; i < out_constants->count; i++) {
+		if (!tcc_is_identifier_token(out_constants->items[i])) {
+			tcc_set_error(error_buf, "enum constants must be valid identifiers");
+			tcc_string_list_destroy(out_constants);
+			return false;
+		}
+	}
+	return true;
+}
+
+/* tcc_parse_composite_fields_inner: Shared parser for struct/union field lists.
+   Parses semicolon-delimited `name:type` fields from an already-extracted inner string.
+   If allow_auto_names is true (struct), unnamed fields get auto-generated names (f1, f2, ...).
+   If false (union), a colon-separated name is required.
+   Outputs are allocated arrays that caller must free on failure via the fail label pattern. */
+static bool tcc_parse_composite_fields_inner(char *inner, bool allow_auto_names, const char *kind_label,
+                                             int *out_count, char ***out_names, char ***out_tokens,
+                                             tcc_ffi_type_t **out_types, size_t **out_sizes,
+                                             tcc_error_buffer_t *error_buf) {
+	char *cur = inner;
 	int count = 0;
 	int cap = 0;
 	char **names = NULL;
@@ -7413,2542 +10661,8274 @@ static bool tcc_parse_composite_fields_inner(char *inner, bool allow_auto_names,
 		while (*part && isspace((unsigned char)*part)) {
 			part++;
 		}
-		part_len = strlen(part);
-		while (part_len > 0 && isspace((unsigned char)part[part_len - 1])) {
-			part[--part_len] = '\0';
+		part_len = strlen(part);
+		while (part_len > 0 && isspace((unsigned char)part[part_len - 1])) {
+			part[--part_len] = '\0';
+		}
+		if (part_len == 0) {
+			snprintf(err_msg, sizeof(err_msg), "%s token contains empty field", kind_label);
+			tcc_set_error(error_buf, err_msg);
+			goto fail;
+		}
+		colon = tcc_find_top_level_char(part, ':');
+		if (colon) {
+			*colon = '\0';
+			name_part = part;
+			type_part = colon + 1;
+			while (*name_part && isspace((unsigned char)*name_part)) {
+				name_part++;
+			}
+			part_len = strlen(name_part);
+			while (part_len > 0 && isspace((unsigned char)name_part[part_len - 1])) {
+				name_part[--part_len] = '\0';
+			}
+			while (*type_part && isspace((unsigned char)*type_part)) {
+				type_part++;
+			}
+			part_len = strlen(type_part);
+			while (part_len > 0 && isspace((unsigned char)type_part[part_len - 1])) {
+				type_part[--part_len] = '\0';
+			}
+			if (!tcc_is_identifier_token(name_part)) {
+				snprintf(err_msg, sizeof(err_msg), "%s field names must be identifiers", kind_label);
+				tcc_set_error(error_buf, err_msg);
+				goto fail;
+			}
+			if (type_part[0] == '\0') {
+				snprintf(err_msg, sizeof(err_msg), "%s field type is missing", kind_label);
+				tcc_set_error(error_buf, err_msg);
+				goto fail;
+			}
+		} else if (allow_auto_names) {
+			snprintf(auto_name, sizeof(auto_name), "f%d", count + 1);
+			name_part = auto_name;
+			type_part = part;
+		} else {
+			snprintf(err_msg, sizeof(err_msg), "%s member must use name:type", kind_label);
+			tcc_set_error(error_buf, err_msg);
+			goto fail;
+		}
+		if (!tcc_parse_type_token(type_part, false, &parsed_type, &parsed_array_size)) {
+			snprintf(err_msg, sizeof(err_msg), "%s field type token is unsupported", kind_label);
+			tcc_set_error(error_buf, err_msg);
+			goto fail;
+		}
+		if (parsed_type == TCC_FFI_VOID) {
+			snprintf(err_msg, sizeof(err_msg), "%s fields cannot use void", kind_label);
+			tcc_set_error(error_buf, err_msg);
+			goto fail;
+		}
+		parsed_size = tcc_ffi_type_size(parsed_type);
+		if (parsed_size == 0) {
+			snprintf(err_msg, sizeof(err_msg), "%s field has unsupported storage type", kind_label);
+			tcc_set_error(error_buf, err_msg);
+			goto fail;
+		}
+		if (count >= cap) {
+			int new_cap = cap == 0 ? 4 : cap * 2;
+			new_names = (char **)duckdb_malloc(sizeof(char *) * (size_t)new_cap);
+			new_tokens = (char **)duckdb_malloc(sizeof(char *) * (size_t)new_cap);
+			new_types = (tcc_ffi_type_t *)duckdb_malloc(sizeof(tcc_ffi_type_t) * (size_t)new_cap);
+			new_sizes = (size_t *)duckdb_malloc(sizeof(size_t) * (size_t)new_cap);
+			if (!new_names || !new_tokens || !new_types || !new_sizes) {
+				if (new_names) {
+					duckdb_free(new_names);
+				}
+				if (new_tokens) {
+					duckdb_free(new_tokens);
+				}
+				if (new_types) {
+					duckdb_free(new_types);
+				}
+				if (new_sizes) {
+					duckdb_free(new_sizes);
+				}
+				tcc_set_error(error_buf, "out of memory");
+				goto fail;
+			}
+			memset(new_names, 0, sizeof(char *) * (size_t)new_cap);
+			memset(new_tokens, 0, sizeof(char *) * (size_t)new_cap);
+			if (names && count > 0) {
+				memcpy(new_names, names, sizeof(char *) * (size_t)count);
+				memcpy(new_tokens, tokens, sizeof(char *) * (size_t)count);
+				memcpy(new_types, types, sizeof(tcc_ffi_type_t) * (size_t)count);
+				memcpy(new_sizes, sizes, sizeof(size_t) * (size_t)count);
+				duckdb_free(names);
+				duckdb_free(tokens);
+				duckdb_free(types);
+				duckdb_free(sizes);
+			}
+			names = new_names;
+			tokens = new_tokens;
+			types = new_types;
+			sizes = new_sizes;
+			cap = new_cap;
+		}
+		names[count] = tcc_strdup(name_part);
+		tokens[count] = tcc_strdup(type_part);
+		if (!names[count] || !tokens[count]) {
+			tcc_set_error(error_buf, "out of memory");
+			goto fail;
+		}
+		types[count] = parsed_type;
+		sizes[count] = parsed_size;
+		count++;
+	}
+	if (count <= 0) {
+		snprintf(err_msg, sizeof(err_msg), "%s token requires at least one field", kind_label);
+		tcc_set_error(error_buf, err_msg);
+		goto fail;
+	}
+	*out_count = count;
+	*out_names = names;
+	*out_tokens = tokens;
+	*out_types = types;
+	*out_sizes = sizes;
+	return true;
+fail:
+	if (names) {
+		int i;
+		for (i = 0; i < count; i++) {
+			if (names[i]) {
+				duckdb_free(names[i]);
+			}
+		}
+		duckdb_free(names);
+	}
+	if (tokens) {
+		int i;
+		for (i = 0; i < count; i++) {
+			if (tokens[i]) {
+				duckdb_free(tokens[i]);
+			}
+		}
+		duckdb_free(tokens);
+	}
+	if (types) {
+		duckdb_free(types);
+	}
+	if (sizes) {
+		duckdb_free(sizes);
+	}
+	*out_count = 0;
+	*out_names = NULL;
+	*out_tokens = NULL;
+	*out_types = NULL;
+	*out_sizes = NULL;
+	return false;
+}
+
+/* tcc_parse_struct_meta_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_struct_meta_token(const char *token, tcc_ffi_struct_meta_t *out_meta,
+                                        tcc_error_buffer_t *error_buf) {
+	size_t token_len;
+	char *inner = NULL;
+	bool ok;
+	if (!token || !out_meta) {
+		tcc_set_error(error_buf, "invalid struct token");
+		return false;
+	}
+	memset(out_meta, 0, sizeof(*out_meta));
+	token_len = strlen(token);
+	if (token_len <= 8 || !((token[0] == 's' || token[0] == 'S') && (token[1] == 't' || token[1] == 'T') &&
+	                        (token[2] == 'r' || token[2] == 'R') && (token[3] == 'u' || token[3] == 'U') &&
+	                        (token[4] == 'c' || token[4] == 'C') && (token[5] == 't' || token[5] == 'T') &&
+	                        token[6] == '<' && token[token_len - 1] == '>')) {
+		tcc_set_error(error_buf, "struct token must use struct<...>");
+		return false;
+	}
+	inner = (char *)duckdb_malloc(token_len - 6);
+	if (!inner) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	memcpy(inner, token + 7, token_len - 8);
+	inner[token_len - 8] = '\0';
+	ok = tcc_parse_composite_fields_inner(inner, true, "struct", &out_meta->field_count, &out_meta->field_names,
+	                                      &out_meta->field_tokens, &out_meta->field_types, &out_meta->field_sizes,
+	                                      error_buf);
+	duckdb_free(inner);
+	return ok;
+}
+
+/* tcc_parse_map_meta_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_map_meta_token(const char *token, tcc_ffi_map_meta_t *out_meta, tcc_error_buffer_t *error_buf) {
+	size_t token_len;
+	char *inner = NULL;
+	char *sep;
+	char *key_token;
+	char *value_token;
+	tcc_ffi_type_t key_type = TCC_FFI_VOID;
+	tcc_ffi_type_t value_type = TCC_FFI_VOID;
+	size_t key_array_size = 0;
+	size_t value_array_size = 0;
+	size_t key_size = 0;
+	size_t value_size = 0;
+	char *key_token_copy = NULL;
+	char *value_token_copy = NULL;
+	if (!token || !out_meta) {
+		tcc_set_error(error_buf, "invalid map token");
+		return false;
+	}
+	memset(out_meta, 0, sizeof(*out_meta));
+	token_len = strlen(token);
+	if (token_len <= 5 || !((token[0] == 'm' || token[0] == 'M') && (token[1] == 'a' || token[1] == 'A') &&
+	                        (token[2] == 'p' || token[2] == 'P') && token[3] == '<' &&
+	                        token[token_len - 1] == '>')) {
+		tcc_set_error(error_buf, "map token must use map<key_type;value_type>");
+		return false;
+	}
+	inner = (char *)duckdb_malloc(token_len - 3);
+	if (!inner) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	memcpy(inner, token + 4, token_len - 5);
+	inner[token_len - 5] = '\0';
+	sep = tcc_find_top_level_char(inner, ';');
+	if (!sep || tcc_find_top_level_char(sep + 1, ';')) {
+		duckdb_free(inner);
+		tcc_set_error(error_buf, "map token must use exactly one ';' separator");
+		return false;
+	}
+	*sep = '\0';
+	key_token = inner;
+	value_token = sep + 1;
+	while (*key_token && isspace((unsigned char)*key_token)) {
+		key_token++;
+	}
+	while (*value_token && isspace((unsigned char)*value_token)) {
+		value_token++;
+	}
+	{
+		size_t len = strlen(key_token);
+		while (len > 0 && isspace((unsigned char)key_token[len - 1])) {
+			key_token[--len] = '\0';
+		}
+	}
+	{
+		size_t len = strlen(value_token);
+		while (len > 0 && isspace((unsigned char)value_token[len - 1])) {
+			value_token[--len] = '\0';
+		}
+	}
+	if (key_token[0] == '\0' || value_token[0] == '\0') {
+		duckdb_free(inner);
+		tcc_set_error(error_buf, "map token key/value type is missing");
+		return false;
+	}
+	key_token_copy = tcc_strdup(key_token);
+	value_token_copy = tcc_strdup(value_token);
+	if (!key_token_copy || !value_token_copy) {
+		if (key_token_copy) {
+			duckdb_free(key_token_copy);
+		}
+		if (value_token_copy) {
+			duckdb_free(value_token_copy);
+		}
+		duckdb_free(inner);
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	if (!tcc_parse_type_token(key_token, false, &key_type, &key_array_size) ||
+	    !tcc_parse_type_token(value_token, false, &value_type, &value_array_size) || key_type == TCC_FFI_VOID ||
+	    value_type == TCC_FFI_VOID) {
+		duckdb_free(key_token_copy);
+		duckdb_free(value_token_copy);
+		duckdb_free(inner);
+		tcc_set_error(error_buf, "map key/value contains unsupported type token");
+		return false;
+	}
+	key_size = tcc_ffi_type_size(key_type);
+	value_size = tcc_ffi_type_size(value_type);
+	duckdb_free(inner);
+	if (key_size == 0 || value_size == 0) {
+		duckdb_free(key_token_copy);
+		duckdb_free(value_token_copy);
+		tcc_set_error(error_buf, "map key/value has unsupported storage type");
+		return false;
+	}
+	out_meta->key_token = key_token_copy;
+	out_meta->value_token = value_token_copy;
+	out_meta->key_type = key_type;
+	out_meta->value_type = value_type;
+	out_meta->key_size = key_size;
+	out_meta->value_size = value_size;
+	return true;
+}
+
+/* tcc_parse_union_meta_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_parse_union_meta_token(const char *token, tcc_ffi_union_meta_t *out_meta,
+                                       tcc_error_buffer_t *error_buf) {
+	size_t token_len;
+	char *inner = NULL;
+	bool ok;
+	if (!token || !out_meta) {
+		tcc_set_error(error_buf, "invalid union token");
+		return false;
+	}
+	memset(out_meta, 0, sizeof(*out_meta));
+	token_len = strlen(token);
+	if (token_len <= 7 || !((token[0] == 'u' || token[0] == 'U') && (token[1] == 'n' || token[1] == 'N') &&
+	                        (token[2] == 'i' || token[2] == 'I') && (token[3] == 'o' || token[3] == 'O') &&
+	                        (token[4] == 'n' || token[4] == 'N') && token[5] == '<' && token[token_len - 1] == '>')) {
+		tcc_set_error(error_buf, "union token must use union<name:type;...>");
+		return false;
+	}
+	inner = (char *)duckdb_malloc(token_len - 4);
+	if (!inner) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	memcpy(inner, token + 6, token_len - 7);
+	inner[token_len - 7] = '\0';
+	ok = tcc_parse_composite_fields_inner(inner, false, "union", &out_meta->member_count, &out_meta->member_names,
+	                                      &out_meta->member_tokens, &out_meta->member_types, &out_meta->member_sizes,
+	                                      error_buf);
+	duckdb_free(inner);
+	return ok;
+}
+
+/* tcc_typedesc_destroy: Type-system conversion/parsing helper. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
+static void tcc_typedesc_destroy(tcc_typedesc_t *desc) {
+	idx_t i;
+	if (!desc) {
+		return;
+	}
+	if (desc->token) {
+		duckdb_free(desc->token);
+	}
+	if (desc->kind == TCC_TYPEDESC_LIST || desc->kind == TCC_TYPEDESC_ARRAY) {
+		tcc_typedesc_destroy(desc->as.list_like.child);
+	} else if (desc->kind == TCC_TYPEDESC_STRUCT) {
+		if (desc->as.struct_like.fields) {
+			for (i = 0; i < desc->as.struct_like.count; i++) {
+				if (desc->as.struct_like.fields[i].name) {
+					duckdb_free(desc->as.struct_like.fields[i].name);
+				}
+				tcc_typedesc_destroy(desc->as.struct_like.fields[i].type);
+			}
+			duckdb_free(desc->as.struct_like.fields);
+		}
+	} else if (desc->kind == TCC_TYPEDESC_MAP) {
+		tcc_typedesc_destroy(desc->as.map_like.key);
+		tcc_typedesc_destroy(desc->as.map_like.value);
+	} else if (desc->kind == TCC_TYPEDESC_UNION) {
+		if (desc->as.union_like.members) {
+			for (i = 0; i < desc->as.union_like.count; i++) {
+				if (desc->as.union_like.members[i].name) {
+					duckdb_free(desc->as.union_like.members[i].name);
+				}
+				tcc_typedesc_destroy(desc->as.union_like.members[i].type);
+			}
+			duckdb_free(desc->as.union_like.members);
+		}
+	}
+	duckdb_free(desc);
+}
+
+/* tcc_typedesc_parse_token: Type-system conversion/parsing helper. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
+static bool tcc_typedesc_parse_token(const char *token, bool allow_void, tcc_typedesc_t **out_desc,
+                                     tcc_error_buffer_t *error_buf) {
+	tcc_typedesc_t *desc = NULL;
+	tcc_ffi_type_t parsed = TCC_FFI_VOID;
+	size_t array_size = 0;
+	if (!token || !out_desc) {
+		tcc_set_error(error_buf, "type token is required");
+		return false;
+	}
+	*out_desc = NULL;
+	if (!tcc_parse_type_token(token, allow_void, &parsed, &array_size)) {
+		tcc_set_error(error_buf, "type token is unsupported");
+		return false;
+	}
+	desc = (tcc_typedesc_t *)duckdb_malloc(sizeof(tcc_typedesc_t));
+	if (!desc) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	memset(desc, 0, sizeof(*desc));
+	desc->ffi_type = parsed;
+	desc->array_size = array_size;
+	desc->token = tcc_strdup(token);
+	if (!desc->token) {
+		duckdb_free(desc);
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	if (tcc_ffi_type_is_list(parsed)) {
+		tcc_ffi_type_t child_ffi = TCC_FFI_VOID;
+		const char *child_token = NULL;
+		char *owned_child_token = NULL;
+		desc->kind = TCC_TYPEDESC_LIST;
+		if (tcc_ffi_list_child_type(parsed, &child_ffi)) {
+			child_token = tcc_ffi_type_to_token(child_ffi);
+		} else {
+			size_t token_len_local = strlen(token);
+			if (token_len_local > 6 && token[4] == '<' && token[token_len_local - 1] == '>') {
+				owned_child_token = (char *)duckdb_malloc(token_len_local - 4);
+				if (!owned_child_token) {
+					tcc_typedesc_destroy(desc);
+					tcc_set_error(error_buf, "out of memory");
+					return false;
+				}
+				memcpy(owned_child_token, token + 5, token_len_local - 6);
+				owned_child_token[token_len_local - 6] = '\0';
+				child_token = tcc_trim_inplace(owned_child_token);
+			} else if (token_len_local >= 5 && (token[0] == 'l' || token[0] == 'L') && (token[1] == 'i' || token[1] == 'I') &&
+			           (token[2] == 's' || token[2] == 'S') && (token[3] == 't' || token[3] == 'T') && token[4] == '_') {
+				child_token = token + 5;
+			} else if (token_len_local > 2 && token[token_len_local - 2] == '[' && token[token_len_local - 1] == ']') {
+				owned_child_token = (char *)duckdb_malloc(token_len_local - 1);
+				if (!owned_child_token) {
+					tcc_typedesc_destroy(desc);
+					tcc_set_error(error_buf, "out of memory");
+					return false;
+				}
+				memcpy(owned_child_token, token, token_len_local - 2);
+				owned_child_token[token_len_local - 2] = '\0';
+				child_token = tcc_trim_inplace(owned_child_token);
+			}
+		}
+		if (!child_token || !tcc_typedesc_parse_token(child_token, false, &desc->as.list_like.child, error_buf)) {
+			if (owned_child_token) {
+				duckdb_free(owned_child_token);
+			}
+			tcc_typedesc_destroy(desc);
+			return false;
+		}
+		if (owned_child_token) {
+			duckdb_free(owned_child_token);
+		}
+	} else if (tcc_ffi_type_is_array(parsed)) {
+		tcc_ffi_type_t child_ffi = TCC_FFI_VOID;
+		const char *child_token = NULL;
+		char *owned_child_token = NULL;
+		desc->kind = TCC_TYPEDESC_ARRAY;
+		if (tcc_ffi_array_child_type(parsed, &child_ffi)) {
+			child_token = tcc_ffi_type_to_token(child_ffi);
+		} else {
+			size_t token_len_local = strlen(token);
+			const char *lb = strrchr(token, '[');
+			if (lb && token_len_local > 3 && token[token_len_local - 1] == ']' && lb < token + token_len_local - 1) {
+				size_t child_len = (size_t)(lb - token);
+				owned_child_token = (char *)duckdb_malloc(child_len + 1);
+				if (!owned_child_token) {
+					tcc_typedesc_destroy(desc);
+					tcc_set_error(error_buf, "out of memory");
+					return false;
+				}
+				memcpy(owned_child_token, token, child_len);
+				owned_child_token[child_len] = '\0';
+				child_token = tcc_trim_inplace(owned_child_token);
+			}
+		}
+		if (!child_token || !tcc_typedesc_parse_token(child_token, false, &desc->as.list_like.child, error_buf)) {
+			if (owned_child_token) {
+				duckdb_free(owned_child_token);
+			}
+			tcc_typedesc_destroy(desc);
+			return false;
+		}
+		if (owned_child_token) {
+			duckdb_free(owned_child_token);
+		}
+	} else if (parsed == TCC_FFI_STRUCT) {
+		tcc_ffi_struct_meta_t meta;
+		idx_t i;
+		desc->kind = TCC_TYPEDESC_STRUCT;
+		memset(&meta, 0, sizeof(meta));
+		if (!tcc_parse_struct_meta_token(token, &meta, error_buf)) {
+			tcc_typedesc_destroy(desc);
+			return false;
+		}
+		if (meta.field_count > 0) {
+			desc->as.struct_like.fields =
+			    (tcc_typedesc_field_t *)duckdb_malloc(sizeof(tcc_typedesc_field_t) * (size_t)meta.field_count);
+			if (!desc->as.struct_like.fields) {
+				tcc_struct_meta_destroy(&meta);
+				tcc_typedesc_destroy(desc);
+				tcc_set_error(error_buf, "out of memory");
+				return false;
+			}
+			memset(desc->as.struct_like.fields, 0, sizeof(tcc_typedesc_field_t) * (size_t)meta.field_count);
+		}
+		desc->as.struct_like.count = (idx_t)meta.field_count;
+		for (i = 0; i < (idx_t)meta.field_count; i++) {
+			desc->as.struct_like.fields[i].name = tcc_strdup(meta.field_names[i]);
+			if (!desc->as.struct_like.fields[i].name ||
+			    !tcc_typedesc_parse_token(meta.field_tokens[i], false, &desc->as.struct_like.fields[i].type, error_buf)) {
+				tcc_struct_meta_destroy(&meta);
+				tcc_typedesc_destroy(desc);
+				if (!error_buf || error_buf->message[0] == '\0') {
+					tcc_set_error(error_buf, "out of memory");
+				}
+				return false;
+			}
+		}
+		tcc_struct_meta_destroy(&meta);
+	} else if (parsed == TCC_FFI_MAP) {
+		tcc_ffi_map_meta_t meta;
+		desc->kind = TCC_TYPEDESC_MAP;
+		memset(&meta, 0, sizeof(meta));
+		if (!tcc_parse_map_meta_token(token, &meta, error_buf) ||
+		    !tcc_typedesc_parse_token(meta.key_token, false, &desc->as.map_like.key, error_buf) ||
+		    !tcc_typedesc_parse_token(meta.value_token, false, &desc->as.map_like.value, error_buf)) {
+			tcc_map_meta_destroy(&meta);
+			tcc_typedesc_destroy(desc);
+			return false;
+		}
+		tcc_map_meta_destroy(&meta);
+	} else if (parsed == TCC_FFI_UNION) {
+		tcc_ffi_union_meta_t meta;
+		idx_t i;
+		desc->kind = TCC_TYPEDESC_UNION;
+		memset(&meta, 0, sizeof(meta));
+		if (!tcc_parse_union_meta_token(token, &meta, error_buf)) {
+			tcc_typedesc_destroy(desc);
+			return false;
+		}
+		if (meta.member_count > 0) {
+			desc->as.union_like.members =
+			    (tcc_typedesc_field_t *)duckdb_malloc(sizeof(tcc_typedesc_field_t) * (size_t)meta.member_count);
+			if (!desc->as.union_like.members) {
+				tcc_union_meta_destroy(&meta);
+				tcc_typedesc_destroy(desc);
+				tcc_set_error(error_buf, "out of memory");
+				return false;
+			}
+			memset(desc->as.union_like.members, 0, sizeof(tcc_typedesc_field_t) * (size_t)meta.member_count);
+		}
+		desc->as.union_like.count = (idx_t)meta.member_count;
+		for (i = 0; i < (idx_t)meta.member_count; i++) {
+			const char *member_token = meta.member_tokens ? meta.member_tokens[i] : NULL;
+			desc->as.union_like.members[i].name = tcc_strdup(meta.member_names[i]);
+			if (!member_token || !desc->as.union_like.members[i].name ||
+			    !tcc_typedesc_parse_token(member_token, false, &desc->as.union_like.members[i].type, error_buf)) {
+				tcc_union_meta_destroy(&meta);
+				tcc_typedesc_destroy(desc);
+				if (!error_buf || error_buf->message[0] == '\0') {
+					tcc_set_error(error_buf, "out of memory");
+				}
+				return false;
+			}
+		}
+		tcc_union_meta_destroy(&meta);
+	} else {
+		desc->kind = TCC_TYPEDESC_PRIMITIVE;
+	}
+	*out_desc = desc;
+	return true;
+}
+
+/* tcc_parse_signature: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
+static bool tcc_parse_signature(const char *return_type, const char *arg_types_csv, tcc_ffi_type_t *out_return_type,
+		                                size_t *out_return_array_size, tcc_ffi_type_t **out_arg_types,
+		                                size_t **out_arg_array_sizes, tcc_ffi_struct_meta_t *out_return_struct_meta,
+		                                tcc_ffi_map_meta_t *out_return_map_meta,
+		                                tcc_ffi_union_meta_t *out_return_union_meta,
+		                                tcc_ffi_struct_meta_t **out_arg_struct_metas,
+		                                tcc_ffi_map_meta_t **out_arg_map_metas,
+		                                tcc_ffi_union_meta_t **out_arg_union_metas, int *out_arg_count,
+		                                tcc_error_buffer_t *error_buf) {
+	tcc_typedesc_t *return_desc = NULL;
+	tcc_typedesc_t *arg_desc = NULL;
+	tcc_string_list_t arg_tokens;
+	tcc_ffi_struct_meta_t return_struct_meta;
+	tcc_ffi_map_meta_t return_map_meta;
+	tcc_ffi_union_meta_t return_union_meta;
+	tcc_ffi_type_t *arg_types = NULL;
+	size_t *arg_array_sizes = NULL;
+	tcc_ffi_struct_meta_t *arg_struct_metas = NULL;
+	tcc_ffi_map_meta_t *arg_map_metas = NULL;
+	tcc_ffi_union_meta_t *arg_union_metas = NULL;
+	int argc = 0;
+	idx_t i;
+	memset(&arg_tokens, 0, sizeof(arg_tokens));
+	memset(&return_struct_meta, 0, sizeof(return_struct_meta));
+	memset(&return_map_meta, 0, sizeof(return_map_meta));
+	memset(&return_union_meta, 0, sizeof(return_union_meta));
+	if (!return_type || return_type[0] == '\0' || !out_return_type || !out_return_array_size || !out_arg_types ||
+	    !out_arg_array_sizes || !out_return_struct_meta || !out_return_map_meta || !out_return_union_meta ||
+	    !out_arg_struct_metas || !out_arg_map_metas || !out_arg_union_metas || !out_arg_count) {
+		tcc_set_error(error_buf, "return_type is required");
+		return false;
+	}
+	if (!arg_types_csv) {
+		tcc_set_error(error_buf, "arg_types is required (use [] for no args)");
+		return false;
+	}
+	if (!tcc_typedesc_parse_token(return_type, true, &return_desc, error_buf)) {
+		tcc_set_error(error_buf, "return_type contains unsupported type token");
+		return false;
+	}
+	if (return_desc->ffi_type == TCC_FFI_STRUCT &&
+	    !tcc_parse_struct_meta_token(return_desc->token, &return_struct_meta, error_buf)) {
+		goto fail;
+	}
+	if (return_desc->ffi_type == TCC_FFI_MAP &&
+	    !tcc_parse_map_meta_token(return_desc->token, &return_map_meta, error_buf)) {
+		goto fail;
+	}
+	if (return_desc->ffi_type == TCC_FFI_UNION &&
+	    !tcc_parse_union_meta_token(return_desc->token, &return_union_meta, error_buf)) {
+		goto fail;
+	}
+	if (!tcc_split_csv_tokens(arg_types_csv, &arg_tokens, error_buf)) {
+		goto fail;
+	}
+	argc = (int)arg_tokens.count;
+	if (argc > 0) {
+		arg_types = (tcc_ffi_type_t *)duckdb_malloc(sizeof(tcc_ffi_type_t) * (size_t)argc);
+		arg_array_sizes = (size_t *)duckdb_malloc(sizeof(size_t) * (size_t)argc);
+		arg_struct_metas = (tcc_ffi_struct_meta_t *)duckdb_malloc(sizeof(tcc_ffi_struct_meta_t) * (size_t)argc);
+		arg_map_metas = (tcc_ffi_map_meta_t *)duckdb_malloc(sizeof(tcc_ffi_map_meta_t) * (size_t)argc);
+		arg_union_metas = (tcc_ffi_union_meta_t *)duckdb_malloc(sizeof(tcc_ffi_union_meta_t) * (size_t)argc);
+		if (!arg_types || !arg_array_sizes || !arg_struct_metas || !arg_map_metas || !arg_union_metas) {
+			tcc_set_error(error_buf, "out of memory");
+			goto fail;
+		}
+		memset(arg_struct_metas, 0, sizeof(tcc_ffi_struct_meta_t) * (size_t)argc);
+		memset(arg_map_metas, 0, sizeof(tcc_ffi_map_meta_t) * (size_t)argc);
+		memset(arg_union_metas, 0, sizeof(tcc_ffi_union_meta_t) * (size_t)argc);
+	}
+	for (i = 0; i < (idx_t)argc; i++) {
+		if (!tcc_typedesc_parse_token(arg_tokens.items[i], false, &arg_desc, error_buf)) {
+			tcc_set_error(error_buf, "arg_types contains unsupported type token");
+			goto fail;
+		}
+		arg_types[i] = arg_desc->ffi_type;
+		arg_array_sizes[i] = arg_desc->array_size;
+		if (arg_types[i] == TCC_FFI_STRUCT && !tcc_parse_struct_meta_token(arg_desc->token, &arg_struct_metas[i], error_buf)) {
+			goto fail;
+		}
+		if (arg_types[i] == TCC_FFI_MAP && !tcc_parse_map_meta_token(arg_desc->token, &arg_map_metas[i], error_buf)) {
+			goto fail;
+		}
+		if (arg_types[i] == TCC_FFI_UNION && !tcc_parse_union_meta_token(arg_desc->token, &arg_union_metas[i], error_buf)) {
+			goto fail;
+		}
+		tcc_typedesc_destroy(arg_desc);
+		arg_desc = NULL;
+	}
+	*out_return_type = return_desc->ffi_type;
+	*out_return_array_size = return_desc->array_size;
+	*out_arg_types = arg_types;
+	*out_arg_array_sizes = arg_array_sizes;
+	*out_return_struct_meta = return_struct_meta;
+	*out_return_map_meta = return_map_meta;
+	*out_return_union_meta = return_union_meta;
+	*out_arg_struct_metas = arg_struct_metas;
+	*out_arg_map_metas = arg_map_metas;
+	*out_arg_union_metas = arg_union_metas;
+	*out_arg_count = argc;
+	tcc_string_list_destroy(&arg_tokens);
+	tcc_typedesc_destroy(return_desc);
+	return true;
+fail:
+	if (arg_desc) {
+		tcc_typedesc_destroy(arg_desc);
+	}
+	tcc_typedesc_destroy(return_desc);
+	tcc_string_list_destroy(&arg_tokens);
+	if (arg_types) {
+		duckdb_free(arg_types);
+	}
+	if (arg_array_sizes) {
+		duckdb_free(arg_array_sizes);
+	}
+	if (arg_struct_metas) {
+		tcc_struct_meta_array_destroy(arg_struct_metas, argc);
+	}
+	if (arg_map_metas) {
+		tcc_map_meta_array_destroy(arg_map_metas, argc);
+	}
+	if (arg_union_metas) {
+		tcc_union_meta_array_destroy(arg_union_metas, argc);
+	}
+	tcc_struct_meta_destroy(&return_struct_meta);
+	tcc_map_meta_destroy(&return_map_meta);
+	tcc_union_meta_destroy(&return_union_meta);
+	return false;
+}
+
+/* tcc_codegen_signature_ctx_init: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_codegen_signature_ctx_init(tcc_codegen_signature_ctx_t *ctx) {
+	if (!ctx) {
+		return;
+	}
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->return_type = TCC_FFI_I64;
+	ctx->wrapper_mode = TCC_WRAPPER_MODE_ROW;
+	ctx->stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+}
+
+/* tcc_codegen_signature_ctx_destroy: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
+static void tcc_codegen_signature_ctx_destroy(tcc_codegen_signature_ctx_t *ctx) {
+	if (!ctx) {
+		return;
+	}
+	if (ctx->arg_types) {
+		duckdb_free(ctx->arg_types);
+		ctx->arg_types = NULL;
+	}
+	if (ctx->arg_array_sizes) {
+		duckdb_free(ctx->arg_array_sizes);
+		ctx->arg_array_sizes = NULL;
+	}
+	if (ctx->arg_struct_metas) {
+		tcc_struct_meta_array_destroy(ctx->arg_struct_metas, ctx->arg_count);
+		ctx->arg_struct_metas = NULL;
+	}
+	if (ctx->arg_map_metas) {
+		tcc_map_meta_array_destroy(ctx->arg_map_metas, ctx->arg_count);
+		ctx->arg_map_metas = NULL;
+	}
+	if (ctx->arg_union_metas) {
+		tcc_union_meta_array_destroy(ctx->arg_union_metas, ctx->arg_count);
+		ctx->arg_union_metas = NULL;
+	}
+	tcc_struct_meta_destroy(&ctx->return_struct_meta);
+	tcc_map_meta_destroy(&ctx->return_map_meta);
+	tcc_union_meta_destroy(&ctx->return_union_meta);
+	ctx->arg_count = 0;
+	ctx->return_type = TCC_FFI_I64;
+	ctx->return_array_size = 0;
+	ctx->wrapper_mode = TCC_WRAPPER_MODE_ROW;
+	ctx->wrapper_mode_token = NULL;
+	ctx->stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+	ctx->stability_token = NULL;
+}
+
+/* tcc_codegen_signature_parse_types: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_codegen_signature_parse_types(const tcc_module_bind_data_t *bind, tcc_codegen_signature_ctx_t *ctx,
+                                              tcc_error_buffer_t *error_buf) {
+	if (!bind || !ctx) {
+		tcc_set_error(error_buf, "invalid codegen signature arguments");
+		return false;
+	}
+	return tcc_parse_signature(bind->return_type, bind->arg_types, &ctx->return_type, &ctx->return_array_size,
+	                           &ctx->arg_types, &ctx->arg_array_sizes, &ctx->return_struct_meta,
+	                           &ctx->return_map_meta, &ctx->return_union_meta, &ctx->arg_struct_metas,
+	                           &ctx->arg_map_metas, &ctx->arg_union_metas, &ctx->arg_count, error_buf);
+}
+
+/* tcc_codegen_signature_parse_wrapper_mode: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_codegen_signature_parse_wrapper_mode(const tcc_module_bind_data_t *bind,
+                                                     tcc_codegen_signature_ctx_t *ctx,
+                                                     tcc_error_buffer_t *error_buf) {
+	if (!bind || !ctx) {
+		tcc_set_error(error_buf, "invalid codegen wrapper_mode arguments");
+		return false;
+	}
+	if (!tcc_parse_wrapper_mode(bind->wrapper_mode, &ctx->wrapper_mode, error_buf)) {
+		return false;
+	}
+	ctx->wrapper_mode_token = tcc_wrapper_mode_token(ctx->wrapper_mode);
+	if (!ctx->wrapper_mode_token) {
+		tcc_set_error(error_buf, "wrapper_mode contains unsupported token");
+		return false;
+	}
+	if (tcc_wrapper_mode_is(bind->wrapper_mode, "chunk_columnar")) {
+		if (!tcc_columnar_return_supported(ctx->return_type, &ctx->return_struct_meta)) {
+			tcc_set_error(error_buf, "wrapper_mode chunk_columnar needs a struct return_type of fixed-width fields");
+			return false;
+		}
+		ctx->wrapper_mode_token = "chunk_columnar";
+	} else if (tcc_wrapper_mode_is(bind->wrapper_mode, "predicate")) {
+		if (!tcc_predicate_signature_supported(ctx->return_type, ctx->arg_types, ctx->arg_count)) {
+			tcc_set_error(error_buf, "wrapper_mode predicate needs a bool return_type and fixed-width arg_types");
+			return false;
+		}
+		ctx->wrapper_mode_token = "predicate";
+	}
+	if (ctx->wrapper_mode == TCC_WRAPPER_MODE_ARROW) {
+		int i;
+		if (!tcc_arrow_format_for_type(ctx->return_type)) {
+			tcc_set_error(error_buf, "wrapper_mode arrow does not support this return_type");
+			return false;
+		}
+		for (i = 0; i < ctx->arg_count; i++) {
+			if (!tcc_arrow_format_for_type(ctx->arg_types[i])) {
+				tcc_set_error(error_buf, "wrapper_mode arrow does not support one of the arg_types");
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/* tcc_codegen_source_ctx_init: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_codegen_source_ctx_init(tcc_codegen_source_ctx_t *ctx) {
+	if (!ctx) {
+		return;
+	}
+	memset(ctx, 0, sizeof(*ctx));
+	tcc_codegen_signature_ctx_init(&ctx->signature);
+}
+
+/* tcc_codegen_source_ctx_destroy: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
+static void tcc_codegen_source_ctx_destroy(tcc_codegen_source_ctx_t *ctx) {
+	if (!ctx) {
+		return;
+	}
+	if (ctx->compilation_unit_source) {
+		duckdb_free(ctx->compilation_unit_source);
+		ctx->compilation_unit_source = NULL;
+	}
+	if (ctx->wrapper_loader_source) {
+		duckdb_free(ctx->wrapper_loader_source);
+		ctx->wrapper_loader_source = NULL;
+	}
+	tcc_codegen_signature_ctx_destroy(&ctx->signature);
+	memset(ctx->module_symbol, 0, sizeof(ctx->module_symbol));
+}
+
+/* tcc_type_param_supported: `type_params` tokens must be fixed-width numeric scalars with a plain C spelling. */
+static bool tcc_type_param_supported(tcc_ffi_type_t type) {
+	switch (type) {
+	case TCC_FFI_I8:
+	case TCC_FFI_U8:
+	case TCC_FFI_I16:
+	case TCC_FFI_U16:
+	case TCC_FFI_I32:
+	case TCC_FFI_U32:
+	case TCC_FFI_I64:
+	case TCC_FFI_U64:
+	case TCC_FFI_F32:
+	case TCC_FFI_F64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* tcc_type_param_substitute: rebuilds a signature CSV with every standalone `T` token replaced by `type_token`.
+ * Allocation/Lifetime: returns a duckdb_malloc string owned by the caller; *out_found reports whether T occurred. */
+static char *tcc_type_param_substitute(const char *csv, const char *type_token, bool *out_found,
+                                       tcc_error_buffer_t *error_buf) {
+	tcc_string_list_t tokens;
+	tcc_text_buf_t out = {0};
+	char *result = NULL;
+	idx_t i;
+	bool ok = true;
+	memset(&tokens, 0, sizeof(tokens));
+	if (!tcc_split_csv_tokens(csv ? csv : "", &tokens, error_buf)) {
+		return NULL;
+	}
+	for (i = 0; i < tokens.count && ok; i++) {
+		bool is_t = strcmp(tokens.items[i], "T") == 0;
+		*out_found = *out_found || is_t;
+		ok = tcc_text_buf_appendf(&out, "%s%s", i == 0 ? "" : ",", is_t ? type_token : tokens.items[i]);
+	}
+	if (ok) {
+		result = tcc_strdup(out.data ? out.data : "");
+	}
+	if (!result) {
+		tcc_set_error(error_buf, "out of memory");
+	}
+	tcc_text_buf_destroy(&out);
+	tcc_string_list_destroy(&tokens);
+	return result;
+}
+
+/**
+ * @function tcc_codegen_prepare_generic_sources
+ * @brief Expands a `type_params` kernel into one instantiation per type inside a single compilation unit.
+ * @param[in] state Module state (session ids name the module init).
+ * @param[in] bind Bind data with `type_params`, `source`, and `T`-bearing `arg_types`/`return_type`.
+ * @param[in] sql_name SQL name every instantiation registers as an overload of.
+ * @param[in] target_symbol Generic entry point; instantiation `t` is renamed to `<symbol>__<t>`.
+ * @param[out] ctx Receives the wrapper/loader text and the compilation unit.
+ * @param[out] error_buf Error buffer for signature and allocation failures.
+ * @return true on success.
+ * @ownership borrows(state, bind, sql_name, target_symbol), transfers(ctx sources to caller)
+ * @heap allocates the unit text; released by tcc_codegen_source_ctx_destroy.
+ * @note The user source is pasted once per type between `#define T <c type>` and `#undef T`, with
+ * `#define <symbol> <symbol>__<t>` renaming the entry point and `T_NAME(x)` naming per-type helpers.
+ * The module init registers the instantiations in order and stops at the first failure. Overloads registered
+ * before it stay live in DuckDB, so tcc_codegen_load_unit keeps the artifact alive for them
+ * (tcc_artifact_release_failed_init) while the compile still reports the failure.
+ */
+static bool tcc_codegen_prepare_generic_sources(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                                const char *sql_name, const char *target_symbol,
+                                                tcc_codegen_source_ctx_t *ctx, tcc_error_buffer_t *error_buf) {
+	tcc_string_list_t params;
+	tcc_text_buf_t user = {0};
+	tcc_text_buf_t wrappers = {0};
+	tcc_text_buf_t inits = {0};
+	tcc_function_stability_t stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+	const char *stability_token;
+	idx_t i;
+	bool ok = true;
+	memset(&params, 0, sizeof(params));
+	if (bind->specialize && bind->specialize[0] != '\0') {
+		tcc_set_error(error_buf, "type_params cannot be combined with specialize");
+		return false;
+	}
+	if (!bind->source || bind->source[0] == '\0' || !tcc_fuse_is_c_identifier(target_symbol)) {
+		tcc_set_error(error_buf, "type_params needs an inline source and a C identifier symbol");
+		return false;
+	}
+	if (!tcc_split_csv_tokens(bind->type_params, &params, error_buf)) {
+		return false;
+	}
+	if (params.count == 0 || params.count > 16) {
+		tcc_string_list_destroy(&params);
+		tcc_set_error(error_buf, "type_params takes 1 to 16 type tokens");
+		return false;
+	}
+	/* A repeated overload would fail to register after the earlier ones already went live; compare parsed types so
+	 * spellings of one type (`i64`, `I64`) count as the same entry. */
+	for (i = 1; i < params.count; i++) {
+		tcc_ffi_type_t type_i;
+		size_t array_i = 0;
+		idx_t j;
+		if (!tcc_parse_type_token(params.items[i], false, &type_i, &array_i)) {
+			continue;
+		}
+		for (j = 0; j < i; j++) {
+			tcc_ffi_type_t type_j;
+			size_t array_j = 0;
+			if (tcc_parse_type_token(params.items[j], false, &type_j, &array_j) && type_i == type_j &&
+			    array_i == array_j) {
+				tcc_string_list_destroy(&params);
+				tcc_set_error(error_buf, "type_params entries must be distinct");
+				return false;
+			}
+		}
+	}
+	if (!tcc_parse_function_stability(tcc_effective_stability(state, bind), &stability, error_buf)) {
+		tcc_string_list_destroy(&params);
+		return false;
+	}
+	stability_token = tcc_function_stability_token(stability);
+	snprintf(ctx->module_symbol, sizeof(ctx->module_symbol), "__ducktinycc_ffi_init_%llu_%llu",
+	         (unsigned long long)state->session.state_id, (unsigned long long)state->session.config_version);
+	for (i = 0; i < params.count && ok; i++) {
+		const char *param = params.items[i];
+		tcc_module_bind_data_t inst = *bind;
+		tcc_codegen_signature_ctx_t sig;
+		tcc_ffi_type_t param_type;
+		size_t param_array_size = 0;
+		char inst_symbol[160];
+		char inst_module[160];
+		char *wrapper;
+		bool found = false;
+		ok = false;
+		if (!tcc_parse_type_token(param, false, &param_type, &param_array_size) ||
+		    !tcc_type_param_supported(param_type)) {
+			tcc_set_error(error_buf, "type_params entries must be numeric scalar type tokens (i8..u64, f32, f64)");
+			break;
+		}
+		inst.arg_types = tcc_type_param_substitute(bind->arg_types, param, &found, error_buf);
+		inst.return_type = tcc_type_param_substitute(bind->return_type ? bind->return_type : "i64", param, &found,
+		                                             error_buf);
+		tcc_codegen_signature_ctx_init(&sig);
+		if (inst.arg_types && inst.return_type && !found) {
+			tcc_set_error(error_buf, "type_params needs T in arg_types or return_type");
+		} else if (inst.arg_types && inst.return_type && tcc_codegen_signature_parse_types(&inst, &sig, error_buf) &&
+		           tcc_codegen_signature_parse_wrapper_mode(&inst, &sig, error_buf)) {
+			snprintf(inst_symbol, sizeof(inst_symbol), "%s__%s", target_symbol, param);
+			snprintf(inst_module, sizeof(inst_module), "%s_%s", ctx->module_symbol, param);
+			wrapper = tcc_codegen_generate_wrapper_source(inst_module, inst_symbol, sql_name, inst.return_type,
+			                                              inst.arg_types, sig.wrapper_mode_token, sig.wrapper_mode,
+			                                              stability_token, sig.return_type,
+			                                              sig.arg_types, sig.arg_count, false,
+			                                              tcc_perf_map_enabled(bind));
+			ok = wrapper && tcc_text_buf_appendf(&wrappers, "%s", wrapper) &&
+			     tcc_text_buf_appendf(&user,
+			                          "#define T %s\n#define T_NAME(name) name##__%s\n#define %s %s\n%s\n"
+			                          "#undef %s\n#undef T_NAME\n#undef T\n",
+			                          tcc_ffi_type_to_c_type_name(param_type), param, target_symbol, inst_symbol,
+			                          bind->source, target_symbol) &&
+			     tcc_text_buf_appendf(&inits, "%s%s(con)", i == 0 ? "" : " && ", inst_module);
+			if (wrapper) {
+				duckdb_free(wrapper);
+			}
+			if (!ok) {
+				tcc_set_error(error_buf, "failed to generate codegen wrapper");
+			}
+		}
+		if (i == 0 && ok) {
+			/* Keep the first instantiation's signature for callers that report it. */
+			tcc_codegen_signature_ctx_destroy(&ctx->signature);
+			ctx->signature = sig;
+			ctx->signature.stability = stability;
+			ctx->signature.stability_token = stability_token;
+		} else {
+			tcc_codegen_signature_ctx_destroy(&sig);
+		}
+		if (inst.arg_types) {
+			duckdb_free(inst.arg_types);
+		}
+		if (inst.return_type) {
+			duckdb_free(inst.return_type);
+		}
+	}
+	tcc_string_list_destroy(&params);
+	ok = ok && tcc_text_buf_appendf(&wrappers, "_Bool %s(duckdb_connection con) {\n  return %s;\n}\n",
+	                                ctx->module_symbol, inits.data);
+	if (ok) {
+		ctx->wrapper_loader_source = tcc_strdup(wrappers.data);
+		ctx->compilation_unit_source =
+		    ctx->wrapper_loader_source ? tcc_codegen_build_compilation_unit(user.data, wrappers.data) : NULL;
+		if (!ctx->compilation_unit_source) {
+			tcc_set_error(error_buf, "out of memory");
+			ok = false;
+		}
+	}
+	tcc_text_buf_destroy(&user);
+	tcc_text_buf_destroy(&wrappers);
+	tcc_text_buf_destroy(&inits);
+	return ok;
+}
+
+/* tcc_codegen_prepare_sources: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_codegen_prepare_sources(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                        const char *sql_name, const char *target_symbol,
+                                        tcc_codegen_source_ctx_t *ctx, tcc_error_buffer_t *error_buf) {
+	uint64_t t0 = tcc_now_ns();
+	if (!state || !bind || !sql_name || !target_symbol || !ctx) {
+		tcc_set_error(error_buf, "invalid codegen source arguments");
+		return false;
+	}
+	if (bind->type_params && bind->type_params[0] != '\0') {
+		return tcc_codegen_prepare_generic_sources(state, bind, sql_name, target_symbol, ctx, error_buf);
+	}
+	if (!tcc_codegen_signature_parse_types(bind, &ctx->signature, error_buf)) {
+		return false;
+	}
+	if (!tcc_codegen_signature_parse_wrapper_mode(bind, &ctx->signature, error_buf)) {
+		return false;
+	}
+	if (!tcc_parse_function_stability(tcc_effective_stability(state, bind), &ctx->signature.stability, error_buf)) {
+		return false;
+	}
+	ctx->signature.stability_token = tcc_function_stability_token(ctx->signature.stability);
+	if (!ctx->signature.stability_token) {
+		tcc_set_error(error_buf, "stability contains unsupported token");
+		return false;
+	}
+	ctx->parse_ns = tcc_now_ns() - t0;
+	snprintf(ctx->module_symbol, sizeof(ctx->module_symbol), "__ducktinycc_ffi_init_%llu_%llu",
+	         (unsigned long long)state->session.state_id, (unsigned long long)state->session.config_version);
+	ctx->wrapper_loader_source =
+	    tcc_codegen_generate_wrapper_source(ctx->module_symbol, target_symbol, sql_name,
+	                                        bind->return_type ? bind->return_type : "i64",
+	                                        bind->arg_types ? bind->arg_types : "",
+	                                        ctx->signature.wrapper_mode_token, ctx->signature.wrapper_mode,
+	                                        ctx->signature.stability_token, ctx->signature.return_type,
+	                                        ctx->signature.arg_types, ctx->signature.arg_count,
+	                                        /* emit_extern_decl: only when user source is NOT bundled in the
+	                                         * compilation unit.  When user_source is present, the definition
+	                                         * already provides the prototype; emitting an extern with our
+	                                         * stdint.h-derived type (e.g. int64_t) would conflict with user
+	                                         * code that uses a raw primitive (e.g. long long) for the same
+	                                         * 64-bit type, because on LP64 Linux int64_t == long != long long. */
+	                                        !(bind->source && bind->source[0] != '\0'), tcc_perf_map_enabled(bind));
+	if (!ctx->wrapper_loader_source) {
+		tcc_set_error(error_buf, "failed to generate codegen wrapper");
+		return false;
+	}
+	ctx->compilation_unit_source = tcc_codegen_build_compilation_unit(bind->source, ctx->wrapper_loader_source);
+	if (!ctx->compilation_unit_source) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	return true;
+}
+
+/* tcc_codegen_classify_error_message: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_codegen_classify_error_message(const char *error_message, const char **phase, const char **code,
+                                               const char **message) {
+	if (!error_message || !phase || !code || !message) {
+		return;
+	}
+	if (strstr(error_message, "wrapper_mode")) {
+		*phase = "bind";
+		*code = "E_BAD_WRAPPER_MODE";
+		*message = "invalid wrapper_mode";
+	} else if (strstr(error_message, "isolation must be") || strstr(error_message, "isolation := 'process' is not")) {
+		*phase = "bind";
+		*code = "E_BAD_ARGS";
+		*message = "invalid isolation";
+	} else if (strstr(error_message, "stability")) {
+		*phase = "bind";
+		*code = "E_BAD_STABILITY";
+		*message = "invalid stability";
+	} else if (strstr(error_message, "return_type") || strstr(error_message, "arg_types") ||
+	           strstr(error_message, "struct token") || strstr(error_message, "map token") ||
+	           strstr(error_message, "fixed-width scalar tokens only") || strstr(error_message, "type_params") ||
+	           strstr(error_message, "used field")) {
+		*phase = "bind";
+		*code = "E_BAD_SIGNATURE";
+		*message = "invalid return_type/arg_types";
+	} else if (strstr(error_message, "failed to generate codegen wrapper") || strstr(error_message, "out of memory")) {
+		*phase = "codegen";
+		*code = "E_CODEGEN_FAILED";
+		*message = "ffi codegen failed";
+	} else if (strstr(error_message, "no persistent extension connection")) {
+		*phase = "load";
+		*code = "E_NO_CONNECTION";
+		*message = "no persistent extension connection available";
+	} else if (strstr(error_message, "generated module init returned false")) {
+		*phase = "load";
+		*code = "E_INIT_FAILED";
+		*message = "generated module init returned false";
+	}
+}
+
+/* Resolves target symbol from explicit args or session-level bound symbol. */
+static const char *tcc_effective_symbol(tcc_module_state_t *state, const tcc_module_bind_data_t *bind) {
+	if (bind->symbol && bind->symbol[0] != '\0') {
+		return bind->symbol;
+	}
+	if (state->session.bound_symbol && state->session.bound_symbol[0] != '\0') {
+		return state->session.bound_symbol;
+	}
+	return NULL;
+}
+
+/* Resolves SQL function name from explicit args or session-level fallback. */
+static const char *tcc_effective_sql_name(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                          const char *effective_symbol) {
+	if (bind->sql_name && bind->sql_name[0] != '\0') {
+		return bind->sql_name;
+	}
+	if (state->session.bound_sql_name && state->session.bound_sql_name[0] != '\0') {
+		return state->session.bound_sql_name;
+	}
+	return effective_symbol;
+}
+
+/* Resolves function stability from explicit args, session-level binding, or default. */
+static const char *tcc_effective_stability(tcc_module_state_t *state, const tcc_module_bind_data_t *bind) {
+	if (bind && bind->stability && bind->stability[0] != '\0') {
+		return bind->stability;
+	}
+	if (state && state->session.bound_stability && state->session.bound_stability[0] != '\0') {
+		return state->session.bound_stability;
+	}
+	return "consistent";
+}
+
+static const char *tcc_ffi_type_to_token(tcc_ffi_type_t type) {
+	if (tcc_ffi_type_is_list(type)) {
+		return "list";
+	}
+	if (tcc_ffi_type_is_array(type)) {
+		return "array";
+	}
+	switch (type) {
+#define TCC_FFI_TOKEN_CASE(type_id, token_str, c_type_name, duckdb_type_id, width_bytes)                                   \
+	case type_id:                                                                                                          \
+		return token_str;
+		TCC_FFI_SCALAR_ROWS(TCC_FFI_TOKEN_CASE)
+#undef TCC_FFI_TOKEN_CASE
+	case TCC_FFI_PTR:
+		return "ptr";
+	case TCC_FFI_VARCHAR:
+		return "varchar";
+	case TCC_FFI_BLOB:
+		return "blob";
+	case TCC_FFI_STRUCT:
+		return "struct";
+	case TCC_FFI_MAP:
+		return "map";
+	case TCC_FFI_UNION:
+		return "union";
+	default:
+		return NULL;
+	}
+}
+
+static const char *tcc_ffi_type_to_c_type_name(tcc_ffi_type_t type) {
+	if (tcc_ffi_type_is_list(type)) {
+		return "ducktinycc_list_t";
+	}
+	if (tcc_ffi_type_is_array(type)) {
+		return "ducktinycc_array_t";
+	}
+	switch (type) {
+	case TCC_FFI_VOID:
+		return "void";
+#define TCC_FFI_CTYPE_CASE(type_id, token_str, c_type_name, duckdb_type_id, width_bytes)                                   \
+	case type_id:                                                                                                          \
+		return c_type_name;
+		TCC_FFI_SCALAR_ROWS(TCC_FFI_CTYPE_CASE)
+#undef TCC_FFI_CTYPE_CASE
+	case TCC_FFI_PTR:
+		return "void *";
+	case TCC_FFI_VARCHAR:
+		return "const char *";
+	case TCC_FFI_BLOB:
+		return "ducktinycc_blob_t";
+	case TCC_FFI_UUID:
+		return "ducktinycc_hugeint_t";
+	case TCC_FFI_DATE:
+		return "ducktinycc_date_t";
+	case TCC_FFI_TIME:
+		return "ducktinycc_time_t";
+	case TCC_FFI_TIMESTAMP:
+		return "ducktinycc_timestamp_t";
+	case TCC_FFI_INTERVAL:
+		return "ducktinycc_interval_t";
+	case TCC_FFI_DECIMAL:
+		return "ducktinycc_decimal_t";
+	case TCC_FFI_STRUCT:
+		return "ducktinycc_struct_t";
+	case TCC_FFI_MAP:
+		return "ducktinycc_map_t";
+	case TCC_FFI_UNION:
+		return "ducktinycc_union_t";
+	default:
+		return NULL;
+	}
+}
+#undef TCC_FFI_SCALAR_ROWS
+
+/* ===== Section: Wrapper/Helper Code Generation ===== */
+
+/* tcc_codegen_ret_null_check: Returns the C expression that tests whether a return value should be treated as NULL.
+ * Returns NULL for VOID (special case) and for plain scalars (no null-check). */
+static const char *tcc_codegen_ret_null_check(tcc_ffi_type_t ret_type) {
+	if (ret_type == TCC_FFI_VOID) {
+		return NULL;
+	}
+	if (ret_type == TCC_FFI_VARCHAR) {
+		return "!result";
+	}
+	if (ret_type == TCC_FFI_BLOB) {
+		return "result.len > 0 && !result.ptr";
+	}
+	if (ret_type == TCC_FFI_PTR) {
+		return "!result";
+	}
+	if (tcc_ffi_type_is_list(ret_type) || tcc_ffi_type_is_array(ret_type)) {
+		return "result.len > 0 && !result.ptr";
+	}
+	if (tcc_ffi_type_is_struct(ret_type)) {
+		return "!result.field_ptrs || result.field_count == 0";
+	}
+	if (tcc_ffi_type_is_map(ret_type)) {
+		return "result.len > 0 && (!result.key_ptr || !result.value_ptr)";
+	}
+	if (tcc_ffi_type_is_union(ret_type)) {
+		return "!result.tag_ptr || !result.member_ptrs || result.member_count == 0";
+	}
+	/* Plain scalar: no null-check */
+	return NULL;
+}
+
+static char *tcc_codegen_generate_wrapper_source(const char *module_symbol, const char *target_symbol,
+                                                 const char *sql_name, const char *return_type,
+                                                 const char *arg_types_csv, const char *wrapper_mode_token,
+                                                 tcc_wrapper_mode_t wrapper_mode, const char *stability_token,
+                                                 tcc_ffi_type_t ret_type, const tcc_ffi_type_t *arg_types,
+                                                 int arg_count, bool emit_extern_decl, bool export_wrapper) {
+	tcc_text_buf_t args_decl = {0};
+	tcc_text_buf_t row_unpack_lines = {0};
+	tcc_text_buf_t row_call_args = {0};
+	tcc_text_buf_t batch_col_decls = {0};
+	tcc_text_buf_t batch_call_args = {0};
+	tcc_text_buf_t batch_null_checks = {0};
+	tcc_text_buf_t src = {0};
+	const char *ret_c_type = tcc_ffi_type_to_c_type_name(ret_type);
+	const char *resolved_wrapper_mode = wrapper_mode_token ? wrapper_mode_token : tcc_wrapper_mode_token(wrapper_mode);
+	/* Wrappers stay file-local unless perf-map output needs them listed among the module's global symbols. */
+	const char *linkage = export_wrapper ? "" : "static ";
+	char *wrapper_name = NULL;
+	char *out_src = NULL;
+	size_t wrapper_len;
+	int i;
+	bool ok = true;
+	if (!ret_c_type) {
+		return NULL;
+	}
+	if (!module_symbol || !target_symbol || !sql_name || !return_type || !arg_types_csv || !resolved_wrapper_mode ||
+	    !stability_token || arg_count < 0) {
+		return NULL;
+	}
+	wrapper_len = strlen("__ducktinycc_wrapper_") + strlen(module_symbol) + 1;
+	wrapper_name = (char *)duckdb_malloc(wrapper_len);
+	if (!wrapper_name) {
+		return NULL;
+	}
+	snprintf(wrapper_name, wrapper_len, "__ducktinycc_wrapper_%s", module_symbol);
+	for (i = 0; i < arg_count; i++) {
+		const char *arg_c_type = tcc_ffi_type_to_c_type_name(arg_types[i]);
+		if (!arg_c_type) {
+			ok = false;
+			break;
+		}
+		if (!tcc_text_buf_appendf(&args_decl, "%s%s a%d", i == 0 ? "" : ", ", arg_c_type, i)) {
+			ok = false;
+			break;
+		}
+		if (arg_types[i] == TCC_FFI_PTR) {
+			if (!tcc_text_buf_appendf(&row_unpack_lines,
+			                          "  void *a%d = (void *)(uintptr_t)(*(unsigned long long *)args[%d]);\n", i, i) ||
+			    !tcc_text_buf_appendf(&row_call_args, "%sa%d", i == 0 ? "" : ", ", i) ||
+			    !tcc_text_buf_appendf(&batch_col_decls, "  unsigned long long *col%d_ptr = (unsigned long long *)arg_data[%d];\n",
+			                          i, i) ||
+			    !tcc_text_buf_appendf(&batch_call_args, "%s(void *)(uintptr_t)col%d_ptr[row]", i == 0 ? "" : ", ", i) ||
+			    !tcc_text_buf_appendf(
+			        &batch_null_checks,
+			        "%s(arg_validity[%d] && ((arg_validity[%d][row >> 6] & (1ULL << (row & 63))) == 0))",
+			        i == 0 ? "" : " || ", i, i)) {
+				ok = false;
+				break;
+			}
+		} else {
+			if (!tcc_text_buf_appendf(&row_unpack_lines, "  %s a%d = *(%s *)args[%d];\n", arg_c_type, i, arg_c_type, i) ||
+			    !tcc_text_buf_appendf(&row_call_args, "%sa%d", i == 0 ? "" : ", ", i) ||
+			    !tcc_text_buf_appendf(&batch_col_decls, "  %s *col%d = (%s *)arg_data[%d];\n", arg_c_type, i, arg_c_type,
+			                          i) ||
+			    !tcc_text_buf_appendf(&batch_call_args, "%scol%d[row]", i == 0 ? "" : ", ", i) ||
+			    !tcc_text_buf_appendf(
+			        &batch_null_checks,
+			        "%s(arg_validity[%d] && ((arg_validity[%d][row >> 6] & (1ULL << (row & 63))) == 0))",
+			        i == 0 ? "" : " || ", i, i)) {
+				ok = false;
+				break;
+			}
+		}
+	}
+	if (ok && arg_count == 0) {
+		ok = tcc_text_buf_appendf(&args_decl, "void");
+	}
+	if (ok && wrapper_mode == TCC_WRAPPER_MODE_ROW) {
+		ok = tcc_text_buf_appendf(
+		    &src,
+		    "#include <stdint.h>\n"
+		    "typedef struct _duckdb_connection *duckdb_connection;\n"
+		    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
+		    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
+		/* Emit an extern forward declaration of the user function only when the user source
+		 * is NOT bundled in the same compilation unit (i.e. the function is defined via a
+		 * separate session source or symbol injection).  When user source IS present in the
+		 * compilation unit it already provides the prototype; emitting an extern with our
+		 * stdint.h-derived type (e.g. int64_t) would conflict if the user wrote a raw
+		 * primitive (e.g. long long) — which on LP64 Linux resolves to a different type. */
+		if (ok && emit_extern_decl) {
+			ok = tcc_text_buf_appendf(&src, "extern %s %s(%s);\n",
+			                          ret_c_type, target_symbol,
+			                          args_decl.data ? args_decl.data : "");
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(
+			    &src,
+			    "%s_Bool %s(void **args, void *out_value, _Bool *out_is_null) {\n%s",
+			    linkage, wrapper_name,
+			    row_unpack_lines.data ? row_unpack_lines.data : "");
+		}
+		if (ok && ret_type == TCC_FFI_VOID) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "  %s(%s);\n"
+			                          "  if (out_is_null) { *out_is_null = 1; }\n"
+			                          "  (void)out_value;\n"
+			                          "  return 1;\n"
+			                          "}\n",
+			                          target_symbol, row_call_args.data ? row_call_args.data : "");
+		} else if (ok && ret_type == TCC_FFI_PTR) {
+			const char *nc = tcc_codegen_ret_null_check(ret_type);
+			ok = tcc_text_buf_appendf(&src,
+			                          "  void *result = (void *)%s(%s);\n"
+			                          "  if (%s) {\n"
+			                          "    if (out_is_null) { *out_is_null = 1; }\n"
+			                          "    return 1;\n"
+			                          "  }\n"
+			                          "  *(unsigned long long *)out_value = (unsigned long long)(uintptr_t)result;\n"
+			                          "  if (out_is_null) { *out_is_null = 0; }\n"
+			                          "  return 1;\n"
+			                          "}\n",
+			                          target_symbol, row_call_args.data ? row_call_args.data : "", nc);
+		} else if (ok) {
+			const char *nc = tcc_codegen_ret_null_check(ret_type);
+			ok = tcc_text_buf_appendf(&src, "  %s result = %s(%s);\n",
+			                          ret_c_type, target_symbol, row_call_args.data ? row_call_args.data : "");
+			if (ok && nc) {
+				ok = tcc_text_buf_appendf(&src,
+				                          "  if (%s) {\n"
+				                          "    if (out_is_null) { *out_is_null = 1; }\n"
+				                          "    return 1;\n"
+				                          "  }\n", nc);
+			}
+			if (ok) {
+				ok = tcc_text_buf_appendf(&src,
+				                          "  *(%s *)out_value = result;\n"
+				                          "  if (out_is_null) { *out_is_null = 0; }\n"
+				                          "  return 1;\n"
+				                          "}\n", ret_c_type);
+			}
+		}
+	} else if (ok && wrapper_mode == TCC_WRAPPER_MODE_BATCH &&
+	           tcc_wrapper_mode_is(resolved_wrapper_mode, "predicate")) {
+		/* The kernel sees whole argument columns and sets bit `row` of `mask` for every selected row; NULL
+		 * arguments are masked out by the host afterwards. */
+		tcc_text_buf_t pred_decl = {0};
+		tcc_text_buf_t pred_args = {0};
+		for (i = 0; i < arg_count && ok; i++) {
+			const char *arg_c_type = tcc_ffi_type_to_c_type_name(arg_types[i]);
+			ok = tcc_text_buf_appendf(&pred_decl, "const %s *a%d, ", arg_c_type, i) &&
+			     tcc_text_buf_appendf(&pred_args, "(const %s *)arg_data[%d], ", arg_c_type, i);
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(
+			    &src,
+			    "#include <stdint.h>\n"
+			    "typedef struct _duckdb_connection *duckdb_connection;\n"
+			    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
+			    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
+		}
+		if (ok && emit_extern_decl) {
+			ok = tcc_text_buf_appendf(&src, "extern void %s(%suint64_t count, uint64_t *mask);\n", target_symbol,
+			                          pred_decl.data ? pred_decl.data : "");
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "%s_Bool %s(void **arg_data, uint64_t **arg_validity, uint64_t count, "
+			                          "void *out_data, uint64_t *out_validity) {\n"
+			                          "  (void)arg_validity;\n"
+			                          "  (void)out_validity;\n"
+			                          "  %s(%scount, (uint64_t *)out_data);\n"
+			                          "  return 1;\n"
+			                          "}\n",
+			                          linkage, wrapper_name, target_symbol, pred_args.data ? pred_args.data : "");
+		}
+		tcc_text_buf_destroy(&pred_decl);
+		tcc_text_buf_destroy(&pred_args);
+	} else if (ok && wrapper_mode == TCC_WRAPPER_MODE_BATCH &&
+	           tcc_wrapper_mode_is(resolved_wrapper_mode, "chunk_columnar")) {
+		/* The kernel stores each field of row `row` into out->field_ptrs[i]; returning 0 makes the row NULL. */
+		ok = tcc_text_buf_appendf(
+		    &src,
+		    "#include <stdint.h>\n"
+		    "typedef struct _duckdb_connection *duckdb_connection;\n"
+		    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
+		    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
+		if (ok && emit_extern_decl) {
+			ok = tcc_text_buf_appendf(&src, "extern _Bool %s(%s%sducktinycc_struct_out_t *out, uint64_t row);\n",
+			                          target_symbol, arg_count > 0 ? args_decl.data : "", arg_count > 0 ? ", " : "");
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(
+			    &src,
+			    "%s_Bool %s(void **arg_data, uint64_t **arg_validity, uint64_t count, void *out_data, uint64_t "
+			    "*out_validity) {\n%s"
+			    "  ducktinycc_struct_out_t *out = (ducktinycc_struct_out_t *)out_data;\n"
+			    "  for (uint64_t row = 0; row < count; row++) {\n",
+			    linkage, wrapper_name, batch_col_decls.data ? batch_col_decls.data : "");
+		}
+		if (ok && arg_count > 0) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "    if (%s) {\n"
+			                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
+			                          "      continue;\n"
+			                          "    }\n",
+			                          batch_null_checks.data ? batch_null_checks.data : "");
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "    if (!%s(%s%sout, row) && out_validity) {\n"
+			                          "      out_validity[row >> 6] &= ~(1ULL << (row & 63));\n"
+			                          "    }\n"
+			                          "  }\n"
+			                          "  return 1;\n"
+			                          "}\n",
+			                          target_symbol, arg_count > 0 ? batch_call_args.data : "", arg_count > 0 ? ", " : "");
+		}
+	} else if (ok && wrapper_mode == TCC_WRAPPER_MODE_BATCH) {
+		ok = tcc_text_buf_appendf(
+		    &src,
+		    "#include <stdint.h>\n"
+		    "typedef struct _duckdb_connection *duckdb_connection;\n"
+		    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
+		    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
+		if (ok && emit_extern_decl) {
+			ok = tcc_text_buf_appendf(&src, "extern %s %s(%s);\n",
+			                          ret_c_type, target_symbol,
+			                          args_decl.data ? args_decl.data : "");
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(
+			    &src,
+			    "%s_Bool %s(void **arg_data, uint64_t **arg_validity, uint64_t count, void *out_data, uint64_t "
+			    "*out_validity) {\n%s",
+			    linkage, wrapper_name,
+			    batch_col_decls.data ? batch_col_decls.data : "");
+		}
+		if (ok && ret_type == TCC_FFI_VOID) {
+			ok = tcc_text_buf_appendf(&src, "  (void)out_data;\n");
+		} else if (ok && ret_type == TCC_FFI_PTR) {
+			ok = tcc_text_buf_appendf(&src, "  unsigned long long *out = (unsigned long long *)out_data;\n");
+		} else if (ok) {
+			ok = tcc_text_buf_appendf(&src, "  %s *out = (%s *)out_data;\n", ret_c_type, ret_c_type);
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(&src, "  for (uint64_t row = 0; row < count; row++) {\n");
+		}
+		if (ok && arg_count > 0) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "    if (%s) {\n"
+			                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
+			                          "      continue;\n"
+			                          "    }\n",
+			                          batch_null_checks.data ? batch_null_checks.data : "");
+		}
+		if (ok && ret_type == TCC_FFI_VOID) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "    %s(%s);\n"
+			                          "    if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n",
+			                          target_symbol, batch_call_args.data ? batch_call_args.data : "");
+		} else if (ok && ret_type == TCC_FFI_PTR) {
+			const char *nc = tcc_codegen_ret_null_check(ret_type);
+			ok = tcc_text_buf_appendf(&src,
+			                          "    void *result = (void *)%s(%s);\n"
+			                          "    if (%s) {\n"
+			                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
+			                          "      continue;\n"
+			                          "    }\n"
+			                          "    out[row] = (unsigned long long)(uintptr_t)result;\n",
+			                          target_symbol, batch_call_args.data ? batch_call_args.data : "", nc);
+		} else if (ok) {
+			const char *nc = tcc_codegen_ret_null_check(ret_type);
+			if (nc) {
+				ok = tcc_text_buf_appendf(&src,
+				                          "    %s result = %s(%s);\n"
+				                          "    if (%s) {\n"
+				                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
+				                          "      continue;\n"
+				                          "    }\n"
+				                          "    out[row] = result;\n",
+				                          ret_c_type, target_symbol,
+				                          batch_call_args.data ? batch_call_args.data : "", nc);
+			} else {
+				ok = tcc_text_buf_appendf(&src, "    out[row] = %s(%s);\n", target_symbol,
+				                          batch_call_args.data ? batch_call_args.data : "");
+			}
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "  }\n"
+			                          "  return 1;\n"
+			                          "}\n");
+		}
+	} else if (ok && wrapper_mode == TCC_WRAPPER_MODE_ARROW) {
+		/* Arrow entry points take the whole chunk; the wrapper is a plain trampoline with a stable name. */
+		ok = tcc_text_buf_appendf(
+		    &src,
+		    "#include <stdint.h>\n"
+		    "typedef struct _duckdb_connection *duckdb_connection;\n"
+		    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
+		    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
+		if (ok && emit_extern_decl) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "extern _Bool %s(const struct ArrowSchema *schema, const struct ArrowArray *input, "
+			                          "struct ArrowArray *out);\n",
+			                          target_symbol);
+		}
+		if (ok) {
+			ok = tcc_text_buf_appendf(&src,
+			                          "%s_Bool %s(const struct ArrowSchema *schema, const struct ArrowArray *input, "
+			                          "struct ArrowArray *out) {\n"
+			                          "  return %s(schema, input, out) ? 1 : 0;\n"
+			                          "}\n",
+			                          linkage, wrapper_name, target_symbol);
+		}
+	} else {
+		ok = false;
+	}
+	if (ok) {
+		ok = tcc_text_buf_appendf(&src,
+		                          "_Bool %s(duckdb_connection con) {\n"
+		                          "  return ducktinycc_register_signature(con, \"%s\", (void *)%s, \"%s\", \"%s\", "
+		                          "\"%s\", \"%s\");\n"
+		                          "}\n",
+		                          module_symbol, sql_name, wrapper_name, return_type, arg_types_csv,
+		                          resolved_wrapper_mode, stability_token);
+	}
+	if (ok && src.data) {
+		out_src = tcc_strdup(src.data);
+	}
+	if (wrapper_name) {
+		duckdb_free(wrapper_name);
+	}
+	tcc_text_buf_destroy(&args_decl);
+	tcc_text_buf_destroy(&row_unpack_lines);
+	tcc_text_buf_destroy(&row_call_args);
+	tcc_text_buf_destroy(&batch_col_decls);
+	tcc_text_buf_destroy(&batch_call_args);
+	tcc_text_buf_destroy(&batch_null_checks);
+	tcc_text_buf_destroy(&src);
+	return out_src;
+}
+
+static char *tcc_codegen_build_compilation_unit(const char *user_source, const char *wrapper_loader_source) {
+	char *compilation_unit_source;
+	const char *prelude = "#include <stdint.h>\n"
+	                      "/* Composite descriptors below are borrowed views from DuckDB vectors. */\n"
+	                      "/* Wrappers must not free them and must not retain them after invocation. */\n"
+	                      "typedef struct {\n"
+	                      "  uint64_t lower;\n"
+	                      "  int64_t upper;\n"
+	                      "} ducktinycc_hugeint_t;\n"
+	                      "typedef struct {\n"
+	                      "  const void *ptr;\n"
+	                      "  uint64_t len;\n"
+	                      "} ducktinycc_blob_t;\n"
+	                      "typedef struct {\n"
+	                      "  int32_t days;\n"
+	                      "} ducktinycc_date_t;\n"
+	                      "typedef struct {\n"
+	                      "  int64_t micros;\n"
+	                      "} ducktinycc_time_t;\n"
+	                      "typedef struct {\n"
+	                      "  int64_t micros;\n"
+	                      "} ducktinycc_timestamp_t;\n"
+	                      "typedef struct {\n"
+	                      "  int32_t months;\n"
+	                      "  int32_t days;\n"
+	                      "  int64_t micros;\n"
+	                      "} ducktinycc_interval_t;\n"
+	                      "typedef struct {\n"
+	                      "  uint8_t width;\n"
+	                      "  uint8_t scale;\n"
+	                      "  ducktinycc_hugeint_t value;\n"
+	                      "} ducktinycc_decimal_t;\n"
+	                      "typedef struct {\n"
+	                      "  const void *ptr;\n"
+	                      "  const uint64_t *validity;\n"
+	                      "  uint64_t offset;\n"
+	                      "  uint64_t len;\n"
+	                      "} ducktinycc_list_t;\n"
+	                      "typedef struct {\n"
+	                      "  const void *ptr;\n"
+	                      "  const uint64_t *validity;\n"
+	                      "  uint64_t offset;\n"
+	                      "  uint64_t len;\n"
+	                      "} ducktinycc_array_t;\n"
+	                      "typedef struct {\n"
+	                      "  const void *const *field_ptrs;\n"
+	                      "  const uint64_t *const *field_validity;\n"
+	                      "  uint64_t field_count;\n"
+	                      "  uint64_t offset;\n"
+	                      "} ducktinycc_struct_t;\n"
+	                      "/* wrapper_mode := 'chunk_columnar' STRUCT return: writable field columns of the output chunk. */\n"
+	                      "typedef struct {\n"
+	                      "  void *const *field_ptrs;\n"
+	                      "  uint64_t *const *field_validity;\n"
+	                      "  uint64_t field_count;\n"
+	                      "} ducktinycc_struct_out_t;\n"
+	                      "typedef struct {\n"
+	                      "  const void *key_ptr;\n"
+	                      "  const uint64_t *key_validity;\n"
+	                      "  const void *value_ptr;\n"
+		                      "  const uint64_t *value_validity;\n"
+		                      "  uint64_t offset;\n"
+		                      "  uint64_t len;\n"
+		                      "} ducktinycc_map_t;\n"
+	                      "typedef struct {\n"
+	                      "  const uint8_t *tag_ptr;\n"
+	                      "  const void *const *member_ptrs;\n"
+	                      "  const uint64_t *const *member_validity;\n"
+	                      "  uint64_t member_count;\n"
+	                      "  uint64_t offset;\n"
+	                      "} ducktinycc_union_t;\n"
+	                      "/* Arrow C Data Interface (wrapper_mode := 'arrow'); schema/input are borrowed for the call. */\n"
+	                      "#ifndef ARROW_C_DATA_INTERFACE\n"
+	                      "#define ARROW_C_DATA_INTERFACE\n"
+	                      "#define ARROW_FLAG_DICTIONARY_ORDERED 1\n"
+	                      "#define ARROW_FLAG_NULLABLE 2\n"
+	                      "#define ARROW_FLAG_MAP_KEYS_SORTED 4\n"
+	                      "struct ArrowSchema {\n"
+	                      "  const char *format;\n"
+	                      "  const char *name;\n"
+	                      "  const char *metadata;\n"
+	                      "  int64_t flags;\n"
+	                      "  int64_t n_children;\n"
+	                      "  struct ArrowSchema **children;\n"
+	                      "  struct ArrowSchema *dictionary;\n"
+	                      "  void (*release)(struct ArrowSchema *);\n"
+	                      "  void *private_data;\n"
+	                      "};\n"
+	                      "struct ArrowArray {\n"
+	                      "  int64_t length;\n"
+	                      "  int64_t null_count;\n"
+	                      "  int64_t offset;\n"
+	                      "  int64_t n_buffers;\n"
+	                      "  int64_t n_children;\n"
+	                      "  const void **buffers;\n"
+	                      "  struct ArrowArray **children;\n"
+	                      "  struct ArrowArray *dictionary;\n"
+	                      "  void (*release)(struct ArrowArray *);\n"
+	                      "  void *private_data;\n"
+	                      "};\n"
+	                      "#endif\n"
+	                      "/* Accessor helpers below operate on caller-owned memory spans. */\n"
+		                      "extern int ducktinycc_valid_is_set(const uint64_t *validity, uint64_t idx);\n"
+		                      "extern void ducktinycc_valid_set(uint64_t *validity, uint64_t idx, int valid);\n"
+		                      "extern int ducktinycc_span_contains(uint64_t len, uint64_t idx);\n"
+		                      "extern const void *ducktinycc_ptr_add(const void *base, uint64_t byte_offset);\n"
+		                      "extern void *ducktinycc_ptr_add_mut(void *base, uint64_t byte_offset);\n"
+		                      "extern int ducktinycc_span_fits(uint64_t len, uint64_t offset, uint64_t width);\n"
+		                      "extern const void *ducktinycc_buf_ptr_at(const void *base, uint64_t len, uint64_t offset, uint64_t width);\n"
+		                      "extern void *ducktinycc_buf_ptr_at_mut(void *base, uint64_t len, uint64_t offset, uint64_t width);\n"
+		                      "extern int ducktinycc_read_bytes(const void *base, uint64_t len, uint64_t offset, void *out, uint64_t width);\n"
+		                      "extern int ducktinycc_write_bytes(void *base, uint64_t len, uint64_t offset, const void *in, uint64_t width);\n"
+		                      "extern int ducktinycc_read_i8(const void *base, uint64_t len, uint64_t offset, int8_t *out);\n"
+		                      "extern int ducktinycc_write_i8(void *base, uint64_t len, uint64_t offset, int8_t value);\n"
+		                      "extern int ducktinycc_read_u8(const void *base, uint64_t len, uint64_t offset, uint8_t *out);\n"
+		                      "extern int ducktinycc_write_u8(void *base, uint64_t len, uint64_t offset, uint8_t value);\n"
+		                      "extern int ducktinycc_read_i16(const void *base, uint64_t len, uint64_t offset, int16_t *out);\n"
+		                      "extern int ducktinycc_write_i16(void *base, uint64_t len, uint64_t offset, int16_t value);\n"
+		                      "extern int ducktinycc_read_u16(const void *base, uint64_t len, uint64_t offset, uint16_t *out);\n"
+		                      "extern int ducktinycc_write_u16(void *base, uint64_t len, uint64_t offset, uint16_t value);\n"
+		                      "extern int ducktinycc_read_i32(const void *base, uint64_t len, uint64_t offset, int32_t *out);\n"
+		                      "extern int ducktinycc_write_i32(void *base, uint64_t len, uint64_t offset, int32_t value);\n"
+		                      "extern int ducktinycc_read_u32(const void *base, uint64_t len, uint64_t offset, uint32_t *out);\n"
+		                      "extern int ducktinycc_write_u32(void *base, uint64_t len, uint64_t offset, uint32_t value);\n"
+		                      "extern int ducktinycc_read_i64(const void *base, uint64_t len, uint64_t offset, int64_t *out);\n"
+		                      "extern int ducktinycc_write_i64(void *base, uint64_t len, uint64_t offset, int64_t value);\n"
+		                      "extern int ducktinycc_read_u64(const void *base, uint64_t len, uint64_t offset, uint64_t *out);\n"
+		                      "extern int ducktinycc_write_u64(void *base, uint64_t len, uint64_t offset, uint64_t value);\n"
+		                      "extern int ducktinycc_read_f32(const void *base, uint64_t len, uint64_t offset, float *out);\n"
+		                      "extern int ducktinycc_write_f32(void *base, uint64_t len, uint64_t offset, float value);\n"
+		                      "extern int ducktinycc_read_f64(const void *base, uint64_t len, uint64_t offset, double *out);\n"
+		                      "extern int ducktinycc_write_f64(void *base, uint64_t len, uint64_t offset, double value);\n"
+		                      "extern int ducktinycc_read_ptr(const void *base, uint64_t len, uint64_t offset, const void **out);\n"
+		                      "extern int ducktinycc_write_ptr(void *base, uint64_t len, uint64_t offset, const void *value);\n"
+		                      "extern int ducktinycc_list_is_valid(const ducktinycc_list_t *list, uint64_t idx);\n"
+		                      "extern const void *ducktinycc_list_elem_ptr(const ducktinycc_list_t *list, uint64_t idx, uint64_t elem_size);\n"
+		                      "extern int ducktinycc_array_is_valid(const ducktinycc_array_t *arr, uint64_t idx);\n"
+		                      "extern const void *ducktinycc_array_elem_ptr(const ducktinycc_array_t *arr, uint64_t idx, uint64_t elem_size);\n"
+		                      "extern const void *ducktinycc_struct_field_ptr(const ducktinycc_struct_t *st, uint64_t idx);\n"
+		                      "extern int ducktinycc_struct_field_is_valid(const ducktinycc_struct_t *st, uint64_t field_idx);\n"
+		                      "extern const void *ducktinycc_map_key_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t key_size);\n"
+		                      "extern const void *ducktinycc_map_value_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t value_size);\n"
+		                      "extern int ducktinycc_map_key_is_valid(const ducktinycc_map_t *m, uint64_t idx);\n"
+		                      "extern int ducktinycc_map_value_is_valid(const ducktinycc_map_t *m, uint64_t idx);\n"
+		                      "extern int64_t ducktinycc_map_find(const ducktinycc_map_t *m, const void *key, uint64_t key_size);\n"
+		                      "extern int ducktinycc_union_tag(const ducktinycc_union_t *u);\n"
+		                      "extern const void *ducktinycc_union_member_ptr(const ducktinycc_union_t *u, uint64_t member_idx);\n"
+		                      "extern int ducktinycc_union_member_is_valid(const ducktinycc_union_t *u, uint64_t member_idx);\n"
+		                      "extern void *ducktinycc_out_alloc(uint64_t size);\n"
+		                      "extern int duckdb_validity_row_is_valid(uint64_t *validity, uint64_t row);\n"
+		                      "#ifndef DUCKTINYCC_HOST_ACCESSORS\n"
+		                      "/* Composite accessors expanded in place: the same checks as the host-exported functions\n"
+		                      " * declared above, without a call per element. Arguments are evaluated once. Define\n"
+		                      " * DUCKTINYCC_HOST_ACCESSORS (add_define) to call the host functions instead. */\n"
+		                      "#define ducktinycc__bit(v, i) ((int)(((v)[(i) >> 6] >> ((i) & 63)) & 1))\n"
+		                      "#define ducktinycc_list_is_valid(list, idx) ({ const ducktinycc_list_t *ducktinycc__l = (list); uint64_t ducktinycc__i = (idx); (ducktinycc__l && ducktinycc__i < ducktinycc__l->len) ? (!ducktinycc__l->validity ? 1 : ducktinycc__bit(ducktinycc__l->validity, ducktinycc__l->offset + ducktinycc__i)) : 0; })\n"
+		                      "#define ducktinycc_list_elem_ptr(list, idx, elem_size) ({ const ducktinycc_list_t *ducktinycc__l = (list); uint64_t ducktinycc__i = (idx); uint64_t ducktinycc__w = (elem_size); (ducktinycc__l && ducktinycc__l->ptr && ducktinycc__i < ducktinycc__l->len && ducktinycc__w != 0) ? (const void *)((const uint8_t *)ducktinycc__l->ptr + ducktinycc__i * ducktinycc__w) : (const void *)0; })\n"
+		                      "#define ducktinycc_array_is_valid(arr, idx) ({ const ducktinycc_array_t *ducktinycc__a = (arr); uint64_t ducktinycc__i = (idx); (ducktinycc__a && ducktinycc__i < ducktinycc__a->len) ? (!ducktinycc__a->validity ? 1 : ducktinycc__bit(ducktinycc__a->validity, ducktinycc__a->offset + ducktinycc__i)) : 0; })\n"
+		                      "#define ducktinycc_array_elem_ptr(arr, idx, elem_size) ({ const ducktinycc_array_t *ducktinycc__a = (arr); uint64_t ducktinycc__i = (idx); uint64_t ducktinycc__w = (elem_size); (ducktinycc__a && ducktinycc__a->ptr && ducktinycc__i < ducktinycc__a->len && ducktinycc__w != 0) ? (const void *)((const uint8_t *)ducktinycc__a->ptr + ducktinycc__i * ducktinycc__w) : (const void *)0; })\n"
+		                      "#define ducktinycc_struct_field_ptr(st, idx) ({ const ducktinycc_struct_t *ducktinycc__s = (st); uint64_t ducktinycc__i = (idx); (ducktinycc__s && ducktinycc__s->field_ptrs && ducktinycc__i < ducktinycc__s->field_count) ? (const void *)ducktinycc__s->field_ptrs[ducktinycc__i] : (const void *)0; })\n"
+		                      "#define ducktinycc_struct_field_is_valid(st, field_idx) ({ const ducktinycc_struct_t *ducktinycc__s = (st); uint64_t ducktinycc__i = (field_idx); (ducktinycc__s && ducktinycc__s->field_ptrs && ducktinycc__i < ducktinycc__s->field_count && ducktinycc__s->field_ptrs[ducktinycc__i]) ? ((!ducktinycc__s->field_validity || !ducktinycc__s->field_validity[ducktinycc__i]) ? 1 : ducktinycc__bit(ducktinycc__s->field_validity[ducktinycc__i], ducktinycc__s->offset)) : 0; })\n"
+		                      "#define ducktinycc_map_key_ptr(m, idx, key_size) ({ const ducktinycc_map_t *ducktinycc__m = (m); uint64_t ducktinycc__i = (idx); uint64_t ducktinycc__w = (key_size); (ducktinycc__m && ducktinycc__m->key_ptr && ducktinycc__i < ducktinycc__m->len && ducktinycc__w != 0) ? (const void *)((const uint8_t *)ducktinycc__m->key_ptr + ducktinycc__i * ducktinycc__w) : (const void *)0; })\n"
+		                      "#define ducktinycc_map_value_ptr(m, idx, value_size) ({ const ducktinycc_map_t *ducktinycc__m = (m); uint64_t ducktinycc__i = (idx); uint64_t ducktinycc__w = (value_size); (ducktinycc__m && ducktinycc__m->value_ptr && ducktinycc__i < ducktinycc__m->len && ducktinycc__w != 0) ? (const void *)((const uint8_t *)ducktinycc__m->value_ptr + ducktinycc__i * ducktinycc__w) : (const void *)0; })\n"
+		                      "#define ducktinycc_map_key_is_valid(m, idx) ({ const ducktinycc_map_t *ducktinycc__m = (m); uint64_t ducktinycc__i = (idx); (ducktinycc__m && ducktinycc__i < ducktinycc__m->len) ? (!ducktinycc__m->key_validity ? 1 : ducktinycc__bit(ducktinycc__m->key_validity, ducktinycc__m->offset + ducktinycc__i)) : 0; })\n"
+		                      "#define ducktinycc_map_value_is_valid(m, idx) ({ const ducktinycc_map_t *ducktinycc__m = (m); uint64_t ducktinycc__i = (idx); (ducktinycc__m && ducktinycc__i < ducktinycc__m->len) ? (!ducktinycc__m->value_validity ? 1 : ducktinycc__bit(ducktinycc__m->value_validity, ducktinycc__m->offset + ducktinycc__i)) : 0; })\n"
+		                      "#define ducktinycc_union_tag(u) ({ const ducktinycc_union_t *ducktinycc__u = (u); (ducktinycc__u && ducktinycc__u->tag_ptr) ? (int)ducktinycc__u->tag_ptr[ducktinycc__u->offset] : -1; })\n"
+		                      "#define ducktinycc_union_member_ptr(u, member_idx) ({ const ducktinycc_union_t *ducktinycc__u = (u); uint64_t ducktinycc__i = (member_idx); (ducktinycc__u && ducktinycc__u->member_ptrs && ducktinycc__i < ducktinycc__u->member_count) ? (const void *)ducktinycc__u->member_ptrs[ducktinycc__i] : (const void *)0; })\n"
+		                      "#define ducktinycc_union_member_is_valid(u, member_idx) ({ const ducktinycc_union_t *ducktinycc__u = (u); uint64_t ducktinycc__i = (member_idx); (ducktinycc__u && ducktinycc__u->member_ptrs && ducktinycc__i < ducktinycc__u->member_count) ? ((!ducktinycc__u->member_validity || !ducktinycc__u->member_validity[ducktinycc__i]) ? 1 : ducktinycc__bit(ducktinycc__u->member_validity[ducktinycc__i], ducktinycc__u->offset)) : 0; })\n"
+		                      "#endif\n";
+	size_t n0;
+	size_t n1;
+	size_t n2;
+	if (!wrapper_loader_source) {
+		return NULL;
+	}
+	if (!user_source || user_source[0] == '\0') {
+		n0 = strlen(prelude);
+		n2 = strlen(wrapper_loader_source);
+		compilation_unit_source = (char *)duckdb_malloc(n0 + n2 + 2);
+		if (!compilation_unit_source) {
+			return NULL;
+		}
+		memcpy(compilation_unit_source, prelude, n0);
+		memcpy(compilation_unit_source + n0, wrapper_loader_source, n2);
+		compilation_unit_source[n0 + n2] = '\0';
+		return compilation_unit_source;
+	}
+	n0 = strlen(prelude);
+	n1 = strlen(user_source);
+	n2 = strlen(wrapper_loader_source);
+	compilation_unit_source = (char *)duckdb_malloc(n0 + n1 + n2 + 3);
+	if (!compilation_unit_source) {
+		return NULL;
+	}
+	memcpy(compilation_unit_source, prelude, n0);
+	memcpy(compilation_unit_source + n0, user_source, n1);
+	compilation_unit_source[n0 + n1] = '\n';
+	memcpy(compilation_unit_source + n0 + n1 + 1, wrapper_loader_source, n2);
+	compilation_unit_source[n0 + n1 + 1 + n2] = '\0';
+	return compilation_unit_source;
+}
+
+/* tcc_helper_binding_list_add_prefixed: Growable container utility used by parsing/codegen flows. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_helper_binding_list_add_prefixed(tcc_helper_binding_list_t *bindings, const char *prefix,
+                                                 const char *suffix, const char *return_type,
+                                                 const char *arg_types_csv, const char *stability) {
+	char symbol[512];
+	char sql_name[512];
+	int n_symbol;
+	int n_sql;
+	if (!bindings || !prefix || !suffix || !return_type || !arg_types_csv || !stability) {
+		return false;
+	}
+	n_symbol = snprintf(symbol, sizeof(symbol), "%s_%s", prefix, suffix);
+	n_sql = snprintf(sql_name, sizeof(sql_name), "%s_%s", prefix, suffix);
+	if (n_symbol < 0 || n_sql < 0 || (size_t)n_symbol >= sizeof(symbol) || (size_t)n_sql >= sizeof(sql_name)) {
+		return false;
+	}
+	return tcc_helper_binding_list_add(bindings, symbol, sql_name, return_type, arg_types_csv, stability);
+}
+
+/* tcc_format_cstr: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_format_cstr(char *buf, size_t buf_size, const char *fmt, ...) {
+	va_list args;
+	int n;
+	if (!buf || buf_size == 0 || !fmt) {
+		return false;
+	}
+	va_start(args, fmt);
+	n = vsnprintf(buf, buf_size, fmt, args);
+	va_end(args);
+	return n >= 0 && (size_t)n < buf_size;
+}
+
+static char *tcc_generate_c_composite_helpers_source(const char *kind_keyword, const char *type_name,
+                                                     const char *prefix, const tcc_c_field_list_t *fields,
+                                                     tcc_error_buffer_t *error_buf) {
+	tcc_text_buf_t src = {0};
+	idx_t i;
+	bool ok;
+	if (!kind_keyword || !type_name || !prefix || !fields) {
+		tcc_set_error(error_buf, "invalid composite helper arguments");
+		return NULL;
+	}
+	ok = tcc_text_buf_appendf(
+	    &src,
+	    "extern void *malloc(unsigned long long);\n"
+	    "extern void free(void *);\n"
+	    "/* Generated helpers allocate with libc malloc/free. Pair %s_new with %s_free. */\n"
+	    "#ifndef DUCKTINYCC_OFFSETOF\n"
+	    "#define DUCKTINYCC_OFFSETOF(type, member) ((unsigned long long)((const char *)&(((type *)0)->member) - (const char *)0))\n"
+	    "#endif\n"
+	    "unsigned long long %s_sizeof(void){ return (unsigned long long)sizeof(%s %s); }\n"
+	    "unsigned long long %s_alignof(void){ struct __ducktinycc_align_%s { char c; %s %s v; };"
+	    " return (unsigned long long)(sizeof(struct __ducktinycc_align_%s) - sizeof(%s %s)); }\n"
+	    "void *%s_new(void){ return malloc(sizeof(%s %s)); }\n"
+	    "void %s_free(void *p){ if (p) free(p); }\n",
+	    prefix, prefix, prefix, kind_keyword, type_name, prefix, prefix, kind_keyword, type_name, prefix,
+	    kind_keyword, type_name, prefix, kind_keyword, type_name, prefix);
+	if (!ok) {
+		tcc_set_error(error_buf, "out of memory");
+		tcc_text_buf_destroy(&src);
+		return NULL;
+	}
+	for (i = 0; i < fields->count; i++) {
+		const tcc_c_field_spec_t *field = &fields->items[i];
+		const char *c_type = tcc_ffi_type_to_c_type_name(field->type);
+		if (!c_type) {
+			tcc_set_error(error_buf, "field type is unsupported for helper codegen");
+			tcc_text_buf_destroy(&src);
+			return NULL;
+		}
+		if (field->array_size > 0) {
+			ok = tcc_text_buf_appendf(
+			    &src,
+			    "%s %s_get_%s_elt(void *p, unsigned long long idx){ %s out = (%s){0};"
+			    " if (!p || idx >= %lluULL) return out; out = ((%s %s *)p)->%s[idx]; return out; }\n"
+			    "void *%s_set_%s_elt(void *p, unsigned long long idx, %s value){"
+			    " if (!p || idx >= %lluULL) return (void *)0; ((%s %s *)p)->%s[idx] = value; return p; }\n"
+			    "unsigned long long %s_off_%s(void){ return DUCKTINYCC_OFFSETOF(%s %s, %s); }\n"
+			    "void *%s_%s_addr(void *p){ if (!p) return (void *)0; return (void *)&((%s %s *)p)->%s[0]; }\n",
+			    c_type, prefix, field->name, c_type, c_type, (unsigned long long)field->array_size, kind_keyword,
+			    type_name, field->name, prefix, field->name, c_type, (unsigned long long)field->array_size,
+			    kind_keyword, type_name, field->name, prefix, field->name, kind_keyword, type_name, field->name,
+			    prefix, field->name, kind_keyword, type_name, field->name);
+		} else {
+			ok = tcc_text_buf_appendf(
+			    &src,
+			    "%s %s_get_%s(void *p){ %s out = (%s){0};"
+			    " if (!p) return out; out = ((%s %s *)p)->%s; return out; }\n"
+			    "void *%s_set_%s(void *p, %s value){ if (!p) return (void *)0; ((%s %s *)p)->%s = value; return p; }\n",
+			    c_type, prefix, field->name, c_type, c_type, kind_keyword, type_name, field->name, prefix, field->name,
+			    c_type, kind_keyword, type_name, field->name);
+			if (ok && !field->is_bitfield) {
+				ok = tcc_text_buf_appendf(
+				    &src,
+				    "unsigned long long %s_off_%s(void){ return DUCKTINYCC_OFFSETOF(%s %s, %s); }\n"
+				    "void *%s_%s_addr(void *p){ if (!p) return (void *)0; return (void *)&((%s %s *)p)->%s; }\n",
+				    prefix, field->name, kind_keyword, type_name, field->name, prefix, field->name, kind_keyword,
+				    type_name, field->name);
+			}
+		}
+		if (!ok) {
+			tcc_set_error(error_buf, "out of memory");
+			tcc_text_buf_destroy(&src);
+			return NULL;
+		}
+	}
+	if (!src.data) {
+		tcc_set_error(error_buf, "out of memory");
+		return NULL;
+	}
+	{
+		char *out = tcc_strdup(src.data);
+		tcc_text_buf_destroy(&src);
+		if (!out) {
+			tcc_set_error(error_buf, "out of memory");
+		}
+		return out;
+	}
+}
+
+static char *tcc_generate_c_enum_helpers_source(const char *enum_name, const char *prefix,
+                                                const tcc_string_list_t *constants, tcc_error_buffer_t *error_buf) {
+	tcc_text_buf_t src = {0};
+	idx_t i;
+	if (!enum_name || !prefix || !constants) {
+		tcc_set_error(error_buf, "invalid enum helper arguments");
+		return NULL;
+	}
+	if (!tcc_text_buf_appendf(&src, "unsigned long long %s_sizeof(void){ return (unsigned long long)sizeof(enum %s); }\n",
+	                          prefix, enum_name)) {
+		tcc_set_error(error_buf, "out of memory");
+		tcc_text_buf_destroy(&src);
+		return NULL;
+	}
+	for (i = 0; i < constants->count; i++) {
+		if (!tcc_text_buf_appendf(&src, "long long %s_%s(void){ return (long long)(%s); }\n", prefix,
+		                          constants->items[i], constants->items[i])) {
+			tcc_set_error(error_buf, "out of memory");
+			tcc_text_buf_destroy(&src);
+			return NULL;
+		}
+	}
+	if (!src.data) {
+		tcc_set_error(error_buf, "out of memory");
+		return NULL;
+	}
+	{
+		char *out = tcc_strdup(src.data);
+		tcc_text_buf_destroy(&src);
+		if (!out) {
+			tcc_set_error(error_buf, "out of memory");
+		}
+		return out;
+	}
+}
+
+/* tcc_build_c_composite_bindings: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
+static bool tcc_build_c_composite_bindings(const char *prefix, const tcc_c_field_list_t *fields,
+                                           tcc_helper_binding_list_t *out_bindings, tcc_error_buffer_t *error_buf) {
+	idx_t i;
+	if (!prefix || !fields || !out_bindings) {
+		tcc_set_error(error_buf, "invalid helper binding arguments");
+		return false;
+	}
+#define TCC_ADD_BINDING_FORMAT(RET_TOKEN, ARG_CSV, STABILITY, SUFFIX_FMT, ...)                                           \
+	do {                                                                                                                  \
+		if (!tcc_format_cstr(suffix, sizeof(suffix), SUFFIX_FMT, __VA_ARGS__) ||                                         \
+		    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, suffix, RET_TOKEN, ARG_CSV, STABILITY)) {       \
+			tcc_set_error(error_buf, "out of memory");                                                                    \
+			return false;                                                                                                 \
+		}                                                                                                                 \
+	} while (0)
+	char suffix[512];
+	if (!tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "sizeof", "u64", "", "consistent") ||
+	    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "alignof", "u64", "", "consistent") ||
+	    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "new", "ptr", "", "volatile") ||
+	    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "free", "void", "ptr", "volatile")) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	for (i = 0; i < fields->count; i++) {
+		const tcc_c_field_spec_t *field = &fields->items[i];
+		const char *token = tcc_ffi_type_to_token(field->type);
+		char arg_csv[128];
+		if (!token) {
+			tcc_set_error(error_buf, "field type token is unsupported for helper bindings");
+			return false;
+		}
+		if (field->array_size > 0) {
+			if (!tcc_format_cstr(arg_csv, sizeof(arg_csv), "ptr,u64")) {
+				tcc_set_error(error_buf, "out of memory");
+				return false;
+			}
+			TCC_ADD_BINDING_FORMAT(token, arg_csv, "volatile", "get_%s_elt", field->name);
+			if (!tcc_format_cstr(arg_csv, sizeof(arg_csv), "ptr,u64,%s", token)) {
+				tcc_set_error(error_buf, "out of memory");
+				return false;
+			}
+			TCC_ADD_BINDING_FORMAT("ptr", arg_csv, "volatile", "set_%s_elt", field->name);
+			TCC_ADD_BINDING_FORMAT("u64", "", "consistent", "off_%s", field->name);
+			TCC_ADD_BINDING_FORMAT("ptr", "ptr", "consistent", "%s_addr", field->name);
+		} else {
+			TCC_ADD_BINDING_FORMAT(token, "ptr", "volatile", "get_%s", field->name);
+			if (!tcc_format_cstr(arg_csv, sizeof(arg_csv), "ptr,%s", token)) {
+				tcc_set_error(error_buf, "out of memory");
+				return false;
+			}
+			TCC_ADD_BINDING_FORMAT("ptr", arg_csv, "volatile", "set_%s", field->name);
+			if (!field->is_bitfield) {
+				TCC_ADD_BINDING_FORMAT("u64", "", "consistent", "off_%s", field->name);
+				TCC_ADD_BINDING_FORMAT("ptr", "ptr", "consistent", "%s_addr", field->name);
+			}
+		}
+	}
+#undef TCC_ADD_BINDING_FORMAT
+	return true;
+}
+
+/* tcc_build_c_enum_bindings: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
+static bool tcc_build_c_enum_bindings(const char *prefix, const tcc_string_list_t *constants,
+                                      tcc_helper_binding_list_t *out_bindings, tcc_error_buffer_t *error_buf) {
+	idx_t i;
+	char suffix[512];
+	if (!prefix || !constants || !out_bindings) {
+		tcc_set_error(error_buf, "invalid enum binding arguments");
+		return false;
+	}
+	if (!tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "sizeof", "u64", "", "consistent")) {
+		tcc_set_error(error_buf, "out of memory");
+		return false;
+	}
+	for (i = 0; i < constants->count; i++) {
+		if (!tcc_format_cstr(suffix, sizeof(suffix), "%s", constants->items[i]) ||
+		    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, suffix, "i64", "", "consistent")) {
+			tcc_set_error(error_buf, "out of memory");
+			return false;
+		}
+	}
+	return true;
+}
+
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/* tcc_codegen_compile_and_load_module: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static int tcc_codegen_compile_and_load_module(const char *runtime_path, tcc_module_state_t *state,
+                                               const tcc_module_bind_data_t *bind, const char *sql_name,
+                                               const char *target_symbol, tcc_registered_artifact_t **out_artifact,
+                                               tcc_error_buffer_t *error_buf, char *out_module_symbol, size_t symbol_len,
+                                               tcc_compile_timings_t *timings) {
+	tcc_codegen_source_ctx_t source_ctx;
+	uint64_t t_phase;
+	uint64_t t_now;
+	int rc;
+
+	if (!state || !bind || !sql_name || !target_symbol || !out_artifact || !error_buf || !out_module_symbol ||
+	    symbol_len == 0) {
+		tcc_set_error(error_buf, "invalid codegen compile arguments");
+		return -1;
+	}
+	if (!state->connection) {
+		tcc_set_error(error_buf, "no persistent extension connection available");
+		return -1;
+	}
+	tcc_codegen_source_ctx_init(&source_ctx);
+	t_phase = tcc_now_ns();
+	if (!tcc_codegen_prepare_sources(state, bind, sql_name, target_symbol, &source_ctx, error_buf)) {
+		tcc_codegen_source_ctx_destroy(&source_ctx);
+		return -1;
+	}
+	TCC_TIMINGS_LAP(timings, codegen_ns, t_phase, t_now);
+	if (timings) {
+		timings->parse_ns = source_ctx.parse_ns;
+		timings->codegen_ns -= source_ctx.parse_ns;
+	}
+	snprintf(out_module_symbol, symbol_len, "%s", source_ctx.module_symbol);
+	rc = tcc_codegen_load_unit(runtime_path, state, bind, source_ctx.compilation_unit_source, sql_name,
+	                           out_module_symbol, out_artifact, error_buf, timings);
+	tcc_codegen_source_ctx_destroy(&source_ctx);
+	return rc;
+}
+
+/* ===== Section: Constant Specialization ===== */
+/* Specialized arguments per UDF and cached constant tuples per UDF. */
+#define TCC_SPECIALIZE_MAX_ARGS 8
+#define TCC_SPECIALIZE_MAX_VARIANTS 16
+/* A tuple earns a variant only after this many chunks of at least TCC_SPECIALIZE_MIN_ROWS rows carried it: a
+ * synchronous TinyCC compile costs far more than a small or one-off chunk can win back. */
+#define TCC_SPECIALIZE_MIN_ROWS 1024
+#define TCC_SPECIALIZE_MIN_HITS 3
+/* Tuples counted toward TCC_SPECIALIZE_MIN_HITS; the least-seen one is evicted when full. */
+#define TCC_SPECIALIZE_MAX_CANDIDATES 32
+
+/* One compiled variant: the constant tuple (raw argument bits) it was built for and its wrapper. */
+typedef struct {
+	uint64_t key[TCC_SPECIALIZE_MAX_ARGS];
+	/* NULL when the variant failed to compile; chunks with this tuple stay on the generic wrapper. */
+	void *wrapper;
+	tcc_registered_artifact_t *artifact;
+} tcc_specialize_variant_t;
+
+/* A constant tuple seen on qualifying chunks that has no variant yet. */
+typedef struct {
+	uint64_t key[TCC_SPECIALIZE_MAX_ARGS];
+	int hits;
+} tcc_specialize_candidate_t;
+
+/* `specialize := [...]` plan of one UDF: which arguments become #defines, and a snapshot of everything needed to
+ * recompile the unit later (the session may be reset after registration). Owned by the signature ctx. */
+struct tcc_specialize_plan {
+	int count;
+	int arg_index[TCC_SPECIALIZE_MAX_ARGS];
+	char *define_names[TCC_SPECIALIZE_MAX_ARGS];
+	tcc_ffi_type_t arg_types[TCC_SPECIALIZE_MAX_ARGS];
+	char *runtime_path;
+	char *unit_source;
+	char *module_symbol;
+	char *sql_name;
+	tcc_session_t session;
+	/* Held by the one thread counting a candidate or compiling a variant; others run the generic wrapper meanwhile
+	 * (so under contention a sighting may go uncounted). */
+	atomic_flag compiling;
+	/* Published variant count: entries below it are immutable. */
+	atomic_int variant_count;
+	tcc_specialize_variant_t variants[TCC_SPECIALIZE_MAX_VARIANTS];
+	/* Guarded by `compiling`. */
+	int candidate_count;
+	tcc_specialize_candidate_t candidates[TCC_SPECIALIZE_MAX_CANDIDATES];
+};
+
+/* tcc_session_snapshot: deep-copies the build inputs of `src` plus the bind's one-shot overrides into `out`.
+ * Allocation/Lifetime: `out` owns the copies; release with tcc_session_clear_build_state. */
+static bool tcc_session_snapshot(const tcc_session_t *src, const tcc_module_bind_data_t *bind, tcc_session_t *out) {
+	const tcc_string_list_t *from[] = {&src->include_paths, &src->sysinclude_paths, &src->library_paths,
+	                                   &src->libraries,     &src->options,          &src->headers,
+	                                   &src->sources,       &src->define_names,     &src->define_values,
+	                                   &src->symbol_names};
+	tcc_string_list_t *to[] = {&out->include_paths, &out->sysinclude_paths, &out->library_paths, &out->libraries,
+	                           &out->options,       &out->headers,          &out->sources,       &out->define_names,
+	                           &out->define_values, &out->symbol_names};
+	size_t l;
+	idx_t i;
+	bool ok = true;
+	memset(out, 0, sizeof(tcc_session_t));
+	for (l = 0; l < sizeof(from) / sizeof(from[0]); l++) {
+		for (i = 0; i < from[l]->count && ok; i++) {
+			ok = tcc_string_list_append(to[l], from[l]->items[i]);
+		}
+	}
+	if (ok && src->symbol_count > 0) {
+		out->symbol_ptrs = (uint64_t *)duckdb_malloc(sizeof(uint64_t) * (size_t)src->symbol_count);
+		ok = out->symbol_ptrs != NULL;
+		if (ok) {
+			memcpy(out->symbol_ptrs, src->symbol_ptrs, sizeof(uint64_t) * (size_t)src->symbol_count);
+			out->symbol_count = src->symbol_count;
+			out->symbol_capacity = src->symbol_count;
+		}
+	}
+	/* Same effect as tcc_apply_bind_overrides_to_state on the original compile. */
+	if (ok && bind->include_path && bind->include_path[0] != '\0') {
+		ok = tcc_string_list_append(&out->include_paths, bind->include_path);
+	}
+	if (ok && bind->source_file && bind->source_file[0] != '\0') {
+		char dir[1024];
+		ok = tcc_source_file_dir(bind->source_file, dir, sizeof(dir)) &&
+		     tcc_string_list_append(&out->include_paths, dir);
+	}
+	if (ok && bind->sysinclude_path && bind->sysinclude_path[0] != '\0') {
+		ok = tcc_string_list_append(&out->sysinclude_paths, bind->sysinclude_path);
+	}
+	if (ok && bind->library_path && bind->library_path[0] != '\0') {
+		ok = tcc_string_list_append(&out->library_paths, bind->library_path);
+	}
+	if (ok && bind->option && bind->option[0] != '\0') {
+		ok = tcc_string_list_append(&out->options, bind->option);
+	}
+	if (ok && bind->define_name && bind->define_name[0] != '\0') {
+		ok = tcc_string_list_append(&out->define_names, bind->define_name) &&
+		     tcc_string_list_append(&out->define_values, bind->define_value ? bind->define_value : "1");
+	}
+	if (ok && bind->header && bind->header[0] != '\0') {
+		ok = tcc_string_list_append(&out->headers, bind->header);
+	}
+	if (ok && bind->library && bind->library[0] != '\0') {
+		ok = tcc_string_list_append(&out->libraries, bind->library);
+	}
+	if (!ok) {
+		tcc_session_clear_build_state(out);
+	}
+	return ok;
+}
+
+/* tcc_specialize_plan_destroy: frees the snapshot and every compiled variant. */
+static void tcc_specialize_plan_destroy(tcc_specialize_plan_t *plan) {
+	int i;
+	if (!plan) {
+		return;
+	}
+	for (i = 0; i < plan->count; i++) {
+		if (plan->define_names[i]) {
+			duckdb_free(plan->define_names[i]);
+		}
+	}
+	for (i = 0; i < atomic_load_explicit(&plan->variant_count, memory_order_acquire); i++) {
+		if (plan->variants[i].artifact) {
+			tcc_artifact_destroy(plan->variants[i].artifact);
+		}
+	}
+	if (plan->runtime_path) {
+		duckdb_free(plan->runtime_path);
+	}
+	if (plan->unit_source) {
+		duckdb_free(plan->unit_source);
+	}
+	if (plan->module_symbol) {
+		duckdb_free(plan->module_symbol);
+	}
+	if (plan->sql_name) {
+		duckdb_free(plan->sql_name);
+	}
+	tcc_session_clear_build_state(&plan->session);
+	duckdb_free(plan);
+}
+
+/* tcc_specialize_plan_create: parses `specialize` entries ('define_name:argument_position', 1-based) and
+ * snapshots the compile inputs. Argument types are checked later, at registration. */
+static tcc_specialize_plan_t *tcc_specialize_plan_create(const char *specialize_csv, const char *runtime_path,
+                                                         const tcc_session_t *session,
+                                                         const tcc_module_bind_data_t *bind, const char *unit_source,
+                                                         const char *sql_name, const char *module_symbol,
+                                                         tcc_error_buffer_t *error_buf) {
+	tcc_specialize_plan_t *plan;
+	tcc_string_list_t entries;
+	idx_t i;
+	memset(&entries, 0, sizeof(entries));
+	if (!tcc_split_csv_tokens(specialize_csv, &entries, error_buf)) {
+		return NULL;
+	}
+	if (entries.count == 0 || entries.count > TCC_SPECIALIZE_MAX_ARGS) {
+		tcc_string_list_destroy(&entries);
+		tcc_set_error(error_buf, "specialize takes 1 to 8 'define_name:argument_position' entries");
+		return NULL;
+	}
+	plan = (tcc_specialize_plan_t *)duckdb_malloc(sizeof(tcc_specialize_plan_t));
+	if (!plan) {
+		tcc_string_list_destroy(&entries);
+		tcc_set_error(error_buf, "out of memory");
+		return NULL;
+	}
+	memset(plan, 0, sizeof(tcc_specialize_plan_t));
+	atomic_flag_clear(&plan->compiling);
+	atomic_init(&plan->variant_count, 0);
+	for (i = 0; i < entries.count; i++) {
+		char *entry = entries.items[i];
+		char *colon = strchr(entry, ':');
+		char *end = NULL;
+		long position;
+		char *p;
+		bool ident = colon && colon != entry && (isalpha((unsigned char)entry[0]) || entry[0] == '_');
+		for (p = entry; ident && p < colon; p++) {
+			ident = isalnum((unsigned char)*p) || *p == '_';
+		}
+		position = colon ? strtol(colon + 1, &end, 10) : 0;
+		if (!ident || !end || end == colon + 1 || *end != '\0' || position < 1) {
+			tcc_string_list_destroy(&entries);
+			tcc_specialize_plan_destroy(plan);
+			tcc_set_error(error_buf, "specialize entries must be 'define_name:argument_position' (1-based)");
+			return NULL;
+		}
+		*colon = '\0';
+		plan->define_names[plan->count] = tcc_strdup(entry);
+		plan->arg_index[plan->count] = (int)position - 1;
+		plan->count++;
+		if (!plan->define_names[plan->count - 1]) {
+			tcc_string_list_destroy(&entries);
+			tcc_specialize_plan_destroy(plan);
+			tcc_set_error(error_buf, "out of memory");
+			return NULL;
+		}
+	}
+	tcc_string_list_destroy(&entries);
+	plan->runtime_path = runtime_path ? tcc_strdup(runtime_path) : NULL;
+	plan->unit_source = tcc_strdup(unit_source);
+	plan->module_symbol = tcc_strdup(module_symbol);
+	plan->sql_name = tcc_strdup(sql_name);
+	if ((runtime_path && !plan->runtime_path) || !plan->unit_source || !plan->module_symbol || !plan->sql_name ||
+	    !tcc_session_snapshot(session, bind, &plan->session)) {
+		tcc_specialize_plan_destroy(plan);
+		tcc_set_error(error_buf, "out of memory");
+		return NULL;
+	}
+	return plan;
+}
+
+/* tcc_specialize_type_supported: integer, boolean, floating and integer-backed temporal types can be folded into a
+ * C literal. */
+static bool tcc_specialize_type_supported(tcc_ffi_type_t type) {
+	switch (type) {
+	case TCC_FFI_BOOL:
+	case TCC_FFI_I8:
+	case TCC_FFI_U8:
+	case TCC_FFI_I16:
+	case TCC_FFI_U16:
+	case TCC_FFI_I32:
+	case TCC_FFI_U32:
+	case TCC_FFI_I64:
+	case TCC_FFI_U64:
+	case TCC_FFI_F32:
+	case TCC_FFI_F64:
+	case TCC_FFI_DATE:
+	case TCC_FFI_TIME:
+	case TCC_FFI_TIMESTAMP:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* tcc_specialize_attach: checks the plan against the registered signature and moves it into ctx->specialize.
+ * Allocation/Lifetime: on success the ctx owns the plan. */
+static bool tcc_specialize_attach(tcc_host_sig_ctx_t *ctx, tcc_specialize_plan_t *plan, const char **out_error) {
+	int i;
+	if (ctx->wrapper_mode != TCC_WRAPPER_MODE_ROW && ctx->wrapper_mode != TCC_WRAPPER_MODE_BATCH) {
+		*out_error = "specialize supports wrapper_mode 'row' and 'chunk_scalar_loop'";
+		return false;
+	}
+	if (ctx->isolation) {
+		*out_error = "specialize cannot be combined with isolation := 'process'";
+		return false;
+	}
+	for (i = 0; i < plan->count; i++) {
+		if (plan->arg_index[i] >= ctx->arg_count) {
+			*out_error = "specialize argument position is past the last argument";
+			return false;
+		}
+		if (!tcc_specialize_type_supported(ctx->arg_types[plan->arg_index[i]])) {
+			*out_error = "specialize supports boolean, integer, floating-point, DATE, TIME and TIMESTAMP arguments";
+			return false;
+		}
+		plan->arg_types[i] = ctx->arg_types[plan->arg_index[i]];
+	}
+	ctx->specialize = plan;
+	return true;
+}
+
+/* tcc_specialize_format_literal: renders raw argument bits as a C literal of the argument's type (hex floats are
+ * exact). Returns false for NaN/infinity, which have no literal; such tuples stay generic. */
+static bool tcc_specialize_format_literal(tcc_ffi_type_t type, uint64_t bits, char *buf, size_t buf_len) {
+	int8_t i8;
+	int16_t i16;
+	int32_t i32;
+	int64_t i64;
+	float f32;
+	double f64;
+	switch (type) {
+	case TCC_FFI_BOOL:
+		return tcc_format_cstr(buf, buf_len, "%d", (bits & 0xff) ? 1 : 0);
+	case TCC_FFI_I8:
+		memcpy(&i8, &bits, sizeof(i8));
+		return tcc_format_cstr(buf, buf_len, "(%d)", (int)i8);
+	case TCC_FFI_U8:
+		return tcc_format_cstr(buf, buf_len, "%uU", (unsigned)(bits & 0xff));
+	case TCC_FFI_I16:
+		memcpy(&i16, &bits, sizeof(i16));
+		return tcc_format_cstr(buf, buf_len, "(%d)", (int)i16);
+	case TCC_FFI_U16:
+		return tcc_format_cstr(buf, buf_len, "%uU", (unsigned)(bits & 0xffff));
+	case TCC_FFI_I32:
+	case TCC_FFI_DATE:
+		memcpy(&i32, &bits, sizeof(i32));
+		return i32 == INT32_MIN ? tcc_format_cstr(buf, buf_len, "(-2147483647-1)")
+		                        : tcc_format_cstr(buf, buf_len, "(%ld)", (long)i32);
+	case TCC_FFI_U32:
+		return tcc_format_cstr(buf, buf_len, "%luUL", (unsigned long)(bits & 0xffffffffu));
+	case TCC_FFI_I64:
+	case TCC_FFI_TIME:
+	case TCC_FFI_TIMESTAMP:
+		memcpy(&i64, &bits, sizeof(i64));
+		return i64 == INT64_MIN ? tcc_format_cstr(buf, buf_len, "(-9223372036854775807LL-1)")
+		                        : tcc_format_cstr(buf, buf_len, "(%lldLL)", (long long)i64);
+	case TCC_FFI_U64:
+		return tcc_format_cstr(buf, buf_len, "%lluULL", (unsigned long long)bits);
+	case TCC_FFI_F32:
+		memcpy(&f32, &bits, sizeof(f32));
+		return isfinite(f32) && tcc_format_cstr(buf, buf_len, "((float)%a)", (double)f32);
+	case TCC_FFI_F64:
+		memcpy(&f64, &bits, sizeof(f64));
+		return isfinite(f64) && tcc_format_cstr(buf, buf_len, "(%a)", f64);
+	default:
+		return false;
+	}
+}
+
+/* tcc_specialize_compile_variant: recompiles the snapshot unit with the tuple's #defines and returns its wrapper
+ * (NULL on failure). Allocation/Lifetime: on success *out_artifact owns the relocated variant. */
+static void *tcc_specialize_compile_variant(const tcc_specialize_plan_t *plan, const uint64_t *key,
+                                            tcc_registered_artifact_t **out_artifact) {
+	tcc_module_state_t variant_state;
+	tcc_module_bind_data_t variant_bind;
+	tcc_registered_artifact_t *artifact = NULL;
+	tcc_error_buffer_t err;
+	void *wrapper = NULL;
+	char literal[64];
+	bool ok;
+	int i;
+	*out_artifact = NULL;
+	memset(&variant_state, 0, sizeof(variant_state));
+	memset(&variant_bind, 0, sizeof(variant_bind));
+	memset(&err, 0, sizeof(err));
+	if (!tcc_session_snapshot(&plan->session, &variant_bind, &variant_state.session)) {
+		return NULL;
+	}
+	ok = true;
+	for (i = 0; i < plan->count && ok; i++) {
+		ok = tcc_specialize_format_literal(plan->arg_types[i], key[i], literal, sizeof(literal)) &&
+		     tcc_string_list_append(&variant_state.session.define_names, plan->define_names[i]) &&
+		     tcc_string_list_append(&variant_state.session.define_values, literal);
+	}
+	variant_bind.source = plan->unit_source;
+	if (ok && tcc_build_module_artifact(plan->runtime_path, &variant_state, &variant_bind, plan->module_symbol,
+	                                    plan->sql_name, &artifact, &err, NULL) == 0) {
+		tcc_registering_capture = &wrapper;
+		ok = artifact->module_init(NULL);
+		tcc_registering_capture = NULL;
+		if (ok && wrapper) {
+			*out_artifact = artifact;
+		} else {
+			tcc_artifact_destroy(artifact);
+			wrapper = NULL;
+		}
+	}
+	tcc_session_clear_build_state(&variant_state.session);
+	tcc_session_base_release(variant_state.session_base);
+	return wrapper;
+}
+
+/* tcc_specialize_count_hit: records one qualifying chunk of `key`; returns true (and forgets the candidate) once the
+ * tuple reached TCC_SPECIALIZE_MIN_HITS. Allocation/Lifetime: caller holds plan->compiling. */
+static bool tcc_specialize_count_hit(tcc_specialize_plan_t *plan, const uint64_t *key) {
+	size_t key_size = sizeof(plan->candidates[0].key);
+	int victim = 0;
+	int i;
+	for (i = 0; i < plan->candidate_count; i++) {
+		if (memcmp(plan->candidates[i].key, key, key_size) == 0) {
+			break;
+		}
+	}
+	if (i == plan->candidate_count) {
+		if (plan->candidate_count < TCC_SPECIALIZE_MAX_CANDIDATES) {
+			i = plan->candidate_count++;
+		} else {
+			for (i = 1; i < plan->candidate_count; i++) {
+				if (plan->candidates[i].hits < plan->candidates[victim].hits) {
+					victim = i;
+				}
+			}
+			i = victim;
+		}
+		memcpy(plan->candidates[i].key, key, key_size);
+		plan->candidates[i].hits = 0;
+	}
+	if (++plan->candidates[i].hits < TCC_SPECIALIZE_MIN_HITS) {
+		return false;
+	}
+	plan->candidates[i] = plan->candidates[--plan->candidate_count];
+	return true;
+}
+
+/**
+ * @function tcc_specialize_route
+ * @brief Picks the specialized wrapper for a chunk whose specialized arguments are one non-NULL constant.
+ * @param[in] ctx Signature context with a specialization plan.
+ * @param[in] input Borrowed input chunk.
+ * @param[out] out_ctx Copy of ctx pointing at the variant wrapper (filled when returning true).
+ * @return true when the chunk should run on a variant; false runs it on the generic wrapper.
+ * @ownership borrows(ctx,input), transfers(none)
+ * @heap compiles and caches a variant once a tuple has filled TCC_SPECIALIZE_MIN_HITS chunks of at least
+ *       TCC_SPECIALIZE_MIN_ROWS rows; smaller chunks never count
+ * @thread_safety lock-free lookup of published variants; one thread counts or compiles at a time and the others
+ *                keep running the generic wrapper instead of waiting
+ * @locks plan->compiling (try-lock only)
+ * @errors a failed variant compile is cached as a miss, so the tuple stays generic
+ */
+static bool tcc_specialize_route(const tcc_host_sig_ctx_t *ctx, duckdb_data_chunk input, tcc_host_sig_ctx_t *out_ctx) {
+	tcc_specialize_plan_t *plan = ctx->specialize;
+	uint64_t key[TCC_SPECIALIZE_MAX_ARGS];
+	idx_t n = duckdb_data_chunk_get_size(input);
+	void *wrapper = NULL;
+	int count;
+	int i;
+	if (n < TCC_SPECIALIZE_MIN_ROWS) {
+		return false;
+	}
+	memset(key, 0, sizeof(key));
+	for (i = 0; i < plan->count; i++) {
+		duckdb_vector v = duckdb_data_chunk_get_vector(input, (idx_t)plan->arg_index[i]);
+		const uint8_t *data = (const uint8_t *)duckdb_vector_get_data(v);
+		uint64_t *validity = duckdb_vector_get_validity(v);
+		size_t width = ctx->arg_sizes[plan->arg_index[i]];
+		idx_t row;
+		for (row = 0; validity && row < n; row++) {
+			if (!tcc_valid_input_row(validity, row)) {
+				return false;
+			}
+		}
+		for (row = 1; row < n; row++) {
+			if (memcmp(data + (size_t)row * width, data, width) != 0) {
+				return false;
+			}
+		}
+		memcpy(&key[i], data, width);
+	}
+	count = atomic_load_explicit(&plan->variant_count, memory_order_acquire);
+	for (i = 0; i < count; i++) {
+		if (memcmp(plan->variants[i].key, key, sizeof(key)) == 0) {
+			wrapper = plan->variants[i].wrapper;
+			break;
+		}
+	}
+	if (i == count) {
+		if (count == TCC_SPECIALIZE_MAX_VARIANTS ||
+		    atomic_flag_test_and_set_explicit(&plan->compiling, memory_order_acquire)) {
+			return false;
+		}
+		count = atomic_load_explicit(&plan->variant_count, memory_order_acquire);
+		for (i = 0; i < count; i++) {
+			if (memcmp(plan->variants[i].key, key, sizeof(key)) == 0) {
+				break;
+			}
+		}
+		if (i < count) {
+			wrapper = plan->variants[i].wrapper;
+		} else if (count < TCC_SPECIALIZE_MAX_VARIANTS && tcc_specialize_count_hit(plan, key)) {
+			tcc_specialize_variant_t *variant = &plan->variants[count];
+			memcpy(variant->key, key, sizeof(key));
+			variant->wrapper = tcc_specialize_compile_variant(plan, key, &variant->artifact);
+			wrapper = variant->wrapper;
+			atomic_store_explicit(&plan->variant_count, count + 1, memory_order_release);
+		}
+		atomic_flag_clear_explicit(&plan->compiling, memory_order_release);
+	}
+	if (!wrapper) {
+		return false;
+	}
+	*out_ctx = *ctx;
+	out_ctx->specialize = NULL;
+	if (ctx->wrapper_mode == TCC_WRAPPER_MODE_BATCH) {
+		out_ctx->batch_wrapper = (tcc_host_batch_wrapper_fn_t)wrapper;
+	} else {
+		out_ctx->row_wrapper = (tcc_host_row_wrapper_fn_t)wrapper;
+	}
+	return true;
+}
+
+/* tcc_artifact_release_failed_init: drops the artifact of a module_init that returned false. If the init had
+ * already registered some functions (a multi-signature init such as `type_params` failing on a later overload),
+ * those stay in DuckDB's catalog, so the artifact is parked on the state instead of freed. Allocation/Lifetime:
+ * consumes the caller's reference; a stranded artifact is released with the state (or leaked if the list cannot
+ * grow, which is still safe). */
+static void tcc_artifact_release_failed_init(tcc_module_state_t *state, tcc_registered_artifact_t *artifact) {
+	bool registered = false;
+	idx_t i;
+	for (i = 0; i < artifact->udf_stats_count; i++) {
+		/* ducktinycc_register_signature clears ctx when DuckDB rejected the function. */
+		registered = registered || (artifact->udf_stats[i] && artifact->udf_stats[i]->ctx);
+	}
+	if (!registered) {
+		tcc_artifact_destroy(artifact);
+		return;
+	}
+	if (state->stranded_count == state->stranded_capacity) {
+		idx_t new_capacity = state->stranded_capacity == 0 ? 2 : state->stranded_capacity * 2;
+		tcc_registered_artifact_t **grown = (tcc_registered_artifact_t **)duckdb_malloc(
+		    sizeof(tcc_registered_artifact_t *) * (size_t)new_capacity);
+		if (!grown) {
+			return;
+		}
+		if (state->stranded) {
+			memcpy(grown, state->stranded, sizeof(tcc_registered_artifact_t *) * (size_t)state->stranded_count);
+			duckdb_free((void *)state->stranded);
+		}
+		state->stranded = grown;
+		state->stranded_capacity = new_capacity;
+	}
+	state->stranded[state->stranded_count++] = artifact;
+}
+
+/* tcc_codegen_load_unit: Codegen helper that compiles a complete wrapper+loader unit and runs its module init. Allocation/Lifetime: on success transfers a new artifact to *out_artifact; caller stores or destroys it. */
+static int tcc_codegen_load_unit(const char *runtime_path, tcc_module_state_t *state,
+                                 const tcc_module_bind_data_t *bind, const char *unit_source, const char *sql_name,
+                                 const char *module_symbol, tcc_registered_artifact_t **out_artifact,
+                                 tcc_error_buffer_t *error_buf, tcc_compile_timings_t *timings) {
+	tcc_module_bind_data_t bind_copy;
+	tcc_registered_artifact_t *artifact = NULL;
+	uint64_t t_phase;
+	tcc_specialize_plan_t *specialize = NULL;
+	int isolation_workers = 0;
+	int isolation_timeout_ms = 0;
+	bool init_ok;
+
+#ifdef TCC_ISOLATION_SUPPORTED
+	if (!tcc_parse_isolation(bind->isolation, &isolation_workers, &isolation_timeout_ms, error_buf)) {
+		return -1;
+	}
+#else
+	if (bind->isolation && bind->isolation[0] != '\0' && strcmp(bind->isolation, "inprocess") != 0) {
+		tcc_set_error(error_buf, "isolation := 'process' is not supported on this platform");
+		return -1;
+	}
+#endif
+	memset(&bind_copy, 0, sizeof(bind_copy));
+	bind_copy = *bind;
+	bind_copy.source = (char *)unit_source;
+	if (bind->specialize && bind->specialize[0] != '\0') {
+		if (bind->import_from && bind->import_from[0] != '\0') {
+			tcc_set_error(error_buf, "specialize cannot be combined with import_from");
+			return -1;
+		}
+		specialize = tcc_specialize_plan_create(bind->specialize, runtime_path, &state->session, bind, unit_source,
+		                                        sql_name, module_symbol, error_buf);
+		if (!specialize) {
+			return -1;
+		}
+	}
+	if (tcc_build_module_artifact(runtime_path, state, &bind_copy, module_symbol, sql_name, &artifact, error_buf,
+	                              timings) != 0) {
+		tcc_specialize_plan_destroy(specialize);
+		return -1;
+	}
+
+	tcc_registering_artifact = artifact;
+	tcc_registering_timings = timings;
+	tcc_registering_isolation_workers = isolation_workers;
+	tcc_registering_isolation_timeout_ms = isolation_timeout_ms;
+	tcc_registering_used = bind->used;
+	tcc_registering_specialize = specialize;
+	tcc_registering_error = NULL;
+	t_phase = tcc_now_ns();
+	init_ok = artifact->module_init(state->connection);
+	tcc_registering_artifact = NULL;
+	tcc_registering_timings = NULL;
+	tcc_registering_isolation_workers = 0;
+	tcc_registering_isolation_timeout_ms = 0;
+	tcc_registering_used = NULL;
+	/* Still set when no signature took the plan (module_init failed before registering). */
+	if (tcc_registering_specialize) {
+		tcc_specialize_plan_destroy(tcc_registering_specialize);
+		tcc_registering_specialize = NULL;
+	}
+	if (!init_ok) {
+		tcc_artifact_release_failed_init(state, artifact);
+		tcc_set_error(error_buf, tcc_registering_error ? tcc_registering_error : "generated module init returned false");
+		tcc_registering_error = NULL;
+		return -1;
+	}
+	if (timings) {
+		/* register_ns was accumulated by ducktinycc_register_signature while module_init ran. */
+		uint64_t init_total = tcc_now_ns() - t_phase;
+		timings->init_ns = init_total > timings->register_ns ? init_total - timings->register_ns : 0;
+	}
+	*out_artifact = artifact;
+	return 0;
+}
+#endif
+
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/* tcc_compile_generated_binding: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
+static bool tcc_compile_generated_binding(const char *runtime_path, tcc_module_state_t *state, const char *source,
+                                          const tcc_helper_binding_t *binding, tcc_error_buffer_t *error_buf) {
+	tcc_module_bind_data_t generated_bind;
+	tcc_registered_artifact_t *artifact = NULL;
+	char module_symbol[128];
+	if (!state || !binding || !source || !error_buf) {
+		tcc_set_error(error_buf, "invalid generated binding arguments");
+		return false;
+	}
+	memset(&generated_bind, 0, sizeof(generated_bind));
+	memset(module_symbol, 0, sizeof(module_symbol));
+	generated_bind.source = (char *)source;
+	generated_bind.symbol = binding->symbol;
+	generated_bind.sql_name = binding->sql_name;
+	generated_bind.arg_types = binding->arg_types_csv;
+	generated_bind.return_type = binding->return_type;
+	generated_bind.wrapper_mode = "row";
+	generated_bind.stability = binding->stability;
+	if (tcc_codegen_compile_and_load_module(runtime_path, state, &generated_bind, binding->sql_name, binding->symbol,
+	                                        &artifact, error_buf, module_symbol, sizeof(module_symbol), NULL) != 0) {
+		return false;
+	}
+	if (!tcc_registry_store_metadata(state, binding->sql_name, module_symbol, artifact->state_id, artifact)) {
+		tcc_artifact_destroy(artifact);
+		tcc_set_error(error_buf, "failed to store generated helper metadata");
+		return false;
+	}
+	return true;
+}
+#endif
+
+/* ===== Section: Compile Timings ===== */
+/* Field names of the `timings` STRUCT column and `tcc_compile_stats()` phase columns, in tcc_compile_timings_t order. */
+static const char *const tcc_compile_timing_names[9] = {"parse_ns",    "codegen_ns", "setup_ns",
+                                                        "session_ns",  "compile_ns", "relocate_ns",
+                                                        "init_ns",     "register_ns", "total_ns"};
+
+/* tcc_compile_timings_values: flattens timings into tcc_compile_timing_names order. */
+static void tcc_compile_timings_values(const tcc_compile_timings_t *t, uint64_t out[9]) {
+	out[0] = t->parse_ns;
+	out[1] = t->codegen_ns;
+	out[2] = t->setup_ns;
+	out[3] = t->session_ns;
+	out[4] = t->compile_ns;
+	out[5] = t->relocate_ns;
+	out[6] = t->init_ns;
+	out[7] = t->register_ns;
+	out[8] = t->total_ns;
+}
+
+/* tcc_compile_timings_create_type: STRUCT(<phase>_ns UBIGINT, ...) logical type. Allocation/Lifetime: caller destroys the returned type. */
+static duckdb_logical_type tcc_compile_timings_create_type(void) {
+	duckdb_logical_type ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+	duckdb_logical_type member_types[9];
+	duckdb_logical_type struct_type;
+	int i;
+	for (i = 0; i < 9; i++) {
+		member_types[i] = ubigint_type;
+	}
+	struct_type = duckdb_create_struct_type(member_types, (const char **)tcc_compile_timing_names, 9);
+	duckdb_destroy_logical_type(&ubigint_type);
+	return struct_type;
+}
+
+/* tcc_write_timings_col: fills the `timings` column of a `tcc_module(...)` row written by tcc_write_row. */
+static void tcc_write_timings_col(duckdb_data_chunk output, const tcc_compile_timings_t *timings) {
+	duckdb_vector v = duckdb_data_chunk_get_vector(output, 10);
+	uint64_t values[9];
+	uint64_t *validity;
+	int i;
+	tcc_compile_timings_values(timings, values);
+	for (i = 0; i < 9; i++) {
+		uint64_t *child = (uint64_t *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, (idx_t)i));
+		child[0] = values[i];
+	}
+	validity = duckdb_vector_get_validity(v);
+	if (validity) {
+		duckdb_validity_set_row_valid(validity, 0);
+	}
+}
+
+/* tcc_compile_stats_record: appends one compile to the state's history ring. Allocation/Lifetime: caller holds the
+ * state write lock; the ring is allocated on first use and owns copied strings (freed by tcc_compile_stats_clear). */
+static void tcc_compile_stats_record(tcc_module_state_t *state, const char *mode, const char *sql_name,
+                                     const char *code, bool ok, const tcc_compile_timings_t *timings) {
+	tcc_compile_stat_t *rec;
+	if (!state || !timings) {
+		return;
+	}
+	if (!state->compile_stats) {
+		state->compile_stats =
+		    (tcc_compile_stat_t *)duckdb_malloc(sizeof(tcc_compile_stat_t) * TCC_COMPILE_STATS_CAPACITY);
+		if (!state->compile_stats) {
+			return;
+		}
+		memset(state->compile_stats, 0, sizeof(tcc_compile_stat_t) * TCC_COMPILE_STATS_CAPACITY);
+	}
+	rec = &state->compile_stats[state->compile_stats_seq % TCC_COMPILE_STATS_CAPACITY];
+	if (rec->mode) {
+		duckdb_free(rec->mode);
+	}
+	if (rec->sql_name) {
+		duckdb_free(rec->sql_name);
+	}
+	if (rec->code) {
+		duckdb_free(rec->code);
+	}
+	memset(rec, 0, sizeof(tcc_compile_stat_t));
+	rec->seq = ++state->compile_stats_seq;
+	rec->mode = mode ? tcc_strdup(mode) : NULL;
+	rec->sql_name = sql_name ? tcc_strdup(sql_name) : NULL;
+	rec->code = code ? tcc_strdup(code) : NULL;
+	rec->ok = ok;
+	rec->state_id = state->session.state_id;
+	rec->timings = *timings;
+}
+
+/* tcc_compile_stats_clear: releases the compile history ring. Allocation/Lifetime: frees every record string and the ring. */
+static void tcc_compile_stats_clear(tcc_module_state_t *state) {
+	idx_t i;
+	if (!state || !state->compile_stats) {
+		return;
+	}
+	for (i = 0; i < TCC_COMPILE_STATS_CAPACITY; i++) {
+		tcc_compile_stat_t *rec = &state->compile_stats[i];
+		if (rec->mode) {
+			duckdb_free(rec->mode);
+		}
+		if (rec->sql_name) {
+			duckdb_free(rec->sql_name);
+		}
+		if (rec->code) {
+			duckdb_free(rec->code);
+		}
+	}
+	duckdb_free(state->compile_stats);
+	state->compile_stats = NULL;
+}
+
+/* ===== Section: x86-64 Disassembler (code_info) ===== */
+/* Register, ALU, shift and condition-code names for the x86-64 decoder. */
+static const char *const tcc_x64_reg64[16] = {"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+                                              "r8",  "r9",  "r10", "r11", "r12", "r13", "r14", "r15"};
+static const char *const tcc_x64_reg32[16] = {"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi",  "edi",
+                                              "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"};
+static const char *const tcc_x64_reg16[16] = {"ax",  "cx",  "dx",   "bx",   "sp",   "bp",   "si",   "di",
+                                              "r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w"};
+static const char *const tcc_x64_reg8[16] = {"al",  "cl",  "dl",   "bl",   "spl",  "bpl",  "sil",  "dil",
+                                             "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b"};
+static const char *const tcc_x64_reg8_legacy[8] = {"al", "cl", "dl", "bl", "ah", "ch", "dh", "bh"};
+static const char *const tcc_x64_alu[8] = {"add", "or", "adc", "sbb", "and", "sub", "xor", "cmp"};
+static const char *const tcc_x64_shift[8] = {"rol", "ror", "rcl", "rcr", "shl", "shr", "sal", "sar"};
+static const char *const tcc_x64_cc[16] = {"o", "no", "b",  "ae", "e", "ne", "be", "a",
+                                           "s", "ns", "p", "np", "l", "ge", "le", "g"};
+
+/* Decoder cursor and per-instruction prefix/ModRM state. `mem` holds the formatted memory operand (no size). */
+typedef struct {
+	const uint8_t *code;
+	size_t len;
+	size_t pos;
+	bool overrun;
+	uint8_t rex;
+	bool opsize16;
+	bool lock;
+	uint8_t rep;
+	uint8_t mod;
+	uint8_t reg;
+	uint8_t rm;
+	char mem[64];
+} tcc_x64_insn_t;
+
+/* tcc_x64_u8: reads one code byte, flagging overrun past the symbol end. */
+static uint8_t tcc_x64_u8(tcc_x64_insn_t *d) {
+	if (d->pos >= d->len) {
+		d->overrun = true;
+		return 0;
+	}
+	return d->code[d->pos++];
+}
+
+/* tcc_x64_imm: reads a sign-extended little-endian immediate/displacement of 1, 2, 4 or 8 bytes. */
+static int64_t tcc_x64_imm(tcc_x64_insn_t *d, int bytes) {
+	uint64_t v = 0;
+	int i;
+	for (i = 0; i < bytes; i++) {
+		v |= (uint64_t)tcc_x64_u8(d) << (8 * i);
+	}
+	if (bytes < 8 && (v & ((uint64_t)1 << (8 * bytes - 1)))) {
+		v |= ~(uint64_t)0 << (8 * bytes);
+	}
+	return (int64_t)v;
+}
+
+/* tcc_x64_gpr: general-purpose register name for `num` at operand width `bits`. */
+static const char *tcc_x64_gpr(const tcc_x64_insn_t *d, unsigned num, int bits) {
+	num &= 15;
+	switch (bits) {
+	case 64:
+		return tcc_x64_reg64[num];
+	case 16:
+		return tcc_x64_reg16[num];
+	case 8:
+		return d->rex ? tcc_x64_reg8[num] : tcc_x64_reg8_legacy[num & 7];
+	default:
+		return tcc_x64_reg32[num];
+	}
+}
+
+/* tcc_x64_size_name: Intel `ptr` size keyword for an operand width. */
+static const char *tcc_x64_size_name(int bits) {
+	switch (bits) {
+	case 8:
+		return "byte";
+	case 16:
+		return "word";
+	case 64:
+		return "qword";
+	case 80:
+		return "tbyte";
+	case 128:
+		return "xmmword";
+	default:
+		return "dword";
+	}
+}
+
+/* tcc_x64_hex: formats a signed value as 0x.. / -0x.. */
+static void tcc_x64_hex(int64_t v, char *out, size_t cap) {
+	if (v < 0) {
+		snprintf(out, cap, "-0x%llx", (unsigned long long)((uint64_t)0 - (uint64_t)v));
+	} else {
+		snprintf(out, cap, "0x%llx", (unsigned long long)v);
+	}
+}
+
+/* tcc_x64_read_modrm: decodes ModRM (+SIB, displacement) into reg/rm fields and the memory operand text. */
+static void tcc_x64_read_modrm(tcc_x64_insn_t *d) {
+	uint8_t modrm = tcc_x64_u8(d);
+	const char *base = NULL;
+	const char *index = NULL;
+	unsigned scale = 1;
+	int64_t disp = 0;
+	bool rip = false;
+	size_t n;
+	d->mod = (uint8_t)(modrm >> 6);
+	d->reg = (uint8_t)(((modrm >> 3) & 7) | ((d->rex & 4) ? 8 : 0));
+	d->rm = (uint8_t)((modrm & 7) | ((d->rex & 1) ? 8 : 0));
+	d->mem[0] = '\0';
+	if (d->mod == 3) {
+		return;
+	}
+	if ((modrm & 7) == 4) {
+		uint8_t sib = tcc_x64_u8(d);
+		unsigned sindex = ((sib >> 3) & 7) | ((d->rex & 2) ? 8 : 0);
+		scale = 1u << (sib >> 6);
+		if (sindex != 4) {
+			index = tcc_x64_reg64[sindex];
+		}
+		if ((sib & 7) == 5 && d->mod == 0) {
+			disp = tcc_x64_imm(d, 4);
+		} else {
+			base = tcc_x64_reg64[(sib & 7) | ((d->rex & 1) ? 8 : 0)];
+		}
+	} else if ((modrm & 7) == 5 && d->mod == 0) {
+		rip = true;
+		disp = tcc_x64_imm(d, 4);
+	} else {
+		base = tcc_x64_reg64[d->rm];
+	}
+	if (d->mod == 1) {
+		disp = tcc_x64_imm(d, 1);
+	} else if (d->mod == 2) {
+		disp = tcc_x64_imm(d, 4);
+	}
+	n = (size_t)snprintf(d->mem, sizeof(d->mem), "[%s", rip ? "rip" : (base ? base : ""));
+	if (index && n < sizeof(d->mem)) {
+		n += (size_t)snprintf(d->mem + n, sizeof(d->mem) - n, scale > 1 ? "%s%s*%u" : "%s%s", (rip || base) ? "+" : "",
+		                      index, scale);
+	}
+	if (n < sizeof(d->mem) && (disp != 0 || (!rip && !base && !index))) {
+		char hex[24];
+		tcc_x64_hex(disp, hex, sizeof(hex));
+		n += (size_t)snprintf(d->mem + n, sizeof(d->mem) - n, "%s%s", (rip || base || index) && disp >= 0 ? "+" : "",
+		                      hex);
+	}
+	if (n < sizeof(d->mem)) {
+		snprintf(d->mem + n, sizeof(d->mem) - n, "]");
+	}
+}
+
+/* tcc_x64_rm: r/m operand as a general-purpose register or sized memory reference. */
+static void tcc_x64_rm(const tcc_x64_insn_t *d, int bits, char *out, size_t cap) {
+	if (d->mod == 3) {
+		snprintf(out, cap, "%s", tcc_x64_gpr(d, d->rm, bits));
+	} else {
+		snprintf(out, cap, "%s ptr %s", tcc_x64_size_name(bits), d->mem);
+	}
+}
+
+/* tcc_x64_rm_xmm: r/m operand as an xmm register or sized memory reference. */
+static void tcc_x64_rm_xmm(const tcc_x64_insn_t *d, int bits, char *out, size_t cap) {
+	if (d->mod == 3) {
+		snprintf(out, cap, "xmm%u", (unsigned)d->rm);
+	} else {
+		snprintf(out, cap, "%s ptr %s", tcc_x64_size_name(bits), d->mem);
+	}
+}
+
+/* tcc_x64_sse_suffix: ps/pd/ss/sd by mandatory prefix (none/66/F3/F2). */
+static const char *tcc_x64_sse_suffix(const tcc_x64_insn_t *d) {
+	if (d->rep == 0xF3) {
+		return "ss";
+	}
+	if (d->rep == 0xF2) {
+		return "sd";
+	}
+	return d->opsize16 ? "pd" : "ps";
+}
+
+/* tcc_x64_sse_bits: memory width of a scalar/packed SSE operand by mandatory prefix. */
+static int tcc_x64_sse_bits(const tcc_x64_insn_t *d) {
+	if (d->rep == 0xF3) {
+		return 32;
+	}
+	if (d->rep == 0xF2) {
+		return 64;
+	}
+	return 128;
+}
+
+/* tcc_x64_decode_0f: two-byte (0F xx) opcodes emitted by TinyCC: SSE scalar math/moves/conversions, jcc/setcc/cmovcc,
+ * movzx/movsx, imul, bswap and a few system instructions. Returns false for opcodes outside that subset. */
+static bool tcc_x64_decode_0f(tcc_x64_insn_t *d, int osize, uint64_t addr, char *text, size_t cap) {
+	uint8_t op = tcc_x64_u8(d);
+	char a[96];
+	char b[16]; /* only ever an "xmmN" register name */
+	if (op >= 0x80 && op <= 0x8F) {
+		int64_t rel = tcc_x64_imm(d, 4);
+		snprintf(text, cap, "j%s 0x%llx", tcc_x64_cc[op & 15], (unsigned long long)(addr + d->pos + (uint64_t)rel));
+		return true;
+	}
+	if (op >= 0x90 && op <= 0x9F) {
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, 8, a, sizeof(a));
+		snprintf(text, cap, "set%s %s", tcc_x64_cc[op & 15], a);
+		return true;
+	}
+	if (op >= 0x40 && op <= 0x4F) {
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, osize, a, sizeof(a));
+		snprintf(text, cap, "cmov%s %s, %s", tcc_x64_cc[op & 15], tcc_x64_gpr(d, d->reg, osize), a);
+		return true;
+	}
+	if (op >= 0xC8 && op <= 0xCF) {
+		snprintf(text, cap, "bswap %s", tcc_x64_gpr(d, (unsigned)(op & 7) | ((d->rex & 1) ? 8u : 0u), osize));
+		return true;
+	}
+	switch (op) {
+	case 0x05:
+		snprintf(text, cap, "syscall");
+		return true;
+	case 0x0B:
+		snprintf(text, cap, "ud2");
+		return true;
+	case 0xA2:
+		snprintf(text, cap, "cpuid");
+		return true;
+	case 0x1F:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, osize, a, sizeof(a));
+		snprintf(text, cap, "nop %s", a);
+		return true;
+	case 0xAF:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, osize, a, sizeof(a));
+		snprintf(text, cap, "imul %s, %s", tcc_x64_gpr(d, d->reg, osize), a);
+		return true;
+	case 0xB0:
+	case 0xB1:
+	case 0xC0:
+	case 0xC1:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, (op & 1) ? osize : 8, a, sizeof(a));
+		snprintf(text, cap, "%s %s, %s", op < 0xC0 ? "cmpxchg" : "xadd", a, tcc_x64_gpr(d, d->reg, (op & 1) ? osize : 8));
+		return true;
+	case 0xB6:
+	case 0xB7:
+	case 0xBE:
+	case 0xBF:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, (op & 1) ? 16 : 8, a, sizeof(a));
+		snprintf(text, cap, "%s %s, %s", op < 0xBE ? "movzx" : "movsx", tcc_x64_gpr(d, d->reg, osize), a);
+		return true;
+	case 0x10:
+	case 0x11:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, tcc_x64_sse_bits(d), a, sizeof(a));
+		snprintf(b, sizeof(b), "xmm%u", (unsigned)d->reg);
+		if (op == 0x10) {
+			snprintf(text, cap, "%s%s %s, %s", d->rep ? "mov" : "movu", tcc_x64_sse_suffix(d), b, a);
+		} else {
+			snprintf(text, cap, "%s%s %s, %s", d->rep ? "mov" : "movu", tcc_x64_sse_suffix(d), a, b);
+		}
+		return true;
+	case 0x28:
+	case 0x29:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, 128, a, sizeof(a));
+		snprintf(b, sizeof(b), "xmm%u", (unsigned)d->reg);
+		if (op == 0x28) {
+			snprintf(text, cap, "mova%s %s, %s", d->opsize16 ? "pd" : "ps", b, a);
+		} else {
+			snprintf(text, cap, "mova%s %s, %s", d->opsize16 ? "pd" : "ps", a, b);
+		}
+		return true;
+	case 0x2A:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, (d->rex & 8) ? 64 : 32, a, sizeof(a));
+		snprintf(text, cap, "cvtsi2%s xmm%u, %s", d->rep == 0xF2 ? "sd" : "ss", (unsigned)d->reg, a);
+		return true;
+	case 0x2C:
+	case 0x2D:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, d->rep == 0xF2 ? 64 : 32, a, sizeof(a));
+		snprintf(text, cap, "cvt%s%s2si %s, %s", op == 0x2C ? "t" : "", d->rep == 0xF2 ? "sd" : "ss",
+		         tcc_x64_gpr(d, d->reg, (d->rex & 8) ? 64 : 32), a);
+		return true;
+	case 0x2E:
+	case 0x2F:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, d->opsize16 ? 64 : 32, a, sizeof(a));
+		snprintf(text, cap, "%scomis%s xmm%u, %s", op == 0x2E ? "u" : "", d->opsize16 ? "d" : "s", (unsigned)d->reg, a);
+		return true;
+	case 0x51:
+	case 0x58:
+	case 0x59:
+	case 0x5C:
+	case 0x5D:
+	case 0x5E:
+	case 0x5F: {
+		static const char *const names[] = {"sqrt", "", "", "", "", "", "", "add", "mul", "", "", "sub", "min", "div", "max"};
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, tcc_x64_sse_bits(d), a, sizeof(a));
+		snprintf(text, cap, "%s%s xmm%u, %s", names[op - 0x51], tcc_x64_sse_suffix(d), (unsigned)d->reg, a);
+		return true;
+	}
+	case 0x54:
+	case 0x55:
+	case 0x56:
+	case 0x57: {
+		static const char *const names[] = {"and", "andn", "or", "xor"};
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, 128, a, sizeof(a));
+		snprintf(text, cap, "%s%s xmm%u, %s", names[op - 0x54], d->opsize16 ? "pd" : "ps", (unsigned)d->reg, a);
+		return true;
+	}
+	case 0x5A:
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, d->rep == 0xF3 ? 32 : (d->rep == 0xF2 ? 64 : (d->opsize16 ? 128 : 64)), a, sizeof(a));
+		snprintf(text, cap, "%s xmm%u, %s",
+		         d->rep == 0xF3 ? "cvtss2sd" : (d->rep == 0xF2 ? "cvtsd2ss" : (d->opsize16 ? "cvtpd2ps" : "cvtps2pd")),
+		         (unsigned)d->reg, a);
+		return true;
+	case 0x6E:
+		if (!d->opsize16) {
+			return false;
+		}
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm(d, (d->rex & 8) ? 64 : 32, a, sizeof(a));
+		snprintf(text, cap, "mov%s xmm%u, %s", (d->rex & 8) ? "q" : "d", (unsigned)d->reg, a);
+		return true;
+	case 0x7E:
+		tcc_x64_read_modrm(d);
+		if (d->rep == 0xF3) {
+			tcc_x64_rm_xmm(d, 64, a, sizeof(a));
+			snprintf(text, cap, "movq xmm%u, %s", (unsigned)d->reg, a);
+			return true;
+		}
+		if (!d->opsize16) {
+			return false;
+		}
+		tcc_x64_rm(d, (d->rex & 8) ? 64 : 32, a, sizeof(a));
+		snprintf(text, cap, "mov%s %s, xmm%u", (d->rex & 8) ? "q" : "d", a, (unsigned)d->reg);
+		return true;
+	case 0xD6:
+		if (!d->opsize16) {
+			return false;
+		}
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, 64, a, sizeof(a));
+		snprintf(text, cap, "movq %s, xmm%u", a, (unsigned)d->reg);
+		return true;
+	case 0xEF:
+		if (!d->opsize16) {
+			return false;
+		}
+		tcc_x64_read_modrm(d);
+		tcc_x64_rm_xmm(d, 128, a, sizeof(a));
+		snprintf(text, cap, "pxor xmm%u, %s", (unsigned)d->reg, a);
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * @function tcc_x64_disasm_one
+ * @brief Decodes one x86-64 instruction at `code` into Intel-syntax text.
+ * @param[in] code Instruction bytes; at most `len` are read.
+ * @param[in] addr Runtime address of `code`, used to resolve relative branch targets.
+ * @param[out] text Mnemonic and operands (NUL-terminated, truncated to `cap`).
+ * @return Instruction length in bytes (always >= 1).
+ * @heap none
+ * @errors Opcodes outside the subset TinyCC emits (integer ALU/moves/branches, SSE scalar, x87 escapes), or
+ *         instructions running past `len`, are rendered as a single `.byte 0x..` so decoding resynchronizes.
+ *
+ * This is a length-correct decoder for ordinary ModRM/SIB/REX encodings, not a general disassembler: VEX/EVEX,
+ * segment overrides and most 0F opcodes are not named.
+ */
+static size_t tcc_x64_disasm_one(const uint8_t *code, size_t len, uint64_t addr, char *text, size_t cap) {
+	tcc_x64_insn_t d;
+	uint8_t op;
+	int osize;
+	bool ok = true;
+	char a[96];
+	char imm[32];
+	memset(&d, 0, sizeof(d));
+	d.code = code;
+	d.len = len;
+	for (;;) {
+		op = tcc_x64_u8(&d);
+		if (op == 0x66) {
+			d.opsize16 = true;
+		} else if (op == 0xF2 || op == 0xF3) {
+			d.rep = op;
+		} else if (op == 0xF0) {
+			d.lock = true;
+		} else {
+			break;
+		}
+		if (d.pos > 4) {
+			break;
+		}
+	}
+	if (!d.overrun && op >= 0x40 && op <= 0x4F) {
+		d.rex = op;
+		op = tcc_x64_u8(&d);
+	}
+	osize = (d.rex & 8) ? 64 : (d.opsize16 ? 16 : 32);
+	if (d.overrun) {
+		ok = false;
+	} else if (op < 0x40 && (op & 7) < 6 && op != 0x0F) {
+		const char *name = tcc_x64_alu[op >> 3];
+		int bits = (op & 1) ? osize : 8;
+		if ((op & 7) < 4) {
+			tcc_x64_read_modrm(&d);
+			tcc_x64_rm(&d, bits, a, sizeof(a));
+			if (op & 2) {
+				snprintf(text, cap, "%s %s, %s", name, tcc_x64_gpr(&d, d.reg, bits), a);
+			} else {
+				snprintf(text, cap, "%s %s, %s", name, a, tcc_x64_gpr(&d, d.reg, bits));
+			}
+		} else {
+			tcc_x64_hex(tcc_x64_imm(&d, bits == 8 ? 1 : (bits == 16 ? 2 : 4)), imm, sizeof(imm));
+			snprintf(text, cap, "%s %s, %s", name, tcc_x64_gpr(&d, 0, bits), imm);
+		}
+	} else if (op == 0x0F) {
+		ok = tcc_x64_decode_0f(&d, osize, addr, text, cap);
+	} else if (op >= 0x50 && op <= 0x5F) {
+		snprintf(text, cap, "%s %s", op < 0x58 ? "push" : "pop",
+		         tcc_x64_reg64[(op & 7) | ((d.rex & 1) ? 8 : 0)]);
+	} else if (op == 0x63) {
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, 32, a, sizeof(a));
+		snprintf(text, cap, "movsxd %s, %s", tcc_x64_gpr(&d, d.reg, osize), a);
+	} else if (op == 0x68 || op == 0x6A) {
+		tcc_x64_hex(tcc_x64_imm(&d, op == 0x68 ? 4 : 1), imm, sizeof(imm));
+		snprintf(text, cap, "push %s", imm);
+	} else if (op == 0x69 || op == 0x6B) {
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, osize, a, sizeof(a));
+		tcc_x64_hex(tcc_x64_imm(&d, op == 0x6B ? 1 : (osize == 16 ? 2 : 4)), imm, sizeof(imm));
+		snprintf(text, cap, "imul %s, %s, %s", tcc_x64_gpr(&d, d.reg, osize), a, imm);
+	} else if (op >= 0x70 && op <= 0x7F) {
+		int64_t rel = tcc_x64_imm(&d, 1);
+		snprintf(text, cap, "j%s 0x%llx", tcc_x64_cc[op & 15], (unsigned long long)(addr + d.pos + (uint64_t)rel));
+	} else if (op >= 0x80 && op <= 0x83 && op != 0x82) {
+		int bits = op == 0x80 ? 8 : osize;
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, bits, a, sizeof(a));
+		tcc_x64_hex(tcc_x64_imm(&d, op == 0x81 ? (osize == 16 ? 2 : 4) : 1), imm, sizeof(imm));
+		snprintf(text, cap, "%s %s, %s", tcc_x64_alu[d.reg & 7], a, imm);
+	} else if (op >= 0x84 && op <= 0x8B) {
+		static const char *const names[] = {"test", "test", "xchg", "xchg", "mov", "mov", "mov", "mov"};
+		int bits = (op & 1) ? osize : 8;
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, bits, a, sizeof(a));
+		if (op == 0x8A || op == 0x8B) {
+			snprintf(text, cap, "%s %s, %s", names[op - 0x84], tcc_x64_gpr(&d, d.reg, bits), a);
+		} else {
+			snprintf(text, cap, "%s %s, %s", names[op - 0x84], a, tcc_x64_gpr(&d, d.reg, bits));
+		}
+	} else if (op == 0x8D) {
+		tcc_x64_read_modrm(&d);
+		snprintf(text, cap, "lea %s, %s", tcc_x64_gpr(&d, d.reg, osize), d.mem);
+		ok = d.mod != 3;
+	} else if (op == 0x8F) {
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, 64, a, sizeof(a));
+		snprintf(text, cap, "pop %s", a);
+	} else if (op == 0x90) {
+		snprintf(text, cap, d.rep == 0xF3 ? "pause" : "nop");
+	} else if (op > 0x90 && op <= 0x97) {
+		snprintf(text, cap, "xchg %s, %s", tcc_x64_gpr(&d, (unsigned)(op & 7) | ((d.rex & 1) ? 8u : 0u), osize),
+		         tcc_x64_gpr(&d, 0, osize));
+	} else if (op == 0x98) {
+		snprintf(text, cap, osize == 64 ? "cdqe" : (osize == 16 ? "cbw" : "cwde"));
+	} else if (op == 0x99) {
+		snprintf(text, cap, osize == 64 ? "cqo" : (osize == 16 ? "cwd" : "cdq"));
+	} else if (op == 0xA4 || op == 0xA5 || op == 0xAA || op == 0xAB) {
+		snprintf(text, cap, "%s%s", op < 0xA8 ? "movs" : "stos",
+		         !(op & 1) ? "b" : (osize == 64 ? "q" : (osize == 16 ? "w" : "d")));
+	} else if (op == 0xA8 || op == 0xA9) {
+		int bits = op == 0xA8 ? 8 : osize;
+		tcc_x64_hex(tcc_x64_imm(&d, bits == 8 ? 1 : (bits == 16 ? 2 : 4)), imm, sizeof(imm));
+		snprintf(text, cap, "test %s, %s", tcc_x64_gpr(&d, 0, bits), imm);
+	} else if (op >= 0xB0 && op <= 0xBF) {
+		int bits = op < 0xB8 ? 8 : osize;
+		tcc_x64_hex(tcc_x64_imm(&d, bits / 8), imm, sizeof(imm));
+		snprintf(text, cap, "mov %s, %s", tcc_x64_gpr(&d, (unsigned)(op & 7) | ((d.rex & 1) ? 8u : 0u), bits), imm);
+	} else if (op == 0xC0 || op == 0xC1 || (op >= 0xD0 && op <= 0xD3)) {
+		int bits = (op & 1) ? osize : 8;
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, bits, a, sizeof(a));
+		if (op <= 0xC1) {
+			tcc_x64_hex(tcc_x64_imm(&d, 1), imm, sizeof(imm));
+		} else {
+			snprintf(imm, sizeof(imm), "%s", op <= 0xD1 ? "1" : "cl");
+		}
+		snprintf(text, cap, "%s %s, %s", tcc_x64_shift[d.reg & 7], a, imm);
+	} else if (op == 0xC2) {
+		tcc_x64_hex(tcc_x64_imm(&d, 2) & 0xFFFF, imm, sizeof(imm));
+		snprintf(text, cap, "ret %s", imm);
+	} else if (op == 0xC3) {
+		snprintf(text, cap, "ret");
+	} else if (op == 0xC6 || op == 0xC7) {
+		int bits = op == 0xC6 ? 8 : osize;
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, bits, a, sizeof(a));
+		tcc_x64_hex(tcc_x64_imm(&d, bits == 8 ? 1 : (bits == 16 ? 2 : 4)), imm, sizeof(imm));
+		snprintf(text, cap, "mov %s, %s", a, imm);
+		ok = (d.reg & 7) == 0;
+	} else if (op == 0xC9) {
+		snprintf(text, cap, "leave");
+	} else if (op == 0xCC) {
+		snprintf(text, cap, "int3");
+	} else if (op >= 0xD8 && op <= 0xDF) {
+		/* x87 escape (TinyCC uses it for long double); only the operand is decoded. */
+		tcc_x64_read_modrm(&d);
+		if (d.mod == 3) {
+			snprintf(text, cap, "x87 %02x /%u st(%u)", (unsigned)op, (unsigned)(d.reg & 7), (unsigned)(d.rm & 7));
+		} else {
+			snprintf(text, cap, "x87 %02x /%u %s", (unsigned)op, (unsigned)(d.reg & 7), d.mem);
+		}
+	} else if (op == 0xE8 || op == 0xE9) {
+		int64_t rel = tcc_x64_imm(&d, 4);
+		snprintf(text, cap, "%s 0x%llx", op == 0xE8 ? "call" : "jmp",
+		         (unsigned long long)(addr + d.pos + (uint64_t)rel));
+	} else if (op == 0xEB) {
+		int64_t rel = tcc_x64_imm(&d, 1);
+		snprintf(text, cap, "jmp 0x%llx", (unsigned long long)(addr + d.pos + (uint64_t)rel));
+	} else if (op == 0xF6 || op == 0xF7) {
+		static const char *const names[] = {"test", "test", "not", "neg", "mul", "imul", "div", "idiv"};
+		int bits = op == 0xF6 ? 8 : osize;
+		tcc_x64_read_modrm(&d);
+		tcc_x64_rm(&d, bits, a, sizeof(a));
+		if ((d.reg & 7) < 2) {
+			tcc_x64_hex(tcc_x64_imm(&d, bits == 8 ? 1 : (bits == 16 ? 2 : 4)), imm, sizeof(imm));
+			snprintf(text, cap, "test %s, %s", a, imm);
+		} else {
+			snprintf(text, cap, "%s %s", names[d.reg & 7], a);
+		}
+	} else if (op == 0xFE || op == 0xFF) {
+		static const char *const names[] = {"inc", "dec", "call", "callf", "jmp", "jmpf", "push", ""};
+		unsigned sub;
+		tcc_x64_read_modrm(&d);
+		sub = d.reg & 7u;
+		tcc_x64_rm(&d, op == 0xFE ? 8 : (sub >= 2 && sub != 3 && sub != 5 ? 64 : osize), a, sizeof(a));
+		snprintf(text, cap, "%s %s", names[sub], a);
+		ok = sub != 7 && (op == 0xFF || sub < 2);
+	} else {
+		ok = false;
+	}
+	if (!ok || d.overrun || d.pos == 0) {
+		snprintf(text, cap, ".byte 0x%02x", (unsigned)code[0]);
+		return 1;
+	}
+	if (d.lock || (d.rep && op != 0x0F && op != 0x90)) {
+		/* Keep lock/rep prefixes visible (`lock cmpxchg`, `rep stosb`, `repz ret`). */
+		bool string_op = op == 0xA4 || op == 0xA5 || op == 0xAA || op == 0xAB;
+		char tmp[176];
+		size_t n;
+		snprintf(tmp, sizeof(tmp), "%s%s%s", d.lock ? "lock " : "",
+		         !d.rep || op == 0x0F || op == 0x90 ? "" : (d.rep == 0xF3 ? (string_op ? "rep " : "repz ") : "repnz "),
+		         text);
+		n = strlen(tmp);
+		if (n >= cap) {
+			/* Mark the cut so a truncated operand is never read as a complete one. */
+			n = cap - 1;
+			if (n >= 3) {
+				memcpy(tmp + n - 3, "...", 3);
+			}
+		}
+		memcpy(text, tmp, n);
+		text[n] = '\0';
+	}
+	return d.pos;
+}
+
+/*
+ * @function tcc_x64_disasm
+ * @brief Disassembles `len` bytes at runtime address `addr` into one line per instruction.
+ * @return duckdb_malloc'd NUL-terminated text (caller frees), or NULL on OOM.
+ * @note Lines are `+0x<offset>  <hex bytes>  <instruction>`; branch/call targets are absolute addresses.
+ */
+static char *tcc_x64_disasm(const uint8_t *code, size_t len, uint64_t addr) {
+	size_t cap = len * 48 + 64;
+	size_t n = 0;
+	size_t pos = 0;
+	char *out = (char *)duckdb_malloc(cap);
+	if (!out) {
+		return NULL;
+	}
+	out[0] = '\0';
+	while (pos < len) {
+		char text[160];
+		char hex[64];
+		size_t ilen = tcc_x64_disasm_one(code + pos, len - pos, addr + pos, text, sizeof(text));
+		size_t h = 0;
+		size_t i;
+		size_t need;
+		for (i = 0; i < ilen && h + 4 < sizeof(hex); i++) {
+			h += (size_t)snprintf(hex + h, sizeof(hex) - h, "%s%02x", i ? " " : "", (unsigned)code[pos + i]);
+		}
+		hex[h] = '\0';
+		need = strlen(text) + strlen(hex) + 40;
+		if (n + need > cap) {
+			size_t new_cap = cap * 2 + need;
+			char *grown = (char *)duckdb_malloc(new_cap);
+			if (!grown) {
+				duckdb_free(out);
+				return NULL;
+			}
+			memcpy(grown, out, n + 1);
+			duckdb_free(out);
+			out = grown;
+			cap = new_cap;
+		}
+		n += (size_t)snprintf(out + n, cap - n, "%s+0x%04llx  %-24s %s", n ? "\n" : "", (unsigned long long)pos, hex,
+		                      text);
+		pos += ilen;
+	}
+	return out;
+}
+
+/* ===== Section: Module Code Inspection (code_info / tcc_code_info) ===== */
+#if defined(__x86_64__) || defined(_M_X64)
+#define TCC_CODE_INFO_HAS_X64_DISASM 1
+#else
+#define TCC_CODE_INFO_HAS_X64_DISASM 0
+#endif
+
+/* One relocated function of a module. `code`/`disassembly` are only filled for tcc_code_info(). */
+typedef struct {
+	char *symbol;
+	uint64_t address;
+	uint64_t size;
+	uint8_t *code;
+	char *disassembly;
+} tcc_code_symbol_t;
+
+/* Per-symbol code layout of one module artifact; owns every string and byte copy. */
+typedef struct {
+	char *sql_name;
+	char *module_symbol;
+	tcc_code_symbol_t *items;
+	idx_t count;
+	uint64_t code_size;
+} tcc_code_info_t;
+
+/* tcc_code_info_clear: releases a collected code layout. Allocation/Lifetime: frees every owned string/byte copy. */
+static void tcc_code_info_clear(tcc_code_info_t *info) {
+	idx_t i;
+	if (!info) {
+		return;
+	}
+	for (i = 0; i < info->count; i++) {
+		if (info->items[i].symbol) {
+			duckdb_free(info->items[i].symbol);
+		}
+		if (info->items[i].code) {
+			duckdb_free(info->items[i].code);
+		}
+		if (info->items[i].disassembly) {
+			duckdb_free(info->items[i].disassembly);
+		}
+	}
+	if (info->items) {
+		duckdb_free(info->items);
+	}
+	if (info->sql_name) {
+		duckdb_free(info->sql_name);
+	}
+	if (info->module_symbol) {
+		duckdb_free(info->module_symbol);
+	}
+	memset(info, 0, sizeof(*info));
+}
+
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/* tcc_code_info_find_artifact: resolves a compiled module by its compile sql_name or by any UDF it registered. */
+static tcc_registered_artifact_t *tcc_code_info_find_artifact(tcc_module_state_t *state, const char *sql_name) {
+	idx_t i;
+	idx_t j;
+	idx_t entry = tcc_registry_find_sql_name(state, sql_name);
+	if (entry != (idx_t)-1 && state->entries[entry].artifact) {
+		/* A module rebuilt from `source_file` runs its latest rebuild. */
+		return state->entries[entry].artifact->rebuilt ? state->entries[entry].artifact->rebuilt
+		                                                : state->entries[entry].artifact;
+	}
+	for (i = 0; i < state->entry_count; i++) {
+		tcc_registered_artifact_t *artifact = state->entries[i].artifact;
+		if (!artifact) {
+			continue;
+		}
+		for (j = 0; j < artifact->udf_stats_count; j++) {
+			if (artifact->udf_stats[j] && artifact->udf_stats[j]->sql_name &&
+			    strcmp(artifact->udf_stats[j]->sql_name, sql_name) == 0) {
+				return artifact->rebuilt ? artifact->rebuilt : artifact;
+			}
+		}
+	}
+	return NULL;
+}
+#endif
+
+/*
+ * @function tcc_code_info_collect
+ * @brief Copies the address, size and (optionally) bytes/disassembly of every function in a registered module.
+ * @param[in] state Extension state; caller holds the read lock so the artifact cannot be released meanwhile.
+ * @param[in] sql_name Compile sql_name of the module or the SQL name of any UDF it registered.
+ * @param[in] copy_code Copy each symbol's machine code bytes.
+ * @param[in] disassemble Also render x86-64 disassembly (ignored on other hosts).
+ * @param[out] info Filled on success; the caller releases it with tcc_code_info_clear on every path.
+ * @return 1 on success, 0 when no module matches `sql_name`, -1 on OOM or missing text markers.
+ * @note Sizes are distances to the next global symbol, as for the perf map: static functions are not listed by
+ *       TinyCC and count towards the global symbol before them (or `static` at the start of the module).
+ */
+static int tcc_code_info_collect(tcc_module_state_t *state, const char *sql_name, bool copy_code, bool disassemble,
+                                 tcc_code_info_t *info) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	(void)state;
+	(void)sql_name;
+	(void)copy_code;
+	(void)disassemble;
+	memset(info, 0, sizeof(*info));
+	return 0;
+#else
+	tcc_registered_artifact_t *artifact;
+	tcc_perf_map_collect_t c;
+	idx_t i;
+	int rc = 1;
+	memset(info, 0, sizeof(*info));
+	artifact = tcc_code_info_find_artifact(state, sql_name);
+	if (!artifact || !artifact->tcc) {
+		return 0;
+	}
+	info->sql_name = tcc_strdup(artifact->sql_name ? artifact->sql_name : sql_name);
+	info->module_symbol = artifact->symbol ? tcc_strdup(artifact->symbol) : NULL;
+	info->code_size = artifact->code_size;
+	if (!info->sql_name || (artifact->symbol && !info->module_symbol) ||
+	    !tcc_module_collect_text_symbols(artifact->tcc, &c)) {
+		return -1;
+	}
+	if (c.count > 0) {
+		info->items = (tcc_code_symbol_t *)duckdb_malloc(sizeof(tcc_code_symbol_t) * (size_t)c.count);
+		if (!info->items) {
+			rc = -1;
+			goto cleanup;
+		}
+		memset(info->items, 0, sizeof(tcc_code_symbol_t) * (size_t)c.count);
+	}
+	for (i = 0; i < c.count; i++) {
+		uintptr_t next = i + 1 < c.count ? c.items[i + 1].addr : c.end;
+		const char *name = c.items[i].name;
+		tcc_code_symbol_t *item;
+		if (strcmp(name, TCC_MODULE_TEXT_END_SYMBOL) == 0 || next <= c.items[i].addr) {
+			continue;
+		}
+		if (strcmp(name, TCC_MODULE_TEXT_BEGIN_SYMBOL) == 0) {
+			name = "static";
+		}
+		item = &info->items[info->count++];
+		item->symbol = tcc_strdup(name);
+		item->address = (uint64_t)c.items[i].addr;
+		item->size = (uint64_t)(next - c.items[i].addr);
+		if (!item->symbol) {
+			rc = -1;
+			goto cleanup;
+		}
+		if (copy_code) {
+			item->code = (uint8_t *)duckdb_malloc((size_t)item->size);
+			if (!item->code) {
+				rc = -1;
+				goto cleanup;
+			}
+			memcpy(item->code, (const void *)c.items[i].addr, (size_t)item->size);
+		}
+		if (disassemble && TCC_CODE_INFO_HAS_X64_DISASM) {
+			item->disassembly =
+			    tcc_x64_disasm((const uint8_t *)c.items[i].addr, (size_t)item->size, item->address);
+			if (!item->disassembly) {
+				rc = -1;
+				goto cleanup;
+			}
+		}
+	}
+cleanup:
+	if (c.items) {
+		duckdb_free(c.items);
+	}
+	return rc;
+#endif
+}
+
+/* Handles `mode := 'code_info'`: one summary row (function count, module text size, largest function). */
+static void tcc_mode_code_info(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                               duckdb_data_chunk output) {
+	tcc_code_info_t info;
+	const tcc_code_symbol_t *largest = NULL;
+	char detail[512];
+	idx_t i;
+	int rc;
+	if (!bind->sql_name || bind->sql_name[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "sql_name is required", NULL, NULL, NULL,
+		              NULL, "connection");
+		return;
+	}
+	rc = tcc_code_info_collect(state, bind->sql_name, false, false, &info);
+	if (rc == 0) {
+		tcc_write_row(output, false, bind->mode, "code_info", "E_NOT_FOUND", "no compiled module with this sql_name",
+		              NULL, bind->sql_name, NULL, NULL, "connection");
+		return;
+	}
+	if (rc < 0) {
+		tcc_code_info_clear(&info);
+		tcc_write_row(output, false, bind->mode, "code_info", "E_STORE_FAILED", "out of memory", NULL, bind->sql_name,
+		              NULL, NULL, "connection");
+		return;
+	}
+	for (i = 0; i < info.count; i++) {
+		if (!largest || info.items[i].size > largest->size) {
+			largest = &info.items[i];
+		}
+	}
+	snprintf(detail, sizeof(detail), "module=%s functions=%llu code_size=%llu largest=%s:%llu", info.sql_name,
+	         (unsigned long long)info.count, (unsigned long long)info.code_size, largest ? largest->symbol : "",
+	         (unsigned long long)(largest ? largest->size : 0));
+	tcc_write_row(output, true, bind->mode, "code_info", "OK", "module code layout (see tcc_code_info())", detail,
+	              bind->sql_name, info.module_symbol, NULL, "connection");
+	tcc_code_info_clear(&info);
+}
+
+/* ===== Section: In-SQL UDF Benchmark ===== */
+/* Default `rows := N` for `mode := 'bench'`. */
+#define TCC_BENCH_DEFAULT_ROWS 100000
+/* Elements per synthesized LIST/MAP row. */
+#define TCC_BENCH_LIST_LEN 4
+
+/* Timer reads used to estimate the per-lap cost subtracted from the phase split. */
+#define TCC_BENCH_CLOCK_SAMPLES 1024
+
+/* Field names of the `bench` STRUCT column (rows/chunks/total_ns are UBIGINT, the rest DOUBLE). */
+static const char *const tcc_bench_field_names[8] = {
+    "rows", "chunks", "null_ratio", "total_ns", "ns_per_row", "marshal_ns_per_row", "call_ns_per_row",
+    "writeback_ns_per_row"};
+
+/* tcc_bench_create_type: STRUCT(rows UBIGINT, chunks UBIGINT, null_ratio DOUBLE, total_ns UBIGINT, *_per_row DOUBLE)
+ * logical type. Allocation/Lifetime: caller destroys the returned type. */
+static duckdb_logical_type tcc_bench_create_type(void) {
+	duckdb_logical_type ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+	duckdb_logical_type double_type = duckdb_create_logical_type(DUCKDB_TYPE_DOUBLE);
+	duckdb_logical_type member_types[8];
+	duckdb_logical_type struct_type;
+	member_types[0] = ubigint_type;
+	member_types[1] = ubigint_type;
+	member_types[2] = double_type;
+	member_types[3] = ubigint_type;
+	member_types[4] = double_type;
+	member_types[5] = double_type;
+	member_types[6] = double_type;
+	member_types[7] = double_type;
+	struct_type = duckdb_create_struct_type(member_types, (const char **)tcc_bench_field_names, 8);
+	duckdb_destroy_logical_type(&ubigint_type);
+	duckdb_destroy_logical_type(&double_type);
+	return struct_type;
+}
+
+/* tcc_write_bench_col: fills the `bench` column of a `tcc_module(...)` row written by tcc_write_row. */
+static void tcc_write_bench_col(duckdb_data_chunk output, uint64_t rows, uint64_t chunks, double null_ratio,
+                                uint64_t total_ns, const double phase_ns[3]) {
+	duckdb_vector v = duckdb_data_chunk_get_vector(output, 11);
+	double per_row = rows > 0 ? 1.0 / (double)rows : 0.0;
+	uint64_t *validity;
+	((uint64_t *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 0)))[0] = rows;
+	((uint64_t *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 1)))[0] = chunks;
+	((double *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 2)))[0] = null_ratio;
+	((uint64_t *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 3)))[0] = total_ns;
+	((double *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 4)))[0] = (double)total_ns * per_row;
+	((double *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 5)))[0] = phase_ns[0] * per_row;
+	((double *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 6)))[0] = phase_ns[1] * per_row;
+	((double *)duckdb_vector_get_data(duckdb_struct_vector_get_child(v, 7)))[0] = phase_ns[2] * per_row;
+	validity = duckdb_vector_get_validity(v);
+	if (validity) {
+		duckdb_validity_set_row_valid(validity, 0);
+	}
+}
+
+/* tcc_bench_clock_cost_ns: average cost of one tcc_now_ns() read on this thread. */
+static double tcc_bench_clock_cost_ns(void) {
+	uint64_t t0 = tcc_now_ns();
+	int i;
+	for (i = 0; i < TCC_BENCH_CLOCK_SAMPLES; i++) {
+		(void)tcc_now_ns();
+	}
+	return (double)(tcc_now_ns() - t0) / (double)(TCC_BENCH_CLOCK_SAMPLES + 1);
+}
+
+/* tcc_bench_row_is_null: deterministic per-(column,row) NULL choice hitting `null_ratio` on average. */
+static bool tcc_bench_row_is_null(double null_ratio, int col, idx_t row) {
+	uint64_t h = ((uint64_t)row + 1) * 0x9E3779B97F4A7C15ULL ^ ((uint64_t)col + 1) * 0xC2B2AE3D27D4EB4FULL;
+	h ^= h >> 31;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 29;
+	return (double)(h >> 11) * (1.0 / 9007199254740992.0) < null_ratio;
+}
+
+/* tcc_bench_fill_primitive: writes `count` small deterministic values into a fixed-width or string vector.
+ * Allocation/Lifetime: strings are copied into the vector's own heap. */
+static bool tcc_bench_fill_primitive(duckdb_vector vector, idx_t count) {
+	duckdb_logical_type type = duckdb_vector_get_column_type(vector);
+	duckdb_type type_id = duckdb_get_type_id(type);
+	void *data = duckdb_vector_get_data(vector);
+	idx_t i;
+	bool ok = true;
+	if (type_id == DUCKDB_TYPE_DECIMAL) {
+		type_id = duckdb_decimal_internal_type(type);
+	}
+	duckdb_destroy_logical_type(&type);
+	for (i = 0; i < count; i++) {
+		int64_t v = (int64_t)(i % 97);
+		switch (type_id) {
+		case DUCKDB_TYPE_BOOLEAN:
+			((bool *)data)[i] = (i & 1) != 0;
+			break;
+		case DUCKDB_TYPE_TINYINT:
+		case DUCKDB_TYPE_UTINYINT:
+			((int8_t *)data)[i] = (int8_t)v;
+			break;
+		case DUCKDB_TYPE_SMALLINT:
+		case DUCKDB_TYPE_USMALLINT:
+			((int16_t *)data)[i] = (int16_t)v;
+			break;
+		case DUCKDB_TYPE_INTEGER:
+		case DUCKDB_TYPE_UINTEGER:
+		case DUCKDB_TYPE_DATE:
+			((int32_t *)data)[i] = (int32_t)v;
+			break;
+		case DUCKDB_TYPE_BIGINT:
+		case DUCKDB_TYPE_UBIGINT:
+		case DUCKDB_TYPE_TIME:
+		case DUCKDB_TYPE_TIMESTAMP:
+			((int64_t *)data)[i] = v;
+			break;
+		case DUCKDB_TYPE_FLOAT:
+			((float *)data)[i] = (float)v * 0.5f;
+			break;
+		case DUCKDB_TYPE_DOUBLE:
+			((double *)data)[i] = (double)v * 0.5;
+			break;
+		case DUCKDB_TYPE_HUGEINT:
+		case DUCKDB_TYPE_UUID:
+			((duckdb_hugeint *)data)[i].lower = (uint64_t)v;
+			((duckdb_hugeint *)data)[i].upper = 0;
+			break;
+		case DUCKDB_TYPE_INTERVAL:
+			((duckdb_interval *)data)[i].months = 0;
+			((duckdb_interval *)data)[i].days = (int32_t)(i % 7);
+			((duckdb_interval *)data)[i].micros = v;
+			break;
+		case DUCKDB_TYPE_VARCHAR:
+		case DUCKDB_TYPE_BLOB: {
+			char text[32];
+			int len = snprintf(text, sizeof(text), "bench-%llu", (unsigned long long)(i % 997));
+			duckdb_vector_assign_string_element_len(vector, i, text, (idx_t)len);
+			break;
+		}
+		default:
+			ok = false;
+			break;
 		}
-		if (part_len == 0) {
-			snprintf(err_msg, sizeof(err_msg), "%s token contains empty field", kind_label);
-			tcc_set_error(error_buf, err_msg);
-			goto fail;
+		if (!ok) {
+			break;
 		}
-		colon = tcc_find_top_level_char(part, ':');
-		if (colon) {
-			*colon = '\0';
-			name_part = part;
-			type_part = colon + 1;
-			while (*name_part && isspace((unsigned char)*name_part)) {
-				name_part++;
-			}
-			part_len = strlen(name_part);
-			while (part_len > 0 && isspace((unsigned char)name_part[part_len - 1])) {
-				name_part[--part_len] = '\0';
-			}
-			while (*type_part && isspace((unsigned char)*type_part)) {
-				type_part++;
-			}
-			part_len = strlen(type_part);
-			while (part_len > 0 && isspace((unsigned char)type_part[part_len - 1])) {
-				type_part[--part_len] = '\0';
+	}
+	return ok;
+}
+
+/* tcc_bench_fill_vector: recursively synthesizes `count` valid rows shaped by `desc` (LIST/MAP rows hold
+ * TCC_BENCH_LIST_LEN elements, UNION tags rotate through members). Allocation/Lifetime: list children are
+ * reserved in the vector; nothing is returned to the caller. */
+static bool tcc_bench_fill_vector(duckdb_vector vector, const tcc_typedesc_t *desc, idx_t count) {
+	idx_t i;
+	if (!desc) {
+		return false;
+	}
+	switch (desc->kind) {
+	case TCC_TYPEDESC_LIST:
+	case TCC_TYPEDESC_MAP: {
+		duckdb_list_entry *entries = (duckdb_list_entry *)duckdb_vector_get_data(vector);
+		idx_t child_count = count * TCC_BENCH_LIST_LEN;
+		duckdb_vector child;
+		if (duckdb_list_vector_reserve(vector, child_count) != DuckDBSuccess ||
+		    duckdb_list_vector_set_size(vector, child_count) != DuckDBSuccess) {
+			return false;
+		}
+		for (i = 0; i < count; i++) {
+			entries[i].offset = i * TCC_BENCH_LIST_LEN;
+			entries[i].length = TCC_BENCH_LIST_LEN;
+		}
+		child = duckdb_list_vector_get_child(vector);
+		if (desc->kind == TCC_TYPEDESC_LIST) {
+			return tcc_bench_fill_vector(child, desc->as.list_like.child, child_count);
+		}
+		return tcc_bench_fill_vector(duckdb_struct_vector_get_child(child, 0), desc->as.map_like.key, child_count) &&
+		       tcc_bench_fill_vector(duckdb_struct_vector_get_child(child, 1), desc->as.map_like.value, child_count);
+	}
+	case TCC_TYPEDESC_ARRAY:
+		return tcc_bench_fill_vector(duckdb_array_vector_get_child(vector), desc->as.list_like.child,
+		                             count * (idx_t)desc->array_size);
+	case TCC_TYPEDESC_STRUCT:
+		for (i = 0; i < desc->as.struct_like.count; i++) {
+			if (!tcc_bench_fill_vector(duckdb_struct_vector_get_child(vector, i), desc->as.struct_like.fields[i].type,
+			                           count)) {
+				return false;
 			}
-			if (!tcc_is_identifier_token(name_part)) {
-				snprintf(err_msg, sizeof(err_msg), "%s field names must be identifiers", kind_label);
-				tcc_set_error(error_buf, err_msg);
-				goto fail;
+		}
+		return true;
+	case TCC_TYPEDESC_UNION: {
+		uint8_t *tags = (uint8_t *)duckdb_vector_get_data(duckdb_struct_vector_get_child(vector, 0));
+		idx_t members = desc->as.union_like.count;
+		if (!tags || members == 0) {
+			return false;
+		}
+		for (i = 0; i < count; i++) {
+			tags[i] = (uint8_t)(i % members);
+		}
+		for (i = 0; i < members; i++) {
+			if (!tcc_bench_fill_vector(duckdb_struct_vector_get_child(vector, i + 1), desc->as.union_like.members[i].type,
+			                           count)) {
+				return false;
 			}
-			if (type_part[0] == '\0') {
-				snprintf(err_msg, sizeof(err_msg), "%s field type is missing", kind_label);
-				tcc_set_error(error_buf, err_msg);
-				goto fail;
+		}
+		return true;
+	}
+	case TCC_TYPEDESC_PRIMITIVE:
+	default:
+		if (desc->ffi_type == TCC_FFI_PTR) {
+			return false;
+		}
+		return tcc_bench_fill_primitive(vector, count);
+	}
+}
+
+/* tcc_bench_find_ctx: signature ctx of the registered UDF named `sql_name`, and the artifact holding its code.
+ * Allocation/Lifetime: caller holds the state lock; the ctx is borrowed from DuckDB's function catalog and lives as
+ * long as the database, the artifact is borrowed from the registry. */
+static tcc_host_sig_ctx_t *tcc_bench_find_ctx(tcc_module_state_t *state, const char *sql_name,
+                                              tcc_registered_artifact_t **out_artifact) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	(void)state;
+	(void)sql_name;
+	(void)out_artifact;
+	return NULL;
+#else
+	idx_t i;
+	idx_t j;
+	for (i = 0; i < state->entry_count; i++) {
+		tcc_registered_artifact_t *artifact = state->entries[i].artifact;
+		if (!artifact) {
+			continue;
+		}
+		for (j = 0; j < artifact->udf_stats_count; j++) {
+			tcc_udf_stats_t *stats = artifact->udf_stats[j];
+			if (stats && stats->ctx && stats->sql_name && strcmp(stats->sql_name, sql_name) == 0) {
+				*out_artifact = artifact;
+				return stats->ctx;
 			}
-		} else if (allow_auto_names) {
-			snprintf(auto_name, sizeof(auto_name), "f%d", count + 1);
-			name_part = auto_name;
-			type_part = part;
-		} else {
-			snprintf(err_msg, sizeof(err_msg), "%s member must use name:type", kind_label);
-			tcc_set_error(error_buf, err_msg);
-			goto fail;
 		}
-		if (!tcc_parse_type_token(type_part, false, &parsed_type, &parsed_array_size)) {
-			snprintf(err_msg, sizeof(err_msg), "%s field type token is unsupported", kind_label);
-			tcc_set_error(error_buf, err_msg);
-			goto fail;
+	}
+	return NULL;
+#endif
+}
+
+/**
+ * @function tcc_mode_bench
+ * @brief Handles `mode := 'bench'`: times the registered UDF's executor over synthesized input chunks.
+ * @param[in] state Extension state; the caller holds its read lock, which this handler releases.
+ * @param[in] bind Parsed bind data (`sql_name`, `rows`, `null_ratio`).
+ * @param[out] output `tcc_module(...)` result chunk; fills the `bench` STRUCT column on success.
+ * @ownership borrows(state,bind,output); owns the synthesized input/output chunks until return
+ * @heap one input chunk (duckdb_vector_size() rows, LIST/MAP children TCC_BENCH_LIST_LEN per row) and one
+ *       output chunk, reused across iterations; the executor's per-chunk scratch as in normal execution
+ * @stack fixed-size locals only
+ * @thread_safety runs user code on the calling thread; the executor is the one DuckDB calls, with the same ctx
+ * @locks the dispatcher's read lock is held only to find the UDF and pin its artifact; it is released before any
+ *        user code runs, so compiles and re-entrant calls are not blocked by a long benchmark
+ * @errors E_MISSING_ARGS, E_BAD_ARGS (null_ratio outside [0,1], rows = 0, ptr arguments), E_NOT_FOUND,
+ *         E_STORE_FAILED (chunk allocation), E_EXEC_FAILED (executor error, message in detail)
+ * @note Input rows are generated once and replayed for every chunk. `ns_per_row` comes from an uninstrumented
+ *       pass; the marshal/call/writeback split comes from a second, instrumented pass (three clock reads per row
+ *       in row mode) with the measured clock cost subtracted per lap, so the split approximates `ns_per_row`.
+ */
+static void tcc_mode_bench(tcc_module_state_t *state, const tcc_module_bind_data_t *bind, duckdb_data_chunk output) {
+	tcc_host_sig_ctx_t *ctx = NULL;
+	tcc_registered_artifact_t *artifact = NULL;
+	duckdb_logical_type *arg_types = NULL;
+	duckdb_logical_type ret_type = NULL;
+	duckdb_data_chunk input = NULL;
+	duckdb_data_chunk result = NULL;
+	tcc_exec_split_t split;
+	double phase_ns[3];
+	double clock_ns;
+	duckdb_logical_type placeholder_type = NULL;
+	uint64_t rows = bind->has_bench_rows ? bind->bench_rows : TCC_BENCH_DEFAULT_ROWS;
+	double null_ratio = bind->bench_null_ratio;
+	idx_t chunk_rows;
+	uint64_t chunks;
+	uint64_t total_ns = 0;
+	uint64_t done;
+	const char *error = NULL;
+	char detail[256];
+	int pass;
+	int col;
+	memset(&split, 0, sizeof(split));
+	if (bind->sql_name && bind->sql_name[0] != '\0') {
+		ctx = tcc_bench_find_ctx(state, bind->sql_name, &artifact);
+	}
+	if (artifact) {
+		/* The pin keeps the UDF's code alive once the lock is gone. */
+		atomic_fetch_add_explicit(&artifact->refs, 1, memory_order_relaxed);
+	}
+	tcc_rwlock_read_unlock(&state->lock);
+	if (!bind->sql_name || bind->sql_name[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "sql_name is required", NULL, NULL, NULL,
+		              NULL, "connection");
+		return;
+	}
+	if (!(null_ratio >= 0.0 && null_ratio <= 1.0) || rows == 0) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "rows must be > 0 and null_ratio in [0, 1]",
+		              NULL, bind->sql_name, NULL, NULL, "connection");
+		goto cleanup;
+	}
+	if (!ctx) {
+		tcc_write_row(output, false, bind->mode, "bench", "E_NOT_FOUND", "no registered UDF with this sql_name",
+		              NULL, bind->sql_name, NULL, NULL, "connection");
+		return;
+	}
+	chunk_rows = duckdb_vector_size();
+	if ((uint64_t)chunk_rows > rows) {
+		chunk_rows = (idx_t)rows;
+	}
+	chunks = (rows + chunk_rows - 1) / chunk_rows;
+	if (ctx->arg_count > 0) {
+		arg_types = (duckdb_logical_type *)duckdb_malloc(sizeof(duckdb_logical_type) * (size_t)ctx->arg_count);
+		if (!arg_types) {
+			error = "out of memory";
+			goto fail_store;
 		}
-		if (parsed_type == TCC_FFI_VOID) {
-			snprintf(err_msg, sizeof(err_msg), "%s fields cannot use void", kind_label);
-			tcc_set_error(error_buf, err_msg);
-			goto fail;
+		memset(arg_types, 0, sizeof(duckdb_logical_type) * (size_t)ctx->arg_count);
+		for (col = 0; col < ctx->arg_count; col++) {
+			arg_types[col] = tcc_typedesc_create_logical_type(ctx->arg_descs ? ctx->arg_descs[col] : NULL);
+			if (!arg_types[col]) {
+				error = "failed to create argument type";
+				goto fail_store;
+			}
 		}
-		parsed_size = tcc_ffi_type_size(parsed_type);
-		if (parsed_size == 0) {
-			snprintf(err_msg, sizeof(err_msg), "%s field has unsupported storage type", kind_label);
-			tcc_set_error(error_buf, err_msg);
-			goto fail;
+	}
+	ret_type = tcc_typedesc_create_logical_type(ctx->return_desc);
+	if (ctx->arg_count > 0) {
+		input = duckdb_create_data_chunk(arg_types, (idx_t)ctx->arg_count);
+	} else {
+		/* DuckDB chunks need a column; zero-argument executors only read the chunk size. */
+		placeholder_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
+		input = duckdb_create_data_chunk(&placeholder_type, 1);
+	}
+	result = ret_type ? duckdb_create_data_chunk(&ret_type, 1) : NULL;
+	if (!input || !result) {
+		error = "failed to allocate benchmark chunks";
+		goto fail_store;
+	}
+	for (col = 0; col < ctx->arg_count; col++) {
+		duckdb_vector v = duckdb_data_chunk_get_vector(input, (idx_t)col);
+		idx_t row;
+		if (!tcc_bench_fill_vector(v, ctx->arg_descs[col], chunk_rows)) {
+			tcc_write_row(output, false, bind->mode, "bench", "E_BAD_ARGS",
+			              "cannot synthesize input for this argument type (ptr arguments are not supported)",
+			              ctx->arg_descs[col]->token, bind->sql_name, NULL, NULL, "connection");
+			goto cleanup;
 		}
-		if (count >= cap) {
-			int new_cap = cap == 0 ? 4 : cap * 2;
-			new_names = (char **)duckdb_malloc(sizeof(char *) * (size_t)new_cap);
-			new_tokens = (char **)duckdb_malloc(sizeof(char *) * (size_t)new_cap);
-			new_types = (tcc_ffi_type_t *)duckdb_malloc(sizeof(tcc_ffi_type_t) * (size_t)new_cap);
-			new_sizes = (size_t *)duckdb_malloc(sizeof(size_t) * (size_t)new_cap);
-			if (!new_names || !new_tokens || !new_types || !new_sizes) {
-				if (new_names) {
-					duckdb_free(new_names);
-				}
-				if (new_tokens) {
-					duckdb_free(new_tokens);
-				}
-				if (new_types) {
-					duckdb_free(new_types);
+		if (null_ratio > 0.0) {
+			uint64_t *validity;
+			duckdb_vector_ensure_validity_writable(v);
+			validity = duckdb_vector_get_validity(v);
+			for (row = 0; row < chunk_rows; row++) {
+				if (tcc_bench_row_is_null(null_ratio, col, row)) {
+					duckdb_validity_set_row_invalid(validity, row);
 				}
-				if (new_sizes) {
-					duckdb_free(new_sizes);
-				}
-				tcc_set_error(error_buf, "out of memory");
-				goto fail;
-			}
-			memset(new_names, 0, sizeof(char *) * (size_t)new_cap);
-			memset(new_tokens, 0, sizeof(char *) * (size_t)new_cap);
-			if (names && count > 0) {
-				memcpy(new_names, names, sizeof(char *) * (size_t)count);
-				memcpy(new_tokens, tokens, sizeof(char *) * (size_t)count);
-				memcpy(new_types, types, sizeof(tcc_ffi_type_t) * (size_t)count);
-				memcpy(new_sizes, sizes, sizeof(size_t) * (size_t)count);
-				duckdb_free(names);
-				duckdb_free(tokens);
-				duckdb_free(types);
-				duckdb_free(sizes);
 			}
-			names = new_names;
-			tokens = new_tokens;
-			types = new_types;
-			sizes = new_sizes;
-			cap = new_cap;
-		}
-		names[count] = tcc_strdup(name_part);
-		tokens[count] = tcc_strdup(type_part);
-		if (!names[count] || !tokens[count]) {
-			tcc_set_error(error_buf, "out of memory");
-			goto fail;
 		}
-		types[count] = parsed_type;
-		sizes[count] = parsed_size;
-		count++;
-	}
-	if (count <= 0) {
-		snprintf(err_msg, sizeof(err_msg), "%s token requires at least one field", kind_label);
-		tcc_set_error(error_buf, err_msg);
-		goto fail;
 	}
-	*out_count = count;
-	*out_names = names;
-	*out_tokens = tokens;
-	*out_types = types;
-	*out_sizes = sizes;
-	return true;
-fail:
-	if (names) {
-		int i;
-		for (i = 0; i < count; i++) {
-			if (names[i]) {
-				duckdb_free(names[i]);
+	/* Pass 0 warms caches and is discarded, pass 1 is the uninstrumented total, pass 2 collects the split. */
+	for (pass = 0; pass < 3; pass++) {
+		uint64_t iterations = pass == 0 ? 1 : chunks;
+		uint64_t it;
+		done = 0;
+		for (it = 0; it < iterations; it++) {
+			idx_t n = (idx_t)((rows - done) < (uint64_t)chunk_rows ? (rows - done) : (uint64_t)chunk_rows);
+			uint64_t t0;
+			bool ok;
+			duckdb_data_chunk_reset(result);
+			duckdb_data_chunk_set_size(input, n);
+			duckdb_data_chunk_set_size(result, n);
+			t0 = tcc_now_ns();
+			ok = tcc_execute_chunk(ctx, input, duckdb_data_chunk_get_vector(result, 0), pass == 2 ? &split : NULL,
+			                       &error);
+			if (pass == 1) {
+				total_ns += tcc_now_ns() - t0;
 			}
+			if (!ok) {
+				tcc_write_row(output, false, bind->mode, "bench", "E_EXEC_FAILED", "UDF execution failed", error,
+				              bind->sql_name, NULL, NULL, "connection");
+				goto cleanup;
+			}
+			done += n;
 		}
-		duckdb_free(names);
 	}
-	if (tokens) {
-		int i;
-		for (i = 0; i < count; i++) {
-			if (tokens[i]) {
-				duckdb_free(tokens[i]);
+	clock_ns = tcc_bench_clock_cost_ns();
+	for (pass = 0; pass < 3; pass++) {
+		double overhead = clock_ns * (double)split.laps[pass];
+		phase_ns[pass] = (double)split.ns[pass] > overhead ? (double)split.ns[pass] - overhead : 0.0;
+	}
+	snprintf(detail, sizeof(detail), "wrapper_mode=%s rows=%llu chunks=%llu ns_per_row=%.2f",
+	         tcc_wrapper_mode_token(ctx->wrapper_mode), (unsigned long long)rows, (unsigned long long)chunks,
+	         (double)total_ns / (double)rows);
+	tcc_write_row(output, true, bind->mode, "bench", "OK", "benchmarked UDF executor", detail, bind->sql_name, NULL,
+	              NULL, "connection");
+	tcc_write_bench_col(output, rows, chunks, null_ratio, total_ns, phase_ns);
+	goto cleanup;
+
+fail_store:
+	tcc_write_row(output, false, bind->mode, "bench", "E_STORE_FAILED", "failed to prepare benchmark input", error,
+	              bind->sql_name, NULL, NULL, "connection");
+cleanup:
+	if (input) {
+		duckdb_destroy_data_chunk(&input);
+	}
+	if (result) {
+		duckdb_destroy_data_chunk(&result);
+	}
+	if (ret_type) {
+		duckdb_destroy_logical_type(&ret_type);
+	}
+	if (placeholder_type) {
+		duckdb_destroy_logical_type(&placeholder_type);
+	}
+	if (arg_types) {
+		for (col = 0; col < ctx->arg_count; col++) {
+			if (arg_types[col]) {
+				duckdb_destroy_logical_type(&arg_types[col]);
 			}
 		}
-		duckdb_free(tokens);
-	}
-	if (types) {
-		duckdb_free(types);
+		duckdb_free((void *)arg_types);
 	}
-	if (sizes) {
-		duckdb_free(sizes);
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_artifact_destroy(artifact);
+#endif
+}
+
+/* ===== Section: File Readers (file_reader / tcc_read) ===== */
+/* Most ranges one splitter call may return; a file is scanned by at most this many threads. */
+#define TCC_READER_MAX_RANGES 4096
+
+/* `<symbol>_split`: writes up to `max_ranges` ascending range start offsets (the first must be 0) and returns the
+ * count. Ranges must be decodable independently. */
+typedef uint64_t (*tcc_reader_split_fn_t)(const uint8_t *data, uint64_t size, uint64_t *starts, uint64_t max_ranges);
+/* Decoder: decodes rows from data[*pos, end) into the column arrays (at most `capacity` rows), advances *pos and
+ * returns the row count; 0 finishes the range, a negative value reports malformed input. */
+typedef int64_t (*tcc_reader_decode_fn_t)(const uint8_t *data, uint64_t *pos, uint64_t end, void **columns,
+                                          uint64_t capacity);
+
+/* Compiled decoder registered for one file extension. Shared by the module state and every scan bound to it. */
+struct tcc_file_reader {
+	char *extension;
+	tcc_reader_decode_fn_t decode;
+	/* NULL when the source defines no `<symbol>_split`: the whole file is one range. */
+	tcc_reader_split_fn_t split;
+	/* Output columns, parsed from the `struct<...>` return_type. */
+	tcc_ffi_struct_meta_t columns;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	/* Relocated code of decode/split (one reference). */
+	tcc_registered_artifact_t *artifact;
+#endif
+	/* Owners: the state's reader list and each bound scan. */
+	atomic_int refs;
+};
+
+/* Input file of one scan: memory-mapped where available, otherwise read into memory. */
+typedef struct {
+	const uint8_t *data;
+	uint64_t size;
+	bool mapped;
+} tcc_mapped_file_t;
+
+/* Bind payload of `tcc_read(path, extension)`. */
+typedef struct {
+	char *path;
+	tcc_file_reader_t *reader;
+} tcc_read_bind_data_t;
+
+/* Global scan state: the mapped file, its ranges and the next range to hand out. */
+typedef struct {
+	tcc_mapped_file_t file;
+	uint64_t *starts;
+	uint64_t range_count;
+	atomic_uint_fast64_t next_range;
+} tcc_read_init_data_t;
+
+/* Per-thread scan state: the range being decoded. */
+typedef struct {
+	bool active;
+	uint64_t pos;
+	uint64_t end;
+} tcc_read_local_data_t;
+
+/* tcc_file_reader_release: drops one reference; the last one frees the decoder code and column metadata. */
+static void tcc_file_reader_release(tcc_file_reader_t *reader) {
+	if (!reader || atomic_fetch_sub_explicit(&reader->refs, 1, memory_order_acq_rel) != 1) {
+		return;
 	}
-	*out_count = 0;
-	*out_names = NULL;
-	*out_tokens = NULL;
-	*out_types = NULL;
-	*out_sizes = NULL;
-	return false;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_artifact_destroy(reader->artifact);
+#endif
+	tcc_struct_meta_destroy(&reader->columns);
+	if (reader->extension) {
+		duckdb_free(reader->extension);
+	}
+	duckdb_free(reader);
 }
 
-/* tcc_parse_struct_meta_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_struct_meta_token(const char *token, tcc_ffi_struct_meta_t *out_meta,
-                                        tcc_error_buffer_t *error_buf) {
-	size_t token_len;
-	char *inner = NULL;
-	bool ok;
-	if (!token || !out_meta) {
-		tcc_set_error(error_buf, "invalid struct token");
-		return false;
+/* tcc_file_readers_destroy: releases the state's reader list (scans still running keep their own reference). */
+static void tcc_file_readers_destroy(tcc_module_state_t *state) {
+	idx_t i;
+	for (i = 0; i < state->reader_count; i++) {
+		tcc_file_reader_release(state->readers[i]);
 	}
-	memset(out_meta, 0, sizeof(*out_meta));
-	token_len = strlen(token);
-	if (token_len <= 8 || !((token[0] == 's' || token[0] == 'S') && (token[1] == 't' || token[1] == 'T') &&
-	                        (token[2] == 'r' || token[2] == 'R') && (token[3] == 'u' || token[3] == 'U') &&
-	                        (token[4] == 'c' || token[4] == 'C') && (token[5] == 't' || token[5] == 'T') &&
-	                        token[6] == '<' && token[token_len - 1] == '>')) {
-		tcc_set_error(error_buf, "struct token must use struct<...>");
-		return false;
+	if (state->readers) {
+		duckdb_free((void *)state->readers);
 	}
-	inner = (char *)duckdb_malloc(token_len - 6);
-	if (!inner) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+	state->readers = NULL;
+	state->reader_count = 0;
+	state->reader_capacity = 0;
+}
+
+/* tcc_file_reader_find: returns the reader index registered for `extension` (case-insensitive), or -1. Caller holds
+ * the state lock. */
+static idx_t tcc_file_reader_find(const tcc_module_state_t *state, const char *extension) {
+	idx_t i;
+	for (i = 0; extension && i < state->reader_count; i++) {
+		if (tcc_equals_ci(state->readers[i]->extension, extension)) {
+			return i;
+		}
 	}
-	memcpy(inner, token + 7, token_len - 8);
-	inner[token_len - 8] = '\0';
-	ok = tcc_parse_composite_fields_inner(inner, true, "struct", &out_meta->field_count, &out_meta->field_names,
-	                                      &out_meta->field_tokens, &out_meta->field_types, &out_meta->field_sizes,
-	                                      error_buf);
-	duckdb_free(inner);
-	return ok;
+	return (idx_t)-1;
 }
 
-/* tcc_parse_map_meta_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_map_meta_token(const char *token, tcc_ffi_map_meta_t *out_meta, tcc_error_buffer_t *error_buf) {
-	size_t token_len;
-	char *inner = NULL;
-	char *sep;
-	char *key_token;
-	char *value_token;
-	tcc_ffi_type_t key_type = TCC_FFI_VOID;
-	tcc_ffi_type_t value_type = TCC_FFI_VOID;
-	size_t key_array_size = 0;
-	size_t value_array_size = 0;
-	size_t key_size = 0;
-	size_t value_size = 0;
-	char *key_token_copy = NULL;
-	char *value_token_copy = NULL;
-	if (!token || !out_meta) {
-		tcc_set_error(error_buf, "invalid map token");
+/* tcc_reader_column_supported: decoders write straight into DuckDB's vector buffers, so columns are fixed-width. */
+static bool tcc_reader_column_supported(tcc_ffi_type_t type) {
+	return (type >= TCC_FFI_BOOL && type <= TCC_FFI_F64) || type == TCC_FFI_DATE || type == TCC_FFI_TIME ||
+	       type == TCC_FFI_TIMESTAMP;
+}
+
+/* tcc_mapped_file_open: maps `path` read-only (reads it on platforms without mmap). An empty file maps to size 0. */
+static bool tcc_mapped_file_open(const char *path, tcc_mapped_file_t *out) {
+#ifdef TCC_READER_MMAP
+	struct stat st;
+	void *data;
+	int fd;
+	memset(out, 0, sizeof(*out));
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
 		return false;
 	}
-	memset(out_meta, 0, sizeof(*out_meta));
-	token_len = strlen(token);
-	if (token_len <= 5 || !((token[0] == 'm' || token[0] == 'M') && (token[1] == 'a' || token[1] == 'A') &&
-	                        (token[2] == 'p' || token[2] == 'P') && token[3] == '<' &&
-	                        token[token_len - 1] == '>')) {
-		tcc_set_error(error_buf, "map token must use map<key_type;value_type>");
+	if (fstat(fd, &st) != 0) {
+		close(fd);
 		return false;
 	}
-	inner = (char *)duckdb_malloc(token_len - 3);
-	if (!inner) {
-		tcc_set_error(error_buf, "out of memory");
+	if (st.st_size > 0) {
+		data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			return false;
+		}
+		out->data = (const uint8_t *)data;
+		out->size = (uint64_t)st.st_size;
+		out->mapped = true;
+	}
+	close(fd);
+	return true;
+#else
+	FILE *fp = fopen(path, "rb");
+	long len;
+	uint8_t *data;
+	memset(out, 0, sizeof(*out));
+	if (!fp) {
 		return false;
 	}
-	memcpy(inner, token + 4, token_len - 5);
-	inner[token_len - 5] = '\0';
-	sep = tcc_find_top_level_char(inner, ';');
-	if (!sep || tcc_find_top_level_char(sep + 1, ';')) {
-		duckdb_free(inner);
-		tcc_set_error(error_buf, "map token must use exactly one ';' separator");
+	if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+		fclose(fp);
 		return false;
 	}
-	*sep = '\0';
-	key_token = inner;
-	value_token = sep + 1;
-	while (*key_token && isspace((unsigned char)*key_token)) {
-		key_token++;
+	data = len > 0 ? (uint8_t *)duckdb_malloc((size_t)len) : NULL;
+	if (len > 0 && (!data || fread(data, 1, (size_t)len, fp) != (size_t)len)) {
+		duckdb_free(data);
+		fclose(fp);
+		return false;
 	}
-	while (*value_token && isspace((unsigned char)*value_token)) {
-		value_token++;
+	fclose(fp);
+	out->data = data;
+	out->size = (uint64_t)len;
+	return true;
+#endif
+}
+
+/* tcc_mapped_file_close: unmaps or frees the file contents. */
+static void tcc_mapped_file_close(tcc_mapped_file_t *file) {
+#ifdef TCC_READER_MMAP
+	if (file->mapped) {
+		munmap((void *)file->data, (size_t)file->size);
 	}
-	{
-		size_t len = strlen(key_token);
-		while (len > 0 && isspace((unsigned char)key_token[len - 1])) {
-			key_token[--len] = '\0';
-		}
+#else
+	if (file->data) {
+		duckdb_free((void *)file->data);
 	}
-	{
-		size_t len = strlen(value_token);
-		while (len > 0 && isspace((unsigned char)value_token[len - 1])) {
-			value_token[--len] = '\0';
+#endif
+	memset(file, 0, sizeof(*file));
+}
+
+/**
+ * @function tcc_mode_file_reader
+ * @brief Handles `mode := 'file_reader'`: compiles a decoder and registers it for a file extension.
+ * @param[in] state Module state whose reader list receives the decoder.
+ * @param[in] bind `sql_name` is the extension, `symbol` the decoder, `return_type` a `struct<...>` of columns.
+ * @param[in] runtime_path TinyCC runtime directory.
+ * @param[out] output One status row.
+ * @ownership borrows(state,bind), transfers(new reader to state->readers)
+ * @thread_safety caller holds the module state write lock
+ * @note The decoder is compiled like a module whose "init" symbol is the decoder itself; it is looked up, never
+ * called as an init. A previous reader for the same extension is replaced; scans already bound keep using it.
+ */
+static void tcc_mode_file_reader(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                 const char *runtime_path, duckdb_data_chunk output) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	(void)state;
+	(void)runtime_path;
+	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
+	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, bind->symbol,
+	              NULL, "database");
+#else
+	const char *extension = bind->sql_name;
+	tcc_file_reader_t *reader = NULL;
+	tcc_registered_artifact_t *artifact = NULL;
+	tcc_error_buffer_t err;
+	char split_symbol[256];
+	char detail[sizeof(split_symbol) + 64];
+	const char *p;
+	idx_t existing;
+	int c;
+	memset(&err, 0, sizeof(err));
+	if (extension && extension[0] == '.') {
+		extension++;
+	}
+	if (!extension || extension[0] == '\0' || !bind->symbol || !tcc_is_identifier_token(bind->symbol) ||
+	    !bind->return_type || bind->return_type[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
+		              "sql_name (file extension), symbol and return_type are required", NULL, bind->sql_name,
+		              bind->symbol, NULL, "database");
+		return;
+	}
+	for (p = extension; *p; p++) {
+		if (!isalnum((unsigned char)*p) && *p != '_' && *p != '.') {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
+			              "file extension may only contain letters, digits, '_' and '.'", NULL, bind->sql_name,
+			              bind->symbol, NULL, "database");
+			return;
 		}
 	}
-	if (key_token[0] == '\0' || value_token[0] == '\0') {
-		duckdb_free(inner);
-		tcc_set_error(error_buf, "map token key/value type is missing");
-		return false;
+	reader = (tcc_file_reader_t *)duckdb_malloc(sizeof(tcc_file_reader_t));
+	if (!reader) {
+		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED", "out of memory", NULL,
+		              bind->sql_name, bind->symbol, NULL, "database");
+		return;
 	}
-	key_token_copy = tcc_strdup(key_token);
-	value_token_copy = tcc_strdup(value_token);
-	if (!key_token_copy || !value_token_copy) {
-		if (key_token_copy) {
-			duckdb_free(key_token_copy);
+	memset(reader, 0, sizeof(tcc_file_reader_t));
+	atomic_init(&reader->refs, 1);
+	reader->extension = tcc_strdup(extension);
+	if (!tcc_parse_struct_meta_token(bind->return_type, &reader->columns, &err)) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_SIGNATURE", "return_type must be struct<...>",
+		              err.message, bind->sql_name, bind->symbol, NULL, "database");
+		goto fail;
+	}
+	for (c = 0; c < reader->columns.field_count; c++) {
+		if (!tcc_reader_column_supported(reader->columns.field_types[c])) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_SIGNATURE",
+			              "file reader columns must be fixed-width (bool, integers, floats, date, time, timestamp)",
+			              reader->columns.field_tokens[c], bind->sql_name, bind->symbol, NULL, "database");
+			goto fail;
 		}
-		if (value_token_copy) {
-			duckdb_free(value_token_copy);
+	}
+	if (tcc_build_module_artifact(runtime_path, state, bind, bind->symbol, extension, &artifact, &err, NULL) != 0) {
+		tcc_write_row(output, false, bind->mode, "compile", "E_COMPILE_FAILED", "compile failed",
+		              err.message[0] ? err.message : NULL, bind->sql_name, bind->symbol, NULL, "database");
+		goto fail;
+	}
+	reader->artifact = artifact;
+	/* module_init is typed for the generated init; re-fetch the decoder as data and cast to its real type. */
+	reader->decode = (tcc_reader_decode_fn_t)tcc_get_symbol(artifact->tcc, bind->symbol);
+	snprintf(split_symbol, sizeof(split_symbol), "%s_split", bind->symbol);
+	reader->split = (tcc_reader_split_fn_t)tcc_get_symbol(artifact->tcc, split_symbol);
+	existing = tcc_file_reader_find(state, extension);
+	if (!reader->extension) {
+		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED", "out of memory", NULL,
+		              bind->sql_name, bind->symbol, NULL, "database");
+		goto fail;
+	}
+	if (existing != (idx_t)-1) {
+		tcc_file_reader_release(state->readers[existing]);
+		state->readers[existing] = reader;
+	} else {
+		if (state->reader_count == state->reader_capacity) {
+			idx_t new_capacity = state->reader_capacity == 0 ? 4 : state->reader_capacity * 2;
+			tcc_file_reader_t **grown =
+			    (tcc_file_reader_t **)duckdb_malloc(sizeof(tcc_file_reader_t *) * (size_t)new_capacity);
+			if (!grown) {
+				tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED", "out of memory", NULL,
+				              bind->sql_name, bind->symbol, NULL, "database");
+				goto fail;
+			}
+			if (state->readers) {
+				memcpy(grown, state->readers, sizeof(tcc_file_reader_t *) * (size_t)state->reader_count);
+				duckdb_free((void *)state->readers);
+			}
+			state->readers = grown;
+			state->reader_capacity = new_capacity;
 		}
-		duckdb_free(inner);
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+		state->readers[state->reader_count++] = reader;
 	}
-	if (!tcc_parse_type_token(key_token, false, &key_type, &key_array_size) ||
-	    !tcc_parse_type_token(value_token, false, &value_type, &value_array_size) || key_type == TCC_FFI_VOID ||
-	    value_type == TCC_FFI_VOID) {
-		duckdb_free(key_token_copy);
-		duckdb_free(value_token_copy);
-		duckdb_free(inner);
-		tcc_set_error(error_buf, "map key/value contains unsupported type token");
-		return false;
+	snprintf(detail, sizeof(detail), "columns=%d splitter=%s", reader->columns.field_count,
+	         reader->split ? split_symbol : "(none)");
+	tcc_write_row(output, true, bind->mode, "load", "OK", "file reader registered", detail, bind->sql_name,
+	              bind->symbol, NULL, "database");
+	return;
+
+fail:
+	tcc_file_reader_release(reader);
+#endif
+}
+
+/* destroy_tcc_read_bind_data: Destructor callback for DuckDB bind payloads. Allocation/Lifetime: releases the path
+ * copy and the reader reference. */
+static void destroy_tcc_read_bind_data(void *ptr) {
+	tcc_read_bind_data_t *bind = (tcc_read_bind_data_t *)ptr;
+	if (!bind) {
+		return;
 	}
-	key_size = tcc_ffi_type_size(key_type);
-	value_size = tcc_ffi_type_size(value_type);
-	duckdb_free(inner);
-	if (key_size == 0 || value_size == 0) {
-		duckdb_free(key_token_copy);
-		duckdb_free(value_token_copy);
-		tcc_set_error(error_buf, "map key/value has unsupported storage type");
-		return false;
+	if (bind->path) {
+		duckdb_free(bind->path);
 	}
-	out_meta->key_token = key_token_copy;
-	out_meta->value_token = value_token_copy;
-	out_meta->key_type = key_type;
-	out_meta->value_type = value_type;
-	out_meta->key_size = key_size;
-	out_meta->value_size = value_size;
-	return true;
+	tcc_file_reader_release(bind->reader);
+	duckdb_free(bind);
 }
 
-/* tcc_parse_union_meta_token: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_parse_union_meta_token(const char *token, tcc_ffi_union_meta_t *out_meta,
-                                       tcc_error_buffer_t *error_buf) {
-	size_t token_len;
-	char *inner = NULL;
-	bool ok;
-	if (!token || !out_meta) {
-		tcc_set_error(error_buf, "invalid union token");
-		return false;
+/* Bind callback for `tcc_read(path, extension)`: pins the registered reader and declares its columns. */
+static void tcc_read_bind(duckdb_bind_info info) {
+	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_bind_get_extra_info(info);
+	duckdb_value path_value = duckdb_bind_get_parameter(info, 0);
+	duckdb_value ext_value = duckdb_bind_get_parameter(info, 1);
+	char *path = path_value && !duckdb_is_null_value(path_value) ? duckdb_get_varchar(path_value) : NULL;
+	char *extension = ext_value && !duckdb_is_null_value(ext_value) ? duckdb_get_varchar(ext_value) : NULL;
+	tcc_read_bind_data_t *bind = NULL;
+	tcc_file_reader_t *reader = NULL;
+	idx_t idx;
+	int c;
+	if (path_value) {
+		duckdb_destroy_value(&path_value);
 	}
-	memset(out_meta, 0, sizeof(*out_meta));
-	token_len = strlen(token);
-	if (token_len <= 7 || !((token[0] == 'u' || token[0] == 'U') && (token[1] == 'n' || token[1] == 'N') &&
-	                        (token[2] == 'i' || token[2] == 'I') && (token[3] == 'o' || token[3] == 'O') &&
-	                        (token[4] == 'n' || token[4] == 'N') && token[5] == '<' && token[token_len - 1] == '>')) {
-		tcc_set_error(error_buf, "union token must use union<name:type;...>");
-		return false;
+	if (ext_value) {
+		duckdb_destroy_value(&ext_value);
 	}
-	inner = (char *)duckdb_malloc(token_len - 4);
-	if (!inner) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+	if (!state || !path || !extension) {
+		duckdb_bind_set_error(info, "tcc_read requires a path and a registered file extension");
+		goto done;
+	}
+	tcc_rwlock_read_lock(&state->lock);
+	idx = tcc_file_reader_find(state, extension[0] == '.' ? extension + 1 : extension);
+	if (idx != (idx_t)-1) {
+		reader = state->readers[idx];
+		atomic_fetch_add_explicit(&reader->refs, 1, memory_order_relaxed);
+	}
+	tcc_rwlock_read_unlock(&state->lock);
+	if (!reader) {
+		duckdb_bind_set_error(info, "no file reader registered for this extension (use mode := 'file_reader')");
+		goto done;
+	}
+	bind = (tcc_read_bind_data_t *)duckdb_malloc(sizeof(tcc_read_bind_data_t));
+	if (!bind) {
+		tcc_file_reader_release(reader);
+		duckdb_bind_set_error(info, "out of memory");
+		goto done;
+	}
+	bind->path = path;
+	bind->reader = reader;
+	path = NULL;
+	for (c = 0; c < reader->columns.field_count; c++) {
+		duckdb_logical_type type = tcc_ffi_type_create_logical_type(reader->columns.field_types[c], 0, NULL, NULL, NULL);
+		duckdb_bind_add_result_column(info, reader->columns.field_names[c], type);
+		duckdb_destroy_logical_type(&type);
+	}
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_read_bind_data);
+done:
+	if (path) {
+		duckdb_free(path);
+	}
+	if (extension) {
+		duckdb_free(extension);
 	}
-	memcpy(inner, token + 6, token_len - 7);
-	inner[token_len - 7] = '\0';
-	ok = tcc_parse_composite_fields_inner(inner, false, "union", &out_meta->member_count, &out_meta->member_names,
-	                                      &out_meta->member_tokens, &out_meta->member_types, &out_meta->member_sizes,
-	                                      error_buf);
-	duckdb_free(inner);
-	return ok;
 }
 
-/* tcc_typedesc_destroy: Type-system conversion/parsing helper. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
-static void tcc_typedesc_destroy(tcc_typedesc_t *desc) {
-	idx_t i;
-	if (!desc) {
+/* destroy_tcc_read_init_data: Destructor callback for DuckDB init payloads. Allocation/Lifetime: unmaps the file
+ * and frees the range table. */
+static void destroy_tcc_read_init_data(void *ptr) {
+	tcc_read_init_data_t *init = (tcc_read_init_data_t *)ptr;
+	if (!init) {
 		return;
 	}
-	if (desc->token) {
-		duckdb_free(desc->token);
+	tcc_mapped_file_close(&init->file);
+	if (init->starts) {
+		duckdb_free(init->starts);
 	}
-	if (desc->kind == TCC_TYPEDESC_LIST || desc->kind == TCC_TYPEDESC_ARRAY) {
-		tcc_typedesc_destroy(desc->as.list_like.child);
-	} else if (desc->kind == TCC_TYPEDESC_STRUCT) {
-		if (desc->as.struct_like.fields) {
-			for (i = 0; i < desc->as.struct_like.count; i++) {
-				if (desc->as.struct_like.fields[i].name) {
-					duckdb_free(desc->as.struct_like.fields[i].name);
-				}
-				tcc_typedesc_destroy(desc->as.struct_like.fields[i].type);
-			}
-			duckdb_free(desc->as.struct_like.fields);
-		}
-	} else if (desc->kind == TCC_TYPEDESC_MAP) {
-		tcc_typedesc_destroy(desc->as.map_like.key);
-		tcc_typedesc_destroy(desc->as.map_like.value);
-	} else if (desc->kind == TCC_TYPEDESC_UNION) {
-		if (desc->as.union_like.members) {
-			for (i = 0; i < desc->as.union_like.count; i++) {
-				if (desc->as.union_like.members[i].name) {
-					duckdb_free(desc->as.union_like.members[i].name);
-				}
-				tcc_typedesc_destroy(desc->as.union_like.members[i].type);
+	duckdb_free(init);
+}
+
+/* Global init for `tcc_read`: maps the file and splits it into ranges; one scan thread per range at most. */
+static void tcc_read_init(duckdb_init_info info) {
+	tcc_read_bind_data_t *bind = (tcc_read_bind_data_t *)duckdb_init_get_bind_data(info);
+	tcc_read_init_data_t *init;
+	uint64_t i;
+	init = (tcc_read_init_data_t *)duckdb_malloc(sizeof(tcc_read_init_data_t));
+	if (!init) {
+		duckdb_init_set_error(info, "out of memory");
+		return;
+	}
+	memset(init, 0, sizeof(tcc_read_init_data_t));
+	atomic_init(&init->next_range, 0);
+	if (!tcc_mapped_file_open(bind->path, &init->file)) {
+		duckdb_free(init);
+		duckdb_init_set_error(info, "tcc_read could not open the file");
+		return;
+	}
+	init->starts = (uint64_t *)duckdb_malloc(sizeof(uint64_t) * TCC_READER_MAX_RANGES);
+	if (!init->starts) {
+		destroy_tcc_read_init_data(init);
+		duckdb_init_set_error(info, "out of memory");
+		return;
+	}
+	init->starts[0] = 0;
+	init->range_count = 1;
+	if (bind->reader->split && init->file.size > 0) {
+		init->range_count = bind->reader->split(init->file.data, init->file.size, init->starts, TCC_READER_MAX_RANGES);
+		for (i = 0; i < init->range_count && init->range_count <= TCC_READER_MAX_RANGES; i++) {
+			if (init->starts[i] > init->file.size || (i == 0 && init->starts[0] != 0) ||
+			    (i > 0 && init->starts[i] < init->starts[i - 1])) {
+				break;
 			}
-			duckdb_free(desc->as.union_like.members);
+		}
+		if (init->range_count == 0 || init->range_count > TCC_READER_MAX_RANGES || i != init->range_count) {
+			destroy_tcc_read_init_data(init);
+			duckdb_init_set_error(info, "file reader splitter returned invalid ranges");
+			return;
 		}
 	}
-	duckdb_free(desc);
+	duckdb_init_set_init_data(info, init, destroy_tcc_read_init_data);
+	duckdb_init_set_max_threads(info, (idx_t)init->range_count);
 }
 
-/* tcc_typedesc_parse_token: Type-system conversion/parsing helper. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
-static bool tcc_typedesc_parse_token(const char *token, bool allow_void, tcc_typedesc_t **out_desc,
-                                     tcc_error_buffer_t *error_buf) {
-	tcc_typedesc_t *desc = NULL;
-	tcc_ffi_type_t parsed = TCC_FFI_VOID;
-	size_t array_size = 0;
-	if (!token || !out_desc) {
-		tcc_set_error(error_buf, "type token is required");
-		return false;
-	}
-	*out_desc = NULL;
-	if (!tcc_parse_type_token(token, allow_void, &parsed, &array_size)) {
-		tcc_set_error(error_buf, "type token is unsupported");
-		return false;
+/* Local init for `tcc_read`: each scan thread starts without a range. */
+static void tcc_read_local_init(duckdb_init_info info) {
+	tcc_read_local_data_t *local = (tcc_read_local_data_t *)duckdb_malloc(sizeof(tcc_read_local_data_t));
+	if (!local) {
+		duckdb_init_set_error(info, "out of memory");
+		return;
 	}
-	desc = (tcc_typedesc_t *)duckdb_malloc(sizeof(tcc_typedesc_t));
-	if (!desc) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+	memset(local, 0, sizeof(tcc_read_local_data_t));
+	duckdb_init_set_init_data(info, local, duckdb_free);
+}
+
+/* Scan callback for `tcc_read`: decodes the thread's current range into the output vectors, claiming ranges until
+ * one yields rows or none are left. */
+static void tcc_read_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_read_bind_data_t *bind = (tcc_read_bind_data_t *)duckdb_function_get_bind_data(info);
+	tcc_read_init_data_t *init = (tcc_read_init_data_t *)duckdb_function_get_init_data(info);
+	tcc_read_local_data_t *local = (tcc_read_local_data_t *)duckdb_function_get_local_init_data(info);
+	const tcc_file_reader_t *reader = bind->reader;
+	void *columns[256];
+	uint64_t capacity = (uint64_t)duckdb_vector_size();
+	int64_t rows = 0;
+	int c;
+	if (reader->columns.field_count > (int)(sizeof(columns) / sizeof(columns[0]))) {
+		duckdb_function_set_error(info, "file reader has too many columns");
+		return;
 	}
-	memset(desc, 0, sizeof(*desc));
-	desc->ffi_type = parsed;
-	desc->array_size = array_size;
-	desc->token = tcc_strdup(token);
-	if (!desc->token) {
-		duckdb_free(desc);
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+	for (c = 0; c < reader->columns.field_count; c++) {
+		columns[c] = duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, (idx_t)c));
 	}
-	if (tcc_ffi_type_is_list(parsed)) {
-		tcc_ffi_type_t child_ffi = TCC_FFI_VOID;
-		const char *child_token = NULL;
-		char *owned_child_token = NULL;
-		desc->kind = TCC_TYPEDESC_LIST;
-		if (tcc_ffi_list_child_type(parsed, &child_ffi)) {
-			child_token = tcc_ffi_type_to_token(child_ffi);
-		} else {
-			size_t token_len_local = strlen(token);
-			if (token_len_local > 6 && token[4] == '<' && token[token_len_local - 1] == '>') {
-				owned_child_token = (char *)duckdb_malloc(token_len_local - 4);
-				if (!owned_child_token) {
-					tcc_typedesc_destroy(desc);
-					tcc_set_error(error_buf, "out of memory");
-					return false;
-				}
-				memcpy(owned_child_token, token + 5, token_len_local - 6);
-				owned_child_token[token_len_local - 6] = '\0';
-				child_token = tcc_trim_inplace(owned_child_token);
-			} else if (token_len_local >= 5 && (token[0] == 'l' || token[0] == 'L') && (token[1] == 'i' || token[1] == 'I') &&
-			           (token[2] == 's' || token[2] == 'S') && (token[3] == 't' || token[3] == 'T') && token[4] == '_') {
-				child_token = token + 5;
-			} else if (token_len_local > 2 && token[token_len_local - 2] == '[' && token[token_len_local - 1] == ']') {
-				owned_child_token = (char *)duckdb_malloc(token_len_local - 1);
-				if (!owned_child_token) {
-					tcc_typedesc_destroy(desc);
-					tcc_set_error(error_buf, "out of memory");
-					return false;
-				}
-				memcpy(owned_child_token, token, token_len_local - 2);
-				owned_child_token[token_len_local - 2] = '\0';
-				child_token = tcc_trim_inplace(owned_child_token);
-			}
-		}
-		if (!child_token || !tcc_typedesc_parse_token(child_token, false, &desc->as.list_like.child, error_buf)) {
-			if (owned_child_token) {
-				duckdb_free(owned_child_token);
-			}
-			tcc_typedesc_destroy(desc);
-			return false;
-		}
-		if (owned_child_token) {
-			duckdb_free(owned_child_token);
-		}
-	} else if (tcc_ffi_type_is_array(parsed)) {
-		tcc_ffi_type_t child_ffi = TCC_FFI_VOID;
-		const char *child_token = NULL;
-		char *owned_child_token = NULL;
-		desc->kind = TCC_TYPEDESC_ARRAY;
-		if (tcc_ffi_array_child_type(parsed, &child_ffi)) {
-			child_token = tcc_ffi_type_to_token(child_ffi);
-		} else {
-			size_t token_len_local = strlen(token);
-			const char *lb = strrchr(token, '[');
-			if (lb && token_len_local > 3 && token[token_len_local - 1] == ']' && lb < token + token_len_local - 1) {
-				size_t child_len = (size_t)(lb - token);
-				owned_child_token = (char *)duckdb_malloc(child_len + 1);
-				if (!owned_child_token) {
-					tcc_typedesc_destroy(desc);
-					tcc_set_error(error_buf, "out of memory");
-					return false;
-				}
-				memcpy(owned_child_token, token, child_len);
-				owned_child_token[child_len] = '\0';
-				child_token = tcc_trim_inplace(owned_child_token);
-			}
-		}
-		if (!child_token || !tcc_typedesc_parse_token(child_token, false, &desc->as.list_like.child, error_buf)) {
-			if (owned_child_token) {
-				duckdb_free(owned_child_token);
-			}
-			tcc_typedesc_destroy(desc);
-			return false;
-		}
-		if (owned_child_token) {
-			duckdb_free(owned_child_token);
-		}
-	} else if (parsed == TCC_FFI_STRUCT) {
-		tcc_ffi_struct_meta_t meta;
-		idx_t i;
-		desc->kind = TCC_TYPEDESC_STRUCT;
-		memset(&meta, 0, sizeof(meta));
-		if (!tcc_parse_struct_meta_token(token, &meta, error_buf)) {
-			tcc_typedesc_destroy(desc);
-			return false;
-		}
-		if (meta.field_count > 0) {
-			desc->as.struct_like.fields =
-			    (tcc_typedesc_field_t *)duckdb_malloc(sizeof(tcc_typedesc_field_t) * (size_t)meta.field_count);
-			if (!desc->as.struct_like.fields) {
-				tcc_struct_meta_destroy(&meta);
-				tcc_typedesc_destroy(desc);
-				tcc_set_error(error_buf, "out of memory");
-				return false;
+	while (rows == 0) {
+		uint64_t before;
+		if (!local->active) {
+			uint64_t r = atomic_fetch_add_explicit(&init->next_range, 1, memory_order_relaxed);
+			if (r >= init->range_count) {
+				break;
 			}
-			memset(desc->as.struct_like.fields, 0, sizeof(tcc_typedesc_field_t) * (size_t)meta.field_count);
+			local->pos = init->starts[r];
+			local->end = r + 1 < init->range_count ? init->starts[r + 1] : init->file.size;
+			local->active = local->pos < local->end;
+			continue;
 		}
-		desc->as.struct_like.count = (idx_t)meta.field_count;
-		for (i = 0; i < (idx_t)meta.field_count; i++) {
-			desc->as.struct_like.fields[i].name = tcc_strdup(meta.field_names[i]);
-			if (!desc->as.struct_like.fields[i].name ||
-			    !tcc_typedesc_parse_token(meta.field_tokens[i], false, &desc->as.struct_like.fields[i].type, error_buf)) {
-				tcc_struct_meta_destroy(&meta);
-				tcc_typedesc_destroy(desc);
-				if (!error_buf || error_buf->message[0] == '\0') {
-					tcc_set_error(error_buf, "out of memory");
-				}
-				return false;
-			}
+		before = local->pos;
+		rows = reader->decode(init->file.data, &local->pos, local->end, columns, capacity);
+		if (rows < 0 || (uint64_t)rows > capacity || local->pos > local->end || (rows > 0 && local->pos == before)) {
+			duckdb_function_set_error(info, rows < 0 ? "file reader decoder reported malformed input"
+			                                         : "file reader decoder broke its contract");
+			return;
 		}
-		tcc_struct_meta_destroy(&meta);
-	} else if (parsed == TCC_FFI_MAP) {
-		tcc_ffi_map_meta_t meta;
-		desc->kind = TCC_TYPEDESC_MAP;
-		memset(&meta, 0, sizeof(meta));
-		if (!tcc_parse_map_meta_token(token, &meta, error_buf) ||
-		    !tcc_typedesc_parse_token(meta.key_token, false, &desc->as.map_like.key, error_buf) ||
-		    !tcc_typedesc_parse_token(meta.value_token, false, &desc->as.map_like.value, error_buf)) {
-			tcc_map_meta_destroy(&meta);
-			tcc_typedesc_destroy(desc);
-			return false;
+		if (rows == 0 || local->pos >= local->end) {
+			local->active = false;
 		}
-		tcc_map_meta_destroy(&meta);
-	} else if (parsed == TCC_FFI_UNION) {
-		tcc_ffi_union_meta_t meta;
-		idx_t i;
-		desc->kind = TCC_TYPEDESC_UNION;
-		memset(&meta, 0, sizeof(meta));
-		if (!tcc_parse_union_meta_token(token, &meta, error_buf)) {
-			tcc_typedesc_destroy(desc);
-			return false;
+	}
+	duckdb_data_chunk_set_size(output, (idx_t)rows);
+}
+
+/* tcc_read_replacement_scan: rewrites `FROM 'file.ext'` to `tcc_read('file.ext', 'ext')` when a reader is registered
+ * for the extension. */
+static void tcc_read_replacement_scan(duckdb_replacement_scan_info info, const char *table_name, void *data) {
+	tcc_module_state_t *state = (tcc_module_state_t *)data;
+	const char *extension = table_name ? strrchr(table_name, '.') : NULL;
+	duckdb_value value;
+	bool found;
+	if (!state || !extension || strchr(extension, '/') || strchr(extension, '\\')) {
+		return;
+	}
+	extension++;
+	tcc_rwlock_read_lock(&state->lock);
+	found = tcc_file_reader_find(state, extension) != (idx_t)-1;
+	tcc_rwlock_read_unlock(&state->lock);
+	if (!found) {
+		return;
+	}
+	duckdb_replacement_scan_set_function_name(info, "tcc_read");
+	value = duckdb_create_varchar(table_name);
+	duckdb_replacement_scan_add_parameter(info, value);
+	duckdb_destroy_value(&value);
+	value = duckdb_create_varchar(extension);
+	duckdb_replacement_scan_add_parameter(info, value);
+	duckdb_destroy_value(&value);
+}
+
+/* Registers `tcc_read(path, extension)` and the replacement scan routing registered extensions to it, with borrowed
+ * module state. */
+static bool register_tcc_read_function(duckdb_connection connection, duckdb_database database,
+                                       tcc_module_state_t *state) {
+	duckdb_table_function tf = duckdb_create_table_function();
+	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_state rc;
+	duckdb_table_function_set_name(tf, "tcc_read");
+	duckdb_table_function_add_parameter(tf, varchar_type);
+	duckdb_table_function_add_parameter(tf, varchar_type);
+	duckdb_table_function_set_extra_info(tf, state, NULL);
+	duckdb_table_function_set_bind(tf, tcc_read_bind);
+	duckdb_table_function_set_init(tf, tcc_read_init);
+	duckdb_table_function_set_local_init(tf, tcc_read_local_init);
+	duckdb_table_function_set_function(tf, tcc_read_function);
+	duckdb_table_function_supports_projection_pushdown(tf, false);
+	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_table_function(&tf);
+	if (rc == DuckDBSuccess && database) {
+		duckdb_add_replacement_scan(database, tcc_read_replacement_scan, state, NULL);
+	}
+	return rc == DuckDBSuccess;
+}
+
+/* ===== Section: Side-Effect Sinks (sink) ===== */
+/* Most arguments a sink takes; the per-chunk column tables live on the stack. */
+#define TCC_SINK_MAX_ARGS 64
+
+/* Sink callback: consumes one input chunk. `columns[i]` is argument i's data (a ducktinycc_blob_t view per row for
+ * varchar/blob), `validity[i]` its validity mask or NULL when every row is valid. */
+typedef void (*tcc_sink_fn_t)(void **columns, uint64_t **validity, uint64_t count);
+/* `<symbol>_flush`: runs when the aggregate finalizes, after every chunk of the query reached the sink. */
+typedef void (*tcc_sink_flush_fn_t)(void);
+
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+#ifdef _WIN32
+typedef SRWLOCK tcc_mutex_t;
+#else
+typedef pthread_mutex_t tcc_mutex_t;
+#endif
+
+/* tcc_mutex_init / _lock / _unlock / _destroy: thin wrappers so waiters sleep instead of spinning. */
+static void tcc_mutex_init(tcc_mutex_t *mutex) {
+#ifdef _WIN32
+	InitializeSRWLock(mutex);
+#else
+	pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+static void tcc_mutex_lock(tcc_mutex_t *mutex) {
+#ifdef _WIN32
+	AcquireSRWLockExclusive(mutex);
+#else
+	pthread_mutex_lock(mutex);
+#endif
+}
+
+static void tcc_mutex_unlock(tcc_mutex_t *mutex) {
+#ifdef _WIN32
+	ReleaseSRWLockExclusive(mutex);
+#else
+	pthread_mutex_unlock(mutex);
+#endif
+}
+
+static void tcc_mutex_destroy(tcc_mutex_t *mutex) {
+#ifdef _WIN32
+	(void)mutex;
+#else
+	pthread_mutex_destroy(mutex);
+#endif
+}
+#endif
+
+/* Compiled sink registered as an aggregate function; owned by that function as its extra info. */
+typedef struct {
+	tcc_sink_fn_t sink;
+	/* NULL when the source defines no `<symbol>_flush`. */
+	tcc_sink_flush_fn_t flush;
+	int arg_count;
+	tcc_ffi_type_t arg_types[TCC_SINK_MAX_ARGS];
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	/* Serializes sink/flush calls: DuckDB feeds chunks from several threads, the C code sees one at a time. Held
+	 * across the user's I/O, so waiters block rather than spin. */
+	tcc_mutex_t lock;
+	bool lock_ready;
+	/* Relocated code of sink/flush (one reference). */
+	tcc_registered_artifact_t *artifact;
+#endif
+} tcc_sink_t;
+
+/* Aggregate state: rows handed to the sink. */
+typedef struct {
+	uint64_t rows;
+} tcc_sink_state_t;
+
+/* tcc_sink_destroy: Destructor callback for the aggregate extra info. Allocation/Lifetime: drops the artifact
+ * reference and frees the sink. */
+static void tcc_sink_destroy(void *ptr) {
+	tcc_sink_t *sink = (tcc_sink_t *)ptr;
+	if (!sink) {
+		return;
+	}
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (sink->lock_ready) {
+		tcc_mutex_destroy(&sink->lock);
+	}
+	tcc_artifact_destroy(sink->artifact);
+#endif
+	duckdb_free(sink);
+}
+
+/* tcc_sink_arg_supported: sinks read DuckDB's flat vectors in place, so arguments are fixed-width columns, except
+ * varchar/blob which are decoded to ducktinycc_blob_t views per chunk. */
+static bool tcc_sink_arg_supported(tcc_ffi_type_t type) {
+	return tcc_reader_column_supported(type) || type == TCC_FFI_VARCHAR || type == TCC_FFI_BLOB;
+}
+
+static idx_t tcc_sink_state_size(duckdb_function_info info) {
+	(void)info;
+	return (idx_t)sizeof(tcc_sink_state_t);
+}
+
+static void tcc_sink_state_init(duckdb_function_info info, duckdb_aggregate_state state) {
+	(void)info;
+	((tcc_sink_state_t *)state)->rows = 0;
+}
+
+/* Update callback: hands the whole input chunk to the sink under its lock, then counts the rows. A sink is an
+ * ungrouped aggregate, so every row of a chunk must share one state; GROUP BY is rejected before the sink runs. */
+static void tcc_sink_update(duckdb_function_info info, duckdb_data_chunk input, duckdb_aggregate_state *states) {
+	tcc_sink_t *sink = (tcc_sink_t *)duckdb_aggregate_function_get_extra_info(info);
+	idx_t count = duckdb_data_chunk_get_size(input);
+	void *columns[TCC_SINK_MAX_ARGS];
+	uint64_t *validity[TCC_SINK_MAX_ARGS];
+	ducktinycc_blob_t *blobs = NULL;
+	ducktinycc_blob_t *next_blobs;
+	idx_t blob_columns = 0;
+	idx_t row;
+	int c;
+	if (count == 0) {
+		return;
+	}
+	for (row = 1; row < count; row++) {
+		if (states[row] != states[0]) {
+			duckdb_aggregate_function_set_error(info, "sink aggregates cannot be used with GROUP BY");
+			return;
 		}
-		if (meta.member_count > 0) {
-			desc->as.union_like.members =
-			    (tcc_typedesc_field_t *)duckdb_malloc(sizeof(tcc_typedesc_field_t) * (size_t)meta.member_count);
-			if (!desc->as.union_like.members) {
-				tcc_union_meta_destroy(&meta);
-				tcc_typedesc_destroy(desc);
-				tcc_set_error(error_buf, "out of memory");
-				return false;
-			}
-			memset(desc->as.union_like.members, 0, sizeof(tcc_typedesc_field_t) * (size_t)meta.member_count);
+	}
+	for (c = 0; c < sink->arg_count; c++) {
+		blob_columns += sink->arg_types[c] == TCC_FFI_VARCHAR || sink->arg_types[c] == TCC_FFI_BLOB;
+	}
+	if (blob_columns > 0) {
+		blobs = (ducktinycc_blob_t *)duckdb_malloc(sizeof(ducktinycc_blob_t) * (size_t)(blob_columns * count));
+		if (!blobs) {
+			duckdb_aggregate_function_set_error(info, "out of memory");
+			return;
 		}
-		desc->as.union_like.count = (idx_t)meta.member_count;
-		for (i = 0; i < (idx_t)meta.member_count; i++) {
-			const char *member_token = meta.member_tokens ? meta.member_tokens[i] : NULL;
-			desc->as.union_like.members[i].name = tcc_strdup(meta.member_names[i]);
-			if (!member_token || !desc->as.union_like.members[i].name ||
-			    !tcc_typedesc_parse_token(member_token, false, &desc->as.union_like.members[i].type, error_buf)) {
-				tcc_union_meta_destroy(&meta);
-				tcc_typedesc_destroy(desc);
-				if (!error_buf || error_buf->message[0] == '\0') {
-					tcc_set_error(error_buf, "out of memory");
+	}
+	next_blobs = blobs;
+	for (c = 0; c < sink->arg_count; c++) {
+		duckdb_vector vector = duckdb_data_chunk_get_vector(input, (idx_t)c);
+		columns[c] = duckdb_vector_get_data(vector);
+		validity[c] = duckdb_vector_get_validity(vector);
+		if (sink->arg_types[c] == TCC_FFI_VARCHAR || sink->arg_types[c] == TCC_FFI_BLOB) {
+			duckdb_string_t *strings = (duckdb_string_t *)columns[c];
+			for (row = 0; row < count; row++) {
+				if (!validity[c] || duckdb_validity_row_is_valid(validity[c], row)) {
+					next_blobs[row] = tcc_duckdb_string_to_blob(&strings[row]);
+				} else {
+					next_blobs[row].ptr = NULL;
+					next_blobs[row].len = 0;
 				}
-				return false;
 			}
+			columns[c] = next_blobs;
+			next_blobs += count;
 		}
-		tcc_union_meta_destroy(&meta);
-	} else {
-		desc->kind = TCC_TYPEDESC_PRIMITIVE;
 	}
-	*out_desc = desc;
-	return true;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_mutex_lock(&sink->lock);
+	sink->sink(columns, validity, (uint64_t)count);
+	tcc_mutex_unlock(&sink->lock);
+#endif
+	if (blobs) {
+		duckdb_free(blobs);
+	}
+	((tcc_sink_state_t *)states[0])->rows += (uint64_t)count;
 }
 
-/* tcc_parse_signature: Parser helper for signature, type, or helper-codegen grammar. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
-static bool tcc_parse_signature(const char *return_type, const char *arg_types_csv, tcc_ffi_type_t *out_return_type,
-		                                size_t *out_return_array_size, tcc_ffi_type_t **out_arg_types,
-		                                size_t **out_arg_array_sizes, tcc_ffi_struct_meta_t *out_return_struct_meta,
-		                                tcc_ffi_map_meta_t *out_return_map_meta,
-		                                tcc_ffi_union_meta_t *out_return_union_meta,
-		                                tcc_ffi_struct_meta_t **out_arg_struct_metas,
-		                                tcc_ffi_map_meta_t **out_arg_map_metas,
-		                                tcc_ffi_union_meta_t **out_arg_union_metas, int *out_arg_count,
-		                                tcc_error_buffer_t *error_buf) {
-	tcc_typedesc_t *return_desc = NULL;
-	tcc_typedesc_t *arg_desc = NULL;
-	tcc_string_list_t arg_tokens;
-	tcc_ffi_struct_meta_t return_struct_meta;
-	tcc_ffi_map_meta_t return_map_meta;
-	tcc_ffi_union_meta_t return_union_meta;
-	tcc_ffi_type_t *arg_types = NULL;
-	size_t *arg_array_sizes = NULL;
-	tcc_ffi_struct_meta_t *arg_struct_metas = NULL;
-	tcc_ffi_map_meta_t *arg_map_metas = NULL;
-	tcc_ffi_union_meta_t *arg_union_metas = NULL;
-	int argc = 0;
+static void tcc_sink_combine(duckdb_function_info info, duckdb_aggregate_state *source, duckdb_aggregate_state *target,
+                             idx_t count) {
 	idx_t i;
-	memset(&arg_tokens, 0, sizeof(arg_tokens));
-	memset(&return_struct_meta, 0, sizeof(return_struct_meta));
-	memset(&return_map_meta, 0, sizeof(return_map_meta));
-	memset(&return_union_meta, 0, sizeof(return_union_meta));
-	if (!return_type || return_type[0] == '\0' || !out_return_type || !out_return_array_size || !out_arg_types ||
-	    !out_arg_array_sizes || !out_return_struct_meta || !out_return_map_meta || !out_return_union_meta ||
-	    !out_arg_struct_metas || !out_arg_map_metas || !out_arg_union_metas || !out_arg_count) {
-		tcc_set_error(error_buf, "return_type is required");
-		return false;
+	(void)info;
+	for (i = 0; i < count; i++) {
+		((tcc_sink_state_t *)target[i])->rows += ((tcc_sink_state_t *)source[i])->rows;
 	}
-	if (!arg_types_csv) {
-		tcc_set_error(error_buf, "arg_types is required (use [] for no args)");
-		return false;
+}
+
+/* Finalize callback: an ungrouped aggregate finalizes its single state once per query, which is when
+ * `<symbol>_flush` runs; more than one state means grouped use and is rejected without flushing. */
+static void tcc_sink_finalize(duckdb_function_info info, duckdb_aggregate_state *source, duckdb_vector result,
+                              idx_t count, idx_t offset) {
+	tcc_sink_t *sink = (tcc_sink_t *)duckdb_aggregate_function_get_extra_info(info);
+	int64_t *out = (int64_t *)duckdb_vector_get_data(result);
+	if (count != 1) {
+		duckdb_aggregate_function_set_error(info, "sink aggregates cannot be used with GROUP BY");
+		return;
 	}
-	if (!tcc_typedesc_parse_token(return_type, true, &return_desc, error_buf)) {
-		tcc_set_error(error_buf, "return_type contains unsupported type token");
-		return false;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	if (sink->flush) {
+		tcc_mutex_lock(&sink->lock);
+		sink->flush();
+		tcc_mutex_unlock(&sink->lock);
 	}
-	if (return_desc->ffi_type == TCC_FFI_STRUCT &&
-	    !tcc_parse_struct_meta_token(return_desc->token, &return_struct_meta, error_buf)) {
-		goto fail;
+#endif
+	out[offset] = (int64_t)((tcc_sink_state_t *)source[0])->rows;
+}
+
+/**
+ * @function tcc_mode_sink
+ * @brief Handles `mode := 'sink'`: compiles a chunk-at-a-time side-effect callback and registers it as an aggregate.
+ * @param[in] state Module state whose connection receives the aggregate.
+ * @param[in] bind `sql_name` names the aggregate, `symbol` the sink callback, `arg_types` its columns.
+ * @param[in] runtime_path TinyCC runtime directory.
+ * @param[out] output One status row.
+ * @ownership borrows(state,bind), transfers(sink and its artifact to the registered aggregate)
+ * @thread_safety caller holds the module state write lock
+ * @note `SELECT sql_name(a, b, ...) FROM t` feeds every chunk of `t` to the sink and returns the row count; the
+ * optional `<symbol>_flush` runs once the query has consumed its input. The aggregate is ungrouped only (GROUP BY
+ * is an error), and the sink's C globals are shared by every query: concurrent queries interleave their chunks and
+ * each one's flush sees whatever the others have fed in so far.
+ */
+static void tcc_mode_sink(tcc_module_state_t *state, const tcc_module_bind_data_t *bind, const char *runtime_path,
+                          duckdb_data_chunk output) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	(void)state;
+	(void)runtime_path;
+	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
+	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, bind->symbol,
+	              NULL, "database");
+#else
+	tcc_sink_t *sink = NULL;
+	tcc_registered_artifact_t *artifact = NULL;
+	tcc_string_list_t arg_tokens;
+	tcc_error_buffer_t err;
+	duckdb_aggregate_function fn;
+	duckdb_logical_type type;
+	duckdb_state rc;
+	char flush_symbol[256];
+	char detail[sizeof(flush_symbol) + 64];
+	size_t array_size;
+	idx_t i;
+	memset(&arg_tokens, 0, sizeof(arg_tokens));
+	memset(&err, 0, sizeof(err));
+	if (!bind->sql_name || bind->sql_name[0] == '\0' || !bind->symbol || !tcc_is_identifier_token(bind->symbol) ||
+	    !bind->arg_types || bind->arg_types[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "sql_name, symbol and arg_types are required",
+		              NULL, bind->sql_name, bind->symbol, NULL, "database");
+		return;
 	}
-	if (return_desc->ffi_type == TCC_FFI_MAP &&
-	    !tcc_parse_map_meta_token(return_desc->token, &return_map_meta, error_buf)) {
-		goto fail;
+	if (!state->connection) {
+		tcc_write_row(output, false, bind->mode, "load", "E_NO_CONNECTION",
+		              "no persistent extension connection available", NULL, bind->sql_name, bind->symbol, NULL,
+		              "database");
+		return;
 	}
-	if (return_desc->ffi_type == TCC_FFI_UNION &&
-	    !tcc_parse_union_meta_token(return_desc->token, &return_union_meta, error_buf)) {
-		goto fail;
+	sink = (tcc_sink_t *)duckdb_malloc(sizeof(tcc_sink_t));
+	if (!sink) {
+		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED", "out of memory", NULL,
+		              bind->sql_name, bind->symbol, NULL, "database");
+		return;
 	}
-	if (!tcc_split_csv_tokens(arg_types_csv, &arg_tokens, error_buf)) {
+	memset(sink, 0, sizeof(tcc_sink_t));
+	tcc_mutex_init(&sink->lock);
+	sink->lock_ready = true;
+	if (!tcc_split_csv_tokens(bind->arg_types, &arg_tokens, &err) || arg_tokens.count == 0 ||
+	    arg_tokens.count > TCC_SINK_MAX_ARGS) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_SIGNATURE", "sink takes 1 to 64 arg_types",
+		              err.message[0] ? err.message : NULL, bind->sql_name, bind->symbol, NULL, "database");
 		goto fail;
 	}
-	argc = (int)arg_tokens.count;
-	if (argc > 0) {
-		arg_types = (tcc_ffi_type_t *)duckdb_malloc(sizeof(tcc_ffi_type_t) * (size_t)argc);
-		arg_array_sizes = (size_t *)duckdb_malloc(sizeof(size_t) * (size_t)argc);
-		arg_struct_metas = (tcc_ffi_struct_meta_t *)duckdb_malloc(sizeof(tcc_ffi_struct_meta_t) * (size_t)argc);
-		arg_map_metas = (tcc_ffi_map_meta_t *)duckdb_malloc(sizeof(tcc_ffi_map_meta_t) * (size_t)argc);
-		arg_union_metas = (tcc_ffi_union_meta_t *)duckdb_malloc(sizeof(tcc_ffi_union_meta_t) * (size_t)argc);
-		if (!arg_types || !arg_array_sizes || !arg_struct_metas || !arg_map_metas || !arg_union_metas) {
-			tcc_set_error(error_buf, "out of memory");
+	for (i = 0; i < arg_tokens.count; i++) {
+		if (!tcc_parse_type_token(arg_tokens.items[i], false, &sink->arg_types[i], &array_size) || array_size != 0 ||
+		    !tcc_sink_arg_supported(sink->arg_types[i])) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_SIGNATURE",
+			              "sink arguments must be fixed-width columns, varchar or blob", arg_tokens.items[i],
+			              bind->sql_name, bind->symbol, NULL, "database");
 			goto fail;
 		}
-		memset(arg_struct_metas, 0, sizeof(tcc_ffi_struct_meta_t) * (size_t)argc);
-		memset(arg_map_metas, 0, sizeof(tcc_ffi_map_meta_t) * (size_t)argc);
-		memset(arg_union_metas, 0, sizeof(tcc_ffi_union_meta_t) * (size_t)argc);
 	}
-	for (i = 0; i < (idx_t)argc; i++) {
-		if (!tcc_typedesc_parse_token(arg_tokens.items[i], false, &arg_desc, error_buf)) {
-			tcc_set_error(error_buf, "arg_types contains unsupported type token");
-			goto fail;
-		}
-		arg_types[i] = arg_desc->ffi_type;
-		arg_array_sizes[i] = arg_desc->array_size;
-		if (arg_types[i] == TCC_FFI_STRUCT && !tcc_parse_struct_meta_token(arg_desc->token, &arg_struct_metas[i], error_buf)) {
-			goto fail;
-		}
-		if (arg_types[i] == TCC_FFI_MAP && !tcc_parse_map_meta_token(arg_desc->token, &arg_map_metas[i], error_buf)) {
-			goto fail;
-		}
-		if (arg_types[i] == TCC_FFI_UNION && !tcc_parse_union_meta_token(arg_desc->token, &arg_union_metas[i], error_buf)) {
-			goto fail;
-		}
-		tcc_typedesc_destroy(arg_desc);
-		arg_desc = NULL;
+	sink->arg_count = (int)arg_tokens.count;
+	if (tcc_build_module_artifact(runtime_path, state, bind, bind->symbol, bind->sql_name, &artifact, &err, NULL) !=
+	    0) {
+		tcc_write_row(output, false, bind->mode, "compile", "E_COMPILE_FAILED", "compile failed",
+		              err.message[0] ? err.message : NULL, bind->sql_name, bind->symbol, NULL, "database");
+		goto fail;
 	}
-	*out_return_type = return_desc->ffi_type;
-	*out_return_array_size = return_desc->array_size;
-	*out_arg_types = arg_types;
-	*out_arg_array_sizes = arg_array_sizes;
-	*out_return_struct_meta = return_struct_meta;
-	*out_return_map_meta = return_map_meta;
-	*out_return_union_meta = return_union_meta;
-	*out_arg_struct_metas = arg_struct_metas;
-	*out_arg_map_metas = arg_map_metas;
-	*out_arg_union_metas = arg_union_metas;
-	*out_arg_count = argc;
+	sink->artifact = artifact;
+	/* module_init is typed for the generated init; re-fetch the callback as data and cast to its real type. */
+	sink->sink = (tcc_sink_fn_t)tcc_get_symbol(artifact->tcc, bind->symbol);
+	snprintf(flush_symbol, sizeof(flush_symbol), "%s_flush", bind->symbol);
+	sink->flush = (tcc_sink_flush_fn_t)tcc_get_symbol(artifact->tcc, flush_symbol);
+	snprintf(detail, sizeof(detail), "args=%d flush=%s", sink->arg_count, sink->flush ? flush_symbol : "(none)");
+
+	fn = duckdb_create_aggregate_function();
+	duckdb_aggregate_function_set_name(fn, bind->sql_name);
+	for (i = 0; i < arg_tokens.count; i++) {
+		type = tcc_ffi_type_create_logical_type(sink->arg_types[i], 0, NULL, NULL, NULL);
+		duckdb_aggregate_function_add_parameter(fn, type);
+		duckdb_destroy_logical_type(&type);
+	}
+	type = duckdb_create_logical_type(DUCKDB_TYPE_BIGINT);
+	duckdb_aggregate_function_set_return_type(fn, type);
+	duckdb_destroy_logical_type(&type);
+	duckdb_aggregate_function_set_functions(fn, tcc_sink_state_size, tcc_sink_state_init, tcc_sink_update,
+	                                        tcc_sink_combine, tcc_sink_finalize);
+	/* From here the function object owns the sink: destroying an unregistered function frees it. */
+	duckdb_aggregate_function_set_extra_info(fn, sink, tcc_sink_destroy);
+	sink = NULL;
+	rc = duckdb_register_aggregate_function(state->connection, fn);
+	duckdb_destroy_aggregate_function(&fn);
 	tcc_string_list_destroy(&arg_tokens);
-	tcc_typedesc_destroy(return_desc);
-	return true;
-fail:
-	if (arg_desc) {
-		tcc_typedesc_destroy(arg_desc);
+	if (rc != DuckDBSuccess) {
+		tcc_write_row(output, false, bind->mode, "load", "E_INIT_FAILED", "failed to register sink aggregate",
+		              NULL, bind->sql_name, bind->symbol, NULL, "database");
+		return;
 	}
-	tcc_typedesc_destroy(return_desc);
+	tcc_write_row(output, true, bind->mode, "load", "OK", "sink registered", detail, bind->sql_name, bind->symbol,
+	              NULL, "database");
+	return;
+
+fail:
 	tcc_string_list_destroy(&arg_tokens);
-	if (arg_types) {
-		duckdb_free(arg_types);
-	}
-	if (arg_array_sizes) {
-		duckdb_free(arg_array_sizes);
-	}
-	if (arg_struct_metas) {
-		tcc_struct_meta_array_destroy(arg_struct_metas, argc);
-	}
-	if (arg_map_metas) {
-		tcc_map_meta_array_destroy(arg_map_metas, argc);
-	}
-	if (arg_union_metas) {
-		tcc_union_meta_array_destroy(arg_union_metas, argc);
-	}
-	tcc_struct_meta_destroy(&return_struct_meta);
-	tcc_map_meta_destroy(&return_map_meta);
-	tcc_union_meta_destroy(&return_union_meta);
-	return false;
+	tcc_sink_destroy(sink);
+#endif
 }
 
-/* tcc_codegen_signature_ctx_init: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_codegen_signature_ctx_init(tcc_codegen_signature_ctx_t *ctx) {
-	if (!ctx) {
-		return;
+/* ===== Section: tcc_module Dispatcher ===== */
+/* Returns whether a mode mutates shared session/registry state. */
+static bool tcc_mode_requires_write_lock(const char *mode) {
+	if (!mode) {
+		return false;
 	}
-	memset(ctx, 0, sizeof(*ctx));
-	ctx->return_type = TCC_FFI_I64;
-	ctx->wrapper_mode = TCC_WRAPPER_MODE_ROW;
-	ctx->stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+	return strcmp(mode, "config_set") == 0 || strcmp(mode, "config_reset") == 0 ||
+	       strcmp(mode, "tcc_new_state") == 0 || strcmp(mode, "add_include") == 0 ||
+	       strcmp(mode, "add_sysinclude") == 0 || strcmp(mode, "add_library_path") == 0 ||
+	       strcmp(mode, "add_library") == 0 || strcmp(mode, "add_option") == 0 ||
+	       strcmp(mode, "add_header") == 0 || strcmp(mode, "add_source") == 0 || strcmp(mode, "add_file") == 0 ||
+	       strcmp(mode, "add_define") == 0 || strcmp(mode, "add_symbol") == 0 ||
+	       strcmp(mode, "tinycc_bind") == 0 ||
+	       strcmp(mode, "compile") == 0 || strcmp(mode, "quick_compile") == 0 || strcmp(mode, "fuse") == 0 ||
+	       strcmp(mode, "compile_expr") == 0 || strcmp(mode, "file_reader") == 0 ||
+	       strcmp(mode, "sink") == 0 ||
+	       strcmp(mode, "c_struct") == 0 || strcmp(mode, "c_union") == 0 || strcmp(mode, "c_bitfield") == 0 ||
+	       strcmp(mode, "c_enum") == 0;
 }
 
-/* tcc_codegen_signature_ctx_destroy: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
-static void tcc_codegen_signature_ctx_destroy(tcc_codegen_signature_ctx_t *ctx) {
-	if (!ctx) {
-		return;
-	}
-	if (ctx->arg_types) {
-		duckdb_free(ctx->arg_types);
-		ctx->arg_types = NULL;
-	}
-	if (ctx->arg_array_sizes) {
-		duckdb_free(ctx->arg_array_sizes);
-		ctx->arg_array_sizes = NULL;
-	}
-	if (ctx->arg_struct_metas) {
-		tcc_struct_meta_array_destroy(ctx->arg_struct_metas, ctx->arg_count);
-		ctx->arg_struct_metas = NULL;
+/* ===== Extracted mode handlers ===== */
+
+/* Handles add_include/add_sysinclude/add_library_path/add_library/add_option/add_header/add_source. */
+static void tcc_mode_add_staged(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                duckdb_data_chunk output) {
+	const char *mode = bind->mode;
+	tcc_string_list_t *target = NULL;
+	const char *value = NULL;
+	const char *label = NULL;
+	const char *arg_name = NULL;
+	if (strcmp(mode, "add_include") == 0) {
+		target = &state->session.include_paths;
+		value = bind->include_path;
+		label = "include path added";
+		arg_name = "include_path";
+	} else if (strcmp(mode, "add_sysinclude") == 0) {
+		target = &state->session.sysinclude_paths;
+		value = bind->sysinclude_path;
+		label = "sysinclude path added";
+		arg_name = "sysinclude_path";
+	} else if (strcmp(mode, "add_library_path") == 0) {
+		target = &state->session.library_paths;
+		value = bind->library_path;
+		label = "library path added";
+		arg_name = "library_path";
+	} else if (strcmp(mode, "add_library") == 0) {
+		target = &state->session.libraries;
+		value = bind->library;
+		label = "library added";
+		arg_name = "library";
+	} else if (strcmp(mode, "add_option") == 0) {
+		target = &state->session.options;
+		value = bind->option;
+		label = "compiler option added";
+		arg_name = "option";
+	} else if (strcmp(mode, "add_header") == 0) {
+		target = &state->session.headers;
+		value = bind->header;
+		label = "header source added";
+		arg_name = "header";
+	} else if (strcmp(mode, "add_source") == 0) {
+		target = &state->session.sources;
+		value = bind->source;
+		label = "source appended";
+		arg_name = "source";
 	}
-	if (ctx->arg_map_metas) {
-		tcc_map_meta_array_destroy(ctx->arg_map_metas, ctx->arg_count);
-		ctx->arg_map_metas = NULL;
+	if (!target) {
+		tcc_write_row(output, false, mode, "bind", "E_BAD_MODE", "unknown add mode", NULL, NULL, NULL, NULL,
+		              "database");
+		return;
 	}
-	if (ctx->arg_union_metas) {
-		tcc_union_meta_array_destroy(ctx->arg_union_metas, ctx->arg_count);
-		ctx->arg_union_metas = NULL;
+	if (value && tcc_string_list_append(target, value)) {
+		state->session.config_version++;
+		tcc_write_row(output, true, mode, "state", "OK", label, value, NULL, NULL, NULL, "database");
+	} else {
+		char msg[128];
+		snprintf(msg, sizeof(msg), "%s is required", arg_name);
+		tcc_write_row(output, false, mode, "bind", "E_MISSING_ARGS", msg, NULL, NULL, NULL, NULL, "database");
 	}
-	tcc_struct_meta_destroy(&ctx->return_struct_meta);
-	tcc_map_meta_destroy(&ctx->return_map_meta);
-	tcc_union_meta_destroy(&ctx->return_union_meta);
-	ctx->arg_count = 0;
-	ctx->return_type = TCC_FFI_I64;
-	ctx->return_array_size = 0;
-	ctx->wrapper_mode = TCC_WRAPPER_MODE_ROW;
-	ctx->wrapper_mode_token = NULL;
-	ctx->stability = TCC_FUNCTION_STABILITY_CONSISTENT;
-	ctx->stability_token = NULL;
 }
 
-/* tcc_codegen_signature_parse_types: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_codegen_signature_parse_types(const tcc_module_bind_data_t *bind, tcc_codegen_signature_ctx_t *ctx,
-                                              tcc_error_buffer_t *error_buf) {
-	if (!bind || !ctx) {
-		tcc_set_error(error_buf, "invalid codegen signature arguments");
-		return false;
+/* Handles add_file: stages a C file like add_source, keyed by path so re-adding an unchanged file changes nothing
+ * and a changed one replaces its staged copy. The file's directory joins the include paths for quoted includes. */
+static void tcc_mode_add_file(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                              duckdb_data_chunk output) {
+	tcc_session_t *session = &state->session;
+	tcc_session_file_t *file = NULL;
+	char *contents;
+	char dir[1024];
+	char detail[64];
+	uint64_t hash;
+	idx_t i;
+	if (!bind->source_file || bind->source_file[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "source_file is required", NULL, NULL,
+		              NULL, NULL, "database");
+		return;
 	}
-	return tcc_parse_signature(bind->return_type, bind->arg_types, &ctx->return_type, &ctx->return_array_size,
-	                           &ctx->arg_types, &ctx->arg_array_sizes, &ctx->return_struct_meta,
-	                           &ctx->return_map_meta, &ctx->return_union_meta, &ctx->arg_struct_metas,
-	                           &ctx->arg_map_metas, &ctx->arg_union_metas, &ctx->arg_count, error_buf);
-}
-
-/* tcc_codegen_signature_parse_wrapper_mode: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_codegen_signature_parse_wrapper_mode(const tcc_module_bind_data_t *bind,
-                                                     tcc_codegen_signature_ctx_t *ctx,
-                                                     tcc_error_buffer_t *error_buf) {
-	if (!bind || !ctx) {
-		tcc_set_error(error_buf, "invalid codegen wrapper_mode arguments");
-		return false;
+	contents = tcc_read_text_file(bind->source_file);
+	if (!contents) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_NOT_FOUND", "cannot read source_file", bind->source_file,
+		              NULL, NULL, NULL, "database");
+		return;
 	}
-	if (!tcc_parse_wrapper_mode(bind->wrapper_mode, &ctx->wrapper_mode, error_buf)) {
-		return false;
+	if (!tcc_source_file_dir(bind->source_file, dir, sizeof(dir)) ||
+	    !tcc_string_list_append_unique(&session->include_paths, dir)) {
+		duckdb_free(contents);
+		tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to stage source_file", NULL,
+		              NULL, NULL, NULL, "database");
+		return;
 	}
-	ctx->wrapper_mode_token = tcc_wrapper_mode_token(ctx->wrapper_mode);
-	if (!ctx->wrapper_mode_token) {
-		tcc_set_error(error_buf, "wrapper_mode contains unsupported token");
-		return false;
+	hash = tcc_source_file_hash(bind->source_file, contents, &session->include_paths, NULL);
+	snprintf(detail, sizeof(detail), "hash=%016llx", (unsigned long long)hash);
+	for (i = 0; i < session->file_count && !file; i++) {
+		if (strcmp(session->files[i].path, bind->source_file) == 0) {
+			file = &session->files[i];
+		}
 	}
-	return true;
-}
-
-/* tcc_codegen_source_ctx_init: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_codegen_source_ctx_init(tcc_codegen_source_ctx_t *ctx) {
-	if (!ctx) {
+	if (file && file->hash == hash) {
+		duckdb_free(contents);
+		tcc_write_row(output, true, bind->mode, "state", "OK", "source file unchanged", detail, NULL, NULL, NULL,
+		              "database");
 		return;
 	}
-	memset(ctx, 0, sizeof(*ctx));
-	tcc_codegen_signature_ctx_init(&ctx->signature);
-}
-
-/* tcc_codegen_source_ctx_destroy: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
-static void tcc_codegen_source_ctx_destroy(tcc_codegen_source_ctx_t *ctx) {
-	if (!ctx) {
+	if (file) {
+		duckdb_free(session->sources.items[file->source_index]);
+		session->sources.items[file->source_index] = contents;
+		file->hash = hash;
+		session->config_version++;
+		tcc_write_row(output, true, bind->mode, "state", "OK", "source file replaced", detail, NULL, NULL, NULL,
+		              "database");
 		return;
 	}
-	if (ctx->compilation_unit_source) {
-		duckdb_free(ctx->compilation_unit_source);
-		ctx->compilation_unit_source = NULL;
+	if (session->file_count == session->file_capacity) {
+		idx_t new_capacity = session->file_capacity == 0 ? 4 : session->file_capacity * 2;
+		tcc_session_file_t *grown =
+		    (tcc_session_file_t *)duckdb_malloc(sizeof(tcc_session_file_t) * (size_t)new_capacity);
+		if (grown && session->files) {
+			memcpy(grown, session->files, sizeof(tcc_session_file_t) * (size_t)session->file_count);
+			duckdb_free(session->files);
+		}
+		if (grown) {
+			session->files = grown;
+			session->file_capacity = new_capacity;
+		}
 	}
-	if (ctx->wrapper_loader_source) {
-		duckdb_free(ctx->wrapper_loader_source);
-		ctx->wrapper_loader_source = NULL;
+	file = session->file_count < session->file_capacity ? &session->files[session->file_count] : NULL;
+	if (!file || !(file->path = tcc_strdup(bind->source_file)) || !tcc_string_list_append(&session->sources, contents)) {
+		if (file && file->path) {
+			duckdb_free(file->path);
+		}
+		duckdb_free(contents);
+		tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to stage source_file", NULL,
+		              NULL, NULL, NULL, "database");
+		return;
 	}
-	tcc_codegen_signature_ctx_destroy(&ctx->signature);
-	memset(ctx->module_symbol, 0, sizeof(ctx->module_symbol));
+	duckdb_free(contents);
+	file->source_index = session->sources.count - 1;
+	file->hash = hash;
+	session->file_count++;
+	session->config_version++;
+	tcc_write_row(output, true, bind->mode, "state", "OK", "source file added", detail, NULL, NULL, NULL,
+	              "database");
 }
 
-/* tcc_codegen_prepare_sources: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_codegen_prepare_sources(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
-                                        const char *sql_name, const char *target_symbol,
-                                        tcc_codegen_source_ctx_t *ctx, tcc_error_buffer_t *error_buf) {
-	if (!state || !bind || !sql_name || !target_symbol || !ctx) {
-		tcc_set_error(error_buf, "invalid codegen source arguments");
-		return false;
-	}
-	if (!tcc_codegen_signature_parse_types(bind, &ctx->signature, error_buf)) {
-		return false;
+/* Handles c_struct/c_union/c_bitfield/c_enum modes. */
+static void tcc_mode_c_helpers(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                               const char *runtime_path, duckdb_data_chunk output) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
+	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, bind->symbol,
+	              NULL, "database");
+#else
+	const bool is_enum = strcmp(bind->mode, "c_enum") == 0;
+	const bool is_union = strcmp(bind->mode, "c_union") == 0;
+	const bool force_bitfield = strcmp(bind->mode, "c_bitfield") == 0;
+	const char *kind_keyword = is_union ? "union" : "struct";
+	const char *type_name = bind->symbol;
+	char prefix_buf[256];
+	const char *prefix = NULL;
+	tcc_error_buffer_t err;
+	tcc_c_field_list_t fields;
+	tcc_string_list_t enum_constants;
+	tcc_helper_binding_list_t helper_bindings;
+	char *helper_source = NULL;
+	char *combined_source = NULL;
+	idx_t i;
+	memset(&err, 0, sizeof(err));
+	memset(&fields, 0, sizeof(fields));
+	memset(&enum_constants, 0, sizeof(enum_constants));
+	memset(&helper_bindings, 0, sizeof(helper_bindings));
+
+	if (!type_name || !tcc_is_identifier_token(type_name)) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "symbol must be a valid C identifier",
+		              NULL, bind->sql_name, bind->symbol, NULL, "database");
+		goto done;
 	}
-	if (!tcc_codegen_signature_parse_wrapper_mode(bind, &ctx->signature, error_buf)) {
-		return false;
+	if (bind->sql_name && bind->sql_name[0] != '\0') {
+		prefix = bind->sql_name;
+	} else if (is_enum) {
+		int n = snprintf(prefix_buf, sizeof(prefix_buf), "enum_%s", type_name);
+		if (n < 0 || (size_t)n >= sizeof(prefix_buf)) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "failed to build helper prefix", NULL,
+			              bind->sql_name, bind->symbol, NULL, "database");
+			goto done;
+		}
+		prefix = prefix_buf;
+	} else {
+		int n = snprintf(prefix_buf, sizeof(prefix_buf), "%s_%s", is_union ? "union" : "struct", type_name);
+		if (n < 0 || (size_t)n >= sizeof(prefix_buf)) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "failed to build helper prefix", NULL,
+			              bind->sql_name, bind->symbol, NULL, "database");
+			goto done;
+		}
+		prefix = prefix_buf;
 	}
-	if (!tcc_parse_function_stability(tcc_effective_stability(state, bind), &ctx->signature.stability, error_buf)) {
-		return false;
+	if (!prefix || !tcc_is_identifier_token(prefix)) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
+		              "sql_name must be a valid C/SQL identifier when provided", NULL, bind->sql_name, bind->symbol,
+		              NULL, "database");
+		goto done;
 	}
-	ctx->signature.stability_token = tcc_function_stability_token(ctx->signature.stability);
-	if (!ctx->signature.stability_token) {
-		tcc_set_error(error_buf, "stability contains unsupported token");
-		return false;
+	if (is_enum) {
+		if (!tcc_parse_c_enum_constants(bind->arg_types, &enum_constants, &err)) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "invalid c_enum constants",
+			              err.message[0] ? err.message : NULL, prefix, type_name, NULL, "database");
+			goto done;
+		}
+		helper_source = tcc_generate_c_enum_helpers_source(type_name, prefix, &enum_constants, &err);
+		if (!helper_source) {
+			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
+			              "failed to generate enum helpers", err.message[0] ? err.message : NULL, prefix, type_name,
+			              NULL, "database");
+			goto done;
+		}
+		if (!tcc_build_c_enum_bindings(prefix, &enum_constants, &helper_bindings, &err)) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
+			              "failed to build enum helper signatures", err.message[0] ? err.message : NULL, prefix,
+			              type_name, NULL, "database");
+			goto done;
+		}
+	} else {
+		if (!tcc_parse_c_field_specs(bind->arg_types, force_bitfield, &fields, &err)) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "invalid c struct/union field specs",
+			              err.message[0] ? err.message : NULL, prefix, type_name, NULL, "database");
+			goto done;
+		}
+		helper_source = tcc_generate_c_composite_helpers_source(kind_keyword, type_name, prefix, &fields, &err);
+		if (!helper_source) {
+			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
+			              "failed to generate struct/union helpers", err.message[0] ? err.message : NULL, prefix,
+			              type_name, NULL, "database");
+			goto done;
+		}
+		if (!tcc_build_c_composite_bindings(prefix, &fields, &helper_bindings, &err)) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
+			              "failed to build struct/union helper signatures", err.message[0] ? err.message : NULL,
+			              prefix, type_name, NULL, "database");
+			goto done;
+		}
 	}
-	snprintf(ctx->module_symbol, sizeof(ctx->module_symbol), "__ducktinycc_ffi_init_%llu_%llu",
-	         (unsigned long long)state->session.state_id, (unsigned long long)state->session.config_version);
-	ctx->wrapper_loader_source =
-	    tcc_codegen_generate_wrapper_source(ctx->module_symbol, target_symbol, sql_name,
-	                                        bind->return_type ? bind->return_type : "i64",
-	                                        bind->arg_types ? bind->arg_types : "",
-	                                        ctx->signature.wrapper_mode_token, ctx->signature.wrapper_mode,
-	                                        ctx->signature.stability_token, ctx->signature.return_type,
-	                                        ctx->signature.arg_types, ctx->signature.arg_count,
-	                                        /* emit_extern_decl: only when user source is NOT bundled in the
-	                                         * compilation unit.  When user_source is present, the definition
-	                                         * already provides the prototype; emitting an extern with our
-	                                         * stdint.h-derived type (e.g. int64_t) would conflict with user
-	                                         * code that uses a raw primitive (e.g. long long) for the same
-	                                         * 64-bit type, because on LP64 Linux int64_t == long != long long. */
-	                                        !(bind->source && bind->source[0] != '\0'));
-	if (!ctx->wrapper_loader_source) {
-		tcc_set_error(error_buf, "failed to generate codegen wrapper");
-		return false;
+
+	if (bind->source && bind->source[0] != '\0') {
+		size_t n0 = strlen(bind->source);
+		size_t n1 = strlen(helper_source);
+		combined_source = (char *)duckdb_malloc(n0 + n1 + 3);
+		if (!combined_source) {
+			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
+			              "failed to allocate helper source buffer", NULL, prefix, type_name, NULL, "database");
+			goto done;
+		}
+		memcpy(combined_source, bind->source, n0);
+		combined_source[n0] = '\n';
+		memcpy(combined_source + n0 + 1, helper_source, n1);
+		combined_source[n0 + n1 + 1] = '\0';
+	} else {
+		combined_source = tcc_strdup(helper_source);
+		if (!combined_source) {
+			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
+			              "failed to allocate helper source buffer", NULL, prefix, type_name, NULL, "database");
+			goto done;
+		}
 	}
-	ctx->compilation_unit_source = tcc_codegen_build_compilation_unit(bind->source, ctx->wrapper_loader_source);
-	if (!ctx->compilation_unit_source) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+
+	for (i = 0; i < helper_bindings.count; i++) {
+		const tcc_helper_binding_t *entry = &helper_bindings.items[i];
+		memset(&err, 0, sizeof(err));
+		if (!tcc_compile_generated_binding(runtime_path, state, combined_source, entry, &err)) {
+			const char *phase = "compile";
+			const char *code = "E_COMPILE_FAILED";
+			const char *message = "generated helper compile failed";
+			tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+			tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+			              entry->sql_name, entry->symbol, NULL, "database");
+			goto done;
+		}
+	}
+	{
+		char detail[256];
+		snprintf(detail, sizeof(detail), "generated=%llu prefix=%.96s target=%.96s",
+		         (unsigned long long)helper_bindings.count, prefix, type_name);
+		tcc_write_row(output, true, bind->mode, "load", "OK", "generated and registered helper UDFs", detail,
+		              prefix, type_name, NULL, "database");
 	}
-	return true;
-}
 
-/* tcc_codegen_classify_error_message: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_codegen_classify_error_message(const char *error_message, const char **phase, const char **code,
-                                               const char **message) {
-	if (!error_message || !phase || !code || !message) {
-		return;
+done:
+	if (helper_source) {
+		duckdb_free(helper_source);
 	}
-	if (strstr(error_message, "wrapper_mode")) {
-		*phase = "bind";
-		*code = "E_BAD_WRAPPER_MODE";
-		*message = "invalid wrapper_mode";
-	} else if (strstr(error_message, "stability")) {
-		*phase = "bind";
-		*code = "E_BAD_STABILITY";
-		*message = "invalid stability";
-	} else if (strstr(error_message, "return_type") || strstr(error_message, "arg_types") ||
-	           strstr(error_message, "struct token") || strstr(error_message, "map token") ||
-	           strstr(error_message, "fixed-width scalar tokens only")) {
-		*phase = "bind";
-		*code = "E_BAD_SIGNATURE";
-		*message = "invalid return_type/arg_types";
-	} else if (strstr(error_message, "failed to generate codegen wrapper") || strstr(error_message, "out of memory")) {
-		*phase = "codegen";
-		*code = "E_CODEGEN_FAILED";
-		*message = "ffi codegen failed";
-	} else if (strstr(error_message, "no persistent extension connection")) {
-		*phase = "load";
-		*code = "E_NO_CONNECTION";
-		*message = "no persistent extension connection available";
-	} else if (strstr(error_message, "generated module init returned false")) {
-		*phase = "load";
-		*code = "E_INIT_FAILED";
-		*message = "generated module init returned false";
+	if (combined_source) {
+		duckdb_free(combined_source);
 	}
+	tcc_c_field_list_destroy(&fields);
+	tcc_string_list_destroy(&enum_constants);
+	tcc_helper_binding_list_destroy(&helper_bindings);
+#endif
 }
 
-/* Resolves target symbol from explicit args or session-level bound symbol. */
-static const char *tcc_effective_symbol(tcc_module_state_t *state, const tcc_module_bind_data_t *bind) {
-	if (bind->symbol && bind->symbol[0] != '\0') {
-		return bind->symbol;
+/* Handles codegen_preview mode. */
+static void tcc_mode_codegen_preview(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                     duckdb_data_chunk output) {
+	const char *target_symbol = tcc_effective_symbol(state, bind);
+	const char *sql_name = tcc_effective_sql_name(state, bind, target_symbol);
+	tcc_codegen_source_ctx_t source_ctx;
+	tcc_error_buffer_t err;
+	memset(&err, 0, sizeof(err));
+	tcc_codegen_source_ctx_init(&source_ctx);
+	if (!target_symbol || target_symbol[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
+		              "symbol is required (bind or argument)", NULL, sql_name, target_symbol, NULL, "database");
+		goto done;
 	}
-	if (state->session.bound_symbol && state->session.bound_symbol[0] != '\0') {
-		return state->session.bound_symbol;
+	if (!tcc_codegen_prepare_sources(state, bind, sql_name, target_symbol, &source_ctx, &err)) {
+		const char *phase = "codegen";
+		const char *code = "E_CODEGEN_FAILED";
+		const char *message = "ffi codegen failed";
+		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+		              sql_name, target_symbol, NULL, "database");
+		goto done;
 	}
-	return NULL;
+	tcc_write_row(output, true, bind->mode, "codegen", "OK", "generated codegen source",
+	              source_ctx.compilation_unit_source, sql_name, target_symbol, source_ctx.module_symbol,
+	              "database");
+done:
+	tcc_codegen_source_ctx_destroy(&source_ctx);
 }
 
-/* Resolves SQL function name from explicit args or session-level fallback. */
-static const char *tcc_effective_sql_name(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
-                                          const char *effective_symbol) {
-	if (bind->sql_name && bind->sql_name[0] != '\0') {
-		return bind->sql_name;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/* tcc_source_compile_hashes: signature hash (what DuckDB registered) and input hash (what the code is built
+ * from) of a `source_file` compile. Allocation/Lifetime: borrows all inputs. */
+static void tcc_source_compile_hashes(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                      const char *sql_name, const char *target_symbol, uint64_t *out_input,
+                                      uint64_t *out_signature) {
+	const char *signature_fields[] = {sql_name,          target_symbol,   bind->arg_types,  bind->return_type,
+	                                  bind->wrapper_mode, bind->stability, bind->isolation, bind->specialize,
+	                                  bind->type_params, bind->used};
+	const char *input_fields[] = {bind->include_path, bind->sysinclude_path, bind->library_path,
+	                              bind->library,      bind->option,          bind->header,
+	                              bind->define_name,  bind->define_value,    bind->import_from};
+	uint64_t signature = 14695981039346656037ULL;
+	uint64_t input;
+	tcc_string_list_t imports;
+	tcc_error_buffer_t err;
+	size_t f;
+	idx_t i;
+	for (f = 0; f < sizeof(signature_fields) / sizeof(signature_fields[0]); f++) {
+		signature = tcc_hash64_str(signature, signature_fields[f]);
 	}
-	if (state->session.bound_sql_name && state->session.bound_sql_name[0] != '\0') {
-		return state->session.bound_sql_name;
+	input = tcc_source_file_hash(bind->source_file, bind->source, &state->session.include_paths, bind->include_path);
+	input = tcc_session_hash_inputs(&state->session, input);
+	for (f = 0; f < sizeof(input_fields) / sizeof(input_fields[0]); f++) {
+		input = tcc_hash64_str(input, input_fields[f]);
 	}
-	return effective_symbol;
+	/* An imported module that was rebuilt moves its importers' hash, so they relink against the new code. */
+	memset(&imports, 0, sizeof(imports));
+	memset(&err, 0, sizeof(err));
+	if (bind->import_from && bind->import_from[0] != '\0' && tcc_split_csv_tokens(bind->import_from, &imports, &err)) {
+		for (i = 0; i < imports.count; i++) {
+			char *colon = strchr(imports.items[i], ':');
+			idx_t idx;
+			if (colon) {
+				*colon = '\0';
+			}
+			idx = tcc_registry_find_sql_name(state, imports.items[i]);
+			if (idx != (idx_t)-1) {
+				input = tcc_hash64(input, &state->entries[idx].input_hash, sizeof(uint64_t));
+			}
+		}
+	}
+	tcc_string_list_destroy(&imports);
+	*out_input = input;
+	*out_signature = signature;
 }
+#endif
 
-/* Resolves function stability from explicit args, session-level binding, or default. */
-static const char *tcc_effective_stability(tcc_module_state_t *state, const tcc_module_bind_data_t *bind) {
-	if (bind && bind->stability && bind->stability[0] != '\0') {
-		return bind->stability;
+/* Handles compile/quick_compile modes. */
+static void tcc_mode_compile(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                             const char *runtime_path, duckdb_data_chunk output) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
+	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, bind->symbol,
+	              NULL, "database");
+#else
+	const char *target_symbol = tcc_effective_symbol(state, bind);
+	const char *sql_name = tcc_effective_sql_name(state, bind, target_symbol);
+	char module_symbol[128];
+	tcc_error_buffer_t err;
+	tcc_registered_artifact_t *artifact = NULL;
+	char artifact_id[256];
+	char hash_detail[96];
+	const char *phase = "compile";
+	const char *code = "E_COMPILE_FAILED";
+	const char *message = "compile failed";
+	tcc_compile_timings_t timings;
+	tcc_module_bind_data_t file_bind;
+	char *file_source = NULL;
+	uint64_t input_hash = 0;
+	uint64_t signature_hash = 0;
+	idx_t existing;
+	uint64_t t_start = tcc_now_ns();
+	uint64_t t_register;
+	memset(&err, 0, sizeof(err));
+	memset(&timings, 0, sizeof(timings));
+
+	if (bind->source_file && bind->source_file[0] != '\0') {
+		if (bind->source && bind->source[0] != '\0') {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
+			              "source and source_file are mutually exclusive", NULL, sql_name, target_symbol, NULL,
+			              "connection");
+			return;
+		}
+		file_source = tcc_read_text_file(bind->source_file);
+		if (!file_source) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_NOT_FOUND", "cannot read source_file",
+			              bind->source_file, sql_name, target_symbol, NULL, "connection");
+			return;
+		}
+		file_bind = *bind;
+		file_bind.source = file_source;
+		bind = &file_bind;
 	}
-	if (state && state->session.bound_stability && state->session.bound_stability[0] != '\0') {
-		return state->session.bound_stability;
+	if (strcmp(bind->mode, "quick_compile") == 0 && (!bind->source || bind->source[0] == '\0')) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
+		              "source is required in quick_compile mode", NULL, sql_name, target_symbol, NULL,
+		              "connection");
+		goto done;
 	}
-	return "consistent";
-}
-
-static const char *tcc_ffi_type_to_token(tcc_ffi_type_t type) {
-	if (tcc_ffi_type_is_list(type)) {
-		return "list";
+	if (!target_symbol || target_symbol[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
+		              "symbol is required (bind or argument)", NULL, sql_name, target_symbol, NULL, "database");
+		goto done;
 	}
-	if (tcc_ffi_type_is_array(type)) {
-		return "array";
+	if (file_source) {
+		tcc_source_compile_hashes(state, bind, sql_name, target_symbol, &input_hash, &signature_hash);
+		snprintf(hash_detail, sizeof(hash_detail), "input_hash=%016llx", (unsigned long long)input_hash);
 	}
-	switch (type) {
-#define TCC_FFI_TOKEN_CASE(type_id, token_str, c_type_name, duckdb_type_id, width_bytes)                                   \
-	case type_id:                                                                                                          \
-		return token_str;
-		TCC_FFI_SCALAR_ROWS(TCC_FFI_TOKEN_CASE)
-#undef TCC_FFI_TOKEN_CASE
-	case TCC_FFI_PTR:
-		return "ptr";
-	case TCC_FFI_VARCHAR:
-		return "varchar";
-	case TCC_FFI_BLOB:
-		return "blob";
-	case TCC_FFI_STRUCT:
-		return "struct";
-	case TCC_FFI_MAP:
-		return "map";
-	case TCC_FFI_UNION:
-		return "union";
-	default:
-		return NULL;
+	existing = sql_name ? tcc_registry_find_sql_name(state, sql_name) : (idx_t)-1;
+	/* Reject duplicate SQL name: DuckDB's scalar-function registration behaviour
+	 * differs across platforms (Linux fails, macOS silently replaces).  Checking
+	 * our own registry first makes the "already registered" error consistent.
+	 * A module compiled from source_file is instead kept (same inputs) or rebuilt in place. */
+	if (existing != (idx_t)-1 && (!file_source || !state->entries[existing].from_file)) {
+		tcc_write_row(output, false, bind->mode, "load", "E_INIT_FAILED",
+		              "generated module init returned false",
+		              "sql_name already registered; use tcc_new_state to reset",
+		              sql_name, target_symbol, NULL, "database");
+		goto done;
+	}
+	if (existing != (idx_t)-1) {
+		tcc_registered_entry_t *entry = &state->entries[existing];
+		tcc_registered_artifact_t *owner = entry->artifact;
+		tcc_host_sig_ctx_t *udf = owner && owner->udf_stats_count == 1 ? owner->udf_stats[0]->ctx : NULL;
+		tcc_registered_artifact_t *chain;
+		uint64_t retained;
+		void *wrapper = NULL;
+		int rc;
+		snprintf(artifact_id, sizeof(artifact_id), "%s@ffi_state_%llu", sql_name,
+		         (unsigned long long)entry->state_id);
+		if (entry->signature_hash != signature_hash) {
+			tcc_write_row(output, false, bind->mode, "load", "E_BAD_SIGNATURE",
+			              "signature differs from the registered source_file module",
+			              "sql_name already registered; use tcc_new_state to reset", sql_name, target_symbol, NULL,
+			              "database");
+			goto done;
+		}
+		if (entry->input_hash == input_hash) {
+			timings.total_ns = tcc_now_ns() - t_start;
+			tcc_write_row(output, true, bind->mode, "load", "OK", "inputs unchanged; kept registered SQL function",
+			              hash_detail, sql_name, target_symbol, artifact_id, "database");
+			tcc_write_timings_col(output, &timings);
+			goto done;
+		}
+		if (!udf || udf->isolation || udf->specialize) {
+			tcc_write_row(output, false, bind->mode, "load", "E_BAD_ARGS", "module cannot be rebuilt in place",
+			              "isolated, specialized and generic modules need tcc_new_state to reset", sql_name,
+			              target_symbol, NULL, "database");
+			goto done;
+		}
+		/* Build without registering: module_init hands its wrapper to the capture slot. */
+		tcc_registering_capture = &wrapper;
+		rc = tcc_codegen_compile_and_load_module(runtime_path, state, bind, sql_name, target_symbol, &artifact,
+		                                         &err, module_symbol, sizeof(module_symbol), &timings);
+		tcc_registering_capture = NULL;
+		if (rc != 0 || !wrapper) {
+			if (rc == 0) {
+				tcc_artifact_destroy(artifact);
+				tcc_set_error(&err, "generated module init returned false");
+			}
+			tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+			timings.total_ns = tcc_now_ns() - t_start;
+			tcc_compile_stats_record(state, bind->mode, sql_name, code, false, &timings);
+			tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+			              sql_name, target_symbol, NULL, "database");
+			tcc_write_timings_col(output, &timings);
+			goto done;
+		}
+		artifact->superseded = owner->rebuilt;
+		owner->rebuilt = artifact;
+		atomic_store_explicit(&udf->rebuilt_wrapper, (uintptr_t)wrapper, memory_order_seq_cst);
+		if (atomic_load_explicit(&udf->rebuilt_readers, memory_order_seq_cst) == 0) {
+			/* No chunk is inside older rebuilt code, and every chunk starting from here reads the new wrapper. */
+			tcc_artifact_destroy(artifact->superseded);
+			artifact->superseded = NULL;
+		}
+		for (retained = 0, chain = artifact; chain; chain = chain->superseded) {
+			retained++;
+		}
+		snprintf(hash_detail + strlen(hash_detail), sizeof(hash_detail) - strlen(hash_detail), " retained=%llu",
+		         (unsigned long long)retained);
+		entry->input_hash = input_hash;
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, "OK", true, &timings);
+		tcc_write_row(output, true, bind->mode, "load", "OK", "inputs changed; rebuilt and swapped SQL function code",
+		              hash_detail, sql_name, target_symbol, artifact_id, "database");
+		tcc_write_timings_col(output, &timings);
+		goto done;
+	}
+	if (tcc_codegen_compile_and_load_module(runtime_path, state, bind, sql_name, target_symbol, &artifact, &err,
+	                                        module_symbol, sizeof(module_symbol), &timings) != 0) {
+		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, code, false, &timings);
+		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+		              sql_name, target_symbol, NULL, "database");
+		tcc_write_timings_col(output, &timings);
+		goto done;
+	}
+	t_register = tcc_now_ns();
+	if (!tcc_registry_store_metadata(state, sql_name, module_symbol, artifact->state_id, artifact)) {
+		tcc_artifact_destroy(artifact);
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, "E_STORE_FAILED", false, &timings);
+		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED",
+		              "failed to store ffi module artifact metadata", NULL, sql_name, target_symbol, NULL,
+		              "connection");
+		tcc_write_timings_col(output, &timings);
+		goto done;
 	}
+	if (file_source) {
+		tcc_registered_entry_t *entry = &state->entries[tcc_registry_find_sql_name(state, sql_name)];
+		entry->from_file = true;
+		entry->input_hash = input_hash;
+		entry->signature_hash = signature_hash;
+	}
+	timings.register_ns += tcc_now_ns() - t_register;
+	timings.total_ns = tcc_now_ns() - t_start;
+	tcc_compile_stats_record(state, bind->mode, sql_name, "OK", true, &timings);
+	snprintf(artifact_id, sizeof(artifact_id), "%s@ffi_state_%llu", sql_name,
+	         (unsigned long long)artifact->state_id);
+	tcc_write_row(output, true, bind->mode, "load", "OK", "compiled and registered SQL function via codegen",
+	              file_source ? hash_detail : runtime_path, sql_name, target_symbol, artifact_id, "database");
+	tcc_write_timings_col(output, &timings);
+done:
+	if (file_source) {
+		duckdb_free(file_source);
+	}
+#endif
 }
 
-static const char *tcc_ffi_type_to_c_type_name(tcc_ffi_type_t type) {
-	if (tcc_ffi_type_is_list(type)) {
-		return "ducktinycc_list_t";
+/* ===== Section: Kernel Fusion (fuse) ===== */
+/* tcc_fuse_is_c_identifier: Fuse helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_fuse_is_c_identifier(const char *name) {
+	const char *p;
+	if (!name || !(isalpha((unsigned char)name[0]) || name[0] == '_')) {
+		return false;
 	}
-	if (tcc_ffi_type_is_array(type)) {
-		return "ducktinycc_array_t";
+	for (p = name + 1; *p; p++) {
+		if (!(isalnum((unsigned char)*p) || *p == '_')) {
+			return false;
+		}
 	}
-	switch (type) {
-	case TCC_FFI_VOID:
-		return "void";
-#define TCC_FFI_CTYPE_CASE(type_id, token_str, c_type_name, duckdb_type_id, width_bytes)                                   \
-	case type_id:                                                                                                          \
-		return c_type_name;
-		TCC_FFI_SCALAR_ROWS(TCC_FFI_CTYPE_CASE)
-#undef TCC_FFI_CTYPE_CASE
-	case TCC_FFI_PTR:
-		return "void *";
-	case TCC_FFI_VARCHAR:
-		return "const char *";
-	case TCC_FFI_BLOB:
-		return "ducktinycc_blob_t";
-	case TCC_FFI_UUID:
-		return "ducktinycc_hugeint_t";
-	case TCC_FFI_DATE:
-		return "ducktinycc_date_t";
-	case TCC_FFI_TIME:
-		return "ducktinycc_time_t";
-	case TCC_FFI_TIMESTAMP:
-		return "ducktinycc_timestamp_t";
-	case TCC_FFI_INTERVAL:
-		return "ducktinycc_interval_t";
-	case TCC_FFI_DECIMAL:
-		return "ducktinycc_decimal_t";
-	case TCC_FFI_STRUCT:
-		return "ducktinycc_struct_t";
-	case TCC_FFI_MAP:
-		return "ducktinycc_map_t";
-	case TCC_FFI_UNION:
-		return "ducktinycc_union_t";
-	default:
-		return NULL;
+	return true;
+}
+
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+/**
+ * @function tcc_fuse_build_source
+ * @brief Builds the fused compilation unit: staged sources, user source and the composed entry point.
+ * @param[in] state Module state whose staged `add_source` sources are inlined.
+ * @param[in] bind Bind data carrying `source`, `arg_types` and `return_type`.
+ * @param[in] stages Stage symbols applied left to right.
+ * @param[in] entry_symbol Name of the generated entry point.
+ * @param[out] out Receives the compilation unit text.
+ * @param[out] error_buf Error buffer for signature and allocation failures.
+ * @return true on success.
+ * @ownership borrows(state, bind, stages, entry_symbol), transfers(out->data to caller)
+ * @heap allocates via tcc_text_buf_appendf; caller releases with tcc_text_buf_destroy.
+ * @note The first stage receives the UDF arguments, every later stage the previous result.
+ * Intermediate types are inferred with `__typeof__` and must be arithmetic: they live in
+ * C locals, so there is no NULL to propagate between stages and the fused function
+ * returns exactly what the unfused chain would.
+ */
+static bool tcc_fuse_build_source(const tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                  const tcc_string_list_t *stages, const char *entry_symbol, tcc_text_buf_t *out,
+                                  tcc_error_buffer_t *error_buf) {
+	tcc_codegen_signature_ctx_t sig;
+	tcc_text_buf_t args = {0};
+	const char *ret_c_type;
+	idx_t i;
+	int a;
+	bool ok = true;
+	tcc_codegen_signature_ctx_init(&sig);
+	if (!tcc_codegen_signature_parse_types(bind, &sig, error_buf)) {
+		tcc_codegen_signature_ctx_destroy(&sig);
+		return false;
+	}
+	ret_c_type = tcc_ffi_type_to_c_type_name(sig.return_type);
+	if (!ret_c_type || sig.return_type == TCC_FFI_VOID) {
+		tcc_set_error(error_buf, "return_type must be a non-void value type for fuse");
+		tcc_codegen_signature_ctx_destroy(&sig);
+		return false;
+	}
+	for (i = 0; i < state->session.sources.count && ok; i++) {
+		ok = tcc_text_buf_appendf(out, "%s\n", state->session.sources.items[i]);
+	}
+	if (ok && bind->source && bind->source[0] != '\0') {
+		ok = tcc_text_buf_appendf(out, "%s\n", bind->source);
+	}
+	for (a = 0; a < sig.arg_count && ok; a++) {
+		const char *arg_c_type = tcc_ffi_type_to_c_type_name(sig.arg_types[a]);
+		ok = arg_c_type && tcc_text_buf_appendf(&args, "%s%s a%d", a == 0 ? "" : ", ", arg_c_type, a);
+	}
+	ok = ok && tcc_text_buf_appendf(out, "%s %s(%s) {\n", ret_c_type, entry_symbol,
+	                                args.data ? args.data : "void");
+	for (i = 0; ok && i < stages->count; i++) {
+		const char *stage = stages->items[i];
+		tcc_text_buf_t call = {0};
+		if (i == 0) {
+			ok = tcc_text_buf_appendf(&call, "%s(", stage);
+			for (a = 0; a < sig.arg_count && ok; a++) {
+				ok = tcc_text_buf_appendf(&call, "%sa%d", a == 0 ? "" : ", ", a);
+			}
+			ok = ok && tcc_text_buf_appendf(&call, ")");
+		} else {
+			ok = tcc_text_buf_appendf(&call, "%s(t%llu)", stage, (unsigned long long)(i - 1));
+		}
+		if (ok && i + 1 == stages->count) {
+			ok = tcc_text_buf_appendf(out, "  return %s;\n", call.data);
+		} else if (ok) {
+			/* sizeof(t * 1) only compiles for arithmetic intermediates. */
+			ok = tcc_text_buf_appendf(out, "  __typeof__(%s) t%llu = %s;\n  (void)sizeof(t%llu * 1);\n", call.data,
+			                          (unsigned long long)i, call.data, (unsigned long long)i);
+		}
+		tcc_text_buf_destroy(&call);
+	}
+	ok = ok && tcc_text_buf_appendf(out, "}\n");
+	tcc_text_buf_destroy(&args);
+	tcc_codegen_signature_ctx_destroy(&sig);
+	if (!ok) {
+		tcc_set_error(error_buf, "out of memory");
 	}
+	return ok;
 }
-#undef TCC_FFI_SCALAR_ROWS
+#endif
 
-/* ===== Section: Wrapper/Helper Code Generation ===== */
+/**
+ * @function tcc_mode_fuse
+ * @brief Handles `mode := 'fuse'`: compiles a chain of stage functions into one registered UDF.
+ * @param[in,out] state Module state (write lock held by the dispatcher).
+ * @param[in] bind Bind data with `symbols`, `sql_name`, `arg_types`, `return_type`.
+ * @param[in] runtime_path Effective TinyCC runtime path.
+ * @param[out] output Result chunk (one row).
+ * @ownership borrows(state, bind, runtime_path), transfers(artifact to registry on success)
+ * @errors E_MISSING_ARGS, E_BAD_ARGS, E_BAD_SIGNATURE, E_COMPILE_FAILED, E_INIT_FAILED, E_STORE_FAILED
+ * @note Staged `add_source` sources are compiled inside the fused compilation unit (not as
+ * separate translation units) so every stage is declared where the entry point calls it.
+ * The staged list is left untouched for later compiles.
+ */
+static void tcc_mode_fuse(tcc_module_state_t *state, const tcc_module_bind_data_t *bind, const char *runtime_path,
+                          duckdb_data_chunk output) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
+	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, NULL, NULL,
+	              "database");
+#else
+	const char *sql_name = bind->sql_name;
+	tcc_string_list_t stages;
+	tcc_string_list_t staged_sources;
+	tcc_text_buf_t unit = {0};
+	tcc_module_bind_data_t fused_bind;
+	tcc_registered_artifact_t *artifact = NULL;
+	tcc_error_buffer_t err;
+	tcc_compile_timings_t timings;
+	char entry_symbol[128];
+	char module_symbol[128];
+	char artifact_id[256];
+	const char *phase = "compile";
+	const char *code = "E_COMPILE_FAILED";
+	const char *message = "compile failed";
+	uint64_t t_start = tcc_now_ns();
+	uint64_t t_register;
+	int rc;
+	idx_t i;
+	memset(&stages, 0, sizeof(stages));
+	memset(&err, 0, sizeof(err));
+	memset(&timings, 0, sizeof(timings));
 
-/* tcc_codegen_ret_null_check: Returns the C expression that tests whether a return value should be treated as NULL.
- * Returns NULL for VOID (special case) and for plain scalars (no null-check). */
-static const char *tcc_codegen_ret_null_check(tcc_ffi_type_t ret_type) {
-	if (ret_type == TCC_FFI_VOID) {
-		return NULL;
-	}
-	if (ret_type == TCC_FFI_VARCHAR) {
-		return "!result";
+	if (!sql_name || sql_name[0] == '\0' || !bind->symbols || bind->symbols[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "sql_name and symbols are required",
+		              NULL, sql_name, NULL, NULL, "database");
+		return;
 	}
-	if (ret_type == TCC_FFI_BLOB) {
-		return "result.len > 0 && !result.ptr";
+	if (!tcc_split_csv_tokens(bind->symbols, &stages, &err) || stages.count < 2) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "symbols must list at least two stages",
+		              err.message[0] ? err.message : NULL, sql_name, bind->symbols, NULL, "database");
+		tcc_string_list_destroy(&stages);
+		return;
 	}
-	if (ret_type == TCC_FFI_PTR) {
-		return "!result";
+	for (i = 0; i < stages.count; i++) {
+		if (!tcc_fuse_is_c_identifier(stages.items[i])) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "stage symbol is not a C identifier",
+			              stages.items[i], sql_name, bind->symbols, NULL, "database");
+			tcc_string_list_destroy(&stages);
+			return;
+		}
 	}
-	if (tcc_ffi_type_is_list(ret_type) || tcc_ffi_type_is_array(ret_type)) {
-		return "result.len > 0 && !result.ptr";
+	if (tcc_registry_find_sql_name(state, sql_name) != (idx_t)-1) {
+		tcc_write_row(output, false, bind->mode, "load", "E_INIT_FAILED", "generated module init returned false",
+		              "sql_name already registered; use tcc_new_state to reset", sql_name, bind->symbols, NULL,
+		              "database");
+		tcc_string_list_destroy(&stages);
+		return;
 	}
-	if (tcc_ffi_type_is_struct(ret_type)) {
-		return "!result.field_ptrs || result.field_count == 0";
+	snprintf(entry_symbol, sizeof(entry_symbol), "__ducktinycc_fused_%llu_%llu",
+	         (unsigned long long)state->session.state_id, (unsigned long long)state->session.config_version);
+	if (!tcc_fuse_build_source(state, bind, &stages, entry_symbol, &unit, &err)) {
+		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+		              sql_name, bind->symbols, NULL, "database");
+		tcc_text_buf_destroy(&unit);
+		tcc_string_list_destroy(&stages);
+		return;
 	}
-	if (tcc_ffi_type_is_map(ret_type)) {
-		return "result.len > 0 && (!result.key_ptr || !result.value_ptr)";
+	tcc_string_list_destroy(&stages);
+
+	fused_bind = *bind;
+	fused_bind.source = unit.data;
+	/* The staged sources are already part of the fused unit; hide them from
+	 * tcc_apply_session_to_state so they are not defined twice.  Safe under the
+	 * write lock held by the dispatcher. */
+	staged_sources = state->session.sources;
+	memset(&state->session.sources, 0, sizeof(state->session.sources));
+	rc = tcc_codegen_compile_and_load_module(runtime_path, state, &fused_bind, sql_name, entry_symbol, &artifact,
+	                                         &err, module_symbol, sizeof(module_symbol), &timings);
+	state->session.sources = staged_sources;
+	tcc_text_buf_destroy(&unit);
+	if (rc != 0) {
+		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, code, false, &timings);
+		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+		              sql_name, bind->symbols, NULL, "database");
+		tcc_write_timings_col(output, &timings);
+		return;
 	}
-	if (tcc_ffi_type_is_union(ret_type)) {
-		return "!result.tag_ptr || !result.member_ptrs || result.member_count == 0";
+	t_register = tcc_now_ns();
+	if (!tcc_registry_store_metadata(state, sql_name, module_symbol, artifact->state_id, artifact)) {
+		tcc_artifact_destroy(artifact);
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, "E_STORE_FAILED", false, &timings);
+		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED",
+		              "failed to store ffi module artifact metadata", NULL, sql_name, bind->symbols, NULL,
+		              "connection");
+		tcc_write_timings_col(output, &timings);
+		return;
 	}
-	/* Plain scalar: no null-check */
-	return NULL;
+	timings.register_ns += tcc_now_ns() - t_register;
+	timings.total_ns = tcc_now_ns() - t_start;
+	tcc_compile_stats_record(state, bind->mode, sql_name, "OK", true, &timings);
+	snprintf(artifact_id, sizeof(artifact_id), "%s@ffi_state_%llu", sql_name,
+	         (unsigned long long)artifact->state_id);
+	tcc_write_row(output, true, bind->mode, "load", "OK", "fused stages into one SQL function", entry_symbol,
+	              sql_name, bind->symbols, artifact_id, "database");
+	tcc_write_timings_col(output, &timings);
+#endif
 }
 
-static char *tcc_codegen_generate_wrapper_source(const char *module_symbol, const char *target_symbol,
-                                                 const char *sql_name, const char *return_type,
-                                                 const char *arg_types_csv, const char *wrapper_mode_token,
-                                                 tcc_wrapper_mode_t wrapper_mode, const char *stability_token,
-                                                 tcc_ffi_type_t ret_type, const tcc_ffi_type_t *arg_types,
-                                                 int arg_count, bool emit_extern_decl) {
-	tcc_text_buf_t args_decl = {0};
-	tcc_text_buf_t row_unpack_lines = {0};
-	tcc_text_buf_t row_call_args = {0};
-	tcc_text_buf_t batch_col_decls = {0};
-	tcc_text_buf_t batch_call_args = {0};
-	tcc_text_buf_t batch_null_checks = {0};
-	tcc_text_buf_t src = {0};
-	const char *ret_c_type = tcc_ffi_type_to_c_type_name(ret_type);
-	const char *resolved_wrapper_mode = wrapper_mode_token ? wrapper_mode_token : tcc_wrapper_mode_token(wrapper_mode);
-	char *wrapper_name = NULL;
-	char *out_src = NULL;
-	size_t wrapper_len;
-	int i;
-	bool ok = true;
-	if (!ret_c_type) {
-		return NULL;
+/* ===== Section: SQL Expression Compiler (compile_expr) ===== */
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+#define TCC_EXPR_MAX_DEPTH 128
+
+/* Lexer token classes for the compile_expr SQL subset. */
+typedef enum {
+	TCC_EXPR_TOK_END = 0,
+	TCC_EXPR_TOK_IDENT,
+	TCC_EXPR_TOK_QUOTED,
+	TCC_EXPR_TOK_INT,
+	TCC_EXPR_TOK_FLOAT,
+	TCC_EXPR_TOK_OP,
+	TCC_EXPR_TOK_BAD
+} tcc_expr_tok_t;
+
+/* Typed expression node kinds; CASE lowers to nested IF and COALESCE to binary COALESCE nodes. */
+typedef enum {
+	TCC_EXPR_NODE_COLUMN,
+	TCC_EXPR_NODE_LITERAL,
+	TCC_EXPR_NODE_NULL,
+	TCC_EXPR_NODE_NEG,
+	TCC_EXPR_NODE_ABS,
+	TCC_EXPR_NODE_NOT,
+	TCC_EXPR_NODE_ARITH,
+	TCC_EXPR_NODE_COMPARE,
+	TCC_EXPR_NODE_AND,
+	TCC_EXPR_NODE_OR,
+	TCC_EXPR_NODE_IS_NULL,
+	TCC_EXPR_NODE_IF,
+	TCC_EXPR_NODE_COALESCE,
+	TCC_EXPR_NODE_CAST
+} tcc_expr_node_kind_t;
+
+/* One typed node; kids index the parser pool (-1 when absent). */
+typedef struct {
+	tcc_expr_node_kind_t kind;
+	/* Result type; TCC_FFI_VOID for an untyped NULL. */
+	tcc_ffi_type_t type;
+	/* COMPARE: common operand type. */
+	tcc_ffi_type_t operand_type;
+	/* ARITH/COMPARE operator text; IS_NULL uses "!" for IS NOT NULL. */
+	char op[3];
+	/* 0 none, 1 integer literal, 2 decimal/float literal (both adapt to the other operand like DuckDB literals). */
+	int literal;
+	int64_t ival;
+	double fval;
+	int column;
+	int kids[3];
+} tcc_expr_node_t;
+
+/* Recursive-descent parser state; nodes are typed as they are built. */
+typedef struct {
+	const char *src;
+	size_t pos;
+	tcc_expr_tok_t tok;
+	size_t tok_start;
+	size_t tok_len;
+	tcc_expr_node_t *nodes;
+	int node_count;
+	int node_capacity;
+	const tcc_string_list_t *arg_names;
+	const tcc_ffi_type_t *arg_types;
+	int arg_count;
+	int depth;
+	tcc_error_buffer_t *err;
+} tcc_expr_parser_t;
+
+/* tcc_expr_type_is_int: compile_expr type helper. Allocation/Lifetime: none. */
+static bool tcc_expr_type_is_int(tcc_ffi_type_t type) {
+	return type == TCC_FFI_I8 || type == TCC_FFI_U8 || type == TCC_FFI_I16 || type == TCC_FFI_U16 ||
+	       type == TCC_FFI_I32 || type == TCC_FFI_U32 || type == TCC_FFI_I64 || type == TCC_FFI_U64;
+}
+
+/* tcc_expr_type_is_signed: compile_expr type helper. Allocation/Lifetime: none. */
+static bool tcc_expr_type_is_signed(tcc_ffi_type_t type) {
+	return type == TCC_FFI_I8 || type == TCC_FFI_I16 || type == TCC_FFI_I32 || type == TCC_FFI_I64;
+}
+
+/* tcc_expr_type_is_float: compile_expr type helper. Allocation/Lifetime: none. */
+static bool tcc_expr_type_is_float(tcc_ffi_type_t type) {
+	return type == TCC_FFI_F32 || type == TCC_FFI_F64;
+}
+
+/* tcc_expr_c_type: C type of a kernel local (BOOL and untyped NULL use int). Allocation/Lifetime: static string. */
+static const char *tcc_expr_c_type(tcc_ffi_type_t type) {
+	if (type == TCC_FFI_BOOL || type == TCC_FFI_VOID) {
+		return "int";
 	}
-	if (!module_symbol || !target_symbol || !sql_name || !return_type || !arg_types_csv || !resolved_wrapper_mode ||
-	    !stability_token || arg_count < 0) {
-		return NULL;
+	return tcc_ffi_type_to_c_type_name(type);
+}
+
+/* tcc_expr_int_limits: integer range as C literals plus int64 bounds for literal fitting. Allocation/Lifetime: static strings. */
+static void tcc_expr_int_limits(tcc_ffi_type_t type, const char **min_c, const char **max_c, int64_t *min_v,
+                                int64_t *max_v) {
+	switch (type) {
+	case TCC_FFI_I8:
+		*min_c = "-128LL", *max_c = "127LL", *min_v = -128, *max_v = 127;
+		break;
+	case TCC_FFI_U8:
+		*min_c = "0LL", *max_c = "255LL", *min_v = 0, *max_v = 255;
+		break;
+	case TCC_FFI_I16:
+		*min_c = "-32768LL", *max_c = "32767LL", *min_v = -32768, *max_v = 32767;
+		break;
+	case TCC_FFI_U16:
+		*min_c = "0LL", *max_c = "65535LL", *min_v = 0, *max_v = 65535;
+		break;
+	case TCC_FFI_I32:
+		*min_c = "(-2147483647LL - 1)", *max_c = "2147483647LL", *min_v = INT32_MIN, *max_v = INT32_MAX;
+		break;
+	case TCC_FFI_U32:
+		*min_c = "0LL", *max_c = "4294967295LL", *min_v = 0, *max_v = 4294967295LL;
+		break;
+	case TCC_FFI_I64:
+		*min_c = "(-9223372036854775807LL - 1)", *max_c = "9223372036854775807LL", *min_v = INT64_MIN,
+		*max_v = INT64_MAX;
+		break;
+	default:
+		/* u64: literals never exceed INT64_MAX, so that bound is enough for fitting. */
+		*min_c = "0ULL", *max_c = "18446744073709551615ULL", *min_v = 0, *max_v = INT64_MAX;
+		break;
 	}
-	wrapper_len = strlen("__ducktinycc_wrapper_") + strlen(module_symbol) + 1;
-	wrapper_name = (char *)duckdb_malloc(wrapper_len);
-	if (!wrapper_name) {
-		return NULL;
+}
+
+/* tcc_expr_int_width: byte width used by DuckDB's integer promotion. Allocation/Lifetime: none. */
+static size_t tcc_expr_int_width(tcc_ffi_type_t type) {
+	return tcc_ffi_type_size(type);
+}
+
+/* tcc_expr_fail: records a parse/type error with the current source offset. Allocation/Lifetime: writes p->err. */
+static int tcc_expr_fail(tcc_expr_parser_t *p, const char *message) {
+	if (p->err->message[0] == '\0') {
+		snprintf(p->err->message, sizeof(p->err->message), "%s at offset %llu", message,
+		         (unsigned long long)p->tok_start);
 	}
-	snprintf(wrapper_name, wrapper_len, "__ducktinycc_wrapper_%s", module_symbol);
-	for (i = 0; i < arg_count; i++) {
-		const char *arg_c_type = tcc_ffi_type_to_c_type_name(arg_types[i]);
-		if (!arg_c_type) {
-			ok = false;
-			break;
-		}
-		if (!tcc_text_buf_appendf(&args_decl, "%s%s a%d", i == 0 ? "" : ", ", arg_c_type, i)) {
-			ok = false;
-			break;
-		}
-		if (arg_types[i] == TCC_FFI_PTR) {
-			if (!tcc_text_buf_appendf(&row_unpack_lines,
-			                          "  void *a%d = (void *)(uintptr_t)(*(unsigned long long *)args[%d]);\n", i, i) ||
-			    !tcc_text_buf_appendf(&row_call_args, "%sa%d", i == 0 ? "" : ", ", i) ||
-			    !tcc_text_buf_appendf(&batch_col_decls, "  unsigned long long *col%d_ptr = (unsigned long long *)arg_data[%d];\n",
-			                          i, i) ||
-			    !tcc_text_buf_appendf(&batch_call_args, "%s(void *)(uintptr_t)col%d_ptr[row]", i == 0 ? "" : ", ", i) ||
-			    !tcc_text_buf_appendf(
-			        &batch_null_checks,
-			        "%s(arg_validity[%d] && ((arg_validity[%d][row >> 6] & (1ULL << (row & 63))) == 0))",
-			        i == 0 ? "" : " || ", i, i)) {
-				ok = false;
-				break;
-			}
-		} else {
-			if (!tcc_text_buf_appendf(&row_unpack_lines, "  %s a%d = *(%s *)args[%d];\n", arg_c_type, i, arg_c_type, i) ||
-			    !tcc_text_buf_appendf(&row_call_args, "%sa%d", i == 0 ? "" : ", ", i) ||
-			    !tcc_text_buf_appendf(&batch_col_decls, "  %s *col%d = (%s *)arg_data[%d];\n", arg_c_type, i, arg_c_type,
-			                          i) ||
-			    !tcc_text_buf_appendf(&batch_call_args, "%scol%d[row]", i == 0 ? "" : ", ", i) ||
-			    !tcc_text_buf_appendf(
-			        &batch_null_checks,
-			        "%s(arg_validity[%d] && ((arg_validity[%d][row >> 6] & (1ULL << (row & 63))) == 0))",
-			        i == 0 ? "" : " || ", i, i)) {
-				ok = false;
-				break;
+	return -1;
+}
+
+/* tcc_expr_next: advances the lexer by one token. Allocation/Lifetime: borrows p->src. */
+static void tcc_expr_next(tcc_expr_parser_t *p) {
+	static const char *const ops[] = {"::", "//", "<>", "!=", "<=", ">=", "==", "+", "-",
+	                                  "*",  "/",  "%",  "<",  ">",  "=",  "(",  ")", ","};
+	const char *s = p->src;
+	size_t i = p->pos;
+	size_t k;
+	while (s[i] && isspace((unsigned char)s[i])) {
+		i++;
+	}
+	p->tok_start = i;
+	if (!s[i]) {
+		p->tok = TCC_EXPR_TOK_END;
+	} else if (isalpha((unsigned char)s[i]) || s[i] == '_') {
+		while (isalnum((unsigned char)s[i]) || s[i] == '_') {
+			i++;
+		}
+		p->tok = TCC_EXPR_TOK_IDENT;
+	} else if (s[i] == '"') {
+		i++;
+		while (s[i] && s[i] != '"') {
+			i++;
+		}
+		p->tok = s[i] == '"' ? TCC_EXPR_TOK_QUOTED : TCC_EXPR_TOK_BAD;
+		if (s[i]) {
+			i++;
+		}
+	} else if (isdigit((unsigned char)s[i]) || (s[i] == '.' && isdigit((unsigned char)s[i + 1]))) {
+		bool is_float = false;
+		while (isdigit((unsigned char)s[i])) {
+			i++;
+		}
+		if (s[i] == '.') {
+			is_float = true;
+			i++;
+			while (isdigit((unsigned char)s[i])) {
+				i++;
 			}
 		}
-	}
-	if (ok && arg_count == 0) {
-		ok = tcc_text_buf_appendf(&args_decl, "void");
-	}
-	if (ok && wrapper_mode == TCC_WRAPPER_MODE_ROW) {
-		ok = tcc_text_buf_appendf(
-		    &src,
-		    "#include <stdint.h>\n"
-		    "typedef struct _duckdb_connection *duckdb_connection;\n"
-		    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
-		    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
-		/* Emit an extern forward declaration of the user function only when the user source
-		 * is NOT bundled in the same compilation unit (i.e. the function is defined via a
-		 * separate session source or symbol injection).  When user source IS present in the
-		 * compilation unit it already provides the prototype; emitting an extern with our
-		 * stdint.h-derived type (e.g. int64_t) would conflict if the user wrote a raw
-		 * primitive (e.g. long long) — which on LP64 Linux resolves to a different type. */
-		if (ok && emit_extern_decl) {
-			ok = tcc_text_buf_appendf(&src, "extern %s %s(%s);\n",
-			                          ret_c_type, target_symbol,
-			                          args_decl.data ? args_decl.data : "");
-		}
-		if (ok) {
-			ok = tcc_text_buf_appendf(
-			    &src,
-			    "static _Bool %s(void **args, void *out_value, _Bool *out_is_null) {\n%s",
-			    wrapper_name,
-			    row_unpack_lines.data ? row_unpack_lines.data : "");
-		}
-		if (ok && ret_type == TCC_FFI_VOID) {
-			ok = tcc_text_buf_appendf(&src,
-			                          "  %s(%s);\n"
-			                          "  if (out_is_null) { *out_is_null = 1; }\n"
-			                          "  (void)out_value;\n"
-			                          "  return 1;\n"
-			                          "}\n",
-			                          target_symbol, row_call_args.data ? row_call_args.data : "");
-		} else if (ok && ret_type == TCC_FFI_PTR) {
-			const char *nc = tcc_codegen_ret_null_check(ret_type);
-			ok = tcc_text_buf_appendf(&src,
-			                          "  void *result = (void *)%s(%s);\n"
-			                          "  if (%s) {\n"
-			                          "    if (out_is_null) { *out_is_null = 1; }\n"
-			                          "    return 1;\n"
-			                          "  }\n"
-			                          "  *(unsigned long long *)out_value = (unsigned long long)(uintptr_t)result;\n"
-			                          "  if (out_is_null) { *out_is_null = 0; }\n"
-			                          "  return 1;\n"
-			                          "}\n",
-			                          target_symbol, row_call_args.data ? row_call_args.data : "", nc);
-		} else if (ok) {
-			const char *nc = tcc_codegen_ret_null_check(ret_type);
-			ok = tcc_text_buf_appendf(&src, "  %s result = %s(%s);\n",
-			                          ret_c_type, target_symbol, row_call_args.data ? row_call_args.data : "");
-			if (ok && nc) {
-				ok = tcc_text_buf_appendf(&src,
-				                          "  if (%s) {\n"
-				                          "    if (out_is_null) { *out_is_null = 1; }\n"
-				                          "    return 1;\n"
-				                          "  }\n", nc);
+		if (s[i] == 'e' || s[i] == 'E') {
+			size_t j = i + 1;
+			if (s[j] == '+' || s[j] == '-') {
+				j++;
 			}
-			if (ok) {
-				ok = tcc_text_buf_appendf(&src,
-				                          "  *(%s *)out_value = result;\n"
-				                          "  if (out_is_null) { *out_is_null = 0; }\n"
-				                          "  return 1;\n"
-				                          "}\n", ret_c_type);
+			if (isdigit((unsigned char)s[j])) {
+				is_float = true;
+				i = j;
+				while (isdigit((unsigned char)s[i])) {
+					i++;
+				}
 			}
 		}
-	} else if (ok && wrapper_mode == TCC_WRAPPER_MODE_BATCH) {
-		ok = tcc_text_buf_appendf(
-		    &src,
-		    "#include <stdint.h>\n"
-		    "typedef struct _duckdb_connection *duckdb_connection;\n"
-		    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
-		    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n");
-		if (ok && emit_extern_decl) {
-			ok = tcc_text_buf_appendf(&src, "extern %s %s(%s);\n",
-			                          ret_c_type, target_symbol,
-			                          args_decl.data ? args_decl.data : "");
-		}
-		if (ok) {
-			ok = tcc_text_buf_appendf(
-			    &src,
-			    "static _Bool %s(void **arg_data, uint64_t **arg_validity, uint64_t count, void *out_data, uint64_t "
-			    "*out_validity) {\n%s",
-			    wrapper_name,
-			    batch_col_decls.data ? batch_col_decls.data : "");
+		p->tok = is_float ? TCC_EXPR_TOK_FLOAT : TCC_EXPR_TOK_INT;
+	} else {
+		p->tok = TCC_EXPR_TOK_BAD;
+		for (k = 0; k < sizeof(ops) / sizeof(ops[0]); k++) {
+			size_t len = strlen(ops[k]);
+			if (strncmp(s + i, ops[k], len) == 0) {
+				p->tok = TCC_EXPR_TOK_OP;
+				i += len;
+				break;
+			}
 		}
-		if (ok && ret_type == TCC_FFI_VOID) {
-			ok = tcc_text_buf_appendf(&src, "  (void)out_data;\n");
-		} else if (ok && ret_type == TCC_FFI_PTR) {
-			ok = tcc_text_buf_appendf(&src, "  unsigned long long *out = (unsigned long long *)out_data;\n");
-		} else if (ok) {
-			ok = tcc_text_buf_appendf(&src, "  %s *out = (%s *)out_data;\n", ret_c_type, ret_c_type);
+		if (p->tok == TCC_EXPR_TOK_BAD) {
+			i++;
 		}
-		if (ok) {
-			ok = tcc_text_buf_appendf(&src, "  for (uint64_t row = 0; row < count; row++) {\n");
+	}
+	p->tok_len = i - p->tok_start;
+	p->pos = i;
+}
+
+/* tcc_expr_is_op: current token is the given operator. Allocation/Lifetime: none. */
+static bool tcc_expr_is_op(const tcc_expr_parser_t *p, const char *op) {
+	return p->tok == TCC_EXPR_TOK_OP && p->tok_len == strlen(op) && strncmp(p->src + p->tok_start, op, p->tok_len) == 0;
+}
+
+/* tcc_expr_is_kw: current token is the given keyword (case-insensitive). Allocation/Lifetime: none. */
+static bool tcc_expr_is_kw(const tcc_expr_parser_t *p, const char *kw) {
+	size_t i;
+	if (p->tok != TCC_EXPR_TOK_IDENT || p->tok_len != strlen(kw)) {
+		return false;
+	}
+	for (i = 0; i < p->tok_len; i++) {
+		if (toupper((unsigned char)p->src[p->tok_start + i]) != kw[i]) {
+			return false;
 		}
-		if (ok && arg_count > 0) {
-			ok = tcc_text_buf_appendf(&src,
-			                          "    if (%s) {\n"
-			                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
-			                          "      continue;\n"
-			                          "    }\n",
-			                          batch_null_checks.data ? batch_null_checks.data : "");
+	}
+	return true;
+}
+
+/* tcc_expr_expect_op: consumes an operator or fails. Allocation/Lifetime: none. */
+static bool tcc_expr_expect_op(tcc_expr_parser_t *p, const char *op, const char *message) {
+	if (!tcc_expr_is_op(p, op)) {
+		tcc_expr_fail(p, message);
+		return false;
+	}
+	tcc_expr_next(p);
+	return true;
+}
+
+/* tcc_expr_expect_kw: consumes a keyword or fails. Allocation/Lifetime: none. */
+static bool tcc_expr_expect_kw(tcc_expr_parser_t *p, const char *kw, const char *message) {
+	if (!tcc_expr_is_kw(p, kw)) {
+		tcc_expr_fail(p, message);
+		return false;
+	}
+	tcc_expr_next(p);
+	return true;
+}
+
+/* tcc_expr_new_node: appends a node to the pool. Allocation/Lifetime: grows p->nodes (duckdb_malloc); freed by the caller of the parse. */
+static int tcc_expr_new_node(tcc_expr_parser_t *p, tcc_expr_node_kind_t kind, tcc_ffi_type_t type) {
+	tcc_expr_node_t *node;
+	if (p->node_count == p->node_capacity) {
+		int new_capacity = p->node_capacity == 0 ? 32 : p->node_capacity * 2;
+		tcc_expr_node_t *grown = (tcc_expr_node_t *)duckdb_malloc(sizeof(tcc_expr_node_t) * (size_t)new_capacity);
+		if (!grown) {
+			tcc_set_error(p->err, "out of memory");
+			return -1;
 		}
-		if (ok && ret_type == TCC_FFI_VOID) {
-			ok = tcc_text_buf_appendf(&src,
-			                          "    %s(%s);\n"
-			                          "    if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n",
-			                          target_symbol, batch_call_args.data ? batch_call_args.data : "");
-		} else if (ok && ret_type == TCC_FFI_PTR) {
-			const char *nc = tcc_codegen_ret_null_check(ret_type);
-			ok = tcc_text_buf_appendf(&src,
-			                          "    void *result = (void *)%s(%s);\n"
-			                          "    if (%s) {\n"
-			                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
-			                          "      continue;\n"
-			                          "    }\n"
-			                          "    out[row] = (unsigned long long)(uintptr_t)result;\n",
-			                          target_symbol, batch_call_args.data ? batch_call_args.data : "", nc);
-		} else if (ok) {
-			const char *nc = tcc_codegen_ret_null_check(ret_type);
-			if (nc) {
-				ok = tcc_text_buf_appendf(&src,
-				                          "    %s result = %s(%s);\n"
-				                          "    if (%s) {\n"
-				                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
-				                          "      continue;\n"
-				                          "    }\n"
-				                          "    out[row] = result;\n",
-				                          ret_c_type, target_symbol,
-				                          batch_call_args.data ? batch_call_args.data : "", nc);
-			} else {
-				ok = tcc_text_buf_appendf(&src, "    out[row] = %s(%s);\n", target_symbol,
-				                          batch_call_args.data ? batch_call_args.data : "");
-			}
+		if (p->nodes) {
+			memcpy(grown, p->nodes, sizeof(tcc_expr_node_t) * (size_t)p->node_count);
+			duckdb_free(p->nodes);
 		}
-		if (ok) {
-			ok = tcc_text_buf_appendf(&src,
-			                          "  }\n"
-			                          "  return 1;\n"
-			                          "}\n");
+		p->nodes = grown;
+		p->node_capacity = new_capacity;
+	}
+	node = &p->nodes[p->node_count];
+	memset(node, 0, sizeof(*node));
+	node->kind = kind;
+	node->type = type;
+	node->column = -1;
+	node->kids[0] = node->kids[1] = node->kids[2] = -1;
+	return p->node_count++;
+}
+
+/* tcc_expr_literal_fits: whether an integer literal can take the given integer type. Allocation/Lifetime: none. */
+static bool tcc_expr_literal_fits(int64_t value, tcc_ffi_type_t type) {
+	const char *min_c;
+	const char *max_c;
+	int64_t min_v;
+	int64_t max_v;
+	tcc_expr_int_limits(type, &min_c, &max_c, &min_v, &max_v);
+	return value >= min_v && value <= max_v;
+}
+
+/**
+ * @function tcc_expr_common_type
+ * @brief DuckDB's implicit max type for two operands of the supported numeric/bool subset.
+ * @param[in] p Parser (for error reporting).
+ * @param[in] a Left node index.
+ * @param[in] b Right node index.
+ * @param[out] out Common type; TCC_FFI_VOID when both sides are untyped NULL.
+ * @return true on success; false (with p->err set) when the pair needs HUGEINT or mixes BOOLEAN with numbers.
+ * @note Integer literals take the other side's integer type when they fit and decimal literals
+ * take FLOAT next to FLOAT, mirroring DuckDB's INTEGER_LITERAL handling. Signed/unsigned pairs
+ * promote to the signed side when it is wider and to BIGINT otherwise.
+ */
+static bool tcc_expr_common_type(tcc_expr_parser_t *p, int a, int b, tcc_ffi_type_t *out) {
+	const tcc_expr_node_t *na = &p->nodes[a];
+	const tcc_expr_node_t *nb = &p->nodes[b];
+	tcc_ffi_type_t ta = na->type;
+	tcc_ffi_type_t tb = nb->type;
+	if (ta == TCC_FFI_VOID || tb == TCC_FFI_VOID) {
+		*out = ta == TCC_FFI_VOID ? tb : ta;
+		return true;
+	}
+	if (ta == TCC_FFI_BOOL || tb == TCC_FFI_BOOL) {
+		if (ta != tb) {
+			tcc_expr_fail(p, "cannot combine BOOLEAN with a numeric value");
+			return false;
 		}
-	} else {
-		ok = false;
+		*out = TCC_FFI_BOOL;
+		return true;
 	}
-	if (ok) {
-		ok = tcc_text_buf_appendf(&src,
-		                          "_Bool %s(duckdb_connection con) {\n"
-		                          "  return ducktinycc_register_signature(con, \"%s\", (void *)%s, \"%s\", \"%s\", "
-		                          "\"%s\", \"%s\");\n"
-		                          "}\n",
-		                          module_symbol, sql_name, wrapper_name, return_type, arg_types_csv,
-		                          resolved_wrapper_mode, stability_token);
+	if (na->literal == 1 && nb->literal == 0 && tcc_expr_type_is_int(tb) && tcc_expr_literal_fits(na->ival, tb)) {
+		*out = tb;
+		return true;
 	}
-	if (ok && src.data) {
-		out_src = tcc_strdup(src.data);
+	if (nb->literal == 1 && na->literal == 0 && tcc_expr_type_is_int(ta) && tcc_expr_literal_fits(nb->ival, ta)) {
+		*out = ta;
+		return true;
 	}
-	if (wrapper_name) {
-		duckdb_free(wrapper_name);
+	if ((na->literal == 2 && tb == TCC_FFI_F32) || (nb->literal == 2 && ta == TCC_FFI_F32)) {
+		*out = TCC_FFI_F32;
+		return true;
 	}
-	tcc_text_buf_destroy(&args_decl);
-	tcc_text_buf_destroy(&row_unpack_lines);
-	tcc_text_buf_destroy(&row_call_args);
-	tcc_text_buf_destroy(&batch_col_decls);
-	tcc_text_buf_destroy(&batch_call_args);
-	tcc_text_buf_destroy(&batch_null_checks);
-	tcc_text_buf_destroy(&src);
-	return out_src;
+	if (tcc_expr_type_is_float(ta) || tcc_expr_type_is_float(tb)) {
+		*out = ta == TCC_FFI_F64 || tb == TCC_FFI_F64 ? TCC_FFI_F64 : TCC_FFI_F32;
+		return true;
+	}
+	if (tcc_expr_type_is_signed(ta) == tcc_expr_type_is_signed(tb)) {
+		*out = tcc_expr_int_width(ta) >= tcc_expr_int_width(tb) ? ta : tb;
+		return true;
+	}
+	{
+		tcc_ffi_type_t s = tcc_expr_type_is_signed(ta) ? ta : tb;
+		tcc_ffi_type_t u = tcc_expr_type_is_signed(ta) ? tb : ta;
+		if (u == TCC_FFI_U64) {
+			tcc_expr_fail(p, "mixing UBIGINT with a signed integer needs HUGEINT, which is not supported");
+			return false;
+		}
+		*out = tcc_expr_int_width(s) > tcc_expr_int_width(u) ? s : TCC_FFI_I64;
+	}
+	return true;
 }
 
-static char *tcc_codegen_build_compilation_unit(const char *user_source, const char *wrapper_loader_source) {
-	char *compilation_unit_source;
-	const char *prelude = "#include <stdint.h>\n"
-	                      "/* Composite descriptors below are borrowed views from DuckDB vectors. */\n"
-	                      "/* Wrappers must not free them and must not retain them after invocation. */\n"
-	                      "typedef struct {\n"
-	                      "  uint64_t lower;\n"
-	                      "  int64_t upper;\n"
-	                      "} ducktinycc_hugeint_t;\n"
-	                      "typedef struct {\n"
-	                      "  const void *ptr;\n"
-	                      "  uint64_t len;\n"
-	                      "} ducktinycc_blob_t;\n"
-	                      "typedef struct {\n"
-	                      "  int32_t days;\n"
-	                      "} ducktinycc_date_t;\n"
-	                      "typedef struct {\n"
-	                      "  int64_t micros;\n"
-	                      "} ducktinycc_time_t;\n"
-	                      "typedef struct {\n"
-	                      "  int64_t micros;\n"
-	                      "} ducktinycc_timestamp_t;\n"
-	                      "typedef struct {\n"
-	                      "  int32_t months;\n"
-	                      "  int32_t days;\n"
-	                      "  int64_t micros;\n"
-	                      "} ducktinycc_interval_t;\n"
-	                      "typedef struct {\n"
-	                      "  uint8_t width;\n"
-	                      "  uint8_t scale;\n"
-	                      "  ducktinycc_hugeint_t value;\n"
-	                      "} ducktinycc_decimal_t;\n"
-	                      "typedef struct {\n"
-	                      "  const void *ptr;\n"
-	                      "  const uint64_t *validity;\n"
-	                      "  uint64_t offset;\n"
-	                      "  uint64_t len;\n"
-	                      "} ducktinycc_list_t;\n"
-	                      "typedef struct {\n"
-	                      "  const void *ptr;\n"
-	                      "  const uint64_t *validity;\n"
-	                      "  uint64_t offset;\n"
-	                      "  uint64_t len;\n"
-	                      "} ducktinycc_array_t;\n"
-	                      "typedef struct {\n"
-	                      "  const void *const *field_ptrs;\n"
-	                      "  const uint64_t *const *field_validity;\n"
-	                      "  uint64_t field_count;\n"
-	                      "  uint64_t offset;\n"
-	                      "} ducktinycc_struct_t;\n"
-	                      "typedef struct {\n"
-	                      "  const void *key_ptr;\n"
-	                      "  const uint64_t *key_validity;\n"
-	                      "  const void *value_ptr;\n"
-		                      "  const uint64_t *value_validity;\n"
-		                      "  uint64_t offset;\n"
-		                      "  uint64_t len;\n"
-		                      "} ducktinycc_map_t;\n"
-	                      "typedef struct {\n"
-	                      "  const uint8_t *tag_ptr;\n"
-	                      "  const void *const *member_ptrs;\n"
-	                      "  const uint64_t *const *member_validity;\n"
-	                      "  uint64_t member_count;\n"
-	                      "  uint64_t offset;\n"
-	                      "} ducktinycc_union_t;\n"
-	                      "/* Accessor helpers below operate on caller-owned memory spans. */\n"
-		                      "extern int ducktinycc_valid_is_set(const uint64_t *validity, uint64_t idx);\n"
-		                      "extern void ducktinycc_valid_set(uint64_t *validity, uint64_t idx, int valid);\n"
-		                      "extern int ducktinycc_span_contains(uint64_t len, uint64_t idx);\n"
-		                      "extern const void *ducktinycc_ptr_add(const void *base, uint64_t byte_offset);\n"
-		                      "extern void *ducktinycc_ptr_add_mut(void *base, uint64_t byte_offset);\n"
-		                      "extern int ducktinycc_span_fits(uint64_t len, uint64_t offset, uint64_t width);\n"
-		                      "extern const void *ducktinycc_buf_ptr_at(const void *base, uint64_t len, uint64_t offset, uint64_t width);\n"
-		                      "extern void *ducktinycc_buf_ptr_at_mut(void *base, uint64_t len, uint64_t offset, uint64_t width);\n"
-		                      "extern int ducktinycc_read_bytes(const void *base, uint64_t len, uint64_t offset, void *out, uint64_t width);\n"
-		                      "extern int ducktinycc_write_bytes(void *base, uint64_t len, uint64_t offset, const void *in, uint64_t width);\n"
-		                      "extern int ducktinycc_read_i8(const void *base, uint64_t len, uint64_t offset, int8_t *out);\n"
-		                      "extern int ducktinycc_write_i8(void *base, uint64_t len, uint64_t offset, int8_t value);\n"
-		                      "extern int ducktinycc_read_u8(const void *base, uint64_t len, uint64_t offset, uint8_t *out);\n"
-		                      "extern int ducktinycc_write_u8(void *base, uint64_t len, uint64_t offset, uint8_t value);\n"
-		                      "extern int ducktinycc_read_i16(const void *base, uint64_t len, uint64_t offset, int16_t *out);\n"
-		                      "extern int ducktinycc_write_i16(void *base, uint64_t len, uint64_t offset, int16_t value);\n"
-		                      "extern int ducktinycc_read_u16(const void *base, uint64_t len, uint64_t offset, uint16_t *out);\n"
-		                      "extern int ducktinycc_write_u16(void *base, uint64_t len, uint64_t offset, uint16_t value);\n"
-		                      "extern int ducktinycc_read_i32(const void *base, uint64_t len, uint64_t offset, int32_t *out);\n"
-		                      "extern int ducktinycc_write_i32(void *base, uint64_t len, uint64_t offset, int32_t value);\n"
-		                      "extern int ducktinycc_read_u32(const void *base, uint64_t len, uint64_t offset, uint32_t *out);\n"
-		                      "extern int ducktinycc_write_u32(void *base, uint64_t len, uint64_t offset, uint32_t value);\n"
-		                      "extern int ducktinycc_read_i64(const void *base, uint64_t len, uint64_t offset, int64_t *out);\n"
-		                      "extern int ducktinycc_write_i64(void *base, uint64_t len, uint64_t offset, int64_t value);\n"
-		                      "extern int ducktinycc_read_u64(const void *base, uint64_t len, uint64_t offset, uint64_t *out);\n"
-		                      "extern int ducktinycc_write_u64(void *base, uint64_t len, uint64_t offset, uint64_t value);\n"
-		                      "extern int ducktinycc_read_f32(const void *base, uint64_t len, uint64_t offset, float *out);\n"
-		                      "extern int ducktinycc_write_f32(void *base, uint64_t len, uint64_t offset, float value);\n"
-		                      "extern int ducktinycc_read_f64(const void *base, uint64_t len, uint64_t offset, double *out);\n"
-		                      "extern int ducktinycc_write_f64(void *base, uint64_t len, uint64_t offset, double value);\n"
-		                      "extern int ducktinycc_read_ptr(const void *base, uint64_t len, uint64_t offset, const void **out);\n"
-		                      "extern int ducktinycc_write_ptr(void *base, uint64_t len, uint64_t offset, const void *value);\n"
-		                      "extern int ducktinycc_list_is_valid(const ducktinycc_list_t *list, uint64_t idx);\n"
-		                      "extern const void *ducktinycc_list_elem_ptr(const ducktinycc_list_t *list, uint64_t idx, uint64_t elem_size);\n"
-		                      "extern int ducktinycc_array_is_valid(const ducktinycc_array_t *arr, uint64_t idx);\n"
-		                      "extern const void *ducktinycc_array_elem_ptr(const ducktinycc_array_t *arr, uint64_t idx, uint64_t elem_size);\n"
-		                      "extern const void *ducktinycc_struct_field_ptr(const ducktinycc_struct_t *st, uint64_t idx);\n"
-		                      "extern int ducktinycc_struct_field_is_valid(const ducktinycc_struct_t *st, uint64_t field_idx);\n"
-		                      "extern const void *ducktinycc_map_key_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t key_size);\n"
-		                      "extern const void *ducktinycc_map_value_ptr(const ducktinycc_map_t *m, uint64_t idx, uint64_t value_size);\n"
-		                      "extern int ducktinycc_map_key_is_valid(const ducktinycc_map_t *m, uint64_t idx);\n"
-		                      "extern int ducktinycc_map_value_is_valid(const ducktinycc_map_t *m, uint64_t idx);\n"
-		                      "extern int ducktinycc_union_tag(const ducktinycc_union_t *u);\n"
-		                      "extern const void *ducktinycc_union_member_ptr(const ducktinycc_union_t *u, uint64_t member_idx);\n"
-		                      "extern int ducktinycc_union_member_is_valid(const ducktinycc_union_t *u, uint64_t member_idx);\n"
-		                      "extern int duckdb_validity_row_is_valid(uint64_t *validity, uint64_t row);\n";
-	size_t n0;
-	size_t n1;
-	size_t n2;
-	if (!wrapper_loader_source) {
-		return NULL;
+/* tcc_expr_make: builds a typed node with up to three kids. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_make(tcc_expr_parser_t *p, tcc_expr_node_kind_t kind, tcc_ffi_type_t type, int k0, int k1, int k2) {
+	int node = tcc_expr_new_node(p, kind, type);
+	if (node >= 0) {
+		p->nodes[node].kids[0] = k0;
+		p->nodes[node].kids[1] = k1;
+		p->nodes[node].kids[2] = k2;
+	}
+	return node;
+}
+
+/* tcc_expr_require_bool: checks a logical operand. Allocation/Lifetime: none. */
+static bool tcc_expr_require_bool(tcc_expr_parser_t *p, int node, const char *what) {
+	tcc_ffi_type_t type = p->nodes[node].type;
+	if (type != TCC_FFI_BOOL && type != TCC_FFI_VOID) {
+		char message[128];
+		snprintf(message, sizeof(message), "%s needs a BOOLEAN operand", what);
+		tcc_expr_fail(p, message);
+		return false;
+	}
+	return true;
+}
+
+/* tcc_expr_require_numeric: checks an arithmetic operand. Allocation/Lifetime: none. */
+static bool tcc_expr_require_numeric(tcc_expr_parser_t *p, int node, const char *what) {
+	if (p->nodes[node].type == TCC_FFI_BOOL) {
+		char message[128];
+		snprintf(message, sizeof(message), "%s is not supported for BOOLEAN", what);
+		tcc_expr_fail(p, message);
+		return false;
+	}
+	return true;
+}
+
+/* tcc_expr_lookup_type_name: SQL or ducktinycc name of a supported compile_expr type (case-insensitive, length-bounded). Allocation/Lifetime: none. */
+static bool tcc_expr_lookup_type_name(const char *name, size_t len, tcc_ffi_type_t *out) {
+	static const struct {
+		const char *name;
+		tcc_ffi_type_t type;
+	} names[] = {
+	    {"BOOLEAN", TCC_FFI_BOOL},   {"BOOL", TCC_FFI_BOOL},     {"LOGICAL", TCC_FFI_BOOL},  {"TINYINT", TCC_FFI_I8},
+	    {"INT1", TCC_FFI_I8},        {"I8", TCC_FFI_I8},         {"SMALLINT", TCC_FFI_I16},  {"INT2", TCC_FFI_I16},
+	    {"SHORT", TCC_FFI_I16},      {"I16", TCC_FFI_I16},       {"INTEGER", TCC_FFI_I32},   {"INT", TCC_FFI_I32},
+	    {"INT4", TCC_FFI_I32},       {"SIGNED", TCC_FFI_I32},    {"I32", TCC_FFI_I32},       {"BIGINT", TCC_FFI_I64},
+	    {"INT8", TCC_FFI_I64},       {"LONG", TCC_FFI_I64},      {"I64", TCC_FFI_I64},       {"UTINYINT", TCC_FFI_U8},
+	    {"U8", TCC_FFI_U8},          {"USMALLINT", TCC_FFI_U16}, {"U16", TCC_FFI_U16},       {"UINTEGER", TCC_FFI_U32},
+	    {"U32", TCC_FFI_U32},        {"UBIGINT", TCC_FFI_U64},   {"U64", TCC_FFI_U64},       {"FLOAT", TCC_FFI_F32},
+	    {"FLOAT4", TCC_FFI_F32},     {"REAL", TCC_FFI_F32},      {"F32", TCC_FFI_F32},       {"DOUBLE", TCC_FFI_F64},
+	    {"FLOAT8", TCC_FFI_F64},     {"F64", TCC_FFI_F64},
+	};
+	size_t i;
+	size_t j;
+	for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+		if (strlen(names[i].name) != len) {
+			continue;
+		}
+		for (j = 0; j < len && toupper((unsigned char)name[j]) == names[i].name[j]; j++) {
+		}
+		if (j == len) {
+			*out = names[i].type;
+			return true;
+		}
 	}
-	if (!user_source || user_source[0] == '\0') {
-		n0 = strlen(prelude);
-		n2 = strlen(wrapper_loader_source);
-		compilation_unit_source = (char *)duckdb_malloc(n0 + n2 + 2);
-		if (!compilation_unit_source) {
-			return NULL;
+	return false;
+}
+
+/* tcc_expr_parse_type_name: type name after CAST ... AS or `::`. Allocation/Lifetime: none. */
+static bool tcc_expr_parse_type_name(tcc_expr_parser_t *p, tcc_ffi_type_t *out) {
+	if (p->tok == TCC_EXPR_TOK_IDENT && tcc_expr_lookup_type_name(p->src + p->tok_start, p->tok_len, out)) {
+		tcc_expr_next(p);
+		return true;
+	}
+	tcc_expr_fail(p, "unsupported cast target type (numeric and BOOLEAN types only)");
+	return false;
+}
+
+static int tcc_expr_parse_expr(tcc_expr_parser_t *p);
+
+/* tcc_expr_make_compare: typed comparison node. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_make_compare(tcc_expr_parser_t *p, const char *op, int a, int b) {
+	tcc_ffi_type_t common;
+	int node;
+	if (!tcc_expr_common_type(p, a, b, &common)) {
+		return -1;
+	}
+	node = tcc_expr_make(p, TCC_EXPR_NODE_COMPARE, TCC_FFI_BOOL, a, b, -1);
+	if (node >= 0) {
+		p->nodes[node].operand_type = common;
+		snprintf(p->nodes[node].op, sizeof(p->nodes[node].op), "%s", op);
+	}
+	return node;
+}
+
+/* tcc_expr_parse_case_tail: WHEN ... THEN ... [ELSE ...] END, lowered to nested IF nodes. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_case_tail(tcc_expr_parser_t *p, int operand) {
+	int cond;
+	int then_node;
+	int rest;
+	tcc_ffi_type_t type;
+	if (++p->depth > TCC_EXPR_MAX_DEPTH) {
+		return tcc_expr_fail(p, "expression nests too deeply");
+	}
+	if (tcc_expr_is_kw(p, "ELSE")) {
+		tcc_expr_next(p);
+		rest = tcc_expr_parse_expr(p);
+		p->depth--;
+		return rest >= 0 && tcc_expr_expect_kw(p, "END", "expected END") ? rest : -1;
+	}
+	if (tcc_expr_is_kw(p, "END")) {
+		tcc_expr_next(p);
+		p->depth--;
+		return tcc_expr_new_node(p, TCC_EXPR_NODE_NULL, TCC_FFI_VOID);
+	}
+	if (!tcc_expr_expect_kw(p, "WHEN", "expected WHEN, ELSE or END")) {
+		return -1;
+	}
+	cond = tcc_expr_parse_expr(p);
+	if (cond < 0) {
+		return -1;
+	}
+	if (operand >= 0) {
+		cond = tcc_expr_make_compare(p, "=", operand, cond);
+		if (cond < 0) {
+			return -1;
 		}
-		memcpy(compilation_unit_source, prelude, n0);
-		memcpy(compilation_unit_source + n0, wrapper_loader_source, n2);
-		compilation_unit_source[n0 + n2] = '\0';
-		return compilation_unit_source;
 	}
-	n0 = strlen(prelude);
-	n1 = strlen(user_source);
-	n2 = strlen(wrapper_loader_source);
-	compilation_unit_source = (char *)duckdb_malloc(n0 + n1 + n2 + 3);
-	if (!compilation_unit_source) {
-		return NULL;
+	if (!tcc_expr_require_bool(p, cond, "CASE WHEN") || !tcc_expr_expect_kw(p, "THEN", "expected THEN")) {
+		return -1;
 	}
-	memcpy(compilation_unit_source, prelude, n0);
-	memcpy(compilation_unit_source + n0, user_source, n1);
-	compilation_unit_source[n0 + n1] = '\n';
-	memcpy(compilation_unit_source + n0 + n1 + 1, wrapper_loader_source, n2);
-	compilation_unit_source[n0 + n1 + 1 + n2] = '\0';
-	return compilation_unit_source;
+	then_node = tcc_expr_parse_expr(p);
+	if (then_node < 0) {
+		return -1;
+	}
+	rest = tcc_expr_parse_case_tail(p, operand);
+	p->depth--;
+	if (rest < 0 || !tcc_expr_common_type(p, then_node, rest, &type)) {
+		return -1;
+	}
+	return tcc_expr_make(p, TCC_EXPR_NODE_IF, type, cond, then_node, rest);
 }
 
-/* tcc_helper_binding_list_add_prefixed: Growable container utility used by parsing/codegen flows. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_helper_binding_list_add_prefixed(tcc_helper_binding_list_t *bindings, const char *prefix,
-                                                 const char *suffix, const char *return_type,
-                                                 const char *arg_types_csv, const char *stability) {
-	char symbol[512];
-	char sql_name[512];
-	int n_symbol;
-	int n_sql;
-	if (!bindings || !prefix || !suffix || !return_type || !arg_types_csv || !stability) {
-		return false;
+/* tcc_expr_parse_coalesce_tail: COALESCE argument list, lowered to right-nested binary nodes. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_coalesce_tail(tcc_expr_parser_t *p) {
+	int first;
+	int rest;
+	tcc_ffi_type_t type;
+	if (++p->depth > TCC_EXPR_MAX_DEPTH) {
+		return tcc_expr_fail(p, "expression nests too deeply");
 	}
-	n_symbol = snprintf(symbol, sizeof(symbol), "%s_%s", prefix, suffix);
-	n_sql = snprintf(sql_name, sizeof(sql_name), "%s_%s", prefix, suffix);
-	if (n_symbol < 0 || n_sql < 0 || (size_t)n_symbol >= sizeof(symbol) || (size_t)n_sql >= sizeof(sql_name)) {
-		return false;
+	first = tcc_expr_parse_expr(p);
+	if (first < 0) {
+		return -1;
 	}
-	return tcc_helper_binding_list_add(bindings, symbol, sql_name, return_type, arg_types_csv, stability);
+	if (tcc_expr_is_op(p, ")")) {
+		tcc_expr_next(p);
+		p->depth--;
+		return first;
+	}
+	if (!tcc_expr_expect_op(p, ",", "expected ',' or ')' in COALESCE")) {
+		return -1;
+	}
+	rest = tcc_expr_parse_coalesce_tail(p);
+	p->depth--;
+	if (rest < 0 || !tcc_expr_common_type(p, first, rest, &type)) {
+		return -1;
+	}
+	return tcc_expr_make(p, TCC_EXPR_NODE_COALESCE, type, first, rest, -1);
 }
 
-/* tcc_format_cstr: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_format_cstr(char *buf, size_t buf_size, const char *fmt, ...) {
-	va_list args;
-	int n;
-	if (!buf || buf_size == 0 || !fmt) {
-		return false;
+/* tcc_expr_parse_primary: literals, columns, parentheses, CASE, CAST, COALESCE and ABS. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_primary(tcc_expr_parser_t *p) {
+	int node;
+	int child;
+	if (p->tok == TCC_EXPR_TOK_INT) {
+		char digits[32];
+		unsigned long long value;
+		char *end = NULL;
+		if (p->tok_len >= sizeof(digits)) {
+			return tcc_expr_fail(p, "integer literal out of range");
+		}
+		memcpy(digits, p->src + p->tok_start, p->tok_len);
+		digits[p->tok_len] = '\0';
+		errno = 0;
+		value = strtoull(digits, &end, 10);
+		if (errno != 0 || value > (unsigned long long)INT64_MAX) {
+			return tcc_expr_fail(p, "integer literal out of range (HUGEINT literals are not supported)");
+		}
+		node = tcc_expr_new_node(p, TCC_EXPR_NODE_LITERAL, value <= (unsigned long long)INT32_MAX ? TCC_FFI_I32 : TCC_FFI_I64);
+		if (node >= 0) {
+			p->nodes[node].literal = 1;
+			p->nodes[node].ival = (int64_t)value;
+		}
+		tcc_expr_next(p);
+		return node;
+	}
+	if (p->tok == TCC_EXPR_TOK_FLOAT) {
+		char text[64];
+		double value;
+		if (p->tok_len >= sizeof(text)) {
+			return tcc_expr_fail(p, "numeric literal too long");
+		}
+		memcpy(text, p->src + p->tok_start, p->tok_len);
+		text[p->tok_len] = '\0';
+		value = strtod(text, NULL);
+		if (!isfinite(value)) {
+			return tcc_expr_fail(p, "numeric literal out of range");
+		}
+		node = tcc_expr_new_node(p, TCC_EXPR_NODE_LITERAL, TCC_FFI_F64);
+		if (node >= 0) {
+			p->nodes[node].literal = 2;
+			p->nodes[node].fval = value;
+		}
+		tcc_expr_next(p);
+		return node;
+	}
+	if (tcc_expr_is_op(p, "(")) {
+		tcc_expr_next(p);
+		node = tcc_expr_parse_expr(p);
+		return node >= 0 && tcc_expr_expect_op(p, ")", "expected ')'") ? node : -1;
+	}
+	if (p->tok == TCC_EXPR_TOK_IDENT) {
+		if (tcc_expr_is_kw(p, "NULL")) {
+			tcc_expr_next(p);
+			return tcc_expr_new_node(p, TCC_EXPR_NODE_NULL, TCC_FFI_VOID);
+		}
+		if (tcc_expr_is_kw(p, "TRUE") || tcc_expr_is_kw(p, "FALSE")) {
+			node = tcc_expr_new_node(p, TCC_EXPR_NODE_LITERAL, TCC_FFI_BOOL);
+			if (node >= 0) {
+				p->nodes[node].ival = tcc_expr_is_kw(p, "TRUE") ? 1 : 0;
+			}
+			tcc_expr_next(p);
+			return node;
+		}
+		if (tcc_expr_is_kw(p, "CASE")) {
+			int operand = -1;
+			tcc_expr_next(p);
+			if (!tcc_expr_is_kw(p, "WHEN")) {
+				operand = tcc_expr_parse_expr(p);
+				if (operand < 0) {
+					return -1;
+				}
+				if (!tcc_expr_is_kw(p, "WHEN")) {
+					return tcc_expr_fail(p, "expected WHEN");
+				}
+			}
+			return tcc_expr_parse_case_tail(p, operand);
+		}
+		if (tcc_expr_is_kw(p, "CAST")) {
+			tcc_ffi_type_t target;
+			tcc_expr_next(p);
+			if (!tcc_expr_expect_op(p, "(", "expected '(' after CAST")) {
+				return -1;
+			}
+			child = tcc_expr_parse_expr(p);
+			if (child < 0 || !tcc_expr_expect_kw(p, "AS", "expected AS in CAST") ||
+			    !tcc_expr_parse_type_name(p, &target) || !tcc_expr_expect_op(p, ")", "expected ')' after CAST")) {
+				return -1;
+			}
+			return tcc_expr_make(p, TCC_EXPR_NODE_CAST, target, child, -1, -1);
+		}
+		if (tcc_expr_is_kw(p, "COALESCE")) {
+			tcc_expr_next(p);
+			if (!tcc_expr_expect_op(p, "(", "expected '(' after COALESCE")) {
+				return -1;
+			}
+			return tcc_expr_parse_coalesce_tail(p);
+		}
+		if (tcc_expr_is_kw(p, "ABS")) {
+			tcc_expr_next(p);
+			if (!tcc_expr_expect_op(p, "(", "expected '(' after ABS")) {
+				return -1;
+			}
+			child = tcc_expr_parse_expr(p);
+			if (child < 0 || !tcc_expr_require_numeric(p, child, "ABS") ||
+			    !tcc_expr_expect_op(p, ")", "expected ')' after ABS")) {
+				return -1;
+			}
+			return tcc_expr_make(p, TCC_EXPR_NODE_ABS, p->nodes[child].type, child, -1, -1);
+		}
 	}
-	va_start(args, fmt);
-	n = vsnprintf(buf, buf_size, fmt, args);
-	va_end(args);
-	return n >= 0 && (size_t)n < buf_size;
+	if (p->tok == TCC_EXPR_TOK_IDENT || p->tok == TCC_EXPR_TOK_QUOTED) {
+		size_t start = p->tok_start + (p->tok == TCC_EXPR_TOK_QUOTED ? 1 : 0);
+		size_t len = p->tok_len - (p->tok == TCC_EXPR_TOK_QUOTED ? 2 : 0);
+		int i;
+		for (i = 0; i < p->arg_count; i++) {
+			const char *name = p->arg_names->items[i];
+			size_t j;
+			if (strlen(name) != len) {
+				continue;
+			}
+			for (j = 0; j < len && tolower((unsigned char)name[j]) == tolower((unsigned char)p->src[start + j]); j++) {
+			}
+			if (j == len) {
+				break;
+			}
+		}
+		if (i == p->arg_count) {
+			char message[192];
+			size_t at = p->tok_start;
+			tcc_expr_next(p);
+			snprintf(message, sizeof(message), "%s '%.*s'", tcc_expr_is_op(p, "(") ? "unsupported function" : "unknown column",
+			         (int)(len > 64 ? 64 : len), p->src + start);
+			p->tok_start = at;
+			return tcc_expr_fail(p, message);
+		}
+		node = tcc_expr_new_node(p, TCC_EXPR_NODE_COLUMN, p->arg_types[i]);
+		if (node >= 0) {
+			p->nodes[node].column = i;
+		}
+		tcc_expr_next(p);
+		return node;
+	}
+	return tcc_expr_fail(p, p->tok == TCC_EXPR_TOK_END ? "unexpected end of expression" : "unexpected token");
 }
 
-static char *tcc_generate_c_composite_helpers_source(const char *kind_keyword, const char *type_name,
-                                                     const char *prefix, const tcc_c_field_list_t *fields,
-                                                     tcc_error_buffer_t *error_buf) {
-	tcc_text_buf_t src = {0};
-	idx_t i;
-	bool ok;
-	if (!kind_keyword || !type_name || !prefix || !fields) {
-		tcc_set_error(error_buf, "invalid composite helper arguments");
-		return NULL;
+/* tcc_expr_parse_postfix: primary followed by `::type` casts. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_postfix(tcc_expr_parser_t *p) {
+	int node = tcc_expr_parse_primary(p);
+	while (node >= 0 && tcc_expr_is_op(p, "::")) {
+		tcc_ffi_type_t target;
+		tcc_expr_next(p);
+		if (!tcc_expr_parse_type_name(p, &target)) {
+			return -1;
+		}
+		node = tcc_expr_make(p, TCC_EXPR_NODE_CAST, target, node, -1, -1);
 	}
-	ok = tcc_text_buf_appendf(
-	    &src,
-	    "extern void *malloc(unsigned long long);\n"
-	    "extern void free(void *);\n"
-	    "/* Generated helpers allocate with libc malloc/free. Pair %s_new with %s_free. */\n"
-	    "#ifndef DUCKTINYCC_OFFSETOF\n"
-	    "#define DUCKTINYCC_OFFSETOF(type, member) ((unsigned long long)((const char *)&(((type *)0)->member) - (const char *)0))\n"
-	    "#endif\n"
-	    "unsigned long long %s_sizeof(void){ return (unsigned long long)sizeof(%s %s); }\n"
-	    "unsigned long long %s_alignof(void){ struct __ducktinycc_align_%s { char c; %s %s v; };"
-	    " return (unsigned long long)(sizeof(struct __ducktinycc_align_%s) - sizeof(%s %s)); }\n"
-	    "void *%s_new(void){ return malloc(sizeof(%s %s)); }\n"
-	    "void %s_free(void *p){ if (p) free(p); }\n",
-	    prefix, prefix, prefix, kind_keyword, type_name, prefix, prefix, kind_keyword, type_name, prefix,
-	    kind_keyword, type_name, prefix, kind_keyword, type_name, prefix);
-	if (!ok) {
-		tcc_set_error(error_buf, "out of memory");
-		tcc_text_buf_destroy(&src);
-		return NULL;
+	return node;
+}
+
+/* tcc_expr_parse_unary: prefix `-`/`+`; negated literals are folded so `-128` stays a literal. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_unary(tcc_expr_parser_t *p) {
+	int child;
+	if (tcc_expr_is_op(p, "+") || tcc_expr_is_op(p, "-")) {
+		bool negate = tcc_expr_is_op(p, "-");
+		if (++p->depth > TCC_EXPR_MAX_DEPTH) {
+			return tcc_expr_fail(p, "expression nests too deeply");
+		}
+		tcc_expr_next(p);
+		child = tcc_expr_parse_unary(p);
+		p->depth--;
+		if (child < 0 || !negate) {
+			return child;
+		}
+		if (!tcc_expr_require_numeric(p, child, "negation")) {
+			return -1;
+		}
+		if (p->nodes[child].literal == 1) {
+			p->nodes[child].ival = -p->nodes[child].ival;
+			p->nodes[child].type = tcc_expr_literal_fits(p->nodes[child].ival, TCC_FFI_I32) ? TCC_FFI_I32 : TCC_FFI_I64;
+			return child;
+		}
+		if (p->nodes[child].literal == 2) {
+			p->nodes[child].fval = -p->nodes[child].fval;
+			return child;
+		}
+		return tcc_expr_make(p, TCC_EXPR_NODE_NEG, p->nodes[child].type, child, -1, -1);
 	}
-	for (i = 0; i < fields->count; i++) {
-		const tcc_c_field_spec_t *field = &fields->items[i];
-		const char *c_type = tcc_ffi_type_to_c_type_name(field->type);
-		if (!c_type) {
-			tcc_set_error(error_buf, "field type is unsupported for helper codegen");
-			tcc_text_buf_destroy(&src);
-			return NULL;
+	return tcc_expr_parse_postfix(p);
+}
+
+/* tcc_expr_make_arith: typed arithmetic node; `/` yields a floating type like DuckDB. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_make_arith(tcc_expr_parser_t *p, const char *op, int a, int b) {
+	tcc_ffi_type_t type;
+	int node;
+	if (!tcc_expr_require_numeric(p, a, "arithmetic") || !tcc_expr_require_numeric(p, b, "arithmetic") ||
+	    !tcc_expr_common_type(p, a, b, &type)) {
+		return -1;
+	}
+	if (type == TCC_FFI_VOID) {
+		type = TCC_FFI_I32;
+	}
+	if (strcmp(op, "/") == 0 && type != TCC_FFI_F32) {
+		type = TCC_FFI_F64;
+	}
+	node = tcc_expr_make(p, TCC_EXPR_NODE_ARITH, type, a, b, -1);
+	if (node >= 0) {
+		snprintf(p->nodes[node].op, sizeof(p->nodes[node].op), "%s", op);
+	}
+	return node;
+}
+
+/* tcc_expr_parse_mul: `*`, `/`, `//`, `%`. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_mul(tcc_expr_parser_t *p) {
+	int left = tcc_expr_parse_unary(p);
+	while (left >= 0 && (tcc_expr_is_op(p, "*") || tcc_expr_is_op(p, "/") || tcc_expr_is_op(p, "//") ||
+	                     tcc_expr_is_op(p, "%"))) {
+		char op[3];
+		int right;
+		snprintf(op, sizeof(op), "%.*s", (int)p->tok_len, p->src + p->tok_start);
+		tcc_expr_next(p);
+		right = tcc_expr_parse_unary(p);
+		left = right < 0 ? -1 : tcc_expr_make_arith(p, op, left, right);
+	}
+	return left;
+}
+
+/* tcc_expr_parse_add: `+`, `-`. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_add(tcc_expr_parser_t *p) {
+	int left = tcc_expr_parse_mul(p);
+	while (left >= 0 && (tcc_expr_is_op(p, "+") || tcc_expr_is_op(p, "-"))) {
+		char op[3];
+		int right;
+		snprintf(op, sizeof(op), "%.*s", (int)p->tok_len, p->src + p->tok_start);
+		tcc_expr_next(p);
+		right = tcc_expr_parse_mul(p);
+		left = right < 0 ? -1 : tcc_expr_make_arith(p, op, left, right);
+	}
+	return left;
+}
+
+/* tcc_expr_parse_compare: one non-associative comparison. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_compare(tcc_expr_parser_t *p) {
+	static const char *const ops[] = {"=", "==", "<>", "!=", "<", "<=", ">", ">="};
+	int left = tcc_expr_parse_add(p);
+	size_t i;
+	if (left < 0) {
+		return -1;
+	}
+	for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+		if (tcc_expr_is_op(p, ops[i])) {
+			int right;
+			tcc_expr_next(p);
+			right = tcc_expr_parse_add(p);
+			return right < 0 ? -1 : tcc_expr_make_compare(p, ops[i], left, right);
 		}
-		if (field->array_size > 0) {
-			ok = tcc_text_buf_appendf(
-			    &src,
-			    "%s %s_get_%s_elt(void *p, unsigned long long idx){ %s out = (%s){0};"
-			    " if (!p || idx >= %lluULL) return out; out = ((%s %s *)p)->%s[idx]; return out; }\n"
-			    "void *%s_set_%s_elt(void *p, unsigned long long idx, %s value){"
-			    " if (!p || idx >= %lluULL) return (void *)0; ((%s %s *)p)->%s[idx] = value; return p; }\n"
-			    "unsigned long long %s_off_%s(void){ return DUCKTINYCC_OFFSETOF(%s %s, %s); }\n"
-			    "void *%s_%s_addr(void *p){ if (!p) return (void *)0; return (void *)&((%s %s *)p)->%s[0]; }\n",
-			    c_type, prefix, field->name, c_type, c_type, (unsigned long long)field->array_size, kind_keyword,
-			    type_name, field->name, prefix, field->name, c_type, (unsigned long long)field->array_size,
-			    kind_keyword, type_name, field->name, prefix, field->name, kind_keyword, type_name, field->name,
-			    prefix, field->name, kind_keyword, type_name, field->name);
-		} else {
-			ok = tcc_text_buf_appendf(
-			    &src,
-			    "%s %s_get_%s(void *p){ %s out = (%s){0};"
-			    " if (!p) return out; out = ((%s %s *)p)->%s; return out; }\n"
-			    "void *%s_set_%s(void *p, %s value){ if (!p) return (void *)0; ((%s %s *)p)->%s = value; return p; }\n",
-			    c_type, prefix, field->name, c_type, c_type, kind_keyword, type_name, field->name, prefix, field->name,
-			    c_type, kind_keyword, type_name, field->name);
-			if (ok && !field->is_bitfield) {
-				ok = tcc_text_buf_appendf(
-				    &src,
-				    "unsigned long long %s_off_%s(void){ return DUCKTINYCC_OFFSETOF(%s %s, %s); }\n"
-				    "void *%s_%s_addr(void *p){ if (!p) return (void *)0; return (void *)&((%s %s *)p)->%s; }\n",
-				    prefix, field->name, kind_keyword, type_name, field->name, prefix, field->name, kind_keyword,
-				    type_name, field->name);
+	}
+	return left;
+}
+
+/* tcc_expr_parse_is: `IS [NOT] NULL` (binds looser than comparisons, as in PostgreSQL/DuckDB). Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_is(tcc_expr_parser_t *p) {
+	int node = tcc_expr_parse_compare(p);
+	while (node >= 0 && tcc_expr_is_kw(p, "IS")) {
+		bool negate = false;
+		tcc_expr_next(p);
+		if (tcc_expr_is_kw(p, "NOT")) {
+			negate = true;
+			tcc_expr_next(p);
+		}
+		if (!tcc_expr_expect_kw(p, "NULL", "expected NULL after IS")) {
+			return -1;
+		}
+		node = tcc_expr_make(p, TCC_EXPR_NODE_IS_NULL, TCC_FFI_BOOL, node, -1, -1);
+		if (node >= 0 && negate) {
+			p->nodes[node].op[0] = '!';
+		}
+	}
+	return node;
+}
+
+/* tcc_expr_parse_not: prefix NOT. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_not(tcc_expr_parser_t *p) {
+	int child;
+	if (!tcc_expr_is_kw(p, "NOT")) {
+		return tcc_expr_parse_is(p);
+	}
+	if (++p->depth > TCC_EXPR_MAX_DEPTH) {
+		return tcc_expr_fail(p, "expression nests too deeply");
+	}
+	tcc_expr_next(p);
+	child = tcc_expr_parse_not(p);
+	p->depth--;
+	if (child < 0 || !tcc_expr_require_bool(p, child, "NOT")) {
+		return -1;
+	}
+	return tcc_expr_make(p, TCC_EXPR_NODE_NOT, TCC_FFI_BOOL, child, -1, -1);
+}
+
+/* tcc_expr_parse_and: AND chain. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_and(tcc_expr_parser_t *p) {
+	int left = tcc_expr_parse_not(p);
+	while (left >= 0 && tcc_expr_is_kw(p, "AND")) {
+		int right;
+		tcc_expr_next(p);
+		right = tcc_expr_parse_not(p);
+		if (right < 0 || !tcc_expr_require_bool(p, left, "AND") || !tcc_expr_require_bool(p, right, "AND")) {
+			return -1;
+		}
+		left = tcc_expr_make(p, TCC_EXPR_NODE_AND, TCC_FFI_BOOL, left, right, -1);
+	}
+	return left;
+}
+
+/* tcc_expr_parse_expr: OR chain (lowest precedence) with a nesting guard. Allocation/Lifetime: see tcc_expr_new_node. */
+static int tcc_expr_parse_expr(tcc_expr_parser_t *p) {
+	int left;
+	if (++p->depth > TCC_EXPR_MAX_DEPTH) {
+		return tcc_expr_fail(p, "expression nests too deeply");
+	}
+	left = tcc_expr_parse_and(p);
+	while (left >= 0 && tcc_expr_is_kw(p, "OR")) {
+		int right;
+		tcc_expr_next(p);
+		right = tcc_expr_parse_and(p);
+		if (right < 0 || !tcc_expr_require_bool(p, left, "OR") || !tcc_expr_require_bool(p, right, "OR")) {
+			return -1;
+		}
+		left = tcc_expr_make(p, TCC_EXPR_NODE_OR, TCC_FFI_BOOL, left, right, -1);
+	}
+	p->depth--;
+	return left;
+}
+
+/* tcc_expr_emit_cast: converts v<src> to the node's type with DuckDB CAST rules (range errors abort the chunk). Allocation/Lifetime: appends to out. */
+static bool tcc_expr_emit_cast(tcc_text_buf_t *out, int indent, int k, tcc_ffi_type_t from, int src, tcc_ffi_type_t to) {
+	const char *ct = tcc_expr_c_type(to);
+	const char *min_c;
+	const char *max_c;
+	int64_t min_v;
+	int64_t max_v;
+	if (from == TCC_FFI_VOID) {
+		return true;
+	}
+	if (to == TCC_FFI_BOOL) {
+		return tcc_text_buf_appendf(out, "%*sv%d = v%d != 0;\n", indent, "", k, src);
+	}
+	if (from == TCC_FFI_BOOL || tcc_expr_type_is_float(to)) {
+		if (to == TCC_FFI_F32 && from == TCC_FFI_F64) {
+			if (!tcc_text_buf_appendf(out,
+			                          "%*sif (v%d - v%d == 0 && (v%d > 3.4028234663852886e38 || v%d < -3.4028234663852886e38)) "
+			                          "return 0;\n",
+			                          indent, "", src, src, src, src)) {
+				return false;
+			}
+		}
+		return tcc_text_buf_appendf(out, "%*sv%d = (%s)v%d;\n", indent, "", k, ct, src);
+	}
+	tcc_expr_int_limits(to, &min_c, &max_c, &min_v, &max_v);
+	if (tcc_expr_type_is_float(from)) {
+		/* DuckDB checks the lower bound before rounding (so -0.4 does not cast to an unsigned type)
+		 * and rounds half to even; the upper bound is checked on the rounded value. */
+		const char *upper_op = "<=";
+		if (to == TCC_FFI_I64 || to == TCC_FFI_U64) {
+			max_c = to == TCC_FFI_I64 ? "9223372036854775808.0" : "18446744073709551616.0";
+			upper_op = "<";
+		}
+		return tcc_text_buf_appendf(out,
+		                            "%*s{ double x = (double)v%d; double r = ducktinycc_expr_rint(x); "
+		                            "if (!(x >= (double)%s && r %s (double)%s)) return 0; v%d = (%s)r; }\n",
+		                            indent, "", src, min_c, upper_op, max_c, k, ct);
+	}
+	if (tcc_expr_type_is_signed(from)) {
+		if (tcc_expr_type_is_signed(to)) {
+			if (!tcc_text_buf_appendf(out, "%*sif ((int64_t)v%d < %s || (int64_t)v%d > %s) return 0;\n", indent, "",
+			                          src, min_c, src, max_c)) {
+				return false;
+			}
+		} else if (!tcc_text_buf_appendf(out, "%*sif (v%d < 0 || (uint64_t)v%d > (uint64_t)%s) return 0;\n", indent,
+		                                 "", src, src, max_c)) {
+			return false;
+		}
+	} else if (!tcc_text_buf_appendf(out, "%*sif ((uint64_t)v%d > (uint64_t)%s) return 0;\n", indent, "", src,
+	                                 max_c)) {
+		return false;
+	}
+	return tcc_text_buf_appendf(out, "%*sv%d = (%s)v%d;\n", indent, "", k, ct, src);
+}
+
+/* tcc_expr_emit_arith: arithmetic with DuckDB overflow errors and NULL on integer division by zero. Allocation/Lifetime: appends to out. */
+static bool tcc_expr_emit_arith(tcc_text_buf_t *out, int indent, int k, const tcc_expr_node_t *node) {
+	tcc_ffi_type_t t = node->type;
+	const char *ct = tcc_expr_c_type(t);
+	const char *op = node->op;
+	const char *min_c;
+	const char *max_c;
+	int64_t min_v;
+	int64_t max_v;
+	int a = node->kids[0];
+	int b = node->kids[1];
+	if (tcc_expr_type_is_float(t)) {
+		if (strcmp(op, "//") == 0) {
+			return tcc_text_buf_appendf(out, "%*sif ((%s)v%d == 0) n%d = 1; else v%d = (%s)v%d / (%s)v%d;\n", indent,
+			                            "", ct, b, k, k, ct, a, ct, b);
+		}
+		if (strcmp(op, "%") == 0) {
+			return tcc_text_buf_appendf(out, "%*sv%d = (%s)ducktinycc_fmod((double)v%d, (double)v%d);\n", indent, "",
+			                            k, ct, a, b);
+		}
+		return tcc_text_buf_appendf(out, "%*sv%d = (%s)v%d %s (%s)v%d;\n", indent, "", k, ct, a, op, ct, b);
+	}
+	tcc_expr_int_limits(t, &min_c, &max_c, &min_v, &max_v);
+	if (strcmp(op, "//") == 0 || strcmp(op, "%") == 0) {
+		const char *c_op = op[0] == '%' ? "%" : "/";
+		if (tcc_expr_type_is_signed(t)) {
+			return tcc_text_buf_appendf(out,
+			                            "%*sif ((%s)v%d == 0) n%d = 1;\n"
+			                            "%*selse if ((%s)v%d == %s && (%s)v%d == -1) return 0;\n"
+			                            "%*selse v%d = (%s)((%s)v%d %s (%s)v%d);\n",
+			                            indent, "", ct, b, k, indent, "", ct, a, min_c, ct, b, indent, "", k, ct, ct, a,
+			                            c_op, ct, b);
+		}
+		return tcc_text_buf_appendf(out, "%*sif ((%s)v%d == 0) n%d = 1; else v%d = (%s)((%s)v%d %s (%s)v%d);\n",
+		                            indent, "", ct, b, k, k, ct, ct, a, c_op, ct, b);
+	}
+	if (t == TCC_FFI_I64 || t == TCC_FFI_U64) {
+		const char *fn = op[0] == '+' ? "add" : op[0] == '-' ? "sub" : "mul";
+		return tcc_text_buf_appendf(out, "%*sif (!ducktinycc_expr_%s_%s((%s)v%d, (%s)v%d, &v%d)) return 0;\n", indent,
+		                            "", fn, t == TCC_FFI_I64 ? "i64" : "u64", ct, a, ct, b, k);
+	}
+	if (t == TCC_FFI_U32 && op[0] == '*') {
+		return tcc_text_buf_appendf(out,
+		                            "%*s{ uint64_t t = (uint64_t)v%d * (uint64_t)v%d; if (t > 4294967295ULL) return 0; "
+		                            "v%d = (%s)t; }\n",
+		                            indent, "", a, b, k, ct);
+	}
+	return tcc_text_buf_appendf(out,
+	                            "%*s{ int64_t t = (int64_t)(%s)v%d %s (int64_t)(%s)v%d; if (t < %s || t > %s) return 0; "
+	                            "v%d = (%s)t; }\n",
+	                            indent, "", ct, a, op, ct, b, min_c, max_c, k, ct);
+}
+
+/**
+ * @function tcc_expr_emit
+ * @brief Emits C statements that define `v<k>` (value) and `n<k>` (NULL flag) for node k.
+ * @param[in] p Parser holding the typed node pool.
+ * @param[in] k Node index.
+ * @param[out] out Kernel body buffer.
+ * @param[in] indent Current indentation.
+ * @return false on allocation failure.
+ * @note CASE branches, COALESCE fallbacks and the right side of AND/OR are emitted inside
+ * the branch that needs them, so untaken branches cannot raise overflow errors. A shared
+ * simple-CASE operand is re-emitted in each nested scope, which shadows rather than
+ * redeclares its locals.
+ */
+static bool tcc_expr_emit(tcc_expr_parser_t *p, int k, tcc_text_buf_t *out, int indent) {
+	const tcc_expr_node_t *node = &p->nodes[k];
+	const char *ct = tcc_expr_c_type(node->type);
+	int a = node->kids[0];
+	int b = node->kids[1];
+	int c = node->kids[2];
+	int in = indent + 2;
+	switch (node->kind) {
+	case TCC_EXPR_NODE_COLUMN:
+		if (node->type == TCC_FFI_BOOL) {
+			if (!tcc_text_buf_appendf(out, "%*sint v%d = c%d[row] != 0;\n", indent, "", k, node->column)) {
+				return false;
+			}
+		} else if (!tcc_text_buf_appendf(out, "%*s%s v%d = c%d[row];\n", indent, "", ct, k, node->column)) {
+			return false;
+		}
+		return tcc_text_buf_appendf(out, "%*sint n%d = m%d && !((m%d[row >> 6] >> (row & 63)) & 1);\n", indent, "",
+		                            k, node->column, node->column);
+	case TCC_EXPR_NODE_LITERAL:
+		if (node->literal == 2) {
+			return tcc_text_buf_appendf(out, "%*s%s v%d = (%s)%.17g; int n%d = 0;\n", indent, "", ct, k, ct,
+			                            node->fval, k);
+		}
+		return tcc_text_buf_appendf(out, "%*s%s v%d = (%s)%lldLL; int n%d = 0;\n", indent, "", ct, k, ct,
+		                            (long long)node->ival, k);
+	case TCC_EXPR_NODE_NULL:
+		return tcc_text_buf_appendf(out, "%*sint v%d = 0; int n%d = 1;\n", indent, "", k, k);
+	case TCC_EXPR_NODE_NOT:
+		return tcc_expr_emit(p, a, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*sint v%d = !v%d; int n%d = n%d;\n", indent, "", k, a, k, a);
+	case TCC_EXPR_NODE_IS_NULL:
+		return tcc_expr_emit(p, a, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*sint v%d = %sn%d; int n%d = 0;\n", indent, "", k,
+		                            node->op[0] == '!' ? "!" : "", a, k);
+	case TCC_EXPR_NODE_NEG:
+	case TCC_EXPR_NODE_ABS: {
+		const char *min_c;
+		const char *max_c;
+		int64_t min_v;
+		int64_t max_v;
+		bool is_abs = node->kind == TCC_EXPR_NODE_ABS;
+		if (!tcc_expr_emit(p, a, out, indent) ||
+		    !tcc_text_buf_appendf(out, "%*s%s v%d = 0; int n%d = n%d;\n%*sif (!n%d) {\n", indent, "", ct, k, k, a,
+		                          indent, "", k)) {
+			return false;
+		}
+		if (node->type == TCC_FFI_VOID) {
+			/* untyped NULL operand: n<k> is already set */
+		} else if (tcc_expr_type_is_signed(node->type)) {
+			tcc_expr_int_limits(node->type, &min_c, &max_c, &min_v, &max_v);
+			if (!tcc_text_buf_appendf(out, "%*sif ((int64_t)v%d == %s) return 0;\n", in, "", a, min_c)) {
+				return false;
+			}
+			if (is_abs ? !tcc_text_buf_appendf(out, "%*sv%d = v%d < 0 ? (%s)-v%d : v%d;\n", in, "", k, a, ct, a, a)
+			           : !tcc_text_buf_appendf(out, "%*sv%d = (%s)-v%d;\n", in, "", k, ct, a)) {
+				return false;
+			}
+		} else if (tcc_expr_type_is_float(node->type)) {
+			if (!tcc_text_buf_appendf(out, is_abs ? "%*sv%d = v%d < 0 ? -v%d : v%d;\n" : "%*sv%d = -v%d;\n", in, "",
+			                          k, a, a, a)) {
+				return false;
+			}
+		} else if (is_abs) {
+			if (!tcc_text_buf_appendf(out, "%*sv%d = v%d;\n", in, "", k, a)) {
+				return false;
 			}
+		} else if (!tcc_text_buf_appendf(out, "%*sv%d = (%s)(0 - v%d);\n", in, "", k, ct, a)) {
+			return false;
 		}
-		if (!ok) {
-			tcc_set_error(error_buf, "out of memory");
-			tcc_text_buf_destroy(&src);
-			return NULL;
+		return tcc_text_buf_appendf(out, "%*s}\n", indent, "");
+	}
+	case TCC_EXPR_NODE_ARITH:
+		return tcc_expr_emit(p, a, out, indent) && tcc_expr_emit(p, b, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*s%s v%d = 0; int n%d = n%d || n%d;\n%*sif (!n%d) {\n", indent, "", ct, k,
+		                            k, a, b, indent, "", k) &&
+		       tcc_expr_emit_arith(out, in, k, node) && tcc_text_buf_appendf(out, "%*s}\n", indent, "");
+	case TCC_EXPR_NODE_COMPARE: {
+		const char *c_op = strcmp(node->op, "=") == 0 ? "==" : strcmp(node->op, "<>") == 0 ? "!=" : node->op;
+		const char *oct = tcc_expr_c_type(node->operand_type);
+		if (!tcc_expr_emit(p, a, out, indent) || !tcc_expr_emit(p, b, out, indent) ||
+		    !tcc_text_buf_appendf(out, "%*sint v%d = 0; int n%d = n%d || n%d;\n%*sif (!n%d) ", indent, "", k, k, a, b,
+		                          indent, "", k)) {
+			return false;
 		}
+		if (tcc_expr_type_is_float(node->operand_type)) {
+			return tcc_text_buf_appendf(out, "v%d = ducktinycc_expr_cmp((double)(%s)v%d, (double)(%s)v%d) %s 0;\n", k,
+			                            oct, a, oct, b, c_op);
+		}
+		return tcc_text_buf_appendf(out, "v%d = (%s)v%d %s (%s)v%d;\n", k, oct, a, c_op, oct, b);
+	}
+	case TCC_EXPR_NODE_AND:
+	case TCC_EXPR_NODE_OR: {
+		/* Three-valued logic: a decided left side (FALSE for AND, TRUE for OR) skips the right side. */
+		int decided = node->kind == TCC_EXPR_NODE_OR;
+		return tcc_expr_emit(p, a, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*sint v%d = %d; int n%d = 0;\n%*sif (n%d || v%d != %d) {\n", indent, "", k,
+		                            decided, k, indent, "", a, a, decided) &&
+		       tcc_expr_emit(p, b, out, in) &&
+		       tcc_text_buf_appendf(out,
+		                            "%*sif (!n%d && v%d == %d) v%d = %d;\n"
+		                            "%*selse if (n%d || n%d) n%d = 1;\n"
+		                            "%*selse v%d = %d;\n"
+		                            "%*s}\n",
+		                            in, "", b, b, decided, k, decided, in, "", a, b, k, in, "", k, !decided, indent,
+		                            "");
+	}
+	case TCC_EXPR_NODE_IF:
+		return tcc_expr_emit(p, a, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*s%s v%d = 0; int n%d = 1;\n%*sif (!n%d && v%d) {\n", indent, "", ct, k, k,
+		                            indent, "", a, a) &&
+		       tcc_expr_emit(p, b, out, in) &&
+		       tcc_text_buf_appendf(out, "%*sv%d = (%s)v%d; n%d = n%d;\n%*s} else {\n", in, "", k, ct, b, k, b,
+		                            indent, "") &&
+		       tcc_expr_emit(p, c, out, in) &&
+		       tcc_text_buf_appendf(out, "%*sv%d = (%s)v%d; n%d = n%d;\n%*s}\n", in, "", k, ct, c, k, c, indent, "");
+	case TCC_EXPR_NODE_COALESCE:
+		return tcc_expr_emit(p, a, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*s%s v%d = (%s)v%d; int n%d = n%d;\n%*sif (n%d) {\n", indent, "", ct, k,
+		                            ct, a, k, a, indent, "", k) &&
+		       tcc_expr_emit(p, b, out, in) &&
+		       tcc_text_buf_appendf(out, "%*sv%d = (%s)v%d; n%d = n%d;\n%*s}\n", in, "", k, ct, b, k, b, indent, "");
+	case TCC_EXPR_NODE_CAST:
+		return tcc_expr_emit(p, a, out, indent) &&
+		       tcc_text_buf_appendf(out, "%*s%s v%d = 0; int n%d = n%d;\n%*sif (!n%d) {\n", indent, "", ct, k, k, a,
+		                            indent, "", k) &&
+		       tcc_expr_emit_cast(out, in, k, p->nodes[a].type, a, node->type) &&
+		       tcc_text_buf_appendf(out, "%*s}\n", indent, "");
 	}
-	if (!src.data) {
+	return false;
+}
+
+/**
+ * @function tcc_expr_parse_signature
+ * @brief Splits `arg_types := ['name:type', ...]` into column names and types.
+ * @param[in] csv Joined `arg_types` list (may be NULL for a constant expression).
+ * @param[out] names Receives the column names (the tokens truncated at ':').
+ * @param[out] out_types Receives a duckdb_malloc'd type array (NULL when there are no columns).
+ * @param[out] error_buf Error buffer.
+ * @return true on success.
+ * @ownership transfers(names items and *out_types to caller)
+ * @heap caller releases with tcc_string_list_destroy and duckdb_free.
+ */
+static bool tcc_expr_parse_signature(const char *csv, tcc_string_list_t *names, tcc_ffi_type_t **out_types,
+                                     tcc_error_buffer_t *error_buf) {
+	tcc_ffi_type_t *types;
+	idx_t i;
+	idx_t j;
+	*out_types = NULL;
+	if (!csv || csv[0] == '\0') {
+		return true;
+	}
+	if (!tcc_split_csv_tokens(csv, names, error_buf)) {
+		return false;
+	}
+	types = (tcc_ffi_type_t *)duckdb_malloc(sizeof(tcc_ffi_type_t) * (size_t)(names->count ? names->count : 1));
+	if (!types) {
 		tcc_set_error(error_buf, "out of memory");
-		return NULL;
+		return false;
 	}
-	{
-		char *out = tcc_strdup(src.data);
-		tcc_text_buf_destroy(&src);
-		if (!out) {
-			tcc_set_error(error_buf, "out of memory");
+	for (i = 0; i < names->count; i++) {
+		char *item = names->items[i];
+		char *colon = strchr(item, ':');
+		char *type_name;
+		if (!colon || colon == item) {
+			snprintf(error_buf->message, sizeof(error_buf->message),
+			         "arg_types entry '%s' must be 'name:type' for compile_expr", item);
+			duckdb_free(types);
+			return false;
+		}
+		*colon = '\0';
+		type_name = colon + 1;
+		tcc_trim_inplace(item);
+		tcc_trim_inplace(type_name);
+		if (!tcc_expr_lookup_type_name(type_name, strlen(type_name), &types[i])) {
+			snprintf(error_buf->message, sizeof(error_buf->message),
+			         "unsupported type '%s' for column '%s' (numeric and BOOLEAN types only)", type_name, item);
+			duckdb_free(types);
+			return false;
+		}
+		for (j = 0; j < i; j++) {
+			if (tcc_equals_ci(names->items[j], item)) {
+				snprintf(error_buf->message, sizeof(error_buf->message), "duplicate column name '%s'", item);
+				duckdb_free(types);
+				return false;
+			}
 		}
-		return out;
 	}
+	*out_types = types;
+	return true;
 }
 
-static char *tcc_generate_c_enum_helpers_source(const char *enum_name, const char *prefix,
-                                                const tcc_string_list_t *constants, tcc_error_buffer_t *error_buf) {
-	tcc_text_buf_t src = {0};
-	idx_t i;
-	if (!enum_name || !prefix || !constants) {
-		tcc_set_error(error_buf, "invalid enum helper arguments");
-		return NULL;
+/**
+ * @function tcc_expr_build_kernel
+ * @brief Emits the compilation unit for a typed expression tree: runtime helpers, the batch kernel and its module init.
+ * @param[in] p Parser holding the typed node pool and column types.
+ * @param[in] root Root node (already cast to the return type).
+ * @param[in] entry_symbol Kernel name.
+ * @param[in] module_symbol Module init name.
+ * @param[in] sql_name Registered SQL function name.
+ * @param[in] stability_token Stability passed to ducktinycc_register_signature.
+ * @param[out] out Receives the compilation unit text.
+ * @return false on allocation failure.
+ * @ownership borrows(p, names), transfers(out->data to caller)
+ * @heap allocates via tcc_text_buf_appendf; caller releases with tcc_text_buf_destroy.
+ * @note The kernel uses the `chunk_scalar_loop` batch ABI and returns 0 on integer overflow or an
+ * out-of-range cast, which aborts the query the way DuckDB's own arithmetic does.
+ */
+static bool tcc_expr_build_kernel(tcc_expr_parser_t *p, int root, const char *entry_symbol, const char *module_symbol,
+                                  const char *sql_name, const char *stability_token, tcc_text_buf_t *out) {
+	tcc_text_buf_t args_csv = {0};
+	tcc_ffi_type_t ret_type = p->nodes[root].type;
+	const char *ret_c_type = tcc_ffi_type_to_c_type_name(ret_type);
+	int i;
+	bool ok = tcc_text_buf_appendf(
+	    out,
+	    "#include <stdint.h>\n"
+	    "typedef struct _duckdb_connection *duckdb_connection;\n"
+	    "extern _Bool ducktinycc_register_signature(duckdb_connection con, const char *name, void *fn_ptr, "
+	    "const char *return_type, const char *arg_types_csv, const char *wrapper_mode, const char *stability);\n"
+	    "extern double ducktinycc_fmod(double a, double b);\n"
+	    "static int ducktinycc_expr_add_i64(int64_t a, int64_t b, int64_t *r) {\n"
+	    "  if ((b > 0 && a > 9223372036854775807LL - b) || (b < 0 && a < (-9223372036854775807LL - 1) - b)) return 0;\n"
+	    "  *r = a + b;\n"
+	    "  return 1;\n"
+	    "}\n"
+	    "static int ducktinycc_expr_sub_i64(int64_t a, int64_t b, int64_t *r) {\n"
+	    "  if ((b < 0 && a > 9223372036854775807LL + b) || (b > 0 && a < (-9223372036854775807LL - 1) + b)) return 0;\n"
+	    "  *r = a - b;\n"
+	    "  return 1;\n"
+	    "}\n"
+	    "static int ducktinycc_expr_mul_i64(int64_t a, int64_t b, int64_t *r) {\n"
+	    "  int64_t t;\n"
+	    "  if (a == 0 || b == 0) { *r = 0; return 1; }\n"
+	    "  if ((a == -1 && b == (-9223372036854775807LL - 1)) || (b == -1 && a == (-9223372036854775807LL - 1))) "
+	    "return 0;\n"
+	    "  t = (int64_t)((uint64_t)a * (uint64_t)b);\n"
+	    "  if (t / b != a) return 0;\n"
+	    "  *r = t;\n"
+	    "  return 1;\n"
+	    "}\n"
+	    "static int ducktinycc_expr_add_u64(uint64_t a, uint64_t b, uint64_t *r) {\n"
+	    "  if (a + b < a) return 0;\n"
+	    "  *r = a + b;\n"
+	    "  return 1;\n"
+	    "}\n"
+	    "static int ducktinycc_expr_sub_u64(uint64_t a, uint64_t b, uint64_t *r) {\n"
+	    "  if (a < b) return 0;\n"
+	    "  *r = a - b;\n"
+	    "  return 1;\n"
+	    "}\n"
+	    "static int ducktinycc_expr_mul_u64(uint64_t a, uint64_t b, uint64_t *r) {\n"
+	    "  uint64_t t = a * b;\n"
+	    "  if (a != 0 && t / a != b) return 0;\n"
+	    "  *r = t;\n"
+	    "  return 1;\n"
+	    "}\n"
+	    "static int ducktinycc_expr_cmp(double a, double b) {\n"
+	    "  if (a != a) return b != b ? 0 : 1;\n"
+	    "  if (b != b) return -1;\n"
+	    "  return a < b ? -1 : (a > b ? 1 : 0);\n"
+	    "}\n"
+	    "static double ducktinycc_expr_rint(double x) {\n"
+	    "  if (x != x || x >= 4503599627370496.0 || x <= -4503599627370496.0) return x;\n"
+	    "  return x >= 0 ? (x + 4503599627370496.0) - 4503599627370496.0 : (x - 4503599627370496.0) + "
+	    "4503599627370496.0;\n"
+	    "}\n"
+	    "_Bool %s(void **arg_data, uint64_t **arg_validity, uint64_t count, void *out_data, uint64_t "
+	    "*out_validity) {\n",
+	    entry_symbol);
+	for (i = 0; i < p->arg_count && ok; i++) {
+		const char *col_c_type = p->arg_types[i] == TCC_FFI_BOOL ? "uint8_t" : tcc_ffi_type_to_c_type_name(p->arg_types[i]);
+		ok = tcc_text_buf_appendf(out,
+		                          "  const %s *c%d = (const %s *)arg_data[%d];\n"
+		                          "  const uint64_t *m%d = arg_validity[%d];\n",
+		                          col_c_type, i, col_c_type, i, i, i) &&
+		     tcc_text_buf_appendf(&args_csv, "%s%s", i == 0 ? "" : ",", tcc_ffi_type_to_token(p->arg_types[i]));
+	}
+	ok = ok &&
+	     tcc_text_buf_appendf(out,
+	                          "  %s *out = (%s *)out_data;\n"
+	                          "  for (uint64_t row = 0; row < count; row++) {\n",
+	                          ret_c_type, ret_c_type) &&
+	     tcc_expr_emit(p, root, out, 4) &&
+	     tcc_text_buf_appendf(out,
+	                          "    if (n%d) {\n"
+	                          "      if (out_validity) { out_validity[row >> 6] &= ~(1ULL << (row & 63)); }\n"
+	                          "      continue;\n"
+	                          "    }\n"
+	                          "    out[row] = (%s)v%d;\n"
+	                          "  }\n"
+	                          "  return 1;\n"
+	                          "}\n"
+	                          "_Bool %s(duckdb_connection con) {\n"
+	                          "  return ducktinycc_register_signature(con, \"%s\", (void *)%s, \"%s\", \"%s\", "
+	                          "\"chunk_scalar_loop\", \"%s\");\n"
+	                          "}\n",
+	                          root, ret_c_type, root, module_symbol, sql_name, entry_symbol,
+	                          tcc_ffi_type_to_token(ret_type), args_csv.data ? args_csv.data : "", stability_token);
+	tcc_text_buf_destroy(&args_csv);
+	return ok;
+}
+#endif
+
+/**
+ * @function tcc_mode_compile_expr
+ * @brief Handles `mode := 'compile_expr'` and `tcc_compile_expr(...)`: compiles a SQL scalar expression into a registered batch UDF.
+ * @param[in,out] state Module state (write lock held by the dispatcher).
+ * @param[in] bind Bind data with `sql_name`, `expr`, `arg_types` ('name:type' entries) and optional `return_type`/`stability`.
+ * @param[in] runtime_path Effective TinyCC runtime path.
+ * @param[out] output Result chunk (one row); `detail` carries the generated C source on success.
+ * @ownership borrows(state, bind, runtime_path), transfers(artifact to registry on success)
+ * @errors E_MISSING_ARGS, E_BAD_SIGNATURE, E_BAD_STABILITY, E_BAD_EXPR, E_COMPILE_FAILED, E_INIT_FAILED, E_STORE_FAILED
+ * @note Supports column references, numeric/boolean literals, NULL, arithmetic (+ - * / // %),
+ * comparisons, AND/OR/NOT, IS [NOT] NULL, CASE, COALESCE, CAST/`::` and ABS over the bool and
+ * numeric types, with DuckDB's result types, NULL propagation and overflow errors. Decimal
+ * literals are evaluated as DOUBLE (FLOAT next to a FLOAT operand) rather than DECIMAL.
+ * The kernel is registered with special NULL handling so constant NULL arguments reach it.
+ */
+static void tcc_mode_compile_expr(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
+                                  const char *runtime_path, duckdb_data_chunk output) {
+#ifdef DUCKTINYCC_WASM_UNSUPPORTED
+	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
+	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, NULL, NULL,
+	              "database");
+#else
+	const char *sql_name = bind->sql_name;
+	tcc_string_list_t names;
+	tcc_ffi_type_t *types = NULL;
+	tcc_ffi_type_t ret_type = TCC_FFI_VOID;
+	tcc_function_stability_t stability;
+	tcc_expr_parser_t parser;
+	tcc_text_buf_t unit = {0};
+	tcc_registered_artifact_t *artifact = NULL;
+	tcc_error_buffer_t err;
+	tcc_compile_timings_t timings;
+	char entry_symbol[128];
+	char module_symbol[128];
+	char artifact_id[256];
+	const char *phase = "compile";
+	const char *code = "E_COMPILE_FAILED";
+	const char *message = "compile failed";
+	uint64_t t_start = tcc_now_ns();
+	uint64_t t_phase;
+	uint64_t t_register;
+	int root;
+	int rc;
+	memset(&names, 0, sizeof(names));
+	memset(&parser, 0, sizeof(parser));
+	memset(&err, 0, sizeof(err));
+	memset(&timings, 0, sizeof(timings));
+
+	if (!sql_name || sql_name[0] == '\0' || !bind->expr || bind->expr[0] == '\0') {
+		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "sql_name and expr are required", NULL,
+		              sql_name, NULL, NULL, "database");
+		return;
 	}
-	if (!tcc_text_buf_appendf(&src, "unsigned long long %s_sizeof(void){ return (unsigned long long)sizeof(enum %s); }\n",
-	                          prefix, enum_name)) {
-		tcc_set_error(error_buf, "out of memory");
-		tcc_text_buf_destroy(&src);
-		return NULL;
+	if (tcc_registry_find_sql_name(state, sql_name) != (idx_t)-1) {
+		tcc_write_row(output, false, bind->mode, "load", "E_INIT_FAILED", "generated module init returned false",
+		              "sql_name already registered; use tcc_new_state to reset", sql_name, NULL, NULL, "database");
+		return;
 	}
-	for (i = 0; i < constants->count; i++) {
-		if (!tcc_text_buf_appendf(&src, "long long %s_%s(void){ return (long long)(%s); }\n", prefix,
-		                          constants->items[i], constants->items[i])) {
-			tcc_set_error(error_buf, "out of memory");
-			tcc_text_buf_destroy(&src);
-			return NULL;
-		}
+	if (!tcc_expr_parse_signature(bind->arg_types, &names, &types, &err) ||
+	    (bind->return_type && bind->return_type[0] != '\0' &&
+	     !tcc_expr_lookup_type_name(bind->return_type, strlen(bind->return_type), &ret_type))) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_SIGNATURE", "invalid compile_expr signature",
+		              err.message[0] ? err.message : "return_type must be a numeric or BOOLEAN type", sql_name, NULL,
+		              NULL, "database");
+		tcc_string_list_destroy(&names);
+		duckdb_free(types);
+		return;
 	}
-	if (!src.data) {
-		tcc_set_error(error_buf, "out of memory");
-		return NULL;
+	if (!tcc_parse_function_stability(tcc_effective_stability(state, bind), &stability, &err)) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_STABILITY", "invalid stability",
+		              err.message[0] ? err.message : NULL, sql_name, NULL, NULL, "database");
+		tcc_string_list_destroy(&names);
+		duckdb_free(types);
+		return;
 	}
-	{
-		char *out = tcc_strdup(src.data);
-		tcc_text_buf_destroy(&src);
-		if (!out) {
-			tcc_set_error(error_buf, "out of memory");
+
+	t_phase = tcc_now_ns();
+	parser.src = bind->expr;
+	parser.arg_names = &names;
+	parser.arg_types = types;
+	parser.arg_count = (int)names.count;
+	parser.err = &err;
+	tcc_expr_next(&parser);
+	root = tcc_expr_parse_expr(&parser);
+	if (root >= 0 && parser.tok != TCC_EXPR_TOK_END) {
+		root = tcc_expr_fail(&parser, "unexpected trailing input");
+	}
+	if (root >= 0 && bind->return_type && bind->return_type[0] != '\0' && parser.nodes[root].type != ret_type) {
+		if (parser.nodes[root].type == TCC_FFI_BOOL && ret_type != TCC_FFI_BOOL) {
+			root = tcc_expr_fail(&parser, "cannot cast a BOOLEAN result to a numeric return_type");
+		} else {
+			root = tcc_expr_make(&parser, TCC_EXPR_NODE_CAST, ret_type, root, -1, -1);
 		}
-		return out;
 	}
+	if (root >= 0 && parser.nodes[root].type == TCC_FFI_VOID) {
+		root = tcc_expr_fail(&parser, "expression type is unknown (untyped NULL); pass return_type");
+	}
+	timings.parse_ns = tcc_now_ns() - t_phase;
+	if (root < 0) {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_EXPR", "invalid expression",
+		              err.message[0] ? err.message : NULL, sql_name, NULL, NULL, "database");
+		duckdb_free(parser.nodes);
+		tcc_string_list_destroy(&names);
+		duckdb_free(types);
+		return;
+	}
+
+	t_phase = tcc_now_ns();
+	snprintf(entry_symbol, sizeof(entry_symbol), "__ducktinycc_expr_%llu_%llu",
+	         (unsigned long long)state->session.state_id, (unsigned long long)state->session.config_version);
+	snprintf(module_symbol, sizeof(module_symbol), "__ducktinycc_expr_init_%llu_%llu",
+	         (unsigned long long)state->session.state_id, (unsigned long long)state->session.config_version);
+	if (!tcc_expr_build_kernel(&parser, root, entry_symbol, module_symbol, sql_name,
+	                           tcc_function_stability_token(stability), &unit)) {
+		tcc_set_error(&err, "out of memory");
+	}
+	duckdb_free(parser.nodes);
+	tcc_string_list_destroy(&names);
+	duckdb_free(types);
+	timings.codegen_ns = tcc_now_ns() - t_phase;
+	tcc_registering_special_nulls = true;
+	rc = err.message[0] == '\0' ? tcc_codegen_load_unit(runtime_path, state, bind, unit.data, sql_name, module_symbol,
+	                                                     &artifact, &err, &timings)
+	                            : -1;
+	tcc_registering_special_nulls = false;
+	if (rc != 0) {
+		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, code, false, &timings);
+		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
+		              sql_name, entry_symbol, NULL, "database");
+		tcc_write_timings_col(output, &timings);
+		tcc_text_buf_destroy(&unit);
+		return;
+	}
+	t_register = tcc_now_ns();
+	if (!tcc_registry_store_metadata(state, sql_name, module_symbol, artifact->state_id, artifact)) {
+		tcc_artifact_destroy(artifact);
+		timings.total_ns = tcc_now_ns() - t_start;
+		tcc_compile_stats_record(state, bind->mode, sql_name, "E_STORE_FAILED", false, &timings);
+		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED",
+		              "failed to store ffi module artifact metadata", NULL, sql_name, entry_symbol, NULL,
+		              "connection");
+		tcc_write_timings_col(output, &timings);
+		tcc_text_buf_destroy(&unit);
+		return;
+	}
+	timings.register_ns += tcc_now_ns() - t_register;
+	timings.total_ns = tcc_now_ns() - t_start;
+	tcc_compile_stats_record(state, bind->mode, sql_name, "OK", true, &timings);
+	snprintf(artifact_id, sizeof(artifact_id), "%s@ffi_state_%llu", sql_name,
+	         (unsigned long long)artifact->state_id);
+	tcc_write_row(output, true, bind->mode, "load", "OK", "compiled expression into a SQL function", unit.data,
+	              sql_name, entry_symbol, artifact_id, "database");
+	tcc_write_timings_col(output, &timings);
+	tcc_text_buf_destroy(&unit);
+#endif
 }
 
-/* tcc_build_c_composite_bindings: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
-static bool tcc_build_c_composite_bindings(const char *prefix, const tcc_c_field_list_t *fields,
-                                           tcc_helper_binding_list_t *out_bindings, tcc_error_buffer_t *error_buf) {
-	idx_t i;
-	if (!prefix || !fields || !out_bindings) {
-		tcc_set_error(error_buf, "invalid helper binding arguments");
-		return false;
+/* Main dispatcher for all `tcc_module(...)` modes. */
+static void tcc_module_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_function_get_extra_info(info);
+	tcc_module_bind_data_t *bind = (tcc_module_bind_data_t *)duckdb_function_get_bind_data(info);
+	tcc_module_init_data_t *init = (tcc_module_init_data_t *)duckdb_function_get_init_data(info);
+	const char *runtime_path;
+	int lock_mode = 0; /* 0 none, 1 read, 2 write */
+	bool expected_not_emitted = false;
+
+	if (!state || !bind || !init) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
-#define TCC_ADD_BINDING_FORMAT(RET_TOKEN, ARG_CSV, STABILITY, SUFFIX_FMT, ...)                                           \
-	do {                                                                                                                  \
-		if (!tcc_format_cstr(suffix, sizeof(suffix), SUFFIX_FMT, __VA_ARGS__) ||                                         \
-		    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, suffix, RET_TOKEN, ARG_CSV, STABILITY)) {       \
-			tcc_set_error(error_buf, "out of memory");                                                                    \
-			return false;                                                                                                 \
-		}                                                                                                                 \
-	} while (0)
-	char suffix[512];
-	if (!tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "sizeof", "u64", "", "consistent") ||
-	    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "alignof", "u64", "", "consistent") ||
-	    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "new", "ptr", "", "volatile") ||
-	    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "free", "void", "ptr", "volatile")) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
+	if (!atomic_compare_exchange_strong_explicit(&init->emitted, &expected_not_emitted, true, memory_order_acq_rel,
+	                                             memory_order_acquire)) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
-	for (i = 0; i < fields->count; i++) {
-		const tcc_c_field_spec_t *field = &fields->items[i];
-		const char *token = tcc_ffi_type_to_token(field->type);
-		char arg_csv[128];
-		if (!token) {
-			tcc_set_error(error_buf, "field type token is unsupported for helper bindings");
-			return false;
+	if (tcc_mode_requires_write_lock(bind->mode)) {
+		tcc_rwlock_write_lock(&state->lock);
+		lock_mode = 2;
+	} else {
+		tcc_rwlock_read_lock(&state->lock);
+		lock_mode = 1;
+	}
+
+	runtime_path = tcc_session_runtime_path(state, bind->runtime_path);
+	if (strcmp(bind->mode, "config_set") == 0) {
+		tcc_session_set_runtime_path(&state->session, bind->runtime_path);
+		tcc_write_row(output, true, bind->mode, "config", "OK", "session runtime updated",
+		              state->session.runtime_path ? state->session.runtime_path : "(empty)", NULL, NULL, NULL,
+		              "connection");
+	} else if (strcmp(bind->mode, "config_get") == 0) {
+		char detail[256];
+		snprintf(detail, sizeof(detail), "runtime=%s state_id=%llu config_version=%llu",
+		         runtime_path ? runtime_path : "(unset)", (unsigned long long)state->session.state_id,
+		         (unsigned long long)state->session.config_version);
+		tcc_write_row(output, true, bind->mode, "config", "OK", "session configuration", detail, NULL, NULL, NULL,
+		              "connection");
+	} else if (strcmp(bind->mode, "config_reset") == 0) {
+		tcc_session_set_runtime_path(&state->session, NULL);
+		tcc_session_clear_build_state(&state->session);
+		tcc_write_row(output, true, bind->mode, "config", "OK", "session reset", "runtime/build state cleared",
+		              NULL, NULL, NULL, "database");
+	} else if (strcmp(bind->mode, "tcc_new_state") == 0) {
+		char detail[128];
+		tcc_session_clear_build_state(&state->session);
+		snprintf(detail, sizeof(detail), "state_id=%llu", (unsigned long long)state->session.state_id);
+		tcc_write_row(output, true, bind->mode, "state", "OK", "new TinyCC build state prepared", detail, NULL,
+		              NULL, NULL, "database");
+	} else if (strcmp(bind->mode, "add_file") == 0) {
+		tcc_mode_add_file(state, bind, output);
+	} else if (strncmp(bind->mode, "add_", 4) == 0 && strcmp(bind->mode, "add_define") != 0 &&
+	           strcmp(bind->mode, "add_symbol") != 0) {
+		tcc_mode_add_staged(state, bind, output);
+	} else if (strcmp(bind->mode, "add_define") == 0) {
+		if (bind->define_name && bind->define_name[0] != '\0') {
+			const char *define_value = bind->define_value ? bind->define_value : "1";
+			if (tcc_string_list_append(&state->session.define_names, bind->define_name)) {
+				if (!tcc_string_list_append(&state->session.define_values, define_value)) {
+					(void)tcc_string_list_pop_last(&state->session.define_names);
+					tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to store define", NULL,
+					              NULL, NULL, NULL, "database");
+					goto tcc_module_done;
+				}
+				state->session.config_version++;
+				tcc_write_row(output, true, bind->mode, "state", "OK", "define added", bind->define_name, NULL, NULL,
+				              NULL, "database");
+			} else {
+				tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to store define", NULL,
+				              NULL, NULL, NULL, "database");
+			}
+		} else {
+			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "define_name is required", NULL, NULL,
+			              NULL, NULL, "database");
 		}
-		if (field->array_size > 0) {
-			if (!tcc_format_cstr(arg_csv, sizeof(arg_csv), "ptr,u64")) {
-				tcc_set_error(error_buf, "out of memory");
-				return false;
+	} else if (strcmp(bind->mode, "add_symbol") == 0) {
+		if (!bind->symbol_name || bind->symbol_name[0] == '\0') {
+			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "symbol_name is required", NULL,
+			              NULL, NULL, NULL, "database");
+		} else if (!bind->has_symbol_ptr) {
+			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "symbol_ptr is required", NULL,
+			              NULL, NULL, NULL, "database");
+		} else {
+			tcc_session_t *sess = &state->session;
+			if (sess->symbol_count >= sess->symbol_capacity) {
+				idx_t new_cap = sess->symbol_capacity == 0 ? 8 : sess->symbol_capacity * 2;
+				uint64_t *new_ptrs = (uint64_t *)duckdb_malloc(sizeof(uint64_t) * new_cap);
+				if (!new_ptrs) {
+					tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED",
+					              "failed to grow symbol pointer array", NULL, NULL, NULL, NULL, "database");
+					goto tcc_module_done;
+				}
+				if (sess->symbol_ptrs && sess->symbol_count > 0) {
+					memcpy(new_ptrs, sess->symbol_ptrs, sizeof(uint64_t) * sess->symbol_count);
+				}
+				if (sess->symbol_ptrs) {
+					duckdb_free(sess->symbol_ptrs);
+				}
+				sess->symbol_ptrs = new_ptrs;
+				sess->symbol_capacity = new_cap;
 			}
-			TCC_ADD_BINDING_FORMAT(token, arg_csv, "volatile", "get_%s_elt", field->name);
-			if (!tcc_format_cstr(arg_csv, sizeof(arg_csv), "ptr,u64,%s", token)) {
-				tcc_set_error(error_buf, "out of memory");
-				return false;
+			if (!tcc_string_list_append(&sess->symbol_names, bind->symbol_name)) {
+				tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED",
+				              "failed to store symbol name", NULL, NULL, NULL, NULL, "database");
+				goto tcc_module_done;
 			}
-			TCC_ADD_BINDING_FORMAT("ptr", arg_csv, "volatile", "set_%s_elt", field->name);
-			TCC_ADD_BINDING_FORMAT("u64", "", "consistent", "off_%s", field->name);
-			TCC_ADD_BINDING_FORMAT("ptr", "ptr", "consistent", "%s_addr", field->name);
+			sess->symbol_ptrs[sess->symbol_count] = bind->symbol_ptr;
+			sess->symbol_count++;
+			sess->config_version++;
+			{
+				char detail[128];
+				snprintf(detail, sizeof(detail), "ptr=0x%llx", (unsigned long long)bind->symbol_ptr);
+				tcc_write_row(output, true, bind->mode, "state", "OK", "symbol added", detail,
+				              NULL, bind->symbol_name, NULL, "database");
+			}
+		}
+	} else if (strcmp(bind->mode, "tinycc_bind") == 0) {
+		if (!bind->symbol || bind->symbol[0] == '\0') {
+			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "symbol is required", NULL,
+			              bind->sql_name, bind->symbol, NULL, "database");
 		} else {
-			TCC_ADD_BINDING_FORMAT(token, "ptr", "volatile", "get_%s", field->name);
-			if (!tcc_format_cstr(arg_csv, sizeof(arg_csv), "ptr,%s", token)) {
-				tcc_set_error(error_buf, "out of memory");
-				return false;
+			char *bound_symbol = NULL;
+			char *bound_sql_name = NULL;
+			char *bound_stability = NULL;
+			tcc_function_stability_t parsed_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
+			tcc_error_buffer_t err;
+			memset(&err, 0, sizeof(err));
+			if (bind->stability && bind->stability[0] != '\0' &&
+			    !tcc_parse_function_stability(bind->stability, &parsed_stability, &err)) {
+				tcc_write_row(output, false, bind->mode, "bind", "E_BAD_STABILITY", "invalid stability",
+				              err.message[0] ? err.message : NULL, bind->sql_name, bind->symbol, NULL, "database");
+				goto tcc_module_done;
 			}
-			TCC_ADD_BINDING_FORMAT("ptr", arg_csv, "volatile", "set_%s", field->name);
-			if (!field->is_bitfield) {
-				TCC_ADD_BINDING_FORMAT("u64", "", "consistent", "off_%s", field->name);
-				TCC_ADD_BINDING_FORMAT("ptr", "ptr", "consistent", "%s_addr", field->name);
+			bound_symbol = tcc_strdup(bind->symbol);
+			bound_sql_name = tcc_strdup(bind->sql_name && bind->sql_name[0] != '\0' ? bind->sql_name : bind->symbol);
+			if (bind->stability && bind->stability[0] != '\0') {
+				bound_stability = tcc_strdup(tcc_function_stability_token(parsed_stability));
 			}
+			if (!bound_symbol || !bound_sql_name || (bind->stability && bind->stability[0] != '\0' && !bound_stability)) {
+				if (bound_symbol) {
+					duckdb_free(bound_symbol);
+				}
+				if (bound_sql_name) {
+					duckdb_free(bound_sql_name);
+				}
+				if (bound_stability) {
+					duckdb_free(bound_stability);
+				}
+				tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to store symbol binding",
+				              NULL, bind->sql_name, bind->symbol, NULL, "database");
+				goto tcc_module_done;
+			}
+			tcc_session_clear_bind(&state->session);
+			state->session.bound_symbol = bound_symbol;
+			state->session.bound_sql_name = bound_sql_name;
+			state->session.bound_stability = bound_stability;
+			state->session.config_version++;
+			tcc_write_row(output, true, bind->mode, "bind", "OK", "symbol binding updated",
+			              state->session.bound_stability ? state->session.bound_stability : "consistent",
+			              state->session.bound_sql_name, state->session.bound_symbol, NULL, "connection");
 		}
+	} else if (strcmp(bind->mode, "list") == 0) {
+		char detail[256];
+		snprintf(detail, sizeof(detail),
+		         "registered=%llu sources=%llu headers=%llu includes=%llu libs=%llu symbols=%llu state_id=%llu", 
+		         (unsigned long long)state->entry_count, (unsigned long long)state->session.sources.count,
+		         (unsigned long long)state->session.headers.count, (unsigned long long)state->session.include_paths.count,
+		         (unsigned long long)state->session.libraries.count,
+		         (unsigned long long)state->session.symbol_count, (unsigned long long)state->session.state_id);
+		tcc_write_row(output, true, bind->mode, "registry", "OK", "session summary", detail, NULL, NULL, NULL,
+		              "connection");
+	} else if (strcmp(bind->mode, "c_struct") == 0 || strcmp(bind->mode, "c_union") == 0 ||
+	           strcmp(bind->mode, "c_bitfield") == 0 || strcmp(bind->mode, "c_enum") == 0) {
+		tcc_mode_c_helpers(state, bind, runtime_path, output);
+	} else if (strcmp(bind->mode, "codegen_preview") == 0) {
+		tcc_mode_codegen_preview(state, bind, output);
+	} else if (strcmp(bind->mode, "compile") == 0 || strcmp(bind->mode, "quick_compile") == 0) {
+		tcc_mode_compile(state, bind, runtime_path, output);
+	} else if (strcmp(bind->mode, "fuse") == 0) {
+		tcc_mode_fuse(state, bind, runtime_path, output);
+	} else if (strcmp(bind->mode, "compile_expr") == 0) {
+		tcc_mode_compile_expr(state, bind, runtime_path, output);
+	} else if (strcmp(bind->mode, "file_reader") == 0) {
+		tcc_mode_file_reader(state, bind, runtime_path, output);
+	} else if (strcmp(bind->mode, "sink") == 0) {
+		tcc_mode_sink(state, bind, runtime_path, output);
+	} else if (strcmp(bind->mode, "bench") == 0) {
+		/* tcc_mode_bench releases the read lock itself before running the UDF. */
+		lock_mode = 0;
+		tcc_mode_bench(state, bind, output);
+	} else if (strcmp(bind->mode, "code_info") == 0) {
+		tcc_mode_code_info(state, bind, output);
+	} else {
+		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_MODE", "unknown mode", NULL, NULL, NULL, NULL,
+		              "connection");
 	}
-#undef TCC_ADD_BINDING_FORMAT
-	return true;
-}
-
-/* tcc_build_c_enum_bindings: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
-static bool tcc_build_c_enum_bindings(const char *prefix, const tcc_string_list_t *constants,
-                                      tcc_helper_binding_list_t *out_bindings, tcc_error_buffer_t *error_buf) {
-	idx_t i;
-	char suffix[512];
-	if (!prefix || !constants || !out_bindings) {
-		tcc_set_error(error_buf, "invalid enum binding arguments");
-		return false;
-	}
-	if (!tcc_helper_binding_list_add_prefixed(out_bindings, prefix, "sizeof", "u64", "", "consistent")) {
-		tcc_set_error(error_buf, "out of memory");
-		return false;
-	}
-	for (i = 0; i < constants->count; i++) {
-		if (!tcc_format_cstr(suffix, sizeof(suffix), "%s", constants->items[i]) ||
-		    !tcc_helper_binding_list_add_prefixed(out_bindings, prefix, suffix, "i64", "", "consistent")) {
-			tcc_set_error(error_buf, "out of memory");
-			return false;
-		}
-	}
-	return true;
-}
-
-#ifndef DUCKTINYCC_WASM_UNSUPPORTED
-/* tcc_codegen_compile_and_load_module: Codegen helper for wrapper source assembly and compile/load orchestration. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static int tcc_codegen_compile_and_load_module(const char *runtime_path, tcc_module_state_t *state,
-                                               const tcc_module_bind_data_t *bind, const char *sql_name,
-                                               const char *target_symbol, tcc_registered_artifact_t **out_artifact,
-                                               tcc_error_buffer_t *error_buf, char *out_module_symbol, size_t symbol_len) {
-	tcc_codegen_source_ctx_t source_ctx;
-	tcc_module_bind_data_t bind_copy;
-	tcc_registered_artifact_t *artifact = NULL;
-
-	if (!state || !bind || !sql_name || !target_symbol || !out_artifact || !error_buf || !out_module_symbol ||
-	    symbol_len == 0) {
-		tcc_set_error(error_buf, "invalid codegen compile arguments");
-		return -1;
-	}
-	if (!state->connection) {
-		tcc_set_error(error_buf, "no persistent extension connection available");
-		return -1;
-	}
-	tcc_codegen_source_ctx_init(&source_ctx);
-	if (!tcc_codegen_prepare_sources(state, bind, sql_name, target_symbol, &source_ctx, error_buf)) {
-		tcc_codegen_source_ctx_destroy(&source_ctx);
-		return -1;
-	}
-	snprintf(out_module_symbol, symbol_len, "%s", source_ctx.module_symbol);
-
-	memset(&bind_copy, 0, sizeof(bind_copy));
-	bind_copy = *bind;
-	bind_copy.source = source_ctx.compilation_unit_source;
-	if (tcc_build_module_artifact(runtime_path, state, &bind_copy, out_module_symbol, sql_name, &artifact, error_buf) !=
-	    0) {
-		tcc_codegen_source_ctx_destroy(&source_ctx);
-		return -1;
-	}
-	tcc_codegen_source_ctx_destroy(&source_ctx);
 
-	if (!artifact->module_init(state->connection)) {
-		tcc_artifact_destroy(artifact);
-		tcc_set_error(error_buf, "generated module init returned false");
-		return -1;
+tcc_module_done:
+	if (lock_mode == 2) {
+		tcc_rwlock_write_unlock(&state->lock);
+	} else if (lock_mode == 1) {
+		tcc_rwlock_read_unlock(&state->lock);
 	}
-	*out_artifact = artifact;
-	return 0;
 }
-#endif
 
-#ifndef DUCKTINYCC_WASM_UNSUPPORTED
-/* tcc_compile_generated_binding: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: may allocate owned memory; caller or owning context must release via matching destroy path. */
-static bool tcc_compile_generated_binding(const char *runtime_path, tcc_module_state_t *state, const char *source,
-                                          const tcc_helper_binding_t *binding, tcc_error_buffer_t *error_buf) {
-	tcc_module_bind_data_t generated_bind;
-	tcc_registered_artifact_t *artifact = NULL;
-	char module_symbol[128];
-	if (!state || !binding || !source || !error_buf) {
-		tcc_set_error(error_buf, "invalid generated binding arguments");
-		return false;
-	}
-	memset(&generated_bind, 0, sizeof(generated_bind));
-	memset(module_symbol, 0, sizeof(module_symbol));
-	generated_bind.source = (char *)source;
-	generated_bind.symbol = binding->symbol;
-	generated_bind.sql_name = binding->sql_name;
-	generated_bind.arg_types = binding->arg_types_csv;
-	generated_bind.return_type = binding->return_type;
-	generated_bind.wrapper_mode = "row";
-	generated_bind.stability = binding->stability;
-	if (tcc_codegen_compile_and_load_module(runtime_path, state, &generated_bind, binding->sql_name, binding->symbol,
-	                                        &artifact, error_buf, module_symbol, sizeof(module_symbol)) != 0) {
-		return false;
-	}
-	if (!tcc_registry_store_metadata(state, binding->sql_name, module_symbol, artifact->state_id, artifact)) {
-		tcc_artifact_destroy(artifact);
-		tcc_set_error(error_buf, "failed to store generated helper metadata");
-		return false;
+/* destroy_tcc_diag_bind_data: Destructor callback for DuckDB bind/init/extra-info payloads. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
+static void destroy_tcc_diag_bind_data(void *ptr) {
+	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)ptr;
+	if (!bind) {
+		return;
 	}
-	return true;
+	tcc_diag_rows_destroy(&bind->rows);
+	duckdb_free(bind);
 }
-#endif
 
-/* ===== Section: tcc_module Dispatcher ===== */
-/* Returns whether a mode mutates shared session/registry state. */
-static bool tcc_mode_requires_write_lock(const char *mode) {
-	if (!mode) {
-		return false;
+/* destroy_tcc_diag_init_data: Destructor callback for DuckDB bind/init/extra-info payloads. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
+static void destroy_tcc_diag_init_data(void *ptr) {
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)ptr;
+	if (!init) {
+		return;
 	}
-	return strcmp(mode, "config_set") == 0 || strcmp(mode, "config_reset") == 0 ||
-	       strcmp(mode, "tcc_new_state") == 0 || strcmp(mode, "add_include") == 0 ||
-	       strcmp(mode, "add_sysinclude") == 0 || strcmp(mode, "add_library_path") == 0 ||
-	       strcmp(mode, "add_library") == 0 || strcmp(mode, "add_option") == 0 ||
-	       strcmp(mode, "add_header") == 0 || strcmp(mode, "add_source") == 0 ||
-	       strcmp(mode, "add_define") == 0 || strcmp(mode, "add_symbol") == 0 ||
-	       strcmp(mode, "tinycc_bind") == 0 ||
-	       strcmp(mode, "compile") == 0 || strcmp(mode, "quick_compile") == 0 ||
-	       strcmp(mode, "c_struct") == 0 || strcmp(mode, "c_union") == 0 || strcmp(mode, "c_bitfield") == 0 ||
-	       strcmp(mode, "c_enum") == 0;
+	duckdb_free(init);
 }
 
-/* ===== Extracted mode handlers ===== */
-
-/* Handles add_include/add_sysinclude/add_library_path/add_library/add_option/add_header/add_source. */
-static void tcc_mode_add_staged(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
-                                duckdb_data_chunk output) {
-	const char *mode = bind->mode;
-	tcc_string_list_t *target = NULL;
-	const char *value = NULL;
-	const char *label = NULL;
-	const char *arg_name = NULL;
-	if (strcmp(mode, "add_include") == 0) {
-		target = &state->session.include_paths;
-		value = bind->include_path;
-		label = "include path added";
-		arg_name = "include_path";
-	} else if (strcmp(mode, "add_sysinclude") == 0) {
-		target = &state->session.sysinclude_paths;
-		value = bind->sysinclude_path;
-		label = "sysinclude path added";
-		arg_name = "sysinclude_path";
-	} else if (strcmp(mode, "add_library_path") == 0) {
-		target = &state->session.library_paths;
-		value = bind->library_path;
-		label = "library path added";
-		arg_name = "library_path";
-	} else if (strcmp(mode, "add_library") == 0) {
-		target = &state->session.libraries;
-		value = bind->library;
-		label = "library added";
-		arg_name = "library";
-	} else if (strcmp(mode, "add_option") == 0) {
-		target = &state->session.options;
-		value = bind->option;
-		label = "compiler option added";
-		arg_name = "option";
-	} else if (strcmp(mode, "add_header") == 0) {
-		target = &state->session.headers;
-		value = bind->header;
-		label = "header source added";
-		arg_name = "header";
-	} else if (strcmp(mode, "add_source") == 0) {
-		target = &state->session.sources;
-		value = bind->source;
-		label = "source appended";
-		arg_name = "source";
+/* tcc_diag_set_result_schema: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_diag_set_result_schema(duckdb_bind_info info) {
+	duckdb_logical_type bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
+	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_bind_add_result_column(info, "kind", varchar_type);
+	duckdb_bind_add_result_column(info, "key", varchar_type);
+	duckdb_bind_add_result_column(info, "value", varchar_type);
+	duckdb_bind_add_result_column(info, "exists", bool_type);
+	duckdb_bind_add_result_column(info, "detail", varchar_type);
+	duckdb_destroy_logical_type(&bool_type);
+	duckdb_destroy_logical_type(&varchar_type);
+}
+
+/* tcc_diag_table_init: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_diag_table_init(duckdb_init_info info) {
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_malloc(sizeof(tcc_diag_init_data_t));
+	if (!init) {
+		duckdb_init_set_error(info, "out of memory");
+		return;
 	}
-	if (!target) {
-		tcc_write_row(output, false, mode, "bind", "E_BAD_MODE", "unknown add mode", NULL, NULL, NULL, NULL,
-		              "database");
+	atomic_store_explicit(&init->offset, 0, memory_order_relaxed);
+	duckdb_init_set_init_data(info, init, destroy_tcc_diag_init_data);
+}
+
+/* tcc_diag_table_function: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_diag_table_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)duckdb_function_get_bind_data(info);
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_function_get_init_data(info);
+	tcc_diag_row_t *row;
+	duckdb_vector v_exists;
+	bool *exists_data;
+	uint64_t row_idx;
+	if (!bind || !init) {
+		duckdb_data_chunk_set_size(output, 0);
 		return;
 	}
-	if (value && tcc_string_list_append(target, value)) {
-		state->session.config_version++;
-		tcc_write_row(output, true, mode, "state", "OK", label, value, NULL, NULL, NULL, "database");
-	} else {
-		char msg[128];
-		snprintf(msg, sizeof(msg), "%s is required", arg_name);
-		tcc_write_row(output, false, mode, "bind", "E_MISSING_ARGS", msg, NULL, NULL, NULL, NULL, "database");
+	row_idx = atomic_fetch_add_explicit(&init->offset, 1, memory_order_acq_rel);
+	if ((idx_t)row_idx >= bind->rows.count) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
+	row = &bind->rows.rows[(idx_t)row_idx];
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 0), 0, row->kind);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), 0, row->key);
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 2), 0, row->value);
+	v_exists = duckdb_data_chunk_get_vector(output, 3);
+	exists_data = (bool *)duckdb_vector_get_data(v_exists);
+	exists_data[0] = row->exists;
+	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 4), 0, row->detail);
+	duckdb_data_chunk_set_size(output, 1);
 }
 
-/* Handles c_struct/c_union/c_bitfield/c_enum modes. */
-static void tcc_mode_c_helpers(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
-                               const char *runtime_path, duckdb_data_chunk output) {
-#ifdef DUCKTINYCC_WASM_UNSUPPORTED
-	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
-	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, bind->symbol,
-	              NULL, "database");
-#else
-	const bool is_enum = strcmp(bind->mode, "c_enum") == 0;
-	const bool is_union = strcmp(bind->mode, "c_union") == 0;
-	const bool force_bitfield = strcmp(bind->mode, "c_bitfield") == 0;
-	const char *kind_keyword = is_union ? "union" : "struct";
-	const char *type_name = bind->symbol;
-	char prefix_buf[256];
-	const char *prefix = NULL;
-	tcc_error_buffer_t err;
-	tcc_c_field_list_t fields;
-	tcc_string_list_t enum_constants;
-	tcc_helper_binding_list_t helper_bindings;
-	char *helper_source = NULL;
-	char *combined_source = NULL;
+/* tcc_system_paths_bind: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_system_paths_bind(duckdb_bind_info info) {
+	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)duckdb_malloc(sizeof(tcc_diag_bind_data_t));
+	tcc_string_list_t include_paths;
+	tcc_string_list_t library_paths;
+	char *runtime_path = NULL;
+	char *library_path = NULL;
+	const char *effective_runtime;
 	idx_t i;
-	memset(&err, 0, sizeof(err));
-	memset(&fields, 0, sizeof(fields));
-	memset(&enum_constants, 0, sizeof(enum_constants));
-	memset(&helper_bindings, 0, sizeof(helper_bindings));
-
-	if (!type_name || !tcc_is_identifier_token(type_name)) {
-		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "symbol must be a valid C identifier",
-		              NULL, bind->sql_name, bind->symbol, NULL, "database");
-		goto done;
+	if (!bind) {
+		duckdb_bind_set_error(info, "out of memory");
+		return;
 	}
-	if (bind->sql_name && bind->sql_name[0] != '\0') {
-		prefix = bind->sql_name;
-	} else if (is_enum) {
-		int n = snprintf(prefix_buf, sizeof(prefix_buf), "enum_%s", type_name);
-		if (n < 0 || (size_t)n >= sizeof(prefix_buf)) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "failed to build helper prefix", NULL,
-			              bind->sql_name, bind->symbol, NULL, "database");
-			goto done;
+	memset(bind, 0, sizeof(tcc_diag_bind_data_t));
+	memset(&include_paths, 0, sizeof(tcc_string_list_t));
+	memset(&library_paths, 0, sizeof(tcc_string_list_t));
+
+	tcc_bind_read_named_varchar(info, "runtime_path", &runtime_path);
+	tcc_bind_read_named_varchar(info, "library_path", &library_path);
+	effective_runtime = (runtime_path && runtime_path[0] != '\0') ? runtime_path : tcc_default_runtime_path();
+
+	if (!tcc_collect_include_paths(effective_runtime, &include_paths) ||
+	    !tcc_collect_library_search_paths(effective_runtime, library_path, &library_paths)) {
+		tcc_string_list_destroy(&include_paths);
+		tcc_string_list_destroy(&library_paths);
+		if (runtime_path) {
+			duckdb_free(runtime_path);
 		}
-		prefix = prefix_buf;
-	} else {
-		int n = snprintf(prefix_buf, sizeof(prefix_buf), "%s_%s", is_union ? "union" : "struct", type_name);
-		if (n < 0 || (size_t)n >= sizeof(prefix_buf)) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "failed to build helper prefix", NULL,
-			              bind->sql_name, bind->symbol, NULL, "database");
-			goto done;
+		if (library_path) {
+			duckdb_free(library_path);
 		}
-		prefix = prefix_buf;
+		destroy_tcc_diag_bind_data(bind);
+		duckdb_bind_set_error(info, "out of memory");
+		return;
 	}
-	if (!prefix || !tcc_is_identifier_token(prefix)) {
-		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
-		              "sql_name must be a valid C/SQL identifier when provided", NULL, bind->sql_name, bind->symbol,
-		              NULL, "database");
-		goto done;
+
+	(void)tcc_diag_rows_add(&bind->rows, "runtime", "runtime_path", effective_runtime, tcc_path_exists(effective_runtime),
+	                        "effective runtime path");
+	for (i = 0; i < include_paths.count; i++) {
+		(void)tcc_diag_rows_add(&bind->rows, "include_path", "path", include_paths.items[i],
+		                        tcc_path_exists(include_paths.items[i]), "TinyCC include search path");
 	}
-	if (is_enum) {
-		if (!tcc_parse_c_enum_constants(bind->arg_types, &enum_constants, &err)) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "invalid c_enum constants",
-			              err.message[0] ? err.message : NULL, prefix, type_name, NULL, "database");
-			goto done;
+	for (i = 0; i < library_paths.count; i++) {
+		(void)tcc_diag_rows_add(&bind->rows, "library_path", "path", library_paths.items[i],
+		                        tcc_path_exists(library_paths.items[i]), "library search path");
+	}
+
+	tcc_string_list_destroy(&include_paths);
+	tcc_string_list_destroy(&library_paths);
+	if (runtime_path) {
+		duckdb_free(runtime_path);
+	}
+	if (library_path) {
+		duckdb_free(library_path);
+	}
+
+	tcc_diag_set_result_schema(info);
+	duckdb_bind_set_cardinality(info, bind->rows.count, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_diag_bind_data);
+}
+
+/* tcc_try_resolve_candidate: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static bool tcc_try_resolve_candidate(const char *candidate, const tcc_string_list_t *search_paths, char **out_path) {
+	idx_t i;
+	if (!candidate || candidate[0] == '\0' || !search_paths || !out_path) {
+		return false;
+	}
+	if (tcc_is_path_like(candidate)) {
+		if (tcc_path_exists(candidate)) {
+			*out_path = tcc_strdup(candidate);
+			return *out_path != NULL;
 		}
-		helper_source = tcc_generate_c_enum_helpers_source(type_name, prefix, &enum_constants, &err);
-		if (!helper_source) {
-			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
-			              "failed to generate enum helpers", err.message[0] ? err.message : NULL, prefix, type_name,
-			              NULL, "database");
-			goto done;
+		return false;
+	}
+	for (i = 0; i < search_paths->count; i++) {
+		char *full_path = tcc_path_join(search_paths->items[i], candidate);
+		if (!full_path) {
+			return false;
 		}
-		if (!tcc_build_c_enum_bindings(prefix, &enum_constants, &helper_bindings, &err)) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
-			              "failed to build enum helper signatures", err.message[0] ? err.message : NULL, prefix,
-			              type_name, NULL, "database");
-			goto done;
+		if (tcc_path_exists(full_path)) {
+			*out_path = full_path;
+			return true;
 		}
-	} else {
-		if (!tcc_parse_c_field_specs(bind->arg_types, force_bitfield, &fields, &err)) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS", "invalid c struct/union field specs",
-			              err.message[0] ? err.message : NULL, prefix, type_name, NULL, "database");
-			goto done;
+		duckdb_free(full_path);
+	}
+	return false;
+}
+
+/* tcc_library_probe_bind: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
+static void tcc_library_probe_bind(duckdb_bind_info info) {
+	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)duckdb_malloc(sizeof(tcc_diag_bind_data_t));
+	tcc_string_list_t library_paths;
+	tcc_string_list_t candidates;
+	char *library = NULL;
+	char *runtime_path = NULL;
+	char *library_path = NULL;
+	const char *effective_runtime;
+	idx_t i;
+	bool found = false;
+	if (!bind) {
+		duckdb_bind_set_error(info, "out of memory");
+		return;
+	}
+	memset(bind, 0, sizeof(tcc_diag_bind_data_t));
+	memset(&library_paths, 0, sizeof(tcc_string_list_t));
+	memset(&candidates, 0, sizeof(tcc_string_list_t));
+
+	tcc_bind_read_named_varchar(info, "library", &library);
+	tcc_bind_read_named_varchar(info, "runtime_path", &runtime_path);
+	tcc_bind_read_named_varchar(info, "library_path", &library_path);
+	effective_runtime = (runtime_path && runtime_path[0] != '\0') ? runtime_path : tcc_default_runtime_path();
+
+	if (!library || library[0] == '\0') {
+		if (library) {
+			duckdb_free(library);
 		}
-		helper_source = tcc_generate_c_composite_helpers_source(kind_keyword, type_name, prefix, &fields, &err);
-		if (!helper_source) {
-			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
-			              "failed to generate struct/union helpers", err.message[0] ? err.message : NULL, prefix,
-			              type_name, NULL, "database");
-			goto done;
+		if (runtime_path) {
+			duckdb_free(runtime_path);
 		}
-		if (!tcc_build_c_composite_bindings(prefix, &fields, &helper_bindings, &err)) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_BAD_ARGS",
-			              "failed to build struct/union helper signatures", err.message[0] ? err.message : NULL,
-			              prefix, type_name, NULL, "database");
-			goto done;
+		if (library_path) {
+			duckdb_free(library_path);
 		}
+		destroy_tcc_diag_bind_data(bind);
+		duckdb_bind_set_error(info, "library is required");
+		return;
 	}
 
-	if (bind->source && bind->source[0] != '\0') {
-		size_t n0 = strlen(bind->source);
-		size_t n1 = strlen(helper_source);
-		combined_source = (char *)duckdb_malloc(n0 + n1 + 3);
-		if (!combined_source) {
-			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
-			              "failed to allocate helper source buffer", NULL, prefix, type_name, NULL, "database");
-			goto done;
+	if (!tcc_collect_library_search_paths(effective_runtime, library_path, &library_paths) ||
+	    !tcc_build_library_candidates(library, &candidates)) {
+		tcc_string_list_destroy(&library_paths);
+		tcc_string_list_destroy(&candidates);
+		duckdb_free(library);
+		if (runtime_path) {
+			duckdb_free(runtime_path);
 		}
-		memcpy(combined_source, bind->source, n0);
-		combined_source[n0] = '\n';
-		memcpy(combined_source + n0 + 1, helper_source, n1);
-		combined_source[n0 + n1 + 1] = '\0';
-	} else {
-		combined_source = tcc_strdup(helper_source);
-		if (!combined_source) {
-			tcc_write_row(output, false, bind->mode, "codegen", "E_CODEGEN_FAILED",
-			              "failed to allocate helper source buffer", NULL, prefix, type_name, NULL, "database");
-			goto done;
+		if (library_path) {
+			duckdb_free(library_path);
 		}
+		destroy_tcc_diag_bind_data(bind);
+		duckdb_bind_set_error(info, "out of memory");
+		return;
 	}
 
-	for (i = 0; i < helper_bindings.count; i++) {
-		const tcc_helper_binding_t *entry = &helper_bindings.items[i];
-		memset(&err, 0, sizeof(err));
-		if (!tcc_compile_generated_binding(runtime_path, state, combined_source, entry, &err)) {
-			const char *phase = "compile";
-			const char *code = "E_COMPILE_FAILED";
-			const char *message = "generated helper compile failed";
-			tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
-			tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
-			              entry->sql_name, entry->symbol, NULL, "database");
-			goto done;
+	(void)tcc_diag_rows_add(&bind->rows, "input", "library", library, false, "library probe request");
+	(void)tcc_diag_rows_add(&bind->rows, "runtime", "runtime_path", effective_runtime, tcc_path_exists(effective_runtime),
+	                        "effective runtime path");
+	for (i = 0; i < library_paths.count; i++) {
+		(void)tcc_diag_rows_add(&bind->rows, "search_path", "path", library_paths.items[i],
+		                        tcc_path_exists(library_paths.items[i]), "searched path");
+	}
+	for (i = 0; i < candidates.count; i++) {
+		char *resolved = NULL;
+		bool candidate_found = tcc_try_resolve_candidate(candidates.items[i], &library_paths, &resolved);
+		if (candidate_found && resolved) {
+			char *link_name = tcc_library_link_name_from_path(resolved);
+			(void)tcc_diag_rows_add(&bind->rows, "candidate", candidates.items[i], resolved, true, "resolved");
+			(void)tcc_diag_rows_add(&bind->rows, "resolved", "path", resolved, true, "resolved library path");
+			if (link_name) {
+				(void)tcc_diag_rows_add(&bind->rows, "resolved", "link_name", link_name, true,
+				                        "normalized tcc_add_library value");
+				duckdb_free(link_name);
+			}
+			found = true;
+			duckdb_free(resolved);
+			break;
 		}
+		(void)tcc_diag_rows_add(&bind->rows, "candidate", candidates.items[i], NULL, false, "not found");
 	}
-	{
-		char detail[256];
-		snprintf(detail, sizeof(detail), "generated=%llu prefix=%.96s target=%.96s",
-		         (unsigned long long)helper_bindings.count, prefix, type_name);
-		tcc_write_row(output, true, bind->mode, "load", "OK", "generated and registered helper UDFs", detail,
-		              prefix, type_name, NULL, "database");
+	if (!found) {
+		(void)tcc_diag_rows_add(&bind->rows, "resolved", "path", NULL, false, "no matching library found");
 	}
 
-done:
-	if (helper_source) {
-		duckdb_free(helper_source);
+	tcc_string_list_destroy(&library_paths);
+	tcc_string_list_destroy(&candidates);
+	duckdb_free(library);
+	if (runtime_path) {
+		duckdb_free(runtime_path);
 	}
-	if (combined_source) {
-		duckdb_free(combined_source);
+	if (library_path) {
+		duckdb_free(library_path);
 	}
-	tcc_c_field_list_destroy(&fields);
-	tcc_string_list_destroy(&enum_constants);
-	tcc_helper_binding_list_destroy(&helper_bindings);
-#endif
+
+	tcc_diag_set_result_schema(info);
+	duckdb_bind_set_cardinality(info, bind->rows.count, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_diag_bind_data);
 }
 
-/* Handles codegen_preview mode. */
-static void tcc_mode_codegen_preview(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
-                                     duckdb_data_chunk output) {
-	const char *target_symbol = tcc_effective_symbol(state, bind);
-	const char *sql_name = tcc_effective_sql_name(state, bind, target_symbol);
-	tcc_codegen_source_ctx_t source_ctx;
-	tcc_error_buffer_t err;
-	memset(&err, 0, sizeof(err));
-	tcc_codegen_source_ctx_init(&source_ctx);
-	if (!target_symbol || target_symbol[0] == '\0') {
-		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
-		              "symbol is required (bind or argument)", NULL, sql_name, target_symbol, NULL, "database");
-		goto done;
-	}
-	if (!tcc_codegen_prepare_sources(state, bind, sql_name, target_symbol, &source_ctx, &err)) {
-		const char *phase = "codegen";
-		const char *code = "E_CODEGEN_FAILED";
-		const char *message = "ffi codegen failed";
-		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
-		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
-		              sql_name, target_symbol, NULL, "database");
-		goto done;
-	}
-	tcc_write_row(output, true, bind->mode, "codegen", "OK", "generated codegen source",
-	              source_ctx.compilation_unit_source, sql_name, target_symbol, source_ctx.module_symbol,
-	              "database");
-done:
-	tcc_codegen_source_ctx_destroy(&source_ctx);
+/* Registers `tcc_system_paths(...)` diagnostics table function. */
+static bool register_tcc_system_paths_function(duckdb_connection connection) {
+	duckdb_table_function tf = duckdb_create_table_function();
+	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_state rc;
+	duckdb_table_function_set_name(tf, "tcc_system_paths");
+	duckdb_table_function_add_named_parameter(tf, "runtime_path", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "library_path", varchar_type);
+	duckdb_table_function_set_bind(tf, tcc_system_paths_bind);
+	duckdb_table_function_set_init(tf, tcc_diag_table_init);
+	duckdb_table_function_set_function(tf, tcc_diag_table_function);
+	duckdb_table_function_supports_projection_pushdown(tf, false);
+	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_table_function(&tf);
+	return rc == DuckDBSuccess;
 }
 
-/* Handles compile/quick_compile modes. */
-static void tcc_mode_compile(tcc_module_state_t *state, const tcc_module_bind_data_t *bind,
-                             const char *runtime_path, duckdb_data_chunk output) {
-#ifdef DUCKTINYCC_WASM_UNSUPPORTED
-	tcc_write_row(output, false, bind->mode, "runtime", "E_PLATFORM_WASM_UNSUPPORTED",
-	              "TinyCC compile codegen path not supported for WASM build", NULL, bind->sql_name, bind->symbol,
-	              NULL, "database");
-#else
-	const char *target_symbol = tcc_effective_symbol(state, bind);
-	const char *sql_name = tcc_effective_sql_name(state, bind, target_symbol);
-	char module_symbol[128];
-	tcc_error_buffer_t err;
-	tcc_registered_artifact_t *artifact = NULL;
-	char artifact_id[256];
-	const char *phase = "compile";
-	const char *code = "E_COMPILE_FAILED";
-	const char *message = "compile failed";
-	memset(&err, 0, sizeof(err));
+/* Registers `tcc_library_probe(...)` diagnostics table function. */
+static bool register_tcc_library_probe_function(duckdb_connection connection) {
+	duckdb_table_function tf = duckdb_create_table_function();
+	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_state rc;
+	duckdb_table_function_set_name(tf, "tcc_library_probe");
+	duckdb_table_function_add_named_parameter(tf, "library", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "runtime_path", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "library_path", varchar_type);
+	duckdb_table_function_set_bind(tf, tcc_library_probe_bind);
+	duckdb_table_function_set_init(tf, tcc_diag_table_init);
+	duckdb_table_function_set_function(tf, tcc_diag_table_function);
+	duckdb_table_function_supports_projection_pushdown(tf, false);
+	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_table_function(&tf);
+	return rc == DuckDBSuccess;
+}
 
-	if (strcmp(bind->mode, "quick_compile") == 0 && (!bind->source || bind->source[0] == '\0')) {
-		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
-		              "source is required in quick_compile mode", NULL, sql_name, target_symbol, NULL,
-		              "connection");
+/* ===== Section: tcc_functions() ===== */
+/* One snapshotted `tcc_functions()` row: registry metadata plus summed runtime counters. */
+typedef struct {
+	char *sql_name;
+	char *symbol;
+	uint64_t state_id;
+	const char *wrapper_mode;
+	const char *stability;
+	uint64_t code_size;
+	uint64_t counters[6];
+} tcc_function_stats_row_t;
+
+/* Bind payload for `tcc_functions()`: rows captured under the registry read lock. */
+typedef struct {
+	tcc_function_stats_row_t *rows;
+	idx_t count;
+} tcc_functions_bind_data_t;
+
+/* destroy_tcc_functions_bind_data: Destructor callback for DuckDB bind payloads. Allocation/Lifetime: releases owned row strings and the row array. */
+static void destroy_tcc_functions_bind_data(void *ptr) {
+	tcc_functions_bind_data_t *bind = (tcc_functions_bind_data_t *)ptr;
+	idx_t i;
+	if (!bind) {
 		return;
 	}
-	if (!target_symbol || target_symbol[0] == '\0') {
-		tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS",
-		              "symbol is required (bind or argument)", NULL, sql_name, target_symbol, NULL, "database");
-		return;
+	for (i = 0; i < bind->count; i++) {
+		if (bind->rows[i].sql_name) {
+			duckdb_free(bind->rows[i].sql_name);
+		}
+		if (bind->rows[i].symbol) {
+			duckdb_free(bind->rows[i].symbol);
+		}
 	}
-	/* Reject duplicate SQL name: DuckDB's scalar-function registration behaviour
-	 * differs across platforms (Linux fails, macOS silently replaces).  Checking
-	 * our own registry first makes the "already registered" error consistent. */
-	if (sql_name && tcc_registry_find_sql_name(state, sql_name) != (idx_t)-1) {
-		tcc_write_row(output, false, bind->mode, "load", "E_INIT_FAILED",
-		              "generated module init returned false",
-		              "sql_name already registered; use tcc_new_state to reset",
-		              sql_name, target_symbol, NULL, "database");
-		return;
+	if (bind->rows) {
+		duckdb_free(bind->rows);
 	}
-	if (tcc_codegen_compile_and_load_module(runtime_path, state, bind, sql_name, target_symbol, &artifact, &err,
-	                                        module_symbol, sizeof(module_symbol)) != 0) {
-		tcc_codegen_classify_error_message(err.message, &phase, &code, &message);
-		tcc_write_row(output, false, bind->mode, phase, code, message, err.message[0] ? err.message : NULL,
-		              sql_name, target_symbol, NULL, "database");
-		return;
+	duckdb_free(bind);
+}
+
+/* tcc_functions_collect: snapshots one row per registered UDF. Allocation/Lifetime: caller holds the state read lock; rows own copied strings. */
+static bool tcc_functions_collect(tcc_module_state_t *state, tcc_functions_bind_data_t *bind) {
+	idx_t total = 0;
+	idx_t i;
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	for (i = 0; i < state->entry_count; i++) {
+		if (state->entries[i].artifact) {
+			total += state->entries[i].artifact->udf_stats_count;
+		}
 	}
-	if (!tcc_registry_store_metadata(state, sql_name, module_symbol, artifact->state_id, artifact)) {
-		tcc_artifact_destroy(artifact);
-		tcc_write_row(output, false, bind->mode, "register", "E_STORE_FAILED",
-		              "failed to store ffi module artifact metadata", NULL, sql_name, target_symbol, NULL,
-		              "connection");
-		return;
+#endif
+	if (total == 0) {
+		return true;
+	}
+	bind->rows = (tcc_function_stats_row_t *)duckdb_malloc(sizeof(tcc_function_stats_row_t) * (size_t)total);
+	if (!bind->rows) {
+		return false;
+	}
+	memset(bind->rows, 0, sizeof(tcc_function_stats_row_t) * (size_t)total);
+#ifndef DUCKTINYCC_WASM_UNSUPPORTED
+	for (i = 0; i < state->entry_count; i++) {
+		const tcc_registered_entry_t *entry = &state->entries[i];
+		idx_t j;
+		if (!entry->artifact) {
+			continue;
+		}
+		for (j = 0; j < entry->artifact->udf_stats_count; j++) {
+			const tcc_udf_stats_t *stats = entry->artifact->udf_stats[j];
+			tcc_function_stats_row_t *row = &bind->rows[bind->count++];
+			row->sql_name = tcc_strdup(stats->sql_name);
+			row->symbol = tcc_strdup(entry->symbol);
+			if (!row->sql_name || !row->symbol) {
+				return false;
+			}
+			row->state_id = entry->state_id;
+			row->wrapper_mode = tcc_wrapper_mode_token(stats->wrapper_mode);
+			row->stability = tcc_function_stability_token(stats->stability);
+			row->code_size = entry->artifact->code_size;
+			tcc_udf_stats_snapshot(stats, row->counters);
+		}
 	}
-	snprintf(artifact_id, sizeof(artifact_id), "%s@ffi_state_%llu", sql_name,
-	         (unsigned long long)artifact->state_id);
-	tcc_write_row(output, true, bind->mode, "load", "OK", "compiled and registered SQL function via codegen",
-	              runtime_path, sql_name, target_symbol, artifact_id, "database");
 #endif
+	return true;
 }
 
-/* Main dispatcher for all `tcc_module(...)` modes. */
-static void tcc_module_function(duckdb_function_info info, duckdb_data_chunk output) {
-	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_function_get_extra_info(info);
-	tcc_module_bind_data_t *bind = (tcc_module_bind_data_t *)duckdb_function_get_bind_data(info);
-	tcc_module_init_data_t *init = (tcc_module_init_data_t *)duckdb_function_get_init_data(info);
-	const char *runtime_path;
-	int lock_mode = 0; /* 0 none, 1 read, 2 write */
-	bool expected_not_emitted = false;
+/* tcc_functions_bind: Bind callback for `tcc_functions()`. Allocation/Lifetime: allocates bind payload released by destroy_tcc_functions_bind_data. */
+static void tcc_functions_bind(duckdb_bind_info info) {
+	static const char *counter_names[6] = {"chunks", "rows", "null_in_rows", "null_out_rows", "errors", "total_ns"};
+	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_bind_get_extra_info(info);
+	tcc_functions_bind_data_t *bind;
+	duckdb_logical_type varchar_type;
+	duckdb_logical_type ubigint_type;
+	bool ok;
+	int i;
+	bind = (tcc_functions_bind_data_t *)duckdb_malloc(sizeof(tcc_functions_bind_data_t));
+	if (!bind) {
+		duckdb_bind_set_error(info, "out of memory");
+		return;
+	}
+	memset(bind, 0, sizeof(tcc_functions_bind_data_t));
+	ok = true;
+	if (state) {
+		tcc_rwlock_read_lock(&state->lock);
+		ok = tcc_functions_collect(state, bind);
+		tcc_rwlock_read_unlock(&state->lock);
+	}
+	if (!ok) {
+		destroy_tcc_functions_bind_data(bind);
+		duckdb_bind_set_error(info, "out of memory");
+		return;
+	}
 
-	if (!state || !bind || !init) {
+	varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+	duckdb_bind_add_result_column(info, "sql_name", varchar_type);
+	duckdb_bind_add_result_column(info, "symbol", varchar_type);
+	duckdb_bind_add_result_column(info, "state_id", ubigint_type);
+	duckdb_bind_add_result_column(info, "wrapper_mode", varchar_type);
+	duckdb_bind_add_result_column(info, "stability", varchar_type);
+	duckdb_bind_add_result_column(info, "code_size", ubigint_type);
+	for (i = 0; i < 6; i++) {
+		duckdb_bind_add_result_column(info, counter_names[i], ubigint_type);
+	}
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_logical_type(&ubigint_type);
+
+	duckdb_bind_set_cardinality(info, bind->count, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_functions_bind_data);
+}
+
+/* tcc_functions_table_function: emits snapshotted rows, up to one vector per call. */
+static void tcc_functions_table_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_functions_bind_data_t *bind = (tcc_functions_bind_data_t *)duckdb_function_get_bind_data(info);
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_function_get_init_data(info);
+	uint64_t *state_ids;
+	uint64_t *code_sizes;
+	uint64_t *counters[6];
+	idx_t start;
+	idx_t n;
+	idx_t i;
+	int c;
+	if (!bind || !init) {
 		duckdb_data_chunk_set_size(output, 0);
 		return;
 	}
-	if (!atomic_compare_exchange_strong_explicit(&init->emitted, &expected_not_emitted, true, memory_order_acq_rel,
-	                                             memory_order_acquire)) {
+	n = duckdb_vector_size();
+	start = (idx_t)atomic_fetch_add_explicit(&init->offset, n, memory_order_acq_rel);
+	if (start >= bind->count) {
 		duckdb_data_chunk_set_size(output, 0);
 		return;
 	}
-	if (tcc_mode_requires_write_lock(bind->mode)) {
-		tcc_rwlock_write_lock(&state->lock);
-		lock_mode = 2;
-	} else {
-		tcc_rwlock_read_lock(&state->lock);
-		lock_mode = 1;
+	if (n > bind->count - start) {
+		n = bind->count - start;
+	}
+	state_ids = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 2));
+	code_sizes = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 5));
+	for (c = 0; c < 6; c++) {
+		counters[c] = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, (idx_t)(6 + c)));
+	}
+	for (i = 0; i < n; i++) {
+		const tcc_function_stats_row_t *row = &bind->rows[start + i];
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 0), i, row->sql_name);
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), i, row->symbol);
+		state_ids[i] = row->state_id;
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 3), i, row->wrapper_mode);
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 4), i, row->stability);
+		code_sizes[i] = row->code_size;
+		for (c = 0; c < 6; c++) {
+			counters[c][i] = row->counters[c];
+		}
 	}
+	duckdb_data_chunk_set_size(output, n);
+}
 
-	runtime_path = tcc_session_runtime_path(state, bind->runtime_path);
-	if (strcmp(bind->mode, "config_set") == 0) {
-		tcc_session_set_runtime_path(&state->session, bind->runtime_path);
-		tcc_write_row(output, true, bind->mode, "config", "OK", "session runtime updated",
-		              state->session.runtime_path ? state->session.runtime_path : "(empty)", NULL, NULL, NULL,
-		              "connection");
-	} else if (strcmp(bind->mode, "config_get") == 0) {
-		char detail[256];
-		snprintf(detail, sizeof(detail), "runtime=%s state_id=%llu config_version=%llu",
-		         runtime_path ? runtime_path : "(unset)", (unsigned long long)state->session.state_id,
-		         (unsigned long long)state->session.config_version);
-		tcc_write_row(output, true, bind->mode, "config", "OK", "session configuration", detail, NULL, NULL, NULL,
-		              "connection");
-	} else if (strcmp(bind->mode, "config_reset") == 0) {
-		tcc_session_set_runtime_path(&state->session, NULL);
-		tcc_session_clear_build_state(&state->session);
-		tcc_write_row(output, true, bind->mode, "config", "OK", "session reset", "runtime/build state cleared",
-		              NULL, NULL, NULL, "database");
-	} else if (strcmp(bind->mode, "tcc_new_state") == 0) {
-		char detail[128];
-		tcc_session_clear_build_state(&state->session);
-		snprintf(detail, sizeof(detail), "state_id=%llu", (unsigned long long)state->session.state_id);
-		tcc_write_row(output, true, bind->mode, "state", "OK", "new TinyCC build state prepared", detail, NULL,
-		              NULL, NULL, "database");
-	} else if (strncmp(bind->mode, "add_", 4) == 0 && strcmp(bind->mode, "add_define") != 0 &&
-	           strcmp(bind->mode, "add_symbol") != 0) {
-		tcc_mode_add_staged(state, bind, output);
-	} else if (strcmp(bind->mode, "add_define") == 0) {
-		if (bind->define_name && bind->define_name[0] != '\0') {
-			const char *define_value = bind->define_value ? bind->define_value : "1";
-			if (tcc_string_list_append(&state->session.define_names, bind->define_name)) {
-				if (!tcc_string_list_append(&state->session.define_values, define_value)) {
-					(void)tcc_string_list_pop_last(&state->session.define_names);
-					tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to store define", NULL,
-					              NULL, NULL, NULL, "database");
-					goto tcc_module_done;
-				}
-				state->session.config_version++;
-				tcc_write_row(output, true, bind->mode, "state", "OK", "define added", bind->define_name, NULL, NULL,
-				              NULL, "database");
-			} else {
-				tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to store define", NULL,
-				              NULL, NULL, NULL, "database");
-			}
-		} else {
-			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "define_name is required", NULL, NULL,
-			              NULL, NULL, "database");
+/* Registers `tcc_functions()` (registered UDFs + runtime counters) with borrowed module state as extra info. */
+static bool register_tcc_functions_function(duckdb_connection connection, tcc_module_state_t *state) {
+	duckdb_table_function tf = duckdb_create_table_function();
+	duckdb_state rc;
+	duckdb_table_function_set_name(tf, "tcc_functions");
+	duckdb_table_function_set_extra_info(tf, state, NULL);
+	duckdb_table_function_set_bind(tf, tcc_functions_bind);
+	duckdb_table_function_set_init(tf, tcc_diag_table_init);
+	duckdb_table_function_set_function(tf, tcc_functions_table_function);
+	duckdb_table_function_supports_projection_pushdown(tf, false);
+	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_table_function(&tf);
+	return rc == DuckDBSuccess;
+}
+
+/* ===== Section: tcc_compile_stats() ===== */
+/* Bind payload for `tcc_compile_stats()`: history records copied (oldest first) under the registry read lock. */
+typedef struct {
+	tcc_compile_stat_t *rows;
+	idx_t count;
+} tcc_compile_stats_bind_data_t;
+
+/* destroy_tcc_compile_stats_bind_data: Destructor callback for DuckDB bind payloads. Allocation/Lifetime: releases copied record strings and the row array. */
+static void destroy_tcc_compile_stats_bind_data(void *ptr) {
+	tcc_compile_stats_bind_data_t *bind = (tcc_compile_stats_bind_data_t *)ptr;
+	idx_t i;
+	if (!bind) {
+		return;
+	}
+	for (i = 0; i < bind->count; i++) {
+		if (bind->rows[i].mode) {
+			duckdb_free(bind->rows[i].mode);
 		}
-	} else if (strcmp(bind->mode, "add_symbol") == 0) {
-		if (!bind->symbol_name || bind->symbol_name[0] == '\0') {
-			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "symbol_name is required", NULL,
-			              NULL, NULL, NULL, "database");
-		} else if (!bind->has_symbol_ptr) {
-			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "symbol_ptr is required", NULL,
-			              NULL, NULL, NULL, "database");
-		} else {
-			tcc_session_t *sess = &state->session;
-			if (sess->symbol_count >= sess->symbol_capacity) {
-				idx_t new_cap = sess->symbol_capacity == 0 ? 8 : sess->symbol_capacity * 2;
-				uint64_t *new_ptrs = (uint64_t *)duckdb_malloc(sizeof(uint64_t) * new_cap);
-				if (!new_ptrs) {
-					tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED",
-					              "failed to grow symbol pointer array", NULL, NULL, NULL, NULL, "database");
-					goto tcc_module_done;
-				}
-				if (sess->symbol_ptrs && sess->symbol_count > 0) {
-					memcpy(new_ptrs, sess->symbol_ptrs, sizeof(uint64_t) * sess->symbol_count);
-				}
-				if (sess->symbol_ptrs) {
-					duckdb_free(sess->symbol_ptrs);
-				}
-				sess->symbol_ptrs = new_ptrs;
-				sess->symbol_capacity = new_cap;
-			}
-			if (!tcc_string_list_append(&sess->symbol_names, bind->symbol_name)) {
-				tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED",
-				              "failed to store symbol name", NULL, NULL, NULL, NULL, "database");
-				goto tcc_module_done;
-			}
-			sess->symbol_ptrs[sess->symbol_count] = bind->symbol_ptr;
-			sess->symbol_count++;
-			sess->config_version++;
-			{
-				char detail[128];
-				snprintf(detail, sizeof(detail), "ptr=0x%llx", (unsigned long long)bind->symbol_ptr);
-				tcc_write_row(output, true, bind->mode, "state", "OK", "symbol added", detail,
-				              NULL, bind->symbol_name, NULL, "database");
-			}
+		if (bind->rows[i].sql_name) {
+			duckdb_free(bind->rows[i].sql_name);
 		}
-	} else if (strcmp(bind->mode, "tinycc_bind") == 0) {
-		if (!bind->symbol || bind->symbol[0] == '\0') {
-			tcc_write_row(output, false, bind->mode, "bind", "E_MISSING_ARGS", "symbol is required", NULL,
-			              bind->sql_name, bind->symbol, NULL, "database");
-		} else {
-			char *bound_symbol = NULL;
-			char *bound_sql_name = NULL;
-			char *bound_stability = NULL;
-			tcc_function_stability_t parsed_stability = TCC_FUNCTION_STABILITY_CONSISTENT;
-			tcc_error_buffer_t err;
-			memset(&err, 0, sizeof(err));
-			if (bind->stability && bind->stability[0] != '\0' &&
-			    !tcc_parse_function_stability(bind->stability, &parsed_stability, &err)) {
-				tcc_write_row(output, false, bind->mode, "bind", "E_BAD_STABILITY", "invalid stability",
-				              err.message[0] ? err.message : NULL, bind->sql_name, bind->symbol, NULL, "database");
-				goto tcc_module_done;
-			}
-			bound_symbol = tcc_strdup(bind->symbol);
-			bound_sql_name = tcc_strdup(bind->sql_name && bind->sql_name[0] != '\0' ? bind->sql_name : bind->symbol);
-			if (bind->stability && bind->stability[0] != '\0') {
-				bound_stability = tcc_strdup(tcc_function_stability_token(parsed_stability));
-			}
-			if (!bound_symbol || !bound_sql_name || (bind->stability && bind->stability[0] != '\0' && !bound_stability)) {
-				if (bound_symbol) {
-					duckdb_free(bound_symbol);
-				}
-				if (bound_sql_name) {
-					duckdb_free(bound_sql_name);
-				}
-				if (bound_stability) {
-					duckdb_free(bound_stability);
-				}
-				tcc_write_row(output, false, bind->mode, "state", "E_STORE_FAILED", "failed to store symbol binding",
-				              NULL, bind->sql_name, bind->symbol, NULL, "database");
-				goto tcc_module_done;
-			}
-			tcc_session_clear_bind(&state->session);
-			state->session.bound_symbol = bound_symbol;
-			state->session.bound_sql_name = bound_sql_name;
-			state->session.bound_stability = bound_stability;
-			state->session.config_version++;
-			tcc_write_row(output, true, bind->mode, "bind", "OK", "symbol binding updated",
-			              state->session.bound_stability ? state->session.bound_stability : "consistent",
-			              state->session.bound_sql_name, state->session.bound_symbol, NULL, "connection");
+		if (bind->rows[i].code) {
+			duckdb_free(bind->rows[i].code);
 		}
-	} else if (strcmp(bind->mode, "list") == 0) {
-		char detail[256];
-		snprintf(detail, sizeof(detail),
-		         "registered=%llu sources=%llu headers=%llu includes=%llu libs=%llu symbols=%llu state_id=%llu", 
-		         (unsigned long long)state->entry_count, (unsigned long long)state->session.sources.count,
-		         (unsigned long long)state->session.headers.count, (unsigned long long)state->session.include_paths.count,
-		         (unsigned long long)state->session.libraries.count,
-		         (unsigned long long)state->session.symbol_count, (unsigned long long)state->session.state_id);
-		tcc_write_row(output, true, bind->mode, "registry", "OK", "session summary", detail, NULL, NULL, NULL,
-		              "connection");
-	} else if (strcmp(bind->mode, "c_struct") == 0 || strcmp(bind->mode, "c_union") == 0 ||
-	           strcmp(bind->mode, "c_bitfield") == 0 || strcmp(bind->mode, "c_enum") == 0) {
-		tcc_mode_c_helpers(state, bind, runtime_path, output);
-	} else if (strcmp(bind->mode, "codegen_preview") == 0) {
-		tcc_mode_codegen_preview(state, bind, output);
-	} else if (strcmp(bind->mode, "compile") == 0 || strcmp(bind->mode, "quick_compile") == 0) {
-		tcc_mode_compile(state, bind, runtime_path, output);
-	} else {
-		tcc_write_row(output, false, bind->mode, "bind", "E_BAD_MODE", "unknown mode", NULL, NULL, NULL, NULL,
-		              "connection");
 	}
+	if (bind->rows) {
+		duckdb_free(bind->rows);
+	}
+	duckdb_free(bind);
+}
 
-tcc_module_done:
-	if (lock_mode == 2) {
-		tcc_rwlock_write_unlock(&state->lock);
-	} else if (lock_mode == 1) {
-		tcc_rwlock_read_unlock(&state->lock);
+/* tcc_compile_stats_collect: copies the history ring oldest-first. Allocation/Lifetime: caller holds the state read lock; rows own copied strings. */
+static bool tcc_compile_stats_collect(tcc_module_state_t *state, tcc_compile_stats_bind_data_t *bind) {
+	uint64_t seq = state->compile_stats_seq;
+	uint64_t first;
+	uint64_t k;
+	idx_t total;
+	if (!state->compile_stats || seq == 0) {
+		return true;
+	}
+	total = seq < TCC_COMPILE_STATS_CAPACITY ? (idx_t)seq : TCC_COMPILE_STATS_CAPACITY;
+	bind->rows = (tcc_compile_stat_t *)duckdb_malloc(sizeof(tcc_compile_stat_t) * (size_t)total);
+	if (!bind->rows) {
+		return false;
 	}
+	memset(bind->rows, 0, sizeof(tcc_compile_stat_t) * (size_t)total);
+	first = seq - total;
+	for (k = first; k < seq; k++) {
+		const tcc_compile_stat_t *src = &state->compile_stats[k % TCC_COMPILE_STATS_CAPACITY];
+		tcc_compile_stat_t *dst = &bind->rows[bind->count++];
+		*dst = *src;
+		dst->mode = src->mode ? tcc_strdup(src->mode) : NULL;
+		dst->sql_name = src->sql_name ? tcc_strdup(src->sql_name) : NULL;
+		dst->code = src->code ? tcc_strdup(src->code) : NULL;
+		if ((src->mode && !dst->mode) || (src->sql_name && !dst->sql_name) || (src->code && !dst->code)) {
+			return false;
+		}
+	}
+	return true;
 }
 
-/* destroy_tcc_diag_bind_data: Destructor callback for DuckDB bind/init/extra-info payloads. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
-static void destroy_tcc_diag_bind_data(void *ptr) {
-	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)ptr;
+/* tcc_compile_stats_bind: Bind callback for `tcc_compile_stats()`. Allocation/Lifetime: allocates bind payload released by destroy_tcc_compile_stats_bind_data. */
+static void tcc_compile_stats_bind(duckdb_bind_info info) {
+	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_bind_get_extra_info(info);
+	tcc_compile_stats_bind_data_t *bind;
+	duckdb_logical_type varchar_type;
+	duckdb_logical_type ubigint_type;
+	duckdb_logical_type bool_type;
+	bool ok = true;
+	int i;
+	bind = (tcc_compile_stats_bind_data_t *)duckdb_malloc(sizeof(tcc_compile_stats_bind_data_t));
 	if (!bind) {
+		duckdb_bind_set_error(info, "out of memory");
 		return;
 	}
-	tcc_diag_rows_destroy(&bind->rows);
-	duckdb_free(bind);
-}
-
-/* destroy_tcc_diag_init_data: Destructor callback for DuckDB bind/init/extra-info payloads. Allocation/Lifetime: releases owned allocations (duckdb_malloc/duckdb_free and/or libc malloc/free per member contract). */
-static void destroy_tcc_diag_init_data(void *ptr) {
-	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)ptr;
-	if (!init) {
+	memset(bind, 0, sizeof(tcc_compile_stats_bind_data_t));
+	if (state) {
+		tcc_rwlock_read_lock(&state->lock);
+		ok = tcc_compile_stats_collect(state, bind);
+		tcc_rwlock_read_unlock(&state->lock);
+	}
+	if (!ok) {
+		destroy_tcc_compile_stats_bind_data(bind);
+		duckdb_bind_set_error(info, "out of memory");
 		return;
 	}
-	duckdb_free(init);
-}
 
-/* tcc_diag_set_result_schema: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_diag_set_result_schema(duckdb_bind_info info) {
-	duckdb_logical_type bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
-	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
-	duckdb_bind_add_result_column(info, "kind", varchar_type);
-	duckdb_bind_add_result_column(info, "key", varchar_type);
-	duckdb_bind_add_result_column(info, "value", varchar_type);
-	duckdb_bind_add_result_column(info, "exists", bool_type);
-	duckdb_bind_add_result_column(info, "detail", varchar_type);
-	duckdb_destroy_logical_type(&bool_type);
+	varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+	bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
+	duckdb_bind_add_result_column(info, "seq", ubigint_type);
+	duckdb_bind_add_result_column(info, "mode", varchar_type);
+	duckdb_bind_add_result_column(info, "sql_name", varchar_type);
+	duckdb_bind_add_result_column(info, "ok", bool_type);
+	duckdb_bind_add_result_column(info, "code", varchar_type);
+	duckdb_bind_add_result_column(info, "state_id", ubigint_type);
+	for (i = 0; i < 9; i++) {
+		duckdb_bind_add_result_column(info, tcc_compile_timing_names[i], ubigint_type);
+	}
 	duckdb_destroy_logical_type(&varchar_type);
-}
+	duckdb_destroy_logical_type(&ubigint_type);
+	duckdb_destroy_logical_type(&bool_type);
 
-/* tcc_diag_table_init: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_diag_table_init(duckdb_init_info info) {
-	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_malloc(sizeof(tcc_diag_init_data_t));
-	if (!init) {
-		duckdb_init_set_error(info, "out of memory");
-		return;
-	}
-	atomic_store_explicit(&init->offset, 0, memory_order_relaxed);
-	duckdb_init_set_init_data(info, init, destroy_tcc_diag_init_data);
+	duckdb_bind_set_cardinality(info, bind->count, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_compile_stats_bind_data);
 }
-
-/* tcc_diag_table_function: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_diag_table_function(duckdb_function_info info, duckdb_data_chunk output) {
-	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)duckdb_function_get_bind_data(info);
-	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_function_get_init_data(info);
-	tcc_diag_row_t *row;
-	duckdb_vector v_exists;
-	bool *exists_data;
-	uint64_t row_idx;
+
+/* tcc_compile_stats_table_function: emits copied history rows, up to one vector per call. */
+static void tcc_compile_stats_table_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_compile_stats_bind_data_t *bind = (tcc_compile_stats_bind_data_t *)duckdb_function_get_bind_data(info);
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_function_get_init_data(info);
+	uint64_t *seqs;
+	bool *oks;
+	uint64_t *state_ids;
+	uint64_t *phases[9];
+	idx_t start;
+	idx_t n;
+	idx_t i;
+	int c;
 	if (!bind || !init) {
 		duckdb_data_chunk_set_size(output, 0);
 		return;
 	}
-	row_idx = atomic_fetch_add_explicit(&init->offset, 1, memory_order_acq_rel);
-	if ((idx_t)row_idx >= bind->rows.count) {
+	n = duckdb_vector_size();
+	start = (idx_t)atomic_fetch_add_explicit(&init->offset, n, memory_order_acq_rel);
+	if (start >= bind->count) {
 		duckdb_data_chunk_set_size(output, 0);
 		return;
 	}
-	row = &bind->rows.rows[(idx_t)row_idx];
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 0), 0, row->kind);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), 0, row->key);
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 2), 0, row->value);
-	v_exists = duckdb_data_chunk_get_vector(output, 3);
-	exists_data = (bool *)duckdb_vector_get_data(v_exists);
-	exists_data[0] = row->exists;
-	tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 4), 0, row->detail);
-	duckdb_data_chunk_set_size(output, 1);
+	if (n > bind->count - start) {
+		n = bind->count - start;
+	}
+	seqs = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 0));
+	oks = (bool *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 3));
+	state_ids = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 5));
+	for (c = 0; c < 9; c++) {
+		phases[c] = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, (idx_t)(6 + c)));
+	}
+	for (i = 0; i < n; i++) {
+		const tcc_compile_stat_t *row = &bind->rows[start + i];
+		uint64_t values[9];
+		seqs[i] = row->seq;
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), i, row->mode);
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 2), i, row->sql_name);
+		oks[i] = row->ok;
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 4), i, row->code);
+		state_ids[i] = row->state_id;
+		tcc_compile_timings_values(&row->timings, values);
+		for (c = 0; c < 9; c++) {
+			phases[c][i] = values[c];
+		}
+	}
+	duckdb_data_chunk_set_size(output, n);
 }
 
-/* tcc_system_paths_bind: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_system_paths_bind(duckdb_bind_info info) {
-	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)duckdb_malloc(sizeof(tcc_diag_bind_data_t));
-	tcc_string_list_t include_paths;
-	tcc_string_list_t library_paths;
-	char *runtime_path = NULL;
-	char *library_path = NULL;
-	const char *effective_runtime;
-	idx_t i;
-	if (!bind) {
-		duckdb_bind_set_error(info, "out of memory");
-		return;
-	}
-	memset(bind, 0, sizeof(tcc_diag_bind_data_t));
-	memset(&include_paths, 0, sizeof(tcc_string_list_t));
-	memset(&library_paths, 0, sizeof(tcc_string_list_t));
+/* Registers `tcc_compile_stats()` (recent compile phase timings) with borrowed module state as extra info. */
+static bool register_tcc_compile_stats_function(duckdb_connection connection, tcc_module_state_t *state) {
+	duckdb_table_function tf = duckdb_create_table_function();
+	duckdb_state rc;
+	duckdb_table_function_set_name(tf, "tcc_compile_stats");
+	duckdb_table_function_set_extra_info(tf, state, NULL);
+	duckdb_table_function_set_bind(tf, tcc_compile_stats_bind);
+	duckdb_table_function_set_init(tf, tcc_diag_table_init);
+	duckdb_table_function_set_function(tf, tcc_compile_stats_table_function);
+	duckdb_table_function_supports_projection_pushdown(tf, false);
+	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_table_function(&tf);
+	return rc == DuckDBSuccess;
+}
 
-	tcc_bind_read_named_varchar(info, "runtime_path", &runtime_path);
-	tcc_bind_read_named_varchar(info, "library_path", &library_path);
-	effective_runtime = (runtime_path && runtime_path[0] != '\0') ? runtime_path : tcc_default_runtime_path();
+/* ===== Section: tcc_lock_stats() ===== */
+#define TCC_LOCK_STATS_ROWS 3
 
-	if (!tcc_collect_include_paths(effective_runtime, &include_paths) ||
-	    !tcc_collect_library_search_paths(effective_runtime, library_path, &library_paths)) {
-		tcc_string_list_destroy(&include_paths);
-		tcc_string_list_destroy(&library_paths);
-		if (runtime_path) {
-			duckdb_free(runtime_path);
-		}
-		if (library_path) {
-			duckdb_free(library_path);
-		}
-		destroy_tcc_diag_bind_data(bind);
+/* One `tcc_lock_stats()` row: a snapshot of one lock's wait counters. */
+typedef struct {
+	const char *lock;
+	const char *kind;
+	uint64_t acquisitions;
+	uint64_t contended;
+	uint64_t wait_ns;
+	uint64_t max_wait_ns;
+} tcc_lock_stat_row_t;
+
+/* Bind payload for `tcc_lock_stats()`: counters snapshotted at bind time (names are static strings). */
+typedef struct {
+	tcc_lock_stat_row_t rows[TCC_LOCK_STATS_ROWS];
+	idx_t count;
+} tcc_lock_stats_bind_data_t;
+
+/* tcc_lock_stats_snapshot: copies one lock's counters into a result row. Allocation/Lifetime: no allocation; relaxed reads, so
+ * rows are individually consistent per counter only. */
+static void tcc_lock_stats_snapshot(tcc_lock_stat_row_t *row, const char *lock, const char *kind,
+                                    tcc_lock_wait_stats_t *stats) {
+	row->lock = lock;
+	row->kind = kind;
+	row->acquisitions = (uint64_t)atomic_load_explicit(&stats->acquisitions, memory_order_relaxed);
+	row->contended = (uint64_t)atomic_load_explicit(&stats->contended, memory_order_relaxed);
+	row->wait_ns = (uint64_t)atomic_load_explicit(&stats->wait_ns, memory_order_relaxed);
+	row->max_wait_ns = (uint64_t)atomic_load_explicit(&stats->max_wait_ns, memory_order_relaxed);
+}
+
+/* tcc_lock_stats_bind: Bind callback for `tcc_lock_stats()`. Allocation/Lifetime: allocates bind payload released with duckdb_free. */
+static void tcc_lock_stats_bind(duckdb_bind_info info) {
+	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_bind_get_extra_info(info);
+	tcc_lock_stats_bind_data_t *bind;
+	duckdb_logical_type varchar_type;
+	duckdb_logical_type ubigint_type;
+	bind = (tcc_lock_stats_bind_data_t *)duckdb_malloc(sizeof(tcc_lock_stats_bind_data_t));
+	if (!bind) {
 		duckdb_bind_set_error(info, "out of memory");
 		return;
 	}
-
-	(void)tcc_diag_rows_add(&bind->rows, "runtime", "runtime_path", effective_runtime, tcc_path_exists(effective_runtime),
-	                        "effective runtime path");
-	for (i = 0; i < include_paths.count; i++) {
-		(void)tcc_diag_rows_add(&bind->rows, "include_path", "path", include_paths.items[i],
-		                        tcc_path_exists(include_paths.items[i]), "TinyCC include search path");
-	}
-	for (i = 0; i < library_paths.count; i++) {
-		(void)tcc_diag_rows_add(&bind->rows, "library_path", "path", library_paths.items[i],
-		                        tcc_path_exists(library_paths.items[i]), "library search path");
+	memset(bind, 0, sizeof(tcc_lock_stats_bind_data_t));
+	/* Counters are read without taking the locks they describe, so this never perturbs the measurement. */
+	if (state) {
+		tcc_lock_stats_snapshot(&bind->rows[bind->count++], "module_state", "read", &state->lock.read_wait);
+		tcc_lock_stats_snapshot(&bind->rows[bind->count++], "module_state", "write", &state->lock.write_wait);
+		if (state->ptr_registry) {
+			tcc_lock_stats_snapshot(&bind->rows[bind->count++], "ptr_registry", "spin",
+			                        &state->ptr_registry->lock_wait);
+		}
 	}
 
-	tcc_string_list_destroy(&include_paths);
-	tcc_string_list_destroy(&library_paths);
-	if (runtime_path) {
-		duckdb_free(runtime_path);
-	}
-	if (library_path) {
-		duckdb_free(library_path);
-	}
+	varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+	duckdb_bind_add_result_column(info, "lock", varchar_type);
+	duckdb_bind_add_result_column(info, "kind", varchar_type);
+	duckdb_bind_add_result_column(info, "acquisitions", ubigint_type);
+	duckdb_bind_add_result_column(info, "contended", ubigint_type);
+	duckdb_bind_add_result_column(info, "wait_ns", ubigint_type);
+	duckdb_bind_add_result_column(info, "max_wait_ns", ubigint_type);
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_logical_type(&ubigint_type);
 
-	tcc_diag_set_result_schema(info);
-	duckdb_bind_set_cardinality(info, bind->rows.count, true);
-	duckdb_bind_set_bind_data(info, bind, destroy_tcc_diag_bind_data);
+	duckdb_bind_set_cardinality(info, bind->count, true);
+	duckdb_bind_set_bind_data(info, bind, duckdb_free);
 }
 
-/* tcc_try_resolve_candidate: Internal helper in the TinyCC module/runtime pipeline. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static bool tcc_try_resolve_candidate(const char *candidate, const tcc_string_list_t *search_paths, char **out_path) {
+/* tcc_lock_stats_table_function: emits the snapshotted rows once. */
+static void tcc_lock_stats_table_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_lock_stats_bind_data_t *bind = (tcc_lock_stats_bind_data_t *)duckdb_function_get_bind_data(info);
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_function_get_init_data(info);
+	uint64_t *cols[4];
+	idx_t start;
 	idx_t i;
-	if (!candidate || candidate[0] == '\0' || !search_paths || !out_path) {
-		return false;
+	int c;
+	if (!bind || !init) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
-	if (tcc_is_path_like(candidate)) {
-		if (tcc_path_exists(candidate)) {
-			*out_path = tcc_strdup(candidate);
-			return *out_path != NULL;
-		}
-		return false;
+	start = (idx_t)atomic_fetch_add_explicit(&init->offset, bind->count, memory_order_acq_rel);
+	if (start != 0) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
-	for (i = 0; i < search_paths->count; i++) {
-		char *full_path = tcc_path_join(search_paths->items[i], candidate);
-		if (!full_path) {
-			return false;
-		}
-		if (tcc_path_exists(full_path)) {
-			*out_path = full_path;
-			return true;
-		}
-		duckdb_free(full_path);
+	for (c = 0; c < 4; c++) {
+		cols[c] = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, (idx_t)(2 + c)));
 	}
-	return false;
+	for (i = 0; i < bind->count; i++) {
+		const tcc_lock_stat_row_t *row = &bind->rows[i];
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 0), i, row->lock);
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), i, row->kind);
+		cols[0][i] = row->acquisitions;
+		cols[1][i] = row->contended;
+		cols[2][i] = row->wait_ns;
+		cols[3][i] = row->max_wait_ns;
+	}
+	duckdb_data_chunk_set_size(output, bind->count);
 }
 
-/* tcc_library_probe_bind: Diagnostics/probe table-function helper. Allocation/Lifetime: borrows caller-owned inputs; no ownership transfer. */
-static void tcc_library_probe_bind(duckdb_bind_info info) {
-	tcc_diag_bind_data_t *bind = (tcc_diag_bind_data_t *)duckdb_malloc(sizeof(tcc_diag_bind_data_t));
-	tcc_string_list_t library_paths;
-	tcc_string_list_t candidates;
-	char *library = NULL;
-	char *runtime_path = NULL;
-	char *library_path = NULL;
-	const char *effective_runtime;
-	idx_t i;
-	bool found = false;
-	if (!bind) {
-		duckdb_bind_set_error(info, "out of memory");
+/* Registers `tcc_lock_stats()` (module-state RW lock and pointer-registry spin lock wait counters) with borrowed module state. */
+static bool register_tcc_lock_stats_function(duckdb_connection connection, tcc_module_state_t *state) {
+	duckdb_table_function tf = duckdb_create_table_function();
+	duckdb_state rc;
+	duckdb_table_function_set_name(tf, "tcc_lock_stats");
+	duckdb_table_function_set_extra_info(tf, state, NULL);
+	duckdb_table_function_set_bind(tf, tcc_lock_stats_bind);
+	duckdb_table_function_set_init(tf, tcc_diag_table_init);
+	duckdb_table_function_set_function(tf, tcc_lock_stats_table_function);
+	duckdb_table_function_supports_projection_pushdown(tf, false);
+	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_table_function(&tf);
+	return rc == DuckDBSuccess;
+}
+
+/* ===== Section: tcc_code_info() ===== */
+/* destroy_tcc_code_info_bind_data: Destructor callback for DuckDB bind payloads. Allocation/Lifetime: releases the copied layout. */
+static void destroy_tcc_code_info_bind_data(void *ptr) {
+	tcc_code_info_t *info = (tcc_code_info_t *)ptr;
+	if (!info) {
 		return;
 	}
-	memset(bind, 0, sizeof(tcc_diag_bind_data_t));
-	memset(&library_paths, 0, sizeof(tcc_string_list_t));
-	memset(&candidates, 0, sizeof(tcc_string_list_t));
-
-	tcc_bind_read_named_varchar(info, "library", &library);
-	tcc_bind_read_named_varchar(info, "runtime_path", &runtime_path);
-	tcc_bind_read_named_varchar(info, "library_path", &library_path);
-	effective_runtime = (runtime_path && runtime_path[0] != '\0') ? runtime_path : tcc_default_runtime_path();
+	tcc_code_info_clear(info);
+	duckdb_free(info);
+}
 
-	if (!library || library[0] == '\0') {
-		if (library) {
-			duckdb_free(library);
-		}
-		if (runtime_path) {
-			duckdb_free(runtime_path);
-		}
-		if (library_path) {
-			duckdb_free(library_path);
-		}
-		destroy_tcc_diag_bind_data(bind);
-		duckdb_bind_set_error(info, "library is required");
+/* tcc_code_info_bind: Bind callback for `tcc_code_info(sql_name, disassemble := false)`. Allocation/Lifetime: copies the
+ * module's symbol bytes under the state read lock into a payload released by destroy_tcc_code_info_bind_data. */
+static void tcc_code_info_bind(duckdb_bind_info info) {
+	tcc_module_state_t *state = (tcc_module_state_t *)duckdb_bind_get_extra_info(info);
+	tcc_code_info_t *bind;
+	duckdb_value name_val = duckdb_bind_get_parameter(info, 0);
+	duckdb_value dis_val = duckdb_bind_get_named_parameter(info, "disassemble");
+	char *sql_name = name_val ? duckdb_get_varchar(name_val) : NULL;
+	bool disassemble = false;
+	duckdb_logical_type varchar_type;
+	duckdb_logical_type ubigint_type;
+	duckdb_logical_type blob_type;
+	char err[256];
+	int rc = 0;
+	if (dis_val) {
+		disassemble = !duckdb_is_null_value(dis_val) && duckdb_get_bool(dis_val);
+		duckdb_destroy_value(&dis_val);
+	}
+	if (name_val) {
+		duckdb_destroy_value(&name_val);
+	}
+	if (!sql_name || sql_name[0] == '\0') {
+		if (sql_name) {
+			duckdb_free(sql_name);
+		}
+		duckdb_bind_set_error(info, "tcc_code_info: sql_name is required");
 		return;
 	}
-
-	if (!tcc_collect_library_search_paths(effective_runtime, library_path, &library_paths) ||
-	    !tcc_build_library_candidates(library, &candidates)) {
-		tcc_string_list_destroy(&library_paths);
-		tcc_string_list_destroy(&candidates);
-		duckdb_free(library);
-		if (runtime_path) {
-			duckdb_free(runtime_path);
-		}
-		if (library_path) {
-			duckdb_free(library_path);
-		}
-		destroy_tcc_diag_bind_data(bind);
+	bind = (tcc_code_info_t *)duckdb_malloc(sizeof(tcc_code_info_t));
+	if (!bind) {
+		duckdb_free(sql_name);
 		duckdb_bind_set_error(info, "out of memory");
 		return;
 	}
-
-	(void)tcc_diag_rows_add(&bind->rows, "input", "library", library, false, "library probe request");
-	(void)tcc_diag_rows_add(&bind->rows, "runtime", "runtime_path", effective_runtime, tcc_path_exists(effective_runtime),
-	                        "effective runtime path");
-	for (i = 0; i < library_paths.count; i++) {
-		(void)tcc_diag_rows_add(&bind->rows, "search_path", "path", library_paths.items[i],
-		                        tcc_path_exists(library_paths.items[i]), "searched path");
+	memset(bind, 0, sizeof(tcc_code_info_t));
+	if (state) {
+		tcc_rwlock_read_lock(&state->lock);
+		rc = tcc_code_info_collect(state, sql_name, true, disassemble, bind);
+		tcc_rwlock_read_unlock(&state->lock);
 	}
-	for (i = 0; i < candidates.count; i++) {
-		char *resolved = NULL;
-		bool candidate_found = tcc_try_resolve_candidate(candidates.items[i], &library_paths, &resolved);
-		if (candidate_found && resolved) {
-			char *link_name = tcc_library_link_name_from_path(resolved);
-			(void)tcc_diag_rows_add(&bind->rows, "candidate", candidates.items[i], resolved, true, "resolved");
-			(void)tcc_diag_rows_add(&bind->rows, "resolved", "path", resolved, true, "resolved library path");
-			if (link_name) {
-				(void)tcc_diag_rows_add(&bind->rows, "resolved", "link_name", link_name, true,
-				                        "normalized tcc_add_library value");
-				duckdb_free(link_name);
-			}
-			found = true;
-			duckdb_free(resolved);
-			break;
+	if (rc <= 0) {
+		if (rc == 0) {
+			snprintf(err, sizeof(err), "tcc_code_info: no compiled module with sql_name '%s'", sql_name);
+		} else {
+			snprintf(err, sizeof(err), "out of memory");
 		}
-		(void)tcc_diag_rows_add(&bind->rows, "candidate", candidates.items[i], NULL, false, "not found");
-	}
-	if (!found) {
-		(void)tcc_diag_rows_add(&bind->rows, "resolved", "path", NULL, false, "no matching library found");
+		duckdb_free(sql_name);
+		destroy_tcc_code_info_bind_data(bind);
+		duckdb_bind_set_error(info, err);
+		return;
 	}
+	duckdb_free(sql_name);
 
-	tcc_string_list_destroy(&library_paths);
-	tcc_string_list_destroy(&candidates);
-	duckdb_free(library);
-	if (runtime_path) {
-		duckdb_free(runtime_path);
+	varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+	blob_type = duckdb_create_logical_type(DUCKDB_TYPE_BLOB);
+	duckdb_bind_add_result_column(info, "sql_name", varchar_type);
+	duckdb_bind_add_result_column(info, "symbol", varchar_type);
+	duckdb_bind_add_result_column(info, "address", ubigint_type);
+	duckdb_bind_add_result_column(info, "size", ubigint_type);
+	duckdb_bind_add_result_column(info, "code", blob_type);
+	duckdb_bind_add_result_column(info, "disassembly", varchar_type);
+	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_logical_type(&ubigint_type);
+	duckdb_destroy_logical_type(&blob_type);
+
+	duckdb_bind_set_cardinality(info, bind->count, true);
+	duckdb_bind_set_bind_data(info, bind, destroy_tcc_code_info_bind_data);
+}
+
+/* tcc_code_info_table_function: emits one row per module function, up to one vector per call. */
+static void tcc_code_info_table_function(duckdb_function_info info, duckdb_data_chunk output) {
+	tcc_code_info_t *bind = (tcc_code_info_t *)duckdb_function_get_bind_data(info);
+	tcc_diag_init_data_t *init = (tcc_diag_init_data_t *)duckdb_function_get_init_data(info);
+	duckdb_vector v_code;
+	uint64_t *addresses;
+	uint64_t *sizes;
+	idx_t start;
+	idx_t n;
+	idx_t i;
+	if (!bind || !init) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
-	if (library_path) {
-		duckdb_free(library_path);
+	n = duckdb_vector_size();
+	start = (idx_t)atomic_fetch_add_explicit(&init->offset, n, memory_order_acq_rel);
+	if (start >= bind->count) {
+		duckdb_data_chunk_set_size(output, 0);
+		return;
 	}
-
-	tcc_diag_set_result_schema(info);
-	duckdb_bind_set_cardinality(info, bind->rows.count, true);
-	duckdb_bind_set_bind_data(info, bind, destroy_tcc_diag_bind_data);
+	if (n > bind->count - start) {
+		n = bind->count - start;
+	}
+	addresses = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 2));
+	sizes = (uint64_t *)duckdb_vector_get_data(duckdb_data_chunk_get_vector(output, 3));
+	v_code = duckdb_data_chunk_get_vector(output, 4);
+	for (i = 0; i < n; i++) {
+		const tcc_code_symbol_t *row = &bind->items[start + i];
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 0), i, bind->sql_name);
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 1), i, row->symbol);
+		addresses[i] = row->address;
+		sizes[i] = row->size;
+		duckdb_vector_assign_string_element_len(v_code, i, (const char *)row->code, (idx_t)row->size);
+		tcc_set_varchar_col(duckdb_data_chunk_get_vector(output, 5), i, row->disassembly);
+	}
+	duckdb_data_chunk_set_size(output, n);
 }
 
-/* Registers `tcc_system_paths(...)` diagnostics table function. */
-static bool register_tcc_system_paths_function(duckdb_connection connection) {
+/* Registers `tcc_code_info(sql_name, disassemble := false)` (per-function machine code) with borrowed module state. */
+static bool register_tcc_code_info_function(duckdb_connection connection, tcc_module_state_t *state) {
 	duckdb_table_function tf = duckdb_create_table_function();
 	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_logical_type bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
 	duckdb_state rc;
-	duckdb_table_function_set_name(tf, "tcc_system_paths");
-	duckdb_table_function_add_named_parameter(tf, "runtime_path", varchar_type);
-	duckdb_table_function_add_named_parameter(tf, "library_path", varchar_type);
-	duckdb_table_function_set_bind(tf, tcc_system_paths_bind);
+	duckdb_table_function_set_name(tf, "tcc_code_info");
+	duckdb_table_function_add_parameter(tf, varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "disassemble", bool_type);
+	duckdb_table_function_set_extra_info(tf, state, NULL);
+	duckdb_table_function_set_bind(tf, tcc_code_info_bind);
 	duckdb_table_function_set_init(tf, tcc_diag_table_init);
-	duckdb_table_function_set_function(tf, tcc_diag_table_function);
+	duckdb_table_function_set_function(tf, tcc_code_info_table_function);
 	duckdb_table_function_supports_projection_pushdown(tf, false);
 	rc = duckdb_register_table_function(connection, tf);
 	duckdb_destroy_logical_type(&varchar_type);
+	duckdb_destroy_logical_type(&bool_type);
 	duckdb_destroy_table_function(&tf);
 	return rc == DuckDBSuccess;
 }
 
-/* Registers `tcc_library_probe(...)` diagnostics table function. */
-static bool register_tcc_library_probe_function(duckdb_connection connection) {
+/* Registers `tcc_compile_expr(sql_name, expr := ..., arg_types := [...])`, a one-row front end for `mode := 'compile_expr'`, with borrowed module state. */
+static bool register_tcc_compile_expr_function(duckdb_connection connection, tcc_module_state_t *state) {
 	duckdb_table_function tf = duckdb_create_table_function();
 	duckdb_logical_type varchar_type = duckdb_create_logical_type(DUCKDB_TYPE_VARCHAR);
+	duckdb_logical_type list_varchar_type = duckdb_create_list_type(varchar_type);
 	duckdb_state rc;
-	duckdb_table_function_set_name(tf, "tcc_library_probe");
-	duckdb_table_function_add_named_parameter(tf, "library", varchar_type);
-	duckdb_table_function_add_named_parameter(tf, "runtime_path", varchar_type);
-	duckdb_table_function_add_named_parameter(tf, "library_path", varchar_type);
-	duckdb_table_function_set_bind(tf, tcc_library_probe_bind);
-	duckdb_table_function_set_init(tf, tcc_diag_table_init);
-	duckdb_table_function_set_function(tf, tcc_diag_table_function);
+	duckdb_table_function_set_name(tf, "tcc_compile_expr");
+	duckdb_table_function_add_parameter(tf, varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "expr", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "arg_types", list_varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "return_type", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "stability", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "isolation", varchar_type);
+	duckdb_table_function_set_extra_info(tf, state, NULL);
+	duckdb_table_function_set_bind(tf, tcc_compile_expr_bind);
+	duckdb_table_function_set_init(tf, tcc_module_init);
+	duckdb_table_function_set_function(tf, tcc_module_function);
 	duckdb_table_function_supports_projection_pushdown(tf, false);
 	rc = duckdb_register_table_function(connection, tf);
+	duckdb_destroy_logical_type(&list_varchar_type);
 	duckdb_destroy_logical_type(&varchar_type);
 	duckdb_destroy_table_function(&tf);
 	return rc == DuckDBSuccess;
@@ -9992,6 +18972,14 @@ bool RegisterTccModuleFunction(duckdb_connection connection, duckdb_database dat
 	duckdb_table_function_add_named_parameter(tf, "return_type", varchar_type);
 	duckdb_table_function_add_named_parameter(tf, "wrapper_mode", varchar_type);
 	duckdb_table_function_add_named_parameter(tf, "stability", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "symbols", list_varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "expr", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "isolation", varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "specialize", list_varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "type_params", list_varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "import_from", list_varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "used", list_varchar_type);
+	duckdb_table_function_add_named_parameter(tf, "source_file", varchar_type);
 	duckdb_table_function_add_named_parameter(tf, "include_path", varchar_type);
 	duckdb_table_function_add_named_parameter(tf, "sysinclude_path", varchar_type);
 	duckdb_table_function_add_named_parameter(tf, "library_path", varchar_type);
@@ -10006,6 +18994,19 @@ bool RegisterTccModuleFunction(duckdb_connection connection, duckdb_database dat
 		duckdb_table_function_add_named_parameter(tf, "symbol_ptr", ubigint_type);
 		duckdb_destroy_logical_type(&ubigint_type);
 	}
+	{
+		duckdb_logical_type bool_type = duckdb_create_logical_type(DUCKDB_TYPE_BOOLEAN);
+		duckdb_table_function_add_named_parameter(tf, "perf_map", bool_type);
+		duckdb_destroy_logical_type(&bool_type);
+	}
+	{
+		duckdb_logical_type ubigint_type = duckdb_create_logical_type(DUCKDB_TYPE_UBIGINT);
+		duckdb_logical_type double_type = duckdb_create_logical_type(DUCKDB_TYPE_DOUBLE);
+		duckdb_table_function_add_named_parameter(tf, "rows", ubigint_type);
+		duckdb_table_function_add_named_parameter(tf, "null_ratio", double_type);
+		duckdb_destroy_logical_type(&ubigint_type);
+		duckdb_destroy_logical_type(&double_type);
+	}
 
 	duckdb_table_function_set_extra_info(tf, state, destroy_tcc_module_state);
 	duckdb_table_function_set_bind(tf, tcc_module_bind);
@@ -10016,6 +19017,12 @@ bool RegisterTccModuleFunction(duckdb_connection connection, duckdb_database dat
 	rc = duckdb_register_table_function(connection, tf);
 	if (rc == DuckDBSuccess) {
 		rc = register_tcc_system_paths_function(connection) && register_tcc_library_probe_function(connection) &&
+		             register_tcc_functions_function(connection, state) &&
+		             register_tcc_compile_stats_function(connection, state) &&
+		             register_tcc_lock_stats_function(connection, state) &&
+		             register_tcc_code_info_function(connection, state) &&
+		             register_tcc_compile_expr_function(connection, state) &&
+		             register_tcc_read_function(connection, database, state) &&
 		             register_tcc_pointer_helper_functions(connection, state->ptr_registry)
 		         ? DuckDBSuccess
 		         : DuckDBError;